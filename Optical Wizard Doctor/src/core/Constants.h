@@ -40,6 +40,11 @@ namespace CanvasConstants {
     constexpr double SCROLL_SPEED = 0.5;  // Scroll speed multiplier
     constexpr int WHEEL_DELTA_NORMALIZATION = 120;  // Standard wheel delta
     constexpr double MAX_SCALE = 1.0;  // Maximum initial scale to fit
+    constexpr double LAYER_MARGIN = 32.0;  // Static layer padding for labels, handles and shadow
+    constexpr long long STATIC_LAYER_MAX_PIXELS = 4096LL * 4096LL;  // Above this, cache the viewport only
+    constexpr double OVERLAY_MARGIN = 16.0;  // Dirty-rect padding for pens, handles and rotate icon
+    constexpr double DETAIL_TILE_MIN_MAGNIFICATION = 1.25;  // Device pixels per page pixel before re-rendering from the PDF
+    constexpr int DETAIL_TILE_DEBOUNCE_MS = 150;  // Idle time after a pan/zoom before the visible tile is requested
 }
 
 // PDF loading constants
@@ -47,6 +52,10 @@ namespace PdfConstants {
     constexpr int DEFAULT_DPI = 150;
     constexpr int MIN_DPI = 72;
     constexpr int MAX_DPI = 300;
+    constexpr int PREVIEW_DPI = 36;  // Fast first paint while the full page renders
+    constexpr int DETECTION_DPI = 150;  // Grayscale detection raster; detector pixel thresholds are tuned for it
+    constexpr int MAX_TILE_DPI = 1200;  // Upper bound for zoomed-in viewport re-renders
+    constexpr long long MAX_TILE_PIXELS = 4096LL * 4096LL;  // Largest crop a viewport re-render may produce
 }
 
 // Region constants
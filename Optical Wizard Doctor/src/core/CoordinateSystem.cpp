@@ -172,5 +172,22 @@ bool CoordinateSystem::isValidNormalizedCoords(const NormalizedCoords& coords) {
            isValidDouble(coords.x2) && isValidDouble(coords.y2);
 }
 
+bool CoordinateSystem::isValidRegionCoords(const NormalizedCoords& coords) {
+    if (!isValidNormalizedCoords(coords)) {
+        return false;
+    }
+    
+    // Check all coordinates are in valid range [0.0, 1.0]
+    if (coords.x1 < 0.0 || coords.x1 > 1.0 ||
+        coords.y1 < 0.0 || coords.y1 > 1.0 ||
+        coords.x2 < 0.0 || coords.x2 > 1.0 ||
+        coords.y2 < 0.0 || coords.y2 > 1.0) {
+        return false;
+    }
+    
+    // Check coordinates form a valid rectangle (x1 < x2, y1 < y2)
+    return coords.x1 < coords.x2 && coords.y1 < coords.y2;
+}
+
 } // namespace ocr_orc
 
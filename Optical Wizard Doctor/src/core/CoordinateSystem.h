@@ -201,6 +201,13 @@ public:
      * @return true if all coordinates are valid
      */
     static bool isValidNormalizedCoords(const NormalizedCoords& coords);
+    
+    /**
+     * @brief Validate imported region coordinates
+     * @param coords Coordinates to validate
+     * @return true if all values are finite and in [0, 1], with x1 < x2 and y1 < y2
+     */
+    static bool isValidRegionCoords(const NormalizedCoords& coords);
 };
 
 } // namespace ocr_orc
@@ -2,8 +2,6 @@
 #include <QtCore/QFile>
 #include <QtCore/QTextStream>
 #include <QtCore/QStringConverter>
-#include <QtCore/QList>
-#include <algorithm>
 #include <stdexcept>
 
 namespace ocr_orc {
@@ -26,13 +24,11 @@ void CsvExporter::exportToFile(const DocumentState& state, const QString& filePa
     // Write header row
     out << "Region Name,Group,Color,X1 (%),Y1 (%),X2 (%),Y2 (%)\n";
     
-    // Get all region names and sort alphabetically
-    QList<QString> regionNames = state.getAllRegionNames();
-    std::sort(regionNames.begin(), regionNames.end());
-    
-    // Write region rows
-    for (const QString& regionName : regionNames) {
-        RegionData region = state.getRegion(regionName);
+    // Write region rows one at a time, alphabetically (QMap keeps keys sorted),
+    // without copying the region list or building the file in memory
+    for (auto it = state.regions.constBegin(); it != state.regions.constEnd(); ++it) {
+        const QString& regionName = it.key();
+        const RegionData& region = it.value();
         
         out << escapeCsvField(regionName) << ","
             << escapeCsvField(region.group.isEmpty() ? "" : region.group) << ","
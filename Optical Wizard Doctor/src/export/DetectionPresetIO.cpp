@@ -0,0 +1,105 @@
+#include "DetectionPresetIO.h"
+#include "../ui/components/dialogs/MagicDetectParamsDialog.h"
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QFile>
+#include <stdexcept>
+
+namespace ocr_orc {
+
+void DetectionPresetIO::exportToFile(const DetectionParameters& params, const QString& presetName,
+                                     const QString& filePath) {
+    QJsonObject root;
+    root["preset_name"] = presetName;
+    root["parameters"] = toJson(params);
+    root["version"] = QString("1.0");
+    
+    // QSaveFile writes to a temp file and renames it into place on commit
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        throw std::runtime_error(
+            QString("Cannot open file for writing: %1").arg(file.errorString()).toStdString()
+        );
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        throw std::runtime_error(
+            QString("Error writing file: %1").arg(file.errorString()).toStdString()
+        );
+    }
+}
+
+DetectionParameters DetectionPresetIO::importFromFile(const QString& filePath, QString* presetName) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        throw std::runtime_error(
+            QString("Cannot open file for reading: %1").arg(file.errorString()).toStdString()
+        );
+    }
+    
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull()) {
+        throw std::runtime_error(
+            QString("Invalid JSON: %1").arg(parseError.errorString()).toStdString()
+        );
+    }
+    
+    QJsonObject root = doc.object();
+    if (!root.value("parameters").isObject()) {
+        throw std::runtime_error("Invalid preset: missing or invalid 'parameters' field");
+    }
+    
+    if (presetName) {
+        *presetName = root.value("preset_name").toString();
+    }
+    return fromJson(root.value("parameters").toObject());
+}
+
+QJsonObject DetectionPresetIO::toJson(const DetectionParameters& params) {
+    QJsonObject obj;
+    obj["ocrOverlapThreshold"] = params.ocrOverlapThreshold;
+    obj["baseBrightnessThreshold"] = params.baseBrightnessThreshold;
+    obj["brightnessAdaptiveFactor"] = params.brightnessAdaptiveFactor;
+    obj["edgeDensityThreshold"] = params.edgeDensityThreshold;
+    obj["horizontalEdgeDensityThreshold"] = params.horizontalEdgeDensityThreshold;
+    obj["verticalEdgeDensityThreshold"] = params.verticalEdgeDensityThreshold;
+    obj["iouThreshold"] = params.iouThreshold;
+    obj["ocrConfidenceThreshold"] = params.ocrConfidenceThreshold;
+    obj["horizontalOverfitPercent"] = params.horizontalOverfitPercent;
+    obj["verticalOverfitPercent"] = params.verticalOverfitPercent;
+    obj["minHorizontalLines"] = params.minHorizontalLines;
+    obj["strictConsensus"] = params.strictConsensus;
+    obj["minCheckboxSize"] = params.minCheckboxSize;
+    obj["maxCheckboxSize"] = params.maxCheckboxSize;
+    obj["checkboxAspectRatioMin"] = params.checkboxAspectRatioMin;
+    obj["checkboxAspectRatioMax"] = params.checkboxAspectRatioMax;
+    obj["checkboxRectangularity"] = params.checkboxRectangularity;
+    obj["enableStandaloneCheckboxDetection"] = params.enableStandaloneCheckboxDetection;
+    return obj;
+}
+
+DetectionParameters DetectionPresetIO::fromJson(const QJsonObject& obj) {
+    DetectionParameters params;
+    params.ocrOverlapThreshold = obj.value("ocrOverlapThreshold").toDouble(params.ocrOverlapThreshold);
+    params.baseBrightnessThreshold = obj.value("baseBrightnessThreshold").toDouble(params.baseBrightnessThreshold);
+    params.brightnessAdaptiveFactor = obj.value("brightnessAdaptiveFactor").toDouble(params.brightnessAdaptiveFactor);
+    params.edgeDensityThreshold = obj.value("edgeDensityThreshold").toDouble(params.edgeDensityThreshold);
+    params.horizontalEdgeDensityThreshold = obj.value("horizontalEdgeDensityThreshold").toDouble(params.horizontalEdgeDensityThreshold);
+    params.verticalEdgeDensityThreshold = obj.value("verticalEdgeDensityThreshold").toDouble(params.verticalEdgeDensityThreshold);
+    params.iouThreshold = obj.value("iouThreshold").toDouble(params.iouThreshold);
+    params.ocrConfidenceThreshold = obj.value("ocrConfidenceThreshold").toDouble(params.ocrConfidenceThreshold);
+    params.horizontalOverfitPercent = obj.value("horizontalOverfitPercent").toDouble(params.horizontalOverfitPercent);
+    params.verticalOverfitPercent = obj.value("verticalOverfitPercent").toDouble(params.verticalOverfitPercent);
+    params.minHorizontalLines = obj.value("minHorizontalLines").toInt(params.minHorizontalLines);
+    params.strictConsensus = obj.value("strictConsensus").toBool(params.strictConsensus);
+    params.minCheckboxSize = obj.value("minCheckboxSize").toInt(params.minCheckboxSize);
+    params.maxCheckboxSize = obj.value("maxCheckboxSize").toInt(params.maxCheckboxSize);
+    params.checkboxAspectRatioMin = obj.value("checkboxAspectRatioMin").toDouble(params.checkboxAspectRatioMin);
+    params.checkboxAspectRatioMax = obj.value("checkboxAspectRatioMax").toDouble(params.checkboxAspectRatioMax);
+    params.checkboxRectangularity = obj.value("checkboxRectangularity").toDouble(params.checkboxRectangularity);
+    params.enableStandaloneCheckboxDetection = obj.value("enableStandaloneCheckboxDetection").toBool(params.enableStandaloneCheckboxDetection);
+    return params;
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,53 @@
+#ifndef DETECTION_PRESET_IO_H
+#define DETECTION_PRESET_IO_H
+
+#include <QtCore/QString>
+#include <QtCore/QJsonObject>
+
+namespace ocr_orc {
+
+// Forward declare DetectionParameters - defined in MagicDetectParamsDialog.h
+struct DetectionParameters;
+
+/**
+ * @brief Reads and writes Magic Detect parameter presets as JSON files
+ *
+ * A preset file holds a name and the parameter values, keyed like the
+ * dialog's saved settings. The auto-tuner writes its best configuration in
+ * this format, and the parameters dialog can load it as a preset.
+ */
+class DetectionPresetIO {
+public:
+    /**
+     * @brief Write a preset file
+     * @param params Parameter values
+     * @param presetName Name shown when the preset is loaded
+     * @param filePath Path to output JSON file
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void exportToFile(const DetectionParameters& params, const QString& presetName,
+                             const QString& filePath);
+    
+    /**
+     * @brief Read a preset file
+     * @param filePath Path to input JSON file
+     * @param presetName Receives the preset name (may be nullptr)
+     * @return Parameters; values missing from the file keep their defaults
+     * @throws std::runtime_error if the file cannot be read or is not a preset
+     */
+    static DetectionParameters importFromFile(const QString& filePath, QString* presetName = nullptr);
+    
+    /**
+     * @brief Parameter values as a JSON object
+     */
+    static QJsonObject toJson(const DetectionParameters& params);
+    
+    /**
+     * @brief Parameter values from a JSON object (missing keys keep their defaults)
+     */
+    static DetectionParameters fromJson(const QJsonObject& obj);
+};
+
+} // namespace ocr_orc
+
+#endif // DETECTION_PRESET_IO_H
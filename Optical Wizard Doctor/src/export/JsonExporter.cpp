@@ -2,86 +2,121 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonArray>
 #include <QtCore/QFile>
-#include <QtCore/QTextStream>
-#include <QtCore/QStringConverter>
 #include <stdexcept>
 
 namespace ocr_orc {
 
 void JsonExporter::exportToFile(const DocumentState& state, const QString& filePath) {
-    // Build JSON structure
-    QJsonObject root = buildRootObject(state);
-    
-    // Create JSON document
-    QJsonDocument doc(root);
-    QByteArray json = doc.toJson(QJsonDocument::Indented);
-    
-    // Write to file atomically
-    writeFileAtomically(json, filePath);
+    // Stream JSON straight into the temp file, then rename into place
+    writeFileAtomically(filePath, [&state](QIODevice& out) {
+        writeDocument(state, out);
+    });
 }
 
-QJsonObject JsonExporter::buildRootObject(const DocumentState& state) {
-    QJsonObject root;
+void JsonExporter::writeDocument(const DocumentState& state, QIODevice& out) {
+    // Root keys are written in the sorted order QJsonObject would use
+    QSize imageSize = state.getImageSize();
+    double aspectRatio = 1.0;
+    if (imageSize.height() > 0) {
+        aspectRatio = static_cast<double>(imageSize.width()) / 
+                      static_cast<double>(imageSize.height());
+    }
     
-    // PDF path
-    root["pdf_path"] = state.pdfPath;
+    out.write("{\n");
+    
+    // Aspect ratio
+    out.write("    \"aspect_ratio\": ");
+    out.write(scalarJson(aspectRatio));
+    out.write(",\n");
+    
+    // Groups
+    out.write("    \"groups\": ");
+    writeGroups(state, out);
+    out.write(",\n");
     
     // Image size
-    QSize imageSize = state.getImageSize();
     QJsonArray imageSizeArray;
     imageSizeArray.append(imageSize.width());
     imageSizeArray.append(imageSize.height());
-    root["image_size"] = imageSizeArray;
+    out.write("    \"image_size\": ");
+    out.write(nestedJson(imageSizeArray, 1));
+    out.write(",\n");
     
-    // Aspect ratio
-    if (imageSize.height() > 0) {
-        double aspectRatio = static_cast<double>(imageSize.width()) / 
-                             static_cast<double>(imageSize.height());
-        root["aspect_ratio"] = aspectRatio;
-    } else {
-        root["aspect_ratio"] = 1.0;
-    }
-    
-    // Version field for future compatibility
-    root["version"] = "1.0";
+    // PDF path
+    out.write("    \"pdf_path\": ");
+    out.write(scalarJson(state.pdfPath));
+    out.write(",\n");
     
     // Regions
-    root["regions"] = buildRegionsObject(state);
+    out.write("    \"regions\": ");
+    writeRegions(state, out);
+    out.write(",\n");
     
-    // Groups
-    root["groups"] = buildGroupsObject(state);
-    
-    return root;
+    // Version field for future compatibility
+    out.write("    \"version\": ");
+    out.write(scalarJson(QString("1.0")));
+    out.write("\n}\n");
 }
 
-QJsonObject JsonExporter::buildRegionsObject(const DocumentState& state) {
-    QJsonObject regionsObj;
-    
-    QList<QString> regionNames = state.getAllRegionNames();
-    for (const QString& name : regionNames) {
-        RegionData region = state.getRegion(name);
-        regionsObj[name] = regionToJson(region);
+void JsonExporter::writeRegions(const DocumentState& state, QIODevice& out) {
+    // QMap keys are already sorted the same way QJsonObject sorts its keys
+    out.write("{\n");
+    bool first = true;
+    for (auto it = state.regions.constBegin(); it != state.regions.constEnd(); ++it) {
+        if (!first) {
+            out.write(",\n");
+        }
+        first = false;
+        out.write("        ");
+        out.write(scalarJson(it.key()));
+        out.write(": ");
+        out.write(nestedJson(regionToJson(it.value()), 2));
     }
-    
-    return regionsObj;
+    if (!first) {
+        out.write("\n");
+    }
+    out.write("    }");
 }
 
-QJsonObject JsonExporter::buildGroupsObject(const DocumentState& state) {
-    QJsonObject groupsObj;
-    
-    QList<QString> groupNames = state.getGroupNames();
-    for (const QString& groupName : groupNames) {
-        GroupData group = state.getGroup(groupName);
-        
+void JsonExporter::writeGroups(const DocumentState& state, QIODevice& out) {
+    out.write("{\n");
+    bool first = true;
+    for (auto it = state.groups.constBegin(); it != state.groups.constEnd(); ++it) {
         QJsonArray regionArray;
-        for (const QString& regionName : group.regionNames) {
+        for (const QString& regionName : it.value().regionNames) {
             regionArray.append(regionName);
         }
         
-        groupsObj[groupName] = regionArray;
+        if (!first) {
+            out.write(",\n");
+        }
+        first = false;
+        out.write("        ");
+        out.write(scalarJson(it.key()));
+        out.write(": ");
+        out.write(nestedJson(regionArray, 2));
     }
-    
-    return groupsObj;
+    if (!first) {
+        out.write("\n");
+    }
+    out.write("    }");
+}
+
+QByteArray JsonExporter::nestedJson(const QJsonValue& value, int indentLevel) {
+    QByteArray json = value.isArray()
+        ? QJsonDocument(value.toArray()).toJson(QJsonDocument::Indented)
+        : QJsonDocument(value.toObject()).toJson(QJsonDocument::Indented);
+    json.chop(1); // Trailing newline only appears at document level
+    
+    // Strings never contain raw newlines (they are escaped), so every '\n' is layout
+    json.replace("\n", "\n" + QByteArray(4 * indentLevel, ' '));
+    return json;
+}
+
+QByteArray JsonExporter::scalarJson(const QJsonValue& value) {
+    // Let QJsonDocument handle escaping and number formatting, then drop the brackets
+    QByteArray json = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+    return json.mid(1, json.size() - 2);
 }
 
 QJsonObject JsonExporter::regionToJson(const RegionData& region) {
@@ -126,7 +161,8 @@ QJsonObject JsonExporter::regionToJson(const RegionData& region) {
     return regionObj;
 }
 
-void JsonExporter::writeFileAtomically(const QByteArray& jsonData, const QString& filePath) {
+void JsonExporter::writeFileAtomically(const QString& filePath,
+                                       const std::function<void(QIODevice&)>& writeContents) {
     // Create temp file path
     QString tempPath = filePath + ".tmp";
     
@@ -138,9 +174,13 @@ void JsonExporter::writeFileAtomically(const QByteArray& jsonData, const QString
         );
     }
     
-    QTextStream out(&tempFile);
-    out.setEncoding(QStringConverter::Encoding::Utf8);
-    out << jsonData;
+    try {
+        writeContents(tempFile);
+    } catch (...) {
+        tempFile.close();
+        QFile::remove(tempPath);
+        throw;
+    }
     tempFile.close();
     
     // Verify write succeeded
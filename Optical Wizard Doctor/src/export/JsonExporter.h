@@ -4,6 +4,9 @@
 #include "../models/DocumentState.h"
 #include <QtCore/QString>
 #include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QIODevice>
+#include <functional>
 
 namespace ocr_orc {
 
@@ -12,6 +15,7 @@ namespace ocr_orc {
  * 
  * Exports regions, groups, and metadata to JSON format.
  * Uses normalized coordinates (0.0-1.0) as the source of truth.
+ * Output is streamed to disk, so memory use does not grow with region count.
  */
 class JsonExporter {
 public:
@@ -25,25 +29,43 @@ public:
     
 private:
     /**
-     * @brief Build root JSON object with all data
+     * @brief Stream the document to an output device
+     * 
+     * Emits exactly the bytes QJsonDocument::toJson(Indented) would produce for
+     * the full document (keys in sorted order, 4-space indentation), but only
+     * ever holds one region's JSON in memory.
+     * 
      * @param state DocumentState to export
-     * @return QJsonObject containing all exported data
+     * @param out Open output device
      */
-    static QJsonObject buildRootObject(const DocumentState& state);
+    static void writeDocument(const DocumentState& state, QIODevice& out);
     
     /**
-     * @brief Build regions JSON object
+     * @brief Stream the "regions" object (one region at a time)
      * @param state DocumentState to export
-     * @return QJsonObject containing all regions
+     * @param out Open output device
      */
-    static QJsonObject buildRegionsObject(const DocumentState& state);
+    static void writeRegions(const DocumentState& state, QIODevice& out);
     
     /**
-     * @brief Build groups JSON object
+     * @brief Stream the "groups" object (one group at a time)
      * @param state DocumentState to export
-     * @return QJsonObject containing all groups
+     * @param out Open output device
      */
-    static QJsonObject buildGroupsObject(const DocumentState& state);
+    static void writeGroups(const DocumentState& state, QIODevice& out);
+    
+    /**
+     * @brief Serialize a small JSON value as it would appear nested in a larger document
+     * @param value Object or array to serialize
+     * @param indentLevel Nesting depth of the value in the enclosing document
+     * @return Indented JSON without a trailing newline
+     */
+    static QByteArray nestedJson(const QJsonValue& value, int indentLevel);
+    
+    /**
+     * @brief Serialize a scalar (string, number, bool) exactly as QJsonDocument would
+     */
+    static QByteArray scalarJson(const QJsonValue& value);
     
     /**
      * @brief Convert RegionData to JSON object
@@ -53,12 +75,13 @@ private:
     static QJsonObject regionToJson(const RegionData& region);
     
     /**
-     * @brief Write JSON to file atomically (temp file + rename)
-     * @param jsonData JSON data to write
+     * @brief Write a file atomically (temp file + rename)
      * @param filePath Target file path
+     * @param writeContents Writes the file body to the open temp file
      * @throws std::runtime_error if write fails
      */
-    static void writeFileAtomically(const QByteArray& jsonData, const QString& filePath);
+    static void writeFileAtomically(const QString& filePath,
+                                    const std::function<void(QIODevice&)>& writeContents);
 };
 
 } // namespace ocr_orc
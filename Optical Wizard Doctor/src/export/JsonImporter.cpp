@@ -5,6 +5,8 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonParseError>
 #include <QtCore/QJsonArray>
+#include <QtCore/QMap>
+#include <QtCore/QList>
 #if OCR_ORC_DEBUG_ENABLED
 #include <QtCore/QDebug>
 #endif
@@ -12,6 +14,230 @@
 
 namespace ocr_orc {
 
+namespace {
+
+/**
+ * @brief Minimal pull reader for JSON documents
+ *
+ * Walks the structure of objects incrementally from a QIODevice. Individual
+ * member values are cut out as raw bytes and handed to QJsonDocument, so
+ * only one value (e.g. one region) is ever materialized at a time.
+ */
+class JsonStreamReader {
+public:
+    explicit JsonStreamReader(QIODevice* device)
+        : device(device), pos(0), base(0), captureStart(-1) {}
+
+    /**
+     * @brief Next non-whitespace character without consuming it (0 at end of input)
+     */
+    char peek() {
+        while (true) {
+            if (pos >= buffer.size() && !fill()) {
+                return 0;
+            }
+            char c = buffer[pos];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                return c;
+            }
+            pos++;
+        }
+    }
+
+    /**
+     * @brief Consume the opening brace of an object
+     */
+    void beginObject() {
+        if (peek() != '{') {
+            fail("object expected");
+        }
+        pos++;
+        firstMember.append(true);
+    }
+
+    /**
+     * @brief Advance to the next member of the current object
+     * @param key Receives the member name
+     * @return false once the closing brace has been consumed
+     */
+    bool nextKey(QString& key) {
+        char c = peek();
+        if (c == '}') {
+            pos++;
+            firstMember.removeLast();
+            return false;
+        }
+        if (!firstMember.last()) {
+            if (c != ',') {
+                fail(c == 0 ? "unterminated object" : "missing value separator");
+            }
+            pos++;
+            c = peek();
+        }
+        firstMember.last() = false;
+
+        if (c != '"') {
+            fail("illegal value");
+        }
+        key = readValue().toString();
+
+        if (peek() != ':') {
+            fail("missing name separator");
+        }
+        pos++;
+        return true;
+    }
+
+    /**
+     * @brief Parse the next value
+     */
+    QJsonValue readValue() {
+        qint64 valueOffset = 0;
+        QByteArray raw = scanRawValue(valueOffset);
+
+        // Wrap in an array so scalars are accepted by QJsonDocument
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson("[" + raw + "]", &error);
+        if (error.error != QJsonParseError::NoError) {
+            throw std::runtime_error(
+                QString("JSON parse error at offset %1: %2")
+                    .arg(valueOffset + qMax(0, error.offset - 1))
+                    .arg(error.errorString())
+                    .toStdString()
+            );
+        }
+        return doc.array().at(0);
+    }
+
+    /**
+     * @brief Consume the next value (still validated, result discarded)
+     */
+    void skipValue() {
+        readValue();
+    }
+
+    /**
+     * @brief Verify only whitespace remains
+     */
+    void expectEnd() {
+        if (peek() != 0) {
+            fail("garbage at the end of the document");
+        }
+    }
+
+private:
+    [[noreturn]] void fail(const char* message) const {
+        throw std::runtime_error(
+            QString("JSON parse error at offset %1: %2")
+                .arg(base + pos)
+                .arg(QString::fromLatin1(message))
+                .toStdString()
+        );
+    }
+
+    /**
+     * @brief Read more input, discarding consumed bytes not being captured
+     */
+    bool fill() {
+        qsizetype keepFrom = captureStart >= 0 ? captureStart : pos;
+        if (keepFrom > 0) {
+            buffer.remove(0, keepFrom);
+            base += keepFrom;
+            pos -= keepFrom;
+            if (captureStart >= 0) {
+                captureStart = 0;
+            }
+        }
+        QByteArray chunk = device->read(CHUNK_SIZE);
+        if (chunk.isEmpty()) {
+            return false;
+        }
+        buffer.append(chunk);
+        return true;
+    }
+
+    char next() {
+        if (pos >= buffer.size() && !fill()) {
+            fail(captureStart >= 0 ? "unterminated value" : "unexpected end of input");
+        }
+        return buffer[pos++];
+    }
+
+    void scanString() {
+        pos++; // Opening quote
+        while (true) {
+            char c = next();
+            if (c == '\\') {
+                next();
+            } else if (c == '"') {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Cut out the bytes of the next value (string, number, literal, object or array)
+     */
+    QByteArray scanRawValue(qint64& valueOffset) {
+        char c = peek();
+        if (c == 0) {
+            fail("unexpected end of input");
+        }
+        captureStart = pos;
+
+        if (c == '"') {
+            scanString();
+        } else if (c == '{' || c == '[') {
+            int depth = 0;
+            do {
+                c = buffer[pos];
+                if (c == '"') {
+                    scanString();
+                } else {
+                    if (c == '{' || c == '[') {
+                        depth++;
+                    } else if (c == '}' || c == ']') {
+                        depth--;
+                    }
+                    pos++;
+                }
+                if (depth > 0 && pos >= buffer.size() && !fill()) {
+                    fail("unterminated value");
+                }
+            } while (depth > 0);
+        } else {
+            // Number or literal: consume until a structural character
+            while (true) {
+                if (pos >= buffer.size() && !fill()) {
+                    break;
+                }
+                c = buffer[pos];
+                if (c == ',' || c == '}' || c == ']' || c == ' ' ||
+                    c == '\n' || c == '\r' || c == '\t') {
+                    break;
+                }
+                pos++;
+            }
+        }
+
+        valueOffset = base + captureStart;
+        QByteArray raw = buffer.mid(captureStart, pos - captureStart);
+        captureStart = -1;
+        return raw;
+    }
+
+    static const qint64 CHUNK_SIZE = 64 * 1024;
+
+    QIODevice* device;
+    QByteArray buffer;
+    qsizetype pos;          // Read position in buffer
+    qint64 base;            // File offset of buffer[0]
+    qsizetype captureStart; // Start of the value being scanned, or -1
+    QList<bool> firstMember; // Per open object: no member read yet
+};
+
+} // namespace
+
 void JsonImporter::importFromFile(DocumentState& state, const QString& filePath) {
     // Read file
     QFile file(filePath);
@@ -21,44 +247,104 @@ void JsonImporter::importFromFile(DocumentState& state, const QString& filePath)
         );
     }
     
-    QByteArray data = file.readAll();
-    file.close();
+    // Stream the document. Everything is staged locally so a parse error part-way
+    // through leaves the current document untouched, as the DOM parser did.
+    JsonStreamReader reader(&file);
+    QMap<QString, RegionData> stagedRegions;
+    QJsonObject groupsObj;   // Only region names, small compared to regions
+    QString pdfPath;
+    bool hasRegions = false;
+    bool hasGroups = false;
+    bool hasPdfPath = false;
+    int skippedCount = 0;
     
-    // Parse JSON
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-    if (error.error != QJsonParseError::NoError) {
-        throw std::runtime_error(
-            QString("JSON parse error at offset %1: %2")
-                .arg(error.offset)
-                .arg(error.errorString())
-                .toStdString()
-        );
+    if (reader.peek() == '[') {
+        // Valid JSON that is not an object has no regions
+        reader.skipValue();
+        reader.expectEnd();
+        throw std::runtime_error("Invalid JSON: missing or invalid 'regions' field");
     }
     
-    QJsonObject root = doc.object();
+    reader.beginObject();
+    QString key;
+    while (reader.nextKey(key)) {
+        // Later duplicates of a key replace earlier ones, matching QJsonObject
+        if (key == "regions") {
+            hasRegions = reader.peek() == '{';
+            stagedRegions.clear();
+            skippedCount = 0;
+            if (!hasRegions) {
+                reader.skipValue();
+                continue;
+            }
+            
+            reader.beginObject();
+            QString name;
+            while (reader.nextKey(name)) {
+                QJsonValue value = reader.readValue();
+                try {
+                    RegionData region;
+                    if (parseRegion(name, value.toObject(), region)) {
+                        stagedRegions.insert(name, region);
+                    } else {
+                        stagedRegions.remove(name);
+                        skippedCount++;
+                    }
+                } catch (const std::exception& e) {
+                    OCR_ORC_WARNING("Error loading region" << name << ":" << e.what());
+                    stagedRegions.remove(name);
+                    skippedCount++;
+                }
+            }
+        } else if (key == "groups") {
+            hasGroups = reader.peek() == '{';
+            groupsObj = QJsonObject();
+            if (!hasGroups) {
+                reader.skipValue();
+                continue;
+            }
+            
+            reader.beginObject();
+            QString groupName;
+            while (reader.nextKey(groupName)) {
+                groupsObj.insert(groupName, reader.readValue());
+            }
+        } else if (key == "pdf_path") {
+            QJsonValue value = reader.readValue();
+            hasPdfPath = value.isString();
+            pdfPath = value.toString();
+        } else {
+            reader.skipValue();
+        }
+    }
+    reader.expectEnd();
+    file.close();
     
     // Validate structure
-    if (!root.contains("regions") || !root["regions"].isObject()) {
+    if (!hasRegions) {
         throw std::runtime_error("Invalid JSON: missing or invalid 'regions' field");
     }
     
+    if (skippedCount > 0) {
+        OCR_ORC_WARNING("Skipped" << skippedCount << "invalid regions during import");
+    }
+    
     // Clear existing regions and groups (fresh import)
     state.regions.clear();
     state.groups.clear();
     
     // Load PDF path if provided
-    if (root.contains("pdf_path") && root["pdf_path"].isString()) {
-        state.pdfPath = root["pdf_path"].toString();
+    if (hasPdfPath) {
+        state.pdfPath = pdfPath;
     }
     
-    // Load regions
-    QJsonObject regionsObj = root["regions"].toObject();
-    loadRegions(state, regionsObj);
+    // Load regions, releasing staged copies as we go
+    for (auto it = stagedRegions.begin(); it != stagedRegions.end(); it = stagedRegions.erase(it)) {
+        state.addRegion(it.key(), it.value());
+    }
     
     // Load groups (or reconstruct from region data)
-    if (root.contains("groups") && root["groups"].isObject()) {
-        QJsonObject groupsObj = root["groups"].toObject();
+    if (hasGroups) {
         loadGroups(state, groupsObj);
     } else {
         // Reconstruct groups from region data (backward compatibility)
@@ -108,102 +394,55 @@ NormalizedCoords JsonImporter::parseCoordinates(const QJsonValue& value) {
 }
 
 bool JsonImporter::validateCoordinates(const NormalizedCoords& coords) {
-    // Check all coordinates are in valid range [0.0, 1.0]
-    if (coords.x1 < 0.0 || coords.x1 > 1.0 ||
-        coords.y1 < 0.0 || coords.y1 > 1.0 ||
-        coords.x2 < 0.0 || coords.x2 > 1.0 ||
-        coords.y2 < 0.0 || coords.y2 > 1.0) {
+    // Same rules as project files
+    return CoordinateSystem::isValidRegionCoords(coords);
+}
+
+bool JsonImporter::parseRegion(const QString& name, const QJsonObject& regionObj, RegionData& region) {
+    // Parse coordinates
+    if (!regionObj.contains("normalized_coords")) {
+        OCR_ORC_WARNING("Skipping region" << name << ": missing normalized_coords");
         return false;
     }
     
-    // Check coordinates form a valid rectangle (x1 < x2, y1 < y2)
-    if (coords.x1 >= coords.x2 || coords.y1 >= coords.y2) {
+    NormalizedCoords coords = parseCoordinates(regionObj["normalized_coords"]);
+    
+    // Validate coordinates
+    if (!validateCoordinates(coords)) {
+        OCR_ORC_WARNING("Skipping region" << name << ": invalid coordinates");
         return false;
     }
     
-    return true;
-}
-
-void JsonImporter::loadRegions(DocumentState& state, const QJsonObject& regionsObj) {
-    int skippedCount = 0;
-    QStringList duplicateNames;
+    // Create region
+    region.name = name;
+    region.normalizedCoords = coords;
+    region.color = regionObj.contains("color") ? 
+                  regionObj["color"].toString("blue") : "blue";
+    region.group = regionObj.contains("group") && !regionObj["group"].isNull() ?
+                  regionObj["group"].toString("") : "";
     
-    for (auto it = regionsObj.begin(); it != regionsObj.end(); ++it) {
-        QString name = it.key();
-        QJsonObject regionObj = it.value().toObject();
-        
-        try {
-            // Check for duplicate region names
-            if (state.hasRegion(name)) {
-                duplicateNames.append(name);
-                OCR_ORC_WARNING("Skipping duplicate region" << name);
-                skippedCount++;
-                continue; // Skip duplicate
-            }
-            
-            // Parse coordinates
-            if (!regionObj.contains("normalized_coords")) {
-                OCR_ORC_WARNING("Skipping region" << name << ": missing normalized_coords");
-                skippedCount++;
-                continue;
-            }
-            
-            NormalizedCoords coords = parseCoordinates(regionObj["normalized_coords"]);
-            
-            // Validate coordinates
-            if (!validateCoordinates(coords)) {
-                OCR_ORC_WARNING("Skipping region" << name << ": invalid coordinates");
-                skippedCount++;
-                continue;
-            }
-            
-            // Create region
-            RegionData region;
-            region.name = name;
-            region.normalizedCoords = coords;
-            region.color = regionObj.contains("color") ? 
-                          regionObj["color"].toString("blue") : "blue";
-            region.group = regionObj.contains("group") && !regionObj["group"].isNull() ?
-                          regionObj["group"].toString("") : "";
-            
-            // Shape type (optional, defaults to "rect")
-            region.shapeType = regionObj.contains("shape_type") ?
-                              regionObj["shape_type"].toString("rect") : "rect";
-            
-            // Region type (optional, defaults to "none")
-            region.regionType = regionObj.contains("region_type") ?
-                               regionObj["region_type"].toString("none") : "none";
-            
-            // Percentage fill (optional, defaults to "none")
-            region.percentageFill = regionObj.contains("percentage_fill") ?
-                                   regionObj["percentage_fill"].toString("none") : "none";
-            
-            // Rotation angle (optional, defaults to 0.0)
-            region.rotationAngle = regionObj.contains("rotation_angle") ?
-                                  regionObj["rotation_angle"].toDouble(0.0) : 0.0;
-            // Validate rotation angle
-            if (!CoordinateSystem::isValidDouble(region.rotationAngle) || std::abs(region.rotationAngle) > 360.0) {
-                OCR_ORC_WARNING("Invalid rotation angle for region" << name << ", resetting to 0.0");
-                region.rotationAngle = 0.0;
-            }
-            
-            // Add to state
-            state.addRegion(name, region);
-            
-        } catch (const std::exception& e) {
-            OCR_ORC_WARNING("Error loading region" << name << ":" << e.what());
-            skippedCount++;
-        }
-    }
+    // Shape type (optional, defaults to "rect")
+    region.shapeType = regionObj.contains("shape_type") ?
+                      regionObj["shape_type"].toString("rect") : "rect";
     
-    // Report duplicates to user
-    if (!duplicateNames.isEmpty()) {
-        OCR_ORC_WARNING("Duplicate region names found and skipped:" << duplicateNames);
-    }
+    // Region type (optional, defaults to "none")
+    region.regionType = regionObj.contains("region_type") ?
+                       regionObj["region_type"].toString("none") : "none";
     
-    if (skippedCount > 0) {
-        OCR_ORC_WARNING("Skipped" << skippedCount << "invalid regions during import");
+    // Percentage fill (optional, defaults to "none")
+    region.percentageFill = regionObj.contains("percentage_fill") ?
+                           regionObj["percentage_fill"].toString("none") : "none";
+    
+    // Rotation angle (optional, defaults to 0.0)
+    region.rotationAngle = regionObj.contains("rotation_angle") ?
+                          regionObj["rotation_angle"].toDouble(0.0) : 0.0;
+    // Validate rotation angle
+    if (!CoordinateSystem::isValidDouble(region.rotationAngle) || std::abs(region.rotationAngle) > 360.0) {
+        OCR_ORC_WARNING("Invalid rotation angle for region" << name << ", resetting to 0.0");
+        region.rotationAngle = 0.0;
     }
+    
+    return true;
 }
 
 void JsonImporter::loadGroups(DocumentState& state, const QJsonObject& groupsObj) {
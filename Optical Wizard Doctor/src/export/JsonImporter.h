@@ -14,6 +14,8 @@ namespace ocr_orc {
  * 
  * Imports regions, groups, and metadata from JSON format.
  * Validates coordinates and reconstructs groups if missing.
+ * The file is read incrementally and regions are parsed one at a time, so
+ * memory use is bounded by the largest single region rather than the file.
  */
 class JsonImporter {
 public:
@@ -42,11 +44,14 @@ private:
     static bool validateCoordinates(const NormalizedCoords& coords);
     
     /**
-     * @brief Load regions from JSON object
-     * @param state DocumentState to populate
-     * @param regionsObj JSON object containing regions
+     * @brief Build a region from its JSON object
+     * @param name Region name (the key in the "regions" object)
+     * @param regionObj JSON object describing the region
+     * @param region Receives the parsed region
+     * @return false if the region is invalid and should be skipped
+     * @throws std::runtime_error if coordinates are malformed
      */
-    static void loadRegions(DocumentState& state, const QJsonObject& regionsObj);
+    static bool parseRegion(const QString& name, const QJsonObject& regionObj, RegionData& region);
     
     /**
      * @brief Load groups from JSON object
@@ -3,17 +3,83 @@
 #include "../core/Constants.h"
 #include "../core/CoordinateSystem.h"
 #include <QtGui/QImage>
-#include <QtGui/QPainter>
 #include <QtGui/QColor>
+#include <QtGui/QTransform>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
 #if OCR_ORC_DEBUG_ENABLED
 #include <QtCore/QDebug>
 #endif
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <stdexcept>
 
 namespace ocr_orc {
 
+namespace {
+
+void appendU16(QByteArray& out, quint16 value) {
+    quint16 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+void appendU32(QByteArray& out, quint32 value) {
+    quint32 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+/**
+ * @brief PackBits-encode one row (TIFF compression 32773)
+ */
+void packBitsRow(const uchar* src, int length, QByteArray& out) {
+    int i = 0;
+    while (i < length) {
+        // Replicate run
+        int run = 1;
+        while (i + run < length && run < 128 && src[i + run] == src[i]) {
+            run++;
+        }
+        if (run >= 2) {
+            out.append(static_cast<char>(1 - run));
+            out.append(static_cast<char>(src[i]));
+            i += run;
+            continue;
+        }
+        
+        // Literal run, up to the next repeat
+        int start = i;
+        int literal = 0;
+        while (i < length && literal < 128) {
+            if (i + 1 < length && src[i] == src[i + 1]) {
+                break;
+            }
+            i++;
+            literal++;
+        }
+        out.append(static_cast<char>(literal - 1));
+        out.append(reinterpret_cast<const char*>(src + start), literal);
+    }
+}
+
+/**
+ * @brief Number of segments so a polygonal ellipse stays within ~0.25px of the curve
+ */
+int ellipseSegments(double rx, double ry) {
+    double r = std::max(rx, ry);
+    if (r <= 1.0) {
+        return 16;
+    }
+    double step = std::acos(std::max(-1.0, 1.0 - 0.25 / r));
+    int segments = static_cast<int>(std::ceil(M_PI / step));
+    return std::clamp(segments, 16, 1024);
+}
+
+} // namespace
+
 void MaskGenerator::generate(const DocumentState& state, const QString& filePath) {
     // Validate image exists
     if (state.image.isNull()) {
@@ -25,12 +91,20 @@ void MaskGenerator::generate(const DocumentState& state, const QString& filePath
         throw std::runtime_error("No regions defined. Please create regions first.");
     }
     
-    // Create mask image
-    QImage mask = createMaskImage(state);
-    
-    // Save mask image
-    if (!mask.save(filePath)) {
-        throw std::runtime_error("Cannot save mask image. Check file path and permissions.");
+    QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "pbm") {
+        writePbm(renderMasks(state, false), filePath);
+    } else if (suffix == "tif" || suffix == "tiff") {
+        // All regions on page 1, then one page per group
+        writeTiff(renderMasks(state, true), filePath);
+    } else {
+        // Create mask image
+        QImage mask = createMaskImage(state);
+        
+        // Save mask image
+        if (!mask.save(filePath)) {
+            throw std::runtime_error("Cannot save mask image. Check file path and permissions.");
+        }
     }
     
     // Save coordinate JSON alongside mask
@@ -45,7 +119,40 @@ void MaskGenerator::generate(const DocumentState& state, const QString& filePath
     }
 }
 
-QImage MaskGenerator::createMaskImage(const DocumentState& state) {
+void MaskGenerator::generateBatch(const QList<const DocumentState*>& pages, const QString& filePath,
+                                  bool perGroup) {
+    if (pages.isEmpty()) {
+        throw std::runtime_error("No pages to generate masks for.");
+    }
+    
+    QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix != "pbm" && suffix != "tif" && suffix != "tiff") {
+        throw std::runtime_error("Batch masks must be written as .tif/.tiff or .pbm");
+    }
+    
+    QList<MaskPage> allPages;
+    for (int i = 0; i < pages.size(); ++i) {
+        const DocumentState* page = pages[i];
+        if (!page || page->image.isNull()) {
+            throw std::runtime_error(
+                QString("Page %1 has no image loaded.").arg(i + 1).toStdString()
+            );
+        }
+        
+        for (MaskPage& mask : renderMasks(*page, perGroup)) {
+            mask.name = QString("page %1: %2").arg(i + 1).arg(mask.name);
+            allPages.append(mask);
+        }
+    }
+    
+    if (suffix == "pbm") {
+        writePbm(allPages, filePath);
+    } else {
+        writeTiff(allPages, filePath);
+    }
+}
+
+QList<MaskPage> MaskGenerator::renderMasks(const DocumentState& state, bool perGroup) {
     // Get image dimensions
     int width = state.image.width();
     int height = state.image.height();
@@ -54,52 +161,356 @@ QImage MaskGenerator::createMaskImage(const DocumentState& state) {
         throw std::runtime_error("Invalid image dimensions");
     }
     
-    // Create black mask image
-    QImage mask(width, height, QImage::Format_RGB32);
-    mask.fill(QColor(0, 0, 0)); // Black background
-    
-    // Draw white rectangles for regions
-    QPainter painter(&mask);
-    painter.setRenderHint(QPainter::Antialiasing, false); // Sharp edges for OCR
+    // Allocate every page up front so pointers into the list stay valid
+    QList<MaskPage> pages;
+    pages.append({QString("all"), createBlankMask(width, height)});
+    QHash<QString, int> groupPage;
+    if (perGroup) {
+        for (auto it = state.groups.constBegin(); it != state.groups.constEnd(); ++it) {
+            groupPage.insert(it.key(), pages.size());
+            pages.append({it.key(), createBlankMask(width, height)});
+        }
+    }
     
-    for (auto it = state.regions.begin(); it != state.regions.end(); ++it) {
+    // Single pass: each region's spans go to the full mask and its group's mask
+    for (auto it = state.regions.constBegin(); it != state.regions.constEnd(); ++it) {
         const RegionData& region = it.value();
+        QList<QImage*> targets{&pages[0].mask};
+        auto group = groupPage.constFind(region.group);
+        if (group != groupPage.constEnd()) {
+            targets.append(&pages[group.value()].mask);
+        }
+        fillRegion(region, width, height, targets);
+    }
+    
+    return pages;
+}
+
+QImage MaskGenerator::createMaskImage(const DocumentState& state) {
+    return renderMasks(state, false).first().mask;
+}
+
+QImage MaskGenerator::createBlankMask(int width, int height) {
+    // 1 bit per pixel: index 0 = black (hidden), index 1 = white (visible)
+    QImage mask(width, height, QImage::Format_Mono);
+    mask.setColorCount(2);
+    mask.setColor(0, qRgb(0, 0, 0));
+    mask.setColor(1, qRgb(255, 255, 255));
+    mask.fill(0);
+    return mask;
+}
+
+void MaskGenerator::fillRegion(const RegionData& region, int width, int height,
+                               const QList<QImage*>& targets) {
+    // Use normalized coordinates (source of truth) instead of potentially stale imageCoords
+    NormalizedCoords norm = region.normalizedCoords;
+    
+    // Validate normalized coordinates before conversion
+    if (!CoordinateSystem::isValidNormalized(norm)) {
+        return; // Skip invalid region
+    }
+    
+    // Convert normalized coordinates to image coordinates
+    ImageCoords imgCoords = CoordinateSystem::normalizedToImage(norm, width, height);
+    
+    // Validate converted coordinates
+    if (!CoordinateSystem::isValidImage(imgCoords, width, height)) {
+        return; // Skip invalid region
+    }
+    
+    // Ensure coordinates are in order
+    int x1 = std::min(imgCoords.x1, imgCoords.x2);
+    int y1 = std::min(imgCoords.y1, imgCoords.y2);
+    int x2 = std::max(imgCoords.x1, imgCoords.x2);
+    int y2 = std::max(imgCoords.y1, imgCoords.y2);
+    
+    bool isEllipse = region.shapeType == "circle" || region.shapeType == "ellipse";
+    bool isTriangle = region.shapeType == "triangle";
+    bool isRotated = region.rotationAngle != 0.0 && CoordinateSystem::isValidDouble(region.rotationAngle);
+    
+    if (!isEllipse && !isTriangle && !isRotated) {
+        // Axis-aligned rectangle: straight span fill, same pixels the QPainter path produced
+        validateAndClampCoordinates(x1, y1, x2, y2, width, height);
+        if (x2 > x1 && y2 > y1) {
+            for (QImage* target : targets) {
+                for (int y = y1; y < y2; ++y) {
+                    fillSpan(target->scanLine(y), x1, x2);
+                }
+            }
+        }
+        return;
+    }
+    
+    // Build the outline as CanvasRenderer draws it, in image pixels
+    QRectF rect(x1, y1, x2 - x1, y2 - y1);
+    QPolygonF polygon;
+    if (isEllipse) {
+        double rx = rect.width() / 2.0;
+        double ry = rect.height() / 2.0;
+        QPointF center = rect.center();
+        int segments = ellipseSegments(rx, ry);
+        polygon.reserve(segments);
+        for (int i = 0; i < segments; ++i) {
+            double t = 2.0 * M_PI * i / segments;
+            polygon << QPointF(center.x() + rx * std::cos(t), center.y() + ry * std::sin(t));
+        }
+    } else if (isTriangle) {
+        // Top center, bottom left, bottom right
+        polygon << QPointF(rect.center().x(), rect.top())
+                << QPointF(rect.left(), rect.bottom())
+                << QPointF(rect.right(), rect.bottom());
+    } else {
+        polygon = QPolygonF(rect);
+    }
+    
+    // Rotate about the region center (same convention as QPainter::rotate)
+    if (isRotated) {
+        QPointF center = rect.center();
+        QTransform transform;
+        transform.translate(center.x(), center.y());
+        transform.rotate(region.rotationAngle);
+        transform.translate(-center.x(), -center.y());
+        polygon = transform.map(polygon);
+    }
+    
+    fillPolygonInto(polygon, targets);
+}
+
+void MaskGenerator::fillPolygon(QImage& mask, const QPolygonF& polygon) {
+    if (mask.format() != QImage::Format_Mono) {
+        throw std::runtime_error("fillPolygon requires a QImage::Format_Mono mask");
+    }
+    fillPolygonInto(polygon, QList<QImage*>{&mask});
+}
+
+void MaskGenerator::fillPolygonInto(const QPolygonF& polygon, const QList<QImage*>& targets) {
+    if (polygon.size() < 3 || targets.isEmpty()) {
+        return;
+    }
+    
+    const int width = targets.first()->width();
+    const int height = targets.first()->height();
+    
+    // Non-horizontal edges, oriented top to bottom
+    struct Edge {
+        double yTop;
+        double yBottom;
+        double xAtTop;
+        double dxdy;
+    };
+    QVector<Edge> edges;
+    edges.reserve(polygon.size());
+    for (int i = 0; i < polygon.size(); ++i) {
+        QPointF a = polygon[i];
+        QPointF b = polygon[(i + 1) % polygon.size()];
+        if (a.y() == b.y()) {
+            continue;
+        }
+        if (a.y() > b.y()) {
+            std::swap(a, b);
+        }
+        edges.append({a.y(), b.y(), a.x(), (b.x() - a.x()) / (b.y() - a.y())});
+    }
+    
+    // Rows whose pixel centers fall inside the polygon's vertical extent
+    QRectF bounds = polygon.boundingRect();
+    int rowStart = std::max(0, static_cast<int>(std::ceil(bounds.top() - 0.5)));
+    int rowEnd = std::min(height, static_cast<int>(std::ceil(bounds.bottom() - 0.5)));
+    
+    QVector<double> crossings;
+    crossings.reserve(16);
+    for (int y = rowStart; y < rowEnd; ++y) {
+        const double sampleY = y + 0.5;
+        crossings.clear();
+        for (const Edge& edge : edges) {
+            if (sampleY >= edge.yTop && sampleY < edge.yBottom) {
+                crossings.append(edge.xAtTop + (sampleY - edge.yTop) * edge.dxdy);
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
         
-        // Use normalized coordinates (source of truth) instead of potentially stale imageCoords
-        NormalizedCoords norm = region.normalizedCoords;
-        
-        // Validate normalized coordinates before conversion
-        if (!CoordinateSystem::isValidNormalized(norm)) {
-            continue; // Skip invalid region
+        // Even-odd: pixels whose centers lie in [crossing[k], crossing[k+1])
+        for (int k = 0; k + 1 < crossings.size(); k += 2) {
+            int spanStart = std::max(0, static_cast<int>(std::ceil(crossings[k] - 0.5)));
+            int spanEnd = std::min(width, static_cast<int>(std::ceil(crossings[k + 1] - 0.5)));
+            if (spanEnd > spanStart) {
+                for (QImage* target : targets) {
+                    fillSpan(target->scanLine(y), spanStart, spanEnd);
+                }
+            }
         }
+    }
+}
+
+void MaskGenerator::fillSpan(uchar* row, int x1, int x2) {
+    // Format_Mono is MSB-first: pixel x is bit (7 - x % 8) of byte x / 8
+    const int firstByte = x1 >> 3;
+    const int lastByte = (x2 - 1) >> 3;
+    const uchar firstMask = static_cast<uchar>(0xFF >> (x1 & 7));
+    const uchar lastMask = static_cast<uchar>(0xFF << (7 - ((x2 - 1) & 7)));
+    
+    if (firstByte == lastByte) {
+        row[firstByte] |= firstMask & lastMask;
+        return;
+    }
+    row[firstByte] |= firstMask;
+    if (lastByte - firstByte > 1) {
+        std::memset(row + firstByte + 1, 0xFF, lastByte - firstByte - 1);
+    }
+    row[lastByte] |= lastMask;
+}
+
+void MaskGenerator::writePbm(const QList<MaskPage>& pages, const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error(
+            QString("Cannot open file for writing: %1").arg(file.errorString()).toStdString()
+        );
+    }
+    
+    for (const MaskPage& page : pages) {
+        const QImage& mask = page.mask;
+        const int rowBytes = (mask.width() + 7) / 8;
         
-        // Convert normalized coordinates to image coordinates
-        ImageCoords imgCoords = CoordinateSystem::normalizedToImage(norm, width, height);
+        // P4 header; the page name goes in a comment
+        QByteArray header = "P4\n# " + page.name.toUtf8().replace('\n', ' ') + "\n" +
+                            QByteArray::number(mask.width()) + " " +
+                            QByteArray::number(mask.height()) + "\n";
+        file.write(header);
         
-        // Validate converted coordinates
-        if (!CoordinateSystem::isValidImage(imgCoords, width, height)) {
-            continue; // Skip invalid region
+        // PBM uses 1 = black, so invert our 1 = white rows
+        QByteArray row(rowBytes, '\0');
+        for (int y = 0; y < mask.height(); ++y) {
+            const uchar* src = mask.constScanLine(y);
+            for (int i = 0; i < rowBytes; ++i) {
+                row[i] = static_cast<char>(~src[i]);
+            }
+            file.write(row);
         }
+    }
+    
+    file.close();
+    if (file.error() != QFile::NoError) {
+        throw std::runtime_error(
+            QString("Error writing file: %1").arg(file.errorString()).toStdString()
+        );
+    }
+}
+
+void MaskGenerator::writeTiff(const QList<MaskPage>& pages, const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error(
+            QString("Cannot open file for writing: %1").arg(file.errorString()).toStdString()
+        );
+    }
+    
+    // Little-endian TIFF header; first IFD directly follows
+    QByteArray header("II");
+    appendU16(header, 42);
+    appendU32(header, 8);
+    file.write(header);
+    
+    // Tag types
+    const quint16 SHORT = 3;
+    const quint16 LONG = 4;
+    const quint16 ASCII = 2;
+    const quint16 RATIONAL = 5;
+    const int ENTRY_COUNT = 15;
+    const quint32 ifdSize = 2 + ENTRY_COUNT * 12 + 4;
+    
+    quint32 pageOffset = 8;
+    for (int p = 0; p < pages.size(); ++p) {
+        const QImage& mask = pages[p].mask;
+        const int rowBytes = (mask.width() + 7) / 8;
         
-        // Ensure coordinates are in order
-        int x1 = std::min(imgCoords.x1, imgCoords.x2);
-        int y1 = std::min(imgCoords.y1, imgCoords.y2);
-        int x2 = std::max(imgCoords.x1, imgCoords.x2);
-        int y2 = std::max(imgCoords.y1, imgCoords.y2);
+        // Compress first so the next IFD offset is known when writing this one
+        QByteArray strip;
+        for (int y = 0; y < mask.height(); ++y) {
+            packBitsRow(mask.constScanLine(y), rowBytes, strip);
+        }
         
-        // Validate and clamp to image bounds
-        validateAndClampCoordinates(x1, y1, x2, y2, width, height);
+        QByteArray pageName = pages[p].name.toLatin1();
+        pageName.append('\0');
         
-        // Ensure rectangle has positive size
-        if (x2 > x1 && y2 > y1) {
-            // Draw white rectangle
-            painter.fillRect(x1, y1, x2 - x1, y2 - y1, QColor(255, 255, 255));
+        // Page layout: IFD, X/Y resolution rationals, page name, strip
+        const quint32 resolutionOffset = pageOffset + ifdSize;
+        const quint32 nameOffset = resolutionOffset + 16;
+        const quint32 stripOffset = (nameOffset + pageName.size() + 1) & ~1u;
+        const quint32 pageEnd = (stripOffset + strip.size() + 1) & ~1u;
+        const quint32 nextIfd = (p + 1 < pages.size()) ? pageEnd : 0;
+        
+        QByteArray ifd;
+        auto entry = [&ifd](quint16 tag, quint16 type, quint32 count, quint32 value) {
+            appendU16(ifd, tag);
+            appendU16(ifd, type);
+            appendU32(ifd, count);
+            if (type == SHORT && count == 1) {
+                // SHORT values are left-justified in the 4-byte field
+                appendU16(ifd, static_cast<quint16>(value));
+                appendU16(ifd, 0);
+            } else {
+                appendU32(ifd, value);
+            }
+        };
+        
+        appendU16(ifd, ENTRY_COUNT);
+        entry(254, LONG, 1, 2);                      // NewSubfileType: page of multi-page
+        entry(256, LONG, 1, mask.width());           // ImageWidth
+        entry(257, LONG, 1, mask.height());          // ImageLength
+        entry(258, SHORT, 1, 1);                     // BitsPerSample
+        entry(259, SHORT, 1, 32773);                 // Compression: PackBits
+        entry(262, SHORT, 1, 1);                     // Photometric: BlackIsZero (1 = white)
+        entry(273, LONG, 1, stripOffset);            // StripOffsets
+        entry(277, SHORT, 1, 1);                     // SamplesPerPixel
+        entry(278, LONG, 1, mask.height());          // RowsPerStrip
+        entry(279, LONG, 1, strip.size());           // StripByteCounts
+        entry(282, RATIONAL, 1, resolutionOffset);   // XResolution
+        entry(283, RATIONAL, 1, resolutionOffset + 8); // YResolution
+        if (pageName.size() <= 4) {
+            // Values of 4 bytes or fewer are stored inline
+            QByteArray inlineName = pageName.leftJustified(4, '\0');
+            appendU16(ifd, 285);
+            appendU16(ifd, ASCII);
+            appendU32(ifd, pageName.size());
+            ifd.append(inlineName);
+        } else {
+            entry(285, ASCII, pageName.size(), nameOffset); // PageName
         }
+        entry(296, SHORT, 1, 2);                     // ResolutionUnit: inch
+        // PageNumber: two SHORTs (page, total) packed in the value field
+        appendU16(ifd, 297);
+        appendU16(ifd, SHORT);
+        appendU32(ifd, 2);
+        appendU16(ifd, static_cast<quint16>(p));
+        appendU16(ifd, static_cast<quint16>(pages.size()));
+        appendU32(ifd, nextIfd);
+        
+        // Resolution is informational for masks; use the render DPI
+        QByteArray extras;
+        appendU32(extras, PdfConstants::DEFAULT_DPI);
+        appendU32(extras, 1);
+        appendU32(extras, PdfConstants::DEFAULT_DPI);
+        appendU32(extras, 1);
+        extras.append(pageName);
+        extras.append(QByteArray(stripOffset - nameOffset - pageName.size(), '\0'));
+        
+        file.write(ifd);
+        file.write(extras);
+        file.write(strip);
+        if (pageEnd > stripOffset + strip.size()) {
+            file.write(QByteArray(1, '\0'));
+        }
+        
+        pageOffset = pageEnd;
     }
     
-    painter.end();
-    
-    return mask;
+    file.close();
+    if (file.error() != QFile::NoError) {
+        throw std::runtime_error(
+            QString("Error writing file: %1").arg(file.errorString()).toStdString()
+        );
+    }
 }
 
 void MaskGenerator::validateAndClampCoordinates(int& x1, int& y1, int& x2, int& y2,
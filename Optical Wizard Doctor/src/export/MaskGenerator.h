@@ -3,15 +3,36 @@
 
 #include "../models/DocumentState.h"
 #include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtGui/QImage>
+#include <QtGui/QPolygonF>
 
 namespace ocr_orc {
 
+/**
+ * @brief One mask page: a 1-bit image plus the name written into multi-page files
+ */
+struct MaskPage {
+    QString name;   // "all" for the page with every region, otherwise the group name
+    QImage mask;    // QImage::Format_Mono, index 0 = black (hidden), 1 = white (visible)
+};
+
 /**
  * @brief Mask image generator for OCR preprocessing
  * 
  * Generates black/white mask images where:
  * - Background is black (everything hidden)
- * - Regions are white rectangles (visible for OCR)
+ * - Regions are white shapes (visible for OCR)
+ * 
+ * Masks are rasterized straight into 1-bit packed QImage::Format_Mono buffers
+ * by a scanline span filler, honouring shapeType (rect, circle/ellipse,
+ * triangle) and rotationAngle the same way CanvasRenderer draws them.
+ * 
+ * Output format follows the file extension:
+ * - .pbm: binary PBM (P4); one image per page, concatenated
+ * - .tif/.tiff: multi-page bilevel TIFF (PackBits), first page all regions,
+ *   then one page per group
+ * - anything else: saved through QImage (1-bit where the format allows)
  * 
  * Uses IMAGE coordinates (pixels), not canvas or normalized.
  */
@@ -25,14 +46,70 @@ public:
      */
     static void generate(const DocumentState& state, const QString& filePath);
     
+    /**
+     * @brief Generate masks for several pages into one multi-page file
+     * @param pages One DocumentState per page
+     * @param filePath Path to output .tif/.tiff or .pbm file
+     * @param perGroup Also emit one page per group after each page's full mask
+     * @throws std::runtime_error if generation fails
+     */
+    static void generateBatch(const QList<const DocumentState*>& pages, const QString& filePath,
+                              bool perGroup = true);
+    
+    /**
+     * @brief Rasterize the mask of all regions and (optionally) one per group in a single pass
+     * @param state DocumentState containing regions and image
+     * @param perGroup Also produce one mask per group
+     * @return Pages, the full mask first, then groups in name order
+     */
+    static QList<MaskPage> renderMasks(const DocumentState& state, bool perGroup);
+    
+    /**
+     * @brief Fill a polygon into a 1-bit mask (pixels whose centers are inside)
+     * @param mask QImage::Format_Mono mask to draw into
+     * @param polygon Polygon in image pixel coordinates
+     */
+    static void fillPolygon(QImage& mask, const QPolygonF& polygon);
+
 private:
     /**
-     * @brief Create mask image with white rectangles for regions
+     * @brief Create 1-bit mask image with white shapes for regions
      * @param state DocumentState containing regions and image
-     * @return QImage mask (black background, white rectangles)
+     * @return QImage mask (Format_Mono, black background, white shapes)
      */
     static QImage createMaskImage(const DocumentState& state);
     
+    /**
+     * @brief Create an empty (all black) 1-bit mask
+     */
+    static QImage createBlankMask(int width, int height);
+    
+    /**
+     * @brief Rasterize one region into one or more masks of the same size
+     */
+    static void fillRegion(const RegionData& region, int width, int height,
+                           const QList<QImage*>& targets);
+    
+    /**
+     * @brief Scanline-fill a polygon into one or more masks of the same size
+     */
+    static void fillPolygonInto(const QPolygonF& polygon, const QList<QImage*>& targets);
+    
+    /**
+     * @brief Set pixels [x1, x2) of a packed 1-bit row to white
+     */
+    static void fillSpan(uchar* row, int x1, int x2);
+    
+    /**
+     * @brief Write pages as concatenated binary PBM (P4) images
+     */
+    static void writePbm(const QList<MaskPage>& pages, const QString& filePath);
+    
+    /**
+     * @brief Write pages as a multi-page bilevel TIFF (PackBits compressed)
+     */
+    static void writeTiff(const QList<MaskPage>& pages, const QString& filePath);
+    
     /**
      * @brief Validate and clamp coordinates to image bounds
      * @param x1 Left coordinate (output)
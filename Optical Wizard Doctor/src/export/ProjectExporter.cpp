@@ -0,0 +1,279 @@
+#include "ProjectExporter.h"
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+#include <QtCore/QSysInfo>
+#include <QtGui/QImage>
+#include <cstring>
+#include <stdexcept>
+
+namespace ocr_orc {
+
+namespace {
+
+/**
+ * @brief Deduplicating UTF-8 string table (colors and types repeat a lot)
+ */
+class StringTable {
+public:
+    quint32 add(const QString& value) {
+        if (value.isEmpty()) {
+            return ProjectFormat::NO_STRING;
+        }
+        auto it = indices.constFind(value);
+        if (it != indices.constEnd()) {
+            return it.value();
+        }
+        quint32 index = static_cast<quint32>(offsets.size());
+        offsets.append(static_cast<quint32>(data.size()));
+        data.append(value.toUtf8());
+        indices.insert(value, index);
+        return index;
+    }
+
+    QByteArray serialize() const {
+        // quint32 count, quint32 offsets[count + 1], UTF-8 bytes
+        QVector<quint32> table = offsets;
+        table.append(static_cast<quint32>(data.size()));
+        quint32 count = static_cast<quint32>(offsets.size());
+
+        QByteArray out;
+        out.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.append(reinterpret_cast<const char*>(table.constData()), table.size() * sizeof(quint32));
+        out.append(data);
+        return out;
+    }
+
+    quint32 count() const { return static_cast<quint32>(offsets.size()); }
+
+private:
+    QHash<QString, quint32> indices;
+    QVector<quint32> offsets;
+    QByteArray data;
+};
+
+/**
+ * @brief Append a column to a struct-of-arrays section, keeping 8-byte alignment
+ */
+template <typename T>
+void appendColumn(QByteArray& section, const QVector<T>& column) {
+    section.append(reinterpret_cast<const char*>(column.constData()), column.size() * sizeof(T));
+    section.append(QByteArray(ProjectFormat::alignUp(section.size(), 8) - section.size(), '\0'));
+}
+
+struct PendingSection {
+    quint32 type;
+    quint64 count;
+    QByteArray bytes;       // Section body (raster pixels are streamed separately)
+    quint64 extraBytes;     // Pixel bytes following the body for the raster section
+};
+
+} // namespace
+
+void ProjectExporter::exportToFile(const DocumentState& state, const QString& filePath,
+                                   const QList<ProjectOcrWord>& ocrWords) {
+    if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) {
+        throw std::runtime_error("Project files can only be written on little-endian hosts");
+    }
+
+    StringTable strings;
+    QList<PendingSection> sections;
+
+    // Palette-based images would need their color table; store them as ARGB32
+    QImage image = state.image;
+    if (!image.isNull() && image.colorCount() > 0) {
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    // Document
+    {
+        ProjectFormat::DocumentSection doc;
+        std::memset(&doc, 0, sizeof(doc));
+        doc.pdfPath = strings.add(state.pdfPath);
+        doc.imageWidth = image.isNull() ? 0 : static_cast<quint32>(image.width());
+        doc.imageHeight = image.isNull() ? 0 : static_cast<quint32>(image.height());
+        sections.append({ProjectFormat::SECTION_DOCUMENT, 1,
+                         QByteArray(reinterpret_cast<const char*>(&doc), sizeof(doc)), 0});
+    }
+
+    // Regions (QMap order, so index i is stable for group membership below)
+    QHash<QString, quint32> regionIndex;
+    {
+        const int n = state.regions.size();
+        QVector<double> x1, y1, x2, y2, rotation;
+        QVector<quint32> name, color, group, shapeType, regionType, percentageFill;
+        for (auto* column : {&x1, &y1, &x2, &y2, &rotation}) column->reserve(n);
+        for (auto* column : {&name, &color, &group, &shapeType, &regionType, &percentageFill}) column->reserve(n);
+
+        for (auto it = state.regions.constBegin(); it != state.regions.constEnd(); ++it) {
+            const RegionData& region = it.value();
+            regionIndex.insert(it.key(), static_cast<quint32>(x1.size()));
+            x1.append(region.normalizedCoords.x1);
+            y1.append(region.normalizedCoords.y1);
+            x2.append(region.normalizedCoords.x2);
+            y2.append(region.normalizedCoords.y2);
+            rotation.append(region.rotationAngle);
+            name.append(strings.add(it.key()));
+            color.append(strings.add(region.color));
+            group.append(strings.add(region.group));
+            shapeType.append(strings.add(region.shapeType));
+            regionType.append(strings.add(region.regionType));
+            percentageFill.append(strings.add(region.percentageFill));
+        }
+
+        QByteArray bytes;
+        for (auto* column : {&x1, &y1, &x2, &y2, &rotation}) appendColumn(bytes, *column);
+        for (auto* column : {&name, &color, &group, &shapeType, &regionType, &percentageFill}) appendColumn(bytes, *column);
+        sections.append({ProjectFormat::SECTION_REGIONS, static_cast<quint64>(n), bytes, 0});
+    }
+
+    // Groups
+    {
+        QVector<quint32> groupName;
+        QVector<quint32> memberStart;
+        QVector<quint32> members;
+        for (auto it = state.groups.constBegin(); it != state.groups.constEnd(); ++it) {
+            groupName.append(strings.add(it.key()));
+            memberStart.append(static_cast<quint32>(members.size()));
+            for (const QString& regionName : it.value().regionNames) {
+                auto found = regionIndex.constFind(regionName);
+                if (found != regionIndex.constEnd()) {
+                    members.append(found.value());
+                }
+            }
+        }
+        memberStart.append(static_cast<quint32>(members.size()));
+
+        QByteArray bytes;
+        appendColumn(bytes, groupName);
+        appendColumn(bytes, memberStart);
+        appendColumn(bytes, members);
+        sections.append({ProjectFormat::SECTION_GROUPS, static_cast<quint64>(groupName.size()), bytes, 0});
+    }
+
+    // Cached OCR words
+    if (!ocrWords.isEmpty()) {
+        const int n = ocrWords.size();
+        QVector<double> x1, y1, x2, y2;
+        QVector<float> confidence;
+        QVector<qint32> blockId, lineId, wordId;
+        QVector<quint32> text;
+        for (const ProjectOcrWord& word : ocrWords) {
+            x1.append(word.coords.x1);
+            y1.append(word.coords.y1);
+            x2.append(word.coords.x2);
+            y2.append(word.coords.y2);
+            confidence.append(word.confidence);
+            blockId.append(word.blockId);
+            lineId.append(word.lineId);
+            wordId.append(word.wordId);
+            text.append(strings.add(word.text));
+        }
+
+        QByteArray bytes;
+        for (auto* column : {&x1, &y1, &x2, &y2}) appendColumn(bytes, *column);
+        appendColumn(bytes, confidence);
+        for (auto* column : {&blockId, &lineId, &wordId}) appendColumn(bytes, *column);
+        appendColumn(bytes, text);
+        sections.append({ProjectFormat::SECTION_OCR_WORDS, static_cast<quint64>(n), bytes, 0});
+    }
+
+    // Raster header; pixel rows are copied straight from the QImage when writing
+    if (!image.isNull()) {
+        ProjectFormat::RasterSection raster;
+        std::memset(&raster, 0, sizeof(raster));
+        raster.width = static_cast<quint32>(image.width());
+        raster.height = static_cast<quint32>(image.height());
+        raster.bytesPerLine = static_cast<quint32>(image.bytesPerLine());
+        raster.imageFormat = static_cast<quint32>(image.format());
+        raster.dataOffset = ProjectFormat::alignUp(sizeof(raster), ProjectFormat::SECTION_ALIGNMENT);
+
+        QByteArray bytes(reinterpret_cast<const char*>(&raster), sizeof(raster));
+        bytes.append(QByteArray(raster.dataOffset - sizeof(raster), '\0'));
+        sections.append({ProjectFormat::SECTION_RASTER, 1, bytes,
+                         static_cast<quint64>(image.sizeInBytes())});
+    }
+
+    // Strings last: every other section has registered its strings by now
+    sections.prepend({ProjectFormat::SECTION_STRINGS, strings.count(), strings.serialize(), 0});
+
+    // Lay out sections
+    QVector<ProjectFormat::SectionEntry> entries;
+    quint64 offset = ProjectFormat::alignUp(sizeof(ProjectFormat::FileHeader) +
+                                            sections.size() * sizeof(ProjectFormat::SectionEntry),
+                                            ProjectFormat::SECTION_ALIGNMENT);
+    for (const PendingSection& section : sections) {
+        ProjectFormat::SectionEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.type = section.type;
+        entry.offset = offset;
+        entry.size = section.bytes.size() + section.extraBytes;
+        entry.count = section.count;
+        entries.append(entry);
+        offset = ProjectFormat::alignUp(offset + entry.size, ProjectFormat::SECTION_ALIGNMENT);
+    }
+
+    ProjectFormat::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ProjectFormat::MAGIC, sizeof(header.magic));
+    header.versionMajor = ProjectFormat::VERSION_MAJOR;
+    header.versionMinor = ProjectFormat::VERSION_MINOR;
+    header.sectionCount = static_cast<quint32>(entries.size());
+    header.fileSize = offset;
+    header.headerSize = sizeof(ProjectFormat::FileHeader);
+    header.sectionEntrySize = sizeof(ProjectFormat::SectionEntry);
+
+    // Create temp file path for atomic write
+    QString tempPath = filePath + ".tmp";
+    QFile tempFile(tempPath);
+    if (!tempFile.open(QIODevice::WriteOnly)) {
+        throw std::runtime_error(
+            QString("Cannot open file for writing: %1").arg(tempFile.errorString()).toStdString()
+        );
+    }
+
+    auto padTo = [&tempFile](quint64 position) {
+        quint64 current = static_cast<quint64>(tempFile.pos());
+        if (position > current) {
+            tempFile.write(QByteArray(position - current, '\0'));
+        }
+    };
+
+    tempFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    tempFile.write(reinterpret_cast<const char*>(entries.constData()),
+                   entries.size() * sizeof(ProjectFormat::SectionEntry));
+    for (int i = 0; i < sections.size(); ++i) {
+        padTo(entries[i].offset);
+        tempFile.write(sections[i].bytes);
+        if (sections[i].type == ProjectFormat::SECTION_RASTER) {
+            tempFile.write(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes());
+        }
+    }
+    padTo(header.fileSize);
+    tempFile.close();
+
+    // Verify write succeeded
+    if (tempFile.error() != QFile::NoError) {
+        QFile::remove(tempPath);
+        throw std::runtime_error(
+            QString("Error writing file: %1").arg(tempFile.errorString()).toStdString()
+        );
+    }
+
+    // Remove existing file if it exists
+    if (QFile::exists(filePath)) {
+        if (!QFile::remove(filePath)) {
+            QFile::remove(tempPath);
+            throw std::runtime_error("Cannot remove existing file");
+        }
+    }
+
+    // Atomic rename
+    if (!QFile::rename(tempPath, filePath)) {
+        QFile::remove(tempPath);
+        throw std::runtime_error("Cannot rename temp file to final file");
+    }
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,38 @@
+#ifndef PROJECT_EXPORTER_H
+#define PROJECT_EXPORTER_H
+
+#include "ProjectFormat.h"
+#include "../models/DocumentState.h"
+#include <QtCore/QString>
+#include <QtCore/QList>
+
+namespace ocr_orc {
+
+/**
+ * @brief Binary project exporter for DocumentState
+ *
+ * Writes the rendered page raster, region geometry, groups and (optionally)
+ * cached OCR word boxes into a single .orcproj container that can be reopened
+ * by memory-mapping it (see ProjectFileView). Complements JsonExporter, which
+ * remains the interchange format.
+ */
+class ProjectExporter {
+public:
+    /**
+     * @brief Export DocumentState to a binary project file
+     * @param state DocumentState to export (image is stored as rendered)
+     * @param filePath Path to output .orcproj file
+     * @param ocrWords Cached OCR word boxes to store alongside the document
+     * @throws std::runtime_error if export fails
+     */
+    static void exportToFile(const DocumentState& state, const QString& filePath,
+                             const QList<ProjectOcrWord>& ocrWords = QList<ProjectOcrWord>());
+
+private:
+    // Private constructor - this is a utility class with only static methods
+    ProjectExporter() = delete;
+};
+
+} // namespace ocr_orc
+
+#endif // PROJECT_EXPORTER_H
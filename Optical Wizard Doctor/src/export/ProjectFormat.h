@@ -0,0 +1,125 @@
+#ifndef PROJECT_FORMAT_H
+#define PROJECT_FORMAT_H
+
+#include "../core/CoordinateSystem.h"
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <cstdint>
+
+namespace ocr_orc {
+
+/**
+ * @brief Cached OCR word box stored in a project file
+ *
+ * Plain data (no OpenCV types) so project I/O does not depend on the OCR stack.
+ */
+struct ProjectOcrWord {
+    NormalizedCoords coords;  // Word box, normalized (0.0-1.0)
+    QString text;             // Recognized text
+    float confidence;         // OCR confidence (0.0-100.0)
+    int blockId;              // OCR block/paragraph ID
+    int lineId;               // OCR line ID within block
+    int wordId;               // Word ID within line
+
+    ProjectOcrWord() : confidence(0.0f), blockId(0), lineId(0), wordId(0) {}
+};
+
+/**
+ * @brief On-disk layout of the binary project container (.orcproj)
+ *
+ * The file is designed to be memory-mapped and used in place:
+ *
+ *   FileHeader
+ *   SectionEntry[sectionCount]
+ *   sections, each starting on a SECTION_ALIGNMENT boundary
+ *
+ * All integers are little-endian. Every array inside a section starts on an
+ * 8-byte boundary, so mapped pointers can be read directly as double/uint32.
+ * Strings live once in the STRINGS section and are referenced by index.
+ *
+ * Readers must reject files whose major version differs from VERSION_MAJOR;
+ * unknown section types are skipped, so new sections only bump VERSION_MINOR.
+ */
+namespace ProjectFormat {
+
+constexpr char MAGIC[8] = {'O', 'C', 'R', 'O', 'R', 'C', 'P', '\0'};
+constexpr quint16 VERSION_MAJOR = 1;
+constexpr quint16 VERSION_MINOR = 0;
+constexpr quint64 SECTION_ALIGNMENT = 64;
+constexpr quint32 NO_STRING = 0xFFFFFFFFu;  // String reference meaning "empty"
+constexpr const char* FILE_EXTENSION = ".orcproj";
+
+enum SectionType : quint32 {
+    SECTION_DOCUMENT  = 1,  // DocumentSection
+    SECTION_STRINGS   = 2,  // quint32 count, quint32 offsets[count + 1], UTF-8 bytes
+    SECTION_RASTER    = 3,  // RasterSection followed by pixel rows
+    SECTION_REGIONS   = 4,  // Region geometry and metadata, struct of arrays
+    SECTION_GROUPS    = 5,  // Group names and member region indices
+    SECTION_OCR_WORDS = 6   // Cached OCR word boxes, struct of arrays
+};
+
+struct FileHeader {
+    char magic[8];
+    quint16 versionMajor;
+    quint16 versionMinor;
+    quint32 sectionCount;
+    quint64 fileSize;        // Total bytes, used to detect truncation
+    quint32 headerSize;      // sizeof(FileHeader)
+    quint32 sectionEntrySize; // sizeof(SectionEntry)
+    quint8 reserved[32];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+
+struct SectionEntry {
+    quint32 type;            // SectionType
+    quint32 reserved;
+    quint64 offset;          // From start of file
+    quint64 size;            // Bytes
+    quint64 count;           // Element count (regions, groups, words, strings)
+};
+static_assert(sizeof(SectionEntry) == 32, "SectionEntry must stay 32 bytes");
+
+struct DocumentSection {
+    quint32 pdfPath;         // String index or NO_STRING
+    quint32 imageWidth;      // Page size in pixels (0 if no raster)
+    quint32 imageHeight;
+    quint32 reserved;
+};
+
+struct RasterSection {
+    quint32 width;
+    quint32 height;
+    quint32 bytesPerLine;
+    quint32 imageFormat;     // QImage::Format value
+    quint64 dataOffset;      // Pixel data offset from start of section
+};
+
+/*
+ * SECTION_REGIONS layout for count = N (each array 8-byte aligned):
+ *   double   x1[N], y1[N], x2[N], y2[N], rotation[N]
+ *   quint32  name[N], color[N], group[N], shapeType[N], regionType[N], percentageFill[N]
+ *
+ * SECTION_GROUPS layout for count = G with M members in total:
+ *   quint32  name[G]
+ *   quint32  memberStart[G + 1]   (members of group g are member[memberStart[g] .. memberStart[g+1]])
+ *   quint32  member[M]            (indices into the regions arrays)
+ *
+ * SECTION_OCR_WORDS layout for count = W:
+ *   double   x1[W], y1[W], x2[W], y2[W]
+ *   float    confidence[W]
+ *   qint32   blockId[W], lineId[W], wordId[W]
+ *   quint32  text[W]
+ */
+
+/**
+ * @brief Round up to the next multiple of alignment (power of two)
+ */
+constexpr quint64 alignUp(quint64 value, quint64 alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace ProjectFormat
+
+} // namespace ocr_orc
+
+#endif // PROJECT_FORMAT_H
@@ -0,0 +1,383 @@
+#include "ProjectImporter.h"
+#include "../core/Constants.h"
+#include "../core/CoordinateSystem.h"
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSysInfo>
+#include <QtGui/QPixelFormat>
+#if OCR_ORC_DEBUG_ENABLED
+#include <QtCore/QDebug>
+#endif
+#include <cstring>
+#include <stdexcept>
+
+namespace ocr_orc {
+
+namespace {
+
+[[noreturn]] void malformed(const char* what) {
+    throw std::runtime_error(QString("Invalid project file: %1").arg(QString::fromLatin1(what)).toStdString());
+}
+
+/**
+ * @brief Bounds-checked walk over the columns of one section
+ */
+class SectionCursor {
+public:
+    SectionCursor(const uchar* base, quint64 size) : base(base), size(size), pos(0) {}
+
+    template <typename T>
+    const T* take(quint64 count) {
+        if (count > (size - pos) / sizeof(T)) {
+            malformed("section is shorter than its element count");
+        }
+        const T* column = reinterpret_cast<const T*>(base + pos);
+        pos = ProjectFormat::alignUp(pos + count * sizeof(T), 8);
+        pos = qMin(pos, size);
+        return column;
+    }
+
+    quint64 remaining() const { return size - pos; }
+    const uchar* current() const { return base + pos; }
+
+private:
+    const uchar* base;
+    quint64 size;
+    quint64 pos;
+};
+
+void releaseMapping(void* info) {
+    delete static_cast<QSharedPointer<QFile>*>(info);
+}
+
+} // namespace
+
+ProjectFileView::ProjectFileView(const QString& filePath)
+    : file(new QFile(filePath))
+    , data(nullptr)
+    , size(0)
+    , header(nullptr)
+    , stringCount(0)
+    , stringOffsets(nullptr)
+    , stringData(nullptr)
+    , stringDataSize(0)
+    , document(nullptr)
+    , raster(nullptr)
+    , rasterPixels(nullptr)
+    , regionCountValue(0)
+    , regionX1Data(nullptr)
+    , regionY1Data(nullptr)
+    , regionX2Data(nullptr)
+    , regionY2Data(nullptr)
+    , regionRotationData(nullptr)
+    , regionStrings{}
+    , groupCountValue(0)
+    , groupNameData(nullptr)
+    , groupMemberStartData(nullptr)
+    , groupMembersData(nullptr)
+    , ocrWordCountValue(0)
+    , ocrCoords{}
+    , ocrConfidenceData(nullptr)
+    , ocrIds{}
+    , ocrTextData(nullptr)
+{
+    if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) {
+        throw std::runtime_error("Project files can only be read on little-endian hosts");
+    }
+
+    if (!file->open(QIODevice::ReadOnly)) {
+        throw std::runtime_error(
+            QString("Cannot open file for reading: %1").arg(file->errorString()).toStdString()
+        );
+    }
+
+    size = static_cast<quint64>(file->size());
+    if (size < sizeof(ProjectFormat::FileHeader)) {
+        malformed("file is too small");
+    }
+
+    // Map the whole file; pages are only read from disk when touched
+    data = file->map(0, file->size());
+    if (!data) {
+        throw std::runtime_error(
+            QString("Cannot map file: %1").arg(file->errorString()).toStdString()
+        );
+    }
+
+    header = reinterpret_cast<const ProjectFormat::FileHeader*>(data);
+    if (std::memcmp(header->magic, ProjectFormat::MAGIC, sizeof(header->magic)) != 0) {
+        malformed("bad magic");
+    }
+    if (header->versionMajor != ProjectFormat::VERSION_MAJOR) {
+        throw std::runtime_error(
+            QString("Unsupported project file version %1.%2 (expected %3.x)")
+                .arg(header->versionMajor)
+                .arg(header->versionMinor)
+                .arg(ProjectFormat::VERSION_MAJOR)
+                .toStdString()
+        );
+    }
+    if (header->fileSize != size) {
+        malformed("file size does not match header (truncated?)");
+    }
+    if (header->headerSize < sizeof(ProjectFormat::FileHeader) ||
+        header->sectionEntrySize < sizeof(ProjectFormat::SectionEntry)) {
+        malformed("bad header sizes");
+    }
+
+    mapSections();
+}
+
+ProjectFileView::~ProjectFileView() {
+    // The mapping is released when the last QImage referencing it is gone
+}
+
+void ProjectFileView::mapSections() {
+    quint64 tableEnd = header->headerSize +
+                       static_cast<quint64>(header->sectionCount) * header->sectionEntrySize;
+    if (tableEnd > size) {
+        malformed("section table exceeds file");
+    }
+
+    for (quint32 i = 0; i < header->sectionCount; ++i) {
+        const auto* entry = reinterpret_cast<const ProjectFormat::SectionEntry*>(
+            data + header->headerSize + static_cast<quint64>(i) * header->sectionEntrySize);
+        if (entry->offset > size || entry->size > size - entry->offset || entry->offset % 8 != 0) {
+            malformed("section exceeds file");
+        }
+        SectionCursor cursor(data + entry->offset, entry->size);
+
+        switch (entry->type) {
+        case ProjectFormat::SECTION_DOCUMENT:
+            document = cursor.take<ProjectFormat::DocumentSection>(1);
+            break;
+
+        case ProjectFormat::SECTION_STRINGS: {
+            stringCount = *cursor.take<quint32>(1);
+            // Offsets follow the count directly (4-byte aligned), then UTF-8 bytes
+            SectionCursor table(data + entry->offset + sizeof(quint32), entry->size - sizeof(quint32));
+            stringOffsets = table.take<quint32>(static_cast<quint64>(stringCount) + 1);
+            quint64 tableBytes = (static_cast<quint64>(stringCount) + 1) * sizeof(quint32);
+            stringData = reinterpret_cast<const char*>(data + entry->offset + sizeof(quint32) + tableBytes);
+            stringDataSize = entry->size - sizeof(quint32) - tableBytes;
+            if (stringOffsets[stringCount] > stringDataSize) {
+                malformed("string table exceeds section");
+            }
+            break;
+        }
+
+        case ProjectFormat::SECTION_RASTER: {
+            raster = cursor.take<ProjectFormat::RasterSection>(1);
+            if (raster->imageFormat == QImage::Format_Invalid ||
+                raster->imageFormat >= QImage::NImageFormats ||
+                raster->dataOffset % 4 != 0 || raster->dataOffset > entry->size) {
+                malformed("bad raster header");
+            }
+            QPixelFormat pixelFormat = QImage::toPixelFormat(static_cast<QImage::Format>(raster->imageFormat));
+            quint64 minBytesPerLine = (static_cast<quint64>(raster->width) * pixelFormat.bitsPerPixel() + 7) / 8;
+            if (raster->bytesPerLine < minBytesPerLine ||
+                static_cast<quint64>(raster->bytesPerLine) * raster->height > entry->size - raster->dataOffset) {
+                malformed("raster exceeds section");
+            }
+            rasterPixels = data + entry->offset + raster->dataOffset;
+            break;
+        }
+
+        case ProjectFormat::SECTION_REGIONS:
+            regionCountValue = entry->count;
+            regionX1Data = cursor.take<double>(entry->count);
+            regionY1Data = cursor.take<double>(entry->count);
+            regionX2Data = cursor.take<double>(entry->count);
+            regionY2Data = cursor.take<double>(entry->count);
+            regionRotationData = cursor.take<double>(entry->count);
+            for (const quint32*& column : regionStrings) {
+                column = cursor.take<quint32>(entry->count);
+            }
+            break;
+
+        case ProjectFormat::SECTION_GROUPS: {
+            groupCountValue = entry->count;
+            groupNameData = cursor.take<quint32>(entry->count);
+            groupMemberStartData = cursor.take<quint32>(entry->count + 1);
+            for (quint64 g = 0; g < entry->count; ++g) {
+                if (groupMemberStartData[g] > groupMemberStartData[g + 1]) {
+                    malformed("group member ranges out of order");
+                }
+            }
+            groupMembersData = cursor.take<quint32>(groupMemberStartData[entry->count]);
+            break;
+        }
+
+        case ProjectFormat::SECTION_OCR_WORDS:
+            ocrWordCountValue = entry->count;
+            for (const double*& column : ocrCoords) {
+                column = cursor.take<double>(entry->count);
+            }
+            ocrConfidenceData = cursor.take<float>(entry->count);
+            for (const qint32*& column : ocrIds) {
+                column = cursor.take<qint32>(entry->count);
+            }
+            ocrTextData = cursor.take<quint32>(entry->count);
+            break;
+
+        default:
+            // Unknown section from a newer minor version - skip it
+            break;
+        }
+    }
+
+    // Members must reference existing regions
+    if (groupCountValue > 0) {
+        quint64 memberCount = groupMemberStartData[groupCountValue];
+        for (quint64 m = 0; m < memberCount; ++m) {
+            if (groupMembersData[m] >= regionCountValue) {
+                malformed("group references a missing region");
+            }
+        }
+    }
+}
+
+QString ProjectFileView::string(quint32 index) const {
+    if (index == ProjectFormat::NO_STRING || index >= stringCount) {
+        return QString();
+    }
+    quint32 begin = stringOffsets[index];
+    quint32 end = stringOffsets[index + 1];
+    if (begin > end || end > stringDataSize) {
+        return QString();
+    }
+    return QString::fromUtf8(stringData + begin, end - begin);
+}
+
+QString ProjectFileView::pdfPath() const {
+    return document ? string(document->pdfPath) : QString();
+}
+
+QImage ProjectFileView::image() const {
+    if (!raster || !rasterPixels || raster->width == 0 || raster->height == 0) {
+        return QImage();
+    }
+    // Read-only QImage over the mapping; it holds its own reference to the file
+    auto* fileRef = new QSharedPointer<QFile>(file);
+    QImage image(rasterPixels,
+                 static_cast<int>(raster->width),
+                 static_cast<int>(raster->height),
+                 static_cast<qsizetype>(raster->bytesPerLine),
+                 static_cast<QImage::Format>(raster->imageFormat),
+                 releaseMapping,
+                 fileRef);
+    if (image.isNull()) {
+        // QImage does not call the cleanup function when it rejects the data
+        delete fileRef;
+    }
+    return image;
+}
+
+void ProjectImporter::importFromFile(DocumentState& state, const QString& filePath,
+                                     QList<ProjectOcrWord>* ocrWords) {
+    ProjectFileView view(filePath);
+
+    // Build everything before touching state so a bad file leaves it unchanged
+    QMap<QString, RegionData> regions;
+    QHash<QString, QString> storedGroups;
+    int skippedCount = 0;
+    for (int i = 0; i < view.regionCount(); ++i) {
+        QString name = view.string(view.regionName()[i]);
+        NormalizedCoords coords(view.regionX1()[i], view.regionY1()[i],
+                                view.regionX2()[i], view.regionY2()[i]);
+        if (name.isEmpty() || !CoordinateSystem::isValidRegionCoords(coords)) {
+            skippedCount++;
+            continue;
+        }
+
+        RegionData region(name, coords,
+                          view.string(view.regionColor()[i]),
+                          QString(),  // Group membership is applied below, in stored order
+                          view.string(view.regionShapeType()[i]),
+                          view.string(view.regionType()[i]),
+                          view.string(view.regionPercentageFill()[i]),
+                          view.regionRotation()[i]);
+        if (region.color.isEmpty()) region.color = "blue";
+        if (region.shapeType.isEmpty()) region.shapeType = "rect";
+        if (region.regionType.isEmpty()) region.regionType = "none";
+        if (region.percentageFill.isEmpty()) region.percentageFill = "none";
+        if (!CoordinateSystem::isValidDouble(region.rotationAngle)) {
+            region.rotationAngle = 0.0;
+        }
+
+        QString group = view.string(view.regionGroup()[i]);
+        if (!group.isEmpty()) {
+            storedGroups.insert(name, group);
+        }
+        regions.insert(name, region);
+    }
+
+    if (skippedCount > 0) {
+        OCR_ORC_WARNING("Skipped" << skippedCount << "invalid regions during project import");
+    }
+
+    // Clear existing regions and groups (fresh import)
+    state.regions.clear();
+    state.groups.clear();
+    state.pdfPath = view.pdfPath();
+    state.image = view.image();
+    state.detectionImage = QImage();  // Projects store the display raster only
+    state.imageSourcePdf.clear();     // Stored raster may not match the PDF on disk
+
+    for (auto it = regions.constBegin(); it != regions.constEnd(); ++it) {
+        state.addRegion(it.key(), it.value());
+    }
+
+    // Groups, preserving member order
+    for (int g = 0; g < view.groupCount(); ++g) {
+        QString groupName = view.string(view.groupName()[g]);
+        if (groupName.isEmpty()) {
+            continue;
+        }
+        state.createGroup(groupName);
+        for (quint32 m = view.groupMemberStart()[g]; m < view.groupMemberStart()[g + 1]; ++m) {
+            QString regionName = view.string(view.regionName()[view.groupMembers()[m]]);
+            if (state.hasRegion(regionName)) {
+                state.addRegionToGroup(regionName, groupName);
+            }
+        }
+    }
+
+    // Regions whose group was not listed in the groups section
+    for (auto it = storedGroups.constBegin(); it != storedGroups.constEnd(); ++it) {
+        if (state.hasRegion(it.key()) && state.getRegion(it.key()).group.isEmpty()) {
+            state.addRegionToGroup(it.key(), it.value());
+        }
+    }
+
+    if (ocrWords) {
+        ocrWords->clear();
+        ocrWords->reserve(view.ocrWordCount());
+        for (int i = 0; i < view.ocrWordCount(); ++i) {
+            ProjectOcrWord word;
+            word.coords = NormalizedCoords(view.ocrX1()[i], view.ocrY1()[i],
+                                           view.ocrX2()[i], view.ocrY2()[i]);
+            word.text = view.string(view.ocrText()[i]);
+            word.confidence = view.ocrConfidence()[i];
+            word.blockId = view.ocrBlockId()[i];
+            word.lineId = view.ocrLineId()[i];
+            word.wordId = view.ocrWordId()[i];
+            ocrWords->append(word);
+        }
+    }
+
+    // Synchronize coordinates (recalculate image/canvas from normalized)
+    state.synchronizeCoordinates();
+}
+
+bool ProjectImporter::isProjectFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray magic = file.read(sizeof(ProjectFormat::MAGIC));
+    return magic.size() == static_cast<int>(sizeof(ProjectFormat::MAGIC)) &&
+           std::memcmp(magic.constData(), ProjectFormat::MAGIC, sizeof(ProjectFormat::MAGIC)) == 0;
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,154 @@
+#ifndef PROJECT_IMPORTER_H
+#define PROJECT_IMPORTER_H
+
+#include "ProjectFormat.h"
+#include "../models/DocumentState.h"
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QImage>
+
+class QFile;
+
+namespace ocr_orc {
+
+/**
+ * @brief Read-only, memory-mapped view of a .orcproj file
+ *
+ * Opening validates the header and section table only; nothing is parsed or
+ * copied. Column accessors return pointers straight into the mapping, and
+ * image() wraps the mapped pixel rows in a QImage without copying, so pages
+ * are faulted in only when they are actually touched.
+ *
+ * Pointers are valid for the lifetime of the view. Images returned by
+ * image() keep the mapping alive on their own.
+ */
+class ProjectFileView {
+public:
+    /**
+     * @brief Map and validate a project file
+     * @param filePath Path to the .orcproj file
+     * @throws std::runtime_error if the file cannot be mapped or is malformed
+     */
+    explicit ProjectFileView(const QString& filePath);
+    ~ProjectFileView();
+
+    ProjectFileView(const ProjectFileView&) = delete;
+    ProjectFileView& operator=(const ProjectFileView&) = delete;
+
+    quint16 versionMajor() const { return header->versionMajor; }
+    quint16 versionMinor() const { return header->versionMinor; }
+
+    /**
+     * @brief Look up a string by index (empty for NO_STRING or out of range)
+     */
+    QString string(quint32 index) const;
+
+    QString pdfPath() const;
+
+    /**
+     * @brief Page raster backed by the mapping (null if the project has none)
+     */
+    QImage image() const;
+
+    // Regions (struct of arrays, index i describes one region)
+    int regionCount() const { return static_cast<int>(regionCountValue); }
+    const double* regionX1() const { return regionX1Data; }
+    const double* regionY1() const { return regionY1Data; }
+    const double* regionX2() const { return regionX2Data; }
+    const double* regionY2() const { return regionY2Data; }
+    const double* regionRotation() const { return regionRotationData; }
+    const quint32* regionName() const { return regionStrings[0]; }
+    const quint32* regionColor() const { return regionStrings[1]; }
+    const quint32* regionGroup() const { return regionStrings[2]; }
+    const quint32* regionShapeType() const { return regionStrings[3]; }
+    const quint32* regionType() const { return regionStrings[4]; }
+    const quint32* regionPercentageFill() const { return regionStrings[5]; }
+
+    // Groups: members of group g are groupMembers()[groupMemberStart()[g] .. groupMemberStart()[g + 1]]
+    int groupCount() const { return static_cast<int>(groupCountValue); }
+    const quint32* groupName() const { return groupNameData; }
+    const quint32* groupMemberStart() const { return groupMemberStartData; }
+    const quint32* groupMembers() const { return groupMembersData; }
+
+    // Cached OCR word boxes
+    int ocrWordCount() const { return static_cast<int>(ocrWordCountValue); }
+    const double* ocrX1() const { return ocrCoords[0]; }
+    const double* ocrY1() const { return ocrCoords[1]; }
+    const double* ocrX2() const { return ocrCoords[2]; }
+    const double* ocrY2() const { return ocrCoords[3]; }
+    const float* ocrConfidence() const { return ocrConfidenceData; }
+    const qint32* ocrBlockId() const { return ocrIds[0]; }
+    const qint32* ocrLineId() const { return ocrIds[1]; }
+    const qint32* ocrWordId() const { return ocrIds[2]; }
+    const quint32* ocrText() const { return ocrTextData; }
+
+private:
+    void mapSections();
+
+    QSharedPointer<QFile> file;   // Owns the mapping; shared with images
+    const uchar* data;
+    quint64 size;
+    const ProjectFormat::FileHeader* header;
+
+    // Strings
+    quint32 stringCount;
+    const quint32* stringOffsets;
+    const char* stringData;
+    quint64 stringDataSize;
+
+    const ProjectFormat::DocumentSection* document;
+    const ProjectFormat::RasterSection* raster;
+    const uchar* rasterPixels;
+
+    quint64 regionCountValue;
+    const double* regionX1Data;
+    const double* regionY1Data;
+    const double* regionX2Data;
+    const double* regionY2Data;
+    const double* regionRotationData;
+    const quint32* regionStrings[6];
+
+    quint64 groupCountValue;
+    const quint32* groupNameData;
+    const quint32* groupMemberStartData;
+    const quint32* groupMembersData;
+
+    quint64 ocrWordCountValue;
+    const double* ocrCoords[4];
+    const float* ocrConfidenceData;
+    const qint32* ocrIds[3];
+    const quint32* ocrTextData;
+};
+
+/**
+ * @brief Binary project importer for DocumentState
+ *
+ * Restores the page raster, regions and groups from a .orcproj file written
+ * by ProjectExporter, without re-rendering the PDF. Complements JsonImporter.
+ */
+class ProjectImporter {
+public:
+    /**
+     * @brief Import DocumentState from a binary project file
+     * @param state DocumentState to populate (regions, groups, pdfPath, image)
+     * @param filePath Path to input .orcproj file
+     * @param ocrWords If non-null, receives the cached OCR word boxes
+     * @throws std::runtime_error if import fails
+     */
+    static void importFromFile(DocumentState& state, const QString& filePath,
+                               QList<ProjectOcrWord>* ocrWords = nullptr);
+
+    /**
+     * @brief Check whether a file starts with the project file magic
+     */
+    static bool isProjectFile(const QString& filePath);
+
+private:
+    // Private constructor - this is a utility class with only static methods
+    ProjectImporter() = delete;
+};
+
+} // namespace ocr_orc
+
+#endif // PROJECT_IMPORTER_H
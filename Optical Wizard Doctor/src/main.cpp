@@ -7,6 +7,8 @@
 #include <QtCore/QTextStream>
 #include <QtCore/QDateTime>
 #include "ui/MainWindow.h"
+#include "utils/TraceRecorder.h"
+#include "utils/ConcurrencyGovernor.h"
 
 using namespace ocr_orc;
 
@@ -60,6 +62,13 @@ int main(int argc, char *argv[])
     app.setApplicationVersion("1.0.0");
     app.setOrganizationName("OCR-Orc");
     
+    // Runtime tracing is off unless enabled in Preferences or via OCR_ORC_TRACE
+    TraceRecorder::instance().configureFromEnvironment();
+    TraceRecorder::instance().setCurrentThreadName("GUI");
+    
+    // Split cores between OpenCV, Tesseract, Qt pools and detection stages (OCR_ORC_THREADS pins it)
+    ConcurrencyGovernor::instance().configureFromEnvironment();
+    
     // Create and show main window
     MainWindow window;
     window.show();
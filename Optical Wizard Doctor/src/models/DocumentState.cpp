@@ -365,6 +365,14 @@ QSize DocumentState::getImageSize() const {
     return image.size();
 }
 
+const QImage& DocumentState::getDetectionImage() const {
+    return detectionImage.isNull() ? image : detectionImage;
+}
+
+bool DocumentState::isImageRenderedFromPdf() const {
+    return !imageSourcePdf.isEmpty() && imageSourcePdf == pdfPath && !image.isNull();
+}
+
 bool DocumentState::isValid() const {
     // Check for duplicate region names (shouldn't happen with QMap, but verify)
     QSet<QString> seenNames;
@@ -508,6 +516,8 @@ DocumentState DocumentState::fromJson(const QJsonObject& json) {
 void DocumentState::clear() {
     pdfPath = "";
     image = QImage();
+    detectionImage = QImage();
+    imageSourcePdf.clear();
     regions.clear();
     groups.clear();
     zoomLevel = 1.0;
@@ -579,17 +589,21 @@ void DocumentState::restoreState(const StateSnapshot& snapshot) {
             if (!reloadedImage.isNull() && 
                 CoordinateSystem::isValidImageDimensions(reloadedImage.width(), reloadedImage.height())) {
                 image = reloadedImage;
+                imageSourcePdf = pdfPath;
             } else {
                 // PDF exists but couldn't load - clear image to prevent invalid state
                 image = QImage();
+                imageSourcePdf.clear();
             }
         } else {
             // PDF file doesn't exist or isn't readable - clear image
             image = QImage();
+            imageSourcePdf.clear();
         }
     } else {
         // No PDF path - clear image
         image = QImage();
+        imageSourcePdf.clear();
     }
     
     // Only synchronize coordinates if we have a valid image
@@ -671,6 +685,8 @@ void DocumentState::clearUndoRedoStacks() {
 
 void DocumentState::setImage(const QImage& img) {
     image = img;
+    detectionImage = QImage();  // Rendered from the previous page
+    imageSourcePdf.clear();     // Origin unknown
     // Recalculate coordinates when image changes
     synchronizeCoordinates();
 }
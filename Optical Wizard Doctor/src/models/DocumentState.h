@@ -30,6 +30,8 @@ public:
     // Document information
     QString pdfPath;
     QImage image;  // First page as image
+    QImage detectionImage;  // First page as Grayscale8 at PdfConstants::DETECTION_DPI (empty until rendered)
+    QString imageSourcePdf;  // PDF the image was rendered from this session (empty if loaded from a project)
     
     // Region and group storage
     QMap<QString, RegionData> regions;  // Key: region name
@@ -99,6 +101,20 @@ public:
      */
     QSize getImageSize() const;
     
+    /**
+     * @brief Page to run detection on: the grayscale detection raster, or the display image until it is rendered
+     */
+    const QImage& getDetectionImage() const;
+    
+    /**
+     * @brief Whether image was rendered from pdfPath in this session
+     *
+     * Only then may parts of the page be re-rendered from the PDF: a project
+     * stores its own raster and pdfPath may name a file that has changed on
+     * disk (or a different file after a JSON import).
+     */
+    bool isImageRenderedFromPdf() const;
+    
     // State validation
     bool isValid() const;
     
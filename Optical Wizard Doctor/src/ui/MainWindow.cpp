@@ -86,7 +86,7 @@ MainWindow::MainWindow(QWidget *parent)
             , detectionThread(nullptr)
             , detectionWorker(nullptr)
             , isDetecting(false)
-            , currentDetectionResult(nullptr)
+            , detectionDialog(nullptr)
 {
     setWindowProperties();
     setupUI();
@@ -99,7 +99,10 @@ MainWindow::MainWindow(QWidget *parent)
 }
 
 MainWindow::~MainWindow() {
-    // Stop detection worker thread
+    // Stop detection worker thread (a running detection stops at its next milestone)
+    if (detectionWorker) {
+        detectionWorker->cancelDetection();
+    }
     if (detectionThread) {
         detectionThread->quit();
         detectionThread->wait();
@@ -188,7 +191,7 @@ void MainWindow::setupCanvas() {
         [this](const QString& name) { return showChangeColorDialog(name); },
         [this]() { updateRegionListBox(); },
         [this]() { updateGroupListBox(); },
-        [this]() { if (canvas) canvas->update(); },
+        [this]() { if (canvas) canvas->invalidateLayer(); },
         [this]() { updateUndoRedoButtons(); },
         [this](const QString& message, int timeout) {
             statusBar()->showMessage(message, timeout);
@@ -318,7 +321,7 @@ void MainWindow::onUndo() {
         [this]() { return documentState ? documentState->canUndo() : false; },
         [this]() { if (documentState) documentState->undoAction(); },
         [this]() { if (canvas) canvas->invalidateCoordinateCache(); },
-        [this]() { if (canvas) canvas->update(); },
+        [this]() { if (canvas) canvas->invalidateLayer(); },
         [this]() { updateRegionListBox(); },
         [this]() { updateGroupListBox(); },
         [this](bool canUndo, bool canRedo) {
@@ -340,7 +343,7 @@ void MainWindow::onRedo() {
         [this]() { return documentState ? documentState->canRedo() : false; },
         [this]() { if (documentState) documentState->redoAction(); },
         [this]() { if (canvas) canvas->invalidateCoordinateCache(); },
-        [this]() { if (canvas) canvas->update(); },
+        [this]() { if (canvas) canvas->invalidateLayer(); },
         [this]() { updateRegionListBox(); },
         [this]() { updateGroupListBox(); },
         [this](bool canUndo, bool canRedo) {
@@ -356,6 +359,11 @@ void MainWindow::onRedo() {
 }
 
 void MainWindow::updateUndoRedoButtons() {
+    // Runs after every undoable edit; heavy editing stops the background page analysis
+    if (fileOperations) {
+        fileOperations->noteUserEdit();
+    }
+    
     toolbarAdapter->updateUndoRedoButtons(
         documentState,
         [this]() { return documentState ? documentState->canUndo() : false; },
@@ -495,7 +503,7 @@ void MainWindow::onSelectAll() {
                 canvas->setSelectedRegions(regions);
             }
         },
-        [this]() { if (canvas) canvas->update(); },
+        [this]() { if (canvas) canvas->invalidateLayer(); },
         [this]() { updateRegionListBox(); }
     );
 }
@@ -512,7 +520,7 @@ void MainWindow::onInvertSelection() {
                 canvas->setSelectedRegions(regions);
             }
         },
-        [this]() { if (canvas) canvas->update(); },
+        [this]() { if (canvas) canvas->invalidateLayer(); },
         [this]() { updateRegionListBox(); }
     );
 }
@@ -535,11 +543,22 @@ void MainWindow::onMagicDetect() {
             return;
         }
         
+        // Don't detect on the low-DPI preview while the full page is still rendering
+        if (fileOperations && fileOperations->isPdfLoadInProgress()) {
+            fprintf(stderr, "[MainWindow::onMagicDetect] PDF still loading - detection deferred\n");
+            fflush(stderr);
+            statusBar()->showMessage("PDF is still loading, please try again in a moment", 3000);
+            return;
+        }
+        
         // Show parameter configuration dialog
         fprintf(stderr, "[MainWindow::onMagicDetect] Step 1.5: Showing parameter configuration dialog...\n");
         fflush(stderr);
         DetectionParameters defaultParams;
-        MagicDetectParamsDialog* paramsDialog = new MagicDetectParamsDialog(this, defaultParams);
+        // The page drives the dialog's live preview (same raster the detection will use)
+        MagicDetectParamsDialog* paramsDialog = new MagicDetectParamsDialog(this, defaultParams,
+                                                                            documentState->getDetectionImage(),
+                                                                            documentState->image);
         int dialogResult = paramsDialog->exec();
         
         if (dialogResult != QDialog::Accepted || !paramsDialog->shouldRun()) {
@@ -608,6 +627,13 @@ void MainWindow::onMagicDetect() {
                 fprintf(stderr, "[MainWindow::onMagicDetect] Step 2.4.3: detectionProgress signal connected\n");
                 fflush(stderr);
                 
+                QObject::connect(detectionWorker, &DetectionWorker::partialResultReady, 
+                                 this, &MainWindow::onDetectionPartialResult, Qt::QueuedConnection);
+                QObject::connect(detectionWorker, &DetectionWorker::detectionCancelled, 
+                                 this, &MainWindow::onDetectionCancelled, Qt::QueuedConnection);
+                fprintf(stderr, "[MainWindow::onMagicDetect] Step 2.4.4: partial result and cancel signals connected\n");
+                fflush(stderr);
+                
                 // Connect thread finished signal to delete worker
                 QObject::connect(detectionThread, &QThread::finished, detectionWorker, &QObject::deleteLater);
                 fprintf(stderr, "[MainWindow::onMagicDetect] Step 2.5: Thread finished signal connected\n");
@@ -674,8 +700,10 @@ void MainWindow::onMagicDetect() {
         
         // Store parameters in worker for access (Q_ARG doesn't work with custom types)
         detectionWorker->setDetectionParameters(params);
+        detectionWorker->setColorReference(documentState->image);
+        detectionWorker->beginDetection();
         bool invokeSuccess = QMetaObject::invokeMethod(detectionWorker, "detectRegions", Qt::QueuedConnection,
-                                  Q_ARG(QImage, documentState->image),
+                                  Q_ARG(QImage, documentState->getDetectionImage()),
                                   Q_ARG(QString, QString("ocr-first")));
         
         if (!invokeSuccess) {
@@ -692,6 +720,24 @@ void MainWindow::onMagicDetect() {
         
         fprintf(stderr, "[MainWindow::onMagicDetect] Step 5: ✓ detectRegions invoked successfully\n");
         fflush(stderr);
+        
+        // Review dialog opens now and fills in as partial results arrive; closing it aborts the run
+        DetectionPreviewDialog* dialog = new DetectionPreviewDialog(this, documentState->image);
+        detectionDialog = dialog;
+        connect(dialog, &DetectionPreviewDialog::regionsAccepted, this, &MainWindow::onRegionsAcceptedFromDetection);
+        connect(dialog, &DetectionPreviewDialog::abortRequested, this, &MainWindow::onAbortDetection);
+        connect(dialog, &QDialog::finished, this, [this, dialog](int resultCode) {
+            if (detectionDialog == dialog) {
+                detectionDialog = nullptr;
+            }
+            dialog->deleteLater();
+            if (resultCode == QDialog::Accepted) {
+                statusBar()->showMessage("Regions accepted and created", 3000);
+            } else {
+                statusBar()->showMessage("Detection cancelled", 2000);
+            }
+        });
+        dialog->open();
         fprintf(stderr, "[MainWindow::onMagicDetect] ========== MAGIC DETECT INITIATED ==========\n");
         fflush(stderr);
         qDebug() << "[MainWindow::onMagicDetect] Magic detect initiated successfully";
@@ -733,12 +779,49 @@ void MainWindow::onDetectionProgress(int percent, const QString& message) {
     fflush(stderr);
 }
 
+void MainWindow::onDetectionPartialResult(const PartialDetectionLayer& layer) {
+    if (!isDetecting) {
+        return;
+    }
+    if (canvas) {
+        canvas->addDetectionLayer(layer);
+    }
+    if (detectionDialog) {
+        detectionDialog->addPartialLayer(layer);
+    }
+    statusBar()->showMessage(QString("Detecting... %1 ready: %2 (%3 s)")
+                                 .arg(PartialDetectionLayer::kindName(layer.kind))
+                                 .arg(layer.regions.size())
+                                 .arg(layer.elapsedMs / 1000.0, 0, 'f', 1), 0);
+}
+
+void MainWindow::onAbortDetection() {
+    if (!isDetecting || !detectionWorker) {
+        return;
+    }
+    fprintf(stderr, "[MainWindow::onAbortDetection] Abort requested\n");
+    fflush(stderr);
+    detectionWorker->cancelDetection();
+    statusBar()->showMessage("Aborting detection...", 0);
+}
+
+void MainWindow::onDetectionCancelled() {
+    isDetecting = false;
+    if (toolbarWidget && toolbarWidget->getMagicDetectButton()) {
+        toolbarWidget->getMagicDetectButton()->setEnabled(true);
+    }
+    if (canvas) {
+        canvas->clearDetectionLayers();
+    }
+    statusBar()->showMessage("Detection cancelled", 3000);
+}
+
 void MainWindow::onRegionsAcceptedFromDetection(const QList<DetectedRegion>& regions) {
-    if (!currentDetectionResult) {
+    if (!detectionDialog) {
         statusBar()->showMessage("Error: No detection result available", 3000);
         return;
     }
-    const DetectionResult& result = *currentDetectionResult;
+    const DetectionResult result = detectionDialog->getDetectionResult();
     if (regions.isEmpty()) {
         statusBar()->showMessage("No regions selected", 2000);
         return;
@@ -836,7 +919,7 @@ void MainWindow::onRegionsAcceptedFromDetection(const QList<DetectedRegion>& reg
     // Update UI
     updateRegionListBox();
     if (canvas) {
-        canvas->update();
+        canvas->invalidateLayer();
     }
     
     int groupsCreated = result.inferredGroups.size();
@@ -878,11 +961,17 @@ void MainWindow::onDetectionError(const QString& error) {
         userMessage = QString("Detection failed: %1. Please try again or use manual mode.").arg(error);
     }
     
-    statusBar()->showMessage(userMessage, 10000);
     isDetecting = false;
     if (toolbarWidget && toolbarWidget->getMagicDetectButton()) {
         toolbarWidget->getMagicDetectButton()->setEnabled(true);
     }
+    if (canvas) {
+        canvas->clearDetectionLayers();
+    }
+    if (detectionDialog) {
+        detectionDialog->close();
+    }
+    statusBar()->showMessage(userMessage, 10000);
     fprintf(stderr, "[MainWindow::onDetectionError] User message: %s\n", userMessage.toLocal8Bit().constData());
     fprintf(stderr, "[MainWindow::onDetectionError] ====================================\n");
     fflush(stderr);
@@ -893,29 +982,26 @@ void MainWindow::onDetectionComplete(const DetectionResult& result) {
     if (toolbarWidget && toolbarWidget->getMagicDetectButton()) {
         toolbarWidget->getMagicDetectButton()->setEnabled(true);
     }
+    if (canvas) {
+        canvas->clearDetectionLayers();
+    }
+    
+    // Review dialog was closed while the run was finishing
+    if (!detectionDialog) {
+        statusBar()->showMessage("Detection cancelled", 2000);
+        return;
+    }
     
     // Check if any regions were detected
     if (result.totalDetected == 0) {
+        detectionDialog->close();
         statusBar()->showMessage("No regions detected. The document may not contain form fields, or OCR found no text. Try using manual mode to create regions.", 8000);
         return;
     }
     
-    // Store result in member variable for access
-    currentDetectionResult = const_cast<DetectionResult*>(&result);
-    
-    // Show preview dialog
-    DetectionPreviewDialog* dialog = new DetectionPreviewDialog(this, result, documentState->image);
-    connect(dialog, &DetectionPreviewDialog::regionsAccepted, this, &MainWindow::onRegionsAcceptedFromDetection);
-    
-    int resultCode = dialog->exec();
-    currentDetectionResult = nullptr;
-    delete dialog;
-    
-    if (resultCode == QDialog::Accepted) {
-        statusBar()->showMessage("Regions accepted and created", 3000);
-    } else {
-        statusBar()->showMessage("Detection cancelled", 2000);
-    }
+    // The open dialog switches from partial layers to review
+    detectionDialog->setDetectionResult(result);
+    statusBar()->showMessage(QString("Detection complete - review %1 regions").arg(result.totalDetected), 5000);
 }
 
 void MainWindow::showHelp() {
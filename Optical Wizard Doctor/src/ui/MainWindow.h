@@ -26,6 +26,7 @@
 #include <QtGui/QDropEvent>
 #include "../models/DocumentState.h"
 #include "../utils/RegionDetector.h"
+#include "../utils/DetectionProgressChannel.h"
 #include "components/dialogs/MagicDetectParamsDialog.h"
 #include "canvas/Canvas.h"
 #include "components/widgets/ToolbarWidget.h"
@@ -36,6 +37,7 @@
 class QThread;
 namespace ocr_orc {
     class DetectionWorker;
+    class DetectionPreviewDialog;
 }
 #include "mainwindow/operations/file/MainWindowFileOperations.h"
 #include "mainwindow/operations/region/MainWindowRegionOperations.h"
@@ -273,6 +275,22 @@ private slots:
      */
     void onDetectionProgress(int percent, const QString& message);
     
+    /**
+     * @brief Show a partial result of the running detection on the canvas and in the review dialog
+     * @param layer OCR words, rectangle candidates or consensus regions
+     */
+    void onDetectionPartialResult(const PartialDetectionLayer& layer);
+    
+    /**
+     * @brief Handle a detection run that stopped after an abort request
+     */
+    void onDetectionCancelled();
+    
+    /**
+     * @brief Abort the running detection (review dialog closed before the result arrived)
+     */
+    void onAbortDetection();
+    
     /**
      * @brief Handle regions accepted from detection preview dialog
      * @param regions List of accepted DetectedRegion objects
@@ -416,12 +434,12 @@ private:
      * @brief Apply current theme to all widgets
      */
     void applyTheme();
-
+    
     // Detection worker thread
     QThread* detectionThread;
     ocr_orc::DetectionWorker* detectionWorker;
     bool isDetecting;
-    DetectionResult* currentDetectionResult;  // Store result for dialog access
+    ocr_orc::DetectionPreviewDialog* detectionDialog;  // Open from detection start until review ends
     DetectionParameters currentDetectionParams;  // Store detection parameters
     
     // UI Components - Layout
@@ -223,16 +223,16 @@ QString ThemeManager::generateStylesheet(const ThemeColors& colors) const {
           colors.primaryHover.name(), colors.primary.name());
     
     stylesheet += QString(
-        "QListWidget {"
+        "QListView {"
         "    background-color: %1;"
         "    color: %2;"
         "    border: 1px solid %3;"
         "}"
-        "QListWidget::item:selected {"
+        "QListView::item:selected {"
         "    background-color: %4;"
         "    color: %2;"
         "}"
-        "QListWidget::item:hover {"
+        "QListView::item:hover {"
         "    background-color: %5;"
         "}"
     ).arg(colors.surface.name(), colors.text.name(), colors.border.name(),
@@ -1,6 +1,5 @@
 #include "Canvas.h"
 #include "core/coordinate/CanvasCoordinateCache.h"
-#include "../../utils/PdfLoader.h"
 #include "../../core/Constants.h"
 #include <QtWidgets/QApplication>
 #include <QtGui/QPainter>
@@ -47,6 +46,13 @@ Canvas::Canvas(QWidget *parent)
     , panStartOffset()
     , coordinateCache(new CanvasCoordinateCache())
     , renderer(new CanvasRenderer())
+    , layerCache(new CanvasLayerCache())
+    , tileRenderer(new CanvasTileRenderer(this))
+    , tileTimer(new QTimer(this))
+    , wantedTileRect()
+    , wantedTileDpi(0.0)
+    , overlayUpdateRequested(false)
+    , regionsEditedDuringDrag(false)
     , zoomController(new CanvasZoomController())
     , regionOperations(new CanvasRegionOperations())
     , selectionManager(new CanvasSelectionManager())
@@ -77,12 +83,28 @@ Canvas::Canvas(QWidget *parent)
             QWidget::update();
         }
     });
+    
+    // Request the sharp viewport tile once panning/zooming has paused
+    tileTimer->setSingleShot(true);
+    tileTimer->setInterval(CanvasConstants::DETAIL_TILE_DEBOUNCE_MS);
+    connect(tileTimer, &QTimer::timeout, this, [this]() {
+        if (wantedTileDpi <= 0.0 || !documentState || !documentState->isImageRenderedFromPdf()) {
+            return;
+        }
+        tileRenderer->requestTile(documentState->imageSourcePdf, wantedTileRect, wantedTileDpi);
+    });
+    connect(tileRenderer, &CanvasTileRenderer::tileReady, this,
+            [this](int, const QImage& tile, const QRectF& normalizedRect, double) {
+        layerCache->setDetailTile(tile, normalizedRect);
+        updateView();
+    });
 }
 
 Canvas::~Canvas() {
     // QImage is automatically cleaned up
     delete coordinateCache;
     delete renderer;
+    delete layerCache;
     delete zoomController;
     delete regionOperations;
     delete selectionManager;
@@ -96,24 +118,13 @@ Canvas::~Canvas() {
     delete regionCreationManager;
 }
 
-bool Canvas::loadPdf(const QString& filePath) {
-    // Load PDF first page using PdfLoader
-    QImage image = PdfLoader::loadPdfFirstPage(filePath, PdfConstants::DEFAULT_DPI);
-    
-    if (image.isNull()) {
-        OCR_ORC_WARNING("Canvas: Failed to load PDF:" << filePath);
-        return false;
-    }
-    
-    // Set the image
-    setImage(image);
-    return true;
-}
-
 void Canvas::setImage(const QImage& image) {
     // QImage uses implicit sharing (copy-on-write), so regular assignment is efficient
     documentImage = image;
     
+    // A tile rendered for the previous image must not be drawn over this one
+    clearDetailTile();
+    
     // Invalidate coordinate cache (image changed)
     invalidateCoordinateCache();
     
@@ -121,7 +132,7 @@ void Canvas::setImage(const QImage& image) {
     calculateLayout();
     
     // Trigger repaint
-    update();
+    invalidateLayer();
 }
 
 void Canvas::calculateLayout() {
@@ -170,22 +181,31 @@ void Canvas::paintEvent(QPaintEvent* event) {
     
     // Draw document image if loaded
     if (!documentImage.isNull() && !imageRect.isEmpty()) {
-        // Only draw image if it intersects exposed region
-        if (imageRect.intersects(exposedRect)) {
-            if (renderer) {
-                renderer->drawDocumentImage(painter, documentImage, imageRect);
-            }
+        if (renderer) {
+            scheduleDetailTile();
             
-            // Draw regions if DocumentState is available
-            if (documentState && renderer) {
-                renderer->renderRegions(painter, documentState, coordinateCache,
-                                       documentImage, scaleFactor, imageOffset,
-                                       rect(), hoveredRegion, selectedRegions,
-                                       primarySelectedRegion, isRotateMode,
-                                       isRotating ? rotatingRegion : QString(), rotationAngle);
+            // Page and unselected regions: blit from the retained layer
+            layerCache->paint(painter, exposedRect, renderer, documentState, coordinateCache,
+                              documentImage, scaleFactor, imageOffset, size(), devicePixelRatioF(),
+                              staticLayerExclusions());
+            
+            // Overlay: hovered, selected, resized and rotated regions drawn live on top
+            if (documentState) {
+                renderer->renderOverlayRegions(painter, documentState, coordinateCache,
+                                               documentImage, scaleFactor, imageOffset,
+                                               QRectF(exposedRect), staticLayerExclusions(),
+                                               hoveredRegion, selectedRegions,
+                                               primarySelectedRegion, isRotateMode,
+                                               isRotating ? rotatingRegion : QString(), rotationAngle);
             }
         }
         
+        // Partial detection results while Magic Detect is running
+        if (!detectionLayers.isEmpty() && renderer) {
+            renderer->drawDetectionLayers(painter, detectionLayers, documentImage,
+                                          scaleFactor, imageOffset, QRectF(exposedRect));
+        }
+        
         // Draw temporary rectangle during region creation (always visible)
         if (isCreating && !tempRect.isEmpty() && renderer) {
             renderer->drawTempShape(painter, tempRect, shapeType);
@@ -211,20 +231,26 @@ void Canvas::resizeEvent(QResizeEvent* event) {
     // Recalculate layout when canvas is resized
     calculateLayout();
     
-    // Trigger repaint
-    update();
+    // Trigger repaint (layer is keyed on scale/offset/size, nothing to drop)
+    updateView();
 }
 
 void Canvas::setDocumentState(DocumentState* state) {
     documentState = state;
     invalidateCoordinateCache(); // Invalidate cache when state changes
-    update(); // Trigger repaint
+    invalidateLayer(); // Trigger repaint
 }
 
 void Canvas::setHoveredRegion(const QString& regionName) {
     if (!stateManager) return;
+    OverlaySnapshot before = overlaySnapshot();
     stateManager->setHoveredRegion(regionName, hoveredRegion);
-    batchedUpdate();
+    
+    // Only the old and new hover outlines need repainting
+    QRect dirty = CanvasLayerCache::overlayDirtyRect(before, overlaySnapshot());
+    if (!dirty.isEmpty()) {
+        batchedUpdate(dirty);
+    }
 }
 
 void Canvas::setSelectedRegions(const QSet<QString>& regionNames) {
@@ -241,12 +267,148 @@ void Canvas::setSelectedRegions(const QSet<QString>& regionNames) {
         }
     }
     emit selectionChanged();
-    update();
+    invalidateLayer();
 }
 
 void Canvas::invalidateCoordinateCache() {
     if (!stateManager) return;
     stateManager->invalidateCoordinateCache(coordinateCache);
+    layerCache->invalidate();
+}
+
+void Canvas::invalidateLayer() {
+    layerCache->invalidate();
+    QWidget::update();
+}
+
+void Canvas::updateView() {
+    QWidget::update();
+}
+
+void Canvas::scheduleDetailTile() {
+    QRectF normalizedRect;
+    double dpi = 0.0;
+    // A raster from a project file may not match the PDF on disk
+    const bool wanted = documentState && documentState->isImageRenderedFromPdf() &&
+                        CanvasTileRenderer::computeTileRequest(documentImage.size(), scaleFactor, imageOffset,
+                                                               size(), devicePixelRatioF(), normalizedRect, dpi);
+    if (!wanted) {
+        // Back at (or below) raster resolution: the magnified bitmap is sharp enough
+        if (wantedTileDpi > 0.0 || layerCache->hasDetailTile()) {
+            clearDetailTile();
+        }
+        return;
+    }
+    if (normalizedRect == wantedTileRect && dpi == wantedTileDpi) {
+        return;
+    }
+    // The current tile (if any) stays up, magnified, until the new one arrives
+    wantedTileRect = normalizedRect;
+    wantedTileDpi = dpi;
+    tileTimer->start();
+}
+
+void Canvas::clearDetailTile() {
+    tileTimer->stop();
+    tileRenderer->cancel();
+    wantedTileRect = QRectF();
+    wantedTileDpi = 0.0;
+    layerCache->setDetailTile(QImage(), QRectF());
+}
+
+void Canvas::addDetectionLayer(const PartialDetectionLayer& layer) {
+    for (int i = 0; i < detectionLayers.size(); ++i) {
+        if (detectionLayers[i].kind == layer.kind) {
+            detectionLayers.removeAt(i);
+            break;
+        }
+    }
+    detectionLayers.append(layer);
+    updateView();
+}
+
+void Canvas::clearDetectionLayers() {
+    if (detectionLayers.isEmpty()) {
+        return;
+    }
+    detectionLayers.clear();
+    updateView();
+}
+
+QSet<QString> Canvas::staticLayerExclusions() const {
+    QSet<QString> excluded = selectedRegions;
+    if (!hoveredRegion.isEmpty()) {
+        excluded.insert(hoveredRegion);
+    }
+    if (isResizing && !resizingRegion.isEmpty()) {
+        excluded.insert(resizingRegion);
+    }
+    if (isRotating && !rotatingRegion.isEmpty()) {
+        excluded.insert(rotatingRegion);
+    }
+    return excluded;
+}
+
+Canvas::OverlaySnapshot Canvas::overlaySnapshot() const {
+    OverlaySnapshot snapshot;
+    const double margin = CanvasConstants::OVERLAY_MARGIN;
+    
+    if (documentState && renderer && !documentImage.isNull()) {
+        const QSet<QString> names = staticLayerExclusions();
+        for (const QString& name : names) {
+            auto regionIt = documentState->regions.constFind(name);
+            if (regionIt == documentState->regions.constEnd()) {
+                continue;
+            }
+            const RegionData& region = regionIt.value();
+            QRectF canvasRect = coordinateCache->getCachedCoordinates(name, documentState,
+                                                                      documentImage.width(), documentImage.height(),
+                                                                      scaleFactor, imageOffset);
+            bool isSelected = selectedRegions.contains(name);
+            bool isPrimary = (primarySelectedRegion == name && selectedRegions.size() == 1);
+            double angle = (isRotating && rotatingRegion == name) ? rotationAngle : region.rotationAngle;
+            // Angle is part of the state: a small rotation may not change the bounds
+            int state = (hoveredRegion == name ? 1 : 0) | (isSelected ? 2 : 0) |
+                        (isPrimary ? 4 : 0) | (isRotateMode ? 8 : 0) |
+                        (qRound(angle * 16.0) << 4);
+            QRectF bounds = renderer->regionPaintBounds(region, canvasRect, angle, isSelected, isPrimary);
+            snapshot.insert(name, qMakePair(bounds, state));
+        }
+    }
+    
+    // Rubber bands use keys that can't collide with region names
+    if (isCreating && !tempRect.isEmpty()) {
+        snapshot.insert(QStringLiteral("\u0001temp"),
+                        qMakePair(tempRect.adjusted(-margin, -margin, margin, margin), 0));
+    }
+    if (isBoxSelecting && !selectionBox.isEmpty()) {
+        snapshot.insert(QStringLiteral("\u0001box"),
+                        qMakePair(selectionBox.adjusted(-margin, -margin, margin, margin), 0));
+    }
+    return snapshot;
+}
+
+void Canvas::updateOverlay(const OverlaySnapshot& before,
+                           const QSet<QString>& exclusionsBefore,
+                           double scaleBefore,
+                           const QPointF& offsetBefore) {
+    bool requested = overlayUpdateRequested;
+    overlayUpdateRequested = false;
+    
+    // View moved (pan) or a region entered/left the static layer: everything shifts
+    if (scaleFactor != scaleBefore || imageOffset != offsetBefore ||
+        staticLayerExclusions() != exclusionsBefore) {
+        updateView();
+        return;
+    }
+    if (!requested) {
+        return;
+    }
+    
+    QRect dirty = CanvasLayerCache::overlayDirtyRect(before, overlaySnapshot());
+    if (!dirty.isEmpty()) {
+        QWidget::update(dirty);
+    }
 }
 
 void Canvas::batchedUpdate(const QRect& rect) {
@@ -282,18 +444,18 @@ void Canvas::setMode(MouseMode mode) {
     if (isCreating) {
         isCreating = false;
         tempRect = QRectF();
-        update();
+        invalidateLayer();
     }
 }
 
 void Canvas::setRotateMode(bool enabled) {
     isRotateMode = enabled;
-    update();
+    invalidateLayer();
 }
 
 void Canvas::setShapeType(const QString& type) {
     shapeType = type;
-    update();
+    invalidateLayer();
 }
 
 void Canvas::mousePressEvent(QMouseEvent* event) {
@@ -305,6 +467,13 @@ void Canvas::mousePressEvent(QMouseEvent* event) {
     QSet<QString> previousSelection = selectedRegions;
     QString previousPrimary = primarySelectedRegion;
     
+    // Snapshot the overlay so the handler's repaint can be limited to what changed
+    OverlaySnapshot overlayBefore = overlaySnapshot();
+    QSet<QString> exclusionsBefore = staticLayerExclusions();
+    double scaleBefore = scaleFactor;
+    QPointF offsetBefore = imageOffset;
+    regionsEditedDuringDrag = false;
+    
     inputHandler->handleMousePress(event,
                                    static_cast<ocr_orc::MouseMode>(mouseMode),
                                    isRotateMode,
@@ -319,10 +488,11 @@ void Canvas::mousePressEvent(QMouseEvent* event) {
                                    isPanning, panStartPos, panStartOffset, imageOffset,
                                    hitTester, selectionManager, regionCreator, regionOperations,
                                    [this](const QPointF& pos) { return this->widgetToCanvas(pos); },
-                                   [this]() { this->update(); },
+                                   [this]() { overlayUpdateRequested = true; },
                                    [this](Qt::CursorShape shape) { this->setCursor(shape); },
                                    [this]() { this->calculateLayout(); },
                                    [this](const QString&) { emit this->regionCreationRequested(); });
+    updateOverlay(overlayBefore, exclusionsBefore, scaleBefore, offsetBefore);
     
     // Emit selectionChanged if selection was modified
     if (selectedRegions != previousSelection || primarySelectedRegion != previousPrimary) {
@@ -335,6 +505,11 @@ void Canvas::mouseMoveEvent(QMouseEvent* event) {
         return;
     }
     
+    OverlaySnapshot overlayBefore = overlaySnapshot();
+    QSet<QString> exclusionsBefore = staticLayerExclusions();
+    double scaleBefore = scaleFactor;
+    QPointF offsetBefore = imageOffset;
+    
     inputHandler->handleMouseMove(event,
                                    static_cast<ocr_orc::MouseMode>(mouseMode),
                                    isRotateMode,
@@ -352,9 +527,10 @@ void Canvas::mouseMoveEvent(QMouseEvent* event) {
                                   [this](const QString& name, const QPointF& delta) { this->moveRegion(name, delta); },
                                   [this](const QPointF& delta) { this->moveSelectedRegions(delta); },
                                   [this](const QString& name, const QString& handle, const QPointF& pos) { this->resizeRegion(name, handle, pos); },
-                                  [this]() { this->update(); },
+                                  [this]() { overlayUpdateRequested = true; },
                                   [this]() { this->calculateLayout(); },
                                   [this](Qt::CursorShape shape) { this->setCursor(shape); });
+    updateOverlay(overlayBefore, exclusionsBefore, scaleBefore, offsetBefore);
 }
 
 void Canvas::mouseReleaseEvent(QMouseEvent* event) {
@@ -367,6 +543,11 @@ void Canvas::mouseReleaseEvent(QMouseEvent* event) {
     QString previousPrimary = primarySelectedRegion;
     bool wasBoxSelecting = isBoxSelecting;
     
+    OverlaySnapshot overlayBefore = overlaySnapshot();
+    QSet<QString> exclusionsBefore = staticLayerExclusions();
+    double scaleBefore = scaleFactor;
+    QPointF offsetBefore = imageOffset;
+    
     inputHandler->handleMouseRelease(event,
                                     static_cast<ocr_orc::MouseMode>(mouseMode),
                                     documentState, documentImage, imageRect,
@@ -385,14 +566,19 @@ void Canvas::mouseReleaseEvent(QMouseEvent* event) {
                                     [this](const QString& name, const QPointF& delta) { this->moveRegion(name, delta); },
                                     [this](const QPointF& delta) { this->moveSelectedRegions(delta); },
                                     [this](const QString& name, const QString& handle, const QPointF& pos) { this->resizeRegion(name, handle, pos); },
-                                    [this]() { this->update(); },
+                                    [this]() { overlayUpdateRequested = true; },
                                     [this]() { this->calculateLayout(); },
                                     [this](Qt::CursorShape shape) { this->setCursor(shape); },
                                     [this](const QString&) { emit this->regionCreationRequested(); },
                                     [this]() { emit this->stateChanged(); });
-    
-    // Emit selectionChanged if selection was modified (especially after box selection)
-    if (selectedRegions != previousSelection || primarySelectedRegion != previousPrimary || wasBoxSelecting) {
+    updateOverlay(overlayBefore, exclusionsBefore, scaleBefore, offsetBefore);
+    
+    // Emit selectionChanged if selection was modified (especially after box selection),
+    // or once for a finished drag/resize so the region editor shows the final geometry
+    bool editedDuringDrag = regionsEditedDuringDrag;
+    regionsEditedDuringDrag = false;
+    if (selectedRegions != previousSelection || primarySelectedRegion != previousPrimary ||
+        wasBoxSelecting || editedDuringDrag) {
         emit selectionChanged();
     }
 }
@@ -422,7 +608,7 @@ void Canvas::startRegionCreation(const QPointF& pos) {
         return;
     }
     if (regionCreator->startRegionCreation(pos, imageRect, isCreating, creationStartPos, tempRect)) {
-        update();
+        invalidateLayer();
     }
 }
 
@@ -431,7 +617,7 @@ void Canvas::updateRegionCreation(const QPointF& pos) {
         return;
     }
     regionCreator->updateRegionCreation(pos, isCreating, creationStartPos, imageRect, tempRect);
-    update(); // Trigger repaint to show temporary rectangle
+    invalidateLayer(); // Trigger repaint to show temporary rectangle
 }
 
 bool Canvas::finishRegionCreation(const QString& regionName, 
@@ -452,7 +638,7 @@ bool Canvas::finishRegionCreation(const QString& regionName,
                                                       validateFunc);
     
     if (result) {
-        update();
+        invalidateLayer();
         emit regionCreated(regionName);
     }
     
@@ -495,7 +681,7 @@ void Canvas::updateHoverState(const QPointF& canvasPos) {
                                    scaleFactor, imageOffset,
                                    selectedRegions, primarySelectedRegion, hoveredRegion,
                                    hitTester,
-                                   [this]() { this->update(); });
+                                   [this]() { this->invalidateLayer(); });
     // Note: Cursor is set in mouse move handler via hover manager
 }
 
@@ -503,28 +689,28 @@ void Canvas::clearSelection() {
     if (!stateManager) return;
     stateManager->clearSelection(selectionManager, selectedRegions, primarySelectedRegion);
     emit selectionChanged();
-    update();
+    invalidateLayer();
 }
 
 void Canvas::selectRegion(const QString& regionName) {
     if (!stateManager) return;
     stateManager->selectRegion(regionName, selectionManager, selectedRegions, primarySelectedRegion);
     emit selectionChanged();
-    update();
+    invalidateLayer();
 }
 
 void Canvas::toggleRegionSelection(const QString& regionName) {
     if (!stateManager) return;
     stateManager->toggleRegionSelection(regionName, selectionManager, selectedRegions, primarySelectedRegion);
     emit selectionChanged();
-    update();
+    invalidateLayer();
 }
 
 void Canvas::addToSelection(const QSet<QString>& regionNames) {
     if (!stateManager) return;
     stateManager->addToSelection(regionNames, selectionManager, selectedRegions, primarySelectedRegion);
     emit selectionChanged();
-    update();
+    invalidateLayer();
 }
 
 QSet<QString> Canvas::findRegionsInBox(const QRectF& box) const {
@@ -536,30 +722,49 @@ void Canvas::moveRegion(const QString& regionName, const QPointF& delta) {
     if (!regionManager) return;
     regionManager->moveRegion(regionName, delta, documentState, documentImage,
                              scaleFactor, imageOffset, regionOperations);
-    // Invalidate coordinate cache after region move
-    invalidateCoordinateCache();
+    // Refresh only the moved region's cached geometry
+    coordinateCache->updateRegion(regionName, documentState,
+                                  documentImage.width(), documentImage.height());
+    
+    // Mid-drag: the region is in the overlay, so repaint only its old/new bounds
+    // and tell the region editor once on release instead of on every step
+    if ((isDragging || isResizing) && staticLayerExclusions().contains(regionName)) {
+        regionsEditedDuringDrag = true;
+        overlayUpdateRequested = true;
+        return;
+    }
     
     // If this region is currently selected, emit selectionChanged to update region editor
     if (selectedRegions.contains(regionName)) {
         emit selectionChanged();
     }
     
-    update();
+    invalidateLayer();
 }
 
 void Canvas::moveSelectedRegions(const QPointF& delta) {
     if (!regionManager) return;
     regionManager->moveSelectedRegions(delta, documentState, documentImage,
                                       scaleFactor, imageOffset, selectedRegions, regionOperations);
-    // Invalidate coordinate cache after region move
-    invalidateCoordinateCache();
+    // Refresh only the moved regions' cached geometry
+    for (const QString& regionName : selectedRegions) {
+        coordinateCache->updateRegion(regionName, documentState,
+                                      documentImage.width(), documentImage.height());
+    }
+    
+    // Mid-drag: selected regions live in the overlay (see moveRegion)
+    if (isDragging) {
+        regionsEditedDuringDrag = !selectedRegions.isEmpty();
+        overlayUpdateRequested = true;
+        return;
+    }
     
     // If any regions are selected, emit selectionChanged to update region editor
     if (!selectedRegions.isEmpty()) {
         emit selectionChanged();
     }
     
-    update();
+    invalidateLayer();
 }
 
 QList<QString> Canvas::duplicateSelectedRegions() {
@@ -570,7 +775,7 @@ QList<QString> Canvas::duplicateSelectedRegions() {
     
     if (!duplicatedNames.isEmpty()) {
         emit regionsDuplicated(duplicatedNames);
-        update();
+        invalidateLayer();
     }
     return duplicatedNames;
 }
@@ -636,15 +841,23 @@ void Canvas::resizeRegion(const QString& regionName, const QString& handle, cons
     regionOperations->resizeRegion(regionName, handle, newPos, resizeStartRect,
                                   documentState, documentImage, scaleFactor,
                                   imageOffset, imageRect, rotationAngle, originalNorm);
-    // Invalidate coordinate cache after region resize
-    invalidateCoordinateCache();
+    // Refresh only the resized region's cached geometry
+    coordinateCache->updateRegion(regionName, documentState,
+                                  documentImage.width(), documentImage.height());
+    
+    // Mid-resize: the region is in the overlay (see moveRegion)
+    if (isResizing) {
+        regionsEditedDuringDrag = true;
+        overlayUpdateRequested = true;
+        return;
+    }
     
     // If this region is currently selected, emit selectionChanged to update region editor
     if (selectedRegions.contains(regionName)) {
         emit selectionChanged();
     }
     
-    update();
+    invalidateLayer();
 }
 
 void Canvas::keyPressEvent(QKeyEvent* event) {
@@ -664,7 +877,7 @@ void Canvas::keyPressEvent(QKeyEvent* event) {
                                 [this]() { this->zoomOut(); },
                                 [this]() { this->zoomReset(); },
                                 [this](ocr_orc::MouseMode mode) { this->setMode(static_cast<MouseMode>(mode)); },
-                                [this]() { this->update(); },
+                                [this]() { this->invalidateLayer(); },
                                 [this](Qt::CursorShape shape) { this->setCursor(shape); },
                                 [this](const QString&) { emit this->undoRequested(); },
                                 [this](const QString&) { emit this->redoRequested(); },
@@ -679,9 +892,9 @@ void Canvas::keyPressEvent(QKeyEvent* event) {
 void Canvas::zoomIn() {
     if (!zoomManager) return;
     zoomManager->zoomIn(documentState, documentImage, width(), height(),
-                       scaleFactor, imageOffset, zoomController, coordinateCache);
+                       scaleFactor, imageOffset, zoomController);
     calculateLayout();
-    update();
+    invalidateLayer();
     if (documentState) {
         emit zoomChanged(documentState->zoomLevel);
     }
@@ -690,9 +903,9 @@ void Canvas::zoomIn() {
 void Canvas::zoomOut() {
     if (!zoomManager) return;
     zoomManager->zoomOut(documentState, documentImage, width(), height(),
-                        scaleFactor, imageOffset, zoomController, coordinateCache);
+                        scaleFactor, imageOffset, zoomController);
     calculateLayout();
-    update();
+    invalidateLayer();
     if (documentState) {
         emit zoomChanged(documentState->zoomLevel);
     }
@@ -701,9 +914,9 @@ void Canvas::zoomOut() {
 void Canvas::zoomReset() {
     if (!zoomManager) return;
     zoomManager->zoomReset(documentState, documentImage, width(), height(),
-                          scaleFactor, imageOffset, zoomController, coordinateCache);
+                          scaleFactor, imageOffset, zoomController);
     calculateLayout();
-    update();
+    invalidateLayer();
     if (documentState) {
         emit zoomChanged(documentState->zoomLevel);
     }
@@ -713,9 +926,9 @@ void Canvas::setZoom(double zoomLevel) {
     if (!zoomManager) return;
     zoomManager->setZoom(zoomLevel, documentState, documentImage,
                         width(), height(), scaleFactor, imageOffset,
-                        zoomController, coordinateCache);
+                        zoomController);
     calculateLayout();
-    update();
+    invalidateLayer();
     // Always emit signal with the actual zoom level
     if (documentState) {
         emit zoomChanged(documentState->zoomLevel);
@@ -731,9 +944,9 @@ void Canvas::setZoomAtPoint(double zoomLevel, const QPointF& widgetPos) {
     double oldZoom = documentState ? documentState->zoomLevel : 1.0;
     zoomManager->setZoomAtPoint(zoomLevel, widgetPos, documentState, documentImage,
                                width(), height(), scaleFactor, imageOffset,
-                               zoomController, coordinateCache);
+                               zoomController);
     calculateLayout();
-    update();
+    invalidateLayer();
     // Always emit signal with the actual zoom level - zoomManager may have clamped the value
     if (documentState) {
         double finalZoom = documentState->zoomLevel;
@@ -800,7 +1013,7 @@ void Canvas::wheelEvent(QWheelEvent* event) {
             zoomController->panWithWheel(delta, documentState, imageOffset);
         }
         calculateLayout();
-        update();
+        updateView();
         event->accept();
     }
 }
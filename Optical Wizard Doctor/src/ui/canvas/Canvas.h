@@ -7,6 +7,8 @@
 #include <QtCore/QString>
 #include <QtCore/QSet>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
 #include <QtCore/QTimer>
 #include <QtGui/QMouseEvent>
 #include "../../models/DocumentState.h"
@@ -14,6 +16,8 @@
 #include "../../core/Constants.h"
 #include "core/coordinate/CanvasCoordinateCache.h"
 #include "core/rendering/CanvasRenderer.h"
+#include "core/rendering/CanvasLayerCache.h"
+#include "core/rendering/CanvasTileRenderer.h"
 #include "core/zoom/CanvasZoomController.h"
 #include "core/regions/CanvasRegionOperations.h"
 #include "core/selection/CanvasSelectionManager.h"
@@ -45,13 +49,6 @@ class Canvas : public QWidget {
 public:
     explicit Canvas(QWidget *parent = nullptr);
     ~Canvas();
-
-    /**
-     * @brief Load a PDF file and display the first page
-     * @param filePath Path to the PDF file
-     * @return true if PDF loaded successfully, false otherwise
-     */
-    bool loadPdf(const QString& filePath);
     
     /**
      * @brief Set the document image directly (for testing or alternative loading)
@@ -119,6 +116,27 @@ public:
      */
     void invalidateCoordinateCache();
     
+    /**
+     * @brief Repaint the whole canvas after a content change
+     * Drops the cached static layer so region edits made outside the canvas
+     * (colors, names, undo, imports) are picked up. Plain QWidget::update()
+     * repaints from the cached layer (see updateView()).
+     */
+    void invalidateLayer();
+    
+    /**
+     * @brief Show a partial result of a running detection on top of the page
+     * Layers stay until clearDetectionLayers(); a newer layer of the same
+     * kind replaces the older one.
+     * @param layer Layer published by the detector
+     */
+    void addDetectionLayer(const PartialDetectionLayer& layer);
+    
+    /**
+     * @brief Remove all partial detection layers (run finished or cancelled)
+     */
+    void clearDetectionLayers();
+    
     /**
      * @brief Clear all selections
      */
@@ -406,7 +424,52 @@ private:
      * @param rect Optional dirty region to update
      */
     void batchedUpdate(const QRect& rect = QRect());
-
+    
+    /**
+     * @brief Repaint the whole canvas for a view change (pan/zoom) without dropping the static layer
+     */
+    void updateView();
+    
+    /**
+     * @brief (Re)arm the detail tile request if the visible part of the page changed
+     * Called on paint; drops the tile when the page raster is no longer magnified.
+     */
+    void scheduleDetailTile();
+    
+    /**
+     * @brief Drop the detail tile and abandon any request in flight
+     */
+    void clearDetailTile();
+    
+    using OverlaySnapshot = CanvasLayerCache::OverlaySnapshot;
+    
+    /**
+     * @brief Regions drawn by the overlay instead of the static layer
+     * @return Selected and hovered regions plus the region being resized or rotated
+     *
+     * A region drawn in both would have its label and fill composited twice.
+     */
+    QSet<QString> staticLayerExclusions() const;
+    
+    /**
+     * @brief Capture what the overlay currently paints, for dirty-rect diffing
+     */
+    OverlaySnapshot overlaySnapshot() const;
+    
+    /**
+     * @brief Repaint only what changed in the overlay since a snapshot
+     * Falls back to a full repaint when the view or the static layer's
+     * exclusion set changed.
+     * @param before Snapshot taken before the change
+     * @param exclusionsBefore staticLayerExclusions() before the change
+     * @param scaleBefore Scale factor before the change
+     * @param offsetBefore Image offset before the change
+     */
+    void updateOverlay(const OverlaySnapshot& before,
+                       const QSet<QString>& exclusionsBefore,
+                       double scaleBefore,
+                       const QPointF& offsetBefore);
+    
     // Document image
     QImage documentImage;
     
@@ -468,6 +531,13 @@ private:
     
     // Rendering
     CanvasRenderer* renderer;  // Renderer for all painting operations
+    CanvasLayerCache* layerCache;  // Retained page + static regions layer
+    CanvasTileRenderer* tileRenderer;  // Sharp re-render of the visible page area when zoomed in
+    QTimer* tileTimer;                 // Debounces tile requests while panning/zooming
+    QRectF wantedTileRect;             // Visible part of the page (0..1) the next tile should cover
+    double wantedTileDpi;              // Resolution the next tile should have (0: no tile wanted)
+    bool overlayUpdateRequested;   // Set by input handlers instead of a full repaint
+    bool regionsEditedDuringDrag;  // Drag/resize moved regions; selectionChanged is due on release
     
     // Zoom and pan
     CanvasZoomController* zoomController;  // Zoom and pan controller
@@ -506,6 +576,9 @@ private:
     QTimer* updateTimer;                   // Timer for batching update() calls
     QRect pendingUpdateRect;               // Accumulated dirty region for batched update
     
+    // Partial results of a running detection (drawn above the overlay)
+    QList<PartialDetectionLayer> detectionLayers;
+    
     // Performance optimization: Cached colors
     mutable QMap<QString, QColor> colorCache;  // Cache QColor objects by color name
     
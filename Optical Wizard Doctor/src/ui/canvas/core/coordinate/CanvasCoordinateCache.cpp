@@ -4,9 +4,7 @@
 namespace ocr_orc {
 
 CanvasCoordinateCache::CanvasCoordinateCache()
-    : cachedZoomLevel(1.0)
-    , cachedImageOffset(0.0, 0.0)
-    , cachedImageSize(0, 0)
+    : cachedImageSize(0, 0)
     , cacheValid(false)
 {
 }
@@ -15,91 +13,93 @@ CanvasCoordinateCache::~CanvasCoordinateCache() {
     // QMap automatically cleans up
 }
 
-QRectF CanvasCoordinateCache::getCachedCoordinates(const QString& regionName,
-                                                    DocumentState* documentState,
-                                                    int imgWidth, int imgHeight,
-                                                    double scaleFactor,
-                                                    const QPointF& imageOffset) {
-    if (!documentState || !documentState->hasRegion(regionName)) {
+QTransform CanvasCoordinateCache::viewTransform(double scaleFactor, const QPointF& imageOffset) {
+    // canvas = image * scaleFactor + offset (same as CoordinateSystem::imageToCanvas)
+    return QTransform(scaleFactor, 0.0, 0.0, scaleFactor, imageOffset.x(), imageOffset.y());
+}
+
+QRectF CanvasCoordinateCache::computeImageRect(const RegionData& region, int imgWidth, int imgHeight) {
+    ImageCoords img = CoordinateSystem::normalizedToImage(region.normalizedCoords, imgWidth, imgHeight);
+    return QRectF(QPointF(img.x1, img.y1), QPointF(img.x2, img.y2));
+}
+
+QRectF CanvasCoordinateCache::getImageRect(const QString& regionName,
+                                           DocumentState* documentState,
+                                           int imgWidth, int imgHeight) {
+    if (!documentState) {
+        return QRectF();
+    }
+    
+    auto region = documentState->regions.constFind(regionName);
+    if (region == documentState->regions.constEnd()) {
         return QRectF();
     }
     
     // Check if cached
-    if (coordinateCache.contains(regionName)) {
-        return coordinateCache.value(regionName);
+    auto cached = imageRectCache.constFind(regionName);
+    if (cached != imageRectCache.constEnd()) {
+        return cached.value();
     }
     
     // Cache miss - calculate and cache it
-    RegionData region = documentState->getRegion(regionName);
-    NormalizedCoords norm = region.normalizedCoords;
-    CanvasCoords canvasCoords = CoordinateSystem::normalizedToCanvas(
-        norm, imgWidth, imgHeight, scaleFactor, imageOffset
-    );
-    
-    QRectF canvasRect(
-        canvasCoords.x1,
-        canvasCoords.y1,
-        canvasCoords.x2 - canvasCoords.x1,
-        canvasCoords.y2 - canvasCoords.y1
-    );
-    
-    // Cache it
-    coordinateCache[regionName] = canvasRect;
-    
-    return canvasRect;
+    QRectF imageRect = computeImageRect(region.value(), imgWidth, imgHeight);
+    imageRectCache.insert(regionName, imageRect);
+    return imageRect;
 }
 
-void CanvasCoordinateCache::updateCache(DocumentState* documentState,
-                                        int imgWidth, int imgHeight,
-                                        double scaleFactor,
-                                        const QPointF& imageOffset,
-                                        double zoomLevel) {
+QRectF CanvasCoordinateCache::getCachedCoordinates(const QString& regionName,
+                                                    DocumentState* documentState,
+                                                    int imgWidth, int imgHeight,
+                                                    double scaleFactor,
+                                                    const QPointF& imageOffset) {
+    QRectF imageRect = getImageRect(regionName, documentState, imgWidth, imgHeight);
+    if (imageRect.isNull()) {
+        return QRectF();
+    }
+    return viewTransform(scaleFactor, imageOffset).mapRect(imageRect);
+}
+
+void CanvasCoordinateCache::updateCache(DocumentState* documentState, int imgWidth, int imgHeight) {
     if (!documentState) {
         return;
     }
     
-    coordinateCache.clear();
+    imageRectCache.clear();
     
-    QList<QString> regionNames = documentState->getAllRegionNames();
-    for (const QString& regionName : regionNames) {
-        RegionData region = documentState->getRegion(regionName);
-        
-        // Convert normalized coordinates to canvas coordinates
-        NormalizedCoords norm = region.normalizedCoords;
-        CanvasCoords canvasCoords = CoordinateSystem::normalizedToCanvas(
-            norm, imgWidth, imgHeight, scaleFactor, imageOffset
-        );
-        
-        // Create QRectF from canvas coordinates and cache it
-        QRectF canvasRect(
-            canvasCoords.x1,
-            canvasCoords.y1,
-            canvasCoords.x2 - canvasCoords.x1,
-            canvasCoords.y2 - canvasCoords.y1
-        );
-        coordinateCache[regionName] = canvasRect;
+    // Iterate in place: no name list or RegionData copies
+    for (auto it = documentState->regions.constBegin(); it != documentState->regions.constEnd(); ++it) {
+        imageRectCache.insert(it.key(), computeImageRect(it.value(), imgWidth, imgHeight));
     }
     
     // Update cache metadata
-    cachedZoomLevel = zoomLevel;
-    cachedImageOffset = imageOffset;
     cachedImageSize = QSize(imgWidth, imgHeight);
     cacheValid = true;
 }
 
-bool CanvasCoordinateCache::needsUpdate(double zoomLevel,
-                                        const QPointF& imageOffset,
-                                        const QSize& imageSize) const {
-    return !cacheValid ||
-           cachedZoomLevel != zoomLevel ||
-           cachedImageOffset != imageOffset ||
-           cachedImageSize != imageSize;
+void CanvasCoordinateCache::updateRegion(const QString& regionName,
+                                         DocumentState* documentState,
+                                         int imgWidth, int imgHeight) {
+    if (!cacheValid || !documentState || cachedImageSize != QSize(imgWidth, imgHeight)) {
+        // Nothing worth patching; next paint rebuilds
+        invalidate();
+        return;
+    }
+    
+    auto region = documentState->regions.constFind(regionName);
+    if (region == documentState->regions.constEnd()) {
+        imageRectCache.remove(regionName);
+        return;
+    }
+    imageRectCache.insert(regionName, computeImageRect(region.value(), imgWidth, imgHeight));
+}
+
+bool CanvasCoordinateCache::needsUpdate(const QSize& imageSize) const {
+    return !cacheValid || cachedImageSize != imageSize;
 }
 
 void CanvasCoordinateCache::invalidate() {
     cacheValid = false;
-    coordinateCache.clear();
+    imageRectCache.clear();
 }
 
 } // namespace ocr_orc
-
@@ -6,6 +6,7 @@
 #include <QtCore/QPointF>
 #include <QtCore/QRectF>
 #include <QtCore/QSize>
+#include <QtGui/QTransform>
 #include "../../../../models/DocumentState.h"
 #include "../../../../core/CoordinateSystem.h"
 
@@ -13,10 +14,11 @@ namespace ocr_orc {
 
 /**
  * @brief Manages coordinate caching for canvas regions
- * 
- * Caches canvas coordinates for regions to avoid recalculating
- * on every paint event. Cache is invalidated when zoom, pan, or
- * image size changes.
+ *
+ * Caches region geometry in IMAGE space (pixels), so entries only change
+ * when a region is edited or the image size changes. Zoom and pan are a
+ * single view transform (image -> canvas) applied at paint time; they never
+ * touch the cache.
  */
 class CanvasCoordinateCache {
 public:
@@ -24,14 +26,34 @@ public:
     ~CanvasCoordinateCache();
     
     /**
-     * @brief Get cached canvas coordinates for a region
+     * @brief Build the image -> canvas view transform
+     * @param scaleFactor Current scale factor
+     * @param imageOffset Current image offset
+     * @return Transform mapping image pixels to canvas coordinates
+     */
+    static QTransform viewTransform(double scaleFactor, const QPointF& imageOffset);
+    
+    /**
+     * @brief Get cached image-space rectangle for a region
+     * @param regionName Name of the region
+     * @param documentState Document state containing region data
+     * @param imgWidth Image width
+     * @param imgHeight Image height
+     * @return Cached image rectangle, or calculates if not cached
+     */
+    QRectF getImageRect(const QString& regionName,
+                        DocumentState* documentState,
+                        int imgWidth, int imgHeight);
+    
+    /**
+     * @brief Get canvas coordinates for a region (cached image rect through the view transform)
      * @param regionName Name of the region
      * @param documentState Document state containing region data
      * @param imgWidth Image width
      * @param imgHeight Image height
      * @param scaleFactor Current scale factor
      * @param imageOffset Current image offset
-     * @return Cached canvas rectangle, or calculates if not cached
+     * @return Canvas rectangle, or empty if the region doesn't exist
      */
     QRectF getCachedCoordinates(const QString& regionName,
                                 DocumentState* documentState,
@@ -40,30 +62,30 @@ public:
                                 const QPointF& imageOffset);
     
     /**
-     * @brief Update cache for all regions
+     * @brief Rebuild the cache for all regions
      * @param documentState Document state containing all regions
      * @param imgWidth Image width
      * @param imgHeight Image height
-     * @param scaleFactor Current scale factor
-     * @param imageOffset Current image offset
-     * @param zoomLevel Current zoom level
      */
-    void updateCache(DocumentState* documentState,
-                     int imgWidth, int imgHeight,
-                     double scaleFactor,
-                     const QPointF& imageOffset,
-                     double zoomLevel);
+    void updateCache(DocumentState* documentState, int imgWidth, int imgHeight);
+    
+    /**
+     * @brief Refresh one region's entry after it was edited
+     * @param regionName Name of the region (removed from the cache if it no longer exists)
+     * @param documentState Document state containing region data
+     * @param imgWidth Image width
+     * @param imgHeight Image height
+     */
+    void updateRegion(const QString& regionName,
+                      DocumentState* documentState,
+                      int imgWidth, int imgHeight);
     
     /**
      * @brief Check if cache needs updating
-     * @param zoomLevel Current zoom level
-     * @param imageOffset Current image offset
      * @param imageSize Current image size
-     * @return true if cache needs update
+     * @return true if cache is invalid or was built for a different image size
      */
-    bool needsUpdate(double zoomLevel,
-                     const QPointF& imageOffset,
-                     const QSize& imageSize) const;
+    bool needsUpdate(const QSize& imageSize) const;
     
     /**
      * @brief Invalidate the cache
@@ -77,15 +99,15 @@ public:
     bool isValid() const { return cacheValid; }
     
     /**
-     * @brief Get all cached region coordinates
-     * @return Map of region names to canvas rectangles
+     * @brief Get all cached region rectangles
+     * @return Map of region names to image-space rectangles (sorted by name)
      */
-    QMap<QString, QRectF> getAllCachedCoordinates() const { return coordinateCache; }
+    const QMap<QString, QRectF>& getAllImageRects() const { return imageRectCache; }
 
 private:
-    QMap<QString, QRectF> coordinateCache;  // Cached canvas coordinates per region
-    double cachedZoomLevel;                 // Zoom level when cache was created
-    QPointF cachedImageOffset;              // Image offset when cache was created
+    static QRectF computeImageRect(const RegionData& region, int imgWidth, int imgHeight);
+    
+    QMap<QString, QRectF> imageRectCache;   // Cached image-space rectangles per region
     QSize cachedImageSize;                  // Image size when cache was created
     bool cacheValid;                        // Whether cache is valid
 };
@@ -93,4 +115,3 @@ private:
 } // namespace ocr_orc
 
 #endif // CANVAS_COORDINATE_CACHE_H
-
@@ -0,0 +1,193 @@
+#include "CanvasLayerCache.h"
+#include "CanvasRenderer.h"
+#include "../coordinate/CanvasCoordinateCache.h"
+#include "../../../../core/Constants.h"
+#include <cmath>
+
+namespace ocr_orc {
+
+CanvasLayerCache::CanvasLayerCache()
+    : pageSpace(true)
+    , layerOrigin(0.0, 0.0)
+    , subPixelOffset(0.0, 0.0)
+    , cachedImageKey(0)
+    , cachedScaleFactor(0.0)
+    , cachedImageOffset(0.0, 0.0)
+    , cachedWidgetSize(0, 0)
+    , cachedDevicePixelRatio(1.0)
+    , layerValid(false)
+    , rebuildCount(0)
+{
+}
+
+CanvasLayerCache::~CanvasLayerCache() {
+    // QPixmap automatically cleans up
+}
+
+QRect CanvasLayerCache::overlayDirtyRect(const OverlaySnapshot& before, const OverlaySnapshot& after) {
+    // Items that appeared, disappeared, moved or changed state: old and new bounds
+    QRect dirty;
+    for (auto it = before.constBegin(); it != before.constEnd(); ++it) {
+        if (after.value(it.key()) != it.value()) {
+            dirty |= it.value().first.toAlignedRect();
+        }
+    }
+    for (auto it = after.constBegin(); it != after.constEnd(); ++it) {
+        if (before.value(it.key()) != it.value()) {
+            dirty |= it.value().first.toAlignedRect();
+        }
+    }
+    return dirty;
+}
+
+void CanvasLayerCache::invalidate() {
+    layerValid = false;
+}
+
+void CanvasLayerCache::setDetailTile(const QImage& tile, const QRectF& normalizedRect) {
+    if (tile.isNull() && detailTile.isNull()) {
+        return;
+    }
+    detailTile = tile;
+    detailTileRect = tile.isNull() ? QRectF() : normalizedRect;
+    layerValid = false;
+}
+
+bool CanvasLayerCache::matches(const QImage& documentImage, double scaleFactor, const QPointF& imageOffset,
+                               const QSize& widgetSize, qreal devicePixelRatio,
+                               const QSet<QString>& excludedRegions) const {
+    if (!layerValid ||
+        cachedImageKey != documentImage.cacheKey() ||
+        cachedScaleFactor != scaleFactor ||
+        cachedDevicePixelRatio != devicePixelRatio ||
+        cachedExcludedRegions != excludedRegions) {
+        return false;
+    }
+    
+    if (pageSpace) {
+        // Panning by whole pixels reuses the layer; only the sub-pixel phase is baked in
+        QPointF phase(imageOffset.x() - std::floor(imageOffset.x()),
+                      imageOffset.y() - std::floor(imageOffset.y()));
+        return phase == subPixelOffset;
+    }
+    
+    return cachedImageOffset == imageOffset && cachedWidgetSize == widgetSize;
+}
+
+void CanvasLayerCache::paint(QPainter& painter,
+                             const QRect& exposedRect,
+                             CanvasRenderer* renderer,
+                             DocumentState* documentState,
+                             CanvasCoordinateCache* coordinateCache,
+                             const QImage& documentImage,
+                             double scaleFactor,
+                             const QPointF& imageOffset,
+                             const QSize& widgetSize,
+                             qreal devicePixelRatio,
+                             const QSet<QString>& excludedRegions) {
+    if (!renderer || documentImage.isNull() || scaleFactor <= 0.0) {
+        return;
+    }
+    
+    if (!matches(documentImage, scaleFactor, imageOffset, widgetSize, devicePixelRatio, excludedRegions)) {
+        rebuild(renderer, documentState, coordinateCache, documentImage, scaleFactor, imageOffset,
+                widgetSize, devicePixelRatio, excludedRegions);
+    }
+    if (layer.isNull()) {
+        return;
+    }
+    
+    // Where the layer sits on the canvas (always whole pixels, so the blit is 1:1)
+    QPointF topLeft = layerOrigin;
+    if (pageSpace) {
+        topLeft += QPointF(std::floor(imageOffset.x()), std::floor(imageOffset.y()));
+    }
+    QRectF layerRect(topLeft, QSizeF(layer.size()) / layer.devicePixelRatio());
+    
+    // Blit only the exposed part
+    QRectF target = layerRect.intersected(QRectF(exposedRect));
+    if (target.isEmpty()) {
+        return;
+    }
+    QRectF source(
+        (target.topLeft() - topLeft) * layer.devicePixelRatio(),
+        target.size() * layer.devicePixelRatio()
+    );
+    painter.drawPixmap(target, layer, source);
+}
+
+void CanvasLayerCache::rebuild(CanvasRenderer* renderer,
+                               DocumentState* documentState,
+                               CanvasCoordinateCache* coordinateCache,
+                               const QImage& documentImage,
+                               double scaleFactor,
+                               const QPointF& imageOffset,
+                               const QSize& widgetSize,
+                               qreal devicePixelRatio,
+                               const QSet<QString>& excludedRegions) {
+    const double margin = CanvasConstants::LAYER_MARGIN;
+    const QSizeF scaledPage(documentImage.width() * scaleFactor, documentImage.height() * scaleFactor);
+    const QSizeF pageLayerSize(std::ceil(scaledPage.width() + 2.0 * margin + 1.0),
+                               std::ceil(scaledPage.height() + 2.0 * margin + 1.0));
+    const double pagePixels = pageLayerSize.width() * pageLayerSize.height() *
+                              devicePixelRatio * devicePixelRatio;
+    
+    // Offset of the page inside the layer
+    QPointF pageOffset;
+    QSize logicalSize;
+    pageSpace = pagePixels <= static_cast<double>(CanvasConstants::STATIC_LAYER_MAX_PIXELS);
+    if (pageSpace) {
+        subPixelOffset = QPointF(imageOffset.x() - std::floor(imageOffset.x()),
+                                 imageOffset.y() - std::floor(imageOffset.y()));
+        pageOffset = QPointF(margin, margin) + subPixelOffset;
+        layerOrigin = QPointF(-margin, -margin);
+        logicalSize = pageLayerSize.toSize();
+    } else {
+        // Zoomed in too far to hold the whole page: cache what is on screen
+        subPixelOffset = QPointF(0.0, 0.0);
+        pageOffset = imageOffset;
+        layerOrigin = QPointF(0.0, 0.0);
+        logicalSize = widgetSize;
+    }
+    
+    layerValid = false;
+    ++rebuildCount;
+    if (logicalSize.isEmpty()) {
+        layer = QPixmap();
+        return;
+    }
+    
+    layer = QPixmap(logicalSize * devicePixelRatio);
+    layer.setDevicePixelRatio(devicePixelRatio);
+    layer.fill(Qt::transparent);
+    
+    QPainter layerPainter(&layer);
+    layerPainter.setRenderHint(QPainter::Antialiasing, true);
+    layerPainter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    
+    renderer->drawDocumentImage(layerPainter, documentImage, QRectF(pageOffset, scaledPage));
+    if (!detailTile.isNull()) {
+        // Same page geometry as the image, just more pixels
+        QRectF tileTarget(pageOffset.x() + detailTileRect.x() * scaledPage.width(),
+                          pageOffset.y() + detailTileRect.y() * scaledPage.height(),
+                          detailTileRect.width() * scaledPage.width(),
+                          detailTileRect.height() * scaledPage.height());
+        layerPainter.drawImage(tileTarget, detailTile);
+    }
+    if (documentState && coordinateCache) {
+        renderer->renderStaticRegions(layerPainter, documentState, coordinateCache, documentImage,
+                                      scaleFactor, pageOffset, QRectF(QPointF(0.0, 0.0), QSizeF(logicalSize)),
+                                      excludedRegions);
+    }
+    layerPainter.end();
+    
+    cachedImageKey = documentImage.cacheKey();
+    cachedScaleFactor = scaleFactor;
+    cachedImageOffset = imageOffset;
+    cachedWidgetSize = widgetSize;
+    cachedDevicePixelRatio = devicePixelRatio;
+    cachedExcludedRegions = excludedRegions;
+    layerValid = true;
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,144 @@
+#ifndef CANVAS_LAYER_CACHE_H
+#define CANVAS_LAYER_CACHE_H
+
+#include <QtGui/QPainter>
+#include <QtGui/QPixmap>
+#include <QtGui/QImage>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QPointF>
+#include <QtCore/QRect>
+#include <QtCore/QSet>
+#include <QtCore/QSize>
+#include <QtCore/QString>
+#include "../../../../models/DocumentState.h"
+
+namespace ocr_orc {
+
+class CanvasRenderer;
+class CanvasCoordinateCache;
+
+/**
+ * @brief Retained static layer for the canvas
+ *
+ * Holds the page image (with shadow) and every region that is not part of the
+ * interactive overlay, rasterized once into a pixmap. Paint events blit the
+ * exposed part of it and draw only the overlay (hovered, selected, dragged
+ * regions and handles) on top.
+ *
+ * The layer normally covers the whole scaled page, so it is rebuilt once per
+ * zoom level and panning is a plain blit at a new position. When the scaled
+ * page would exceed CanvasConstants::STATIC_LAYER_MAX_PIXELS the layer covers
+ * the viewport only and is rebuilt when the view moves.
+ *
+ * A detail tile (a sharper re-render of part of the page, see
+ * CanvasTileRenderer) can be set; it is drawn over the page image, below
+ * the regions, wherever it overlaps the layer.
+ */
+class CanvasLayerCache {
+public:
+    // Overlay item (region or rubber band) -> painted bounds and state bits
+    using OverlaySnapshot = QHash<QString, QPair<QRectF, int>>;
+    
+    CanvasLayerCache();
+    ~CanvasLayerCache();
+    
+    /**
+     * @brief Union of old and new bounds of overlay items that changed between snapshots
+     * The overlay is drawn over the layer on every paint, so this is all a
+     * change of the overlay needs to repaint.
+     */
+    static QRect overlayDirtyRect(const OverlaySnapshot& before, const OverlaySnapshot& after);
+    
+    /**
+     * @brief Draw the static layer for the exposed area, rebuilding it if stale
+     * @param painter Widget painter
+     * @param exposedRect Area being repainted (canvas coordinates)
+     * @param renderer Renderer used to rasterize the layer
+     * @param documentState Document state containing regions
+     * @param coordinateCache Image-space region geometry cache
+     * @param documentImage Page image
+     * @param scaleFactor Current scale factor
+     * @param imageOffset Current image offset
+     * @param widgetSize Canvas widget size
+     * @param devicePixelRatio Canvas device pixel ratio
+     * @param excludedRegions Regions drawn by the overlay instead
+     */
+    void paint(QPainter& painter,
+               const QRect& exposedRect,
+               CanvasRenderer* renderer,
+               DocumentState* documentState,
+               CanvasCoordinateCache* coordinateCache,
+               const QImage& documentImage,
+               double scaleFactor,
+               const QPointF& imageOffset,
+               const QSize& widgetSize,
+               qreal devicePixelRatio,
+               const QSet<QString>& excludedRegions);
+    
+    /**
+     * @brief Drop the layer (call when region content or the image changes)
+     */
+    void invalidate();
+    
+    /**
+     * @brief Draw a sharper render of part of the page over the page image
+     * @param tile Rendered crop (null to drop the current tile)
+     * @param normalizedRect Part of the page the tile covers, scaled to 0..1
+     */
+    void setDetailTile(const QImage& tile, const QRectF& normalizedRect);
+    
+    /**
+     * @brief Check if a detail tile is set
+     */
+    bool hasDetailTile() const { return !detailTile.isNull(); }
+    
+    /**
+     * @brief Check if the layer is valid
+     */
+    bool isValid() const { return layerValid; }
+    
+    /**
+     * @brief Number of times the layer has been rasterized (for diagnostics and tests)
+     */
+    int getRebuildCount() const { return rebuildCount; }
+
+private:
+    /**
+     * @brief Check whether the current layer can be reused for this view
+     */
+    bool matches(const QImage& documentImage, double scaleFactor, const QPointF& imageOffset,
+                 const QSize& widgetSize, qreal devicePixelRatio,
+                 const QSet<QString>& excludedRegions) const;
+    
+    void rebuild(CanvasRenderer* renderer,
+                 DocumentState* documentState,
+                 CanvasCoordinateCache* coordinateCache,
+                 const QImage& documentImage,
+                 double scaleFactor,
+                 const QPointF& imageOffset,
+                 const QSize& widgetSize,
+                 qreal devicePixelRatio,
+                 const QSet<QString>& excludedRegions);
+    
+    QPixmap layer;                  // Rasterized page + static regions
+    bool pageSpace;                 // true: layer follows the page; false: layer covers the viewport
+    QPointF layerOrigin;            // Page mode: layer position relative to imageOffset; viewport mode: canvas position
+    QPointF subPixelOffset;         // Page mode: fractional part of imageOffset baked into the layer
+    QImage detailTile;              // Sharper render of part of the page (may be null)
+    QRectF detailTileRect;          // Part of the page detailTile covers, scaled to 0..1
+    
+    // Key the layer was built for
+    qint64 cachedImageKey;
+    double cachedScaleFactor;
+    QPointF cachedImageOffset;
+    QSize cachedWidgetSize;
+    qreal cachedDevicePixelRatio;
+    QSet<QString> cachedExcludedRegions;
+    bool layerValid;
+    int rebuildCount;
+};
+
+} // namespace ocr_orc
+
+#endif // CANVAS_LAYER_CACHE_H
@@ -5,9 +5,12 @@
 #include <QtCore/QMap>
 #include <QtGui/QColor>
 #include <QtGui/QFont>
+#include <QtGui/QFontMetricsF>
+#include <QtCore/QStringList>
 #include <QtGui/QPen>
 #include <QtGui/QBrush>
 #include <QtGui/QPolygonF>
+#include <algorithm>
 
 namespace ocr_orc {
 
@@ -39,52 +42,199 @@ void CanvasRenderer::renderRegions(QPainter& painter,
                                    bool isRotateMode,
                                    const QString& rotatingRegion,
                                    double rotationAngle) {
-    if (!documentState || documentImage.isNull() || !coordinateCache) {
+    QTransform view;
+    QRectF imageViewport;
+    if (!prepareView(documentState, coordinateCache, documentImage, scaleFactor, imageOffset,
+                     viewportRect, view, imageViewport)) {
         return;
     }
     
-    // Get all region names
-    QList<QString> regionNames = documentState->getAllRegionNames();
+    // Render each region (cache is sorted by name, same order as getAllRegionNames)
+    const QMap<QString, QRectF>& imageRects = coordinateCache->getAllImageRects();
+    for (auto it = imageRects.constBegin(); it != imageRects.constEnd(); ++it) {
+        const QRectF& imageRect = it.value();
+        
+        // Viewport culling: Only render if region intersects viewport
+        if (!imageRect.intersects(imageViewport)) {
+            continue;
+        }
+        
+        const QString& regionName = it.key();
+        auto regionIt = documentState->regions.constFind(regionName);
+        if (regionIt == documentState->regions.constEnd()) {
+            continue;
+        }
+        const RegionData& region = regionIt.value();
+        
+        // Determine state
+        bool isHovered = (hoveredRegion == regionName);
+        bool isSelected = selectedRegions.contains(regionName);
+        bool isPrimary = (primarySelectedRegion == regionName && selectedRegions.size() == 1);
+        
+        // Draw the region (with rotation if applicable)
+        bool isRotatingThis = (rotatingRegion == regionName);
+        // Use stored rotation angle from region data, or temporary rotation angle during drag
+        double angleToUse = isRotatingThis ? rotationAngle : region.rotationAngle;
+        drawRegion(painter, region, imageRect, view, isHovered, isSelected, isPrimary, isRotateMode, isRotatingThis || (region.rotationAngle != 0.0), angleToUse);
+    }
+}
+
+bool CanvasRenderer::prepareView(DocumentState* documentState,
+                                 CanvasCoordinateCache* coordinateCache,
+                                 const QImage& documentImage,
+                                 double scaleFactor,
+                                 const QPointF& imageOffset,
+                                 const QRectF& viewportRect,
+                                 QTransform& view,
+                                 QRectF& imageViewport) const {
+    if (!documentState || documentImage.isNull() || !coordinateCache) {
+        return false;
+    }
     
-    // Get image dimensions
-    int imgWidth = documentImage.width();
-    int imgHeight = documentImage.height();
+    // Region geometry is cached in image space; it only needs rebuilding after
+    // edits or an image change, never for zoom or pan
+    if (coordinateCache->needsUpdate(documentImage.size())) {
+        coordinateCache->updateCache(documentState, documentImage.width(), documentImage.height());
+    }
     
-    // Check if coordinate cache needs updating
-    double currentZoom = documentState->zoomLevel;
-    if (coordinateCache->needsUpdate(currentZoom, imageOffset, documentImage.size())) {
-        // Update cache for all regions
-        coordinateCache->updateCache(documentState, imgWidth, imgHeight,
-                                     scaleFactor, imageOffset, currentZoom);
+    // Zoom and pan are a single image -> canvas transform
+    view = CanvasCoordinateCache::viewTransform(scaleFactor, imageOffset);
+    bool invertible = false;
+    const QTransform inverseView = view.inverted(&invertible);
+    if (!invertible) {
+        return false;
     }
     
-    // Render each region (using cached coordinates)
-    for (const QString& regionName : regionNames) {
-        // Get cached canvas coordinates (calculates if not cached)
-        QRectF canvasRect = coordinateCache->getCachedCoordinates(
-            regionName, documentState, imgWidth, imgHeight, scaleFactor, imageOffset);
+    // Cull in image space: map the viewport once instead of every region
+    imageViewport = inverseView.mapRect(viewportRect);
+    return true;
+}
+
+void CanvasRenderer::renderStaticRegions(QPainter& painter,
+                                         DocumentState* documentState,
+                                         CanvasCoordinateCache* coordinateCache,
+                                         const QImage& documentImage,
+                                         double scaleFactor,
+                                         const QPointF& imageOffset,
+                                         const QRectF& viewportRect,
+                                         const QSet<QString>& excludedRegions) {
+    QTransform view;
+    QRectF imageViewport;
+    if (!prepareView(documentState, coordinateCache, documentImage, scaleFactor, imageOffset,
+                     viewportRect, view, imageViewport)) {
+        return;
+    }
+    
+    const QMap<QString, QRectF>& imageRects = coordinateCache->getAllImageRects();
+    for (auto it = imageRects.constBegin(); it != imageRects.constEnd(); ++it) {
+        if (!it.value().intersects(imageViewport) || excludedRegions.contains(it.key())) {
+            continue;
+        }
         
-        // Viewport culling: Only render if region intersects viewport
-        if (canvasRect.intersects(viewportRect)) {
-            RegionData region = documentState->getRegion(regionName);
-            
-            // Determine state
-            bool isHovered = (hoveredRegion == regionName);
-            bool isSelected = selectedRegions.contains(regionName);
-            bool isPrimary = (primarySelectedRegion == regionName && selectedRegions.size() == 1);
-            
-            // Draw the region (with rotation if applicable)
-            bool isRotatingThis = (rotatingRegion == regionName);
-            // Use stored rotation angle from region data, or temporary rotation angle during drag
-            double angleToUse = isRotatingThis ? rotationAngle : region.rotationAngle;
-            drawRegion(painter, region, canvasRect, isHovered, isSelected, isPrimary, isRotateMode, isRotatingThis || (region.rotationAngle != 0.0), angleToUse);
+        auto regionIt = documentState->regions.constFind(it.key());
+        if (regionIt == documentState->regions.constEnd()) {
+            continue;
         }
+        const RegionData& region = regionIt.value();
+        drawRegion(painter, region, it.value(), view, false, false, false, false,
+                   region.rotationAngle != 0.0, region.rotationAngle);
     }
 }
 
+void CanvasRenderer::renderOverlayRegions(QPainter& painter,
+                                          DocumentState* documentState,
+                                          CanvasCoordinateCache* coordinateCache,
+                                          const QImage& documentImage,
+                                          double scaleFactor,
+                                          const QPointF& imageOffset,
+                                          const QRectF& viewportRect,
+                                          const QSet<QString>& overlayRegions,
+                                          const QString& hoveredRegion,
+                                          const QSet<QString>& selectedRegions,
+                                          const QString& primarySelectedRegion,
+                                          bool isRotateMode,
+                                          const QString& rotatingRegion,
+                                          double rotationAngle) {
+    if (overlayRegions.isEmpty()) {
+        return;
+    }
+    
+    QTransform view;
+    QRectF imageViewport;
+    if (!prepareView(documentState, coordinateCache, documentImage, scaleFactor, imageOffset,
+                     viewportRect, view, imageViewport)) {
+        return;
+    }
+    
+    // Same name order as renderRegions so overlapping regions stack the same way
+    QStringList names(overlayRegions.constBegin(), overlayRegions.constEnd());
+    names.sort();
+    
+    const QMap<QString, QRectF>& imageRects = coordinateCache->getAllImageRects();
+    for (const QString& regionName : names) {
+        auto rectIt = imageRects.constFind(regionName);
+        auto regionIt = documentState->regions.constFind(regionName);
+        if (rectIt == imageRects.constEnd() || regionIt == documentState->regions.constEnd()) {
+            continue;
+        }
+        
+        const RegionData& region = regionIt.value();
+        bool isPrimary = (primarySelectedRegion == regionName && selectedRegions.size() == 1);
+        bool isRotatingThis = (rotatingRegion == regionName);
+        double angleToUse = isRotatingThis ? rotationAngle : region.rotationAngle;
+        
+        // Handles and labels reach past the shape, so cull on what is actually painted
+        QRectF canvasRect = view.mapRect(rectIt.value());
+        if (!regionPaintBounds(region, canvasRect, angleToUse, selectedRegions.contains(regionName),
+                               isPrimary).intersects(viewportRect)) {
+            continue;
+        }
+        
+        drawRegion(painter, region, rectIt.value(), view,
+                   hoveredRegion == regionName, selectedRegions.contains(regionName), isPrimary,
+                   isRotateMode, isRotatingThis || (region.rotationAngle != 0.0), angleToUse);
+    }
+}
+
+QRectF CanvasRenderer::regionPaintBounds(const RegionData& region,
+                                         const QRectF& canvasRect,
+                                         double rotationAngle,
+                                         bool isSelected,
+                                         bool withHandles) const {
+    // Shape plus handles (the rotate icon is the largest: 24px centred on a corner)
+    const double handleReach = withHandles ? std::max(12.0, RegionConstants::HANDLE_SIZE / 2.0) : 0.0;
+    QRectF bounds = canvasRect.adjusted(-handleReach, -handleReach, handleReach, handleReach);
+    if (rotationAngle != 0.0) {
+        QPointF center = canvasRect.center();
+        QTransform rotation;
+        rotation.translate(center.x(), center.y());
+        rotation.rotate(rotationAngle);
+        rotation.translate(-center.x(), -center.y());
+        bounds = rotation.mapRect(bounds);
+    }
+    
+    // Label: drawn unrotated from the top-centre, baseline 5px above the region
+    QFontMetricsF metrics(labelFont(isSelected));
+    QRectF labelRect(canvasRect.center().x(),
+                     canvasRect.top() - 5 - metrics.ascent(),
+                     metrics.horizontalAdvance(region.name),
+                     metrics.height());
+    
+    // Pens (up to 4px) and antialiasing spill past the geometry
+    const double margin = CanvasConstants::OVERLAY_MARGIN;
+    return bounds.united(labelRect).adjusted(-margin, -margin, margin, margin);
+}
+
+QFont CanvasRenderer::labelFont(bool isSelected) {
+    QFont font("Arial", isSelected ? 10 : 8);
+    font.setBold(isSelected);
+    return font;
+}
+
 void CanvasRenderer::drawRegion(QPainter& painter,
                                 const RegionData& region,
-                                const QRectF& canvasRect,
+                                const QRectF& imageRect,
+                                const QTransform& view,
                                 bool isHovered,
                                 bool isSelected,
                                 bool isPrimary,
@@ -111,6 +261,7 @@ void CanvasRenderer::drawRegion(QPainter& painter,
     cachedPen.setColor(regionColor);
     cachedPen.setWidth(penWidth);
     cachedPen.setJoinStyle(Qt::MiterJoin);
+    cachedPen.setCosmetic(true); // Width in screen pixels regardless of zoom
     painter.setPen(cachedPen);
     
     // Set brush (with opacity if needed)
@@ -127,11 +278,14 @@ void CanvasRenderer::drawRegion(QPainter& painter,
     // CRITICAL: Must save/restore to prevent rotation from affecting other regions
     painter.save();
     
+    // Draw the shape in image space under the view transform
+    painter.setTransform(view, true);
+    
     // Apply rotation transformation if region has rotation (stored or active)
     // Use active rotation angle during drag, or stored rotation angle otherwise
     double angleToApply = isRotating ? rotationAngle : region.rotationAngle;
     if (angleToApply != 0.0) {
-        QPointF center = canvasRect.center();
+        QPointF center = imageRect.center();
         painter.translate(center);
         painter.rotate(angleToApply);
         painter.translate(-center);
@@ -139,23 +293,26 @@ void CanvasRenderer::drawRegion(QPainter& painter,
     
     // Draw shape based on region shape type
     if (region.shapeType == "circle" || region.shapeType == "ellipse") {
-        painter.drawEllipse(canvasRect);
+        painter.drawEllipse(imageRect);
     } else if (region.shapeType == "triangle") {
         // Draw triangle: top center, bottom left, bottom right
-        QPointF top(canvasRect.center().x(), canvasRect.top());
-        QPointF bottomLeft(canvasRect.left(), canvasRect.bottom());
-        QPointF bottomRight(canvasRect.right(), canvasRect.bottom());
+        QPointF top(imageRect.center().x(), imageRect.top());
+        QPointF bottomLeft(imageRect.left(), imageRect.bottom());
+        QPointF bottomRight(imageRect.right(), imageRect.bottom());
         QPolygonF triangle;
         triangle << top << bottomLeft << bottomRight;
         painter.drawPolygon(triangle);
     } else {
         // Default: rectangle
-        painter.drawRect(canvasRect);
+        painter.drawRect(imageRect);
     }
     
-    // Restore painter state after drawing shape (removes rotation transformation)
+    // Restore painter state after drawing shape (removes view and rotation transformation)
     painter.restore();
     
+    // Labels and handles keep a fixed on-screen size, so place them in canvas space
+    QRectF canvasRect = view.mapRect(imageRect);
+    
     // Draw label (outside rotation transformation)
     drawRegionLabel(painter, region.name, canvasRect, regionColor, isSelected);
     
@@ -257,9 +414,7 @@ void CanvasRenderer::drawRegionLabel(QPainter& painter,
     painter.save();
     
     // Set font
-    QFont font("Arial", isSelected ? 10 : 8);
-    font.setBold(isSelected);
-    painter.setFont(font);
+    painter.setFont(labelFont(isSelected));
     
     // Set pen color to match region color
     painter.setPen(QPen(color));
@@ -351,6 +506,52 @@ void CanvasRenderer::drawSelectionBox(QPainter& painter, const QRectF& rect) {
     painter.restore();
 }
 
+void CanvasRenderer::drawDetectionLayers(QPainter& painter,
+                                         const QList<PartialDetectionLayer>& layers,
+                                         const QImage& documentImage,
+                                         double scaleFactor,
+                                         const QPointF& imageOffset,
+                                         const QRectF& dirtyRect) {
+    if (layers.isEmpty() || documentImage.isNull()) {
+        return;
+    }
+    
+    painter.save();
+    painter.setBrush(Qt::NoBrush);
+    
+    for (const PartialDetectionLayer& layer : layers) {
+        painter.setPen(detectionLayerPen(layer.kind));
+        
+        for (const DetectedRegion& region : layer.regions) {
+            CanvasCoords canvasCoords = CoordinateSystem::normalizedToCanvas(
+                region.coords, documentImage.width(), documentImage.height(), scaleFactor, imageOffset);
+            QRectF rect(QPointF(canvasCoords.x1, canvasCoords.y1), QPointF(canvasCoords.x2, canvasCoords.y2));
+            if (rect.intersects(dirtyRect)) {
+                painter.drawRect(rect);
+            }
+        }
+    }
+    
+    painter.restore();
+}
+
+QPen CanvasRenderer::detectionLayerPen(PartialDetectionLayer::Kind kind) {
+    QPen pen;
+    switch (kind) {
+        case PartialDetectionLayer::OCR_WORDS:
+            pen = QPen(QColor(0x60, 0x60, 0x60, 140), 1);
+            break;
+        case PartialDetectionLayer::RECTANGLE_CANDIDATES:
+            pen = QPen(QColor(0xff, 0x98, 0x00, 200), 1.5);
+            pen.setStyle(Qt::DashLine);
+            break;
+        case PartialDetectionLayer::CONSENSUS_REGIONS:
+            pen = QPen(QColor(0x4c, 0xaf, 0x50, 230), 2);
+            break;
+    }
+    return pen;
+}
+
 QColor CanvasRenderer::getRegionColor(const QString& colorName) const {
     // Color map matching UI specification
     static QMap<QString, QColor> colorMap = {
@@ -7,8 +7,11 @@
 #include <QtCore/QString>
 #include <QtCore/QSet>
 #include <QtGui/QImage>
+#include <QtGui/QFont>
+#include <QtGui/QTransform>
 #include "../../../../models/DocumentState.h"
 #include "../coordinate/CanvasCoordinateCache.h"
+#include "../../../../utils/DetectionProgressChannel.h"
 
 namespace ocr_orc {
 
@@ -38,7 +41,7 @@ public:
      * @brief Render all regions
      * @param painter QPainter to use
      * @param documentState Document state containing regions
-     * @param coordinateCache Coordinate cache for region coordinates
+     * @param coordinateCache Image-space region geometry cache
      * @param documentImage Document image (for dimensions)
      * @param scaleFactor Current scale factor
      * @param imageOffset Current image offset
@@ -61,18 +64,87 @@ public:
                        const QString& rotatingRegion = QString(),
                        double rotationAngle = 0.0);
     
+    /**
+     * @brief Render the regions that belong in the retained static layer
+     *
+     * Every region is drawn in its plain (unhovered, unselected) style except
+     * those in excludedRegions, which the overlay draws instead.
+     * @param painter QPainter to use (typically the layer pixmap's)
+     * @param documentState Document state containing regions
+     * @param coordinateCache Image-space region geometry cache
+     * @param documentImage Document image (for dimensions)
+     * @param scaleFactor Current scale factor
+     * @param imageOffset Image offset within the painter's device
+     * @param viewportRect Painter device rectangle for culling
+     * @param excludedRegions Regions to skip (selected, resizing, rotating)
+     */
+    void renderStaticRegions(QPainter& painter,
+                             DocumentState* documentState,
+                             CanvasCoordinateCache* coordinateCache,
+                             const QImage& documentImage,
+                             double scaleFactor,
+                             const QPointF& imageOffset,
+                             const QRectF& viewportRect,
+                             const QSet<QString>& excludedRegions);
+    
+    /**
+     * @brief Render the interactive overlay on top of the static layer
+     * @param painter QPainter to use
+     * @param documentState Document state containing regions
+     * @param coordinateCache Image-space region geometry cache
+     * @param documentImage Document image (for dimensions)
+     * @param scaleFactor Current scale factor
+     * @param imageOffset Current image offset
+     * @param viewportRect Exposed rectangle for culling
+     * @param overlayRegions Regions to draw (hovered, selected, resizing, rotating)
+     * @param hoveredRegion Currently hovered region name
+     * @param selectedRegions Set of selected region names
+     * @param primarySelectedRegion Primary selected region (for resize handles)
+     */
+    void renderOverlayRegions(QPainter& painter,
+                              DocumentState* documentState,
+                              CanvasCoordinateCache* coordinateCache,
+                              const QImage& documentImage,
+                              double scaleFactor,
+                              const QPointF& imageOffset,
+                              const QRectF& viewportRect,
+                              const QSet<QString>& overlayRegions,
+                              const QString& hoveredRegion,
+                              const QSet<QString>& selectedRegions,
+                              const QString& primarySelectedRegion,
+                              bool isRotateMode = false,
+                              const QString& rotatingRegion = QString(),
+                              double rotationAngle = 0.0);
+    
+    /**
+     * @brief Canvas area touched when drawing a region (for dirty-rect updates)
+     * @param region Region data
+     * @param canvasRect Canvas rectangle for the region
+     * @param rotationAngle Rotation angle in degrees
+     * @param isSelected Whether the label is drawn in the selected style
+     * @param withHandles Whether resize handles or the rotate icon are drawn
+     * @return Bounding rectangle covering shape, pen, label and handles
+     */
+    QRectF regionPaintBounds(const RegionData& region,
+                             const QRectF& canvasRect,
+                             double rotationAngle,
+                             bool isSelected,
+                             bool withHandles) const;
+    
     /**
      * @brief Draw a single region
      * @param painter QPainter to use
      * @param region Region data
-     * @param canvasRect Canvas coordinates for the region
+     * @param imageRect Image coordinates for the region
+     * @param view Image -> canvas view transform
      * @param isHovered Whether region is hovered
      * @param isSelected Whether region is selected
      * @param isPrimary Whether region is primary selected (for resize handles)
      */
     void drawRegion(QPainter& painter,
                     const RegionData& region,
-                    const QRectF& canvasRect,
+                    const QRectF& imageRect,
+                    const QTransform& view,
                     bool isHovered,
                     bool isSelected,
                     bool isPrimary = false,
@@ -125,6 +197,30 @@ public:
      */
     void drawSelectionBox(QPainter& painter, const QRectF& rect);
     
+    /**
+     * @brief Draw partial results of a running detection as outlines
+     * Later layers are drawn over earlier ones: OCR words in gray, rectangle
+     * candidates dashed orange, consensus regions green.
+     * @param painter QPainter to use
+     * @param layers Layers published so far
+     * @param documentImage Document image (for normalized-to-canvas conversion)
+     * @param scaleFactor Current scale factor
+     * @param imageOffset Current image offset
+     * @param dirtyRect Exposed area; boxes outside it are skipped
+     */
+    void drawDetectionLayers(QPainter& painter,
+                             const QList<PartialDetectionLayer>& layers,
+                             const QImage& documentImage,
+                             double scaleFactor,
+                             const QPointF& imageOffset,
+                             const QRectF& dirtyRect);
+    
+    /**
+     * @brief Outline pen for a partial detection layer
+     * Shared with the detection preview dialog so both draw the layers alike.
+     */
+    static QPen detectionLayerPen(PartialDetectionLayer::Kind kind);
+    
     /**
      * @brief Get QColor from color name string
      * @param colorName Color name (e.g., "blue", "red")
@@ -133,6 +229,24 @@ public:
     QColor getRegionColor(const QString& colorName) const;
 
 private:
+    /**
+     * @brief Refresh the region cache and compute the view for a render pass
+     * @return false if there is nothing to draw
+     */
+    bool prepareView(DocumentState* documentState,
+                     CanvasCoordinateCache* coordinateCache,
+                     const QImage& documentImage,
+                     double scaleFactor,
+                     const QPointF& imageOffset,
+                     const QRectF& viewportRect,
+                     QTransform& view,
+                     QRectF& imageViewport) const;
+    
+    /**
+     * @brief Font used for region labels
+     */
+    static QFont labelFont(bool isSelected);
+    
     static constexpr double SHADOW_OFFSET = 5.0;
     static constexpr int SHADOW_ALPHA = 100;
 };
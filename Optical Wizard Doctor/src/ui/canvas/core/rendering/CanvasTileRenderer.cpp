@@ -0,0 +1,93 @@
+#include "CanvasTileRenderer.h"
+#include "../../../../utils/PdfLoader.h"
+#include "../../../../utils/TraceRecorder.h"
+#include "../../../../core/Constants.h"
+#include <QtCore/QMetaObject>
+#include <algorithm>
+#include <cstdio>
+
+namespace ocr_orc {
+
+CanvasTileRenderer::CanvasTileRenderer(QObject* parent)
+    : QObject(parent)
+    , currentId(0)
+{
+    pool.setMaxThreadCount(1);
+}
+
+CanvasTileRenderer::~CanvasTileRenderer() {
+    // Drop queued requests and wait for the one in flight; its queued signal dies with this object
+    cancel();
+    pool.clear();
+    pool.waitForDone();
+}
+
+bool CanvasTileRenderer::computeTileRequest(const QSize& imageSize, double scaleFactor, const QPointF& imageOffset,
+                                            const QSize& widgetSize, qreal devicePixelRatio,
+                                            QRectF& normalizedRect, double& dpi) {
+    if (imageSize.isEmpty() || widgetSize.isEmpty() || scaleFactor <= 0.0) {
+        return false;
+    }
+    
+    // Device pixels per page-raster pixel; at or near 1 the raster is already sharp
+    const double magnification = scaleFactor * devicePixelRatio;
+    if (magnification < CanvasConstants::DETAIL_TILE_MIN_MAGNIFICATION) {
+        return false;
+    }
+    
+    // Viewport in page-raster pixels, clipped to the page
+    QRectF visible(-imageOffset / scaleFactor, QSizeF(widgetSize) / scaleFactor);
+    visible = visible.intersected(QRectF(QPointF(0.0, 0.0), QSizeF(imageSize)));
+    if (visible.isEmpty()) {
+        return false;
+    }
+    
+    normalizedRect = QRectF(visible.x() / imageSize.width(), visible.y() / imageSize.height(),
+                            visible.width() / imageSize.width(), visible.height() / imageSize.height());
+    dpi = std::min(PdfConstants::DEFAULT_DPI * magnification, static_cast<double>(PdfConstants::MAX_TILE_DPI));
+    return true;
+}
+
+int CanvasTileRenderer::requestTile(const QString& pdfPath, const QRectF& normalizedRect, double dpi) {
+    const int requestId = currentId.fetch_add(1) + 1;
+    
+    // Anything still queued is for a view the user has left
+    pool.clear();
+    
+    pool.start([this, requestId, pdfPath, normalizedRect, dpi]() {
+        static thread_local bool named = false;
+        if (!named) {
+            TraceRecorder::instance().setCurrentThreadName("CanvasTileRenderer");
+            named = true;
+        }
+    
+        if (!isCurrent(requestId)) return;
+    
+        QRectF renderedRect;
+        QImage tile;
+        {
+            TraceSpan span("PDF viewport tile render", "pdf");
+            span.setArg("dpi", static_cast<int>(dpi));
+            tile = PdfLoader::renderFirstPageRegion(pdfPath, normalizedRect, dpi, &renderedRect);
+        }
+        if (tile.isNull()) {
+            fprintf(stderr, "[CanvasTileRenderer] Tile %d failed at %.0f DPI\n", requestId, dpi);
+            fflush(stderr);
+            return;
+        }
+    
+        QMetaObject::invokeMethod(this, [this, requestId, tile, renderedRect, dpi]() {
+            if (isCurrent(requestId)) {
+                emit tileReady(requestId, tile, renderedRect, dpi);
+            }
+        }, Qt::QueuedConnection);
+    });
+    
+    return requestId;
+}
+
+void CanvasTileRenderer::cancel() {
+    currentId.fetch_add(1);
+}
+
+} // namespace ocr_orc
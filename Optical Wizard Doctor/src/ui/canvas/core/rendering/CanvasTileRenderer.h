@@ -0,0 +1,82 @@
+#ifndef CANVAS_TILE_RENDERER_H
+#define CANVAS_TILE_RENDERER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtCore/QSize>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
+#include <atomic>
+
+namespace ocr_orc {
+
+/**
+ * @brief Re-renders the visible part of the page from the PDF when zoomed in
+ *
+ * The canvas page raster is rendered once at PdfConstants::DEFAULT_DPI, so
+ * zooming past 100% only magnifies its pixels. This renderer asks Poppler
+ * for just the visible crop at the resolution the screen actually shows,
+ * and the canvas draws that tile over the magnified raster once it arrives.
+ * Memory follows the viewport, not the page.
+ *
+ * Requests run one at a time on a private thread pool; a new request
+ * supersedes the previous one and superseded tiles are never emitted.
+ */
+class CanvasTileRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit CanvasTileRenderer(QObject* parent = nullptr);
+    ~CanvasTileRenderer();
+
+    /**
+     * @brief Work out which part of the page a tile should cover for a view
+     * @param imageSize Page raster size (pixels at PdfConstants::DEFAULT_DPI)
+     * @param scaleFactor Canvas scale factor
+     * @param imageOffset Canvas image offset
+     * @param widgetSize Canvas widget size
+     * @param devicePixelRatio Canvas device pixel ratio
+     * @param normalizedRect Receives the visible part of the page, scaled to 0..1
+     * @param dpi Receives the resolution the visible part is shown at (capped at MAX_TILE_DPI)
+     * @return false if no tile is needed (page raster not magnified enough, or page not visible)
+     */
+    static bool computeTileRequest(const QSize& imageSize, double scaleFactor, const QPointF& imageOffset,
+                                   const QSize& widgetSize, qreal devicePixelRatio,
+                                   QRectF& normalizedRect, double& dpi);
+
+    /**
+     * @brief Start rendering a tile (supersedes any previous request)
+     * @param pdfPath PDF the page raster was rendered from
+     * @param normalizedRect Part of the page to render, scaled to 0..1
+     * @param dpi Resolution to render at
+     * @return Id of this request (passed back in tileReady())
+     */
+    int requestTile(const QString& pdfPath, const QRectF& normalizedRect, double dpi);
+
+    /**
+     * @brief Abandon the current request (its tile is never emitted)
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief Emitted when a tile has been rendered
+     * @param requestId Id returned by requestTile()
+     * @param tile Rendered crop
+     * @param normalizedRect Part of the page the tile covers (snapped to its pixels)
+     * @param dpi Resolution the tile was rendered at
+     */
+    void tileReady(int requestId, const QImage& tile, const QRectF& normalizedRect, double dpi);
+
+private:
+    bool isCurrent(int requestId) const { return currentId.load() == requestId; }
+
+    QThreadPool pool;            // Single thread: only the newest tile matters
+    std::atomic<int> currentId;  // Bumped by requestTile()/cancel() to invalidate older requests
+};
+
+} // namespace ocr_orc
+
+#endif // CANVAS_TILE_RENDERER_H
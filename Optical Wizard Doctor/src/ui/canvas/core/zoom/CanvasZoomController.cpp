@@ -100,10 +100,10 @@ void CanvasZoomController::calculateLayout(const QImage& documentImage,
     }
     
     // Update DocumentState if available
+    // (view only: regions are drawn through the view transform, so no per-region resync)
     if (documentState) {
         documentState->scaleFactor = scaleFactor;
         documentState->imageOffset = imageOffset;
-        documentState->synchronizeCoordinates();
     }
     
     // Calculate image rectangle
@@ -119,8 +119,7 @@ void CanvasZoomController::zoomIn(DocumentState* documentState,
                                   const QImage& documentImage,
                                   int canvasWidth, int canvasHeight,
                                   double& scaleFactor,
-                                  QPointF& imageOffset,
-                                  CanvasCoordinateCache* coordinateCache) {
+                                  QPointF& imageOffset) {
     if (!documentState) return;
     
     // Get center of canvas for zoom
@@ -128,15 +127,14 @@ void CanvasZoomController::zoomIn(DocumentState* documentState,
     double currentZoom = documentState->zoomLevel;
     double newZoom = currentZoom * CanvasConstants::ZOOM_FACTOR; // 20% increase
     setZoomAtPoint(newZoom, centerPos, documentState, documentImage,
-                   canvasWidth, canvasHeight, scaleFactor, imageOffset, coordinateCache);
+                   canvasWidth, canvasHeight, scaleFactor, imageOffset);
 }
 
 void CanvasZoomController::zoomOut(DocumentState* documentState,
                                    const QImage& documentImage,
                                    int canvasWidth, int canvasHeight,
                                    double& scaleFactor,
-                                   QPointF& imageOffset,
-                                   CanvasCoordinateCache* coordinateCache) {
+                                   QPointF& imageOffset) {
     if (!documentState) return;
     
     // Get center of canvas for zoom
@@ -144,21 +142,20 @@ void CanvasZoomController::zoomOut(DocumentState* documentState,
     double currentZoom = documentState->zoomLevel;
     double newZoom = currentZoom / CanvasConstants::ZOOM_FACTOR; // 20% decrease
     setZoomAtPoint(newZoom, centerPos, documentState, documentImage,
-                   canvasWidth, canvasHeight, scaleFactor, imageOffset, coordinateCache);
+                   canvasWidth, canvasHeight, scaleFactor, imageOffset);
 }
 
 void CanvasZoomController::zoomReset(DocumentState* documentState,
                                      const QImage& documentImage,
                                      int canvasWidth, int canvasHeight,
                                      double& scaleFactor,
-                                     QPointF& imageOffset,
-                                     CanvasCoordinateCache* coordinateCache) {
+                                     QPointF& imageOffset) {
     if (!documentState) return;
     
     // Reset zoom to center
     QPointF centerPos(canvasWidth / 2.0, canvasHeight / 2.0);
     setZoomAtPoint(1.0, centerPos, documentState, documentImage,
-                   canvasWidth, canvasHeight, scaleFactor, imageOffset, coordinateCache);
+                   canvasWidth, canvasHeight, scaleFactor, imageOffset);
 }
 
 void CanvasZoomController::setZoom(double zoomLevel,
@@ -166,8 +163,7 @@ void CanvasZoomController::setZoom(double zoomLevel,
                                   const QImage& documentImage,
                                   int canvasWidth, int canvasHeight,
                                   double& scaleFactor,
-                                  QPointF& imageOffset,
-                                  CanvasCoordinateCache* coordinateCache) {
+                                  QPointF& imageOffset) {
     if (!documentState) return;
     
     // Validate zoom level (check for NaN/Infinity)
@@ -192,11 +188,6 @@ void CanvasZoomController::setZoom(double zoomLevel,
     QRectF imageRect;
     calculateLayout(documentImage, canvasWidth, canvasHeight, documentState,
                    scaleFactor, imageOffset, imageRect);
-    
-    // Invalidate coordinate cache AFTER layout is recalculated
-    if (coordinateCache) {
-        coordinateCache->invalidate();
-    }
 }
 
 void CanvasZoomController::setZoomAtPoint(double zoomLevel,
@@ -205,8 +196,7 @@ void CanvasZoomController::setZoomAtPoint(double zoomLevel,
                                         const QImage& documentImage,
                                         int canvasWidth, int canvasHeight,
                                         double& scaleFactor,
-                                        QPointF& imageOffset,
-                                        CanvasCoordinateCache* coordinateCache) {
+                                        QPointF& imageOffset) {
     if (!documentState || documentImage.isNull()) return;
     
     // Validate zoom level (check for NaN/Infinity)
@@ -262,16 +252,10 @@ void CanvasZoomController::setZoomAtPoint(double zoomLevel,
     // Update DocumentState
     documentState->imageOffset = imageOffset;
     documentState->scaleFactor = newScaleFactor;
-    documentState->synchronizeCoordinates();
     
     // Recalculate layout again with new offset
     calculateLayout(documentImage, canvasWidth, canvasHeight, documentState,
                    scaleFactor, imageOffset, imageRect);
-    
-    // Invalidate coordinate cache AFTER layout is recalculated
-    if (coordinateCache) {
-        coordinateCache->invalidate();
-    }
 }
 
 double CanvasZoomController::getZoom(DocumentState* documentState) const {
@@ -288,7 +272,6 @@ void CanvasZoomController::panWithWheel(const QPointF& delta,
     // Update DocumentState
     if (documentState) {
         documentState->imageOffset = imageOffset;
-        documentState->synchronizeCoordinates();
     }
 }
 
@@ -5,7 +5,6 @@
 #include <QtCore/QRectF>
 #include <QtGui/QImage>
 #include "../../../../models/DocumentState.h"
-#include "../coordinate/CanvasCoordinateCache.h"
 
 namespace ocr_orc {
 
@@ -48,14 +47,12 @@ public:
      * @param canvasHeight Canvas height
      * @param scaleFactor Output: updated scale factor
      * @param imageOffset Output: updated image offset
-     * @param coordinateCache Cache to invalidate
      */
     void zoomIn(DocumentState* documentState,
                 const QImage& documentImage,
                 int canvasWidth, int canvasHeight,
                 double& scaleFactor,
-                QPointF& imageOffset,
-                CanvasCoordinateCache* coordinateCache);
+                QPointF& imageOffset);
     
     /**
      * @brief Zoom out (decrease zoom by factor) at center
@@ -65,14 +62,12 @@ public:
      * @param canvasHeight Canvas height
      * @param scaleFactor Output: updated scale factor
      * @param imageOffset Output: updated image offset
-     * @param coordinateCache Cache to invalidate
      */
     void zoomOut(DocumentState* documentState,
                  const QImage& documentImage,
                  int canvasWidth, int canvasHeight,
                  double& scaleFactor,
-                 QPointF& imageOffset,
-                 CanvasCoordinateCache* coordinateCache);
+                 QPointF& imageOffset);
     
     /**
      * @brief Reset zoom to 1.0 at center
@@ -82,14 +77,12 @@ public:
      * @param canvasHeight Canvas height
      * @param scaleFactor Output: updated scale factor
      * @param imageOffset Output: updated image offset
-     * @param coordinateCache Cache to invalidate
      */
     void zoomReset(DocumentState* documentState,
                    const QImage& documentImage,
                    int canvasWidth, int canvasHeight,
                    double& scaleFactor,
-                   QPointF& imageOffset,
-                   CanvasCoordinateCache* coordinateCache);
+                   QPointF& imageOffset);
     
     /**
      * @brief Set zoom level
@@ -100,15 +93,13 @@ public:
      * @param canvasHeight Canvas height
      * @param scaleFactor Output: updated scale factor
      * @param imageOffset Output: updated image offset
-     * @param coordinateCache Cache to invalidate
      */
     void setZoom(double zoomLevel,
                  DocumentState* documentState,
                  const QImage& documentImage,
                  int canvasWidth, int canvasHeight,
                  double& scaleFactor,
-                 QPointF& imageOffset,
-                 CanvasCoordinateCache* coordinateCache);
+                 QPointF& imageOffset);
     
     /**
      * @brief Set zoom level centered on a point
@@ -120,7 +111,6 @@ public:
      * @param canvasHeight Canvas height
      * @param scaleFactor Output: updated scale factor
      * @param imageOffset Output: updated image offset
-     * @param coordinateCache Cache to invalidate
      */
     void setZoomAtPoint(double zoomLevel,
                        const QPointF& widgetPos,
@@ -128,8 +118,7 @@ public:
                        const QImage& documentImage,
                        int canvasWidth, int canvasHeight,
                        double& scaleFactor,
-                       QPointF& imageOffset,
-                       CanvasCoordinateCache* coordinateCache);
+                       QPointF& imageOffset);
     
     /**
      * @brief Get current zoom level
@@ -168,9 +168,9 @@ void CanvasMouseHandler::handleMove(QMouseEvent* event,
                 std::abs(newOffset.x()) < 100000.0 && std::abs(newOffset.y()) < 100000.0) {
                 imageOffsetRef = newOffset;
                 
+                // Pan only moves the view transform; handleRelease() resyncs region coordinates once the pan ends
                 if (documentState) {
                     documentState->imageOffset = imageOffsetRef;
-                    documentState->synchronizeCoordinates();
                 }
                 
                 calculateLayout();
@@ -1,6 +1,5 @@
 #include "CanvasZoomManager.h"
 #include "../core/zoom/CanvasZoomController.h"
-#include "../core/coordinate/CanvasCoordinateCache.h"
 #include <QtGui/QImage>
 
 namespace ocr_orc {
@@ -16,11 +15,10 @@ void CanvasZoomManager::zoomIn(DocumentState* documentState,
                                int canvasWidth, int canvasHeight,
                                double& scaleFactor,
                                QPointF& imageOffset,
-                               CanvasZoomController* zoomController,
-                               CanvasCoordinateCache* coordinateCache) {
+                               CanvasZoomController* zoomController) {
     if (!documentState || !zoomController) return;
     zoomController->zoomIn(documentState, documentImage, canvasWidth, canvasHeight,
-                          scaleFactor, imageOffset, coordinateCache);
+                          scaleFactor, imageOffset);
 }
 
 void CanvasZoomManager::zoomOut(DocumentState* documentState,
@@ -28,11 +26,10 @@ void CanvasZoomManager::zoomOut(DocumentState* documentState,
                                 int canvasWidth, int canvasHeight,
                                 double& scaleFactor,
                                 QPointF& imageOffset,
-                                CanvasZoomController* zoomController,
-                                CanvasCoordinateCache* coordinateCache) {
+                                CanvasZoomController* zoomController) {
     if (!documentState || !zoomController) return;
     zoomController->zoomOut(documentState, documentImage, canvasWidth, canvasHeight,
-                           scaleFactor, imageOffset, coordinateCache);
+                           scaleFactor, imageOffset);
 }
 
 void CanvasZoomManager::zoomReset(DocumentState* documentState,
@@ -40,11 +37,10 @@ void CanvasZoomManager::zoomReset(DocumentState* documentState,
                                   int canvasWidth, int canvasHeight,
                                   double& scaleFactor,
                                   QPointF& imageOffset,
-                                  CanvasZoomController* zoomController,
-                                  CanvasCoordinateCache* coordinateCache) {
+                                  CanvasZoomController* zoomController) {
     if (!documentState || !zoomController) return;
     zoomController->zoomReset(documentState, documentImage, canvasWidth, canvasHeight,
-                             scaleFactor, imageOffset, coordinateCache);
+                             scaleFactor, imageOffset);
 }
 
 void CanvasZoomManager::setZoom(double zoomLevel,
@@ -53,11 +49,10 @@ void CanvasZoomManager::setZoom(double zoomLevel,
                                 int canvasWidth, int canvasHeight,
                                 double& scaleFactor,
                                 QPointF& imageOffset,
-                                CanvasZoomController* zoomController,
-                                CanvasCoordinateCache* coordinateCache) {
+                                CanvasZoomController* zoomController) {
     if (!documentState || !zoomController) return;
     zoomController->setZoom(zoomLevel, documentState, documentImage,
-                           canvasWidth, canvasHeight, scaleFactor, imageOffset, coordinateCache);
+                           canvasWidth, canvasHeight, scaleFactor, imageOffset);
 }
 
 void CanvasZoomManager::setZoomAtPoint(double zoomLevel,
@@ -67,11 +62,10 @@ void CanvasZoomManager::setZoomAtPoint(double zoomLevel,
                                        int canvasWidth, int canvasHeight,
                                        double& scaleFactor,
                                        QPointF& imageOffset,
-                                       CanvasZoomController* zoomController,
-                                       CanvasCoordinateCache* coordinateCache) {
+                                       CanvasZoomController* zoomController) {
     if (!documentState || documentImage.isNull() || !zoomController) return;
     zoomController->setZoomAtPoint(zoomLevel, widgetPos, documentState, documentImage,
-                                  canvasWidth, canvasHeight, scaleFactor, imageOffset, coordinateCache);
+                                  canvasWidth, canvasHeight, scaleFactor, imageOffset);
 }
 
 double CanvasZoomManager::getZoom(DocumentState* documentState,
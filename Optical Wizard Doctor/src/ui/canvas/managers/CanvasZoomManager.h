@@ -8,7 +8,6 @@
 namespace ocr_orc {
 
 class CanvasZoomController;
-class CanvasCoordinateCache;
 
 /**
  * @brief Manages zoom operations for Canvas
@@ -23,24 +22,21 @@ public:
                 int canvasWidth, int canvasHeight,
                 double& scaleFactor,
                 QPointF& imageOffset,
-                CanvasZoomController* zoomController,
-                CanvasCoordinateCache* coordinateCache);
+                CanvasZoomController* zoomController);
     
     void zoomOut(DocumentState* documentState,
                  const QImage& documentImage,
                  int canvasWidth, int canvasHeight,
                  double& scaleFactor,
                  QPointF& imageOffset,
-                 CanvasZoomController* zoomController,
-                 CanvasCoordinateCache* coordinateCache);
+                 CanvasZoomController* zoomController);
     
     void zoomReset(DocumentState* documentState,
                    const QImage& documentImage,
                    int canvasWidth, int canvasHeight,
                    double& scaleFactor,
                    QPointF& imageOffset,
-                   CanvasZoomController* zoomController,
-                   CanvasCoordinateCache* coordinateCache);
+                   CanvasZoomController* zoomController);
     
     void setZoom(double zoomLevel,
                  DocumentState* documentState,
@@ -48,8 +44,7 @@ public:
                  int canvasWidth, int canvasHeight,
                  double& scaleFactor,
                  QPointF& imageOffset,
-                 CanvasZoomController* zoomController,
-                 CanvasCoordinateCache* coordinateCache);
+                 CanvasZoomController* zoomController);
     
     void setZoomAtPoint(double zoomLevel,
                        const QPointF& widgetPos,
@@ -58,8 +53,7 @@ public:
                        int canvasWidth, int canvasHeight,
                        double& scaleFactor,
                        QPointF& imageOffset,
-                       CanvasZoomController* zoomController,
-                       CanvasCoordinateCache* coordinateCache);
+                       CanvasZoomController* zoomController);
     
     double getZoom(DocumentState* documentState,
                    CanvasZoomController* zoomController) const;
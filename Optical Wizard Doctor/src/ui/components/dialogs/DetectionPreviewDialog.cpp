@@ -1,6 +1,7 @@
 #include "DetectionPreviewDialog.h"
 #include "../../../utils/RegionDetector.h"
 #include "../../../core/CoordinateSystem.h"
+#include "../../canvas/core/rendering/CanvasRenderer.h"
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QListWidget>
@@ -36,6 +37,8 @@ DetectionPreviewDialog::DetectionPreviewDialog(QWidget* parent,
     , groupsLabel(nullptr)
     , patternsLabel(nullptr)
     , groupsListWidget(nullptr)
+    , summaryLabel(nullptr)
+    , detecting(false)
 {
     setWindowTitle("Magic Detect - Review Detected Regions");
     setMinimumSize(900, 700);
@@ -50,6 +53,76 @@ DetectionPreviewDialog::DetectionPreviewDialog(QWidget* parent,
     updatePreview();
 }
 
+DetectionPreviewDialog::DetectionPreviewDialog(QWidget* parent, const QImage& sourceImage)
+    : DetectionPreviewDialog(parent, DetectionResult(), sourceImage)
+{
+    setWindowTitle("Magic Detect - Detecting...");
+    detecting = true;
+    setReviewEnabled(false);
+    updateSummary();
+    updatePreview();
+}
+
+void DetectionPreviewDialog::addPartialLayer(const PartialDetectionLayer& layer) {
+    if (!detecting) {
+        return;
+    }
+    for (int i = 0; i < partialLayers.size(); ++i) {
+        if (partialLayers[i].kind == layer.kind) {
+            partialLayers.removeAt(i);
+            break;
+        }
+    }
+    partialLayers.append(layer);
+    updateSummary();
+    updatePreview();
+}
+
+void DetectionPreviewDialog::setDetectionResult(const DetectionResult& result) {
+    detectionResult = result;
+    detecting = false;
+    partialLayers.clear();
+    acceptedIndices.clear();
+    setWindowTitle("Magic Detect - Review Detected Regions");
+    setReviewEnabled(true);
+    updateSummary();
+    updateRegionList();
+    updatePreview();
+}
+
+void DetectionPreviewDialog::setReviewEnabled(bool enabled) {
+    for (QWidget* control : reviewControls) {
+        control->setEnabled(enabled);
+    }
+    if (cancelButton) {
+        cancelButton->setText(enabled ? "Cancel" : "Abort Detection");
+    }
+}
+
+void DetectionPreviewDialog::updateSummary() {
+    if (!summaryLabel) return;
+    
+    if (detecting) {
+        if (partialLayers.isEmpty()) {
+            summaryLabel->setText("Detecting... waiting for OCR results");
+            return;
+        }
+        const PartialDetectionLayer& latest = partialLayers.last();
+        summaryLabel->setText(QString("Detecting... %1: %2 (%3 s)")
+                                  .arg(PartialDetectionLayer::kindName(latest.kind))
+                                  .arg(latest.regions.size())
+                                  .arg(latest.elapsedMs / 1000.0, 0, 'f', 1));
+        return;
+    }
+    
+    summaryLabel->setText(
+        QString("Total: %1 regions | High: %2 | Medium: %3 | Low: %4")
+            .arg(detectionResult.totalDetected)
+            .arg(detectionResult.highConfidence)
+            .arg(detectionResult.mediumConfidence)
+            .arg(detectionResult.lowConfidence));
+}
+
 void DetectionPreviewDialog::setupUI() {
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
     mainLayout->setSpacing(10);
@@ -177,17 +250,14 @@ void DetectionPreviewDialog::setupUI() {
     batchLayout->addWidget(cancelButton);
     mainLayout->addLayout(batchLayout);
     
+    reviewControls = {confidenceFilterSlider, regionListWidget, acceptRegionButton, rejectRegionButton,
+                      acceptAllButton, rejectAllButton, acceptFilteredButton, acceptButton};
+    
     // Summary label
-    QLabel* summaryLabel = new QLabel(
-        QString("Total: %1 regions | High: %2 | Medium: %3 | Low: %4")
-            .arg(detectionResult.totalDetected)
-            .arg(detectionResult.highConfidence)
-            .arg(detectionResult.mediumConfidence)
-            .arg(detectionResult.lowConfidence),
-        this
-    );
+    summaryLabel = new QLabel(this);
     summaryLabel->setStyleSheet("font-weight: bold; padding: 5px;");
     mainLayout->addWidget(summaryLabel);
+    updateSummary();
 }
 
 void DetectionPreviewDialog::updatePreview() {
@@ -214,6 +284,19 @@ void DetectionPreviewDialog::updatePreview() {
     double scaleX = (double)pixmap.width() / sourceImage.width();
     double scaleY = (double)pixmap.height() / sourceImage.height();
     
+    // While detecting: outlines of the partial layers, later layers on top
+    for (const PartialDetectionLayer& layer : partialLayers) {
+        painter.setPen(CanvasRenderer::detectionLayerPen(layer.kind));
+        painter.setBrush(Qt::NoBrush);
+        for (const DetectedRegion& region : layer.regions) {
+            int x1 = (int)(region.coords.x1 * pixmap.width());
+            int y1 = (int)(region.coords.y1 * pixmap.height());
+            int x2 = (int)(region.coords.x2 * pixmap.width());
+            int y2 = (int)(region.coords.y2 * pixmap.height());
+            painter.drawRect(x1, y1, x2 - x1, y2 - y1);
+        }
+    }
+    
     // Draw each detected region
     for (int i = 0; i < detectionResult.regions.size(); ++i) {
         const DetectedRegion& region = detectionResult.regions[i];
@@ -434,6 +517,14 @@ void DetectionPreviewDialog::onCancelButtonClicked() {
     reject();
 }
 
+void DetectionPreviewDialog::reject() {
+    if (detecting) {
+        detecting = false;
+        emit abortRequested();
+    }
+    QDialog::reject();
+}
+
 QList<DetectedRegion> DetectionPreviewDialog::getAcceptedRegions() const {
     QList<DetectedRegion> accepted;
     for (int index : acceptedIndices) {
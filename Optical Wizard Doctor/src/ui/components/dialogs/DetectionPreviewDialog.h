@@ -12,6 +12,7 @@
 #include <QtCore/QSet>
 #include <QtGui/QImage>
 #include "../../../utils/RegionDetector.h"
+#include "../../../utils/DetectionProgressChannel.h"
 
 namespace ocr_orc {
 
@@ -23,6 +24,11 @@ namespace ocr_orc {
  * - Accept/reject all regions
  * - Filter by confidence level
  * - See region details (confidence, method)
+ *
+ * The dialog can also be opened when detection starts: it then shows the
+ * partial layers (OCR words, rectangle candidates, consensus regions) as
+ * they arrive, and Cancel aborts the run. Review controls are enabled once
+ * setDetectionResult() delivers the final result.
  */
 class DetectionPreviewDialog : public QDialog {
     Q_OBJECT
@@ -37,8 +43,32 @@ public:
     explicit DetectionPreviewDialog(QWidget* parent, 
                                     const DetectionResult& result, 
                                     const QImage& sourceImage);
+    
+    /**
+     * @brief Constructor for a detection that is still running
+     * @param parent Parent widget
+     * @param sourceImage Original image for preview
+     */
+    DetectionPreviewDialog(QWidget* parent, const QImage& sourceImage);
     ~DetectionPreviewDialog() = default;
     
+    /**
+     * @brief Show a partial result of the running detection
+     * @param layer Layer published by the detector (replaces an older layer of the same kind)
+     */
+    void addPartialLayer(const PartialDetectionLayer& layer);
+    
+    /**
+     * @brief Deliver the final result and enable review
+     * @param result DetectionResult with all detected regions
+     */
+    void setDetectionResult(const DetectionResult& result);
+    
+    /**
+     * @brief Check whether the dialog is still waiting for the final result
+     */
+    bool isDetecting() const { return detecting; }
+    
     /**
      * @brief Get list of accepted regions
      * @return QList of DetectedRegion that were accepted by user
@@ -57,6 +87,17 @@ signals:
      * @param regions List of accepted DetectedRegion objects
      */
     void regionsAccepted(const QList<DetectedRegion>& regions);
+    
+    /**
+     * @brief Emitted when the dialog is closed while detection is still running
+     */
+    void abortRequested();
+
+public slots:
+    /**
+     * @brief Close the dialog; aborts the detection if it is still running
+     */
+    void reject() override;
 
 private slots:
     void onAcceptAllClicked();
@@ -74,6 +115,8 @@ private:
     void updatePreview();
     void updateRegionList();
     void filterRegionsByConfidence(double minConfidence);
+    void updateSummary();
+    void setReviewEnabled(bool enabled);
     
     DetectionResult detectionResult;
     QImage sourceImage;
@@ -91,6 +134,10 @@ private:
     QLabel* groupsLabel;
     QLabel* patternsLabel;
     QListWidget* groupsListWidget;
+    QLabel* summaryLabel;
+    QList<QWidget*> reviewControls;              // Disabled until the final result arrives
+    QList<PartialDetectionLayer> partialLayers;  // Shown while detecting
+    bool detecting;
 };
 
 } // namespace ocr_orc
@@ -1,15 +1,22 @@
 #include "MagicDetectParamsDialog.h"
 #include "../../ThemeManager.h"
+#include "../../utils/DetectionPreviewWorker.h"
+#include "../../../export/DetectionPresetIO.h"
 #include <QtCore/QSettings>
 #include <QtCore/QDebug>
+#include <QtCore/QTimer>
+#include <QtGui/QPainter>
 #include <QtWidgets/QScrollArea>
 #include <QtWidgets/QFrame>
 #include <QtWidgets/QGridLayout>
 #include <QtWidgets/QTextEdit>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
 
 namespace ocr_orc {
 
-MagicDetectParamsDialog::MagicDetectParamsDialog(QWidget* parent, const DetectionParameters& currentParams)
+MagicDetectParamsDialog::MagicDetectParamsDialog(QWidget* parent, const DetectionParameters& currentParams,
+                                                 const QImage& page, const QImage& colorReference)
     : QDialog(parent)
     , params(currentParams)
     , shouldRunDetection(false)
@@ -42,14 +49,22 @@ MagicDetectParamsDialog::MagicDetectParamsDialog(QWidget* parent, const Detectio
     , presetVeryLenientButton(nullptr)
     , presetBalancedButton(nullptr)
     , presetStrictButton(nullptr)
+    , presetLoadButton(nullptr)
     , resetButton(nullptr)
     , runButton(nullptr)
     , cancelButton(nullptr)
     , helpButton(nullptr)
+    , previewPage(page)
+    , previewColorReference(colorReference)
+    , previewWorker(nullptr)
+    , previewDebounceTimer(nullptr)
+    , previewImageLabel(nullptr)
+    , previewStatusLabel(nullptr)
+    , latestPreviewId(0)
 {
     setWindowTitle("🎯 Magic Detect - Configure Parameters");
     setMinimumSize(900, 700);
-    resize(1000, 800);
+    resize(previewPage.isNull() ? 1000 : 1400, 800);
     
     setupUI();
     connectSignals();
@@ -133,7 +148,12 @@ void MagicDetectParamsDialog::setupUI() {
     
     presetLayout->addWidget(presetVeryLenientButton);
     presetLayout->addWidget(presetBalancedButton);
+    presetLoadButton = new QPushButton("📂 Load Preset...", this);
+    presetLoadButton->setObjectName("presetLoad");
+    presetLoadButton->setToolTip("Load parameters from a preset file (e.g. one written by the auto-tuner)");
+    
     presetLayout->addWidget(presetStrictButton);
+    presetLayout->addWidget(presetLoadButton);
     presetLayout->addStretch();
     
     mainLayout->addLayout(presetLayout);
@@ -519,7 +539,16 @@ void MagicDetectParamsDialog::setupUI() {
     
     // === FINALIZE SCROLL AREA ===
     scrollArea->setWidget(scrollContent);
-    mainLayout->addWidget(scrollArea, 1);  // Stretch factor
+    if (previewPage.isNull()) {
+        mainLayout->addWidget(scrollArea, 1);  // Stretch factor
+    } else {
+        // Parameters on the left, live preview of their effect on the right
+        QHBoxLayout* contentLayout = new QHBoxLayout();
+        contentLayout->setSpacing(12);
+        contentLayout->addWidget(scrollArea, 3);
+        contentLayout->addWidget(createPreviewPane(), 2);
+        mainLayout->addLayout(contentLayout, 1);
+    }
     
     // === Action Buttons ===
     QHBoxLayout* buttonLayout = new QHBoxLayout();
@@ -550,6 +579,82 @@ void MagicDetectParamsDialog::setupUI() {
     mainLayout->addLayout(buttonLayout);
 }
 
+QFrame* MagicDetectParamsDialog::createPreviewPane() {
+    QFrame* previewCard = createStyledCard(this, "👁️ Live Preview");
+    QVBoxLayout* previewCardLayout = static_cast<QVBoxLayout*>(previewCard->layout());
+    previewCard->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding);
+    
+    previewImageLabel = new QLabel(previewCard);
+    previewImageLabel->setAlignment(Qt::AlignCenter);
+    previewImageLabel->setMinimumSize(280, 360);
+    previewImageLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    previewImageLabel->setToolTip("Fields (green) and checkboxes (blue) detected with the current parameters, on a thumbnail of the page");
+    previewCardLayout->addWidget(previewImageLabel, 1);
+    
+    previewStatusLabel = new QLabel("Preparing preview (reading the page)...", previewCard);
+    previewStatusLabel->setObjectName("previewLabel");
+    previewStatusLabel->setWordWrap(true);
+    previewCardLayout->addWidget(previewStatusLabel);
+    
+    // Only stages affected by the changed parameter re-run, on cached OCR and rectangles
+    previewWorker = new DetectionPreviewWorker(this);
+    previewWorker->setPage(previewPage, previewColorReference);
+    connect(previewWorker, &DetectionPreviewWorker::previewReady, this, &MagicDetectParamsDialog::onPreviewReady);
+    
+    previewDebounceTimer = new QTimer(this);
+    previewDebounceTimer->setSingleShot(true);
+    previewDebounceTimer->setInterval(PREVIEW_DEBOUNCE_MS);
+    connect(previewDebounceTimer, &QTimer::timeout, this, &MagicDetectParamsDialog::runPreview);
+    
+    return previewCard;
+}
+
+void MagicDetectParamsDialog::schedulePreview() {
+    if (!previewWorker) {
+        return;
+    }
+    // Drop the running preview now; its result would be stale
+    previewWorker->cancel();
+    previewDebounceTimer->start();
+}
+
+void MagicDetectParamsDialog::runPreview() {
+    if (!previewWorker) {
+        return;
+    }
+    latestPreviewId = previewWorker->requestPreview(getParameters());
+    if (!previewImageLabel->pixmap().isNull()) {
+        previewStatusLabel->setText("Updating preview...");
+    }
+}
+
+void MagicDetectParamsDialog::onPreviewReady(int requestId, const QImage& thumbnail, const QList<QRect>& fields,
+                                             const QList<QRect>& checkboxes, qint64 elapsedMs) {
+    if (requestId != latestPreviewId) {
+        return;
+    }
+    
+    QImage overlay = thumbnail.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&overlay);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(QPen(QColor(0, 170, 0), 2));
+    painter.setBrush(QColor(0, 200, 0, 50));
+    for (const QRect& field : fields) {
+        painter.drawRect(field);
+    }
+    painter.setPen(QPen(QColor(0, 90, 220), 2));
+    painter.setBrush(QColor(0, 120, 255, 60));
+    for (const QRect& checkbox : checkboxes) {
+        painter.drawRect(checkbox);
+    }
+    painter.end();
+    
+    previewImageLabel->setPixmap(QPixmap::fromImage(overlay).scaled(
+        previewImageLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    previewStatusLabel->setText(QString("%1 fields, %2 checkboxes (%3 ms)")
+                                    .arg(fields.size()).arg(checkboxes.size()).arg(elapsedMs));
+}
+
 void MagicDetectParamsDialog::connectSignals() {
     connect(helpButton, &QPushButton::clicked, this, &MagicDetectParamsDialog::showHelpDialog);
     connect(resetButton, &QPushButton::clicked, this, &MagicDetectParamsDialog::onResetClicked);
@@ -560,6 +665,7 @@ void MagicDetectParamsDialog::connectSignals() {
     connect(presetVeryLenientButton, &QPushButton::clicked, this, [this]() { applyPreset("VeryLenient"); });
     connect(presetBalancedButton, &QPushButton::clicked, this, [this]() { applyPreset("Balanced"); });
     connect(presetStrictButton, &QPushButton::clicked, this, [this]() { applyPreset("Strict"); });
+    connect(presetLoadButton, &QPushButton::clicked, this, &MagicDetectParamsDialog::onLoadPresetClicked);
     
     // Connect all spinboxes to update preview labels
     connect(ocrOverlapSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), 
@@ -596,6 +702,10 @@ void MagicDetectParamsDialog::connectSignals() {
             this, &MagicDetectParamsDialog::updatePreviewLabels);
     connect(checkboxRectangularitySpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), 
             this, &MagicDetectParamsDialog::updatePreviewLabels);
+    
+    // Toggles have no preview label but still change the live preview
+    connect(strictConsensusCheckBox, &QCheckBox::toggled, this, &MagicDetectParamsDialog::schedulePreview);
+    connect(enableStandaloneCheckboxCheckBox, &QCheckBox::toggled, this, &MagicDetectParamsDialog::schedulePreview);
 }
 
 void MagicDetectParamsDialog::updatePreviewLabels() {
@@ -663,6 +773,8 @@ void MagicDetectParamsDialog::updatePreviewLabels() {
             .arg(aspectMin).arg(aspectMax)
             .arg(rect)
             .arg(enabled ? "ON" : "OFF"));
+    
+    schedulePreview();
 }
 
 void MagicDetectParamsDialog::onResetClicked() {
@@ -692,6 +804,29 @@ void MagicDetectParamsDialog::onResetClicked() {
     updatePreviewLabels();
 }
 
+void MagicDetectParamsDialog::onLoadPresetClicked() {
+    QSettings settings;
+    settings.beginGroup("MagicDetectParams");
+    QString lastPath = settings.value("lastPresetPath").toString();
+    
+    QString filePath = QFileDialog::getOpenFileName(
+        this, "Load Detection Preset", lastPath, "Detection Presets (*.json);;All Files (*)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    try {
+        QString presetName;
+        DetectionParameters preset = DetectionPresetIO::importFromFile(filePath, &presetName);
+        applyParameters(preset);
+        settings.setValue("lastPresetPath", filePath);
+        presetLoadButton->setToolTip(QString("Loaded preset: %1").arg(presetName.isEmpty() ? filePath : presetName));
+    } catch (const std::exception& e) {
+        QMessageBox::warning(this, "Load Preset", QString("Failed to load preset:\n%1").arg(e.what()));
+    }
+    settings.endGroup();
+}
+
 void MagicDetectParamsDialog::onRunClicked() {
     shouldRunDetection = true;
     saveSettings();
@@ -888,7 +1023,10 @@ void MagicDetectParamsDialog::applyPreset(const QString& presetName) {
         return;  // Unknown preset
     }
     
-    // Apply preset values
+    applyParameters(preset);
+}
+
+void MagicDetectParamsDialog::applyParameters(const DetectionParameters& preset) {
     ocrOverlapSpinBox->setValue(preset.ocrOverlapThreshold);
     baseBrightnessSpinBox->setValue(preset.baseBrightnessThreshold);
     brightnessAdaptiveSpinBox->setValue(preset.brightnessAdaptiveFactor);
@@ -1247,6 +1385,20 @@ void MagicDetectParamsDialog::applyTheme() {
         "}"
     ).arg(colors.error.name(), "white", colors.error.darker(120).name());
     
+    dialogStylesheet += QString(
+        "#presetLoad {"
+        "  padding: 10px 20px;"
+        "  background-color: %1;"
+        "  color: %2;"
+        "  border: none;"
+        "  border-radius: 6px;"
+        "  font-weight: bold;"
+        "}"
+        "#presetLoad:hover {"
+        "  background-color: %3;"
+        "}"
+    ).arg(colors.warning.name(), "white", colors.warning.darker(120).name());
+    
     // Action buttons
     dialogStylesheet += QString(
         "#resetButton {"
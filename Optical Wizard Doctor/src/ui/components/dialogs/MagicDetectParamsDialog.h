@@ -12,10 +12,18 @@
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QFormLayout>
 #include <QtWidgets/QCheckBox>
+#include <QtWidgets/QFrame>
 #include <QtCore/QSettings>
+#include <QtCore/QList>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
+
+class QTimer;
 
 namespace ocr_orc {
 
+class DetectionPreviewWorker;
+
 /**
  * @brief Parameters structure for Magic Detect configuration
  */
@@ -76,9 +84,13 @@ public:
      * @brief Constructor
      * @param parent Parent widget
      * @param currentParams Current parameters (for loading defaults)
+     * @param page Page to preview detection on (no preview pane if null)
+     * @param colorReference Colour raster of the page, for classifying a gray page (may be null)
      */
     explicit MagicDetectParamsDialog(QWidget* parent, 
-                                     const DetectionParameters& currentParams = DetectionParameters());
+                                     const DetectionParameters& currentParams = DetectionParameters(),
+                                     const QImage& page = QImage(),
+                                     const QImage& colorReference = QImage());
     virtual ~MagicDetectParamsDialog() = default;
     
     /**
@@ -95,11 +107,23 @@ public:
 
 private slots:
     void onResetClicked();
+    void onLoadPresetClicked();
     void onRunClicked();
     void onCancelClicked();
     void updatePreviewLabels();
+    
+    /**
+     * @brief Restart the debounce timer; the preview runs when edits pause
+     */
+    void schedulePreview();
+    void runPreview();
+    void onPreviewReady(int requestId, const QImage& thumbnail, const QList<QRect>& fields,
+                        const QList<QRect>& checkboxes, qint64 elapsedMs);
 
 private:
+    // Quiet time after the last edit before the preview re-runs
+    static constexpr int PREVIEW_DEBOUNCE_MS = 60;
+    
     void setupUI();
     void loadSettings();
     void saveSettings();
@@ -157,6 +181,7 @@ private:
     QPushButton* presetVeryLenientButton;
     QPushButton* presetBalancedButton;
     QPushButton* presetStrictButton;
+    QPushButton* presetLoadButton;  // Preset file, e.g. written by the auto-tuner
     
     // Buttons
     QPushButton* resetButton;
@@ -164,8 +189,19 @@ private:
     QPushButton* cancelButton;
     QPushButton* helpButton;
     
+    // Live preview (only created when a page was given)
+    QImage previewPage;
+    QImage previewColorReference;
+    DetectionPreviewWorker* previewWorker;
+    QTimer* previewDebounceTimer;
+    QLabel* previewImageLabel;
+    QLabel* previewStatusLabel;
+    int latestPreviewId;
+    
     // Helper methods
+    QFrame* createPreviewPane();
     void applyPreset(const QString& presetName);
+    void applyParameters(const DetectionParameters& preset);
     void showHelpDialog();
 };
 
@@ -1,4 +1,5 @@
 #include "PreferencesDialog.h"
+#include "../../../utils/TraceRecorder.h"
 #include <QtWidgets/QDialogButtonBox>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QFormLayout>
@@ -41,6 +42,10 @@ PreferencesDialog::PreferencesDialog(QWidget *parent)
     , defaultRegionHeightSpinBox(nullptr)
     , minRegionSizeSpinBox(nullptr)
     , minNormalizedSizeSpinBox(nullptr)
+    , enableTracingCheckBox(nullptr)
+    , traceDirectoryEdit(nullptr)
+    , browseTraceDirectoryButton(nullptr)
+    , speculativeAnalysisCheckBox(nullptr)
     , settings(new QSettings("OCROrc", "OCR-Orc"))
 {
     setWindowTitle("Preferences");
@@ -66,6 +71,7 @@ void PreferencesDialog::setupUI() {
     setupExportTab(tabWidget);
     setupUITab(tabWidget);
     setupRegionTab(tabWidget);
+    setupDiagnosticsTab(tabWidget);
     
     mainLayout->addWidget(tabWidget);
 
@@ -260,6 +266,51 @@ void PreferencesDialog::setupRegionTab(QTabWidget* tabWidget) {
     tabWidget->addTab(widget, "Region");
 }
 
+void PreferencesDialog::setupDiagnosticsTab(QTabWidget* tabWidget) {
+    QWidget* widget = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(widget);
+    layout->setSpacing(10);
+    layout->setContentsMargins(10, 10, 10, 10);
+    
+    QGroupBox* tracingGroup = new QGroupBox("Runtime Tracing", widget);
+    QFormLayout* formLayout = new QFormLayout(tracingGroup);
+    
+    enableTracingCheckBox = new QCheckBox("Record detection traces", tracingGroup);
+    enableTracingCheckBox->setToolTip("Write a Chrome trace-event JSON file after each Magic Detect run.\n"
+                                      "Open it in chrome://tracing or ui.perfetto.dev to see per-stage timings.\n"
+                                      "Can also be enabled with the OCR_ORC_TRACE environment variable.");
+    formLayout->addRow(enableTracingCheckBox);
+    
+    QHBoxLayout* pathLayout = new QHBoxLayout();
+    traceDirectoryEdit = new QLineEdit(tracingGroup);
+    browseTraceDirectoryButton = new QPushButton("Browse...", tracingGroup);
+    connect(browseTraceDirectoryButton, &QPushButton::clicked, this, &PreferencesDialog::onBrowseTraceDirectory);
+    pathLayout->addWidget(traceDirectoryEdit);
+    pathLayout->addWidget(browseTraceDirectoryButton);
+    formLayout->addRow("Trace Output Directory:", pathLayout);
+    
+    traceDirectoryEdit->setEnabled(false);
+    browseTraceDirectoryButton->setEnabled(false);
+    connect(enableTracingCheckBox, &QCheckBox::toggled, traceDirectoryEdit, &QLineEdit::setEnabled);
+    connect(enableTracingCheckBox, &QCheckBox::toggled, browseTraceDirectoryButton, &QPushButton::setEnabled);
+    
+    layout->addWidget(tracingGroup);
+    
+    QGroupBox* performanceGroup = new QGroupBox("Performance", widget);
+    QFormLayout* performanceLayout = new QFormLayout(performanceGroup);
+    
+    speculativeAnalysisCheckBox = new QCheckBox("Start OCR in the background when a PDF is loaded", performanceGroup);
+    speculativeAnalysisCheckBox->setToolTip("Runs OCR and rectangle detection on the loaded page at low priority,\n"
+                                            "so Magic Detect can skip its slowest stages. Stopped when another\n"
+                                            "document is loaded or the page is edited heavily.");
+    performanceLayout->addRow(speculativeAnalysisCheckBox);
+    
+    layout->addWidget(performanceGroup);
+    layout->addStretch();
+    
+    tabWidget->addTab(widget, "Diagnostics");
+}
+
 void PreferencesDialog::loadSettings() {
     // General
     QString defaultColor = settings->value("general/defaultRegionColor", "blue").toString();
@@ -314,6 +365,12 @@ void PreferencesDialog::loadSettings() {
     defaultRegionHeightSpinBox->setValue(settings->value("region/defaultHeight", 100).toInt());
     minRegionSizeSpinBox->setValue(settings->value("region/minSize", 10).toInt());
     minNormalizedSizeSpinBox->setValue(settings->value("region/minNormalizedSize", 0.001).toDouble());
+    
+    // Diagnostics
+    enableTracingCheckBox->setChecked(settings->value("diagnostics/enableTracing", false).toBool());
+    traceDirectoryEdit->setText(settings->value("diagnostics/traceDirectory",
+        QStandardPaths::writableLocation(QStandardPaths::TempLocation)).toString());
+    speculativeAnalysisCheckBox->setChecked(settings->value("detection/speculativeAnalysis", true).toBool());
 }
 
 void PreferencesDialog::saveSettings() {
@@ -348,6 +405,12 @@ void PreferencesDialog::saveSettings() {
     settings->setValue("region/minSize", minRegionSizeSpinBox->value());
     settings->setValue("region/minNormalizedSize", minNormalizedSizeSpinBox->value());
     
+    // Diagnostics (applied immediately so the next detection run is traced; OCR_ORC_TRACE still wins)
+    settings->setValue("diagnostics/enableTracing", enableTracingCheckBox->isChecked());
+    settings->setValue("diagnostics/traceDirectory", traceDirectoryEdit->text());
+    TraceRecorder::instance().applyPreferences(enableTracingCheckBox->isChecked(), traceDirectoryEdit->text());
+    settings->setValue("detection/speculativeAnalysis", speculativeAnalysisCheckBox->isChecked());
+    
     settings->sync();
 }
 
@@ -372,6 +435,18 @@ void PreferencesDialog::onBrowseExportPath() {
     }
 }
 
+void PreferencesDialog::onBrowseTraceDirectory() {
+    QString dir = QFileDialog::getExistingDirectory(
+        this,
+        "Select Trace Output Directory",
+        traceDirectoryEdit->text()
+    );
+    
+    if (!dir.isEmpty()) {
+        traceDirectoryEdit->setText(dir);
+    }
+}
+
 void PreferencesDialog::onResetDefaults() {
     int ret = QMessageBox::question(
         this,
@@ -408,6 +483,10 @@ void PreferencesDialog::onResetDefaults() {
         defaultRegionHeightSpinBox->setValue(100);
         minRegionSizeSpinBox->setValue(10);
         minNormalizedSizeSpinBox->setValue(0.001);
+        
+        enableTracingCheckBox->setChecked(false);
+        traceDirectoryEdit->setText(QStandardPaths::writableLocation(QStandardPaths::TempLocation));
+        speculativeAnalysisCheckBox->setChecked(true);
     }
 }
 
@@ -28,6 +28,7 @@ namespace ocr_orc {
  * - Export: Default format, export path
  * - UI: Visibility, icon size
  * - Region: Default size, minimum size
+ * - Diagnostics: Runtime tracing (Chrome trace export), background page analysis
  */
 class PreferencesDialog : public QDialog {
     Q_OBJECT
@@ -62,6 +63,11 @@ private slots:
      */
     void onBrowseExportPath();
 
+    /**
+     * @brief Handle Browse button for trace output directory
+     */
+    void onBrowseTraceDirectory();
+
     /**
      * @brief Handle Reset to Defaults button
      */
@@ -74,6 +80,7 @@ private:
     void setupExportTab(QTabWidget* tabWidget);
     void setupUITab(QTabWidget* tabWidget);
     void setupRegionTab(QTabWidget* tabWidget);
+    void setupDiagnosticsTab(QTabWidget* tabWidget);
 
     // General tab
     QComboBox* defaultRegionColorCombo;
@@ -107,6 +114,12 @@ private:
     QSpinBox* minRegionSizeSpinBox;
     QDoubleSpinBox* minNormalizedSizeSpinBox;
 
+    // Diagnostics tab
+    QCheckBox* enableTracingCheckBox;
+    QLineEdit* traceDirectoryEdit;
+    QPushButton* browseTraceDirectoryButton;
+    QCheckBox* speculativeAnalysisCheckBox;
+
     QSettings* settings;
 };
 
@@ -0,0 +1,157 @@
+#include "SidePanelListModel.h"
+#include <QtCore/QSet>
+
+namespace ocr_orc {
+
+SidePanelListModel::SidePanelListModel(const QString& placeholderText, QObject* parent)
+    : QAbstractListModel(parent)
+    , placeholder(placeholderText)
+    , rowByNameStale(true)
+{
+}
+
+int SidePanelListModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return items.isEmpty() ? 1 : items.size();
+}
+
+QVariant SidePanelListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    
+    if (items.isEmpty()) {
+        // Placeholder row
+        if (role == Qt::DisplayRole) {
+            return placeholder;
+        }
+        if (role == NameRole) {
+            return QString();
+        }
+        return QVariant();
+    }
+    
+    const Item& item = items[index.row()];
+    if (role == Qt::DisplayRole) {
+        return item.label;
+    }
+    if (role == NameRole) {
+        return item.name;
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags SidePanelListModel::flags(const QModelIndex& index) const {
+    if (!index.isValid() || items.isEmpty()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren;
+}
+
+void SidePanelListModel::setItems(const QList<Item>& newItems) {
+    if (items.isEmpty() && newItems.isEmpty()) {
+        return;
+    }
+    
+    QSet<QString> newNames;
+    newNames.reserve(newItems.size());
+    for (const Item& item : newItems) {
+        newNames.insert(item.name);
+    }
+    bool anyKept = false;
+    for (const Item& item : items) {
+        if (newNames.contains(item.name)) {
+            anyKept = true;
+            break;
+        }
+    }
+    
+    // Placeholder row appears or disappears, or nothing survives: nothing to diff against
+    if (!anyKept) {
+        beginResetModel();
+        items = newItems;
+        rowByNameStale = true;
+        endResetModel();
+        return;
+    }
+    
+    // 1. Remove rows that are gone, one contiguous run at a time (back to front)
+    for (int row = items.size() - 1; row >= 0; --row) {
+        if (newNames.contains(items[row].name)) {
+            continue;
+        }
+        const int last = row;
+        while (row > 0 && !newNames.contains(items[row - 1].name)) {
+            --row;
+        }
+        beginRemoveRows(QModelIndex(), row, last);
+        items.remove(row, last - row + 1);
+        rowByNameStale = true;
+        endRemoveRows();
+    }
+    
+    QSet<QString> keptNames;
+    keptNames.reserve(items.size());
+    for (const Item& item : items) {
+        keptNames.insert(item.name);
+    }
+    
+    // 2. Walk the new order: insert new runs, update changed labels
+    int row = 0;
+    while (row < newItems.size()) {
+        const Item& wanted = newItems[row];
+        if (row < items.size() && items[row].name == wanted.name) {
+            if (items[row].label != wanted.label) {
+                items[row].label = wanted.label;
+                const QModelIndex changed = index(row);
+                emit dataChanged(changed, changed, {Qt::DisplayRole});
+            }
+            ++row;
+            continue;
+        }
+    
+        if (!keptNames.contains(wanted.name)) {
+            int last = row;
+            while (last + 1 < newItems.size() && !keptNames.contains(newItems[last + 1].name)) {
+                ++last;
+            }
+            beginInsertRows(QModelIndex(), row, last);
+            items.insert(row, last - row + 1, Item());
+            for (int i = row; i <= last; ++i) {
+                items[i] = newItems[i];
+            }
+            rowByNameStale = true;
+            endInsertRows();
+            row = last + 1;
+            continue;
+        }
+    
+        // A kept item moved relative to the others: nothing cheaper than a reset
+        beginResetModel();
+        items = newItems;
+        rowByNameStale = true;
+        endResetModel();
+        return;
+    }
+}
+
+QModelIndex SidePanelListModel::indexOf(const QString& name) const {
+    if (rowByNameStale) {
+        rowByName.clear();
+        rowByName.reserve(items.size());
+        for (int row = 0; row < items.size(); ++row) {
+            rowByName.insert(items[row].name, row);
+        }
+        rowByNameStale = false;
+    }
+    
+    auto it = rowByName.constFind(name);
+    if (it == rowByName.constEnd()) {
+        return QModelIndex();
+    }
+    return index(it.value());
+}
+
+} // namespace ocr_orc
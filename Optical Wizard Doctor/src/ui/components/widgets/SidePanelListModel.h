@@ -0,0 +1,70 @@
+#ifndef SIDE_PANEL_LIST_MODEL_H
+#define SIDE_PANEL_LIST_MODEL_H
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+namespace ocr_orc {
+
+/**
+ * @brief List model behind the side panel's region and group lists
+ *
+ * Each row is a named item (region or group) with a display label. The
+ * lists are refreshed from many places after every edit, so setItems()
+ * diffs the new items against the current rows and reports only what
+ * changed (rows removed, rows inserted, labels changed). The view keeps its
+ * rows, scroll position and selection instead of rebuilding thousands of
+ * items per edit.
+ *
+ * While empty, the model shows a single disabled placeholder row.
+ */
+class SidePanelListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Item name (region or group name; empty for the placeholder row)
+     */
+    static const int NameRole = Qt::UserRole + 1;
+
+    struct Item {
+        QString name;   // Region or group name (unique)
+        QString label;  // Text shown in the list
+    };
+
+    explicit SidePanelListModel(const QString& placeholderText, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /**
+     * @brief Replace the items, emitting fine-grained change signals
+     *
+     * Falls back to a model reset when the list becomes empty or non-empty,
+     * or when surviving items changed their relative order.
+     */
+    void setItems(const QList<Item>& newItems);
+
+    /**
+     * @brief Index of an item by name (invalid if not listed)
+     */
+    QModelIndex indexOf(const QString& name) const;
+
+    /**
+     * @brief Number of real items (the placeholder row is not counted)
+     */
+    int itemCount() const { return items.size(); }
+
+private:
+    QList<Item> items;
+    QString placeholder;
+    mutable QHash<QString, int> rowByName;  // Rebuilt on demand after rows move
+    mutable bool rowByNameStale;
+};
+
+} // namespace ocr_orc
+
+#endif // SIDE_PANEL_LIST_MODEL_H
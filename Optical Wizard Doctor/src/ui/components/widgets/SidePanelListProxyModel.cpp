@@ -0,0 +1,35 @@
+#include "SidePanelListProxyModel.h"
+#include "SidePanelListModel.h"
+
+namespace ocr_orc {
+
+SidePanelListProxyModel::SidePanelListProxyModel(QObject* parent)
+    : QSortFilterProxyModel(parent)
+{
+    collator.setNumericMode(true);
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    setSortRole(SidePanelListModel::NameRole);
+    setFilterCaseSensitivity(Qt::CaseInsensitive);
+    setDynamicSortFilter(true);
+}
+
+bool SidePanelListProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const {
+    const QString leftName = left.data(SidePanelListModel::NameRole).toString();
+    const QString rightName = right.data(SidePanelListModel::NameRole).toString();
+    const int order = collator.compare(leftName, rightName);
+    if (order != 0) {
+        return order < 0;
+    }
+    // Names differing only in case: keep a stable, deterministic order
+    return leftName < rightName;
+}
+
+bool SidePanelListProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const {
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (index.data(SidePanelListModel::NameRole).toString().isEmpty()) {
+        return true;  // Placeholder row
+    }
+    return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+}
+
+} // namespace ocr_orc
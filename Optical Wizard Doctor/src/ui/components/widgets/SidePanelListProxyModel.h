@@ -0,0 +1,33 @@
+#ifndef SIDE_PANEL_LIST_PROXY_MODEL_H
+#define SIDE_PANEL_LIST_PROXY_MODEL_H
+
+#include <QtCore/QCollator>
+#include <QtCore/QSortFilterProxyModel>
+
+namespace ocr_orc {
+
+/**
+ * @brief Sorting and filtering proxy for a SidePanelListModel
+ *
+ * Sorts rows by name in natural order ("Field 2" before "Field 10"),
+ * case-insensitively, and filters them with the fixed string set through
+ * setFilterFixedString() (matched against the displayed label, so a region
+ * can be found by its group too). The placeholder row is never filtered out.
+ */
+class SidePanelListProxyModel : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    explicit SidePanelListProxyModel(QObject* parent = nullptr);
+
+protected:
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    QCollator collator;
+};
+
+} // namespace ocr_orc
+
+#endif // SIDE_PANEL_LIST_PROXY_MODEL_H
@@ -7,6 +7,7 @@
 #include <QtWidgets/QFrame>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QScrollArea>
+#include <QtCore/QItemSelectionModel>
 #include <QtCore/QSet>
 #include <QtCore/QCoreApplication>
 
@@ -17,8 +18,14 @@ SidePanelWidget::SidePanelWidget(QWidget *parent)
     , sidePanelTabs(nullptr)
     , regionsTab(nullptr)
     , groupsTab(nullptr)
+    , regionFilterEdit(nullptr)
     , regionListBox(nullptr)
     , groupListBox(nullptr)
+    , regionListModel(nullptr)
+    , groupListModel(nullptr)
+    , regionListProxy(nullptr)
+    , groupListProxy(nullptr)
+    , updatingLists(false)
     , infoText(nullptr)
     , helpButton(nullptr)
     , createGroupButton(nullptr)
@@ -100,26 +107,41 @@ void SidePanelWidget::setupRegionsTab() {
     regionsLabel->setStyleSheet("font-weight: bold; font-size: 12pt; color: #000000;");
     regionsLayout->addWidget(regionsLabel);
     
-    regionListBox = new QListWidget(regionsTab);
-    regionListBox->addItem("No regions defined");
+    regionFilterEdit = new QLineEdit(regionsTab);
+    regionFilterEdit->setPlaceholderText("Filter regions");
+    regionFilterEdit->setClearButtonEnabled(true);
+    regionFilterEdit->setStyleSheet("color: #000000; background-color: #ffffff;");
+    regionsLayout->addWidget(regionFilterEdit);
+    
+    regionListModel = new SidePanelListModel("No regions defined", this);
+    regionListProxy = new SidePanelListProxyModel(this);
+    regionListProxy->setSourceModel(regionListModel);
+    regionListProxy->sort(0);
+    
+    regionListBox = new QListView(regionsTab);
+    regionListBox->setModel(regionListProxy);
     regionListBox->setEnabled(false);
     regionListBox->setStyleSheet("color: #000000; background-color: #ffffff;");
     regionListBox->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    regionListBox->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    regionListBox->setUniformItemSizes(true);  // Skip per-row size hints for long lists
     regionsLayout->addWidget(regionListBox, 1);
     
-    // Connect region listbox selection
-    connect(regionListBox, &QListWidget::itemSelectionChanged, this, [this]() {
-        QList<QListWidgetItem*> selectedItems = regionListBox->selectedItems();
-        QSet<QString> selectedRegions;
-        
-        for (QListWidgetItem* item : selectedItems) {
-            QString displayText = item->text();
-            // Extract region name (remove [group] suffix if present)
-            QString regionName = displayText.split(" [").first();
-            selectedRegions.insert(regionName);
+    // Filtering hides rows but must not deselect their regions
+    connect(regionFilterEdit, &QLineEdit::textChanged, this, [this](const QString& text) {
+        updatingLists = true;
+        regionListProxy->setFilterFixedString(text);
+        updatingLists = false;
+        syncRegionSelection(regionSelection);
+    });
+    
+    // Connect region listbox selection (user changes only)
+    connect(regionListBox->selectionModel(), &QItemSelectionModel::selectionChanged, this, [this]() {
+        if (updatingLists) {
+            return;
         }
-        
-        emit regionSelectionChanged(selectedRegions);
+        regionSelection = selectedNames(regionListBox);
+        emit regionSelectionChanged(regionSelection);
     });
     
     QFrame* regionButtonsFrame = new QFrame(regionsTab);
@@ -144,10 +166,18 @@ void SidePanelWidget::setupGroupsTab() {
     groupsLabel->setStyleSheet("font-weight: bold; font-size: 12pt; color: #000000;");
     groupsLayout->addWidget(groupsLabel);
     
-    groupListBox = new QListWidget(groupsTab);
-    groupListBox->addItem("No groups defined");
+    groupListModel = new SidePanelListModel("No groups defined", this);
+    groupListProxy = new SidePanelListProxyModel(this);
+    groupListProxy->setSourceModel(groupListModel);
+    groupListProxy->sort(0);
+    
+    groupListBox = new QListView(groupsTab);
+    groupListBox->setModel(groupListProxy);
     groupListBox->setEnabled(false);
     groupListBox->setStyleSheet("color: #000000; background-color: #ffffff;");
+    groupListBox->setSelectionMode(QAbstractItemView::SingleSelection);
+    groupListBox->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    groupListBox->setUniformItemSizes(true);
     groupsLayout->addWidget(groupListBox, 1);
     
     QFrame* groupButtonsFrame = new QFrame(groupsTab);
@@ -243,72 +273,112 @@ void SidePanelWidget::setupGroupsTab() {
     sidePanelTabs->addTab(groupsTab, "Groups");
     
     // Connect group listbox selection to info display
-    connect(groupListBox, &QListWidget::itemSelectionChanged, this, [this]() {
-        QList<QListWidgetItem*> selectedItems = groupListBox->selectedItems();
-        if (selectedItems.isEmpty()) {
+    connect(groupListBox->selectionModel(), &QItemSelectionModel::selectionChanged, this, [this]() {
+        if (updatingLists) {
+            return;
+        }
+        QString groupName = getSelectedGroupName();
+        if (groupName.isEmpty()) {
             return;
         }
-        
-        QString displayText = selectedItems[0]->text();
-        QString groupName = displayText.split(" (").first();
         emit groupSelectionChanged(groupName);
     });
 }
 
-void SidePanelWidget::updateRegionListBox(const QList<QString>& regionNames, const QSet<QString>& selectedRegions, const QMap<QString, QString>& regionGroups) {
+QSet<QString> SidePanelWidget::selectedNames(const QListView* view) {
+    QSet<QString> names;
+    if (!view || !view->selectionModel()) {
+        return names;
+    }
+    const QModelIndexList rows = view->selectionModel()->selectedRows();
+    names.reserve(rows.size());
+    for (const QModelIndex& index : rows) {
+        QString name = index.data(SidePanelListModel::NameRole).toString();
+        if (!name.isEmpty()) {
+            names.insert(name);
+        }
+    }
+    return names;
+}
+
+QSet<QString> SidePanelWidget::getSelectedRegionNames() const {
+    return selectedNames(regionListBox);
+}
+
+QString SidePanelWidget::getSelectedGroupName() const {
+    QSet<QString> names = selectedNames(groupListBox);
+    return names.isEmpty() ? QString() : *names.begin();
+}
+
+void SidePanelWidget::syncRegionSelection(const QSet<QString>& selectedRegions) {
     if (!regionListBox) {
         return;
     }
-    
-    // Block signals while updating to prevent cascading updates
-    regionListBox->blockSignals(true);
-    
-    regionListBox->clear();
-    
-    if (regionNames.isEmpty()) {
-        regionListBox->addItem("No regions defined");
-        regionListBox->setEnabled(false);
-        regionListBox->blockSignals(false);
+    regionSelection = selectedRegions;
+    QItemSelectionModel* selectionModel = regionListBox->selectionModel();
+    
+    // Regions hidden by the filter cannot be selected in the view
+    QSet<QString> visibleSelection;
+    QItemSelection selection;
+    for (const QString& name : selectedRegions) {
+        QModelIndex index = regionListProxy->mapFromSource(regionListModel->indexOf(name));
+        if (index.isValid()) {
+            visibleSelection.insert(name);
+            selection.select(index, index);
+        }
+    }
+    if (visibleSelection == selectedNames(regionListBox)) {
         return;
     }
     
-    regionListBox->setEnabled(true);
-    
-    // Store current selection to restore after update
-    QSet<QString> currentSelection = selectedRegions;
+    // Selection signals here come from the caller, not the user
+    const bool wasUpdating = updatingLists;
+    updatingLists = true;
+    selectionModel->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    updatingLists = wasUpdating;
+}
+
+void SidePanelWidget::updateRegionListBox(const QList<QString>& regionNames, const QSet<QString>& selectedRegions, const QMap<QString, QString>& regionGroups) {
+    if (!regionListBox) {
+        return;
+    }
     
+    QList<SidePanelListModel::Item> items;
+    items.reserve(regionNames.size());
     for (const QString& regionName : regionNames) {
         QString displayText = regionName;
         // Add group info if region is in a group
-        if (regionGroups.contains(regionName) && !regionGroups[regionName].isEmpty()) {
-            displayText += " [" + regionGroups[regionName] + "]";
-        }
-        QListWidgetItem* item = new QListWidgetItem(displayText, regionListBox);
-        if (currentSelection.contains(regionName)) {
-            item->setSelected(true);
+        QString group = regionGroups.value(regionName);
+        if (!group.isEmpty()) {
+            displayText += " [" + group + "]";
         }
+        items.append({regionName, displayText});
     }
     
-    // Re-enable signals
-    regionListBox->blockSignals(false);
+    // Selection signals here come from the update, not the user
+    updatingLists = true;
+    regionListModel->setItems(items);
+    regionListBox->setEnabled(!regionNames.isEmpty());
+    updatingLists = false;
+    syncRegionSelection(selectedRegions);
 }
 
 void SidePanelWidget::updateGroupListBox(const QList<QString>& groupNames, const QMap<QString, int>& groupSizes) {
-    groupListBox->clear();
-    
-    if (groupNames.isEmpty()) {
-        groupListBox->addItem("No groups defined");
-        groupListBox->setEnabled(false);
+    if (!groupListBox) {
         return;
     }
     
-    groupListBox->setEnabled(true);
-    
+    QList<SidePanelListModel::Item> items;
+    items.reserve(groupNames.size());
     for (const QString& groupName : groupNames) {
         int size = groupSizes.value(groupName, 0);
-        QString displayText = QString("%1 (%2)").arg(groupName).arg(size);
-        groupListBox->addItem(displayText);
+        items.append({groupName, QString("%1 (%2)").arg(groupName).arg(size)});
     }
+    
+    updatingLists = true;
+    groupListModel->setItems(items);
+    groupListBox->setEnabled(!groupNames.isEmpty());
+    updatingLists = false;
 }
 
 void SidePanelWidget::setInfoText(const QString& text) {
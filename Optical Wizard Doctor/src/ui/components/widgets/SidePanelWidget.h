@@ -3,13 +3,17 @@
 
 #include <QtWidgets/QFrame>
 #include <QtWidgets/QTabWidget>
-#include <QtWidgets/QListWidget>
+#include <QtWidgets/QListView>
 #include <QtWidgets/QTextEdit>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QLineEdit>
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QLabel>
 #include <QtCore/QString>
+#include <QtCore/QSet>
+#include <QtCore/QMap>
+#include "SidePanelListModel.h"
+#include "SidePanelListProxyModel.h"
 
 namespace ocr_orc {
 
@@ -24,8 +28,9 @@ public:
     ~SidePanelWidget() = default;
 
     // Getters for UI components
-    QListWidget* getRegionListBox() const { return regionListBox; }
-    QListWidget* getGroupListBox() const { return groupListBox; }
+    QListView* getRegionListBox() const { return regionListBox; }
+    QListView* getGroupListBox() const { return groupListBox; }
+    QLineEdit* getRegionFilterEdit() const { return regionFilterEdit; }
     QTextEdit* getInfoText() const { return infoText; }
     QPushButton* getHelpButton() const { return helpButton; }
     QPushButton* getCreateGroupButton() const { return createGroupButton; }
@@ -33,8 +38,22 @@ public:
     QPushButton* getRemoveFromGroupButton() const { return removeFromGroupButton; }
     QPushButton* getDeleteGroupButton() const { return deleteGroupButton; }
 
+    /**
+     * @brief Names of the regions selected in the region list
+     */
+    QSet<QString> getSelectedRegionNames() const;
+
+    /**
+     * @brief Name of the group selected in the group list (empty if none)
+     */
+    QString getSelectedGroupName() const;
+
     /**
      * @brief Update region listbox with current regions
+     *
+     * Only rows that were added, removed or relabelled are touched, and the
+     * selection is changed only if it differs from selectedRegions.
+     *
      * @param regionNames List of all region names
      * @param selectedRegions Set of currently selected region names
      * @param regionGroups Map of region names to their group names (empty string if no group)
@@ -48,6 +67,16 @@ public:
      */
     void updateGroupListBox(const QList<QString>& groupNames, const QMap<QString, int>& groupSizes);
     
+    /**
+     * @brief Select exactly the given regions in the region list without rebuilding it
+     *
+     * Use this when only the selection changed; no-op if already selected.
+     * Does not emit regionSelectionChanged.
+     *
+     * @param selectedRegions Set of currently selected region names
+     */
+    void syncRegionSelection(const QSet<QString>& selectedRegions);
+    
     /**
      * @brief Refresh all icons based on current theme
      * Call this when theme changes to update icon colors
@@ -189,12 +218,24 @@ private:
     void setupRegionsTab();
     void setupGroupsTab();
     void setupRegionEditor();
+    
+    /**
+     * @brief Names (NameRole) of the selected rows of a list view
+     */
+    static QSet<QString> selectedNames(const QListView* view);
 
     QTabWidget* sidePanelTabs;
     QWidget* regionsTab;
     QWidget* groupsTab;
-    QListWidget* regionListBox;
-    QListWidget* groupListBox;
+    QLineEdit* regionFilterEdit;
+    QListView* regionListBox;
+    QListView* groupListBox;
+    SidePanelListModel* regionListModel;          // Rows diffed on every update
+    SidePanelListModel* groupListModel;
+    SidePanelListProxyModel* regionListProxy;     // Natural sort + filter for regionListBox
+    SidePanelListProxyModel* groupListProxy;      // Natural sort for groupListBox
+    bool updatingLists;                           // Suppresses selection signals during programmatic updates
+    QSet<QString> regionSelection;                // Selected regions, including any hidden by the filter
     QTextEdit* infoText;
     QPushButton* helpButton;
     QPushButton* createGroupButton;
@@ -66,7 +66,7 @@ bool MainWindowUndoRedoAdapter::performUndo(DocumentState* documentState,
         updateGroupListBox,
         updateCanvas ? updateCanvas : [canvas]() {
             if (canvas) {
-                canvas->update();
+                canvas->invalidateLayer();
             }
         },
         [updateUndoRedoButtons, documentState]() {
@@ -139,7 +139,7 @@ bool MainWindowUndoRedoAdapter::performRedo(DocumentState* documentState,
         updateGroupListBox,
         updateCanvas ? updateCanvas : [canvas]() {
             if (canvas) {
-                canvas->update();
+                canvas->invalidateLayer();
             }
         },
         [updateUndoRedoButtons, documentState]() {
@@ -9,8 +9,6 @@
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QInputDialog>
 #include <QtWidgets/QLineEdit>
-#include <QtWidgets/QListWidget>
-#include <QtWidgets/QListWidgetItem>
 #include <QtWidgets/QStatusBar>
 #include <QtCore/QString>
 #include <QtCore/QSet>
@@ -67,7 +65,7 @@ void MainWindowRegionGroupHandlers::onCreateGroup(MainWindow* mainWindow) {
         [mainWindow]() { mainWindow->documentState->synchronizeCoordinates(); },
         [mainWindow]() { mainWindow->updateGroupListBox(); },
         [mainWindow]() { mainWindow->updateRegionListBox(); },
-        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->update(); },
+        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->invalidateLayer(); },
         [mainWindow]() { mainWindow->updateUndoRedoButtons(); },
         [mainWindow](const QString& message, int timeout) {
             mainWindow->statusBar()->showMessage(message, timeout);
@@ -86,9 +84,7 @@ QSet<QString> MainWindowRegionGroupHandlers::getSelectedRegions(MainWindow* main
     
     // Also check list box selections
     if (mainWindow->sidePanelWidget && mainWindow->sidePanelWidget->getRegionListBox()) {
-        QList<QListWidgetItem*> selectedItems = mainWindow->sidePanelWidget->getRegionListBox()->selectedItems();
-        for (QListWidgetItem* item : selectedItems) {
-            QString regionName = item->text().split(" (").first();
+        for (const QString& regionName : mainWindow->sidePanelWidget->getSelectedRegionNames()) {
             if (mainWindow->documentState->hasRegion(regionName)) {
                 selectedRegions.insert(regionName);
             }
@@ -129,7 +125,7 @@ void MainWindowRegionGroupHandlers::onAddToGroup(MainWindow* mainWindow) {
         [mainWindow]() { mainWindow->documentState->synchronizeCoordinates(); },
         [mainWindow]() { mainWindow->updateGroupListBox(); },
         [mainWindow]() { mainWindow->updateRegionListBox(); },
-        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->update(); },
+        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->invalidateLayer(); },
         [mainWindow]() { mainWindow->updateUndoRedoButtons(); },
         [mainWindow](const QString& message, int timeout) {
             mainWindow->statusBar()->showMessage(message, timeout);
@@ -168,7 +164,7 @@ void MainWindowRegionGroupHandlers::onRemoveFromGroup(MainWindow* mainWindow) {
         [mainWindow]() { mainWindow->documentState->synchronizeCoordinates(); },
         [mainWindow]() { mainWindow->updateGroupListBox(); },
         [mainWindow]() { mainWindow->updateRegionListBox(); },
-        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->update(); },
+        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->invalidateLayer(); },
         [mainWindow]() { mainWindow->updateUndoRedoButtons(); },
         [mainWindow](const QString& message, int timeout) {
             mainWindow->statusBar()->showMessage(message, timeout);
@@ -190,12 +186,7 @@ void MainWindowRegionGroupHandlers::onDeleteGroup(MainWindow* mainWindow) {
             if (!mainWindow->sidePanelWidget || !mainWindow->sidePanelWidget->getGroupListBox()) {
                 return QString();
             }
-            QList<QListWidgetItem*> selectedItems = mainWindow->sidePanelWidget->getGroupListBox()->selectedItems();
-            if (selectedItems.isEmpty()) {
-                return QString();
-            }
-            QString displayText = selectedItems[0]->text();
-            return displayText.split(" (").first();
+            return mainWindow->sidePanelWidget->getSelectedGroupName();
         },
         [mainWindow](const QString& title, const QString& message) {
             QMessageBox::warning(mainWindow, title, message);
@@ -216,7 +207,7 @@ void MainWindowRegionGroupHandlers::onDeleteGroup(MainWindow* mainWindow) {
         [mainWindow]() { mainWindow->documentState->synchronizeCoordinates(); },
         [mainWindow]() { mainWindow->updateGroupListBox(); },
         [mainWindow]() { mainWindow->updateRegionListBox(); },
-        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->update(); },
+        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->invalidateLayer(); },
         [mainWindow]() { mainWindow->updateUndoRedoButtons(); },
         [mainWindow](const QString& text) {
             if (mainWindow->sidePanelWidget) {
@@ -377,7 +368,7 @@ void MainWindowRegionGroupHandlers::onDeleteSelected(MainWindow* mainWindow) {
         [mainWindow](const QString& name) { mainWindow->documentState->removeRegion(name); },
         [mainWindow]() { mainWindow->documentState->synchronizeCoordinates(); },
         [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->clearSelection(); },
-        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->update(); },
+        [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->invalidateLayer(); },
         [mainWindow]() { mainWindow->updateRegionListBox(); },
         [mainWindow]() { mainWindow->updateGroupListBox(); },
         [mainWindow]() { mainWindow->updateUndoRedoButtons(); },
@@ -398,7 +389,7 @@ void MainWindowRegionGroupHandlers::onRegionNameChanged(MainWindow* mainWindow,
         mainWindow->updateRegionListBox();
         mainWindow->updateGroupListBox();
         if (mainWindow->canvas) {
-            mainWindow->canvas->update();
+            mainWindow->canvas->invalidateLayer();
         }
         mainWindow->updateUndoRedoButtons();
         mainWindow->statusBar()->showMessage(QString("Renamed region '%1' to '%2'").arg(oldName).arg(newName), 2000);
@@ -425,7 +416,7 @@ void MainWindowRegionGroupHandlers::onRegionColorChanged(MainWindow* mainWindow,
     mainWindow->documentState->addRegion(regionName, region);
     
     if (mainWindow->canvas) {
-        mainWindow->canvas->update();
+        mainWindow->canvas->invalidateLayer();
     }
     mainWindow->updateUndoRedoButtons();
     mainWindow->statusBar()->showMessage(QString("Changed color of '%1' to %2").arg(regionName).arg(newColor), 1500);
@@ -460,7 +451,7 @@ void MainWindowRegionGroupHandlers::onRegionGroupChanged(MainWindow* mainWindow,
     mainWindow->updateRegionListBox();
     mainWindow->updateGroupListBox();
     if (mainWindow->canvas) {
-        mainWindow->canvas->update();
+        mainWindow->canvas->invalidateLayer();
     }
     mainWindow->updateUndoRedoButtons();
     
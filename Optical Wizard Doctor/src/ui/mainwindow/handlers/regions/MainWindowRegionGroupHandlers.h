@@ -4,7 +4,6 @@
 #include <QtCore/QString>
 #include <QtCore/QSet>
 #include <QtCore/QList>
-#include <QtWidgets/QListWidgetItem>
 #include <functional>
 
 namespace ocr_orc {
@@ -5,20 +5,32 @@
 #include "../../../../export/JsonExporter.h"
 #include "../../../../export/CsvExporter.h"
 #include "../../../../export/JsonImporter.h"
+#include "../../../../export/ProjectExporter.h"
+#include "../../../../export/ProjectImporter.h"
 #include "../../../../export/MaskGenerator.h"
+#include "../../../../utils/PageAnalysisCache.h"
+#include "../../../utils/PdfLoadWorker.h"
+#include "../../../utils/SpeculativeAnalysisWorker.h"
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QStatusBar>
 #include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
 #include <QtGui/QImage>
 #include <QtCore/QString>
+#include <memory>
 
 namespace ocr_orc {
 
-MainWindowFileOperations::MainWindowFileOperations() {
+MainWindowFileOperations::MainWindowFileOperations()
+    : pdfLoadWorker(new PdfLoadWorker())
+    , speculativeWorker(new SpeculativeAnalysisWorker()) {
 }
 
 MainWindowFileOperations::~MainWindowFileOperations() {
+    // Both wait for their in-flight stage; pending results are discarded
+    delete speculativeWorker;
+    delete pdfLoadWorker;
 }
 
 void MainWindowFileOperations::loadPdf(QWidget* parentWidget,
@@ -43,65 +55,182 @@ void MainWindowFileOperations::loadPdf(QWidget* parentWidget,
         return; // User cancelled
     }
     
-    // Update status bar
-    if (statusBar) {
-        statusBar->showMessage("Loading PDF...");
+    // Render in the background; the warning is shown when the load fails
+    startPdfLoad(filePath, documentState, canvas, statusBar,
+                 updateZoomLabel, updateUndoRedoButtons, updateRegionListBox,
+                 updateGroupListBox, setFileLabel,
+                 [parentWidget](const QString& title, const QString& message) {
+                     if (parentWidget) {
+                         QMessageBox::warning(parentWidget, title, message);
+                     }
+                 });
+}
+
+bool MainWindowFileOperations::startPdfLoad(const QString& filePath,
+                                            DocumentState* documentState,
+                                            Canvas* canvas,
+                                            QStatusBar* statusBar,
+                                            const UpdateZoomLabelCallback& updateZoomLabel,
+                                            const UpdateUndoRedoButtonsCallback& updateUndoRedoButtons,
+                                            const UpdateRegionListBoxCallback& updateRegionListBox,
+                                            const UpdateGroupListBoxCallback& updateGroupListBox,
+                                            const SetFileLabelCallback& setFileLabel,
+                                            const ShowWarningCallback& showWarning) {
+    if (!documentState || !canvas) {
+        return false;
     }
     
-    // Load PDF in canvas
-    bool success = canvas->loadPdf(filePath);
-    
-    if (success) {
-        // Update file label
-        QFileInfo fileInfo(filePath);
-        if (setFileLabel) {
-            setFileLabel(fileInfo.fileName());
-        }
-        
-        // Update document state
-        documentState->pdfPath = filePath;
-        documentState->image = canvas->hasDocument() ? 
-            QImage(canvas->getDocumentImage()) : QImage();
-        
-        // Clear undo/redo stacks when loading new PDF
-        documentState->clearUndoRedoStacks();
-        
-        // Synchronize coordinates for any existing regions
-        documentState->synchronizeCoordinates();
-        
-        // Update UI
-        if (updateZoomLabel) {
-            updateZoomLabel();
-        }
-        if (updateUndoRedoButtons) {
-            updateUndoRedoButtons();
-        }
-        if (updateRegionListBox) {
-            updateRegionListBox();
-        }
-        if (updateGroupListBox) {
-            updateGroupListBox();
-        }
-        
-        // Update status bar
-        if (statusBar) {
-            statusBar->showMessage("PDF loaded successfully", 3000);
-        }
-    } else {
-        // Show error message
-        if (parentWidget) {
-            QMessageBox::warning(
-                parentWidget,
-                "Load PDF Error",
-                "Failed to load PDF file:\n" + filePath + "\n\nPlease ensure the file is a valid PDF."
-            );
+    // Unreadable files are rejected up front
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile() || !fileInfo.isReadable()) {
+        if (showWarning) {
+            showWarning("Load PDF Error", "Cannot read PDF file:\n" + filePath);
         }
-        
-        // Update status bar
         if (statusBar) {
             statusBar->showMessage("Failed to load PDF", 3000);
         }
+        return false;
     }
+    
+    // Update status bar
+    if (statusBar) {
+        statusBar->showMessage("Loading PDF...");
+    }
+    
+    // Only the newest load is wired up; older ones are cancelled by startLoad()
+    QObject::disconnect(pdfLoadWorker, nullptr, nullptr, nullptr);
+    
+    // Background analysis of the previous page is no longer useful
+    speculativeWorker->cancel();
+    
+    // Shared by preview and full image: both have the same pixel size, so
+    // normalized region coordinates map to the same image coordinates
+    auto applyImage = [documentState, canvas](const QImage& image, const QString& path) {
+        canvas->setImage(image);
+        documentState->image = image;
+        documentState->detectionImage = QImage();  // Rendered last, see detectionPageReady
+        documentState->imageSourcePdf = path;      // Zoomed-in views may re-render from it
+        documentState->synchronizeCoordinates();
+    };
+    auto previewShown = std::make_shared<bool>(false);
+    
+    QObject::connect(pdfLoadWorker, &PdfLoadWorker::previewReady, pdfLoadWorker,
+        [documentState, statusBar, applyImage, previewShown, updateZoomLabel, updateUndoRedoButtons,
+         updateRegionListBox, updateGroupListBox, setFileLabel](int, const QString& path, const QImage& preview) {
+            // First paint of the new document: switch over everything except image quality
+            if (setFileLabel) {
+                setFileLabel(QFileInfo(path).fileName());
+            }
+            documentState->pdfPath = path;
+            documentState->clearUndoRedoStacks();
+            applyImage(preview, path);
+            *previewShown = true;
+            
+            if (updateZoomLabel) {
+                updateZoomLabel();
+            }
+            if (updateUndoRedoButtons) {
+                updateUndoRedoButtons();
+            }
+            if (updateRegionListBox) {
+                updateRegionListBox();
+            }
+            if (updateGroupListBox) {
+                updateGroupListBox();
+            }
+            if (statusBar) {
+                statusBar->showMessage("Rendering PDF at full resolution...");
+            }
+        });
+    
+    QObject::connect(pdfLoadWorker, &PdfLoadWorker::loadComplete, pdfLoadWorker,
+        [documentState, statusBar, applyImage, previewShown, updateZoomLabel, updateUndoRedoButtons,
+         updateRegionListBox, updateGroupListBox, setFileLabel](int, const QString& path, const QImage& image) {
+            // If the preview failed, this is also the first paint
+            bool firstPaint = !*previewShown;
+            if (firstPaint) {
+                if (setFileLabel) {
+                    setFileLabel(QFileInfo(path).fileName());
+                }
+                documentState->pdfPath = path;
+                documentState->clearUndoRedoStacks();
+            }
+            applyImage(image, path);
+            
+            if (firstPaint) {
+                if (updateZoomLabel) {
+                    updateZoomLabel();
+                }
+                if (updateUndoRedoButtons) {
+                    updateUndoRedoButtons();
+                }
+                if (updateRegionListBox) {
+                    updateRegionListBox();
+                }
+                if (updateGroupListBox) {
+                    updateGroupListBox();
+                }
+            }
+            if (statusBar) {
+                statusBar->showMessage("PDF loaded successfully", 3000);
+            }
+        });
+    
+    SpeculativeAnalysisWorker* speculative = speculativeWorker;
+    QObject::connect(pdfLoadWorker, &PdfLoadWorker::detectionPageReady, pdfLoadWorker,
+        [documentState, speculative](int, const QString&, const QImage& page) {
+            documentState->detectionImage = page;
+            
+            // Get OCR out of the way while the user looks at the page
+            if (isSpeculativeAnalysisEnabled()) {
+                speculative->start(documentState->getDetectionImage());
+            }
+        });
+    
+    QObject::connect(pdfLoadWorker, &PdfLoadWorker::loadFailed, pdfLoadWorker,
+        [documentState, canvas, speculative, statusBar, showWarning, previewShown,
+         setFileLabel](int, const QString& path) {
+            // The blurry preview must not stand in for the page: detection and export would use it
+            if (*previewShown) {
+                speculative->cancel();
+                documentState->pdfPath.clear();
+                documentState->setImage(QImage());
+                canvas->setImage(QImage());
+                if (setFileLabel) {
+                    setFileLabel("No file loaded");
+                }
+            }
+            
+            // Show error message
+            if (showWarning) {
+                showWarning("Load PDF Error",
+                    "Failed to load PDF file:\n" + path + "\n\nPlease ensure the file is a valid PDF.");
+            }
+            if (statusBar) {
+                statusBar->showMessage("Failed to load PDF", 3000);
+            }
+        });
+    
+    // Whether the file is a renderable PDF is only known once the worker tries
+    pdfLoadWorker->startLoad(filePath);
+    return true;
+}
+
+bool MainWindowFileOperations::isPdfLoadInProgress() const {
+    return pdfLoadWorker->isLoading();
+}
+
+void MainWindowFileOperations::noteUserEdit() {
+    speculativeWorker->noteUserEdit();
+}
+
+void MainWindowFileOperations::cancelSpeculativeAnalysis() {
+    speculativeWorker->cancel();
+}
+
+bool MainWindowFileOperations::isSpeculativeAnalysisEnabled() {
+    QSettings settings("OCROrc", "OCR-Orc");
+    return settings.value("detection/speculativeAnalysis", true).toBool();
 }
 
 void MainWindowFileOperations::exportCoordinates(QWidget* parentWidget,
@@ -129,7 +258,7 @@ void MainWindowFileOperations::exportCoordinates(QWidget* parentWidget,
         parentWidget,
         "Export Coordinates",
         "",
-        "JSON files (*.json);;CSV files (*.csv);;All files (*.*)"
+        "JSON files (*.json);;CSV files (*.csv);;OCR-Orc projects (*.orcproj);;All files (*.*)"
     );
     
     if (filePath.isEmpty()) {
@@ -138,7 +267,20 @@ void MainWindowFileOperations::exportCoordinates(QWidget* parentWidget,
     
     try {
         // Determine format from extension
-        if (filePath.endsWith(".json", Qt::CaseInsensitive)) {
+        if (filePath.endsWith(ProjectFormat::FILE_EXTENSION, Qt::CaseInsensitive)) {
+            // Binary project: page raster + regions + groups, reopens without re-rendering.
+            // OCR already done for the page goes along, so detection after reopening skips it
+            ProjectExporter::exportToFile(*documentState, filePath,
+                PageAnalysisCache::instance().projectOcrWords(documentState->getDetectionImage()));
+            if (statusBar) {
+                statusBar->showMessage(
+                    QString("Saved project with %1 regions: %2")
+                        .arg(documentState->regions.size())
+                        .arg(filePath),
+                    3000
+                );
+            }
+        } else if (filePath.endsWith(".json", Qt::CaseInsensitive)) {
             JsonExporter::exportToFile(*documentState, filePath);
             if (statusBar) {
                 statusBar->showMessage(
@@ -211,7 +353,7 @@ void MainWindowFileOperations::loadCoordinates(QWidget* parentWidget,
         parentWidget,
         "Import Coordinates",
         "",
-        "JSON files (*.json);;All files (*.*)"
+        "JSON files (*.json);;OCR-Orc projects (*.orcproj);;All files (*.*)"
     );
     
     if (filePath.isEmpty()) {
@@ -219,8 +361,20 @@ void MainWindowFileOperations::loadCoordinates(QWidget* parentWidget,
     }
     
     try {
-        // Import JSON
-        JsonImporter::importFromFile(*documentState, filePath);
+        if (ProjectImporter::isProjectFile(filePath)) {
+            // Project files carry their own page raster, so no PDF render is needed
+            QList<ProjectOcrWord> ocrWords;
+            ProjectImporter::importFromFile(*documentState, filePath, &ocrWords);
+            pdfLoadWorker->cancel();
+            speculativeWorker->cancel();
+            PageAnalysisCache::instance().seedFromProject(documentState->getDetectionImage(), ocrWords);
+            if (canvas) {
+                canvas->setImage(documentState->image);
+            }
+        } else {
+            // Import JSON
+            JsonImporter::importFromFile(*documentState, filePath);
+        }
         
         // Update UI
         if (updateRegionListBox) {
@@ -230,7 +384,7 @@ void MainWindowFileOperations::loadCoordinates(QWidget* parentWidget,
             updateGroupListBox();
         }
         if (canvas) {
-            canvas->update();
+            canvas->invalidateLayer();
         }
         if (updateUndoRedoButtons) {
             updateUndoRedoButtons();
@@ -304,7 +458,8 @@ void MainWindowFileOperations::exportMask(QWidget* parentWidget,
         "",
         "PNG files (*.png);;"
         "JPEG files (*.jpg);;"
-        "TIFF files (*.tiff);;"
+        "TIFF files, one page per group (*.tiff);;"
+        "PBM files (*.pbm);;"
         "All files (*.*)"
     );
     
@@ -360,66 +515,15 @@ bool MainWindowFileOperations::handlePdfDrop(const QString& filePath,
                                              const UpdateGroupListBoxCallback& updateGroupListBox,
                                              const SetFileLabelCallback& setFileLabel,
                                              const ShowWarningCallback& showWarning) {
-    // Update status bar
-    if (statusBar) {
-        statusBar->showMessage("Loading PDF...");
-    }
-    
-    // Load PDF in canvas
-    bool success = canvas->loadPdf(filePath);
+    Q_UNUSED(controlPanelWidget);
     
-    if (success) {
-        // Update file label
-        QFileInfo fileInfo(filePath);
-        if (setFileLabel) {
-            setFileLabel(fileInfo.fileName());
-        }
-        
-        // Update document state
-        documentState->pdfPath = filePath;
-        documentState->image = canvas->hasDocument() ? 
-            QImage(canvas->getDocumentImage()) : QImage();
-        
-        // Clear undo/redo stacks when loading new PDF
-        documentState->clearUndoRedoStacks();
-        
-        // Synchronize coordinates for any existing regions
-        documentState->synchronizeCoordinates();
-        
-        // Update UI
-        if (updateZoomLabel) {
-            updateZoomLabel();
-        }
-        if (updateUndoRedoButtons) {
-            updateUndoRedoButtons();
-        }
-        if (updateRegionListBox) {
-            updateRegionListBox();
-        }
-        if (updateGroupListBox) {
-            updateGroupListBox();
-        }
-        
-        // Update status bar
-        if (statusBar) {
-            statusBar->showMessage("PDF loaded successfully", 3000);
-        }
-        
-        return true;
-    } else {
-        // Show error message
-        if (showWarning) {
-            showWarning("Load PDF Error",
-                "Failed to load PDF file:\n" + filePath + "\n\nPlease ensure the file is a valid PDF.");
-        }
-        
-        // Update status bar
-        if (statusBar) {
-            statusBar->showMessage("Failed to load PDF", 3000);
-        }
-        
+    if (!documentState || !canvas) {
         return false;
     }
+    
+    return startPdfLoad(filePath, documentState, canvas, statusBar,
+                        updateZoomLabel, updateUndoRedoButtons, updateRegionListBox,
+                        updateGroupListBox, setFileLabel, showWarning);
 }
 
 } // namespace ocr_orc
@@ -12,12 +12,15 @@ namespace ocr_orc {
 class DocumentState;
 class Canvas;
 class ControlPanelWidget;
+class PdfLoadWorker;
+class SpeculativeAnalysisWorker;
 
 /**
  * @brief Handles all file operations for MainWindow
  * 
  * Manages:
- * - PDF loading
+ * - PDF loading (rendered in the background: low-DPI preview, then full resolution)
+ * - Speculative page analysis after a load, so Magic Detect finds OCR done
  * - Coordinate export/import (JSON, CSV)
  * - Mask image export
  */
@@ -40,6 +43,13 @@ public:
     
     /**
      * @brief Load a PDF file
+     * 
+     * Returns as soon as the file is chosen; the page is rendered by a
+     * background worker and the canvas is updated when the preview and the
+     * full-resolution image arrive. If enabled in Preferences, the full page
+     * is then analysed at low priority (OCR, rectangles) so a later Magic
+     * Detect can reuse the results.
+     * 
      * @param parentWidget Parent widget for dialogs
      * @param documentState Document state to update
      * @param canvas Canvas widget to load PDF into
@@ -113,7 +123,7 @@ public:
      * @param controlPanelWidget Control panel to update file label
      * @param statusBar Status bar to show messages
      * @param callbacks Callback functions for UI updates
-     * @return true if PDF loaded successfully, false otherwise
+     * @return true if loading was started (render failures are reported later via showWarning)
      */
     bool handlePdfDrop(const QString& filePath,
                        DocumentState* documentState,
@@ -126,6 +136,45 @@ public:
                        const UpdateGroupListBoxCallback& updateGroupListBox,
                        const SetFileLabelCallback& setFileLabel,
                        const ShowWarningCallback& showWarning);
+    
+    /**
+     * @brief True while a PDF is still being rendered (display page or grayscale detection page)
+     */
+    bool isPdfLoadInProgress() const;
+    
+    /**
+     * @brief Report a user edit; heavy editing cancels the background page analysis
+     */
+    void noteUserEdit();
+    
+    /**
+     * @brief Stop the background page analysis (remaining stages are skipped)
+     */
+    void cancelSpeculativeAnalysis();
+    
+    /**
+     * @brief Whether a finished PDF load starts background OCR (Preferences, on by default)
+     */
+    static bool isSpeculativeAnalysisEnabled();
+
+private:
+    /**
+     * @brief Start a background load and wire its results to the UI
+     * @return false (after showWarning) if the file cannot be read; render failures are reported later
+     */
+    bool startPdfLoad(const QString& filePath,
+                      DocumentState* documentState,
+                      Canvas* canvas,
+                      QStatusBar* statusBar,
+                      const UpdateZoomLabelCallback& updateZoomLabel,
+                      const UpdateUndoRedoButtonsCallback& updateUndoRedoButtons,
+                      const UpdateRegionListBoxCallback& updateRegionListBox,
+                      const UpdateGroupListBoxCallback& updateGroupListBox,
+                      const SetFileLabelCallback& setFileLabel,
+                      const ShowWarningCallback& showWarning);
+    
+    PdfLoadWorker* pdfLoadWorker;  // Owned; renders pages off the GUI thread
+    SpeculativeAnalysisWorker* speculativeWorker;  // Owned; fills PageAnalysisCache after a load
 };
 
 } // namespace ocr_orc
@@ -5,7 +5,6 @@
 #include "../../../components/widgets/SidePanelWidget.h"
 #include <QtWidgets/QInputDialog>
 #include <QtWidgets/QMessageBox>
-#include <QtWidgets/QListWidget>
 
 namespace ocr_orc {
 
@@ -19,7 +18,7 @@ QSet<QString> MainWindowGroupOperations::getSelectedRegions(Canvas* canvas,
                                                            SidePanelWidget* sidePanelWidget,
                                                            DocumentState* documentState,
                                                            const GetCanvasSelectedRegionsCallback& getCanvasSelectedRegions,
-                                                           const GetListBoxSelectedItemsCallback& getListBoxSelectedItems,
+                                                           const GetListBoxSelectedRegionsCallback& getListBoxSelectedRegions,
                                                            const HasRegionCallback& hasRegion) const {
     QSet<QString> selectedRegions;
     
@@ -30,10 +29,7 @@ QSet<QString> MainWindowGroupOperations::getSelectedRegions(Canvas* canvas,
     
     // If nothing selected on canvas, try region listbox
     if (selectedRegions.isEmpty() && sidePanelWidget && sidePanelWidget->getRegionListBox() && documentState) {
-        QList<QListWidgetItem*> selectedItems = getListBoxSelectedItems();
-        for (QListWidgetItem* item : selectedItems) {
-            QString displayText = item->text();
-            QString regionName = displayText.split(" [").first();
+        for (const QString& regionName : getListBoxSelectedRegions()) {
             if (hasRegion(regionName)) {
                 selectedRegions.insert(regionName);
             }
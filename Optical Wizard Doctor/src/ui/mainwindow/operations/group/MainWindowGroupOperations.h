@@ -5,7 +5,6 @@
 #include <QtCore/QSet>
 #include <QtCore/QList>
 #include <QtWidgets/QWidget>
-#include <QtWidgets/QListWidgetItem>
 #include <functional>
 
 namespace ocr_orc {
@@ -55,7 +54,7 @@ public:
     using GetGroupNamesCallback = std::function<QList<QString>()>;
     using GetSelectedGroupCallback = std::function<QString()>;
     using GetCanvasSelectedRegionsCallback = std::function<QSet<QString>()>;
-    using GetListBoxSelectedItemsCallback = std::function<QList<QListWidgetItem*>()>;
+    using GetListBoxSelectedRegionsCallback = std::function<QSet<QString>()>;
     
     MainWindowGroupOperations();
     ~MainWindowGroupOperations();
@@ -175,7 +174,7 @@ public:
                                    SidePanelWidget* sidePanelWidget,
                                    DocumentState* documentState,
                                    const GetCanvasSelectedRegionsCallback& getCanvasSelectedRegions,
-                                   const GetListBoxSelectedItemsCallback& getListBoxSelectedItems,
+                                   const GetListBoxSelectedRegionsCallback& getListBoxSelectedRegions,
                                    const HasRegionCallback& hasRegion) const;
 };
 
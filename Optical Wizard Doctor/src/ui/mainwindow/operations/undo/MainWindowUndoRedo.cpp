@@ -63,7 +63,7 @@ void MainWindowUndoRedo::undo(DocumentState* documentState,
         updateGroupListBox,
         [canvas]() {
             if (canvas) {
-                canvas->update();
+                canvas->invalidateLayer();
             }
         },
         [updateUndoRedoButtons, documentState]() {
@@ -130,7 +130,7 @@ void MainWindowUndoRedo::redo(DocumentState* documentState,
         updateGroupListBox,
         [canvas]() {
             if (canvas) {
-                canvas->update();
+                canvas->invalidateLayer();
             }
         },
         [updateUndoRedoButtons, documentState]() {
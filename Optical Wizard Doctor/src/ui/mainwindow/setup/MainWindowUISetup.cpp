@@ -379,7 +379,7 @@ void MainWindowUISetup::setupCanvas(MainWindow* mainWindow,
             mainWindow->canvas->selectRegion(newName);
             mainWindow->updateRegionListBox();
             mainWindow->updateGroupListBox();
-            mainWindow->canvas->update();
+            mainWindow->canvas->invalidateLayer();
             mainWindow->updateUndoRedoButtons();
             mainWindow->statusBar()->showMessage(
                 QString("Renamed region '%1' to '%2'").arg(regionName).arg(newName), 2000);
@@ -404,7 +404,7 @@ void MainWindowUISetup::setupCanvas(MainWindow* mainWindow,
             [mainWindow](const QString& name, const QString& color) {
                 return mainWindow->documentState->changeRegionColor(name, color);
             },
-            [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->update(); },
+            [mainWindow]() { if (mainWindow->canvas) mainWindow->canvas->invalidateLayer(); },
             [mainWindow]() { mainWindow->updateRegionListBox(); },
             [mainWindow]() { mainWindow->updateUndoRedoButtons(); },
             [mainWindow](const QString& message, int timeout) {
@@ -80,7 +80,7 @@ void MainWindowWidgetConnections::connectWidgets(MainWindow* mainWindow,
                 }
             }
             canvas->setSelectedRegions(validRegions);
-            canvas->update();
+            canvas->invalidateLayer();
         }
     });
     
@@ -124,7 +124,7 @@ void MainWindowWidgetConnections::connectWidgets(MainWindow* mainWindow,
             newType,
             [documentState]() { documentState->saveState(); },
             [canvas]() { if (canvas) canvas->invalidateCoordinateCache(); },
-            [canvas]() { if (canvas) canvas->update(); },
+            [canvas]() { if (canvas) canvas->invalidateLayer(); },
             [mainWindow]() { mainWindow->updateUndoRedoButtons(); }
         );
     });
@@ -140,7 +140,7 @@ void MainWindowWidgetConnections::connectWidgets(MainWindow* mainWindow,
             newPercentageFill,
             [documentState]() { documentState->saveState(); },
             [canvas]() { if (canvas) canvas->invalidateCoordinateCache(); },
-            [canvas]() { if (canvas) canvas->update(); },
+            [canvas]() { if (canvas) canvas->invalidateLayer(); },
             [mainWindow]() { mainWindow->updateUndoRedoButtons(); }
         );
     });
@@ -156,7 +156,7 @@ void MainWindowWidgetConnections::connectWidgets(MainWindow* mainWindow,
             x1, y1, x2, y2,
             [documentState]() { documentState->saveState(); },
             [canvas]() { if (canvas) canvas->invalidateCoordinateCache(); },
-            [canvas]() { if (canvas) canvas->update(); },
+            [canvas]() { if (canvas) canvas->invalidateLayer(); },
             [mainWindow]() { mainWindow->updateRegionListBox(); },
             [mainWindow]() { mainWindow->updateUndoRedoButtons(); },
             [canvas]() { return canvas ? canvas->getDocumentImage() : QImage(); },
@@ -177,15 +177,17 @@ void MainWindowWidgetConnections::connectWidgets(MainWindow* mainWindow,
         // Clear hover state when selection changes to prevent old resize handles from showing
         canvas->setHoveredRegion(QString());
         
-        // Use CanvasUiSync to handle selection change with proper refresh order
+        // Use CanvasUiSync to handle selection change with proper refresh order.
+        // Only the selection changed, so the lists are not rebuilt: the region
+        // list just follows the selection and the group list is unaffected.
         CanvasUiSync::handleSelectionChanged(
             selectedRegions,
             canvas->getPrimarySelectedRegion(),
             documentState,
             [canvas]() { if (canvas) canvas->invalidateCoordinateCache(); },
-            [mainWindow]() { if (mainWindow) mainWindow->updateRegionListBox(); },
-            [mainWindow]() { if (mainWindow) mainWindow->updateGroupListBox(); },
-            [canvas]() { if (canvas) canvas->update(); },
+            [sidePanelWidget, selectedRegions]() { if (sidePanelWidget) sidePanelWidget->syncRegionSelection(selectedRegions); },
+            nullptr,
+            [canvas]() { if (canvas) canvas->invalidateLayer(); },
             [sidePanelWidget](const QString& regionName, const QString& color, const QString& group,
                               const QList<QString>& availableGroups, const QString& regionType,
                               const QString& percentageFill, double x1, double y1, double x2, double y2) {
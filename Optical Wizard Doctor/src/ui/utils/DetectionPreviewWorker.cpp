@@ -0,0 +1,116 @@
+#include "DetectionPreviewWorker.h"
+#include "../../utils/DetectionPreview.h"
+#include "../../utils/PageAnalysisCache.h"
+#include "../../utils/TraceRecorder.h"
+#include <QtCore/QMetaObject>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <atomic>
+#include <cstdio>
+
+namespace ocr_orc {
+
+struct DetectionPreviewWorker::State {
+    std::atomic<int> currentId{0};            // Bumped by requestPreview()/cancel() to invalidate older requests
+    QMutex ownerMutex;                        // Held while a job posts its result
+    DetectionPreviewWorker* owner = nullptr;  // Cleared by the worker's destructor
+    
+    bool isCurrent(int requestId) const { return currentId.load() == requestId; }
+};
+
+namespace {
+
+// Single thread, so previews never run concurrently. Outlives the workers,
+// so destroying one never waits for the preview it has running.
+QThreadPool& previewPool() {
+    static QThreadPool pool;
+    static const bool configured = [] {
+        pool.setMaxThreadCount(1);
+        return true;
+    }();
+    Q_UNUSED(configured);
+    return pool;
+}
+
+} // namespace
+
+DetectionPreviewWorker::DetectionPreviewWorker(QObject* parent)
+    : QObject(parent)
+    , state(std::make_shared<State>())
+{
+    state->owner = this;
+}
+
+DetectionPreviewWorker::~DetectionPreviewWorker() {
+    // The running job keeps its preview alive and stops at its next check (or
+    // after prepare(), which cannot be interrupted). It posts nothing once the
+    // owner is cleared, and results already posted die with this object.
+    cancel();
+    QMutexLocker locker(&state->ownerMutex);
+    state->owner = nullptr;
+}
+
+void DetectionPreviewWorker::setPage(const QImage& page, const QImage& colorReference) {
+    cancel();
+    preview = page.isNull() ? nullptr : std::make_shared<DetectionPreview>(page);
+    if (preview) {
+        preview->setColorReference(colorReference);
+    }
+    
+    // Reuse full-page OCR from the background analysis started at PDF load
+    QList<OCRTextRegion> cachedOcr;
+    if (preview && PageAnalysisCache::instance().lookupOcr(PageAnalysisCache::pageKey(page),
+                                                           OcrTextExtractor::TWO_TIER_RECOGNITION, cachedOcr)) {
+        preview->setOcrRegions(cachedOcr, page.size());
+    }
+}
+
+int DetectionPreviewWorker::requestPreview(const DetectionParameters& params) {
+    const int requestId = state->currentId.fetch_add(1) + 1;
+    if (!preview) {
+        return requestId;
+    }
+    
+    // Jobs of superseded requests return at their first check, so the queue is not cleared
+    std::shared_ptr<DetectionPreview> target = preview;
+    std::shared_ptr<State> shared = state;
+    previewPool().start([shared, requestId, params, target]() {
+        static thread_local bool named = false;
+        if (!named) {
+            TraceRecorder::instance().setCurrentThreadName("DetectionPreviewWorker");
+            named = true;
+        }
+    
+        if (!shared->isCurrent(requestId)) return;
+    
+        const bool firstRun = !target->isPrepared();
+        DetectionPreview::Result result = target->run(params, [shared, requestId]() { return !shared->isCurrent(requestId); });
+        if (result.cancelled || !shared->isCurrent(requestId)) {
+            return;
+        }
+        if (firstRun) {
+            fprintf(stderr, "[DetectionPreviewWorker] Preview %d ready after preparing the page\n", requestId);
+            fflush(stderr);
+        }
+    
+        QImage thumbnail = target->getThumbnail();
+        QMutexLocker locker(&shared->ownerMutex);
+        DetectionPreviewWorker* owner = shared->owner;
+        if (!owner) {
+            return;
+        }
+        QMetaObject::invokeMethod(owner, [owner, shared, requestId, thumbnail, result]() {
+            if (shared->isCurrent(requestId)) {
+                emit owner->previewReady(requestId, thumbnail, result.fields, result.checkboxes, result.elapsedMs);
+            }
+        }, Qt::QueuedConnection);
+    });
+    
+    return requestId;
+}
+
+void DetectionPreviewWorker::cancel() {
+    state->currentId.fetch_add(1);
+}
+
+} // namespace ocr_orc
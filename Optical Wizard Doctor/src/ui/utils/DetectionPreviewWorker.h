@@ -0,0 +1,77 @@
+#ifndef DETECTION_PREVIEW_WORKER_H
+#define DETECTION_PREVIEW_WORKER_H
+
+#include "../components/dialogs/MagicDetectParamsDialog.h"
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
+#include <memory>
+
+namespace ocr_orc {
+
+class DetectionPreview;
+
+/**
+ * @brief Runs DetectionPreview in the background for the parameters dialog
+ *
+ * Requests run one at a time on a thread pool shared by all workers. Each
+ * request supersedes the previous one: queued requests return without
+ * running, the running one stops at its next cancellation check, and results
+ * of superseded requests are never emitted. Stages a superseded request
+ * completed stay cached.
+ *
+ * Jobs hold their own reference to the preview, so destroying the worker
+ * never waits for a running job (whose first request may be inside the
+ * uncancellable prepare()); the job's result is simply dropped.
+ */
+class DetectionPreviewWorker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit DetectionPreviewWorker(QObject* parent = nullptr);
+    ~DetectionPreviewWorker();
+    
+    /**
+     * @brief Set the page to preview
+     *
+     * The first request for a page also prepares it (OCR, rectangles,
+     * candidate fields), so it takes much longer than later ones.
+     * @param page Page to preview (the detection raster)
+     * @param colorReference Colour raster of the same page for classification, or null
+     */
+    void setPage(const QImage& page, const QImage& colorReference = QImage());
+    
+    /**
+     * @brief Preview a parameter set, superseding any earlier request
+     * @return Id of this request (passed back in previewReady())
+     */
+    int requestPreview(const DetectionParameters& params);
+    
+    /**
+     * @brief Abandon the current request (no further signals are emitted for it)
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief Emitted when a preview finishes
+     * @param requestId Id returned by requestPreview()
+     * @param thumbnail Page thumbnail the overlay coordinates refer to
+     * @param fields Detected fields, in thumbnail pixels
+     * @param checkboxes Detected checkboxes, in thumbnail pixels
+     * @param elapsedMs Time spent in the preview stages
+     */
+    void previewReady(int requestId, const QImage& thumbnail, const QList<QRect>& fields,
+                      const QList<QRect>& checkboxes, qint64 elapsedMs);
+
+private:
+    struct State;
+    
+    std::shared_ptr<DetectionPreview> preview;  // GUI thread only; each job keeps its own reference
+    std::shared_ptr<State> state;               // Request id and owner, shared with running jobs
+};
+
+} // namespace ocr_orc
+
+#endif // DETECTION_PREVIEW_WORKER_H
@@ -1,5 +1,6 @@
 #include "DetectionWorker.h"
 #include "../../utils/RegionDetector.h"
+#include "../../utils/TraceRecorder.h"
 #include <QtCore/QDebug>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QCoreApplication>
@@ -28,12 +29,33 @@ DetectionWorker::DetectionWorker(QObject* parent)
     progressTimer->setSingleShot(false);
     progressTimer->setInterval(5000); // Update every 5 seconds
     connect(progressTimer, &QTimer::timeout, this, &DetectionWorker::onProgressUpdate);
+    
+    // Layers are published on the worker thread; the signal is queued to the UI
+    progressChannel.setListener([this](const PartialDetectionLayer& layer) {
+        fprintf(stderr, "[DetectionWorker] Partial result: %s - %lld regions after %lld ms\n",
+                PartialDetectionLayer::kindName(layer.kind).toLocal8Bit().constData(),
+                (long long)layer.regions.size(), layer.elapsedMs);
+        fflush(stderr);
+        emit partialResultReady(layer);
+    });
+}
+
+void DetectionWorker::cancelDetection() {
+    progressChannel.requestCancel();
+}
+
+void DetectionWorker::beginDetection() {
+    progressChannel.reset();
 }
 
 void DetectionWorker::setDetectionParameters(const DetectionParameters& params) {
     detectionParams = params;
 }
 
+void DetectionWorker::setColorReference(const QImage& page) {
+    colorReference = page;
+}
+
 void DetectionWorker::detectRegions(const QImage& image, const QString& method) {
     fprintf(stderr, "[DetectionWorker::detectRegions] ========== DETECTION WORKER START ==========\n");
     fprintf(stderr, "[DetectionWorker::detectRegions] Entry - method: %s\n", method.toLocal8Bit().constData());
@@ -136,6 +158,11 @@ void DetectionWorker::detectRegions(const QImage& image, const QString& method)
         QElapsedTimer detectionTimer;
         detectionTimer.start();
         
+        // Runtime tracing: label this thread so per-thread lanes are readable in the trace viewer
+        if (TraceRecorder::isEnabled()) {
+            TraceRecorder::instance().setCurrentThreadName("DetectionWorker");
+        }
+        
         // Since OCR blocks the thread, we'll use a different approach:
         // Emit progress updates manually at key points in the OCR pipeline
         // The timer approach won't work because the event loop is blocked
@@ -152,10 +179,21 @@ void DetectionWorker::detectRegions(const QImage& image, const QString& method)
             fprintf(stderr, "  - Standalone checkbox detection: %s\n",
                     detectionParams.enableStandaloneCheckboxDetection ? "ENABLED" : "DISABLED");
             fflush(stderr);
-            result = detector->detectRegions(image, method, detectionParams);
+            {
+                TraceSpan workerSpan("DetectionWorker::detectRegions", "detection");
+                workerSpan.setArg("method", method);
+                detector->setProgressChannel(&progressChannel);
+                detector->setColorReference(colorReference);
+                result = detector->detectRegions(image, method, detectionParams);
+                workerSpan.setArg("regions_detected", result.totalDetected);
+            }
             fprintf(stderr, "[DetectionWorker::detectRegions] ✓ detector->detectRegions() returned\n");
             fflush(stderr);
             
+            if (TraceRecorder::isEnabled()) {
+                TraceRecorder::instance().exportToDefaultLocation("detection");
+            }
+            
             // Stop progress timer now that OCR is done
             progressTimer->stop();
             fprintf(stderr, "[DetectionWorker::detectRegions] Stopped progress timer\n");
@@ -183,6 +221,13 @@ void DetectionWorker::detectRegions(const QImage& image, const QString& method)
             return;
         }
         
+        if (progressChannel.isCancelled()) {
+            fprintf(stderr, "[DetectionWorker::detectRegions] ========== DETECTION WORKER CANCELLED ==========\n");
+            fflush(stderr);
+            emit detectionCancelled();
+            return;
+        }
+        
         fprintf(stderr, "[DetectionWorker::detectRegions] Step 5: Emitting progress (90%%)...\n");
         fflush(stderr);
         emit detectionProgress(90, "Finalizing results...");
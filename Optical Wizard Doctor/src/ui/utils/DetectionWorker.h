@@ -7,6 +7,7 @@
 #include <QtCore/QElapsedTimer>
 #include <QtGui/QImage>
 #include "../../utils/RegionDetector.h"
+#include "../../utils/DetectionProgressChannel.h"
 #include "../components/dialogs/MagicDetectParamsDialog.h"
 
 namespace ocr_orc {
@@ -15,7 +16,9 @@ namespace ocr_orc {
  * @brief Worker thread for running region detection in background
  * 
  * Prevents UI freezing during detection operations by running
- * detection algorithms in a separate thread.
+ * detection algorithms in a separate thread. OCR-first runs stream
+ * intermediate layers through partialResultReady() and can be stopped
+ * early with cancelDetection().
  */
 class DetectionWorker : public QObject {
     Q_OBJECT
@@ -23,6 +26,24 @@ class DetectionWorker : public QObject {
 public:
     explicit DetectionWorker(QObject* parent = nullptr);
     ~DetectionWorker() = default;
+    
+    /**
+     * @brief Stop the running detection at its next milestone
+     *
+     * Called directly from the UI thread (the worker thread is busy with the
+     * run, so a queued slot would only arrive after it finished). The run
+     * ends with detectionCancelled() instead of detectionComplete().
+     */
+    void cancelDetection();
+    
+    /**
+     * @brief Start a new run: clear the previous run's layers and cancellation
+     *
+     * Call from the UI thread before queuing detectRegions(), so a
+     * cancelDetection() made before the worker thread picks the run up
+     * still stops it.
+     */
+    void beginDetection();
 
 public slots:
     /**
@@ -31,6 +52,15 @@ public slots:
      */
     void setDetectionParameters(const DetectionParameters& params);
     
+    /**
+     * @brief Set the colour raster of the page (called before detectRegions)
+     *
+     * detectRegions() gets the gray detection raster; classification reads
+     * colour from this page instead.
+     * @param page Display raster of the same page, or null
+     */
+    void setColorReference(const QImage& page);
+    
     /**
      * @brief Detect regions in an image (runs in worker thread)
      * @param image Source image to analyze
@@ -52,6 +82,17 @@ signals:
      */
     void detectionComplete(const DetectionResult& result);
     
+    /**
+     * @brief Emitted when an intermediate result set is available
+     * @param layer OCR words, rectangle candidates or consensus regions
+     */
+    void partialResultReady(const PartialDetectionLayer& layer);
+    
+    /**
+     * @brief Emitted instead of detectionComplete when the run was cancelled
+     */
+    void detectionCancelled();
+    
     /**
      * @brief Emitted when detection fails
      * @param error Error message describing the failure
@@ -70,6 +111,8 @@ private:
     QElapsedTimer* ocrTimer;  // Timer to track OCR elapsed time
     int progressCounter;      // Counter for progress updates (20-80%)
     DetectionParameters detectionParams; // Parameters for current detection
+    QImage colorReference;    // Colour raster of the page for classification
+    DetectionProgressChannel progressChannel; // Partial layers out, cancellation in
 };
 
 } // namespace ocr_orc
@@ -0,0 +1,113 @@
+#include "PdfLoadWorker.h"
+#include "../../utils/PdfLoader.h"
+#include "../../utils/TraceRecorder.h"
+#include "../../core/Constants.h"
+#include <QtCore/QMetaObject>
+#include <QtCore/QThread>
+#include <cstdio>
+
+namespace ocr_orc {
+
+PdfLoadWorker::PdfLoadWorker(QObject* parent)
+    : QObject(parent)
+    , currentId(0)
+    , loading(false)
+{
+    pool.setMaxThreadCount(1);
+}
+
+PdfLoadWorker::~PdfLoadWorker() {
+    // Drop queued loads and wait for the one in flight; its queued signals die with this object
+    cancel();
+    pool.clear();
+    pool.waitForDone();
+}
+
+int PdfLoadWorker::startLoad(const QString& filePath) {
+    const int loadId = currentId.fetch_add(1) + 1;
+    loading = true;
+
+    // Anything still queued belongs to a superseded load
+    pool.clear();
+
+    fprintf(stderr, "[PdfLoadWorker::startLoad] Load %d: %s\n",
+            loadId, filePath.toLocal8Bit().constData());
+    fflush(stderr);
+
+    pool.start([this, loadId, filePath]() {
+        static thread_local bool named = false;
+        if (!named) {
+            TraceRecorder::instance().setCurrentThreadName("PdfLoadWorker");
+            named = true;
+        }
+
+        if (!isCurrent(loadId)) return;
+
+        QImage preview;
+        {
+            TraceSpan span("PDF preview render", "pdf");
+            preview = PdfLoader::loadPdfFirstPagePreview(filePath, PdfConstants::PREVIEW_DPI,
+                                                         PdfConstants::DEFAULT_DPI);
+        }
+        if (!preview.isNull() && isCurrent(loadId)) {
+            QMetaObject::invokeMethod(this, [this, loadId, filePath, preview]() {
+                if (isCurrent(loadId)) {
+                    emit previewReady(loadId, filePath, preview);
+                }
+            }, Qt::QueuedConnection);
+        }
+
+        // Skip the expensive render if a newer load was requested meanwhile
+        if (!isCurrent(loadId)) return;
+
+        QImage image;
+        {
+            TraceSpan span("PDF full render", "pdf");
+            image = PdfLoader::loadPdfFirstPage(filePath, PdfConstants::DEFAULT_DPI);
+        }
+        QMetaObject::invokeMethod(this, [this, loadId, filePath, image]() {
+            if (!isCurrent(loadId)) {
+                return;
+            }
+            if (image.isNull()) {
+                loading = false;
+                fprintf(stderr, "[PdfLoadWorker] Load %d failed: %s\n",
+                        loadId, filePath.toLocal8Bit().constData());
+                fflush(stderr);
+                emit loadFailed(loadId, filePath);
+            } else {
+                emit loadComplete(loadId, filePath, image);
+            }
+        }, Qt::QueuedConnection);
+
+        if (image.isNull() || !isCurrent(loadId)) return;
+
+        // Separate gray raster for detection: no ARGB render, no colour conversion later
+        QImage detectionPage;
+        {
+            TraceSpan span("PDF detection render", "pdf");
+            detectionPage = PdfLoader::loadPdfFirstPageGray(filePath, PdfConstants::DETECTION_DPI);
+        }
+        QMetaObject::invokeMethod(this, [this, loadId, filePath, detectionPage]() {
+            if (!isCurrent(loadId)) {
+                return;
+            }
+            loading = false;
+            if (detectionPage.isNull()) {
+                fprintf(stderr, "[PdfLoadWorker] Load %d: grayscale detection render failed, detection will use the display page\n",
+                        loadId);
+                fflush(stderr);
+            }
+            emit detectionPageReady(loadId, filePath, detectionPage);
+        }, Qt::QueuedConnection);
+    });
+
+    return loadId;
+}
+
+void PdfLoadWorker::cancel() {
+    currentId.fetch_add(1);
+    loading = false;
+}
+
+} // namespace ocr_orc
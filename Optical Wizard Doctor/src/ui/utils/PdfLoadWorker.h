@@ -0,0 +1,92 @@
+#ifndef PDF_LOAD_WORKER_H
+#define PDF_LOAD_WORKER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
+#include <atomic>
+
+namespace ocr_orc {
+
+/**
+ * @brief Renders PDF pages in the background so loading never blocks the UI
+ *
+ * Each load first emits a low-DPI preview (scaled to the full-resolution pixel
+ * size), then the full-resolution page, and finally a grayscale render at
+ * PdfConstants::DETECTION_DPI for Magic Detect. Loads run one at a time on a
+ * private thread pool; starting a new load supersedes the previous one, and
+ * results from superseded loads are never emitted.
+ */
+class PdfLoadWorker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PdfLoadWorker(QObject* parent = nullptr);
+    ~PdfLoadWorker();
+
+    /**
+     * @brief Start loading the first page of a PDF
+     * @param filePath Path to the PDF file
+     * @return Id of this load (passed back in every signal)
+     */
+    int startLoad(const QString& filePath);
+
+    /**
+     * @brief Abandon the current load (no further signals are emitted for it)
+     */
+    void cancel();
+
+    /**
+     * @brief Id of the most recent load
+     */
+    int currentLoadId() const { return currentId.load(); }
+
+    /**
+     * @brief True until the most recent load has its detection page, or failed
+     */
+    bool isLoading() const { return loading; }
+
+signals:
+    /**
+     * @brief Emitted when the low-DPI preview is ready
+     * @param loadId Id returned by startLoad()
+     * @param filePath PDF being loaded
+     * @param preview Preview image, same pixel size as the final image
+     */
+    void previewReady(int loadId, const QString& filePath, const QImage& preview);
+
+    /**
+     * @brief Emitted when the full-resolution page is ready
+     * @param loadId Id returned by startLoad()
+     * @param filePath PDF being loaded
+     * @param image Page rendered at PdfConstants::DEFAULT_DPI
+     */
+    void loadComplete(int loadId, const QString& filePath, const QImage& image);
+
+    /**
+     * @brief Emitted after loadComplete() when the grayscale detection page is ready
+     * @param loadId Id returned by startLoad()
+     * @param filePath PDF being loaded
+     * @param page Format_Grayscale8 page at PdfConstants::DETECTION_DPI (null if that render failed)
+     */
+    void detectionPageReady(int loadId, const QString& filePath, const QImage& page);
+
+    /**
+     * @brief Emitted when the PDF could not be rendered
+     * @param loadId Id returned by startLoad()
+     * @param filePath PDF that failed to load
+     */
+    void loadFailed(int loadId, const QString& filePath);
+
+private:
+    bool isCurrent(int loadId) const { return currentId.load() == loadId; }
+
+    QThreadPool pool;            // Single thread so superseded loads never compete for CPU
+    std::atomic<int> currentId;  // Bumped by startLoad()/cancel() to invalidate older loads
+    bool loading;                // GUI-thread only
+};
+
+} // namespace ocr_orc
+
+#endif // PDF_LOAD_WORKER_H
@@ -0,0 +1,157 @@
+#include "SpeculativeAnalysisWorker.h"
+#include "../../utils/PageAnalysisCache.h"
+#include "../../utils/ConcurrencyGovernor.h"
+#include "../../utils/ImageConverter.h"
+#include "../../utils/OcrTextExtractor.h"
+#include "../../utils/RectangleDetector.h"
+#include "../../utils/TraceRecorder.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMetaObject>
+#include <QtCore/QThread>
+#include <cstdio>
+#include <exception>
+
+namespace ocr_orc {
+
+SpeculativeAnalysisWorker::SpeculativeAnalysisWorker(QObject* parent)
+    : QObject(parent)
+    , currentId(0)
+    , running(false)
+    , editsSinceStart(0)
+{
+    pool.setMaxThreadCount(1);
+}
+
+SpeculativeAnalysisWorker::~SpeculativeAnalysisWorker() {
+    // Skip remaining stages and wait for the one in flight; its queued signal dies with this object
+    cancel();
+    pool.clear();
+    pool.waitForDone();
+}
+
+int SpeculativeAnalysisWorker::start(const QImage& page) {
+    const int runId = currentId.fetch_add(1) + 1;
+    editsSinceStart = 0;
+    pool.clear();
+    if (page.isNull()) {
+        running = false;
+        return runId;
+    }
+    running = true;
+    
+    fprintf(stderr, "[SpeculativeAnalysisWorker::start] Run %d: analysing %dx%d page in the background\n",
+            runId, page.width(), page.height());
+    fflush(stderr);
+    
+    pool.start([this, runId, page]() {
+        static thread_local bool named = false;
+        if (!named) {
+            TraceRecorder::instance().setCurrentThreadName("SpeculativeAnalysisWorker");
+            named = true;
+        }
+        // Yield to the UI and to a detection the user starts meanwhile
+        QThread::currentThread()->setPriority(QThread::LowestPriority);
+    
+        if (!isCurrent(runId)) return;
+    
+        // Counted like a detection, so one started meanwhile leaves this run its share
+        ConcurrencyGovernor::DetectionLease lease;
+        TraceSpan runSpan("Speculative page analysis", "speculative");
+        QElapsedTimer timer;
+        timer.start();
+    
+        PageAnalysisCache& cache = PageAnalysisCache::instance();
+        const quint64 key = PageAnalysisCache::pageKey(page);
+        // Same conversion RegionDetector applies to its source page
+        const cv::Mat pageMat = ImageConverter::qImageToDetectionMat(page);
+    
+        // Rectangles first: cheap, and useful even if OCR is cancelled
+        QList<DetectedRectangle> rectangles;
+        if (!cache.lookupRectangles(key, rectangles)) {
+            TraceSpan rectSpan("Speculative rectangle detection", "speculative");
+            // Same settings as RegionDetector's Stage 1.6
+            RectangleDetector rectangleDetector;
+            rectangleDetector.setSensitivity(0.15);
+            rectangleDetector.setMinSize(15, 10);
+            rectangleDetector.setMaxSize(800, 300);
+            rectangles = rectangleDetector.detectRectangles(pageMat);
+            rectSpan.setArg("rectangles_found", rectangles.size());
+            if (isCurrent(runId)) {
+                cache.storeRectangles(key, rectangles);
+            }
+        }
+    
+        if (!isCurrent(runId)) return;
+    
+        // RegionDetector's default recognition mode
+        const OcrTextExtractor::RecognitionMode mode = OcrTextExtractor::TWO_TIER_RECOGNITION;
+        if (cache.beginOcr(key, mode)) {
+            TraceSpan ocrSpan("Speculative OCR", "speculative");
+            try {
+                OcrTextExtractor extractor;
+                // Polled by Tesseract between words. Once a detection waits for this
+                // result the run is finished at normal priority even if cancelled;
+                // otherwise a cancelled run stops at the next word.
+                bool abandoned = false;
+                bool awaited = false;
+                extractor.setCancellationCheck([this, runId, &cache, key, mode, &abandoned, &awaited]() {
+                    if (!abandoned && !awaited && cache.isOcrAwaited(key, mode)) {
+                        awaited = true;
+                        QThread::currentThread()->setPriority(QThread::NormalPriority);
+                    }
+                    abandoned = abandoned || (!awaited && !isCurrent(runId));
+                    return abandoned;
+                });
+                QList<OCRTextRegion> regions = extractor.extractTextRegionsTwoTier(pageMat);
+                ocrSpan.setArg("regions_found", regions.size());
+                ocrSpan.setArg("abandoned", abandoned);
+                if (abandoned) {
+                    cache.abandonOcr(key, mode);
+                } else {
+                    // Kept even if this run was cancelled after a detection started
+                    // waiting: the result is still right for the page. The cache
+                    // drops it if another page took its place.
+                    cache.finishOcr(key, mode, regions);
+                }
+            } catch (const std::exception& e) {
+                fprintf(stderr, "[SpeculativeAnalysisWorker] OCR failed: %s\n", e.what());
+                fflush(stderr);
+                cache.abandonOcr(key, mode);
+            }
+        }
+    
+        const qint64 elapsedMs = timer.elapsed();
+        fprintf(stderr, "[SpeculativeAnalysisWorker] Run %d finished in %lld ms%s\n",
+                runId, (long long)elapsedMs, isCurrent(runId) ? "" : " (cancelled)");
+        fflush(stderr);
+    
+        QMetaObject::invokeMethod(this, [this, runId, elapsedMs]() {
+            if (!isCurrent(runId)) {
+                return;
+            }
+            running = false;
+            emit analysisFinished(runId, elapsedMs);
+        }, Qt::QueuedConnection);
+    });
+    
+    return runId;
+}
+
+void SpeculativeAnalysisWorker::cancel() {
+    currentId.fetch_add(1);
+    running = false;
+}
+
+void SpeculativeAnalysisWorker::noteUserEdit() {
+    if (!running) {
+        return;
+    }
+    if (++editsSinceStart >= HEAVY_EDIT_THRESHOLD) {
+        fprintf(stderr, "[SpeculativeAnalysisWorker] %d edits while analysing - background analysis cancelled\n",
+                editsSinceStart);
+        fflush(stderr);
+        cancel();
+    }
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,84 @@
+#ifndef SPECULATIVE_ANALYSIS_WORKER_H
+#define SPECULATIVE_ANALYSIS_WORKER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
+#include <atomic>
+
+namespace ocr_orc {
+
+/**
+ * @brief Runs the page-only detection stages in the background after a PDF loads
+ *
+ * Users usually look at a freshly loaded page for a while before pressing
+ * Magic Detect. This worker uses that time to run rectangle detection and
+ * OCR at low priority and stores the results in PageAnalysisCache, where
+ * RegionDetector picks them up (a detection started while OCR is still
+ * running waits for it instead of starting a second OCR pass).
+ *
+ * Each run holds a ConcurrencyGovernor::DetectionLease, so a detection
+ * started meanwhile (which may wait for this OCR) is sized to leave it a
+ * share of the cores instead of competing with it.
+ *
+ * cancel() is called when another document is loaded or the user edits
+ * heavily. Rectangle detection, if running, finishes; OCR stops at the next
+ * word through Tesseract's cancel monitor and its reservation is dropped,
+ * so the next page only queues behind a stale run briefly. Once a detection
+ * waits for this run's OCR, the run raises its thread to normal priority and
+ * is no longer cancelled, since the detection needs the result.
+ */
+class SpeculativeAnalysisWorker : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Edits (undo checkpoints) after which a running analysis is abandoned
+     */
+    static const int HEAVY_EDIT_THRESHOLD = 5;
+
+    explicit SpeculativeAnalysisWorker(QObject* parent = nullptr);
+    ~SpeculativeAnalysisWorker();
+
+    /**
+     * @brief Start analysing a page (supersedes any previous page)
+     * @param page Full-resolution page, exactly as it will be passed to detection
+     * @return Id of this run (passed back in analysisFinished())
+     */
+    int start(const QImage& page);
+
+    /**
+     * @brief Abandon the current run; stages not yet started are skipped
+     */
+    void cancel();
+
+    /**
+     * @brief Count a user edit; cancels the run after HEAVY_EDIT_THRESHOLD edits
+     */
+    void noteUserEdit();
+
+    /**
+     * @brief True while the most recent run has not finished or been cancelled
+     */
+    bool isRunning() const { return running; }
+
+signals:
+    /**
+     * @brief Emitted when every stage of a run has been stored in the cache
+     * @param runId Id returned by start()
+     * @param elapsedMs Time the background stages took
+     */
+    void analysisFinished(int runId, qint64 elapsedMs);
+
+private:
+    bool isCurrent(int runId) const { return currentId.load() == runId; }
+
+    QThreadPool pool;            // One thread; a stale run leaves it at its next OCR word
+    std::atomic<int> currentId;  // Bumped by start()/cancel() to invalidate older runs
+    bool running;                // GUI-thread only
+    int editsSinceStart;         // GUI-thread only
+};
+
+} // namespace ocr_orc
+
+#endif // SPECULATIVE_ANALYSIS_WORKER_H
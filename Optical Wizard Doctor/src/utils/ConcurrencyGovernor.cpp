@@ -0,0 +1,169 @@
+#include "ConcurrencyGovernor.h"
+#include "TraceRecorder.h"
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cstdio>
+
+namespace ocr_orc {
+
+namespace {
+    // Leases held by the calling thread; only the outermost one counts
+    thread_local int leaseDepth = 0;
+}
+
+QString ConcurrencyGovernor::Allocation::toString() const {
+    return QString("opencv=%1 tesseract=%2 pool=%3 stages=%4")
+        .arg(opencvThreads).arg(tesseractThreads).arg(globalPoolThreads).arg(stageWorkers);
+}
+
+ConcurrencyGovernor::DetectionLease::DetectionLease()
+    : counted(leaseDepth == 0)
+{
+    leaseDepth++;
+    allocation = counted ? ConcurrencyGovernor::instance().beginDetection()
+                         : ConcurrencyGovernor::instance().currentAllocation();
+}
+
+ConcurrencyGovernor::DetectionLease::~DetectionLease() {
+    leaseDepth--;
+    if (counted) {
+        ConcurrencyGovernor::instance().endDetection();
+    }
+}
+
+ConcurrencyGovernor& ConcurrencyGovernor::instance() {
+    static ConcurrencyGovernor governor;
+    return governor;
+}
+
+ConcurrencyGovernor::ConcurrencyGovernor()
+    : coreCount(std::max(1, QThread::idealThreadCount()))
+    , activeDetections(0)
+    , pinned(false)
+    , applied(false)
+{
+    allocation = computeAllocation(coreCount, 0);
+}
+
+ConcurrencyGovernor::Allocation ConcurrencyGovernor::computeAllocation(int cores, int activeDetections) {
+    cores = std::max(1, cores);
+    
+    Allocation result;
+    result.tesseractThreads = 1;
+    if (activeDetections <= 0) {
+        result.opencvThreads = cores;
+        result.globalPoolThreads = cores;
+        result.stageWorkers = cores;
+        return result;
+    }
+    
+    const int share = std::max(1, cores / activeDetections);
+    result.stageWorkers = share;
+    result.opencvThreads = share;
+    result.globalPoolThreads = std::max(std::min(cores, MIN_GLOBAL_POOL_THREADS), cores - share * activeDetections);
+    return result;
+}
+
+void ConcurrencyGovernor::configureFromEnvironment() {
+    QMutexLocker locker(&mutex);
+    
+    // OCR_ORC_THREADS=N pins a deterministic allocation for N cores
+    QByteArray env = qgetenv("OCR_ORC_THREADS");
+    if (!env.isEmpty()) {
+        bool ok = false;
+        int threads = QString::fromLocal8Bit(env).trimmed().toInt(&ok);
+        if (ok && threads > 0) {
+            pinned = true;
+            pinnedAllocation = computeAllocation(threads, 1);
+        } else {
+            fprintf(stderr, "[ConcurrencyGovernor] Ignoring OCR_ORC_THREADS='%s' (expected a positive integer)\n",
+                    env.constData());
+            fflush(stderr);
+        }
+    }
+    
+    rebalanceLocked("startup", activeDetections == 0);
+}
+
+void ConcurrencyGovernor::pin(const Allocation& fixed) {
+    QMutexLocker locker(&mutex);
+    pinned = true;
+    pinnedAllocation = fixed;
+    pinnedAllocation.opencvThreads = std::max(1, pinnedAllocation.opencvThreads);
+    pinnedAllocation.tesseractThreads = std::max(1, pinnedAllocation.tesseractThreads);
+    pinnedAllocation.globalPoolThreads = std::max(1, pinnedAllocation.globalPoolThreads);
+    pinnedAllocation.stageWorkers = std::max(1, pinnedAllocation.stageWorkers);
+    rebalanceLocked("pin", activeDetections == 0);
+}
+
+void ConcurrencyGovernor::unpin() {
+    QMutexLocker locker(&mutex);
+    pinned = false;
+    rebalanceLocked("unpin", activeDetections == 0);
+}
+
+bool ConcurrencyGovernor::isPinned() const {
+    QMutexLocker locker(&mutex);
+    return pinned;
+}
+
+ConcurrencyGovernor::Allocation ConcurrencyGovernor::currentAllocation() const {
+    QMutexLocker locker(&mutex);
+    return allocation;
+}
+
+int ConcurrencyGovernor::getActiveDetections() const {
+    QMutexLocker locker(&mutex);
+    return activeDetections;
+}
+
+ConcurrencyGovernor::Allocation ConcurrencyGovernor::beginDetection() {
+    QMutexLocker locker(&mutex);
+    activeDetections++;
+    // The caller is not inside parallel_for yet; anyone else may be
+    rebalanceLocked("detection started", activeDetections == 1);
+    return allocation;
+}
+
+void ConcurrencyGovernor::endDetection() {
+    QMutexLocker locker(&mutex);
+    activeDetections = std::max(0, activeDetections - 1);
+    rebalanceLocked("detection finished", activeDetections == 0);
+}
+
+void ConcurrencyGovernor::rebalanceLocked(const char* reason, bool opencvSafe) {
+    Allocation target = pinned ? pinnedAllocation : computeAllocation(coreCount, activeDetections);
+    if (applied && target == allocation) {
+        OCR_ORC_TRACE_COUNTER("active_detections", activeDetections);
+        return;
+    }
+    applyLocked(target, reason, opencvSafe);
+}
+
+void ConcurrencyGovernor::applyLocked(const Allocation& target, const char* reason, bool opencvSafe) {
+    Allocation next = target;
+    if (opencvSafe) {
+        cv::setNumThreads(next.opencvThreads);
+    } else {
+        // Resizing OpenCV's pool under a running parallel_for is not safe; keep the old size
+        next.opencvThreads = allocation.opencvThreads;
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(next.globalPoolThreads);
+    allocation = next;
+    applied = true;
+    
+    fprintf(stderr, "[ConcurrencyGovernor] %s: %s (%d cores, %d active detection(s)%s%s)\n",
+            reason, qPrintable(next.toString()), coreCount, activeDetections, pinned ? ", pinned" : "",
+            opencvSafe ? "" : ", OpenCV resize deferred");
+    fflush(stderr);
+    
+    OCR_ORC_TRACE_COUNTER("active_detections", activeDetections);
+    OCR_ORC_TRACE_COUNTER("threads_opencv", next.opencvThreads);
+    OCR_ORC_TRACE_COUNTER("threads_tesseract", next.tesseractThreads);
+    OCR_ORC_TRACE_COUNTER("threads_global_pool", next.globalPoolThreads);
+    OCR_ORC_TRACE_COUNTER("threads_stage_workers", next.stageWorkers);
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,165 @@
+#ifndef CONCURRENCY_GOVERNOR_H
+#define CONCURRENCY_GOVERNOR_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+namespace ocr_orc {
+
+/**
+ * @brief Process-wide thread budget shared by the parallel subsystems
+ *
+ * OpenCV's parallel_for pool, Tesseract's OpenMP threads, the global
+ * QThreadPool and the detection stage graph would otherwise each size
+ * themselves to the full core count and oversubscribe the machine while a
+ * detection runs. The governor splits the cores between them based on how
+ * many detections are active and applies the result:
+ * - OpenCV: cv::setNumThreads() (only while no other detection can be
+ *   inside parallel_for; otherwise the resize waits for a safe point)
+ * - Tesseract: advisory only. The OpenMP runtime reads OMP_THREAD_LIMIT
+ *   when it loads, before main(), so the governor cannot change it; set it
+ *   in the launching environment. tesseractThreads records the budget the
+ *   other shares assume (one thread per OCR call)
+ * - Global QThreadPool: setMaxThreadCount()
+ * - Stage graph: read by RegionDetector when it builds its TaskGraph
+ *
+ * Every change is logged and recorded as trace counters. pin() (or
+ * OCR_ORC_THREADS) fixes the allocation regardless of workload so batch
+ * runs are reproducible across machines and load.
+ */
+class ConcurrencyGovernor {
+public:
+    /**
+     * @brief Threads granted to each subsystem
+     */
+    struct Allocation {
+        int opencvThreads = 1;      // cv::setNumThreads()
+        int tesseractThreads = 1;   // Advisory; not applied (see class doc)
+        int globalPoolThreads = 1;  // QThreadPool::globalInstance()
+        int stageWorkers = 1;       // Workers per detection TaskGraph
+    
+        bool operator==(const Allocation& other) const = default;
+    
+        /**
+         * @brief One-line summary for logs (e.g. "opencv=8 tesseract=1 pool=2 stages=8")
+         */
+        QString toString() const;
+    };
+    
+    /**
+     * @brief RAII registration of a running detection
+     *
+     * Nested leases on one thread (e.g. the OCR-first fallback calling
+     * detectRegions()) count as a single detection.
+     */
+    class DetectionLease {
+    public:
+        DetectionLease();
+        ~DetectionLease();
+    
+        DetectionLease(const DetectionLease&) = delete;
+        DetectionLease& operator=(const DetectionLease&) = delete;
+    
+        /**
+         * @brief Allocation in effect when the lease was taken
+         */
+        const Allocation& getAllocation() const { return allocation; }
+    
+    private:
+        bool counted;
+        Allocation allocation;
+    };
+    
+    /**
+     * @brief Get the process-wide governor
+     */
+    static ConcurrencyGovernor& instance();
+    
+    /**
+     * @brief Split a core budget between the subsystems
+     *
+     * Idle: OpenCV and the global pool get every core. While detections run,
+     * each gets an equal share of the cores as stage workers, and OpenCV gets
+     * the same share (every core for a single detection, whose stages are
+     * mostly waiting on OCR while one OpenCV pass runs). The global pool keeps
+     * whatever the detections leave, but never less than
+     * MIN_GLOBAL_POOL_THREADS. Tesseract always gets one OpenMP thread: OCR
+     * is one stage of the graph and its OpenMP threads spin-wait between
+     * layers.
+     *
+     * @param cores Cores available (values below 1 count as 1)
+     * @param activeDetections Running detections
+     */
+    static Allocation computeAllocation(int cores, int activeDetections);
+    
+    static constexpr int MIN_GLOBAL_POOL_THREADS = 2;  // Thumbnails and other UI work keep running
+    
+    /**
+     * @brief Apply OCR_ORC_THREADS and the initial allocation
+     *
+     * OCR_ORC_THREADS=N pins the allocation for N cores and one detection.
+     * Call once at startup, before any OCR runs.
+     */
+    void configureFromEnvironment();
+    
+    /**
+     * @brief Fix the allocation regardless of workload (batch mode)
+     */
+    void pin(const Allocation& allocation);
+    
+    /**
+     * @brief Return to workload-based allocation
+     */
+    void unpin();
+    
+    bool isPinned() const;
+    
+    /**
+     * @brief Allocation currently applied
+     */
+    Allocation currentAllocation() const;
+    
+    /**
+     * @brief Detections currently holding a lease
+     */
+    int getActiveDetections() const;
+    
+    /**
+     * @brief Cores the workload-based allocation splits (QThread::idealThreadCount())
+     */
+    int getCoreCount() const { return coreCount; }
+
+private:
+    ConcurrencyGovernor();
+    ConcurrencyGovernor(const ConcurrencyGovernor&) = delete;
+    ConcurrencyGovernor& operator=(const ConcurrencyGovernor&) = delete;
+    
+    Allocation beginDetection();
+    void endDetection();
+    
+    /**
+     * @brief Recompute and apply if changed (mutex must be held)
+     * @param opencvSafe No other thread can be inside an OpenCV parallel_for
+     */
+    void rebalanceLocked(const char* reason, bool opencvSafe);
+    
+    /**
+     * @brief Push an allocation to the subsystems (mutex must be held)
+     *
+     * Without opencvSafe the OpenCV thread count is left as it is and
+     * resized at the next safe rebalance.
+     */
+    void applyLocked(const Allocation& allocation, const char* reason, bool opencvSafe);
+    
+    mutable QMutex mutex;
+    int coreCount;
+    int activeDetections;
+    bool pinned;
+    bool applied;  // False until the first applyLocked()
+    Allocation pinnedAllocation;
+    Allocation allocation;
+};
+
+} // namespace ocr_orc
+
+#endif // CONCURRENCY_GOVERNOR_H
@@ -0,0 +1,130 @@
+#include "DetectedRegionBatch.h"
+#include "RegionDetector.h"  // Full definition needed here
+#include <algorithm>
+
+namespace ocr_orc {
+
+namespace {
+
+// Names for the fixed RegionTypeCode values, in enum order
+const char* const KNOWN_TYPE_NAMES[REGION_TYPE_FIRST_CUSTOM] = {
+    "unknown",
+    "letters",
+    "numbers",
+    "mixed",
+    "checkbox",
+    "cell",
+    "form_field",
+    "text_input",
+    "text_line",
+    "text_block"
+};
+
+} // namespace
+
+DetectedRegionBatch::DetectedRegionBatch() {
+}
+
+DetectedRegionBatch::DetectedRegionBatch(const QList<DetectedRegion>& regions) {
+    assign(regions);
+}
+
+void DetectedRegionBatch::clear() {
+    x1Column.clear();
+    y1Column.clear();
+    x2Column.clear();
+    y2Column.clear();
+    centerXColumn.clear();
+    centerYColumn.clear();
+    confidenceColumn.clear();
+    typeColumn.clear();
+    groupColumn.clear();
+    customTypeNames.clear();
+}
+
+void DetectedRegionBatch::assign(const QList<DetectedRegion>& regions) {
+    clear();
+    
+    const size_t count = static_cast<size_t>(regions.size());
+    x1Column.reserve(count);
+    y1Column.reserve(count);
+    x2Column.reserve(count);
+    y2Column.reserve(count);
+    centerXColumn.reserve(count);
+    centerYColumn.reserve(count);
+    confidenceColumn.reserve(count);
+    typeColumn.reserve(count);
+    groupColumn.reserve(count);
+    
+    for (const DetectedRegion& region : regions) {
+        append(region);
+    }
+}
+
+int DetectedRegionBatch::append(const DetectedRegion& region) {
+    x1Column.push_back(region.coords.x1);
+    y1Column.push_back(region.coords.y1);
+    x2Column.push_back(region.coords.x2);
+    y2Column.push_back(region.coords.y2);
+    centerXColumn.push_back((region.coords.x1 + region.coords.x2) / 2.0);
+    centerYColumn.push_back((region.coords.y1 + region.coords.y2) / 2.0);
+    confidenceColumn.push_back(region.confidence);
+    typeColumn.push_back(encodeType(region.inferredType));
+    groupColumn.push_back(region.suggestedGroup.isEmpty() ? 0 : 1);
+    return size() - 1;
+}
+
+int DetectedRegionBatch::encodeType(const QString& type) {
+    for (int code = 0; code < REGION_TYPE_FIRST_CUSTOM; ++code) {
+        if (type == QLatin1String(KNOWN_TYPE_NAMES[code])) {
+            return code;
+        }
+    }
+    
+    int custom = customTypeNames.indexOf(type);
+    if (custom < 0) {
+        custom = static_cast<int>(customTypeNames.size());
+        customTypeNames.append(type);
+    }
+    return REGION_TYPE_FIRST_CUSTOM + custom;
+}
+
+QString DetectedRegionBatch::typeName(int code) const {
+    if (code >= 0 && code < REGION_TYPE_FIRST_CUSTOM) {
+        return QString::fromLatin1(KNOWN_TYPE_NAMES[code]);
+    }
+    int custom = code - REGION_TYPE_FIRST_CUSTOM;
+    if (custom >= 0 && custom < customTypeNames.size()) {
+        return customTypeNames[custom];
+    }
+    return QString();
+}
+
+void DetectedRegionBatch::sortIndicesByCenterX(int* begin, int* end) const {
+    std::stable_sort(begin, end, [this](int a, int b) {
+        return centerXColumn[a] < centerXColumn[b];
+    });
+}
+
+void DetectedRegionBatch::sortIndicesByCenterY(int* begin, int* end) const {
+    std::stable_sort(begin, end, [this](int a, int b) {
+        return centerYColumn[a] < centerYColumn[b];
+    });
+}
+
+QList<QList<DetectedRegion>> DetectedRegionBatch::materialize(const QList<DetectedRegion>& regions,
+                                                              const RegionIndexClusters& clusters) {
+    QList<QList<DetectedRegion>> result;
+    result.reserve(clusters.clusterCount());
+    for (int c = 0; c < clusters.clusterCount(); ++c) {
+        QList<DetectedRegion> cluster;
+        cluster.reserve(clusters.clusterSize(c));
+        for (const int* it = clusters.clusterBegin(c); it != clusters.clusterEnd(c); ++it) {
+            cluster.append(regions[*it]);
+        }
+        result.append(cluster);
+    }
+    return result;
+}
+
+} // namespace ocr_orc
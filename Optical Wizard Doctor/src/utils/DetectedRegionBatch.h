@@ -0,0 +1,145 @@
+#ifndef DETECTED_REGION_BATCH_H
+#define DETECTED_REGION_BATCH_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <vector>
+
+namespace ocr_orc {
+
+// Forward declaration
+struct DetectedRegion;
+
+/**
+ * @brief Compact type codes for DetectedRegion::inferredType
+ *
+ * The known vocabulary has fixed codes; any other string is interned by the
+ * batch it appears in (codes from REGION_TYPE_FIRST_CUSTOM upwards), so two
+ * codes are equal exactly when the strings are.
+ */
+enum RegionTypeCode {
+    REGION_TYPE_UNKNOWN = 0,
+    REGION_TYPE_LETTERS,
+    REGION_TYPE_NUMBERS,
+    REGION_TYPE_MIXED,
+    REGION_TYPE_CHECKBOX,
+    REGION_TYPE_CELL,
+    REGION_TYPE_FORM_FIELD,
+    REGION_TYPE_TEXT_INPUT,
+    REGION_TYPE_TEXT_LINE,
+    REGION_TYPE_TEXT_BLOCK,
+    REGION_TYPE_FIRST_CUSTOM
+};
+
+/**
+ * @brief Clusters of region indices in one flat buffer
+ *
+ * Cluster c holds indices[offsets[c] .. offsets[c + 1]). Clearing keeps the
+ * capacity for the next call on the same owner.
+ */
+struct RegionIndexClusters {
+    std::vector<int> indices;
+    std::vector<int> offsets;  // size() == clusterCount() + 1 once non-empty
+    
+    void clear() { indices.clear(); offsets.clear(); }
+    int clusterCount() const { return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1; }
+    int clusterSize(int c) const { return offsets[c + 1] - offsets[c]; }
+    const int* clusterBegin(int c) const { return indices.data() + offsets[c]; }
+    const int* clusterEnd(int c) const { return indices.data() + offsets[c + 1]; }
+};
+
+/**
+ * @brief Structure-of-arrays view of a list of detected regions
+ *
+ * Post-processing (clustering, validation, group inference) only
+ * reads geometry, confidence, type and whether a group was suggested. The
+ * batch keeps those in contiguous columns so those stages work on indices
+ * into the source list instead of copying DetectedRegion (and its strings).
+ * Row i always describes regions[i] of the list it was assigned from.
+ *
+ * assign() reuses column capacity. Detection builds its batches per run, so
+ * the saving is in not copying regions, not in avoiding allocation.
+ */
+class DetectedRegionBatch {
+public:
+    DetectedRegionBatch();
+    explicit DetectedRegionBatch(const QList<DetectedRegion>& regions);
+    ~DetectedRegionBatch() = default;
+    
+    /**
+     * @brief Refill the columns from a region list (keeps capacity)
+     * @param regions Source regions
+     */
+    void assign(const QList<DetectedRegion>& regions);
+    
+    /**
+     * @brief Append one region as a new row
+     * @param region Region to append
+     * @return Index of the new row
+     */
+    int append(const DetectedRegion& region);
+    
+    /**
+     * @brief Remove all rows (keeps capacity)
+     */
+    void clear();
+    
+    int size() const { return static_cast<int>(x1Column.size()); }
+    bool isEmpty() const { return x1Column.empty(); }
+    
+    // Row accessors (normalized coordinates)
+    double x1(int i) const { return x1Column[i]; }
+    double y1(int i) const { return y1Column[i]; }
+    double x2(int i) const { return x2Column[i]; }
+    double y2(int i) const { return y2Column[i]; }
+    double centerX(int i) const { return centerXColumn[i]; }
+    double centerY(int i) const { return centerYColumn[i]; }
+    double width(int i) const { return x2Column[i] - x1Column[i]; }
+    double height(int i) const { return y2Column[i] - y1Column[i]; }
+    double confidence(int i) const { return confidenceColumn[i]; }
+    int typeCode(int i) const { return typeColumn[i]; }
+    bool hasSuggestedGroup(int i) const { return groupColumn[i] != 0; }
+    
+    /**
+     * @brief Get the inferredType string for a type code of this batch
+     */
+    QString typeName(int code) const;
+    
+    /**
+     * @brief Sort indices by region center X (stable)
+     */
+    void sortIndicesByCenterX(int* begin, int* end) const;
+    
+    /**
+     * @brief Sort indices by region center Y (stable)
+     */
+    void sortIndicesByCenterY(int* begin, int* end) const;
+    
+    /**
+     * @brief Copy the regions of each cluster out of the source list
+     * @param regions List the batch was assigned from
+     * @param clusters Index clusters into that list
+     * @return One region list per cluster
+     */
+    static QList<QList<DetectedRegion>> materialize(const QList<DetectedRegion>& regions,
+                                                    const RegionIndexClusters& clusters);
+
+private:
+    int encodeType(const QString& type);
+    
+    std::vector<double> x1Column;
+    std::vector<double> y1Column;
+    std::vector<double> x2Column;
+    std::vector<double> y2Column;
+    std::vector<double> centerXColumn;
+    std::vector<double> centerYColumn;
+    std::vector<double> confidenceColumn;
+    std::vector<int> typeColumn;
+    std::vector<unsigned char> groupColumn;  // 1 if suggestedGroup is non-empty
+    QStringList customTypeNames;             // Interned names for codes >= REGION_TYPE_FIRST_CUSTOM
+};
+
+} // namespace ocr_orc
+
+#endif // DETECTED_REGION_BATCH_H
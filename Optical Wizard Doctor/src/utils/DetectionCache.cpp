@@ -60,8 +60,9 @@ QString DetectionCache::generateImageHash(const cv::Mat& image) const
             int x = samplePoints[i][0];
             int y = samplePoints[i][1];
             if (x < image.cols && y < image.rows) {
-                cv::Vec3b pixel = image.at<cv::Vec3b>(y, x);
-                QByteArray pixelData(reinterpret_cast<const char*>(&pixel), sizeof(cv::Vec3b));
+                // Any channel count: detection pages may be single-channel gray
+                const uchar* pixel = image.ptr<uchar>(y) + x * image.elemSize();
+                QByteArray pixelData(reinterpret_cast<const char*>(pixel), static_cast<int>(image.elemSize()));
                 hash.addData(pixelData);
             }
         }
@@ -0,0 +1,183 @@
+#include "DetectionContext.h"
+#include "ImageConverter.h"
+#include "../ui/components/dialogs/MagicDetectParamsDialog.h"
+#include <opencv2/imgproc.hpp>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+#include <cstdio>
+
+namespace ocr_orc {
+
+namespace {
+
+// Wrap a colour page for saturation sampling without copying when its layout allows.
+// Saturation does not depend on channel order, so RGB and BGR layouts both work.
+cv::Mat colorSamplingMat(const QImage& page)
+{
+    uchar* bits = const_cast<uchar*>(page.constBits());
+    switch (page.format()) {
+        case QImage::Format_RGB888:
+        case QImage::Format_BGR888:
+            return cv::Mat(page.height(), page.width(), CV_8UC3, bits, page.bytesPerLine());
+        case QImage::Format_RGBX8888:
+        case QImage::Format_RGBA8888:
+            return cv::Mat(page.height(), page.width(), CV_8UC4, bits, page.bytesPerLine());
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+            if (Q_BYTE_ORDER == Q_LITTLE_ENDIAN) {
+                // Bytes are B, G, R, A
+                return cv::Mat(page.height(), page.width(), CV_8UC4, bits, page.bytesPerLine());
+            }
+            break;
+        default:
+            break;
+    }
+    return ImageConverter::qImageToMat(page);
+}
+
+} // namespace
+
+DetectionContext::DetectionContext(const QImage& image, const DetectionParameters& params)
+    : sourceImage(image)
+    , parameters(std::make_unique<DetectionParameters>(params))
+    , documentClassified(false)
+    , documentType(STANDARD_FORM)
+    , conversionCount(0)
+    , classificationCount(0)
+{
+}
+
+DetectionContext::~DetectionContext() = default;
+
+cv::Mat DetectionContext::getSourceBgr()
+{
+    QMutexLocker locker(&mutex);
+    return sourceBgrLocked();
+}
+
+void DetectionContext::setWorkingImage(const cv::Mat& image)
+{
+    QMutexLocker locker(&mutex);
+    workingImage = image;
+    workingGray.release();
+    documentClassified = false;
+    thresholdManager.reset();
+}
+
+cv::Mat DetectionContext::getWorkingImage()
+{
+    QMutexLocker locker(&mutex);
+    return workingImageLocked();
+}
+
+cv::Mat DetectionContext::getWorkingGray()
+{
+    QMutexLocker locker(&mutex);
+    if (workingGray.empty()) {
+        const cv::Mat& working = workingImageLocked();
+        if (working.channels() == 3) {
+            cv::cvtColor(working, workingGray, cv::COLOR_BGR2GRAY);
+            conversionCount++;
+        } else if (working.channels() == 4) {
+            cv::cvtColor(working, workingGray, cv::COLOR_BGRA2GRAY);
+            conversionCount++;
+        } else {
+            workingGray = working;
+        }
+    }
+    return workingGray;
+}
+
+bool DetectionContext::isWorkingImage(const cv::Mat& image)
+{
+    if (image.empty()) {
+        return false;
+    }
+    QMutexLocker locker(&mutex);
+    const cv::Mat& working = workingImageLocked();
+    return image.data == working.data && image.size() == working.size() && image.type() == working.type();
+}
+
+void DetectionContext::setColorReference(const QImage& page)
+{
+    QMutexLocker locker(&mutex);
+    colorReference = page;
+    documentClassified = false;
+    thresholdManager.reset();
+}
+
+DocumentType DetectionContext::getDocumentType()
+{
+    QMutexLocker locker(&mutex);
+    return documentTypeLocked();
+}
+
+AdaptiveThresholdManager DetectionContext::getThresholdManager()
+{
+    QMutexLocker locker(&mutex);
+    if (!thresholdManager) {
+        thresholdManager = std::make_unique<AdaptiveThresholdManager>(documentTypeLocked());
+        thresholdManager->setCustomOverrides(parameters->baseBrightnessThreshold, parameters->edgeDensityThreshold,
+                                             parameters->horizontalEdgeDensityThreshold,
+                                             parameters->verticalEdgeDensityThreshold,
+                                             parameters->iouThreshold, parameters->ocrConfidenceThreshold,
+                                             parameters->horizontalOverfitPercent, parameters->verticalOverfitPercent,
+                                             parameters->brightnessAdaptiveFactor);
+    }
+    return *thresholdManager;
+}
+
+void DetectionContext::setParameters(const DetectionParameters& params)
+{
+    QMutexLocker locker(&mutex);
+    *parameters = params;
+    thresholdManager.reset();
+}
+
+int DetectionContext::getConversionCount() const
+{
+    QMutexLocker locker(&mutex);
+    return conversionCount;
+}
+
+int DetectionContext::getClassificationCount() const
+{
+    QMutexLocker locker(&mutex);
+    return classificationCount;
+}
+
+const cv::Mat& DetectionContext::sourceBgrLocked()
+{
+    if (sourceBgr.empty() && !sourceImage.isNull()) {
+        sourceBgr = ImageConverter::qImageToDetectionMat(sourceImage);
+        if (sourceImage.format() != QImage::Format_Grayscale8) {
+            conversionCount++;
+        }
+    }
+    return sourceBgr;
+}
+
+const cv::Mat& DetectionContext::workingImageLocked()
+{
+    return workingImage.empty() ? sourceBgrLocked() : workingImage;
+}
+
+DocumentType DetectionContext::documentTypeLocked()
+{
+    if (!documentClassified) {
+        DocumentTypeClassifier classifier;
+        const cv::Mat& working = workingImageLocked();
+        if (working.channels() == 1 && !colorReference.isNull()) {
+            classifier.setColorReference(colorSamplingMat(colorReference));
+        }
+        documentType = classifier.classifyDocument(working);
+        documentClassified = true;
+        classificationCount++;
+        fprintf(stderr, "[DetectionContext] Classified page as document type %d\n", static_cast<int>(documentType));
+        fflush(stderr);
+    }
+    return documentType;
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,165 @@
+#ifndef DETECTION_CONTEXT_H
+#define DETECTION_CONTEXT_H
+
+#include "DocumentTypeClassifier.h"
+#include "AdaptiveThresholdManager.h"
+#include "DetectionCache.h"
+#include <opencv2/opencv.hpp>
+#include <QtGui/QImage>
+#include <QtCore/QMutex>
+#include <memory>
+
+namespace ocr_orc {
+
+// Forward declare DetectionParameters - defined in MagicDetectParamsDialog.h
+struct DetectionParameters;
+
+/**
+ * @brief Page conversions and page-level analysis shared by one detection run
+ *
+ * Created once per run and handed to every stage, so the page is converted
+ * from QImage once, converted to grayscale once, and classified once,
+ * instead of once per stage (Stage 1 OCR, Stage 4 conversion, refiner calls,
+ * Pass 7 reclassification).
+ *
+ * The working image is the page the CV stages see: the preprocessed page
+ * once setWorkingImage() is called, otherwise the converted source. The
+ * grayscale copy, document type and threshold manager all derive from it
+ * and are computed lazily. Getters lock, so stages on worker threads can
+ * share one context. Returned cv::Mat headers share the context's data and
+ * must not be written to.
+ *
+ * The context keeps its own copies of the page (implicitly shared) and the
+ * parameters, so it does not depend on the caller's objects staying alive.
+ */
+class DetectionContext {
+public:
+    /**
+     * @brief Constructor
+     * @param image Source page (copied; implicitly shared)
+     * @param params Detection parameters (copied)
+     */
+    DetectionContext(const QImage& image, const DetectionParameters& params);
+    ~DetectionContext();
+    
+    DetectionContext(const DetectionContext&) = delete;
+    DetectionContext& operator=(const DetectionContext&) = delete;
+    
+    const QImage& getSourceImage() const { return sourceImage; }
+    const DetectionParameters& getParameters() const { return *parameters; }
+    
+    /**
+     * @brief Source page as BGR (converted on first use)
+     *
+     * A Format_Grayscale8 page (the detection raster from
+     * PdfLoader::loadPdfFirstPageGray()) is used in place as a single-channel
+     * Mat; every stage accepts either.
+     */
+    cv::Mat getSourceBgr();
+    
+    /**
+     * @brief Replace the working image (e.g. with the preprocessed page)
+     *
+     * Drops the grayscale copy, document type and threshold manager so they
+     * are recomputed for the new page; call before handing those out.
+     */
+    void setWorkingImage(const cv::Mat& image);
+    
+    /**
+     * @brief Page seen by the CV stages (source BGR until setWorkingImage())
+     */
+    cv::Mat getWorkingImage();
+    
+    /**
+     * @brief Grayscale working image (converted on first use)
+     */
+    cv::Mat getWorkingGray();
+    
+    /**
+     * @brief Check whether a Mat is the working image (same data, size and type)
+     *
+     * Lets helpers that take a plain cv::Mat reuse getWorkingGray() instead
+     * of converting the full page again.
+     */
+    bool isWorkingImage(const cv::Mat& image);
+    
+    /**
+     * @brief Colour raster of the same page, for classifying a grayscale working image
+     *
+     * The detection raster is gray, so it carries no saturation; colorfulness
+     * and coloured sections are read from this page instead (e.g. the
+     * display raster). Drops the document type and threshold manager.
+     */
+    void setColorReference(const QImage& page);
+    
+    /**
+     * @brief Document type of the working image (classified on first use)
+     */
+    DocumentType getDocumentType();
+    
+    /**
+     * @brief Threshold manager for the document type, with the run's parameter overrides applied
+     *
+     * Returns a copy, so setWorkingImage() or setParameters() on another
+     * thread cannot invalidate it. The manager itself is built once.
+     */
+    AdaptiveThresholdManager getThresholdManager();
+    
+    /**
+     * @brief Replace the parameters and rebuild the threshold manager on next use
+     *
+     * For callers that keep one context across runs (e.g. the live preview).
+     */
+    void setParameters(const DetectionParameters& params);
+    
+    /**
+     * @brief Edge and brightness cache for the run
+     */
+    DetectionCache& getDetectionCache() { return detectionCache; }
+    
+    /**
+     * @brief Number of full-page conversions done (QImage to BGR plus BGR to gray)
+     */
+    int getConversionCount() const;
+    
+    /**
+     * @brief Number of document classifications done
+     */
+    int getClassificationCount() const;
+
+private:
+    QImage sourceImage;
+    QImage colorReference;  // Null unless setColorReference()
+    std::unique_ptr<DetectionParameters> parameters;  // Owned copy (type is forward-declared)
+    
+    mutable QMutex mutex;
+    cv::Mat sourceBgr;
+    cv::Mat workingImage;  // Empty until setWorkingImage(); falls back to sourceBgr
+    cv::Mat workingGray;
+    bool documentClassified;
+    DocumentType documentType;
+    std::unique_ptr<AdaptiveThresholdManager> thresholdManager;
+    DetectionCache detectionCache;
+    
+    int conversionCount;
+    int classificationCount;
+    
+    /**
+     * @brief Source BGR (mutex must be held)
+     */
+    const cv::Mat& sourceBgrLocked();
+    
+    /**
+     * @brief Working image (mutex must be held)
+     */
+    const cv::Mat& workingImageLocked();
+    
+    /**
+     * @brief Document type (mutex must be held)
+     */
+    DocumentType documentTypeLocked();
+};
+
+} // namespace ocr_orc
+
+#endif // DETECTION_CONTEXT_H
@@ -0,0 +1,331 @@
+#include "DetectionPreview.h"
+#include "DetectionContext.h"
+#include "RegionDetector.h"
+#include "TextRegionRefiner.h"
+#include "FormFieldDetector.h"
+#include "TraceRecorder.h"
+#include "../ui/components/dialogs/MagicDetectParamsDialog.h"
+#include <QtCore/QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace ocr_orc {
+
+namespace {
+    bool cancelled(const std::function<bool()>& isCancelled) {
+        return isCancelled && isCancelled();
+    }
+    
+    QRect toQRect(const cv::Rect& rect) {
+        return QRect(rect.x, rect.y, rect.width, rect.height);
+    }
+}
+
+DetectionPreview::DetectionPreview(const QImage& page, int maxSize)
+    : scale(1.0)
+    , parameters(std::make_unique<DetectionParameters>())
+    , prepared(false)
+    , ocrSeeded(false)
+    , validStages(0)
+{
+    if (!page.isNull()) {
+        const int longestSide = std::max(page.width(), page.height());
+        if (maxSize > 0 && longestSide > maxSize) {
+            scale = static_cast<double>(maxSize) / longestSide;
+            thumbnail = page.scaled(std::max(1, qRound(page.width() * scale)),
+                                    std::max(1, qRound(page.height() * scale)),
+                                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        } else {
+            thumbnail = page;  // Implicitly shared; never modified
+        }
+    }
+    context = std::make_unique<DetectionContext>(thumbnail, *parameters);
+}
+
+DetectionPreview::~DetectionPreview() = default;
+
+void DetectionPreview::setOcrRegions(const QList<OCRTextRegion>& regions, const QSize& sourceSize) {
+    if (sourceSize.isEmpty() || thumbnail.isNull()) {
+        return;
+    }
+    const double scaleX = static_cast<double>(thumbnail.width()) / sourceSize.width();
+    const double scaleY = static_cast<double>(thumbnail.height()) / sourceSize.height();
+    
+    ocrRegions.clear();
+    ocrRegions.reserve(regions.size());
+    for (OCRTextRegion region : regions) {
+        const cv::Rect& box = region.boundingBox;
+        region.boundingBox = cv::Rect(qRound(box.x * scaleX), qRound(box.y * scaleY),
+                                      std::max(1, qRound(box.width * scaleX)),
+                                      std::max(1, qRound(box.height * scaleY)));
+        ocrRegions.append(region);
+    }
+    ocrSeeded = true;
+    prepared = false;
+    validStages = 0;
+}
+
+void DetectionPreview::setColorReference(const QImage& page) {
+    colorReference = page;
+    context->setColorReference(page);
+}
+
+std::unique_ptr<DetectionPreview> DetectionPreview::fork() const {
+    auto copy = std::make_unique<DetectionPreview>(thumbnail, 0);
+    copy->setColorReference(colorReference);
+    copy->scale = scale;
+    copy->prepared = prepared;
+    copy->ocrSeeded = ocrSeeded;
+    copy->ocrRegions = ocrRegions;
+    copy->rectangles = rectangles;
+    copy->candidateFields = candidateFields;
+    return copy;
+}
+
+bool DetectionPreview::prepare() {
+    if (prepared) {
+        return true;
+    }
+    if (thumbnail.isNull()) {
+        return false;
+    }
+    
+    TraceSpan span("DetectionPreview::prepare", "preview");
+    QElapsedTimer timer;
+    timer.start();
+    
+    cv::Mat page = context->getWorkingImage();
+    context->getDocumentType();
+    
+    if (!ocrSeeded) {
+        // The thumbnail is small enough for one full-page pass
+        OcrTextExtractor extractor;
+        ocrRegions = extractor.extractTextRegions(page);
+    }
+    
+    // Same detector settings as the full run, scaled to the thumbnail
+    RectangleDetector rectangleDetector;
+    rectangleDetector.setSensitivity(0.15);
+    rectangleDetector.setMinSize(scaled(15, 4), scaled(10, 3));
+    rectangleDetector.setMaxSize(scaled(800, 20), scaled(300, 10));
+    rectangles = rectangleDetector.detectRectangles(page);
+    
+    TextRegionRefiner refiner;
+    refiner.setDetectionContext(context.get());
+    refiner.setPixelScale(scale);
+    candidateFields = refiner.findEmptyFormFields(ocrRegions, page);
+    
+    prepared = true;
+    validStages = 0;
+    span.setArg("ocr_regions", ocrRegions.size());
+    span.setArg("rectangles", rectangles.size());
+    span.setArg("candidates", candidateFields.size());
+    fprintf(stderr, "[DetectionPreview] Prepared %dx%d thumbnail: %lld OCR regions%s, %lld rectangles, %lld candidates (%lld ms)\n",
+            thumbnail.width(), thumbnail.height(), (long long)ocrRegions.size(), ocrSeeded ? " (seeded)" : "",
+            (long long)rectangles.size(), (long long)candidateFields.size(), (long long)timer.elapsed());
+    fflush(stderr);
+    return true;
+}
+
+DetectionPreview::Result DetectionPreview::run(const DetectionParameters& params,
+                                               const std::function<bool()>& isCancelled) {
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+    
+    if (!prepare()) {
+        return result;
+    }
+    
+    const int stale = affectedStages(*parameters, params);
+    if (stale != 0) {
+        validStages &= ~stale;
+        *parameters = params;
+        context->setParameters(params);
+    }
+    
+    TraceSpan span("DetectionPreview::run", "preview");
+    struct StageStep {
+        Stage stage;
+        bool (DetectionPreview::*runStage)(const std::function<bool()>&);
+    };
+    const StageStep steps[] = {
+        {CHECKBOX_STAGE, &DetectionPreview::runCheckboxStage},
+        {TEXT_FILTER_STAGE, &DetectionPreview::runTextFilterStage},
+        {OVERFIT_STAGE, &DetectionPreview::runOverfitStage},
+        {MERGE_STAGE, &DetectionPreview::runMergeStage},
+    };
+    for (const StageStep& step : steps) {
+        if (validStages & step.stage) {
+            continue;
+        }
+        if (cancelled(isCancelled) || !(this->*step.runStage)(isCancelled)) {
+            result.cancelled = true;
+            span.setArg("cancelled", true);
+            return result;
+        }
+        validStages |= step.stage;
+        result.stagesRun |= step.stage;
+    }
+    
+    for (const cv::Rect& field : mergedFields) {
+        result.fields.append(toQRect(field));
+    }
+    for (const CheckboxDetection& checkbox : checkboxes) {
+        if (checkbox.detected) {
+            result.checkboxes.append(toQRect(checkbox.boundingBox));
+        }
+    }
+    result.elapsedMs = timer.elapsed();
+    span.setArg("stages_run", result.stagesRun);
+    span.setArg("fields", result.fields.size());
+    return result;
+}
+
+int DetectionPreview::affectedStages(const DetectionParameters& before, const DetectionParameters& after) {
+    int stages = 0;
+    if (before.minCheckboxSize != after.minCheckboxSize ||
+        before.maxCheckboxSize != after.maxCheckboxSize ||
+        before.checkboxAspectRatioMin != after.checkboxAspectRatioMin ||
+        before.checkboxAspectRatioMax != after.checkboxAspectRatioMax ||
+        before.checkboxRectangularity != after.checkboxRectangularity ||
+        before.enableStandaloneCheckboxDetection != after.enableStandaloneCheckboxDetection) {
+        stages |= CHECKBOX_STAGE;
+    }
+    if (before.ocrOverlapThreshold != after.ocrOverlapThreshold ||
+        before.minHorizontalLines != after.minHorizontalLines ||
+        before.baseBrightnessThreshold != after.baseBrightnessThreshold ||
+        before.brightnessAdaptiveFactor != after.brightnessAdaptiveFactor ||
+        before.edgeDensityThreshold != after.edgeDensityThreshold ||
+        before.horizontalEdgeDensityThreshold != after.horizontalEdgeDensityThreshold ||
+        before.verticalEdgeDensityThreshold != after.verticalEdgeDensityThreshold) {
+        stages |= TEXT_FILTER_STAGE | OVERFIT_STAGE | MERGE_STAGE;
+    }
+    if (before.horizontalOverfitPercent != after.horizontalOverfitPercent ||
+        before.verticalOverfitPercent != after.verticalOverfitPercent) {
+        stages |= OVERFIT_STAGE | MERGE_STAGE;
+    }
+    if (before.iouThreshold != after.iouThreshold ||
+        before.strictConsensus != after.strictConsensus) {
+        stages |= MERGE_STAGE;
+    }
+    return stages;
+}
+
+bool DetectionPreview::runCheckboxStage(const std::function<bool()>& isCancelled) {
+    TraceSpan span("Preview: Checkboxes", "stage");
+    const DetectionParameters& params = *parameters;
+    cv::Mat page = context->getWorkingImage();
+    
+    CheckboxDetector detector;
+    detector.setSizeRange(scaled(params.minCheckboxSize, 3), scaled(params.maxCheckboxSize, 4));
+    detector.setAspectRatioRange(params.checkboxAspectRatioMin, params.checkboxAspectRatioMax);
+    detector.setRectangularityThreshold(params.checkboxRectangularity);
+    
+    QList<CheckboxDetection> found;
+    for (const OCRTextRegion& hint : ocrRegions) {
+        if (cancelled(isCancelled)) return false;
+        found.append(detector.detectCheckbox(hint, page));
+    }
+    if (params.enableStandaloneCheckboxDetection) {
+        if (cancelled(isCancelled)) return false;
+        found.append(detector.detectAllCheckboxes(page));
+    }
+    checkboxes = found;
+    return true;
+}
+
+bool DetectionPreview::runTextFilterStage(const std::function<bool()>& isCancelled) {
+    TraceSpan span("Preview: Pass 2 Text Filter", "stage");
+    const DetectionParameters& params = *parameters;
+    cv::Mat page = context->getWorkingImage();
+    AdaptiveThresholdManager thresholdManager = context->getThresholdManager();
+    
+    TextRegionRefiner refiner;
+    refiner.setDetectionContext(context.get());
+    refiner.setPixelScale(scale);
+    QList<cv::Rect> kept;
+    for (const cv::Rect& field : candidateFields) {
+        if (cancelled(isCancelled)) return false;
+        if (!refiner.regionContainsText(field, page, ocrRegions, &thresholdManager,
+                                        params.ocrOverlapThreshold, params.minHorizontalLines)) {
+            kept.append(field);
+        }
+    }
+    textFreeFields = kept;
+    return true;
+}
+
+bool DetectionPreview::runOverfitStage(const std::function<bool()>& isCancelled) {
+    TraceSpan span("Preview: Passes 3-5 Overfit and Classify", "stage");
+    cv::Mat page = context->getWorkingImage();
+    DocumentType docType = context->getDocumentType();
+    AdaptiveThresholdManager thresholdManager = context->getThresholdManager();
+    const int horizontalOverfit = static_cast<int>(thresholdManager.getHorizontalOverfitPercent(docType));
+    const int verticalOverfit = static_cast<int>(thresholdManager.getVerticalOverfitPercent(docType));
+    
+    FormFieldDetector formFieldDetector;
+    formFieldDetector.setPixelScale(scale);
+    QList<cv::Rect> overfitted;
+    for (const cv::Rect& field : textFreeFields) {
+        if (cancelled(isCancelled)) return false;
+        overfitted.append(formFieldDetector.overfitRegionAsymmetric(field, page, horizontalOverfit, verticalOverfit));
+    }
+    if (cancelled(isCancelled)) return false;
+    QList<cv::Rect> refined = formFieldDetector.refineOverfittedRegions(overfitted, page, isCancelled);
+    
+    // Add grid cells the overfit regions missed, as the full run does
+    if (cancelled(isCancelled)) return false;
+    QList<cv::Rect> flattened = refined;
+    for (const QList<cv::Rect>& group : formFieldDetector.detectCellGroupsWithSharedWalls(refined, page, isCancelled)) {
+        for (const cv::Rect& cell : group) {
+            bool found = false;
+            for (const cv::Rect& existing : flattened) {
+                cv::Rect overlap = cell & existing;
+                if (overlap.width > cell.width * 0.5 && overlap.height > cell.height * 0.5) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                flattened.append(cell);
+            }
+        }
+    }
+    
+    if (cancelled(isCancelled)) return false;
+    // Cancelled calls return partial lists, which must not be kept as the stage's result
+    classifiedFields = formFieldDetector.classifyAndRefineRegions(flattened, page, ocrRegions, isCancelled);
+    return !cancelled(isCancelled);
+}
+
+bool DetectionPreview::runMergeStage(const std::function<bool()>& isCancelled) {
+    TraceSpan span("Preview: Passes 7-8.5 Merge and Final Filter", "stage");
+    const DetectionParameters& params = *parameters;
+    cv::Mat page = context->getWorkingImage();
+    
+    RegionDetector detector;
+    DetectionResult merged = detector.matchAndMergePipelines(classifiedFields, rectangles, ocrRegions, *context, scale);
+    
+    AdaptiveThresholdManager thresholdManager = context->getThresholdManager();
+    TextRegionRefiner refiner;
+    refiner.setDetectionContext(context.get());
+    refiner.setPixelScale(scale);
+    QList<cv::Rect> kept;
+    for (const DetectedRegion& region : merged.regions) {
+        if (cancelled(isCancelled)) return false;
+        if (!refiner.regionContainsText(region.boundingBox, page, ocrRegions, &thresholdManager,
+                                        params.ocrOverlapThreshold, params.minHorizontalLines)) {
+            kept.append(region.boundingBox);
+        }
+    }
+    mergedFields = kept;
+    return true;
+}
+
+int DetectionPreview::scaled(int pixels, int minimum) const {
+    return std::max(minimum, static_cast<int>(std::lround(pixels * scale)));
+}
+
+} // namespace ocr_orc
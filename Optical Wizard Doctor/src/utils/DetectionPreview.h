@@ -0,0 +1,184 @@
+#ifndef DETECTION_PREVIEW_H
+#define DETECTION_PREVIEW_H
+
+#include "OcrTextExtractor.h"
+#include "RectangleDetector.h"
+#include "CheckboxDetector.h"
+#include <opencv2/opencv.hpp>
+#include <QtGui/QImage>
+#include <QtCore/QList>
+#include <QtCore/QRect>
+#include <QtCore/QSize>
+#include <functional>
+#include <memory>
+
+namespace ocr_orc {
+
+// Forward declare DetectionParameters - defined in MagicDetectParamsDialog.h
+struct DetectionParameters;
+class DetectionContext;
+
+/**
+ * @brief Incremental OCR-first detection on a page thumbnail, for live parameter tuning
+ *
+ * prepare() does the parameter-independent work once: it scales the page to
+ * a thumbnail, runs OCR (unless OCR results were seeded from an earlier
+ * run), detects rectangles and finds the candidate fields around the OCR
+ * hints. run() then re-runs only the stages whose parameters changed since
+ * the previous run, reusing the rest:
+ * - Checkbox stage: checkbox size, shape and standalone scan parameters
+ * - Text filter stage (Pass 2): overlap, brightness, edge density, Hough lines
+ * - Overfit stage (Passes 3-5): overfit percentages
+ * - Merge stage (Passes 7-8.5): IoU threshold and consensus mode
+ * A stage that re-runs invalidates the stages after it.
+ *
+ * Runs take a cancellation callback that is polled between stages and
+ * between candidates; a cancelled run keeps every stage it completed, so the
+ * next run picks up from there. Not thread-safe: use from one thread.
+ */
+class DetectionPreview {
+public:
+    /**
+     * @brief Stages run() can recompute (flags)
+     */
+    enum Stage {
+        CHECKBOX_STAGE = 0x1,
+        TEXT_FILTER_STAGE = 0x2,
+        OVERFIT_STAGE = 0x4,
+        MERGE_STAGE = 0x8,
+        ALL_STAGES = 0xF
+    };
+    
+    /**
+     * @brief Preview overlay, in thumbnail pixels
+     */
+    struct Result {
+        QList<QRect> fields;
+        QList<QRect> checkboxes;
+        int stagesRun = 0;        // Stage flags recomputed by this run
+        qint64 elapsedMs = 0;
+        bool cancelled = false;   // Fields/checkboxes are empty when cancelled
+    };
+    
+    // Longest thumbnail side; large enough for OCR to find label words
+    static constexpr int MAX_THUMBNAIL_SIZE = 1200;
+    
+    /**
+     * @brief Constructor
+     * @param page Full-resolution page (scaled down if larger than maxSize)
+     * @param maxSize Longest side of the working image; 0 keeps the page resolution
+     */
+    explicit DetectionPreview(const QImage& page, int maxSize = MAX_THUMBNAIL_SIZE);
+    ~DetectionPreview();
+    
+    DetectionPreview(const DetectionPreview&) = delete;
+    DetectionPreview& operator=(const DetectionPreview&) = delete;
+    
+    /**
+     * @brief Reuse OCR results from an earlier run instead of running OCR in prepare()
+     * @param regions OCR regions in source-page pixels
+     * @param sourceSize Size of the page the regions were read from
+     */
+    void setOcrRegions(const QList<OCRTextRegion>& regions, const QSize& sourceSize);
+    
+    /**
+     * @brief Classify a gray page with the colour statistics of another raster of it
+     *
+     * Call before prepare(). The full run does the same (see
+     * RegionDetector::setColorReference()), so both pick the same thresholds.
+     * @param page Colour raster of the same page (any size), or null
+     */
+    void setColorReference(const QImage& page);
+    
+    /**
+     * @brief Run OCR, rectangle detection and candidate search on the thumbnail
+     *
+     * Not cancellable: the work is done once per page and every later run
+     * needs it.
+     *
+     * @return false if the page is empty
+     */
+    bool prepare();
+    
+    bool isPrepared() const { return prepared; }
+    
+    /**
+     * @brief New preview over the same prepared inputs, with its own stage caches
+     *
+     * OCR regions, rectangles and candidates are shared (implicitly) rather
+     * than recomputed, so several threads can each run their own fork of
+     * one prepared page.
+     */
+    std::unique_ptr<DetectionPreview> fork() const;
+    
+    /**
+     * @brief Drop every cached stage so the next run recomputes all of them
+     */
+    void invalidateStages() { validStages = 0; }
+    
+    /**
+     * @brief Re-run the stages affected by the parameters (prepares first if needed)
+     * @param params Parameters to preview
+     * @param isCancelled Polled between stages and candidates; may be empty
+     */
+    Result run(const DetectionParameters& params,
+               const std::function<bool()>& isCancelled = std::function<bool()>());
+    
+    /**
+     * @brief Stages that must re-run when parameters change from before to after
+     *
+     * ocrConfidenceThreshold maps to no stage: the full run applies it only
+     * to ROI reads after page OCR, which the preview does not do.
+     */
+    static int affectedStages(const DetectionParameters& before, const DetectionParameters& after);
+    
+    const QImage& getThumbnail() const { return thumbnail; }
+    
+    /**
+     * @brief Thumbnail size divided by page size
+     */
+    double getScale() const { return scale; }
+    
+    /**
+     * @brief Stage flags whose cached results match the last run's parameters
+     */
+    int getValidStages() const { return validStages; }
+    
+    int getOcrRegionCount() const { return ocrRegions.size(); }
+    int getCandidateCount() const { return candidateFields.size(); }
+
+private:
+    QImage thumbnail;
+    QImage colorReference;  // Null unless setColorReference()
+    double scale;
+    std::unique_ptr<DetectionParameters> parameters;  // Parameters of the last run()
+    std::unique_ptr<DetectionContext> context;
+    bool prepared;
+    bool ocrSeeded;
+    
+    // Parameter-independent inputs (prepare())
+    QList<OCRTextRegion> ocrRegions;
+    QList<DetectedRectangle> rectangles;
+    QList<cv::Rect> candidateFields;
+    
+    // Stage outputs, valid per validStages
+    int validStages;
+    QList<CheckboxDetection> checkboxes;
+    QList<cv::Rect> textFreeFields;
+    QList<cv::Rect> classifiedFields;
+    QList<cv::Rect> mergedFields;
+    
+    bool runCheckboxStage(const std::function<bool()>& isCancelled);
+    bool runTextFilterStage(const std::function<bool()>& isCancelled);
+    bool runOverfitStage(const std::function<bool()>& isCancelled);
+    bool runMergeStage(const std::function<bool()>& isCancelled);
+    
+    /**
+     * @brief Scale a full-page pixel size to the thumbnail (at least minimum)
+     */
+    int scaled(int pixels, int minimum) const;
+};
+
+} // namespace ocr_orc
+
+#endif // DETECTION_PREVIEW_H
@@ -0,0 +1,59 @@
+#include "DetectionProgressChannel.h"
+#include <QtCore/QMutexLocker>
+
+namespace ocr_orc {
+
+QString PartialDetectionLayer::kindName(Kind kind) {
+    switch (kind) {
+        case OCR_WORDS:
+            return "OCR words";
+        case RECTANGLE_CANDIDATES:
+            return "Rectangle candidates";
+        case CONSENSUS_REGIONS:
+            return "Consensus regions";
+    }
+    return "Unknown";
+}
+
+DetectionProgressChannel::DetectionProgressChannel()
+    : cancelled(false)
+{
+    runTimer.start();
+}
+
+void DetectionProgressChannel::setListener(const Listener& newListener) {
+    QMutexLocker locker(&mutex);
+    listener = newListener;
+}
+
+void DetectionProgressChannel::reset() {
+    QMutexLocker locker(&mutex);
+    layers.clear();
+    cancelled.store(false);
+    runTimer.restart();
+}
+
+void DetectionProgressChannel::publish(PartialDetectionLayer layer) {
+    Listener notify;
+    {
+        QMutexLocker locker(&mutex);
+        if (cancelled.load()) {
+            return;
+        }
+        layer.elapsedMs = runTimer.elapsed();
+        layers.append(layer);
+        notify = listener;
+    }
+    
+    // Outside the lock: the listener may call back into the channel
+    if (notify) {
+        notify(layer);
+    }
+}
+
+QList<PartialDetectionLayer> DetectionProgressChannel::getLayers() const {
+    QMutexLocker locker(&mutex);
+    return layers;
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,101 @@
+#ifndef DETECTION_PROGRESS_CHANNEL_H
+#define DETECTION_PROGRESS_CHANNEL_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QMutex>
+#include <QtCore/QElapsedTimer>
+#include <atomic>
+#include <functional>
+#include "RegionDetector.h"
+
+namespace ocr_orc {
+
+/**
+ * @brief Intermediate result set published while a detection run is in progress
+ */
+struct PartialDetectionLayer {
+    /**
+     * @brief Pipeline point the layer was taken at
+     */
+    enum Kind {
+        OCR_WORDS,              // Word boxes after Stage 1 (OCR extraction)
+        RECTANGLE_CANDIDATES,   // Rectangle candidates after Pass 6
+        CONSENSUS_REGIONS       // Merged consensus regions after Pass 7
+    };
+    
+    Kind kind;
+    QList<DetectedRegion> regions;  // Normalized coordinates, like the final result
+    qint64 elapsedMs;               // Time since the run started
+    
+    PartialDetectionLayer() : kind(OCR_WORDS), elapsedMs(0) {}
+    PartialDetectionLayer(Kind k, const QList<DetectedRegion>& r)
+        : kind(k), regions(r), elapsedMs(0) {}
+    
+    /**
+     * @brief Human-readable layer name for status messages
+     */
+    static QString kindName(Kind kind);
+};
+
+/**
+ * @brief Thread-safe channel from a running detection to the UI
+ *
+ * The detector publishes one layer at each milestone of the OCR-first
+ * pipeline; the listener is called on the publishing thread, outside the
+ * lock, so it can emit a queued signal. The UI requests cancellation through
+ * the same channel; the detector polls it at each milestone, between passes
+ * and between candidates, and returns an empty result when it is set.
+ */
+class DetectionProgressChannel {
+public:
+    using Listener = std::function<void(const PartialDetectionLayer&)>;
+    
+    DetectionProgressChannel();
+    ~DetectionProgressChannel() = default;
+    
+    DetectionProgressChannel(const DetectionProgressChannel&) = delete;
+    DetectionProgressChannel& operator=(const DetectionProgressChannel&) = delete;
+    
+    /**
+     * @brief Set the callback for published layers (may be empty)
+     */
+    void setListener(const Listener& listener);
+    
+    /**
+     * @brief Start a new run: drop published layers, clear cancellation and restart the clock
+     */
+    void reset();
+    
+    /**
+     * @brief Publish a layer (dropped once cancellation was requested)
+     * @param layer Layer to publish; elapsedMs is filled in here
+     */
+    void publish(PartialDetectionLayer layer);
+    
+    /**
+     * @brief Layers published since the last reset(), in order
+     */
+    QList<PartialDetectionLayer> getLayers() const;
+    
+    /**
+     * @brief Ask the running detection to stop at its next milestone (any thread)
+     */
+    void requestCancel() { cancelled.store(true); }
+    
+    /**
+     * @brief Check whether cancellation was requested (any thread)
+     */
+    bool isCancelled() const { return cancelled.load(); }
+
+private:
+    mutable QMutex mutex;
+    QList<PartialDetectionLayer> layers;
+    Listener listener;
+    QElapsedTimer runTimer;
+    std::atomic<bool> cancelled;
+};
+
+} // namespace ocr_orc
+
+#endif // DETECTION_PROGRESS_CHANNEL_H
@@ -1,27 +1,103 @@
 #include "DocumentPreprocessor.h"
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
+#include <opencv2/core/utility.hpp>
 #include <QtCore/QList>
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace ocr_orc {
 
+namespace {
+
+// Same support and sigmas as the bilateralFilter(9, 75, 75) used in QUALITY_PREPROCESSING
+constexpr int BILATERAL_RADIUS = 4;
+constexpr double BILATERAL_SIGMA_COLOR = 75.0;
+constexpr double BILATERAL_SIGMA_SPACE = 75.0;
+
+// Shadow background kernel at full resolution
+constexpr int SHADOW_KERNEL_SIZE = 15;
+
+/**
+ * @brief One horizontal 1-D bilateral pass over an 8-bit gray or BGR image
+ * @param colorWeights Range weights indexed by the summed absolute channel difference
+ */
+void bilateralRows(const cv::Mat& src, cv::Mat& dst, const float* spaceWeights, const float* colorWeights)
+{
+    const int channels = src.channels();
+    const int cols = src.cols;
+    dst.create(src.size(), src.type());
+    
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            const uchar* in = src.ptr<uchar>(y);
+            uchar* out = dst.ptr<uchar>(y);
+            
+            for (int x = 0; x < cols; ++x) {
+                const uchar* center = in + x * channels;
+                float sum[3] = {0.0f, 0.0f, 0.0f};
+                float weightSum = 0.0f;
+                
+                for (int k = -BILATERAL_RADIUS; k <= BILATERAL_RADIUS; ++k) {
+                    const uchar* neighbor = in + std::clamp(x + k, 0, cols - 1) * channels;
+                    int diff = 0;
+                    for (int c = 0; c < channels; ++c) {
+                        diff += std::abs(neighbor[c] - center[c]);
+                    }
+                    
+                    float weight = spaceWeights[k + BILATERAL_RADIUS] * colorWeights[diff];
+                    for (int c = 0; c < channels; ++c) {
+                        sum[c] += weight * neighbor[c];
+                    }
+                    weightSum += weight;
+                }
+                
+                uchar* target = out + x * channels;
+                for (int c = 0; c < channels; ++c) {
+                    target[c] = cv::saturate_cast<uchar>(sum[c] / weightSum);
+                }
+            }
+        }
+    });
+}
+
+} // namespace
+
 DocumentPreprocessor::DocumentPreprocessor()
     : enableSkewCorrection(true)
     , enableDenoising(true)
     , enableShadowRemoval(true)
     , enableContrastEnhancement(true)
+    , mode(QUALITY_PREPROCESSING)
+    , colorOutputRequired(true)
 {
 }
 
+int DocumentPreprocessor::estimationScale(const cv::Size& size)
+{
+    // 4-8x, aiming for roughly 500px on the long side; small pages go down to 1x to keep 250px
+    const int longSide = std::max(size.width, size.height);
+    int scale = std::clamp(longSide / 500, 4, 8);
+    while (scale > 1 && longSide / scale < 250) {
+        --scale;
+    }
+    return scale;
+}
+
 cv::Mat DocumentPreprocessor::preprocess(const cv::Mat& image)
 {
     if (image.empty()) {
         return image;
     }
     
-    cv::Mat processed = image.clone();
+    cv::Mat processed;
+    if (mode == FAST_PREPROCESSING && !colorOutputRequired && image.channels() == 3) {
+        // Caller only needs gray: convert once so every step touches one channel
+        cv::cvtColor(image, processed, cv::COLOR_BGR2GRAY);
+    } else {
+        processed = image.clone();
+    }
     
     // Apply preprocessing steps in order (expert recommendation)
     
@@ -78,13 +154,31 @@ double DocumentPreprocessor::detectSkewAngle(const cv::Mat& image)
         gray = image.clone();
     }
     
+    if (mode == FAST_PREPROCESSING) {
+        // Line orientation survives downsampling; Hough cost scales with edge pixels
+        const int scale = estimationScale(gray.size());
+        cv::Mat small;
+        cv::resize(gray, small, cv::Size(), 1.0 / scale, 1.0 / scale, cv::INTER_AREA);
+        
+        cv::Mat edges;
+        cv::Canny(small, edges, 50, 150);
+        
+        // Votes shrink with line length; a finer theta step keeps sub-degree resolution
+        return medianLineAngle(edges, std::max(30, 100 / scale), CV_PI / 720);
+    }
+    
     // Apply edge detection
     cv::Mat edges;
     cv::Canny(gray, edges, 50, 150);
     
+    return medianLineAngle(edges, 100, CV_PI / 180);
+}
+
+double DocumentPreprocessor::medianLineAngle(const cv::Mat& edges, int threshold, double thetaStep)
+{
     // Use HoughLines to detect lines
     std::vector<cv::Vec2f> lines;
-    cv::HoughLines(edges, lines, 1, CV_PI / 180, 100);
+    cv::HoughLines(edges, lines, 1, thetaStep, threshold);
     
     if (lines.empty()) {
         return 0.0;
@@ -149,7 +243,10 @@ cv::Mat DocumentPreprocessor::denoise(const cv::Mat& image)
     cv::Mat denoised;
     
     // Use bilateral filter for edge-preserving denoising (expert recommendation)
-    if (image.channels() == 3) {
+    if (image.channels() == 3 && mode == FAST_PREPROCESSING && image.depth() == CV_8U) {
+        // 2 x 9 taps per pixel instead of a 9x9 window
+        denoised = separableBilateral(image);
+    } else if (image.channels() == 3) {
         cv::bilateralFilter(image, denoised, 9, 75, 75);
     } else {
         // For grayscale, use Gaussian blur (bilateral filter also works)
@@ -159,6 +256,33 @@ cv::Mat DocumentPreprocessor::denoise(const cv::Mat& image)
     return denoised;
 }
 
+cv::Mat DocumentPreprocessor::separableBilateral(const cv::Mat& image)
+{
+    const int channels = image.channels();
+    
+    float spaceWeights[2 * BILATERAL_RADIUS + 1];
+    const double spaceCoeff = -0.5 / (BILATERAL_SIGMA_SPACE * BILATERAL_SIGMA_SPACE);
+    for (int k = -BILATERAL_RADIUS; k <= BILATERAL_RADIUS; ++k) {
+        spaceWeights[k + BILATERAL_RADIUS] = static_cast<float>(std::exp(k * k * spaceCoeff));
+    }
+    
+    // Range weights over the summed channel difference, as bilateralFilter does for color
+    std::vector<float> colorWeights(256 * channels);
+    const double colorCoeff = -0.5 / (BILATERAL_SIGMA_COLOR * BILATERAL_SIGMA_COLOR);
+    for (size_t i = 0; i < colorWeights.size(); ++i) {
+        colorWeights[i] = static_cast<float>(std::exp(static_cast<double>(i * i) * colorCoeff));
+    }
+    
+    // Vertical pass runs as a horizontal pass on the transpose (contiguous rows)
+    cv::Mat horizontal, transposed, vertical, result;
+    bilateralRows(image, horizontal, spaceWeights, colorWeights.data());
+    cv::transpose(horizontal, transposed);
+    bilateralRows(transposed, vertical, spaceWeights, colorWeights.data());
+    cv::transpose(vertical, result);
+    
+    return result;
+}
+
 cv::Mat DocumentPreprocessor::removeShadows(const cv::Mat& image)
 {
     if (image.empty()) {
@@ -173,8 +297,30 @@ cv::Mat DocumentPreprocessor::removeShadows(const cv::Mat& image)
         gray = image.clone();
     }
     
+    if (mode == FAST_PREPROCESSING) {
+        // Background is smooth: estimate it small and upsample the field
+        const int scale = estimationScale(gray.size());
+        const int kernelSize = std::max(3, (SHADOW_KERNEL_SIZE / scale) | 1);
+        cv::Mat small, smallBackground, background;
+        cv::resize(gray, small, cv::Size(), 1.0 / scale, 1.0 / scale, cv::INTER_AREA);
+        cv::morphologyEx(small, smallBackground, cv::MORPH_CLOSE,
+                         cv::getStructuringElement(cv::MORPH_RECT, cv::Size(kernelSize, kernelSize)));
+        cv::resize(smallBackground, background, gray.size(), 0.0, 0.0, cv::INTER_LINEAR);
+        
+        cv::Mat result;
+        if (image.channels() == 3) {
+            // One luminance background for all channels instead of one close per channel
+            cv::Mat background3;
+            cv::cvtColor(background, background3, cv::COLOR_GRAY2BGR);
+            cv::divide(image, background3, result, 255.0);
+        } else {
+            cv::divide(gray, background, result, 255.0);
+        }
+        return result;
+    }
+    
     // Use morphological operations to estimate background (shadow areas)
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(15, 15));
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(SHADOW_KERNEL_SIZE, SHADOW_KERNEL_SIZE));
     cv::Mat background;
     cv::morphologyEx(gray, background, cv::MORPH_CLOSE, kernel);
     
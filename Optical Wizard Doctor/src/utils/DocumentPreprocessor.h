@@ -13,9 +13,21 @@ namespace ocr_orc {
  * - Denoising
  * - Shadow removal
  * - Contrast enhancement
+ *
+ * FAST_PREPROCESSING estimates skew and the shadow background on a 4-8x
+ * downsampled copy, replaces the bilateral filter with a separable
+ * approximation, and works on gray only unless color output is required.
  */
 class DocumentPreprocessor {
 public:
+    /**
+     * @brief Preprocessing mode
+     */
+    enum PreprocessingMode {
+        QUALITY_PREPROCESSING,  // Full-resolution filters, per-channel processing
+        FAST_PREPROCESSING      // Downsampled estimation, separable denoising
+    };
+    
     DocumentPreprocessor();
     ~DocumentPreprocessor() = default;
     
@@ -70,12 +82,60 @@ public:
      */
     void setPreprocessingOptions(bool enableSkew = true, bool enableDenoise = true,
                                 bool enableShadowRemoval = true, bool enableContrast = true);
+    
+    /**
+     * @brief Set preprocessing mode
+     * @param mode QUALITY_PREPROCESSING (default) or FAST_PREPROCESSING
+     */
+    void setMode(PreprocessingMode mode) { this->mode = mode; }
+    
+    /**
+     * @brief Get preprocessing mode
+     */
+    PreprocessingMode getMode() const { return mode; }
+    
+    /**
+     * @brief Whether preprocess() must return a color image for color input
+     * @param required False lets FAST_PREPROCESSING convert to gray up front (default: true)
+     */
+    void setColorOutputRequired(bool required) { colorOutputRequired = required; }
+    
+    /**
+     * @brief Get color output requirement
+     */
+    bool isColorOutputRequired() const { return colorOutputRequired; }
 
 private:
     bool enableSkewCorrection;
     bool enableDenoising;
     bool enableShadowRemoval;
     bool enableContrastEnhancement;
+    PreprocessingMode mode;
+    bool colorOutputRequired;
+    
+    /**
+     * @brief Downsampling factor for FAST_PREPROCESSING estimates (1-8)
+     * Normally 4-8; lower for small images so the estimate keeps at least
+     * 250px on its long side.
+     * @param size Full-resolution image size
+     */
+    static int estimationScale(const cv::Size& size);
+    
+    /**
+     * @brief Median angle of Hough lines in an edge image
+     * @param edges Canny edge image
+     * @param threshold Hough accumulator threshold
+     * @param thetaStep Angular resolution in radians
+     * @return Median angle in degrees, 0 if no lines
+     */
+    static double medianLineAngle(const cv::Mat& edges, int threshold, double thetaStep);
+    
+    /**
+     * @brief Separable edge-preserving smoothing (horizontal then vertical 1-D bilateral)
+     * @param image 8-bit gray or BGR image
+     * @return Smoothed image
+     */
+    static cv::Mat separableBilateral(const cv::Mat& image);
     
     /**
      * @brief Rotate image by angle
@@ -1,13 +1,56 @@
 #include "DocumentTypeClassifier.h"
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
+#include <QtCore/QByteArray>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <vector>
 
 namespace ocr_orc {
 
+namespace {
+
+// Long side of the classification thumbnail
+constexpr int THUMBNAIL_LONG_SIDE = 1024;
+
+// Field-sized contour bounds at full resolution (see analyzeFieldDensity)
+constexpr double FIELD_MIN_WIDTH = 20.0;
+constexpr double FIELD_MIN_HEIGHT = 10.0;
+constexpr double FIELD_MAX_WIDTH = 500.0;
+constexpr double FIELD_MAX_HEIGHT = 200.0;
+
+// HSV saturation as cv::COLOR_BGR2HSV computes it for 8-bit; value is max(b, g, r)
+inline int hsvSaturation(int b, int g, int r, int& value)
+{
+    value = std::max({b, g, r});
+    const int minimum = std::min({b, g, r});
+    return value > 0 ? ((value - minimum) * 255 + value / 2) / value : 0;
+}
+
+// Saturated and not dark: counts towards hasColoredSections
+inline bool isColoredPixel(int saturation, int value)
+{
+    return saturation > 50 && value > 100;
+}
+
+// Length of a horizontal run above threshold, closed at row end
+inline void countRun(int& runLength, double minLength, int& count)
+{
+    if (runLength > minLength) {
+        count++;
+    }
+    runLength = 0;
+}
+
+} // namespace
+
 DocumentTypeClassifier::DocumentTypeClassifier()
     : classificationConfidence(0.0)
+    , hasColorReference(false)
+    , validationEnabled(qgetenv("OCR_ORC_VALIDATE_CLASSIFIER") == "1")
+    , validationCount(0)
+    , validationMismatches(0)
 {
 }
 
@@ -17,6 +60,107 @@ DocumentType DocumentTypeClassifier::classifyDocument(const cv::Mat& image)
         return STANDARD_FORM;
     }
     
+    // The fused pass handles 8-bit gray and BGR; anything else takes the reference path
+    if (image.depth() != CV_8U || (image.channels() != 1 && image.channels() != 3)) {
+        return classifyDocumentFullResolution(image);
+    }
+    
+    DocumentFeatures features = extractThumbnailFeatures(image);
+    applyColorReference(image, features);
+    DocumentType type = classifyFeatures(features, classificationConfidence);
+    
+    if (validationEnabled) {
+        double referenceConfidence = 0.0;
+        DocumentFeatures reference = extractFullResolutionFeatures(image);
+        applyColorReference(image, reference);
+        DocumentType referenceType = classifyFeatures(reference, referenceConfidence);
+        validationCount++;
+        if (referenceType != type) {
+            validationMismatches++;
+            fprintf(stderr, "[DocumentTypeClassifier] Validation mismatch (%dx%d): thumbnail=%s full=%s\n",
+                    image.cols, image.rows,
+                    documentTypeToString(type).toUtf8().constData(),
+                    documentTypeToString(referenceType).toUtf8().constData());
+            fprintf(stderr, "[DocumentTypeClassifier]   thumbnail: contrast=%.3f color=%.3f fields=%.3f text=%.3f colored=%d handwritten=%d\n",
+                    features.contrast, features.colorfulness, features.fieldDensity,
+                    features.textCharacteristics, features.hasColoredSections, features.handwritten);
+            fprintf(stderr, "[DocumentTypeClassifier]   full:      contrast=%.3f color=%.3f fields=%.3f text=%.3f colored=%d handwritten=%d\n",
+                    reference.contrast, reference.colorfulness, reference.fieldDensity,
+                    reference.textCharacteristics, reference.hasColoredSections, reference.handwritten);
+            fflush(stderr);
+        }
+    }
+    
+    return type;
+}
+
+DocumentType DocumentTypeClassifier::classifyDocumentFullResolution(const cv::Mat& image)
+{
+    if (image.empty()) {
+        return STANDARD_FORM;
+    }
+    DocumentFeatures features = extractFullResolutionFeatures(image);
+    applyColorReference(image, features);
+    return classifyFeatures(features, classificationConfidence);
+}
+
+DocumentFeatures DocumentTypeClassifier::extractColorFeatures(const cv::Mat& image)
+{
+    DocumentFeatures features;
+    if (image.empty() || image.depth() != CV_8U || (image.channels() != 3 && image.channels() != 4)) {
+        return features;
+    }
+    
+    // Same grid as the fused thumbnail pass, so the statistics match a colour page's own
+    const int channels = image.channels();
+    const int longSide = std::max(image.cols, image.rows);
+    const int step = longSide > THUMBNAIL_LONG_SIDE
+        ? std::max(1, static_cast<int>(std::lround(static_cast<double>(longSide) / THUMBNAIL_LONG_SIDE))) : 1;
+    double saturationSum = 0.0;
+    long long coloredCount = 0;
+    long long sampleCount = 0;
+    for (int y = 0; y < image.rows; y += step) {
+        const uchar* row = image.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; x += step) {
+            const uchar* px = row + x * channels;
+            int value;
+            const int saturation = hsvSaturation(px[0], px[1], px[2], value);
+            saturationSum += saturation;
+            if (isColoredPixel(saturation, value)) {
+                coloredCount++;
+            }
+            sampleCount++;
+        }
+    }
+    
+    if (sampleCount > 0) {
+        features.colorfulness = saturationSum / sampleCount / 255.0;
+        features.hasColoredSections = static_cast<double>(coloredCount) / sampleCount > 0.05;
+    }
+    return features;
+}
+
+void DocumentTypeClassifier::setColorReference(const cv::Mat& image)
+{
+    hasColorReference = !image.empty() && (image.channels() == 3 || image.channels() == 4);
+    colorReference = hasColorReference ? extractColorFeatures(image) : DocumentFeatures();
+}
+
+void DocumentTypeClassifier::applyColorReference(const cv::Mat& image, DocumentFeatures& features) const
+{
+    if (hasColorReference && image.channels() == 1) {
+        features.colorfulness = colorReference.colorfulness;
+        features.hasColoredSections = colorReference.hasColoredSections;
+    }
+}
+
+DocumentFeatures DocumentTypeClassifier::extractFullResolutionFeatures(const cv::Mat& image)
+{
+    DocumentFeatures features;
+    if (image.empty()) {
+        return features;
+    }
+    
     // Convert to grayscale for analysis
     cv::Mat gray;
     if (image.channels() == 3) {
@@ -26,41 +170,201 @@ DocumentType DocumentTypeClassifier::classifyDocument(const cv::Mat& image)
     }
     
     // Analyze various characteristics
-    double contrast = analyzeContrast(gray);
-    double colorfulness = analyzeColorDistribution(image);
-    double fieldDensity = analyzeFieldDensity(gray);
-    double textChar = analyzeTextCharacteristics(gray);
-    bool hasColored = hasColoredSections(image);
-    bool handwritten = isHandwritten(gray);
+    features.contrast = analyzeContrast(gray);
+    features.colorfulness = analyzeColorDistribution(image);
+    features.fieldDensity = analyzeFieldDensity(gray);
+    features.textCharacteristics = analyzeTextCharacteristics(gray);
+    features.hasColoredSections = hasColoredSections(image);
+    features.handwritten = isHandwritten(gray);
+    return features;
+}
+
+DocumentFeatures DocumentTypeClassifier::extractThumbnailFeatures(const cv::Mat& image)
+{
+    DocumentFeatures features;
+    if (image.empty()) {
+        return features;
+    }
+    
+    const int longSide = std::max(image.cols, image.rows);
+    const double scale = longSide > THUMBNAIL_LONG_SIDE
+        ? static_cast<double>(THUMBNAIL_LONG_SIDE) / longSide : 1.0;
+    const bool isColor = image.channels() == 3;
+    
+    // Pass 1 (fused): gray mean/variance, saturation and colored-section ratio.
+    // Sampled on a grid, not area-averaged, so thin strokes keep their full
+    // contrast and saturation, matching the full-resolution statistics.
+    const int step = std::max(1, static_cast<int>(std::lround(1.0 / scale)));
+    double graySum = 0.0;
+    double graySqSum = 0.0;
+    double saturationSum = 0.0;
+    long long coloredCount = 0;
+    long long sampleCount = 0;
+    for (int y = 0; y < image.rows; y += step) {
+        const uchar* row = image.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; x += step) {
+            int gray;
+            if (isColor) {
+                const uchar* px = row + x * 3;
+                const int b = px[0], g = px[1], r = px[2];
+                // Same fixed-point weights as cv::COLOR_BGR2GRAY
+                gray = (b * 1868 + g * 9617 + r * 4899 + (1 << 13)) >> 14;
+                
+                int value;
+                const int saturation = hsvSaturation(b, g, r, value);
+                saturationSum += saturation;
+                if (isColoredPixel(saturation, value)) {
+                    coloredCount++;
+                }
+            } else {
+                gray = row[x];
+            }
+            graySum += gray;
+            graySqSum += static_cast<double>(gray) * gray;
+            sampleCount++;
+        }
+    }
+    
+    if (sampleCount > 0) {
+        const double mean = graySum / sampleCount;
+        const double variance = std::max(0.0, graySqSum / sampleCount - mean * mean);
+        features.contrast = std::min(1.0, std::sqrt(variance) / 128.0);
+        if (isColor) {
+            features.colorfulness = saturationSum / sampleCount / 255.0;
+            features.hasColoredSections = static_cast<double>(coloredCount) / sampleCount > 0.05;
+        }
+    }
+    
+    // Structural features need neighbourhoods: area-downsample the gray page
+    cv::Mat gray;
+    if (isColor) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = image;
+    }
+    cv::Mat thumb;
+    if (scale < 1.0) {
+        cv::resize(gray, thumb, cv::Size(), scale, scale, cv::INTER_AREA);
+    } else {
+        thumb = gray;
+    }
+    const double thumbArea = static_cast<double>(thumb.rows) * thumb.cols;
+    
+    // Field density: field-sized bounds shrink with the thumbnail, area is the full page's
+    cv::Mat edges;
+    cv::Canny(thumb, edges, 50, 150);
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(edges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    int rectangularCount = 0;
+    for (const auto& contour : contours) {
+        if (contour.size() < 4) continue;
+        
+        cv::Rect rect = cv::boundingRect(contour);
+        double area = cv::contourArea(contour);
+        double rectArea = rect.width * rect.height;
+        if (rectArea > 0 && area / rectArea > 0.7 &&
+            rect.width > FIELD_MIN_WIDTH * scale && rect.height > FIELD_MIN_HEIGHT * scale &&
+            rect.width < FIELD_MAX_WIDTH * scale && rect.height < FIELD_MAX_HEIGHT * scale) {
+            rectangularCount++;
+        }
+    }
+    const double fullArea = thumbArea / (scale * scale);
+    features.fieldDensity = std::min(1.0, (rectangularCount * 10000.0) / fullArea / 10.0);
+    
+    // Text lines: adaptive threshold window scaled to the thumbnail, then horizontal opening
+    const int blockSize = std::max(3, static_cast<int>(std::lround(11 * scale)) | 1);
+    cv::Mat adaptive;
+    cv::adaptiveThreshold(thumb, adaptive, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C,
+                          cv::THRESH_BINARY_INV, blockSize, 2);
+    cv::Mat textLines;
+    cv::Mat textStructure = cv::getStructuringElement(cv::MORPH_RECT,
+                                                      cv::Size(std::max(1, thumb.cols / 30), 1));
+    cv::morphologyEx(adaptive, textLines, cv::MORPH_OPEN, textStructure);
+    
+    // Guide lines: same as isHandwritten, on lower-threshold edges
+    cv::Mat softEdges;
+    cv::Canny(thumb, softEdges, 30, 90);
+    cv::Mat guideLines;
+    cv::Mat guideStructure = cv::getStructuringElement(cv::MORPH_RECT,
+                                                       cv::Size(std::max(1, thumb.cols / 40), 1));
+    cv::morphologyEx(softEdges, guideLines, cv::MORPH_OPEN, guideStructure);
+    
+    // Pass 2 (fused): text-line runs, guide-line runs and edge pixels in one row sweep
+    const double textRunMin = thumb.cols * 0.1;
+    const double guideRunMin = thumb.cols * 0.3;
+    int horizontalLines = 0;
+    int guideLineCount = 0;
+    long long edgePixels = 0;
+    for (int y = 0; y < thumb.rows; y++) {
+        const uchar* textRow = textLines.ptr<uchar>(y);
+        const uchar* guideRow = guideLines.ptr<uchar>(y);
+        const uchar* edgeRow = softEdges.ptr<uchar>(y);
+        int textRun = 0;
+        int guideRun = 0;
+        for (int x = 0; x < thumb.cols; x++) {
+            if (textRow[x]) {
+                textRun++;
+            } else {
+                countRun(textRun, textRunMin, horizontalLines);
+            }
+            if (guideRow[x]) {
+                guideRun++;
+            } else {
+                countRun(guideRun, guideRunMin, guideLineCount);
+            }
+            edgePixels += edgeRow[x] ? 1 : 0;
+        }
+        countRun(textRun, textRunMin, horizontalLines);
+        countRun(guideRun, guideRunMin, guideLineCount);
+    }
+    
+    // Lines per 100 rows is scale-invariant (line thickness and height shrink together)
+    features.textCharacteristics = std::min(1.0, (horizontalLines * 100.0) / thumb.rows / 5.0);
+    
+    // Edges are 1px wide whatever the scale, so their density grows as 1/scale; undo that
+    const double edgeDensity = static_cast<double>(edgePixels) / thumbArea * scale;
+    features.handwritten = edgeDensity < 0.08 && guideLineCount >= 2;
+    
+    return features;
+}
+
+DocumentType DocumentTypeClassifier::classifyFeatures(const DocumentFeatures& features, double& confidence)
+{
+    const double contrast = features.contrast;
+    const double colorfulness = features.colorfulness;
+    const double fieldDensity = features.fieldDensity;
+    const double textChar = features.textCharacteristics;
+    const bool hasColored = features.hasColoredSections;
+    const bool handwritten = features.handwritten;
     
     // Classification logic based on expert recommendations
     
     // Handwritten forms: Low contrast, smooth edges, guide lines
     if (handwritten && contrast < 0.4) {
-        classificationConfidence = 0.75;
+        confidence = 0.75;
         return HANDWRITTEN_FORM;
     }
     
     // Government forms: High contrast, often colored sections, structured
     if (hasColored && contrast > 0.6 && fieldDensity > 0.3) {
-        classificationConfidence = 0.80;
+        confidence = 0.80;
         return GOVERNMENT_FORM;
     }
     
     // Medical forms: Colored sections, varied layouts, medium contrast
     if (hasColored && contrast > 0.4 && contrast < 0.7 && colorfulness > 0.3) {
-        classificationConfidence = 0.75;
+        confidence = 0.75;
         return MEDICAL_FORM;
     }
     
     // Tax forms: Very dense fields, high contrast, small fields
     if (fieldDensity > 0.5 && contrast > 0.65 && textChar > 0.4) {
-        classificationConfidence = 0.70;
+        confidence = 0.70;
         return TAX_FORM;
     }
     
     // Default to standard form
-    classificationConfidence = 0.60;
+    confidence = 0.60;
     return STANDARD_FORM;
 }
 
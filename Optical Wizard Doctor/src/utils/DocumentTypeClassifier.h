@@ -17,11 +17,33 @@ enum DocumentType {
     STANDARD_FORM       // Default/unknown type
 };
 
+/**
+ * @brief Features the classification heuristics look at
+ */
+struct DocumentFeatures {
+    double contrast = 0.0;              // Gray standard deviation (0.0-1.0)
+    double colorfulness = 0.0;          // Mean saturation (0.0-1.0)
+    double fieldDensity = 0.0;          // Rectangular contours per area (0.0-1.0)
+    double textCharacteristics = 0.0;   // Horizontal text-line density (0.0-1.0)
+    bool hasColoredSections = false;    // >5% saturated, not-dark pixels
+    bool handwritten = false;           // Low edge density with guide lines
+};
+
 /**
  * @brief Document type classifier
  * 
  * Classifies document types to enable adaptive thresholds and processing strategies.
  * Uses heuristics based on contrast, color distribution, field density, and text characteristics.
+ *
+ * classifyDocument() works on a fixed-size thumbnail: pixel statistics come from
+ * one fused pass over a sampling grid, structural features from the downscaled
+ * page with size thresholds scaled to match. classifyDocumentFullResolution()
+ * is the original per-feature path; validation mode runs both and reports
+ * disagreements (also enabled by OCR_ORC_VALIDATE_CLASSIFIER=1).
+ *
+ * A grayscale page has no saturation, so colorfulness and coloured sections
+ * come from setColorReference() when one is given (e.g. the display raster
+ * of a page whose detection raster was rendered in gray).
  */
 class DocumentTypeClassifier {
 public:
@@ -35,6 +57,61 @@ public:
      */
     DocumentType classifyDocument(const cv::Mat& image);
     
+    /**
+     * @brief Classify document type with separate full-resolution passes (reference path)
+     * @param image Source image
+     * @return DocumentType with classification result
+     */
+    DocumentType classifyDocumentFullResolution(const cv::Mat& image);
+    
+    /**
+     * @brief Extract classification features from a thumbnail in a single fused pass
+     * @param image Source image (gray or BGR)
+     * @return Features comparable to extractFullResolutionFeatures()
+     */
+    DocumentFeatures extractThumbnailFeatures(const cv::Mat& image);
+    
+    /**
+     * @brief Colour statistics of a page, sampled on the thumbnail grid
+     * @param image BGR or BGRA page (any size)
+     * @return Features with only colorfulness and hasColoredSections set
+     */
+    static DocumentFeatures extractColorFeatures(const cv::Mat& image);
+    
+    /**
+     * @brief Take colour statistics for grayscale pages from another raster of the same page
+     * @param image BGR or BGRA page; empty (or gray) clears the reference
+     */
+    void setColorReference(const cv::Mat& image);
+    
+    /**
+     * @brief Extract classification features at full resolution
+     * @param image Source image
+     * @return Features
+     */
+    DocumentFeatures extractFullResolutionFeatures(const cv::Mat& image);
+    
+    /**
+     * @brief Enable/disable validation against the full-resolution path
+     * @param enabled True to classify both ways and log disagreements
+     */
+    void setValidationEnabled(bool enabled) { validationEnabled = enabled; }
+    
+    /**
+     * @brief Get validation mode state
+     */
+    bool isValidationEnabled() const { return validationEnabled; }
+    
+    /**
+     * @brief Number of documents checked in validation mode
+     */
+    int getValidationCount() const { return validationCount; }
+    
+    /**
+     * @brief Number of validated documents where the two paths disagreed
+     */
+    int getValidationMismatches() const { return validationMismatches; }
+    
     /**
      * @brief Get classification confidence
      * @return Confidence score (0.0-1.0)
@@ -49,6 +126,19 @@ public:
     static QString documentTypeToString(DocumentType type);
 
 private:
+    /**
+     * @brief Apply the classification heuristics
+     * @param features Extracted features
+     * @param confidence Receives classification confidence
+     * @return DocumentType
+     */
+    static DocumentType classifyFeatures(const DocumentFeatures& features, double& confidence);
+    
+    /**
+     * @brief Replace a grayscale page's (empty) colour statistics with the colour reference's
+     */
+    void applyColorReference(const cv::Mat& image, DocumentFeatures& features) const;
+    
     /**
      * @brief Analyze contrast characteristics
      * @param image Source image
@@ -92,6 +182,11 @@ private:
     bool isHandwritten(const cv::Mat& image);
     
     double classificationConfidence;
+    DocumentFeatures colorReference;  // Colour fields only; see setColorReference()
+    bool hasColorReference;
+    bool validationEnabled;
+    int validationCount;
+    int validationMismatches;
 };
 
 } // namespace ocr_orc
@@ -1,13 +1,25 @@
 #include "FormFieldDetector.h"
 #include <opencv2/imgproc.hpp>
 #include <algorithm>
+#include <cmath>
 
 namespace ocr_orc {
 
 FormFieldDetector::FormFieldDetector()
+    : pixelScale(1.0)
 {
 }
 
+void FormFieldDetector::setPixelScale(double scale)
+{
+    pixelScale = scale > 0.0 ? scale : 1.0;
+}
+
+int FormFieldDetector::px(int pixels) const
+{
+    return std::max(1, static_cast<int>(std::lround(pixels * pixelScale)));
+}
+
 FormFieldType FormFieldDetector::detectFormField(const OCRTextRegion& textRegion, 
                                                   const cv::Mat& image,
                                                   const CheckboxDetection& checkbox)
@@ -244,8 +256,8 @@ cv::Rect FormFieldDetector::overfitRegion(const cv::Rect& region, const cv::Mat&
     int expandY = static_cast<int>(region.height * expandPercent / 100.0);
     
     // Add minimum expansion (at least 20px each direction for small regions)
-    expandX = std::max(expandX, 20);
-    expandY = std::max(expandY, 15);
+    expandX = std::max(expandX, px(20));
+    expandY = std::max(expandY, px(15));
     
     // Expand region DRASTICALLY
     cv::Rect overfitted;
@@ -274,12 +286,12 @@ cv::Rect FormFieldDetector::overfitRegionAsymmetric(const cv::Rect& region, cons
     // Add minimum expansion with emphasis on vertical
     // Horizontal: at least 25px
     // Vertical: at least 30px (more aggressive for multi-line fields)
-    expandX = std::max(expandX, 25);
-    expandY = std::max(expandY, 30);
+    expandX = std::max(expandX, px(25));
+    expandY = std::max(expandY, px(30));
     
     // For very small regions, add even more vertical room
-    if (region.height < 20) {
-        expandY = std::max(expandY, 40);  // At least 40px vertical for small regions
+    if (region.height < px(20)) {
+        expandY = std::max(expandY, px(40));  // At least 40px vertical for small regions
     }
     
     // Expand region EXTREMELY DRASTICALLY with asymmetric expansion
@@ -293,7 +305,8 @@ cv::Rect FormFieldDetector::overfitRegionAsymmetric(const cv::Rect& region, cons
 }
 
 QList<cv::Rect> FormFieldDetector::refineOverfittedRegions(const QList<cv::Rect>& overfittedRegions, 
-                                                           const cv::Mat& image)
+                                                           const cv::Mat& image,
+                                                           const std::function<bool()>& isCancelled)
 {
     QList<cv::Rect> refined;
     
@@ -310,6 +323,9 @@ QList<cv::Rect> FormFieldDetector::refineOverfittedRegions(const QList<cv::Rect>
     }
     
     for (const cv::Rect& overfitted : overfittedRegions) {
+        if (isCancelled && isCancelled()) {
+            return refined;  // Result is being discarded
+        }
         // Clamp to image bounds
         cv::Rect searchArea(
             std::max(0, overfitted.x),
@@ -356,8 +372,8 @@ QList<cv::Rect> FormFieldDetector::refineOverfittedRegions(const QList<cv::Rect>
             double rectangularity = (rectArea > 0) ? contourArea / rectArea : 0.0;
             
             // 2. Size appropriateness (form fields are typically 30-300px wide, 10-50px tall)
-            bool goodSize = (rect.width >= 30 && rect.width <= 400 && 
-                            rect.height >= 10 && rect.height <= 60);
+            bool goodSize = (rect.width >= px(30) && rect.width <= px(400) && 
+                            rect.height >= px(10) && rect.height <= px(60));
             
             // 3. Emptiness (check interior brightness)
             cv::Rect interiorRect(
@@ -386,9 +402,9 @@ QList<cv::Rect> FormFieldDetector::refineOverfittedRegions(const QList<cv::Rect>
         // If we found a good field, enhance it with hard edges (above, left, right) and more vertical height
         if (bestField.width > 0 && bestField.height > 0) {
             // Find hard edges: ABOVE, LEFT, and RIGHT
-            int edgeY = findHardEdgeAbove(bestField, image, 80);  // Search 80px above
-            int edgeXLeft = findHardEdgeLeft(bestField, image, 80);  // Search 80px left
-            int edgeXRight = findHardEdgeRight(bestField, image, 80);  // Search 80px right
+            int edgeY = findHardEdgeAbove(bestField, image, px(80));  // Search 80px above
+            int edgeXLeft = findHardEdgeLeft(bestField, image, px(80));  // Search 80px left
+            int edgeXRight = findHardEdgeRight(bestField, image, px(80));  // Search 80px right
             
             cv::Rect enhancedField = bestField;
             
@@ -451,7 +467,7 @@ QList<cv::Rect> FormFieldDetector::refineOverfittedRegions(const QList<cv::Rect>
             cv::Mat binary;
             cv::threshold(roi, binary, 127, 255, cv::THRESH_BINARY_INV);
             
-            cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(40, 1));
+            cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(40), 1));
             cv::Mat horizontalLines;
             cv::morphologyEx(binary, horizontalLines, cv::MORPH_OPEN, horizontalKernel);
             
@@ -468,17 +484,17 @@ QList<cv::Rect> FormFieldDetector::refineOverfittedRegions(const QList<cv::Rect>
                     lineRect.x += searchArea.x;
                     lineRect.y += searchArea.y;
                     
-                    if (lineRect.width > maxWidth && lineRect.width > 30) {
+                    if (lineRect.width > maxWidth && lineRect.width > px(30)) {
                         maxWidth = lineRect.width;
                         // Create field above the line with MORE vertical height
-                        int fieldHeight = 35;  // Increased from 20 to 35px
+                        int fieldHeight = px(35);  // Increased from 20 to 35px
                         int fieldTop = std::max(0, lineRect.y - fieldHeight);
                         
                         // Find hard edges: above, left, right to anchor to
                         cv::Rect tempField(lineRect.x, fieldTop, lineRect.width, fieldHeight);
-                        int edgeY = findHardEdgeAbove(tempField, image, 60);
-                        int edgeXLeft = findHardEdgeLeft(tempField, image, 60);
-                        int edgeXRight = findHardEdgeRight(tempField, image, 60);
+                        int edgeY = findHardEdgeAbove(tempField, image, px(60));
+                        int edgeXLeft = findHardEdgeLeft(tempField, image, px(60));
+                        int edgeXRight = findHardEdgeRight(tempField, image, px(60));
                         
                         if (edgeY >= 0) {
                             fieldTop = edgeY;
@@ -539,11 +555,15 @@ QList<cv::Rect> FormFieldDetector::refineOverfittedRegions(const QList<cv::Rect>
 
 QList<cv::Rect> FormFieldDetector::classifyAndRefineRegions(const QList<cv::Rect>& regions,
                                                            const cv::Mat& image,
-                                                           const QList<OCRTextRegion>& ocrRegions)
+                                                           const QList<OCRTextRegion>& ocrRegions,
+                                                           const std::function<bool()>& isCancelled)
 {
     QList<cv::Rect> validFields;
     
     for (const cv::Rect& region : regions) {
+        if (isCancelled && isCancelled()) {
+            return validFields;  // Result is being discarded
+        }
         // First check: Filter out titles/headings aggressively
         if (isTitleOrHeading(region, image, ocrRegions)) {
             continue;  // Skip titles/headings
@@ -611,7 +631,7 @@ FormFieldType FormFieldDetector::classifyRegionType(const cv::Rect& region,
         cv::Mat binary;
         cv::threshold(gray, binary, 127, 255, cv::THRESH_BINARY_INV);
         
-        cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(30, 1));
+        cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(30), 1));
         cv::Mat horizontalLines;
         cv::morphologyEx(binary, horizontalLines, cv::MORPH_OPEN, horizontalKernel);
         
@@ -640,7 +660,7 @@ FormFieldType FormFieldDetector::classifyRegionType(const cv::Rect& region,
                 double rectangularity = (rectArea > 0) ? contourArea / rectArea : 0.0;
                 
                 // If we find a good rectangular border, it's a cell
-                if (rectangularity > 0.7 && boxRect.width > 20 && boxRect.height > 10) {
+                if (rectangularity > 0.7 && boxRect.width > px(20) && boxRect.height > px(10)) {
                     return FormFieldType::Cell;
                 }
             }
@@ -680,7 +700,7 @@ bool FormFieldDetector::isTitleOrHeading(const cv::Rect& region,
             totalOverlapArea += overlapArea;
             
             // Large text size suggests title/heading
-            if (ocrBox.height > 18 || ocrBox.width > 80) {
+            if (ocrBox.height > px(18) || ocrBox.width > px(80)) {
                 largeTextCount++;
             }
         }
@@ -692,8 +712,8 @@ bool FormFieldDetector::isTitleOrHeading(const cv::Rect& region,
     }
     
     // Heuristic 2: Check region size and brightness
-    bool isVeryLarge = (region.height > 35 || region.width > image.cols * 0.75);
-    bool isVeryWide = (region.width > image.cols * 0.6 && region.height < 30);
+    bool isVeryLarge = (region.height > px(35) || region.width > image.cols * 0.75);
+    bool isVeryWide = (region.width > image.cols * 0.6 && region.height < px(30));
     
     if (isVeryLarge || isVeryWide) {
         cv::Rect clampedRegion(
@@ -746,7 +766,7 @@ bool FormFieldDetector::isTitleOrHeading(const cv::Rect& region,
         double edgeDensity = static_cast<double>(edgePixels) / (roi.rows * roi.cols);
         
         // High edge density (>0.15) suggests text content (title)
-        if (edgeDensity > 0.15 && region.height > 25) {
+        if (edgeDensity > 0.15 && region.height > px(25)) {
             return true;
         }
         
@@ -755,7 +775,7 @@ bool FormFieldDetector::isTitleOrHeading(const cv::Rect& region,
         cv::threshold(gray, binary, 127, 255, cv::THRESH_BINARY_INV);
         
         // Look for horizontal lines (underlines)
-        cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(30, 1));
+        cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(30), 1));
         cv::Mat horizontalLines;
         cv::morphologyEx(binary, horizontalLines, cv::MORPH_OPEN, horizontalKernel);
         
@@ -812,7 +832,7 @@ bool FormFieldDetector::isTextBlock(const cv::Rect& region, const cv::Mat& image
     cv::Mat binary;
     cv::threshold(gray, binary, 127, 255, cv::THRESH_BINARY_INV);
     
-    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(30, 1));
+    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(30), 1));
     cv::Mat horizontalLines;
     cv::morphologyEx(binary, horizontalLines, cv::MORPH_OPEN, horizontalKernel);
     
@@ -848,14 +868,14 @@ bool FormFieldDetector::isTextBlock(const cv::Rect& region, const cv::Mat& image
                 }
             }
             
-            if (consistentSpacing && avgSpacing > 10) {
+            if (consistentSpacing && avgSpacing > px(10)) {
                 return true;  // Text block (multi-line handwriting area)
             }
         }
     }
     
     // Also check height - text blocks are typically taller than single lines
-    if (region.height > 40) {  // More than typical line height
+    if (region.height > px(40)) {  // More than typical line height
         return true;
     }
     
@@ -896,7 +916,7 @@ int FormFieldDetector::findHardEdgeAbove(const cv::Rect& region, const cv::Mat&
     cv::Canny(roi, edges, 50, 150);
     
     // Use horizontal morphology to find strong horizontal lines
-    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(30, 1));
+    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(30), 1));
     cv::Mat horizontalLines;
     cv::morphologyEx(edges, horizontalLines, cv::MORPH_DILATE, horizontalKernel);
     
@@ -930,7 +950,7 @@ int FormFieldDetector::findHardEdgeAbove(const cv::Rect& region, const cv::Mat&
         cv::Mat binary;
         cv::threshold(roi, binary, 127, 255, cv::THRESH_BINARY_INV);
         
-        cv::Mat horizontalKernel2 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(40, 1));
+        cv::Mat horizontalKernel2 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(40), 1));
         cv::Mat horizontalLines2;
         cv::morphologyEx(binary, horizontalLines2, cv::MORPH_OPEN, horizontalKernel2);
         
@@ -948,7 +968,7 @@ int FormFieldDetector::findHardEdgeAbove(const cv::Rect& region, const cv::Mat&
                 
                 // Prefer lines closer to the region (but not too close)
                 int distanceFromRegion = region.y - edgeY;
-                if (distanceFromRegion > 5 && distanceFromRegion < searchHeight) {
+                if (distanceFromRegion > px(5) && distanceFromRegion < searchHeight) {
                     if (lineRect.width > maxWidth) {
                         maxWidth = lineRect.width;
                         bestEdgeY = edgeY;
@@ -995,7 +1015,7 @@ int FormFieldDetector::findHardEdgeLeft(const cv::Rect& region, const cv::Mat& i
     cv::Canny(roi, edges, 30, 100);  // Lower thresholds for more sensitivity
     
     // Use vertical morphology to find strong vertical lines
-    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 25));
+    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(25)));
     cv::Mat verticalLines;
     cv::morphologyEx(edges, verticalLines, cv::MORPH_DILATE, verticalKernel, cv::Point(-1, -1), 2);
     
@@ -1039,7 +1059,7 @@ int FormFieldDetector::findHardEdgeLeft(const cv::Rect& region, const cv::Mat& i
         cv::Mat binary2;
         cv::threshold(roi, binary2, 127, 255, cv::THRESH_BINARY_INV);
         
-        cv::Mat verticalKernel2 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 30));
+        cv::Mat verticalKernel2 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(30)));
         cv::Mat verticalLines3;
         cv::morphologyEx(binary2, verticalLines3, cv::MORPH_OPEN, verticalKernel2);
         
@@ -1057,7 +1077,7 @@ int FormFieldDetector::findHardEdgeLeft(const cv::Rect& region, const cv::Mat& i
                 
                 // Prefer lines closer to the region (but not too close)
                 int distanceFromRegion = region.x - edgeX;
-                if (distanceFromRegion > 5 && distanceFromRegion < searchWidth) {
+                if (distanceFromRegion > px(5) && distanceFromRegion < searchWidth) {
                     if (lineRect.height > maxHeight) {
                         maxHeight = lineRect.height;
                         bestEdgeX = edgeX;
@@ -1104,7 +1124,7 @@ int FormFieldDetector::findHardEdgeRight(const cv::Rect& region, const cv::Mat&
     cv::Canny(roi, edges, 30, 100);  // Lower thresholds for more sensitivity
     
     // Use vertical morphology to find strong vertical lines
-    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 25));
+    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(25)));
     cv::Mat verticalLines;
     cv::morphologyEx(edges, verticalLines, cv::MORPH_DILATE, verticalKernel, cv::Point(-1, -1), 2);
     
@@ -1148,7 +1168,7 @@ int FormFieldDetector::findHardEdgeRight(const cv::Rect& region, const cv::Mat&
         cv::Mat binary2;
         cv::threshold(roi, binary2, 127, 255, cv::THRESH_BINARY_INV);
         
-        cv::Mat verticalKernel2 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 30));
+        cv::Mat verticalKernel2 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(30)));
         cv::Mat verticalLines3;
         cv::morphologyEx(binary2, verticalLines3, cv::MORPH_OPEN, verticalKernel2);
         
@@ -1166,7 +1186,7 @@ int FormFieldDetector::findHardEdgeRight(const cv::Rect& region, const cv::Mat&
                 
                 // Prefer lines closer to the region (but not too close)
                 int distanceFromRegion = edgeX - (region.x + region.width);
-                if (distanceFromRegion > 5 && distanceFromRegion < searchWidth) {
+                if (distanceFromRegion > px(5) && distanceFromRegion < searchWidth) {
                     if (lineRect.height > maxHeight) {
                         maxHeight = lineRect.height;
                         bestEdgeX = edgeX;
@@ -1189,10 +1209,10 @@ QList<int> FormFieldDetector::findVerticalWalls(const cv::Rect& region, const cv
     
     // Expand search area MORE to catch walls at edges and between cells
     cv::Rect searchArea(
-        std::max(0, region.x - 15),  // More expansion
-        std::max(0, region.y - 5),
-        std::min(image.cols - std::max(0, region.x - 15), region.width + 30),  // More expansion
-        std::min(image.rows - std::max(0, region.y - 5), region.height + 10)
+        std::max(0, region.x - px(15)),  // More expansion
+        std::max(0, region.y - px(5)),
+        std::min(image.cols - std::max(0, region.x - px(15)), region.width + px(30)),  // More expansion
+        std::min(image.rows - std::max(0, region.y - px(5)), region.height + px(10))
     );
     
     if (searchArea.width <= 0 || searchArea.height <= 0) {
@@ -1215,7 +1235,7 @@ QList<int> FormFieldDetector::findVerticalWalls(const cv::Rect& region, const cv
     cv::Canny(roi, edges, 20, 80);  // Even lower thresholds for maximum sensitivity
     
     // Use vertical morphology with longer kernel to catch full-height walls
-    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 20));  // Taller kernel
+    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(20)));  // Taller kernel
     cv::Mat verticalLines;
     cv::morphologyEx(edges, verticalLines, cv::MORPH_DILATE, verticalKernel, cv::Point(-1, -1), 3);  // More iterations
     
@@ -1255,7 +1275,7 @@ QList<int> FormFieldDetector::findVerticalWalls(const cv::Rect& region, const cv
             int wallX = searchArea.x + lineRect.x + lineRect.width / 2;
             
             // Check if wall is within or near the region (wider tolerance)
-            if (wallX >= region.x - 15 && wallX <= region.x + region.width + 15) {
+            if (wallX >= region.x - px(15) && wallX <= region.x + region.width + px(15)) {
                 wallXCoords.append(wallX);
             }
         }
@@ -1266,7 +1286,7 @@ QList<int> FormFieldDetector::findVerticalWalls(const cv::Rect& region, const cv
     cv::Mat houghEdges;
     cv::Canny(roi, houghEdges, 20, 80);
     std::vector<cv::Vec4i> lines;
-    cv::HoughLinesP(houghEdges, lines, 1, CV_PI/180, 30, 20, 10);  // Detect short lines too
+    cv::HoughLinesP(houghEdges, lines, 1, CV_PI/180, px(30), px(20), px(10));  // Detect short lines too
     
     for (const cv::Vec4i& line : lines) {
         int x1 = line[0];
@@ -1278,7 +1298,7 @@ QList<int> FormFieldDetector::findVerticalWalls(const cv::Rect& region, const cv
         if (std::abs(x1 - x2) < 3 && std::abs(y1 - y2) > region.height * 0.4) {
             int wallX = searchArea.x + (x1 + x2) / 2;
             
-            if (wallX >= region.x - 15 && wallX <= region.x + region.width + 15) {
+            if (wallX >= region.x - px(15) && wallX <= region.x + region.width + px(15)) {
                 wallXCoords.append(wallX);
             }
         }
@@ -1309,9 +1329,9 @@ QList<int> FormFieldDetector::findHorizontalEdges(const cv::Rect& region, const
     // Expand search area slightly
     cv::Rect searchArea(
         std::max(0, region.x),
-        std::max(0, region.y - 5),
+        std::max(0, region.y - px(5)),
         std::min(image.cols - std::max(0, region.x), region.width),
-        std::min(image.rows - std::max(0, region.y - 5), region.height + 10)
+        std::min(image.rows - std::max(0, region.y - px(5)), region.height + px(10))
     );
     
     if (searchArea.width <= 0 || searchArea.height <= 0) {
@@ -1334,7 +1354,7 @@ QList<int> FormFieldDetector::findHorizontalEdges(const cv::Rect& region, const
     cv::Canny(roi, edges, 30, 100);  // Lower thresholds for more sensitivity
     
     // Use horizontal morphology to find horizontal lines
-    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(25, 1));  // Wider kernel
+    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(25), 1));  // Wider kernel
     cv::Mat horizontalLines;
     cv::morphologyEx(edges, horizontalLines, cv::MORPH_DILATE, horizontalKernel, cv::Point(-1, -1), 2);
     
@@ -1365,7 +1385,7 @@ QList<int> FormFieldDetector::findHorizontalEdges(const cv::Rect& region, const
             int edgeY = searchArea.y + lineRect.y + lineRect.height / 2;
             
             // Check if edge is within or near the region
-            if (edgeY >= region.y - 10 && edgeY <= region.y + region.height + 10) {
+            if (edgeY >= region.y - px(10) && edgeY <= region.y + region.height + px(10)) {
                 edgeYCoords.append(edgeY);
             }
         }
@@ -1377,7 +1397,7 @@ QList<int> FormFieldDetector::findHorizontalEdges(const cv::Rect& region, const
     // Remove duplicates (edges within 5px of each other)
     QList<int> uniqueEdges;
     for (int y : edgeYCoords) {
-        if (uniqueEdges.isEmpty() || std::abs(y - uniqueEdges.last()) > 5) {
+        if (uniqueEdges.isEmpty() || std::abs(y - uniqueEdges.last()) > px(5)) {
             uniqueEdges.append(y);
         }
     }
@@ -1386,7 +1406,8 @@ QList<int> FormFieldDetector::findHorizontalEdges(const cv::Rect& region, const
 }
 
 QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const QList<cv::Rect>& regions, 
-                                                                          const cv::Mat& image)
+                                                                          const cv::Mat& image,
+                                                                          const std::function<bool()>& isCancelled)
 {
     QList<QList<cv::Rect>> cellGroups;
     
@@ -1407,7 +1428,7 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
     cv::Canny(gray, edges, 20, 80);  // Very sensitive for thin walls
     
     // Use vertical morphology with longer kernel
-    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 25));
+    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(25)));
     cv::Mat verticalLines;
     cv::morphologyEx(edges, verticalLines, cv::MORPH_DILATE, verticalKernel, cv::Point(-1, -1), 3);
     
@@ -1441,7 +1462,7 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
         
         // MORE LENIENT: Check if it's a vertical wall (height > width * 1.5, and height > 25px)
         // This catches thinner walls between cells
-        if (wallRect.height > wallRect.width * 1.5 && wallRect.height > 25) {
+        if (wallRect.height > wallRect.width * 1.5 && wallRect.height > px(25)) {
             int wallX = wallRect.x + wallRect.width / 2;
             allWallXCoords.append(wallX);
         }
@@ -1449,7 +1470,7 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
     
     // Also use HoughLinesP for very thin walls
     std::vector<cv::Vec4i> houghLines;
-    cv::HoughLinesP(edges, houghLines, 1, CV_PI/180, 25, 15, 8);  // Detect shorter lines too
+    cv::HoughLinesP(edges, houghLines, 1, CV_PI/180, px(25), px(15), px(8));  // Detect shorter lines too
     
     for (const cv::Vec4i& line : houghLines) {
         int x1 = line[0];
@@ -1458,7 +1479,7 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
         int y2 = line[3];
         
         // Check if it's a vertical line
-        if (std::abs(x1 - x2) < 3 && std::abs(y1 - y2) > 25) {
+        if (std::abs(x1 - x2) < 3 && std::abs(y1 - y2) > px(25)) {
             int wallX = (x1 + x2) / 2;
             allWallXCoords.append(wallX);
         }
@@ -1477,6 +1498,9 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
     QList<bool> processed(regions.size(), false);
     
     for (int i = 0; i < regions.size(); i++) {
+        if (isCancelled && isCancelled()) {
+            return cellGroups;  // Result is being discarded
+        }
         if (processed[i]) continue;
         
         QList<cv::Rect> group;
@@ -1499,7 +1523,7 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
             int yDiff = std::abs(currentRegion.y - otherRegion.y);
             int heightDiff = std::abs(currentRegion.height - otherRegion.height);
             
-            if (yDiff < 10 && heightDiff < 10) {
+            if (yDiff < px(10) && heightDiff < px(10)) {
                 // Check if they share a wall (one region's edge aligns with a wall)
                 bool sharesWall = false;
                 
@@ -1508,19 +1532,19 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
                 int rightLeftGap = currentRegion.x - (otherRegion.x + otherRegion.width);
                 
                 // Check if gap is small and contains a wall
-                if (leftRightGap >= 0 && leftRightGap < 20) {
+                if (leftRightGap >= 0 && leftRightGap < px(20)) {
                     // Check if there's a wall in the gap
                     for (int wallX : uniqueWalls) {
-                        if (wallX >= currentRegion.x + currentRegion.width - 5 &&
-                            wallX <= otherRegion.x + 5) {
+                        if (wallX >= currentRegion.x + currentRegion.width - px(5) &&
+                            wallX <= otherRegion.x + px(5)) {
                             sharesWall = true;
                             break;
                         }
                     }
-                } else if (rightLeftGap >= 0 && rightLeftGap < 20) {
+                } else if (rightLeftGap >= 0 && rightLeftGap < px(20)) {
                     for (int wallX : uniqueWalls) {
-                        if (wallX >= otherRegion.x + otherRegion.width - 5 &&
-                            wallX <= currentRegion.x + 5) {
+                        if (wallX >= otherRegion.x + otherRegion.width - px(5) &&
+                            wallX <= currentRegion.x + px(5)) {
                             sharesWall = true;
                             break;
                         }
@@ -1530,7 +1554,7 @@ QList<QList<cv::Rect>> FormFieldDetector::detectCellGroupsWithSharedWalls(const
                 // Also check if regions are directly adjacent (touching or very close)
                 if (!sharesWall) {
                     int gap = std::min(leftRightGap, rightLeftGap);
-                    if (gap >= 0 && gap < 5) {
+                    if (gap >= 0 && gap < px(5)) {
                         sharesWall = true;  // Directly adjacent, likely share a wall
                     }
                 }
@@ -6,6 +6,7 @@
 #include <opencv2/opencv.hpp>
 #include <QtCore/QString>
 #include <QtCore/QList>
+#include <functional>
 
 namespace ocr_orc {
 
@@ -36,6 +37,13 @@ public:
     FormFieldDetector();
     ~FormFieldDetector() = default;
     
+    /**
+     * @brief Scale the built-in pixel sizes (minimum overfit, field size limits,
+     *        edge search ranges, line kernels) to the page raster
+     * @param scale Raster size relative to a full-resolution page (1.0 = unchanged)
+     */
+    void setPixelScale(double scale);
+    
     /**
      * @brief Detect form field type for a text region
      * @param textRegion OCR text region
@@ -68,11 +76,13 @@ public:
      * @param regions List of detected regions (cv::Rect)
      * @param image Source image
      * @param ocrRegions All OCR text regions for context
+     * @param isCancelled Polled before each candidate; may be empty (a cancelled call returns what it has)
      * @return List of classified and validated form fields
      */
     QList<cv::Rect> classifyAndRefineRegions(const QList<cv::Rect>& regions,
                                              const cv::Mat& image,
-                                             const QList<OCRTextRegion>& ocrRegions);
+                                             const QList<OCRTextRegion>& ocrRegions,
+                                             const std::function<bool()>& isCancelled = std::function<bool()>());
     
     /**
      * @brief Drastically overfit a region (expand by percentage)
@@ -100,9 +110,11 @@ public:
      * Looks for hard edges ABOVE regions to use as anchor points
      * @param overfittedRegions List of overfitted regions
      * @param image Source image
+     * @param isCancelled Polled before each candidate; may be empty (a cancelled call returns what it has)
      * @return Refined regions with accurate boundaries and increased vertical height
      */
-    QList<cv::Rect> refineOverfittedRegions(const QList<cv::Rect>& overfittedRegions, const cv::Mat& image);
+    QList<cv::Rect> refineOverfittedRegions(const QList<cv::Rect>& overfittedRegions, const cv::Mat& image,
+                                            const std::function<bool()>& isCancelled = std::function<bool()>());
     
     /**
      * @brief Find hard edge (horizontal line) above a region to use as anchor
@@ -135,9 +147,11 @@ public:
      * @brief Detect groups of cells that share vertical walls (grid pattern)
      * @param regions List of detected regions
      * @param image Source image
+     * @param isCancelled Polled before each candidate; may be empty (a cancelled call returns what it has)
      * @return List of cell groups (each group contains cells sharing walls)
      */
-    QList<QList<cv::Rect>> detectCellGroupsWithSharedWalls(const QList<cv::Rect>& regions, const cv::Mat& image);
+    QList<QList<cv::Rect>> detectCellGroupsWithSharedWalls(const QList<cv::Rect>& regions, const cv::Mat& image,
+                                                           const std::function<bool()>& isCancelled = std::function<bool()>());
     
     /**
      * @brief Find vertical walls/lines between cells (more sensitive detection)
@@ -186,6 +200,13 @@ public:
     bool isTextBlock(const cv::Rect& region, const cv::Mat& image);
 
 private:
+    double pixelScale;  // See setPixelScale()
+    
+    /**
+     * @brief Pixel size scaled by pixelScale (at least 1)
+     */
+    int px(int pixels) const;
+    
     /**
      * @brief Detect single-line text input field
      * @param textRegion OCR text region
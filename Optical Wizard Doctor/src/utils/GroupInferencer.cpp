@@ -14,18 +14,19 @@ namespace ocr_orc {
 GroupInferencer::GroupInferencer() {
 }
 
-bool GroupInferencer::areTypesConsistent(const QList<DetectedRegion>& regions) {
-    if (regions.isEmpty()) {
+bool GroupInferencer::areTypesConsistent(const DetectedRegionBatch& batch, const int* begin, const int* end) {
+    if (begin == end) {
         return true;
     }
     
-    QString firstType = regions[0].inferredType;
-    if (firstType == "unknown") {
+    int firstType = batch.typeCode(*begin);
+    if (firstType == REGION_TYPE_UNKNOWN) {
         return true; // Unknown types are considered consistent
     }
     
-    for (const DetectedRegion& region : regions) {
-        if (region.inferredType != "unknown" && region.inferredType != firstType) {
+    for (const int* it = begin; it != end; ++it) {
+        int type = batch.typeCode(*it);
+        if (type != REGION_TYPE_UNKNOWN && type != firstType) {
             return false; // Type mismatch
         }
     }
@@ -33,28 +34,27 @@ bool GroupInferencer::areTypesConsistent(const QList<DetectedRegion>& regions) {
     return true;
 }
 
-bool GroupInferencer::areSizesConsistent(const QList<DetectedRegion>& regions, double tolerance) {
-    if (regions.size() < 2) {
+bool GroupInferencer::areSizesConsistent(const DetectedRegionBatch& batch, const int* begin, const int* end,
+                                         double tolerance) {
+    const int count = static_cast<int>(end - begin);
+    if (count < 2) {
         return true;
     }
     
     // Calculate average size
     double avgWidth = 0.0;
     double avgHeight = 0.0;
-    for (const auto& region : regions) {
-        avgWidth += (region.coords.x2 - region.coords.x1);
-        avgHeight += (region.coords.y2 - region.coords.y1);
+    for (const int* it = begin; it != end; ++it) {
+        avgWidth += batch.width(*it);
+        avgHeight += batch.height(*it);
     }
-    avgWidth /= regions.size();
-    avgHeight /= regions.size();
+    avgWidth /= count;
+    avgHeight /= count;
     
     // Check if all regions are within tolerance
-    for (const auto& region : regions) {
-        double width = region.coords.x2 - region.coords.x1;
-        double height = region.coords.y2 - region.coords.y1;
-        
-        double widthDev = std::abs(width - avgWidth) / avgWidth;
-        double heightDev = std::abs(height - avgHeight) / avgHeight;
+    for (const int* it = begin; it != end; ++it) {
+        double widthDev = std::abs(batch.width(*it) - avgWidth) / avgWidth;
+        double heightDev = std::abs(batch.height(*it) - avgHeight) / avgHeight;
         
         if (widthDev > tolerance || heightDev > tolerance) {
             return false;
@@ -65,44 +65,49 @@ bool GroupInferencer::areSizesConsistent(const QList<DetectedRegion>& regions, d
 }
 
 QList<DetectedGroup> GroupInferencer::inferGroupsFromSpatial(const QList<DetectedRegion>& regions) {
+    scratchGraph.build(regions, 0.0);
+    return inferGroupsFromSpatial(scratchGraph);
+}
+
+QList<DetectedGroup> GroupInferencer::inferGroupsFromSpatial(const RegionNeighborGraph& graph) {
     QList<DetectedGroup> groups;
+    const DetectedRegionBatch& batch = graph.getBatch();
     
-    if (regions.isEmpty()) {
+    if (batch.isEmpty()) {
         return groups;
     }
     
     // Cluster by horizontal alignment (rows)
-    QList<QList<DetectedRegion>> rows = clusterer.clusterByHorizontalAlignment(regions, 0.01);
+    clusterer.clusterIndicesByHorizontalAlignment(graph, 0.01, rowClusters);
     
     int groupIndex = 0;
-    for (const auto& row : rows) {
-        if (row.size() < 2) {
+    for (int r = 0; r < rowClusters.clusterCount(); ++r) {
+        const int* begin = rowClusters.clusterBegin(r);
+        const int* end = rowClusters.clusterEnd(r);
+        const int rowSize = rowClusters.clusterSize(r);
+        if (rowSize < 2) {
             continue; // Need at least 2 regions for a group
         }
         
         // Check type and size consistency
-        if (areTypesConsistent(row) && areSizesConsistent(row, 0.3)) {
+        if (areTypesConsistent(batch, begin, end) && areSizesConsistent(batch, begin, end, 0.3)) {
             // Create group
             DetectedGroup group;
             group.name = QString("Group_%1").arg(groupIndex + 1);
             
             // Generate region names
-            for (int i = 0; i < row.size(); ++i) {
+            for (int i = 0; i < rowSize; ++i) {
                 group.regionNames.append(QString("region_%1_%2").arg(groupIndex + 1).arg(i + 1));
             }
             
             // Suggest color based on inferred type
-            if (!row.isEmpty()) {
-                QString type = row[0].inferredType;
-                if (type == "letters") {
-                    group.suggestedColor = groupIndex % 2 == 0 ? "blue" : "red";
-                } else if (type == "numbers") {
-                    group.suggestedColor = "green";
-                } else {
-                    group.suggestedColor = "yellow";
-                }
+            int type = batch.typeCode(*begin);
+            if (type == REGION_TYPE_LETTERS) {
+                group.suggestedColor = groupIndex % 2 == 0 ? "blue" : "red";
+            } else if (type == REGION_TYPE_NUMBERS) {
+                group.suggestedColor = "green";
             } else {
-                group.suggestedColor = "blue"; // Default
+                group.suggestedColor = "yellow";
             }
             
             group.confidence = 0.7; // Medium confidence for spatial grouping
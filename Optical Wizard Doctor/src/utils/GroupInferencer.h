@@ -6,6 +6,8 @@
 #include <QtCore/QString>
 #include "RegionDetector.h"
 #include "SpatialClusterer.h"
+#include "DetectedRegionBatch.h"
+#include "RegionNeighborGraph.h"
 #include "patterns/PostalCodePatternDetector.h"
 #include "patterns/NameFieldPatternDetector.h"
 #include "patterns/NumberSequencePatternDetector.h"
@@ -32,6 +34,13 @@ public:
      */
     QList<DetectedGroup> inferGroupsFromSpatial(const QList<DetectedRegion>& regions);
     
+    /**
+     * @brief Infer groups from spatial relationships of a prebuilt neighbour graph
+     * @param graph Neighbour graph (shared with grid detection and validation)
+     * @return List of inferred groups
+     */
+    QList<DetectedGroup> inferGroupsFromSpatial(const RegionNeighborGraph& graph);
+    
     /**
      * @brief Infer groups from detected patterns
      * @param regions List of detected regions
@@ -49,19 +58,22 @@ public:
 
 private:
     SpatialClusterer clusterer;
+    RegionNeighborGraph scratchGraph;  // Sorted orders only (radius 0)
+    RegionIndexClusters rowClusters;
     PostalCodePatternDetector postalCodeDetector;
     NameFieldPatternDetector nameFieldDetector;
     NumberSequencePatternDetector numberSequenceDetector;
     
     /**
-     * @brief Check type consistency in a group
+     * @brief Check type consistency in a group of batch rows
      */
-    bool areTypesConsistent(const QList<DetectedRegion>& regions);
+    bool areTypesConsistent(const DetectedRegionBatch& batch, const int* begin, const int* end);
     
     /**
-     * @brief Check size consistency in a group
+     * @brief Check size consistency in a group of batch rows
      */
-    bool areSizesConsistent(const QList<DetectedRegion>& regions, double tolerance = 0.3);
+    bool areSizesConsistent(const DetectedRegionBatch& batch, const int* begin, const int* end,
+                            double tolerance = 0.3);
 };
 
 } // namespace ocr_orc
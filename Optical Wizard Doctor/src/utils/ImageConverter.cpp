@@ -35,6 +35,16 @@ cv::Mat ImageConverter::qImageToMat(const QImage& qImage) {
     return bgrMat.clone();
 }
 
+cv::Mat ImageConverter::qImageToDetectionMat(const QImage& qImage) {
+    if (qImage.format() != QImage::Format_Grayscale8) {
+        return qImageToMat(qImage);
+    }
+    
+    // Already what the detectors convert to: share the pixels (constBits() never detaches)
+    return cv::Mat(qImage.height(), qImage.width(), CV_8UC1,
+                   const_cast<uchar*>(qImage.constBits()), qImage.bytesPerLine());
+}
+
 QImage ImageConverter::matToQImage(const cv::Mat& mat) {
     if (mat.empty()) {
         return QImage();
@@ -23,6 +23,14 @@ public:
      */
     static cv::Mat qImageToMat(const QImage& qImage);
     
+    /**
+     * @brief Convert a page for detection, keeping grayscale pages as they are
+     * @param qImage Source page (must outlive the returned Mat if it is Grayscale8)
+     * @return Single-channel Mat sharing the pixels of a Format_Grayscale8 page
+     *         (read-only, no copy); BGR via qImageToMat() for any other format
+     */
+    static cv::Mat qImageToDetectionMat(const QImage& qImage);
+    
     /**
      * @brief Convert cv::Mat to QImage
      * @param mat Source cv::Mat (any type)
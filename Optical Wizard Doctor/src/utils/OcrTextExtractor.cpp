@@ -2,6 +2,7 @@
 #include "ImageConverter.h"
 #include "../core/CoordinateSystem.h"
 #include <tesseract/baseapi.h>
+#include <tesseract/ocrclass.h>
 #include <leptonica/allheaders.h>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
@@ -13,6 +14,8 @@
 #include <QtCore/QJsonObject>
 #include <QtCore/QDateTime>
 #include <QtCore/QVariantMap>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
 #include <cstdio>
 #include <algorithm>
 #include <cmath>
@@ -40,16 +43,70 @@ static void debugLog(const QString& location, const QString& message, const QVar
 }
 // #endregion
 
+// Tesseract's cancel monitor callback; polled between words, true stops Recognize()
+static bool recognitionCancelled(void* isCancelled, int /*words*/) {
+    return (*static_cast<const std::function<bool()>*>(isCancelled))();
+}
+
+// Block/line/word numbering shared by every word reader: a new block when
+// Tesseract's block type changes, a new line when the top edge moves more than
+// 5px from the line's first word (output pixels)
+struct WordNumbering {
+    int blockId = 0;
+    int lineId = 0;
+    int wordId = 0;
+    int blockType = -1;
+    int lineTop = -1;
+    
+    void advance(int type, int top) {
+        if (type != blockType) {
+            blockType = type;
+            blockId++;
+            wordId = 0;
+        }
+        if (lineTop == -1) {
+            lineTop = top;
+            wordId = 0;
+        } else if (abs(top - lineTop) > 5) {
+            lineId++;
+            lineTop = top;
+            wordId = 0;
+        } else {
+            wordId++;
+        }
+    }
+};
+
 OcrTextExtractor::OcrTextExtractor()
     : minConfidence(60.0)  // Expert recommendation: 60% threshold (default was 50.0)
+    , refinementConfidence(90.0)
+    , lastLayoutWordCount(0)
+    , lastRefinedSegmentCount(0)
+    , roiApi(nullptr)
 {
 }
 
 OcrTextExtractor::~OcrTextExtractor()
 {
+    if (roiApi != nullptr) {
+        tesseract::TessBaseAPI* api = static_cast<tesseract::TessBaseAPI*>(roiApi);
+        api->End();
+        delete api;
+        roiApi = nullptr;
+    }
 }
 
 QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
+{
+    if (image.isNull()) {
+        fprintf(stderr, "[OcrTextExtractor::extractTextRegions] ERROR: Image is null!\n");
+        fflush(stderr);
+        return QList<OCRTextRegion>();
+    }
+    return extractTextRegions(ImageConverter::qImageToMat(image));
+}
+
+QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const cv::Mat& image)
 {
     fprintf(stderr, "[OcrTextExtractor::extractTextRegions] ========== OCR EXTRACTION START ==========\n");
     fflush(stderr);
@@ -60,23 +117,23 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
     try {
         fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Step 1: Validating input image...\n");
         fflush(stderr);
-        if (image.isNull()) {
-            fprintf(stderr, "[OcrTextExtractor::extractTextRegions] ERROR: Image is null!\n");
+        if (image.empty()) {
+            fprintf(stderr, "[OcrTextExtractor::extractTextRegions] ERROR: Image is empty!\n");
             fflush(stderr);
             return regions;
         }
         
-        fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Step 1: ✓ Image valid - Size: %dx%d, Format: %d\n", 
-                image.width(), image.height(), image.format());
+        fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Step 1: ✓ Image valid - Size: %dx%d, Channels: %d\n", 
+                image.cols, image.rows, image.channels());
         fflush(stderr);
-        qDebug() << "[OcrTextExtractor::extractTextRegions] Image dimensions:" << image.width() << "x" << image.height();
+        qDebug() << "[OcrTextExtractor::extractTextRegions] Image dimensions:" << image.cols << "x" << image.rows;
         
         fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Step 2: Preprocessing image...\n");
         fflush(stderr);
         // Preprocess image
         cv::Mat preprocessed;
         try {
-            preprocessed = preprocessImage(image);
+            preprocessed = preprocessMat(image);
             fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Step 2: ✓ Preprocessing complete\n");
             fflush(stderr);
         } catch (const std::exception& e) {
@@ -151,22 +208,9 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
         qDebug() << "OcrTextExtractor: This may take 10-30 seconds on first run...";
         fflush(stdout);
         
-        // Try to find tessdata directory
-        QString tessdataPath = "/opt/homebrew/Cellar/tesseract/5.5.1_1/share/tessdata";
-        fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Trying tessdata path 1: %s\n", tessdataPath.toLocal8Bit().constData());
-        fflush(stderr);
-        if (!QDir(tessdataPath).exists()) {
-            tessdataPath = "/opt/homebrew/share/tessdata";
-            fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Trying tessdata path 2: %s\n", tessdataPath.toLocal8Bit().constData());
-            fflush(stderr);
-        }
-        if (!QDir(tessdataPath).exists()) {
-            tessdataPath = "/usr/local/share/tessdata";
-            fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Trying tessdata path 3: %s\n", tessdataPath.toLocal8Bit().constData());
-            fflush(stderr);
-        }
-        if (!QDir(tessdataPath).exists()) {
-            tessdataPath = "";  // Let Tesseract find it automatically
+        // Same lookup as the ROI engine
+        QString tessdataPath = findTessdataPath();
+        if (tessdataPath.isEmpty()) {
             fprintf(stderr, "[OcrTextExtractor::extractTextRegions] No tessdata found, using auto-detect\n");
             fflush(stderr);
         } else {
@@ -181,10 +225,10 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
         fprintf(stderr, "[OcrTextExtractor::extractTextRegions] WARNING: This may take 10-30 seconds!\n");
         fflush(stderr);
         
-        const char* tessdata = tessdataPath.isEmpty() ? NULL : tessdataPath.toLocal8Bit().constData();
+        QByteArray tessdata = tessdataPath.toLocal8Bit();
         int initResult = 0;
         try {
-            initResult = api->Init(tessdata, "eng");
+            initResult = api->Init(tessdataPath.isEmpty() ? NULL : tessdata.constData(), "eng");
             fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Step 6: Init() returned with code: %d\n", initResult);
             fflush(stderr);
         } catch (const std::exception& e) {
@@ -285,7 +329,7 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
     fprintf(stderr, "[OcrTextExtractor::extractTextRegions] Calling api->Recognize(0) NOW - this will block the thread...\n");
     fflush(stderr);
     
-    int recognizeResult = api->Recognize(0);
+    int recognizeResult = recognize(api);
     
     fprintf(stderr, "[OcrTextExtractor::extractTextRegions] ✓ api->Recognize(0) RETURNED!\n");
     fflush(stderr);
@@ -353,12 +397,7 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
         debugLog("OcrTextExtractor.cpp:extractTextRegions", "Starting iteration loop");
         // #endregion
         
-        int blockId = 0;
-        int lineId = 0;
-        int wordId = 0;
-        int currentBlockId = -1;
-        int lastY = -1;
-        int currentLineId = 0;
+        WordNumbering numbering;
         int iterationCount = 0;
         
         // Check iterator validity before starting iteration
@@ -484,42 +523,21 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
                         delete[] word;
                         break;  // Exit loop on exception
                     }
-                    if (block != currentBlockId) {
-                        currentBlockId = block;
-                        blockId++;
-                        lineId = 0;
-                        wordId = 0;
-                    }
-                    
-                    // Check if we're on a new line using Y-coordinate
-                    // Use a simple approach: track last Y position
-                    if (lastY == -1) {
-                        lastY = y1;
-                        lineId = currentLineId;
-                        wordId = 0;
-                    } else if (abs(y1 - lastY) > 5) {  // 5px tolerance for same line
-                        currentLineId++;
-                        lineId = currentLineId;
-                        lastY = y1;
-                        wordId = 0;
-                    } else {
-                        lineId = currentLineId;
-                        wordId++;
-                    }
+                    numbering.advance(block, y1);
                     
                     // Filter by confidence (expert recommendation: filter low-confidence OCR)
                     OCRTextRegion region;
                     region.text = QString::fromUtf8(word);
                     region.boundingBox = cv::Rect(x1, y1, x2 - x1, y2 - y1);
                     region.confidence = static_cast<double>(conf);
-                    region.blockId = blockId;
-                    region.lineId = lineId;
-                    region.wordId = wordId;
+                    region.blockId = numbering.blockId;
+                    region.lineId = numbering.lineId;
+                    region.wordId = numbering.wordId;
                     region.isLowConfidence = (conf < minConfidence);
                     
                     // Convert to normalized coordinates
-                    int imgWidth = image.width();
-                    int imgHeight = image.height();
+                    int imgWidth = image.cols;
+                    int imgHeight = image.rows;
                     if (imgWidth > 0 && imgHeight > 0) {
                         ImageCoords imgCoords(x1, y1, x2, y2);
                         region.coords = CoordinateSystem::imageToNormalized(imgCoords, imgWidth, imgHeight);
@@ -760,8 +778,11 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegions(const QImage& image)
 cv::Mat OcrTextExtractor::preprocessImage(const QImage& image)
 {
     // Convert QImage to cv::Mat
-    cv::Mat cvImage = ImageConverter::qImageToMat(image);
-    
+    return preprocessMat(ImageConverter::qImageToMat(image));
+}
+
+cv::Mat OcrTextExtractor::preprocessMat(const cv::Mat& cvImage)
+{
     // Convert to grayscale if needed
     cv::Mat gray;
     if (cvImage.channels() == 3) {
@@ -837,7 +858,7 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegionsWithMultiplePSM(const Q
         api->SetImage(preprocessed.data, width, height, bytesPerPixel, bytesPerLine);
         
         // Perform OCR
-        api->Recognize(0);
+        recognize(api);
         
         // Extract text regions
         QList<OCRTextRegion> regions;
@@ -845,12 +866,7 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegionsWithMultiplePSM(const Q
         tesseract::PageIteratorLevel level = tesseract::RIL_WORD;
         
         if (ri != nullptr) {
-            int blockId = 0;
-            int lineId = 0;
-            int wordId = 0;
-            int currentBlockId = -1;
-            int lastY = -1;
-            int currentLineId = 0;
+            WordNumbering numbering;
             
             do {
                 const char* word = ri->GetUTF8Text(level);
@@ -859,36 +875,16 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegionsWithMultiplePSM(const Q
                     
                     int x1, y1, x2, y2;
                     if (ri->BoundingBox(level, &x1, &y1, &x2, &y2)) {
-                        int block = ri->BlockType();
-                        if (block != currentBlockId) {
-                            currentBlockId = block;
-                            blockId++;
-                            lineId = 0;
-                            wordId = 0;
-                        }
-                        
-                        if (lastY == -1) {
-                            lastY = y1;
-                            lineId = currentLineId;
-                            wordId = 0;
-                        } else if (abs(y1 - lastY) > 5) {
-                            currentLineId++;
-                            lineId = currentLineId;
-                            lastY = y1;
-                            wordId = 0;
-                        } else {
-                            lineId = currentLineId;
-                            wordId++;
-                        }
+                        numbering.advance(ri->BlockType(), y1);
                         
                         // Filter by confidence (expert recommendation)
                         OCRTextRegion region;
                         region.text = QString::fromUtf8(word);
                         region.boundingBox = cv::Rect(x1, y1, x2 - x1, y2 - y1);
                         region.confidence = static_cast<double>(conf);
-                        region.blockId = blockId;
-                        region.lineId = lineId;
-                        region.wordId = wordId;
+                        region.blockId = numbering.blockId;
+                        region.lineId = numbering.lineId;
+                        region.wordId = numbering.wordId;
                         region.isLowConfidence = (conf < minConfidence);
                         
                         int imgWidth = image.width();
@@ -942,6 +938,349 @@ QList<OCRTextRegion> OcrTextExtractor::extractTextRegionsWithMultiplePSM(const Q
     return bestResult;
 }
 
+QString OcrTextExtractor::findTessdataPath()
+{
+    const QStringList candidates = {
+        "/opt/homebrew/Cellar/tesseract/5.5.1_1/share/tessdata",
+        "/opt/homebrew/share/tessdata",
+        "/usr/local/share/tessdata"
+    };
+    for (const QString& path : candidates) {
+        if (QDir(path).exists()) {
+            return path;
+        }
+    }
+    return QString();  // Let Tesseract find it automatically
+}
+
+bool OcrTextExtractor::ensureRoiEngine()
+{
+    if (roiApi != nullptr) {
+        return true;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    tesseract::TessBaseAPI* api = new tesseract::TessBaseAPI();
+    QString tessdataPath = findTessdataPath();
+    QByteArray tessdata = tessdataPath.toLocal8Bit();
+    if (api->Init(tessdataPath.isEmpty() ? NULL : tessdata.constData(), "eng")) {
+        fprintf(stderr, "[OcrTextExtractor::ensureRoiEngine] ERROR: Tesseract initialization failed (tessdata: %s)\n",
+                tessdataPath.isEmpty() ? "auto-detect" : tessdata.constData());
+        fflush(stderr);
+        delete api;
+        return false;
+    }
+    
+    roiApi = api;
+    
+    fprintf(stderr, "[OcrTextExtractor::ensureRoiEngine] ✓ ROI engine ready (%lld ms)\n",
+            static_cast<long long>(timer.elapsed()));
+    fflush(stderr);
+    return true;
+}
+
+QList<OCRRoiResult> OcrTextExtractor::extractTextInRegions(const QImage& image, const QList<cv::Rect>& rois)
+{
+    if (image.isNull()) {
+        QList<OCRRoiResult> results;
+        for (int i = 0; i < rois.size(); ++i) {
+            results.append(OCRRoiResult());
+        }
+        return results;
+    }
+    return extractTextInRegions(ImageConverter::qImageToMat(image), rois);
+}
+
+QList<OCRRoiResult> OcrTextExtractor::extractTextInRegions(const cv::Mat& image, const QList<cv::Rect>& rois)
+{
+    QList<OCRRoiResult> results;
+    results.reserve(rois.size());
+    
+    // Clamp ROIs first so results line up with the request even if OCR is unavailable
+    const cv::Rect bounds(0, 0, image.cols, image.rows);
+    bool anyValid = false;
+    for (const cv::Rect& roi : rois) {
+        OCRRoiResult result;
+        result.roi = image.empty() ? cv::Rect() : (roi & bounds);
+        anyValid = anyValid || !result.roi.empty();
+        results.append(result);
+    }
+    if (!anyValid || !ensureRoiEngine()) {
+        return results;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    cv::Mat preprocessed = preprocessMat(image);
+    if (!preprocessed.isContinuous()) {
+        preprocessed = preprocessed.clone();
+    }
+    
+    // Each ROI is a field: read it as one uniform block
+    tesseract::TessBaseAPI* api = static_cast<tesseract::TessBaseAPI*>(roiApi);
+    api->SetPageSegMode(tesseract::PSM_SINGLE_BLOCK);
+    api->SetImage(preprocessed.data, preprocessed.cols, preprocessed.rows, 1, static_cast<int>(preprocessed.step));
+    
+    for (OCRRoiResult& result : results) {
+        if (isCancelled()) {
+            break;
+        }
+        if (result.roi.empty()) {
+            continue;
+        }
+        
+        // Recognize only this rectangle; boxes come back in full-image coordinates
+        api->SetRectangle(result.roi.x, result.roi.y, result.roi.width, result.roi.height);
+        if (recognize(api) != 0) {
+            continue;
+        }
+        
+        char* text = api->GetUTF8Text();
+        if (text != nullptr) {
+            result.text = QString::fromUtf8(text).trimmed();
+            delete[] text;
+        }
+        
+        result.words = readWords(api, 1.0, image.cols, image.rows);
+        if (!result.words.isEmpty()) {
+            double totalConf = 0.0;
+            for (const OCRTextRegion& word : result.words) {
+                totalConf += word.confidence;
+            }
+            result.confidence = totalConf / result.words.size();
+        }
+        result.isLowConfidence = (result.confidence < minConfidence);
+    }
+    
+    // Release the image reference; the engine itself stays warm
+    api->Clear();
+    
+    fprintf(stderr, "[OcrTextExtractor::extractTextInRegions] Read %d ROIs in %lld ms\n",
+            static_cast<int>(results.size()), static_cast<long long>(timer.elapsed()));
+    fflush(stderr);
+    
+    return results;
+}
+
+QList<OCRTextRegion> OcrTextExtractor::extractTextRegionsTwoTier(const QImage& image)
+{
+    if (image.isNull()) {
+        lastLayoutWordCount = 0;
+        lastRefinedSegmentCount = 0;
+        return QList<OCRTextRegion>();
+    }
+    return extractTextRegionsTwoTier(ImageConverter::qImageToMat(image));
+}
+
+QList<OCRTextRegion> OcrTextExtractor::extractTextRegionsTwoTier(const cv::Mat& cvImage)
+{
+    QList<OCRTextRegion> regions;
+    lastLayoutWordCount = 0;
+    lastRefinedSegmentCount = 0;
+    
+    if (cvImage.empty() || !ensureRoiEngine()) {
+        return regions;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    // Relative to the page, so a DETECTION_DPI render is still refined; very large
+    // renders are capped so the layout pass stays cheap
+    const int longSide = std::max(cvImage.cols, cvImage.rows);
+    const double scale = std::min(LAYOUT_SCALE, static_cast<double>(LAYOUT_MAX_LONG_SIDE) / longSide);
+    
+    // Tier 1: sparse-text pass at layout resolution for word boxes and coarse text
+    cv::Mat layoutImage;
+    if (scale < 1.0) {
+        cv::resize(cvImage, layoutImage, cv::Size(), scale, scale, cv::INTER_AREA);
+    } else {
+        layoutImage = cvImage;
+    }
+    cv::Mat preprocessed = preprocessMat(layoutImage);
+    if (!preprocessed.isContinuous()) {
+        preprocessed = preprocessed.clone();
+    }
+    
+    tesseract::TessBaseAPI* api = static_cast<tesseract::TessBaseAPI*>(roiApi);
+    configureTesseract(api);
+    api->SetImage(preprocessed.data, preprocessed.cols, preprocessed.rows, 1, static_cast<int>(preprocessed.step));
+    QList<OCRTextRegion> layoutWords;
+    if (recognize(api) == 0) {
+        layoutWords = readWords(api, 1.0 / scale, cvImage.cols, cvImage.rows);
+    }
+    api->Clear();
+    if (isCancelled()) {
+        return regions;
+    }
+    lastLayoutWordCount = static_cast<int>(layoutWords.size());
+    const qint64 layoutMs = timer.elapsed();
+    
+    // Tier 2: split lines into word runs and re-read at full resolution the runs
+    // whose text the semantic stages use (labels) or that would be dropped
+    QList<int> segmentOfWord(layoutWords.size(), -1);
+    QList<cv::Rect> segmentRois;
+    QList<QPair<int, int>> segmentLines;  // (blockId, lineId) of each refined run
+    if (scale < 1.0) {
+        QMap<QPair<int, int>, QList<int>> lines;
+        for (int i = 0; i < layoutWords.size(); ++i) {
+            lines[qMakePair(layoutWords[i].blockId, layoutWords[i].lineId)].append(i);
+        }
+        
+        for (auto it = lines.begin(); it != lines.end(); ++it) {
+            QList<int> indices = it.value();
+            std::sort(indices.begin(), indices.end(), [&layoutWords](int a, int b) {
+                return layoutWords[a].boundingBox.x < layoutWords[b].boundingBox.x;
+            });
+            
+            int runStart = 0;
+            for (int k = 1; k <= indices.size(); ++k) {
+                if (k < indices.size()) {
+                    const cv::Rect& prev = layoutWords[indices[k - 1]].boundingBox;
+                    const cv::Rect& next = layoutWords[indices[k]].boundingBox;
+                    int gap = next.x - (prev.x + prev.width);
+                    if (gap <= std::max(prev.height, next.height) * 3 / 2) {
+                        continue;
+                    }
+                }
+                
+                // Run is indices[runStart, k)
+                cv::Rect runBox = layoutWords[indices[runStart]].boundingBox;
+                double runMinConf = 100.0;
+                bool hasLetters = false;
+                for (int m = runStart; m < k; ++m) {
+                    const OCRTextRegion& word = layoutWords[indices[m]];
+                    runBox |= word.boundingBox;
+                    runMinConf = std::min(runMinConf, word.confidence);
+                    hasLetters = hasLetters || word.typeHint == "letters" || word.typeHint == "mixed";
+                }
+                
+                bool needsText = hasLetters || runMinConf < minConfidence;
+                if (needsText && runMinConf < refinementConfidence) {
+                    int pad = runBox.height / 4 + static_cast<int>(std::ceil(1.0 / scale));
+                    runBox.x -= pad;
+                    runBox.y -= pad;
+                    runBox.width += 2 * pad;
+                    runBox.height += 2 * pad;
+                    for (int m = runStart; m < k; ++m) {
+                        segmentOfWord[indices[m]] = static_cast<int>(segmentRois.size());
+                    }
+                    segmentRois.append(runBox);
+                    segmentLines.append(it.key());
+                }
+                runStart = k;
+            }
+        }
+    }
+    
+    QList<OCRRoiResult> refined = extractTextInRegions(cvImage, segmentRois);
+    lastRefinedSegmentCount = static_cast<int>(segmentRois.size());
+    if (isCancelled()) {
+        return regions;
+    }
+    
+    // Merge: refined runs replace their layout words in place (unless the re-read found nothing)
+    QList<bool> segmentEmitted(segmentRois.size(), false);
+    QList<OCRTextRegion> merged;
+    for (int i = 0; i < layoutWords.size(); ++i) {
+        int segment = segmentOfWord[i];
+        if (segment < 0 || refined[segment].words.isEmpty()) {
+            merged.append(layoutWords[i]);
+            continue;
+        }
+        if (segmentEmitted[segment]) {
+            continue;
+        }
+        segmentEmitted[segment] = true;
+        for (OCRTextRegion word : refined[segment].words) {
+            word.blockId = segmentLines[segment].first;
+            word.lineId = segmentLines[segment].second;
+            merged.append(word);
+        }
+    }
+    
+    // Same confidence filter and word numbering as the full-page path
+    QMap<QPair<int, int>, int> nextWordId;
+    for (OCRTextRegion& word : merged) {
+        word.isLowConfidence = (word.confidence < minConfidence);
+        if (word.confidence < minConfidence) {
+            continue;
+        }
+        word.wordId = nextWordId[qMakePair(word.blockId, word.lineId)]++;
+        regions.append(word);
+    }
+    
+    fprintf(stderr, "[OcrTextExtractor::extractTextRegionsTwoTier] Layout pass at %.2fx: %d words in %lld ms; "
+            "refined %d runs at full resolution; %d regions in %lld ms total\n",
+            scale, lastLayoutWordCount, static_cast<long long>(layoutMs), lastRefinedSegmentCount,
+            static_cast<int>(regions.size()), static_cast<long long>(timer.elapsed()));
+    fflush(stderr);
+    
+    return regions;
+}
+
+int OcrTextExtractor::recognize(void* apiPtr)
+{
+    tesseract::TessBaseAPI* api = static_cast<tesseract::TessBaseAPI*>(apiPtr);
+    if (!cancellationCheck) {
+        return api->Recognize(nullptr);
+    }
+    tesseract::ETEXT_DESC monitor;
+    monitor.cancel = &recognitionCancelled;
+    monitor.cancel_this = &cancellationCheck;
+    return api->Recognize(&monitor);
+}
+
+QList<OCRTextRegion> OcrTextExtractor::readWords(void* apiPtr, double scale, int imageWidth, int imageHeight)
+{
+    tesseract::TessBaseAPI* api = static_cast<tesseract::TessBaseAPI*>(apiPtr);
+    QList<OCRTextRegion> words;
+    
+    tesseract::ResultIterator* ri = api->GetIterator();
+    if (ri == nullptr) {
+        return words;
+    }
+    
+    // Boxes are scaled before numbering so the line tolerance is in output pixels
+    const tesseract::PageIteratorLevel level = tesseract::RIL_WORD;
+    WordNumbering numbering;
+    do {
+        const char* word = ri->GetUTF8Text(level);
+        if (word == nullptr) {
+            continue;
+        }
+        int x1, y1, x2, y2;
+        if (strlen(word) > 0 && ri->BoundingBox(level, &x1, &y1, &x2, &y2)) {
+            x1 = static_cast<int>(std::floor(x1 * scale));
+            y1 = static_cast<int>(std::floor(y1 * scale));
+            x2 = std::min(imageWidth, static_cast<int>(std::ceil(x2 * scale)));
+            y2 = std::min(imageHeight, static_cast<int>(std::ceil(y2 * scale)));
+            
+            numbering.advance(ri->BlockType(), y1);
+            
+            OCRTextRegion region;
+            region.text = QString::fromUtf8(word);
+            region.boundingBox = cv::Rect(x1, y1, x2 - x1, y2 - y1);
+            region.coords = CoordinateSystem::imageToNormalized(ImageCoords(x1, y1, x2, y2),
+                                                                imageWidth, imageHeight);
+            region.confidence = static_cast<double>(ri->Confidence(level));
+            region.blockId = numbering.blockId;
+            region.lineId = numbering.lineId;
+            region.wordId = numbering.wordId;
+            region.isLowConfidence = (region.confidence < minConfidence);
+            region.typeHint = inferTypeFromText(region.text);
+            words.append(region);
+        }
+        delete[] word;
+    } while (ri->Next(level));
+    delete ri;
+    
+    return words;
+}
+
 QList<OCRTextRegion> OcrTextExtractor::filterByConfidence(const QList<OCRTextRegion>& regions, double minConf)
 {
     QList<OCRTextRegion> filtered;
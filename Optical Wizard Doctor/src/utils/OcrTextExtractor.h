@@ -5,6 +5,7 @@
 #include <QtCore/QString>
 #include <QtCore/QList>
 #include <opencv2/opencv.hpp>
+#include <functional>
 #include "../core/CoordinateSystem.h"
 
 namespace ocr_orc {
@@ -26,6 +27,19 @@ struct OCRTextRegion {
     OCRTextRegion() : confidence(0.0), typeHint("unknown"), blockId(0), lineId(0), wordId(0), isLowConfidence(false) {}
 };
 
+/**
+ * @brief OCR result for one region of interest
+ */
+struct OCRRoiResult {
+    cv::Rect roi;                 // Region that was read (clamped to the image)
+    QString text;                 // Recognized text, trimmed
+    double confidence;            // Mean word confidence (0.0-100.0)
+    QList<OCRTextRegion> words;   // Words inside the region (image coordinates)
+    bool isLowConfidence;         // True if confidence below threshold
+    
+    OCRRoiResult() : confidence(0.0), isLowConfidence(false) {}
+};
+
 /**
  * @brief Tesseract OCR text extractor
  * 
@@ -34,9 +48,20 @@ struct OCRTextRegion {
  */
 class OcrTextExtractor {
 public:
+    /**
+     * @brief How a full page is recognized
+     */
+    enum RecognitionMode {
+        FULL_PAGE_RECOGNITION,  // Recognize the full-resolution page in one pass
+        TWO_TIER_RECOGNITION    // Low-resolution layout pass, full-resolution re-read where text matters
+    };
+    
     OcrTextExtractor();
     ~OcrTextExtractor();
     
+    OcrTextExtractor(const OcrTextExtractor&) = delete;
+    OcrTextExtractor& operator=(const OcrTextExtractor&) = delete;
+    
     /**
      * @brief Extract text regions from image
      * @param image Source image to process
@@ -44,6 +69,13 @@ public:
      */
     QList<OCRTextRegion> extractTextRegions(const QImage& image);
     
+    /**
+     * @brief Extract text regions from an already converted image
+     * @param image Source image (BGR, BGRA or gray)
+     * @return List of OCR text regions with bounding boxes and confidence
+     */
+    QList<OCRTextRegion> extractTextRegions(const cv::Mat& image);
+    
     /**
      * @brief Extract text regions using multiple PSM modes and return best result
      * @param image Source image to process
@@ -51,12 +83,64 @@ public:
      */
     QList<OCRTextRegion> extractTextRegionsWithMultiplePSM(const QImage& image);
     
+    /**
+     * @brief Extract text regions with a low-resolution layout pass and targeted refinement
+     * 
+     * The page is recognized once at LAYOUT_SCALE (sparse text) for word
+     * boxes and coarse type hints. Words are then split into runs along each
+     * line; runs that contain letters (label candidates for the semantic
+     * stages) or would fall below the confidence threshold, and whose layout
+     * confidence is under the refinement threshold, are re-read at full
+     * resolution with extractTextInRegions(). Output uses the same structure,
+     * coordinates and confidence filter as extractTextRegions().
+     * @param image Source image to process
+     * @return List of OCR text regions with bounding boxes and confidence
+     */
+    QList<OCRTextRegion> extractTextRegionsTwoTier(const QImage& image);
+    
+    /**
+     * @brief Two-tier extraction from an already converted image
+     * @param image Source image (BGR, BGRA or gray)
+     */
+    QList<OCRTextRegion> extractTextRegionsTwoTier(const cv::Mat& image);
+    
+    /**
+     * @brief Read only the given regions of an image
+     * 
+     * Meant for re-verifying fields after detection or editing: the image is
+     * preprocessed and handed to Tesseract once, then each ROI is recognized
+     * as a single block via SetRectangle, so the rest of the page is never
+     * laid out or read. The engine is initialized on first use and kept warm
+     * for later calls on the same extractor.
+     * @param image Source image
+     * @param rois Regions in image pixel coordinates
+     * @return One result per ROI, in the same order (empty text for ROIs outside the image)
+     */
+    QList<OCRRoiResult> extractTextInRegions(const QImage& image, const QList<cv::Rect>& rois);
+    
+    /**
+     * @brief Read only the given regions of an image (gray, BGR or BGRA)
+     * @param image Source image
+     * @param rois Regions in image pixel coordinates
+     * @return One result per ROI, in the same order
+     */
+    QList<OCRRoiResult> extractTextInRegions(const cv::Mat& image, const QList<cv::Rect>& rois);
+    
     /**
      * @brief Set minimum OCR confidence threshold
      * @param confidence Minimum confidence (0.0-100.0)
      */
     void setConfidenceThreshold(double confidence) { minConfidence = confidence; }
     
+    /**
+     * @brief Set a check that abandons recognition in progress
+     *
+     * Tesseract polls it between words, and ROI reads poll it between ROIs.
+     * Once it returns true the current extraction stops and returns no regions.
+     * @param isCancelled Check (called on the extracting thread); empty disables
+     */
+    void setCancellationCheck(const std::function<bool()>& isCancelled) { cancellationCheck = isCancelled; }
+    
     /**
      * @brief Get current confidence threshold
      * @return Minimum confidence threshold
@@ -82,6 +166,27 @@ public:
      * @return Minimum confidence threshold
      */
     double getMinConfidence() const { return minConfidence; }
+    
+    /**
+     * @brief Set the layout confidence above which a run keeps its low-resolution text
+     * @param confidence Confidence (0.0-100.0, default: 90.0)
+     */
+    void setRefinementConfidence(double confidence) { refinementConfidence = confidence; }
+    
+    /**
+     * @brief Get the refinement confidence threshold
+     */
+    double getRefinementConfidence() const { return refinementConfidence; }
+    
+    /**
+     * @brief Number of words found by the last two-tier layout pass
+     */
+    int getLastLayoutWordCount() const { return lastLayoutWordCount; }
+    
+    /**
+     * @brief Number of word runs re-read at full resolution by the last two-tier pass
+     */
+    int getLastRefinedSegmentCount() const { return lastRefinedSegmentCount; }
 
 private:
     /**
@@ -91,6 +196,47 @@ private:
      */
     cv::Mat preprocessImage(const QImage& image);
     
+    /**
+     * @brief Preprocess a cv::Mat for OCR (same pipeline as preprocessImage)
+     * @param image Source image (gray, BGR or BGRA)
+     * @return Preprocessed cv::Mat (grayscale, denoised, thresholded)
+     */
+    cv::Mat preprocessMat(const cv::Mat& image);
+    
+    /**
+     * @brief Initialize the warm ROI engine if needed
+     * @return true if the engine is ready
+     */
+    bool ensureRoiEngine();
+    
+    /**
+     * @brief Run Recognize() with the cancellation check as Tesseract's cancel monitor
+     * @param api Tesseract API instance with its image set
+     * @return Recognize() result (non-zero when cancelled)
+     */
+    int recognize(void* api);
+    
+    /**
+     * @brief True if the cancellation check is set and reports cancellation
+     */
+    bool isCancelled() const { return cancellationCheck && cancellationCheck(); }
+    
+    /**
+     * @brief Collect recognized words from the engine's current result
+     * @param api Tesseract API instance (after Recognize)
+     * @param scale Factor from engine image pixels to output pixels
+     * @param imageWidth Output image width (for clamping and normalization)
+     * @param imageHeight Output image height
+     * @return All words (unfiltered), numbered like extractTextRegions()
+     */
+    QList<OCRTextRegion> readWords(void* api, double scale, int imageWidth, int imageHeight);
+    
+    /**
+     * @brief Locate the tessdata directory
+     * @return Path, or empty to let Tesseract find it
+     */
+    static QString findTessdataPath();
+    
     /**
      * @brief Configure Tesseract API settings
      * @param api Tesseract API instance
@@ -104,7 +250,15 @@ private:
      */
     QString inferTypeFromText(const QString& text);
     
+    static constexpr double LAYOUT_SCALE = 0.5;  // Two-tier layout pass: ~75 DPI from a DETECTION_DPI page
+    static constexpr int LAYOUT_MAX_LONG_SIDE = 1700;  // Layout pass cap for high-DPI renders (~150 DPI letter page)
+    
     double minConfidence;  // Minimum confidence threshold (default: 50.0)
+    double refinementConfidence;  // Two-tier: runs below this are re-read at full resolution
+    int lastLayoutWordCount;
+    int lastRefinedSegmentCount;
+    void* roiApi;          // Warm Tesseract engine for ROI reads and layout passes (tesseract::TessBaseAPI*)
+    std::function<bool()> cancellationCheck;  // Empty unless setCancellationCheck()
 };
 
 } // namespace ocr_orc
@@ -0,0 +1,223 @@
+#include "PageAnalysisCache.h"
+#include "TraceRecorder.h"
+#include "../core/CoordinateSystem.h"
+#include <QtCore/QHashFunctions>
+#include <QtCore/QMutexLocker>
+
+namespace ocr_orc {
+
+PageAnalysisCache& PageAnalysisCache::instance() {
+    static PageAnalysisCache cache;
+    return cache;
+}
+
+PageAnalysisCache::PageAnalysisCache()
+    : currentKey(0)
+    , hasPage(false)
+    , rectanglesReady(false)
+    , hits(0)
+    , misses(0)
+{
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        ocrReady[mode] = false;
+        ocrInFlight[mode] = false;
+        ocrWaiters[mode] = 0;
+    }
+}
+
+quint64 PageAnalysisCache::pageKey(const QImage& page) {
+    if (page.isNull()) {
+        return 0;
+    }
+    size_t seed = qHashMulti(0, page.width(), page.height(), static_cast<int>(page.format()));
+    // Row by row: scan lines may carry padding bytes
+    const qsizetype rowBytes = static_cast<qsizetype>(page.width()) * page.depth() / 8;
+    for (int y = 0; y < page.height(); ++y) {
+        seed = qHashBits(page.constScanLine(y), rowBytes, seed);
+    }
+    return static_cast<quint64>(seed);
+}
+
+void PageAnalysisCache::selectPage(quint64 key) {
+    if (hasPage && currentKey == key) {
+        return;
+    }
+    currentKey = key;
+    hasPage = true;
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        ocrReady[mode] = false;
+        ocrInFlight[mode] = false;
+        ocrRegions[mode].clear();
+    }
+    rectanglesReady = false;
+    rectangles.clear();
+    // Consumers waiting on the old page give up and compute their own
+    ocrFinished.wakeAll();
+}
+
+void PageAnalysisCache::countLookup(bool hit) {
+    if (hit) {
+        ++hits;
+        OCR_ORC_TRACE_COUNTER("page_cache_hits", hits);
+    } else {
+        ++misses;
+        OCR_ORC_TRACE_COUNTER("page_cache_misses", misses);
+    }
+}
+
+bool PageAnalysisCache::beginOcr(quint64 key, OcrTextExtractor::RecognitionMode mode) {
+    QMutexLocker locker(&mutex);
+    selectPage(key);
+    if (ocrReady[mode] || ocrInFlight[mode]) {
+        return false;
+    }
+    ocrInFlight[mode] = true;
+    return true;
+}
+
+void PageAnalysisCache::storeOcr(quint64 key, OcrTextExtractor::RecognitionMode mode,
+                                 const QList<OCRTextRegion>& regions) {
+    QMutexLocker locker(&mutex);
+    selectPage(key);
+    ocrRegions[mode] = regions;
+    ocrReady[mode] = true;
+    ocrInFlight[mode] = false;
+    ocrFinished.wakeAll();
+}
+
+bool PageAnalysisCache::finishOcr(quint64 key, OcrTextExtractor::RecognitionMode mode,
+                                  const QList<OCRTextRegion>& regions) {
+    QMutexLocker locker(&mutex);
+    if (!hasPage || currentKey != key || !ocrInFlight[mode]) {
+        return false;
+    }
+    ocrRegions[mode] = regions;
+    ocrReady[mode] = true;
+    ocrInFlight[mode] = false;
+    ocrFinished.wakeAll();
+    return true;
+}
+
+void PageAnalysisCache::abandonOcr(quint64 key, OcrTextExtractor::RecognitionMode mode) {
+    QMutexLocker locker(&mutex);
+    if (hasPage && currentKey == key) {
+        ocrInFlight[mode] = false;
+        ocrFinished.wakeAll();
+    }
+}
+
+bool PageAnalysisCache::lookupOcr(quint64 key, OcrTextExtractor::RecognitionMode mode,
+                                  QList<OCRTextRegion>& regions, bool waitForInFlight) {
+    QMutexLocker locker(&mutex);
+    if (waitForInFlight && hasPage && currentKey == key && ocrInFlight[mode]) {
+        TraceSpan waitSpan("PageAnalysisCache: wait for in-flight OCR", "cache");
+        ++ocrWaiters[mode];
+        while (hasPage && currentKey == key && ocrInFlight[mode]) {
+            ocrFinished.wait(&mutex);
+        }
+        --ocrWaiters[mode];
+    }
+    const bool hit = hasPage && currentKey == key && ocrReady[mode];
+    if (hit) {
+        regions = ocrRegions[mode];
+    }
+    countLookup(hit);
+    return hit;
+}
+
+bool PageAnalysisCache::isOcrAwaited(quint64 key, OcrTextExtractor::RecognitionMode mode) const {
+    QMutexLocker locker(&mutex);
+    return hasPage && currentKey == key && ocrInFlight[mode] && ocrWaiters[mode] > 0;
+}
+
+void PageAnalysisCache::storeRectangles(quint64 key, const QList<DetectedRectangle>& newRectangles) {
+    QMutexLocker locker(&mutex);
+    selectPage(key);
+    rectangles = newRectangles;
+    rectanglesReady = true;
+}
+
+bool PageAnalysisCache::lookupRectangles(quint64 key, QList<DetectedRectangle>& result) {
+    QMutexLocker locker(&mutex);
+    const bool hit = hasPage && currentKey == key && rectanglesReady;
+    if (hit) {
+        result = rectangles;
+    }
+    countLookup(hit);
+    return hit;
+}
+
+QList<ProjectOcrWord> PageAnalysisCache::projectOcrWords(const QImage& page) const {
+    const quint64 key = pageKey(page);
+    QList<OCRTextRegion> regions;
+    {
+        QMutexLocker locker(&mutex);
+        if (!hasPage || currentKey != key || !ocrReady[PROJECT_OCR_MODE]) {
+            return QList<ProjectOcrWord>();
+        }
+        regions = ocrRegions[PROJECT_OCR_MODE];
+    }
+    
+    QList<ProjectOcrWord> words;
+    words.reserve(regions.size());
+    for (const OCRTextRegion& region : regions) {
+        ProjectOcrWord word;
+        word.coords = region.coords;
+        word.text = region.text;
+        word.confidence = static_cast<float>(region.confidence);
+        word.blockId = region.blockId;
+        word.lineId = region.lineId;
+        word.wordId = region.wordId;
+        words.append(word);
+    }
+    return words;
+}
+
+void PageAnalysisCache::seedFromProject(const QImage& page, const QList<ProjectOcrWord>& words) {
+    if (page.isNull() || words.isEmpty()) {
+        return;
+    }
+    
+    // Pixel boxes follow the imported raster; type hints are not stored in projects
+    QList<OCRTextRegion> regions;
+    regions.reserve(words.size());
+    for (const ProjectOcrWord& word : words) {
+        OCRTextRegion region;
+        const ImageCoords box = CoordinateSystem::normalizedToImage(word.coords, page.width(), page.height());
+        region.boundingBox = cv::Rect(box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1);
+        region.coords = word.coords;
+        region.text = word.text;
+        region.confidence = word.confidence;
+        region.blockId = word.blockId;
+        region.lineId = word.lineId;
+        region.wordId = word.wordId;
+        regions.append(region);
+    }
+    storeOcr(pageKey(page), PROJECT_OCR_MODE, regions);
+}
+
+int PageAnalysisCache::getHitCount() const {
+    QMutexLocker locker(&mutex);
+    return hits;
+}
+
+int PageAnalysisCache::getMissCount() const {
+    QMutexLocker locker(&mutex);
+    return misses;
+}
+
+void PageAnalysisCache::clear() {
+    QMutexLocker locker(&mutex);
+    hasPage = false;
+    currentKey = 0;
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        ocrReady[mode] = false;
+        ocrInFlight[mode] = false;
+        ocrRegions[mode].clear();
+    }
+    rectanglesReady = false;
+    rectangles.clear();
+    ocrFinished.wakeAll();
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,157 @@
+#ifndef PAGE_ANALYSIS_CACHE_H
+#define PAGE_ANALYSIS_CACHE_H
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtGui/QImage>
+#include "OcrTextExtractor.h"
+#include "RectangleDetector.h"
+#include "../export/ProjectFormat.h"
+
+namespace ocr_orc {
+
+/**
+ * @brief Process-wide cache of the parameter-independent page analysis
+ *
+ * Holds the OCR regions (per recognition mode) and the rectangle candidates
+ * for one page, keyed by a hash of its pixels. It is filled speculatively
+ * when a PDF is loaded (see SpeculativeAnalysisWorker) and read by
+ * RegionDetector, so Magic Detect can skip its most expensive stages.
+ *
+ * Only the most recent page is kept: touching a new page key drops the old
+ * entry. A producer can reserve an OCR result with beginOcr(); a consumer
+ * looking it up meanwhile can wait for it instead of running OCR twice.
+ */
+class PageAnalysisCache {
+public:
+    /**
+     * @brief Get the process-wide instance
+     */
+    static PageAnalysisCache& instance();
+    
+    PageAnalysisCache(const PageAnalysisCache&) = delete;
+    PageAnalysisCache& operator=(const PageAnalysisCache&) = delete;
+    
+    /**
+     * @brief Key for a page image (pixels, size and format)
+     */
+    static quint64 pageKey(const QImage& page);
+    
+    /**
+     * @brief Announce that OCR for the page is being computed
+     * @return false if a result or reservation already exists
+     */
+    bool beginOcr(quint64 key, OcrTextExtractor::RecognitionMode mode);
+    
+    /**
+     * @brief Store OCR regions (makes key the cached page and completes its reservation)
+     */
+    void storeOcr(quint64 key, OcrTextExtractor::RecognitionMode mode, const QList<OCRTextRegion>& regions);
+    
+    /**
+     * @brief Complete a beginOcr() reservation
+     * @return false (nothing stored) if the page was superseded since beginOcr()
+     */
+    bool finishOcr(quint64 key, OcrTextExtractor::RecognitionMode mode, const QList<OCRTextRegion>& regions);
+    
+    /**
+     * @brief Drop a reservation without a result (wakes waiting consumers)
+     */
+    void abandonOcr(quint64 key, OcrTextExtractor::RecognitionMode mode);
+    
+    /**
+     * @brief Look up OCR regions for the page
+     * @param waitForInFlight Block while a reserved result for this page is still being computed
+     * @return true on a hit
+     */
+    bool lookupOcr(quint64 key, OcrTextExtractor::RecognitionMode mode, QList<OCRTextRegion>& regions,
+                   bool waitForInFlight = false);
+    
+    /**
+     * @brief Whether a consumer is blocked in lookupOcr() on this page's reserved result
+     *
+     * Lets a low-priority producer speed up, and not give up, once a
+     * detection depends on it.
+     */
+    bool isOcrAwaited(quint64 key, OcrTextExtractor::RecognitionMode mode) const;
+    
+    /**
+     * @brief Store rectangle candidates found with RegionDetector's fixed detector settings
+     */
+    void storeRectangles(quint64 key, const QList<DetectedRectangle>& rectangles);
+    
+    /**
+     * @brief Look up rectangle candidates for the page
+     * @return true on a hit
+     */
+    bool lookupRectangles(quint64 key, QList<DetectedRectangle>& rectangles);
+    
+    /**
+     * @brief OCR words cached for a page, for saving in a project file
+     *
+     * Only the recognition mode RegionDetector runs by default (PROJECT_OCR_MODE)
+     * is saved. Does not wait for in-flight OCR and is not counted as a lookup.
+     * @return Empty if no OCR is cached for the page
+     */
+    QList<ProjectOcrWord> projectOcrWords(const QImage& page) const;
+    
+    /**
+     * @brief Seed the cache with OCR words loaded from a project
+     * @param page Page the words belong to (the imported raster, as passed to detection)
+     * @param words Words stored by projectOcrWords(); nothing is seeded if empty
+     */
+    void seedFromProject(const QImage& page, const QList<ProjectOcrWord>& words);
+    
+    /**
+     * @brief Drop everything (wakes waiting consumers); lookup counts are kept
+     */
+    void clear();
+    
+    /**
+     * @brief Lookups answered from the cache since startup
+     */
+    int getHitCount() const;
+    
+    /**
+     * @brief Lookups that found nothing since startup
+     */
+    int getMissCount() const;
+
+private:
+    PageAnalysisCache();
+    ~PageAnalysisCache() = default;
+    
+    static const int MODE_COUNT = 2;  // OcrTextExtractor::RecognitionMode values
+    static constexpr OcrTextExtractor::RecognitionMode PROJECT_OCR_MODE = OcrTextExtractor::TWO_TIER_RECOGNITION;
+    
+    /**
+     * @brief Make key the cached page, dropping any other (caller holds the mutex)
+     */
+    void selectPage(quint64 key);
+    
+    /**
+     * @brief Count a lookup and report it as a trace counter (caller holds the mutex)
+     */
+    void countLookup(bool hit);
+    
+    mutable QMutex mutex;
+    QWaitCondition ocrFinished;
+    quint64 currentKey;
+    bool hasPage;
+    
+    bool ocrReady[MODE_COUNT];
+    bool ocrInFlight[MODE_COUNT];
+    int ocrWaiters[MODE_COUNT];  // Consumers inside lookupOcr()'s wait (not reset with the page)
+    QList<OCRTextRegion> ocrRegions[MODE_COUNT];
+    
+    bool rectanglesReady;
+    QList<DetectedRectangle> rectangles;
+    
+    int hits;
+    int misses;
+};
+
+} // namespace ocr_orc
+
+#endif // PAGE_ANALYSIS_CACHE_H
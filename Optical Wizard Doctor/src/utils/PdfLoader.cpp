@@ -8,6 +8,8 @@
 #if OCR_ORC_DEBUG_ENABLED
 #include <QtCore/QDebug>
 #endif
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <stdexcept>
 
@@ -20,6 +22,59 @@ QImage PdfLoader::loadPdfFirstPage(const QString& filePath, int dpi) {
         dpi = PdfConstants::DEFAULT_DPI;
     }
     
+    return renderFirstPage(filePath, dpi);
+}
+
+QImage PdfLoader::loadPdfFirstPageGray(const QString& filePath, int dpi) {
+    // Validate DPI
+    if (dpi < PdfConstants::MIN_DPI || dpi > PdfConstants::MAX_DPI) {
+        OCR_ORC_WARNING("PdfLoader: Invalid detection DPI, using default:" << PdfConstants::DETECTION_DPI);
+        dpi = PdfConstants::DETECTION_DPI;
+    }
+    
+    return renderFirstPage(filePath, dpi, nullptr, true);
+}
+
+QImage PdfLoader::loadPdfFirstPagePreview(const QString& filePath, int previewDpi, int targetDpi) {
+    // Validate DPI (preview may go below MIN_DPI, but never above the target)
+    if (targetDpi < PdfConstants::MIN_DPI || targetDpi > PdfConstants::MAX_DPI) {
+        OCR_ORC_WARNING("PdfLoader: Invalid target DPI, using default:" << PdfConstants::DEFAULT_DPI);
+        targetDpi = PdfConstants::DEFAULT_DPI;
+    }
+    if (previewDpi <= 0 || previewDpi > targetDpi) {
+        previewDpi = std::min(PdfConstants::PREVIEW_DPI, targetDpi);
+    }
+    
+    QSizeF pageSizePoints;
+    QImage preview = renderFirstPage(filePath, previewDpi, &pageSizePoints);
+    if (preview.isNull()) {
+        return QImage();
+    }
+    
+    // Size the preview like the full render so swapping images keeps the layout stable
+    QSize targetSize(qRound(pageSizePoints.width() * targetDpi / 72.0),
+                     qRound(pageSizePoints.height() * targetDpi / 72.0));
+    if (targetSize.isEmpty()) {
+        return preview;
+    }
+    return preview.scaled(targetSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+}
+
+QImage PdfLoader::renderFirstPageRegion(const QString& filePath, const QRectF& normalizedRect, double dpi,
+                                        QRectF* renderedRect) {
+    QRectF crop = normalizedRect.intersected(QRectF(0.0, 0.0, 1.0, 1.0));
+    if (crop.isEmpty()) {
+        OCR_ORC_WARNING("PdfLoader: Empty region requested:" << filePath);
+        return QImage();
+    }
+    dpi = std::clamp(dpi, static_cast<double>(PdfConstants::MIN_DPI),
+                     static_cast<double>(PdfConstants::MAX_TILE_DPI));
+    
+    return renderFirstPage(filePath, dpi, nullptr, false, crop, renderedRect);
+}
+
+QImage PdfLoader::renderFirstPage(const QString& filePath, double dpi, QSizeF* pageSizePoints, bool grayscale,
+                                  const QRectF& crop, QRectF* renderedCrop) {
     // Check if file exists
     if (!QFileInfo::exists(filePath)) {
         OCR_ORC_WARNING("PdfLoader: File does not exist:" << filePath);
@@ -56,16 +111,54 @@ QImage PdfLoader::loadPdfFirstPage(const QString& filePath, int dpi) {
         return QImage();
     }
     
+    // Rendered output follows the page's /Rotate, so swap for quarter turns
+    poppler::rectf rect = page->page_rect();
+    bool quarterTurn = page->orientation() == poppler::page::landscape ||
+                       page->orientation() == poppler::page::seascape;
+    QSizeF pointSize = quarterTurn ? QSizeF(rect.height(), rect.width())
+                                   : QSizeF(rect.width(), rect.height());
+    if (pageSizePoints) {
+        *pageSizePoints = pointSize;
+    }
+    
+    // Crop in output pixels, snapped outward so the whole requested area is covered
+    int cropX = -1;
+    int cropY = -1;
+    int cropWidth = -1;
+    int cropHeight = -1;
+    if (!crop.isEmpty()) {
+        const double pageWidth = pointSize.width() * dpi / 72.0;
+        const double pageHeight = pointSize.height() * dpi / 72.0;
+        const int maxX = static_cast<int>(std::ceil(pageWidth));
+        const int maxY = static_cast<int>(std::ceil(pageHeight));
+        cropX = std::clamp(static_cast<int>(std::floor(crop.left() * pageWidth)), 0, maxX);
+        cropY = std::clamp(static_cast<int>(std::floor(crop.top() * pageHeight)), 0, maxY);
+        cropWidth = std::clamp(static_cast<int>(std::ceil(crop.right() * pageWidth)), 0, maxX) - cropX;
+        cropHeight = std::clamp(static_cast<int>(std::ceil(crop.bottom() * pageHeight)), 0, maxY) - cropY;
+        if (cropWidth <= 0 || cropHeight <= 0 || pageWidth <= 0.0 || pageHeight <= 0.0) {
+            OCR_ORC_WARNING("PdfLoader: Crop outside the page:" << filePath);
+            return QImage();
+        }
+        if (static_cast<long long>(cropWidth) * cropHeight > PdfConstants::MAX_TILE_PIXELS) {
+            OCR_ORC_WARNING("PdfLoader: Crop too large at" << dpi << "DPI:" << cropWidth << "x" << cropHeight);
+            return QImage();
+        }
+        if (renderedCrop) {
+            *renderedCrop = QRectF(cropX / pageWidth, cropY / pageHeight,
+                                   cropWidth / pageWidth, cropHeight / pageHeight);
+        }
+    }
+    
     // Create page renderer
     poppler::page_renderer renderer;
     renderer.set_render_hint(poppler::page_renderer::antialiasing, true);
     renderer.set_render_hint(poppler::page_renderer::text_antialiasing, true);
-    renderer.set_image_format(poppler::image::format_argb32);
+    renderer.set_image_format(grayscale ? poppler::image::format_gray8 : poppler::image::format_argb32);
     
     // Render page to poppler::image (with error handling)
     poppler::image popplerImg;
     try {
-        popplerImg = renderer.render_page(page.get(), dpi, dpi);
+        popplerImg = renderer.render_page(page.get(), dpi, dpi, cropX, cropY, cropWidth, cropHeight);
     } catch (const std::exception& e) {
         OCR_ORC_WARNING("PdfLoader: Exception during rendering:" << e.what());
         return QImage();
@@ -83,19 +176,18 @@ QImage PdfLoader::loadPdfFirstPage(const QString& filePath, int dpi) {
     }
     
     // Convert poppler::image to QImage
+    // format_argb32 matches QImage::Format_ARGB32, format_gray8 matches Format_Grayscale8
     int width = popplerImg.width();
     int height = popplerImg.height();
-    const char* data = popplerImg.const_data();
     int bytesPerRow = popplerImg.bytes_per_row();
-    
-    // Create QImage from poppler image data
-    // poppler::image format_argb32 is ARGB32, which matches QImage::Format_ARGB32
-    QImage qImage(reinterpret_cast<const uchar*>(data), width, height, bytesPerRow, QImage::Format_ARGB32);
-    
-    // Make a copy since popplerImg will be destroyed
-    QImage result = qImage.copy();
-    
-    return result;
+    QImage::Format format = grayscale ? QImage::Format_Grayscale8 : QImage::Format_ARGB32;
+    
+    // Wrap Poppler's buffer instead of copying it: the QImage keeps a shallow
+    // poppler::image copy alive and releases it with its last reference.
+    // The data is read-only, so writers get a detached copy.
+    poppler::image* buffer = new poppler::image(popplerImg);
+    return QImage(reinterpret_cast<const uchar*>(buffer->const_data()), width, height, bytesPerRow, format,
+                  [](void* info) { delete static_cast<poppler::image*>(info); }, buffer);
 }
 
 bool PdfLoader::isValidPdf(const QString& filePath) {
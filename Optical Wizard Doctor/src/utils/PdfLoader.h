@@ -3,6 +3,8 @@
 
 #include "../core/Constants.h"
 #include <QtCore/QString>
+#include <QtCore/QSizeF>
+#include <QtCore/QRectF>
 #include <QtGui/QImage>
 
 namespace ocr_orc {
@@ -27,6 +29,53 @@ public:
      */
     static QImage loadPdfFirstPage(const QString& filePath, int dpi = PdfConstants::DEFAULT_DPI);
     
+    /**
+     * @brief Render a fast low-resolution preview of the first page
+     * 
+     * Renders at previewDpi and scales the result up to the pixel size the page
+     * will have at targetDpi, so the preview can be shown in place of the full
+     * render without changing layout or image-space region coordinates.
+     * 
+     * @param filePath Path to the PDF file
+     * @param previewDpi Resolution actually rendered (default: 36 DPI)
+     * @param targetDpi Resolution of the full render the preview stands in for
+     * @return Preview QImage sized for targetDpi, or empty QImage on error
+     */
+    static QImage loadPdfFirstPagePreview(const QString& filePath,
+                                          int previewDpi = PdfConstants::PREVIEW_DPI,
+                                          int targetDpi = PdfConstants::DEFAULT_DPI);
+    
+    /**
+     * @brief Render the first page as 8-bit grayscale for detection
+     * 
+     * Poppler renders straight to gray, so detection gets a
+     * QImage::Format_Grayscale8 page without an ARGB render or any colour
+     * conversion: a quarter of the memory of the display raster, before the
+     * intermediate RGB and BGR copies the colour path needs.
+     * 
+     * @param filePath Path to the PDF file
+     * @param dpi Resolution for rendering, independent of the display raster
+     * @return Grayscale8 QImage, or empty QImage on error
+     */
+    static QImage loadPdfFirstPageGray(const QString& filePath, int dpi = PdfConstants::DETECTION_DPI);
+    
+    /**
+     * @brief Render part of the first page at an arbitrary resolution
+     * 
+     * Poppler rasterizes only the requested crop, so memory follows the size
+     * of the crop at dpi rather than the whole page. Used to re-render the
+     * visible part of the page from vector data when the canvas is zoomed in
+     * beyond the resolution of the page raster.
+     * 
+     * @param filePath Path to the PDF file
+     * @param normalizedRect Crop in page coordinates scaled to 0..1 (as rendered, /Rotate applied)
+     * @param dpi Resolution for the crop, clamped to MIN_DPI..MAX_TILE_DPI
+     * @param renderedRect If non-null, receives the crop actually rendered (snapped outward to whole pixels)
+     * @return Rendered crop, or empty QImage on error or if it would exceed MAX_TILE_PIXELS
+     */
+    static QImage renderFirstPageRegion(const QString& filePath, const QRectF& normalizedRect, double dpi,
+                                        QRectF* renderedRect = nullptr);
+    
     /**
      * @brief Check if a file is a valid PDF
      * 
@@ -44,6 +93,17 @@ public:
     static int getPageCount(const QString& filePath);
 
 private:
+    /**
+     * @brief Render page 0 at the given DPI (no DPI validation)
+     * @param pageSizePoints If non-null, receives the page size in points (1/72 inch)
+     * @param grayscale Render Format_Grayscale8 instead of Format_ARGB32
+     * @param crop Normalized part of the page to render (empty: whole page)
+     * @param renderedCrop If non-null and crop is set, receives the normalized crop actually rendered
+     */
+    static QImage renderFirstPage(const QString& filePath, double dpi, QSizeF* pageSizePoints = nullptr,
+                                  bool grayscale = false, const QRectF& crop = QRectF(),
+                                  QRectF* renderedCrop = nullptr);
+    
     // Private constructor - this is a utility class with only static methods
     PdfLoader() = delete;
 };
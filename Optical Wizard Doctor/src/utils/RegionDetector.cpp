@@ -3,6 +3,8 @@
 #include "TypeInferencer.h"
 #include "GroupInferencer.h"
 #include "SpatialClusterer.h"
+#include "DetectedRegionBatch.h"
+#include "RegionNeighborGraph.h"
 #include "patterns/PostalCodePatternDetector.h"
 #include "patterns/NameFieldPatternDetector.h"
 #include "patterns/NumberSequencePatternDetector.h"
@@ -18,13 +20,17 @@
 #include "DocumentPreprocessor.h"
 #include "FormStructureAnalyzer.h"
 #include "DetectionCache.h"
+#include "DetectionContext.h"
+#include "DetectionProgressChannel.h"
+#include "PageAnalysisCache.h"
+#include "TaskGraph.h"
+#include "ConcurrencyGovernor.h"
+#include "TraceRecorder.h"
 #include "../core/CoordinateSystem.h"
 #include "../ui/components/dialogs/MagicDetectParamsDialog.h"
 #include <QtGui/QImage>
-#include <QtCore/QFuture>
 #include <QtCore/QVariantMap>
 #include <QtCore/QElapsedTimer>
-#include <QtConcurrent/QtConcurrent>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <algorithm>
@@ -41,6 +47,28 @@
 
 namespace ocr_orc {
 
+namespace {
+    // True (and logged) if the run has a channel that was cancelled
+    bool cancelRequested(DetectionProgressChannel* channel, const char* after) {
+        if (!channel || !channel->isCancelled()) {
+            return false;
+        }
+        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Cancelled after %s\n", after);
+        fflush(stderr);
+        return true;
+    }
+    
+    // Publish a partial layer if the run has a channel; true if the run should stop
+    bool publishPartial(DetectionProgressChannel* channel, PartialDetectionLayer::Kind kind,
+                        const QList<DetectedRegion>& regions) {
+        if (!channel) {
+            return false;
+        }
+        channel->publish(PartialDetectionLayer(kind, regions));
+        return cancelRequested(channel, PartialDetectionLayer::kindName(kind).toLocal8Bit().constData());
+    }
+}
+
 RegionDetector::RegionDetector()
     : minCellWidth(20)
     , minCellHeight(20)
@@ -50,7 +78,10 @@ RegionDetector::RegionDetector()
     , contourMinArea(400)
     , consensusMode(LENIENT_CONSENSUS)
     , enablePreprocessing(false)
+    , preprocessingMode(DocumentPreprocessor::FAST_PREPROCESSING)
+    , recognitionMode(OcrTextExtractor::TWO_TIER_RECOGNITION)
     , instrumentation(nullptr)
+    , progressChannel(nullptr)
 {
 }
 
@@ -96,6 +127,9 @@ DetectionResult RegionDetector::detectRegions(const QImage& image, const QString
         return detectRegionsOCRFirst(image, method, params);
     }
     
+    // Counts against the thread budget like an OCR-first run
+    ConcurrencyGovernor::DetectionLease threadLease;
+    
     // Multi-scale detection: process at 3 scales and merge results
     QList<DetectionResult> scaleResults;
     QList<double> scales = {0.5, 1.0, 2.0};
@@ -201,13 +235,15 @@ DetectionResult RegionDetector::detectRegions(const QImage& image, const QString
             }
         }
         
-        // Step 3: Spatial clustering and grid detection
+        // Step 3: Spatial clustering and grid detection (one graph shared by both stages;
+        // they read only the sorted orders, so no neighbour lists are built)
+        RegionNeighborGraph regionGraph(mergedResult.regions, 0.0);
         SpatialClusterer clusterer;
-        mergedResult.detectedGrid = clusterer.detectGridStructure(mergedResult.regions);
+        mergedResult.detectedGrid = clusterer.detectGridStructure(regionGraph, mergedResult.regions);
         
         // Step 4: Group inference
         GroupInferencer groupInferencer;
-        QList<DetectedGroup> spatialGroups = groupInferencer.inferGroupsFromSpatial(mergedResult.regions);
+        QList<DetectedGroup> spatialGroups = groupInferencer.inferGroupsFromSpatial(regionGraph);
         QList<DetectedGroup> patternGroups = groupInferencer.inferGroupsFromPatterns(mergedResult.regions);
         
         // Combine groups (prefer pattern-based groups)
@@ -1031,6 +1067,15 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     DetectionResult result;
     result.methodUsed = method;
     
+    // Runtime tracing (no-op unless enabled via Preferences or OCR_ORC_TRACE)
+    TraceSpan runSpan("detectRegionsOCRFirst", "detection");
+    runSpan.setArg("image_width", image.width());
+    runSpan.setArg("image_height", image.height());
+    
+    // Register with the thread budget; the stage graph sizes itself from this run's share
+    ConcurrencyGovernor::DetectionLease threadLease;
+    runSpan.setArg("thread_allocation", threadLease.getAllocation().toString());
+    
     try {
         fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 1: Validating input image...\n");
         fflush(stderr);
@@ -1044,61 +1089,183 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
                 image.width(), image.height());
         fflush(stderr);
         
+        // Page conversions, classification and thresholds are shared by all stages of this run
+        DetectionContext context(image, params);
+        // Without an explicit reference the source page keeps its colour for
+        // classification, so preprocessing is free to reduce the working image to gray
+        context.setColorReference(colorReference.isNull() && image.format() != QImage::Format_Grayscale8
+                                      ? image : colorReference);
+        
         // Instrumentation: Start pipeline (disabled in production - only works in test builds)
         // Note: Instrumentation calls are commented out to avoid compilation issues
         // They would need to be enabled via preprocessor or runtime checks
         
-        // Stage 1: OCR Extraction
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2: Starting OCR Extraction stage...\n");
+        // Stages 0-2 run as a task graph. OCR reads the source page and starts
+        // immediately; preprocessing feeds classification, rectangle detection
+        // and the standalone checkbox scan; text-associated checkbox checks need
+        // both the OCR hints and the working page. This thread waits for each
+        // result where the pipeline first uses it.
+        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2: Building stage graph...\n");
         fflush(stderr);
+        
+        OcrTextExtractor extractor;
+        QList<OCRTextRegion> ocrRegions;
+        cv::Mat cvImage = context.getSourceBgr();  // Replaced by the preprocessing task
+        DocumentType docType = STANDARD_FORM;
+        
+        RectangleDetector rectangleDetector;
+        rectangleDetector.setSensitivity(0.15);
+        rectangleDetector.setMinSize(15, 10);
+        rectangleDetector.setMaxSize(800, 300);
+        QList<DetectedRectangle> rectangleResults;
+        
+        // Apply checkbox parameters from DetectionParameters
+        CheckboxDetector checkboxDetector;
+        checkboxDetector.setSizeRange(params.minCheckboxSize, params.maxCheckboxSize);
+        checkboxDetector.setAspectRatioRange(params.checkboxAspectRatioMin, params.checkboxAspectRatioMax);
+        checkboxDetector.setRectangularityThreshold(params.checkboxRectangularity);
+        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2: Checkbox parameters - size: %d-%dpx, aspect: %.1f-%.1f, rectangularity: %.2f, standalone: %s\n",
+                params.minCheckboxSize, params.maxCheckboxSize, params.checkboxAspectRatioMin, params.checkboxAspectRatioMax,
+                params.checkboxRectangularity, params.enableStandaloneCheckboxDetection ? "ENABLED" : "DISABLED");
+        fflush(stderr);
+        QList<CheckboxDetection> standaloneCheckboxes;
+        
+        // Text-associated checkbox checks are split into one slice per worker
+        const int stageWorkers = std::max(1, threadLease.getAllocation().stageWorkers);
+        std::vector<QList<CheckboxDetection>> checkboxSlices(stageWorkers);
+        
+        // Declared after everything its tasks capture, so it is joined first
+        TaskGraph stageGraph(stageWorkers);
+        
+        QList<int> pageInputs;  // Tasks that read cvImage wait for preprocessing
+        int preprocessTask = -1;
+        if (enablePreprocessing) {
+            preprocessTask = stageGraph.addTask("Stage 0: Document Preprocessing", [&]() {
+                TraceSpan preprocessSpan("Stage 0: Document Preprocessing", "stage");
+                DocumentPreprocessor preprocessor;
+                preprocessor.setMode(preprocessingMode);
+                // Classification samples saturation from the context's colour reference
+                preprocessor.setColorOutputRequired(false);
+                preprocessSpan.setArg("fast_mode", preprocessingMode == DocumentPreprocessor::FAST_PREPROCESSING);
+                cvImage = preprocessor.preprocess(cvImage);
+                context.setWorkingImage(cvImage);
+            });
+            pageInputs.append(preprocessTask);
+        }
+        
+        // OCR and (without preprocessing) rectangle detection depend only on the
+        // page, so a speculative run started at PDF load may have done them already
+        PageAnalysisCache& pageCache = PageAnalysisCache::instance();
+        const quint64 pageKey = PageAnalysisCache::pageKey(image);
+        
+        const int ocrTask = stageGraph.addTask("Stage 1: OCR Extraction", [&]() {
+            TraceSpan ocrSpan("Stage 1: OCR Extraction", "stage");
+            QElapsedTimer ocrStageTimer;
+            ocrStageTimer.start();
+            const bool cached = pageCache.lookupOcr(pageKey, recognitionMode, ocrRegions, true);
+            if (cached) {
+                fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Stage 1: Using cached OCR for this page\n");
+                fflush(stderr);
+            } else {
+                if (recognitionMode == OcrTextExtractor::TWO_TIER_RECOGNITION) {
+                    ocrRegions = extractor.extractTextRegionsTwoTier(context.getSourceBgr());
+                    ocrSpan.setArg("layout_words", extractor.getLastLayoutWordCount());
+                    ocrSpan.setArg("refined_runs", extractor.getLastRefinedSegmentCount());
+                } else {
+                    ocrRegions = extractor.extractTextRegions(context.getSourceBgr());
+                }
+                pageCache.storeOcr(pageKey, recognitionMode, ocrRegions);
+            }
+            ocrSpan.setArg("cached", cached);
+            ocrSpan.setArg("two_tier", recognitionMode == OcrTextExtractor::TWO_TIER_RECOGNITION);
+            ocrSpan.setArg("regions_found", ocrRegions.size());
+            OCR_ORC_TRACE_COUNTER("ocr_regions", ocrRegions.size());
+            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] ✓ OCR extraction returned %lld regions (took %.1f seconds)\n",
+                    (long long)ocrRegions.size(), ocrStageTimer.elapsed() / 1000.0);
+            fflush(stderr);
+        });
+        
+        const int classifyTask = stageGraph.addTask("Stage 1.5: Document Type Classification", [&]() {
+            TraceSpan classifySpan("Stage 1.5: Document Type Classification", "stage");
+            docType = context.getDocumentType();
+            context.getThresholdManager();  // Built here, off the critical path
+            classifySpan.setArg("document_type", static_cast<int>(docType));
+        }, pageInputs);
+        
+        const int rectTask = stageGraph.addTask("Stage 1.6: Rectangle Detection", [&]() {
+            TraceSpan rectSpan("Stage 1.6: Rectangle Detection", "stage");
+            // Cached rectangles were found on the unprocessed page
+            const bool cached = !enablePreprocessing && pageCache.lookupRectangles(pageKey, rectangleResults);
+            if (!cached) {
+                rectangleResults = rectangleDetector.detectRectangles(cvImage);
+                if (!enablePreprocessing) {
+                    pageCache.storeRectangles(pageKey, rectangleResults);
+                }
+            }
+            rectSpan.setArg("cached", cached);
+            rectSpan.setArg("rectangles_found", rectangleResults.size());
+        }, pageInputs);
+        
+        int standaloneTask = -1;
+        if (params.enableStandaloneCheckboxDetection) {
+            standaloneTask = stageGraph.addTask("Stage 2: Standalone Checkbox Scan", [&]() {
+                TraceSpan standaloneSpan("Stage 2: Standalone Checkbox Scan", "stage");
+                standaloneCheckboxes = checkboxDetector.detectAllCheckboxes(cvImage);
+                standaloneSpan.setArg("checkboxes_found", standaloneCheckboxes.size());
+            }, pageInputs);
+        }
+        
+        QList<int> checkboxTasks;
+        for (int slice = 0; slice < stageWorkers; ++slice) {
+            checkboxTasks.append(stageGraph.addTask(QString("Stage 2: Checkbox Slice %1").arg(slice), [&, slice]() {
+                // Contiguous slices, so concatenating them keeps OCR order
+                const QList<OCRTextRegion>& hints = ocrRegions;
+                const int begin = static_cast<int>(hints.size() * slice / stageWorkers);
+                const int end = static_cast<int>(hints.size() * (slice + 1) / stageWorkers);
+                QList<CheckboxDetection>& detections = checkboxSlices[slice];
+                for (int i = begin; i < end; ++i) {
+                    if (stageGraph.isCancelled()) {
+                        return;  // Result is being discarded
+                    }
+                    TraceSpan candidateSpan("detectCheckbox", "candidate");
+                    if (candidateSpan.isActive()) {
+                        candidateSpan.setArg("index", i);
+                        candidateSpan.setArg("text", hints.at(i).text);
+                    }
+                    CheckboxDetection cb = checkboxDetector.detectCheckbox(hints.at(i), cvImage);
+                    if (candidateSpan.isActive()) {
+                        candidateSpan.setArg("detected", cb.detected);
+                    }
+                    detections.append(cb);
+                }
+            }, pageInputs + QList<int>{ocrTask}));
+        }
+        
 #ifdef OCR_ORC_TEST_BUILD
         if (instrumentation) {
             PipelineInstrumentation* inst = static_cast<PipelineInstrumentation*>(instrumentation);
             inst->startStage("Stage 1: OCR Extraction");
+            if (enablePreprocessing) {
+                inst->startStage("Stage 0: Document Preprocessing");
+            }
+            inst->startStage("Stage 1.5: Document Type Classification");
+            inst->startStage("Stage 1.6: Parallel Rectangle Detection");
+            QVariantMap rectParams;
+            rectParams["sensitivity"] = 0.15;
+            rectParams["min_size"] = QString("%1x%2").arg(15).arg(10);
+            rectParams["max_size"] = QString("%1x%2").arg(800).arg(300);
+            inst->logEvent("rectangle_detection_start", rectParams, QVariantMap());
         }
 #endif
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2.1: Creating OcrTextExtractor...\n");
-        fflush(stderr);
-        
-        OcrTextExtractor extractor;
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2.1: ✓ OcrTextExtractor created\n");
+        stageGraph.start();
+        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2: ✓ Started %d stage tasks on %d workers\n",
+                stageGraph.getTaskCount(), stageGraph.getWorkerCount());
+        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2.1: Waiting for OCR - this may take 30-120 seconds\n");
         fflush(stderr);
         
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2.2: About to call extractTextRegions()...\n");
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] WARNING: This may take 30-120 seconds!\n");
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Current thread: %p\n", (void*)QThread::currentThread());
+        stageGraph.wait(ocrTask);
+        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2.1: ✓ OCR regions found: %lld\n", (long long)ocrRegions.size());
         fflush(stderr);
-        
-        QList<OCRTextRegion> ocrRegions;
-        QElapsedTimer ocrStageTimer;
-        ocrStageTimer.start();
-        
-        try {
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Calling extractor.extractTextRegions() NOW...\n");
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] This is a blocking call - progress will appear stuck but OCR is working\n");
-            fflush(stderr);
-            
-            // Note: We can't emit progress here because we don't have access to the worker's signals
-            // The OCR call will block this thread, so the timer in DetectionWorker won't fire
-            // This is expected behavior - OCR is CPU-intensive and blocks the thread
-            
-            ocrRegions = extractor.extractTextRegions(image);
-            qint64 ocrElapsed = ocrStageTimer.elapsed();
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] ✓ extractTextRegions() returned (took %lld ms = %.1f seconds)\n", 
-                    ocrElapsed, ocrElapsed / 1000.0);
-            fflush(stderr);
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 2.2: ✓ extractTextRegions() returned\n");
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] OCR regions found: %lld\n", (long long)ocrRegions.size());
-            fflush(stderr);
-        } catch (const std::exception& e) {
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] EXCEPTION in extractTextRegions(): %s\n", e.what());
-            fflush(stderr);
-            throw; // Re-throw to be caught by outer try-catch
-        } catch (...) {
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] UNKNOWN EXCEPTION in extractTextRegions()\n");
-            fflush(stderr);
-            throw; // Re-throw to be caught by outer try-catch
-        }
     
 #ifdef OCR_ORC_TEST_BUILD
     if (instrumentation) {
@@ -1121,15 +1288,38 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     }
 #endif
     
+        // Partial result: word boxes, so the page layout is visible while the passes run
+        QList<DetectedRegion> ocrWordLayer;
+        ocrWordLayer.reserve(ocrRegions.size());
+        for (const OCRTextRegion& word : ocrRegions) {
+            ocrWordLayer.append(DetectedRegion(convertToNormalized(word.boundingBox, image.width(), image.height()),
+                                               word.confidence / 100.0, "ocr", word.boundingBox));
+        }
+        if (publishPartial(progressChannel, PartialDetectionLayer::OCR_WORDS, ocrWordLayer)) {
+            stageGraph.cancel();
+            return result;
+        }
+        
         fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 3: Checking OCR results...\n");
         fflush(stderr);
         if (ocrRegions.isEmpty()) {
             fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 3: No OCR regions found, falling back to CV-only...\n");
             fflush(stderr);
+            // Stage tasks that have not started are dropped and checkbox slices stop at
+            // their next candidate. A preprocessing, rectangle or standalone checkbox
+            // pass already running is one OpenCV call that cannot be interrupted; it
+            // keeps running alongside the fallback and the graph destructor waits
+            // for it on return.
+            stageGraph.cancel();
             // Fallback to CV-only if OCR fails
             try {
                 DetectionParameters defaultParams;
-                return detectRegions(image, "hybrid", defaultParams);
+                DetectionResult fallback = detectRegions(image, "hybrid", defaultParams);
+                // CV-only regions stand in for the consensus layer the passes would have published
+                if (publishPartial(progressChannel, PartialDetectionLayer::CONSENSUS_REGIONS, fallback.regions)) {
+                    return result;
+                }
+                return fallback;
             } catch (const std::exception& e) {
                 fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] EXCEPTION in fallback detectRegions(): %s\n", e.what());
                 fflush(stderr);
@@ -1143,95 +1333,29 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         
         fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 3: ✓ OCR regions found, continuing with pipeline...\n");
         fflush(stderr);
-        
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 4: Converting image to cv::Mat...\n");
-        fflush(stderr);
-        // Convert image to cv::Mat for CV processing
-        cv::Mat cvImage;
-        try {
-            cvImage = ImageConverter::qImageToMat(image);
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 4: ✓ Image converted - cv::Mat size: %dx%d\n", 
-                    cvImage.cols, cvImage.rows);
-            fflush(stderr);
-        } catch (const std::exception& e) {
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] EXCEPTION converting image: %s\n", e.what());
-            fflush(stderr);
-            throw;
-        } catch (...) {
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] UNKNOWN EXCEPTION converting image\n");
-            fflush(stderr);
-            throw;
-        }
-        
-        int imgWidth = image.width();
-        int imgHeight = image.height();
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Image dimensions: %dx%d\n", imgWidth, imgHeight);
-        fflush(stderr);
-        
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] DEBUG: About to check preprocessing flag...\n");
-        fflush(stderr);
     
     // Stage 0: Document Preprocessing (expert recommendation: handle scanned document issues)
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 5: Checking preprocessing flag (enablePreprocessing=%s)...\n", 
-            enablePreprocessing ? "true" : "false");
-    fflush(stderr);
-    if (enablePreprocessing) {
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 5.1: Starting document preprocessing...\n");
-        fflush(stderr);
-#ifdef OCR_ORC_TEST_BUILD
-        if (instrumentation) {
-            PipelineInstrumentation* inst = static_cast<PipelineInstrumentation*>(instrumentation);
-            inst->startStage("Stage 0: Document Preprocessing");
-        }
-#endif
-        DocumentPreprocessor preprocessor;
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 5.2: Calling preprocessor.preprocess()...\n");
-        fflush(stderr);
-        cvImage = preprocessor.preprocess(cvImage);
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 5.2: ✓ Preprocessing complete\n");
-        fflush(stderr);
-        // Update image dimensions if preprocessing changed size (e.g., rotation)
-        imgWidth = cvImage.cols;
-        imgHeight = cvImage.rows;
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 5.3: Updated dimensions: %dx%d\n", imgWidth, imgHeight);
-        fflush(stderr);
-#ifdef OCR_ORC_TEST_BUILD
-        if (instrumentation) {
-            PipelineInstrumentation* inst = static_cast<PipelineInstrumentation*>(instrumentation);
-            QVariantMap outputs;
-            outputs["output_width"] = imgWidth;
-            outputs["output_height"] = imgHeight;
-            inst->logEvent("preprocessing", QVariantMap(), outputs);
-            inst->endStage("Stage 0: Document Preprocessing");
-        }
-#endif
-    }
-    
-    // Stage 1.5: Document Type Classification and Adaptive Thresholds
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 6: Starting document type classification...\n");
+    stageGraph.wait(preprocessTask);
+    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 5: ✓ Working image ready (preprocessing %s) - %dx%d\n",
+            enablePreprocessing ? "applied" : "disabled", cvImage.cols, cvImage.rows);
     fflush(stderr);
 #ifdef OCR_ORC_TEST_BUILD
-    if (instrumentation) {
+    if (instrumentation && enablePreprocessing) {
         PipelineInstrumentation* inst = static_cast<PipelineInstrumentation*>(instrumentation);
-        inst->startStage("Stage 1.5: Document Type Classification");
+        QVariantMap outputs;
+        outputs["output_width"] = cvImage.cols;
+        outputs["output_height"] = cvImage.rows;
+        inst->logEvent("preprocessing", QVariantMap(), outputs);
+        inst->endStage("Stage 0: Document Preprocessing");
     }
 #endif
-    DocumentTypeClassifier classifier;
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 6.1: Calling classifier.classifyDocument()...\n");
-    fflush(stderr);
-    DocumentType docType = classifier.classifyDocument(cvImage);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 6.1: ✓ Classification complete, docType=%d\n", static_cast<int>(docType));
-    fflush(stderr);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 6.2: Creating AdaptiveThresholdManager...\n");
+    
+    // Stage 1.5: Document Type Classification and Adaptive Thresholds
+    stageGraph.wait(classifyTask);
+    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 6: ✓ Classification complete, docType=%d\n", static_cast<int>(docType));
     fflush(stderr);
-    AdaptiveThresholdManager thresholdManager(docType);
-    // Apply custom parameter overrides
-    thresholdManager.setCustomOverrides(params.baseBrightnessThreshold, params.edgeDensityThreshold,
-                                        params.horizontalEdgeDensityThreshold, params.verticalEdgeDensityThreshold,
-                                        params.iouThreshold, params.ocrConfidenceThreshold,
-                                        params.horizontalOverfitPercent, params.verticalOverfitPercent,
-                                        params.brightnessAdaptiveFactor);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 6.2: ✓ ThresholdManager created with custom overrides\n");
+    // Custom parameter overrides are applied by the context
+    AdaptiveThresholdManager thresholdManager = context.getThresholdManager();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Custom: brightness=%.2f, edge=%.3f, horiz=%.3f, vert=%.3f\n",
             params.baseBrightnessThreshold, params.edgeDensityThreshold, 
             params.horizontalEdgeDensityThreshold, params.verticalEdgeDensityThreshold);
@@ -1254,60 +1378,9 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
 #endif
     
     // Use adaptive confidence threshold based on document type
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 7: Getting OCR confidence threshold...\n");
-    fflush(stderr);
     double ocrConfidenceThreshold = thresholdManager.getOcrConfidenceThreshold(docType);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 7: ✓ Threshold = %.2f\n", ocrConfidenceThreshold);
-    fflush(stderr);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 7.1: Setting confidence threshold on extractor...\n");
-    fflush(stderr);
     extractor.setConfidenceThreshold(ocrConfidenceThreshold);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 7.1: ✓ Threshold set\n");
-    fflush(stderr);
-    
-    // Stage 1.6: Parallel Processing - Start rectangle detection in parallel
-    // (Rectangle detection runs while we do pattern analysis and refinement)
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 8: Creating RectangleDetector...\n");
-    fflush(stderr);
-#ifdef OCR_ORC_TEST_BUILD
-    if (instrumentation) {
-        PipelineInstrumentation* inst = static_cast<PipelineInstrumentation*>(instrumentation);
-        inst->startStage("Stage 1.6: Parallel Rectangle Detection");
-    }
-#endif
-    RectangleDetector rectangleDetector;
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 8: ✓ RectangleDetector created\n");
-    fflush(stderr);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 8.1: Setting rectangle detector parameters...\n");
-    fflush(stderr);
-    rectangleDetector.setSensitivity(0.15);
-    rectangleDetector.setMinSize(15, 10);
-    rectangleDetector.setMaxSize(800, 300);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 8.1: ✓ Parameters set\n");
-    fflush(stderr);
-    
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 8.2: Creating QVariantMap for rectangle params...\n");
-    fflush(stderr);
-    QVariantMap rectParams;
-    rectParams["sensitivity"] = 0.15;
-    rectParams["min_size"] = QString("%1x%2").arg(15).arg(10);
-    rectParams["max_size"] = QString("%1x%2").arg(800).arg(300);
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 8.2: ✓ QVariantMap created\n");
-    fflush(stderr);
-#ifdef OCR_ORC_TEST_BUILD
-    if (instrumentation) {
-        PipelineInstrumentation* inst = static_cast<PipelineInstrumentation*>(instrumentation);
-        inst->logEvent("rectangle_detection_start", rectParams, QVariantMap());
-    }
-#endif
-    
-    // Start rectangle detection in parallel (will wait for result later in Pass 6)
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 9: Starting rectangle detection in parallel...\n");
-    fflush(stderr);
-    QFuture<QList<DetectedRectangle>> rectFuture = QtConcurrent::run([&rectangleDetector, &cvImage]() {
-        return rectangleDetector.detectRectangles(cvImage);
-    });
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 9: ✓ Rectangle detection started in parallel\n");
+    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 7: ✓ OCR confidence threshold = %.2f\n", ocrConfidenceThreshold);
     fflush(stderr);
     
     // Stage 2: Pattern Analysis (before individual refinement)
@@ -1319,55 +1392,27 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->startStage("Stage 2: Pattern Analysis");
     }
 #endif
+    TraceSpan patternSpan("Stage 2: Pattern Analysis", "stage");
     PatternAnalyzer patternAnalyzer;
-    CheckboxDetector checkboxDetector;
     
-    // Apply checkbox parameters from DetectionParameters
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.1: Applying checkbox parameters from dialog...\n");
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.1: BEFORE - size: %d-%dpx, aspect: %.1f-%.1f, rectangularity: %.2f, standalone: %s\n",
-            params.minCheckboxSize, params.maxCheckboxSize, params.checkboxAspectRatioMin, params.checkboxAspectRatioMax, 
-            params.checkboxRectangularity, params.enableStandaloneCheckboxDetection ? "ENABLED" : "DISABLED");
+    // Collect checkboxes for all regions
+    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2: Waiting for checkbox checks of %lld regions...\n", (long long)ocrRegions.size());
     fflush(stderr);
-    
-    checkboxDetector.setSizeRange(params.minCheckboxSize, params.maxCheckboxSize);
-    checkboxDetector.setAspectRatioRange(params.checkboxAspectRatioMin, params.checkboxAspectRatioMax);
-    checkboxDetector.setRectangularityThreshold(params.checkboxRectangularity);
-    
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.1: ✓ PatternAnalyzer and CheckboxDetector created\n");
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.1: ✓ Checkbox parameters APPLIED - size: %d-%dpx, aspect: %.1f-%.1f, rectangularity: %.2f\n",
-            params.minCheckboxSize, params.maxCheckboxSize, params.checkboxAspectRatioMin, params.checkboxAspectRatioMax, params.checkboxRectangularity);
-    fflush(stderr);
-    
-    // Detect checkboxes for all regions
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2: Detecting checkboxes for %lld regions...\n", (long long)ocrRegions.size());
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2: WARNING - This may take 10-30 seconds (processing %lld regions sequentially)\n", (long long)ocrRegions.size());
-    fflush(stderr);
-    QList<CheckboxDetection> checkboxes;
-    int checkboxCount = 0;
     QElapsedTimer checkboxTimer;
     checkboxTimer.start();
-    for (const OCRTextRegion& ocrRegion : ocrRegions) {
-        CheckboxDetection cb = checkboxDetector.detectCheckbox(ocrRegion, cvImage);
-        checkboxes.append(cb);
-        checkboxCount++;
-        if (checkboxCount % 20 == 0) {
-            qint64 elapsed = checkboxTimer.elapsed();
-            double avgTimePerRegion = elapsed / (double)checkboxCount;
-            double estimatedRemaining = avgTimePerRegion * (ocrRegions.size() - checkboxCount) / 1000.0;
-            fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2: Processed %d/%lld checkboxes (%.1fs elapsed, ~%.1fs remaining)...\n", 
-                    checkboxCount, (long long)ocrRegions.size(), elapsed / 1000.0, estimatedRemaining);
-            fflush(stderr);
-        }
+    QList<CheckboxDetection> checkboxes;
+    checkboxes.reserve(ocrRegions.size());
+    for (int slice = 0; slice < stageWorkers; ++slice) {
+        stageGraph.wait(checkboxTasks[slice]);
+        checkboxes.append(checkboxSlices[slice]);
     }
-    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2: ✓ Text-associated checkbox detection complete (%lld checkboxes)\n", (long long)checkboxes.size());
+    fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2: ✓ Text-associated checkbox detection complete (%lld checkboxes, waited %.1f seconds)\n",
+            (long long)checkboxes.size(), checkboxTimer.elapsed() / 1000.0);
     fflush(stderr);
     
-    // Step 10.2.5: Detect standalone checkboxes (not associated with text)
-    QList<CheckboxDetection> standaloneCheckboxes;
-    if (params.enableStandaloneCheckboxDetection) {
-        fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2.5: Detecting standalone checkboxes (scanning entire image)...\n");
-        fflush(stderr);
-        standaloneCheckboxes = checkboxDetector.detectAllCheckboxes(cvImage);
+    // Step 10.2.5: Standalone checkboxes (not associated with text)
+    if (standaloneTask >= 0) {
+        stageGraph.wait(standaloneTask);
     } else {
         fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.2.5: Standalone checkbox detection disabled\n");
         fflush(stderr);
@@ -1417,6 +1462,8 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.3: Analyzing checkbox pattern...\n");
     fflush(stderr);
     QString checkboxPattern = patternAnalyzer.analyzeCheckboxPattern(ocrRegions, checkboxes);
+    patternSpan.setArg("checkboxes_detected", checkboxes.size());
+    patternSpan.end();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 10.3: ✓ Pattern analysis complete\n");
     fflush(stderr);
     
@@ -1451,11 +1498,22 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     // Stage 3.5: Initialize detection cache for performance optimization (expert recommendation)
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 11.2: Initializing detection cache...\n");
     fflush(stderr);
-    DetectionCache detectionCache;
-    refiner.setDetectionCache(&detectionCache);
+    refiner.setDetectionContext(&context);
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 11.2: ✓ Detection cache initialized\n");
     fflush(stderr);
     
+    // Passes 1-5 poll the channel before each candidate and stop the run between passes
+    const std::function<bool()> runCancelled = [this]() {
+        return progressChannel && progressChannel->isCancelled();
+    };
+    auto stopIfCancelled = [&](const char* after) {
+        if (!cancelRequested(progressChannel, after)) {
+            return false;
+        }
+        stageGraph.cancel();  // Rectangle detection may still be queued or running
+        return true;
+    };
+    
     // Pass 1: Use OCR hints to find empty form fields nearby
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 12: Pass 1 - Finding empty form fields...\n");
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 12: WARNING - This may take 15-60 seconds (processing %lld OCR hints with CV operations)\n", (long long)ocrRegions.size());
@@ -1468,7 +1526,11 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
 #endif
     QElapsedTimer findFieldsTimer;
     findFieldsTimer.start();
-    QList<cv::Rect> emptyFormFields = refiner.findEmptyFormFields(ocrRegions, cvImage);
+    TraceSpan pass1Span("Pass 1: Find Empty Form Fields", "stage");
+    QList<cv::Rect> emptyFormFields = refiner.findEmptyFormFields(ocrRegions, cvImage, runCancelled);
+    pass1Span.setArg("fields_found", emptyFormFields.size());
+    pass1Span.end();
+    OCR_ORC_TRACE_COUNTER("empty_form_fields", emptyFormFields.size());
     qint64 findFieldsElapsed = findFieldsTimer.elapsed();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 12: ✓ Pass 1 complete - Found %lld empty form fields (took %.1f seconds)\n", 
             (long long)emptyFormFields.size(), findFieldsElapsed / 1000.0);
@@ -1482,6 +1544,9 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->endStage("Pass 1: Find Empty Form Fields");
     }
 #endif
+    if (stopIfCancelled("Pass 1")) {
+        return result;
+    }
     
     // Pass 2: Filter out any regions that contain text
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 13: Pass 2 - Filtering text-containing regions...\n");
@@ -1500,7 +1565,17 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     fflush(stderr);
     QElapsedTimer filterTimer;
     filterTimer.start();
+    TraceSpan pass2Span("Pass 2: Filter Text-Containing Regions", "stage");
     for (const cv::Rect& field : emptyFormFields) {
+        if (runCancelled()) {
+            break;
+        }
+        TraceSpan fieldSpan("regionContainsText", "candidate");
+        if (fieldSpan.isActive()) {
+            fieldSpan.setArg("pass", "2");
+            fieldSpan.setArg("index", processedFields);
+            fieldSpan.setArg("rect", QString("%1,%2 %3x%4").arg(field.x).arg(field.y).arg(field.width).arg(field.height));
+        }
         fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 13: Processing field %d/%d (x=%d, y=%d, w=%d, h=%d)...\n", 
                 processedFields + 1, totalFields, field.x, field.y, field.width, field.height);
         fflush(stderr);
@@ -1510,6 +1585,10 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         fflush(stderr);
         bool containsText = refiner.regionContainsText(field, cvImage, ocrRegions, &thresholdManager, 
                                                        params.ocrOverlapThreshold, params.minHorizontalLines);
+        if (fieldSpan.isActive()) {
+            fieldSpan.setArg("contains_text", containsText);
+        }
+        fieldSpan.end();
         fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 13: regionContainsText() returned: %s for field %d\n", 
                 containsText ? "true" : "false", processedFields + 1);
         fflush(stderr);
@@ -1531,6 +1610,9 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
             fflush(stderr);
         }
     }
+    pass2Span.setArg("validated_fields", validatedFields.size());
+    pass2Span.setArg("filtered_out", filteredOut);
+    pass2Span.end();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 13: ✓ Pass 2 complete - Validated: %lld, Filtered: %d\n", (long long)validatedFields.size(), filteredOut);
     fflush(stderr);
 #ifdef OCR_ORC_TEST_BUILD
@@ -1543,6 +1625,9 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->endStage("Pass 2: Filter Text-Containing Regions");
     }
 #endif
+    if (stopIfCancelled("Pass 2")) {
+        return result;
+    }
     
     // Pass 3: Adaptive overfitting based on document type
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 14: Pass 3 - Adaptive overfitting...\n");
@@ -1553,8 +1638,12 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->startStage("Pass 3: Adaptive Overfitting");
     }
 #endif
+    TraceSpan pass3Span("Pass 3: Adaptive Overfitting", "stage");
     QList<cv::Rect> overfittedFields;
     for (const cv::Rect& field : validatedFields) {
+        if (runCancelled()) {
+            break;
+        }
         // Use adaptive overfitting percentages based on document type (or custom params)
         double horizontalOverfit = thresholdManager.getHorizontalOverfitPercent(docType);
         double verticalOverfit = thresholdManager.getVerticalOverfitPercent(docType);
@@ -1562,6 +1651,7 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
             field, cvImage, static_cast<int>(horizontalOverfit), static_cast<int>(verticalOverfit));
         overfittedFields.append(overfitted);
     }
+    pass3Span.end();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 14: ✓ Pass 3 complete - Overfitted: %lld fields\n", (long long)overfittedFields.size());
     fflush(stderr);
 #ifdef OCR_ORC_TEST_BUILD
@@ -1576,22 +1666,35 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->endStage("Pass 3: Adaptive Overfitting");
     }
 #endif
+    if (stopIfCancelled("Pass 3")) {
+        return result;
+    }
     
     // Pass 3.5: Use smart boundary detection to find actual form field edges within overfitted regions
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 15: Pass 3.5 - Refining overfitted regions...\n");
     fflush(stderr);
+    TraceSpan pass35Span("Pass 3.5: Refine Overfitted Regions", "stage");
     QList<cv::Rect> refinedOverfitted = formFieldDetector.refineOverfittedRegions(
-        overfittedFields, cvImage);
+        overfittedFields, cvImage, runCancelled);
+    pass35Span.end();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 15: ✓ Pass 3.5 complete - Refined: %lld regions\n", (long long)refinedOverfitted.size());
     fflush(stderr);
+    if (stopIfCancelled("Pass 3.5")) {
+        return result;
+    }
     
     // Pass 4: Detect cell groups with shared walls (grid patterns)
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 16: Pass 4 - Detecting cell groups...\n");
     fflush(stderr);
+    TraceSpan pass4Span("Pass 4: Detect Cell Groups", "stage");
     QList<QList<cv::Rect>> cellGroups = formFieldDetector.detectCellGroupsWithSharedWalls(
-        refinedOverfitted, cvImage);
+        refinedOverfitted, cvImage, runCancelled);
+    pass4Span.end();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 16: ✓ Pass 4 complete - Found %lld cell groups\n", (long long)cellGroups.size());
     fflush(stderr);
+    if (stopIfCancelled("Pass 4")) {
+        return result;
+    }
     
     // Flatten cell groups back to individual regions (for now - can enhance later to keep groups)
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 16.1: Flattening cell groups...\n");
@@ -1623,10 +1726,16 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     // Pass 5: Classify regions and filter out titles/headings
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 17: Pass 5 - Classifying and refining regions...\n");
     fflush(stderr);
+    TraceSpan pass5Span("Pass 5: Classify and Refine Regions", "stage");
     QList<cv::Rect> classifiedFields = formFieldDetector.classifyAndRefineRegions(
-        flattenedRegions, cvImage, ocrRegions);
+        flattenedRegions, cvImage, ocrRegions, runCancelled);
+    pass5Span.setArg("classified_fields", classifiedFields.size());
+    pass5Span.end();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 17: ✓ Pass 5 complete - Classified: %lld fields\n", (long long)classifiedFields.size());
     fflush(stderr);
+    if (stopIfCancelled("Pass 5")) {
+        return result;
+    }
     
     // Pass 6: SECONDARY PIPELINE - Get rectangle detection results (already running in parallel)
     // Wait for rectangle detection to complete (started in Stage 1.6)
@@ -1641,7 +1750,9 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
 #endif
     QElapsedTimer rectWaitTimer;
     rectWaitTimer.start();
-    QList<DetectedRectangle> rectangleResults = rectFuture.result();
+    TraceSpan pass6Span("Pass 6: Wait for Rectangle Detection", "stage");
+    stageGraph.wait(rectTask);
+    pass6Span.end();
     qint64 rectWaitElapsed = rectWaitTimer.elapsed();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 18: ✓ Pass 6 complete - Found %lld rectangles (waited %.1f seconds)\n", 
             (long long)rectangleResults.size(), rectWaitElapsed / 1000.0);
@@ -1656,6 +1767,17 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->endStage("Stage 1.6: Parallel Rectangle Detection");
     }
 #endif
+    {
+        QList<DetectedRegion> rectangleLayer;
+        rectangleLayer.reserve(rectangleResults.size());
+        for (const DetectedRectangle& rect : rectangleResults) {
+            rectangleLayer.append(DetectedRegion(convertToNormalized(rect.boundingBox, cvImage.cols, cvImage.rows),
+                                                 rect.confidence, "rectangle", rect.boundingBox));
+        }
+        if (publishPartial(progressChannel, PartialDetectionLayer::RECTANGLE_CANDIDATES, rectangleLayer)) {
+            return result;
+        }
+    }
     
     // Pass 7: MATCH and MERGE regions from both pipelines (consensus-based detection)
     // Match OCR-first results with rectangle detection results
@@ -1668,7 +1790,11 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->startStage("Pass 7: Match and Merge Pipelines");
     }
 #endif
-    DetectionResult mergedResult = matchAndMergePipelines(classifiedFields, rectangleResults, image, ocrRegions, params);
+    TraceSpan pass7Span("Pass 7: Match and Merge Pipelines", "stage");
+    DetectionResult mergedResult = matchAndMergePipelines(classifiedFields, rectangleResults, ocrRegions, context);
+    pass7Span.setArg("merged_regions", mergedResult.regions.size());
+    pass7Span.end();
+    OCR_ORC_TRACE_COUNTER("merged_regions", mergedResult.regions.size());
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 19: ✓ Pass 7 complete - Merged: %lld regions (high: %d, medium: %d, low: %d)\n", 
             (long long)mergedResult.regions.size(), mergedResult.highConfidence, mergedResult.mediumConfidence, mergedResult.lowConfidence);
     fflush(stderr);
@@ -1684,6 +1810,9 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         inst->endStage("Pass 7: Match and Merge Pipelines");
     }
 #endif
+    if (publishPartial(progressChannel, PartialDetectionLayer::CONSENSUS_REGIONS, mergedResult.regions)) {
+        return result;
+    }
     
     // Pass 8: Use merged consensus regions directly (already processed in matchAndMergePipelines)
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 20: Pass 8 - Using merged consensus regions...\n");
@@ -1701,8 +1830,15 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     int totalRegions = refinedRegions.size();
     int processedRegions = 0;
     int rejectedRegions = 0;
+    TraceSpan pass85Span("Pass 8.5: Final Text Filter", "stage");
     for (const DetectedRegion& region : refinedRegions) {
         cv::Rect fieldRect = region.boundingBox;
+        TraceSpan regionSpan("regionContainsText", "candidate");
+        if (regionSpan.isActive()) {
+            regionSpan.setArg("pass", "8.5");
+            regionSpan.setArg("index", processedRegions);
+            regionSpan.setArg("rect", QString("%1,%2 %3x%4").arg(fieldRect.x).arg(fieldRect.y).arg(fieldRect.width).arg(fieldRect.height));
+        }
         
         // STRICT check: region must NOT contain any text
         // This checks: OCR overlap, brightness, edge density, horizontal text lines
@@ -1725,6 +1861,8 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
             fflush(stderr);
         }
     }
+    pass85Span.setArg("rejected", rejectedRegions);
+    pass85Span.end();
     refinedRegions = textFilteredRegions;
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 21: ✓ Pass 8.5 complete - Kept: %lld, Rejected: %d\n", (long long)refinedRegions.size(), rejectedRegions);
     fflush(stderr);
@@ -1734,6 +1872,7 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     // Pass 9: Form Structure Analysis (expert recommendation: semantic understanding)
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 22: Pass 9 - Form structure analysis...\n");
     fflush(stderr);
+    TraceSpan pass9Span("Pass 9: Form Structure Analysis", "stage");
     FormStructureAnalyzer structureAnalyzer;
     QList<FormFieldGroup> formGroups = structureAnalyzer.detectFormStructure(refinedRegions, ocrRegions);
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 22: ✓ Pass 9 complete - Found %lld form groups\n", (long long)formGroups.size());
@@ -1762,7 +1901,10 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         }
     }
     
+    pass9Span.end();
+    
     // Pass 10: Enhance regions with additional classification and checkbox detection
+    TraceSpan pass10Span("Pass 10: Enhance Regions", "stage");
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 23: Pass 10 - Enhancing regions with classification...\n");
     fflush(stderr);
     int enhancedCount = 0;
@@ -1913,12 +2055,15 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 23.5: ✓ Added %d standalone checkboxes as separate regions\n", addedStandalone);
     fflush(stderr);
     
+    pass10Span.end();
+    
     // Stage 4: Group Inference
+    TraceSpan groupSpan("Stage 4: Group Inference", "stage");
     GroupInferencer groupInferencer;
     
-    // Convert OCR regions to DetectedRegions for group inference
-    // (GroupInferencer expects DetectedRegion list)
-    QList<DetectedGroup> groups = groupInferencer.inferGroupsFromSpatial(refinedRegions);
+    // Spatial grouping reads only the sorted orders of the refined regions
+    RegionNeighborGraph refinedGraph(refinedRegions, 0.0);
+    QList<DetectedGroup> groups = groupInferencer.inferGroupsFromSpatial(refinedGraph);
     
     // Also infer from patterns
     QList<DetectedGroup> patternGroups = groupInferencer.inferGroupsFromPatterns(refinedRegions);
@@ -1942,6 +2087,8 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
         }
     }
     
+    groupSpan.setArg("groups", combinedGroups.size());
+    groupSpan.end();
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 23: ✓ Pass 10 complete - Enhanced %lld regions\n", (long long)refinedRegions.size());
     fflush(stderr);
     
@@ -1984,6 +2131,8 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
     fflush(stderr);
     
     result.methodUsed = method;
+    runSpan.setArg("regions_detected", result.totalDetected);
+    OCR_ORC_TRACE_COUNTER("final_regions", result.totalDetected);
     fprintf(stderr, "[RegionDetector::detectRegionsOCRFirst] Step 24.3: ✓ Final result built - Method: %s, Total: %d regions\n", 
             result.methodUsed.toLocal8Bit().constData(), result.totalDetected);
     fflush(stderr);
@@ -2015,27 +2164,28 @@ DetectionResult RegionDetector::detectRegionsOCRFirst(const QImage& image, const
 
 DetectionResult RegionDetector::matchAndMergePipelines(const QList<cv::Rect>& ocrRegions,
                                                        const QList<DetectedRectangle>& rectangleRegions,
-                                                       const QImage& image,
                                                        const QList<OCRTextRegion>& ocrTextRegions,
-                                                       const DetectionParameters& params)
+                                                       DetectionContext& context,
+                                                       double pixelScale)
 {
     DetectionResult result;
     result.methodUsed = "ocr-first+rectangle-consensus";
     
-    if (image.isNull()) {
+    // Fields and rectangles are in working-image pixels (after preprocessing)
+    cv::Mat cvImage = context.getWorkingImage();
+    if (cvImage.empty()) {
         return result;
     }
+    const DetectionParameters& params = context.getParameters();
     
-    // Convert image to cv::Mat for text checking
-    cv::Mat cvImage = ImageConverter::qImageToMat(image);
-    
-    // Classify document type for adaptive thresholds
-    DocumentTypeClassifier classifier;
-    DocumentType docType = classifier.classifyDocument(cvImage);
-    AdaptiveThresholdManager thresholdManager(docType);
+    // Document type and thresholds from Stage 1.5
+    DocumentType docType = context.getDocumentType();
+    AdaptiveThresholdManager thresholdManager = context.getThresholdManager();
     
     // Create TextRegionRefiner for text filtering
     TextRegionRefiner refiner;
+    refiner.setDetectionContext(&context);
+    refiner.setPixelScale(pixelScale);
     
     QList<DetectedRegion> matchedRegions;
     
@@ -2149,15 +2299,21 @@ DetectionResult RegionDetector::matchAndMergePipelines(const QList<cv::Rect>& oc
                                  bestMatchedRect.x + bestMatchedRect.width, 
                                  bestMatchedRect.y + bestMatchedRect.height);
             NormalizedCoords normCoords = CoordinateSystem::imageToNormalized(
-                imgCoords, image.width(), image.height());
+                imgCoords, cvImage.cols, cvImage.rows);
             
             // CRITICAL: Check if region contains text BEFORE adding it
             // Pass thresholdManager for adaptive thresholds
             fprintf(stderr, "[RegionDetector::matchAndMergePipelines] Checking OCR region (x=%d,y=%d,w=%d,h=%d) for text...\n",
                     bestMatchedRect.x, bestMatchedRect.y, bestMatchedRect.width, bestMatchedRect.height);
             fflush(stderr);
+            TraceSpan candidateSpan("regionContainsText", "candidate");
             bool containsText = refiner.regionContainsText(bestMatchedRect, cvImage, ocrTextRegions, &thresholdManager,
                                                           params.ocrOverlapThreshold, params.minHorizontalLines);
+            if (candidateSpan.isActive()) {
+                candidateSpan.setArg("pass", "7-ocr");
+                candidateSpan.setArg("contains_text", containsText);
+            }
+            candidateSpan.end();
             fprintf(stderr, "[RegionDetector::matchAndMergePipelines] regionContainsText() returned: %s for OCR region\n",
                     containsText ? "TRUE (REJECTING)" : "FALSE (KEEPING)");
             fflush(stderr);
@@ -2227,8 +2383,14 @@ DetectionResult RegionDetector::matchAndMergePipelines(const QList<cv::Rect>& oc
             fprintf(stderr, "[RegionDetector::matchAndMergePipelines] Checking rectangle (x=%d,y=%d,w=%d,h=%d,conf=%.2f) for text...\n",
                     rectDet.boundingBox.x, rectDet.boundingBox.y, rectDet.boundingBox.width, rectDet.boundingBox.height, rectDet.confidence);
             fflush(stderr);
+            TraceSpan candidateSpan("regionContainsText", "candidate");
             bool containsText = refiner.regionContainsText(rectDet.boundingBox, cvImage, ocrTextRegions, &thresholdManager,
                                                           params.ocrOverlapThreshold, params.minHorizontalLines);
+            if (candidateSpan.isActive()) {
+                candidateSpan.setArg("pass", "7-rectangle");
+                candidateSpan.setArg("contains_text", containsText);
+            }
+            candidateSpan.end();
             fprintf(stderr, "[RegionDetector::matchAndMergePipelines] regionContainsText() returned: %s for rectangle\n",
                     containsText ? "TRUE (REJECTING)" : "FALSE (KEEPING)");
             fflush(stderr);
@@ -2246,7 +2408,7 @@ DetectionResult RegionDetector::matchAndMergePipelines(const QList<cv::Rect>& oc
                                  rectDet.boundingBox.x + rectDet.boundingBox.width, 
                                  rectDet.boundingBox.y + rectDet.boundingBox.height);
             NormalizedCoords normCoords = CoordinateSystem::imageToNormalized(
-                imgCoords, image.width(), image.height());
+                imgCoords, cvImage.cols, cvImage.rows);
             
             DetectedRegion region;
             region.coords = normCoords;
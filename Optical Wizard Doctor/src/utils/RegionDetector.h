@@ -10,6 +10,8 @@
 #include "../core/CoordinateSystem.h"
 #include "SpatialClusterer.h"
 #include "DocumentTypeClassifier.h"
+#include "DocumentPreprocessor.h"
+#include "OcrTextExtractor.h"
 
 namespace ocr_orc {
 
@@ -25,6 +27,12 @@ class AdaptiveThresholdManager;
 // Forward declare DetectionParameters - defined in MagicDetectParamsDialog.h
 struct DetectionParameters;
 
+// Forward declare DetectionContext - per-run page conversions and analysis
+class DetectionContext;
+
+// Forward declare DetectionProgressChannel - partial results and cancellation
+class DetectionProgressChannel;
+
 /**
  * @brief Detected region from automatic detection
  */
@@ -135,18 +143,42 @@ public:
      */
     bool isPreprocessingEnabled() const { return enablePreprocessing; }
     
+    /**
+     * @brief Set document preprocessing mode
+     * @param mode FAST_PREPROCESSING (default) or QUALITY_PREPROCESSING
+     */
+    void setPreprocessingMode(DocumentPreprocessor::PreprocessingMode mode) { preprocessingMode = mode; }
+    
+    /**
+     * @brief Get document preprocessing mode
+     */
+    DocumentPreprocessor::PreprocessingMode getPreprocessingMode() const { return preprocessingMode; }
+    
+    /**
+     * @brief Set how the OCR-first pipeline recognizes the page
+     * @param mode TWO_TIER_RECOGNITION (default) or FULL_PAGE_RECOGNITION
+     */
+    void setRecognitionMode(OcrTextExtractor::RecognitionMode mode) { recognitionMode = mode; }
+    
+    /**
+     * @brief Get OCR recognition mode
+     */
+    OcrTextExtractor::RecognitionMode getRecognitionMode() const { return recognitionMode; }
+    
     /**
      * @brief Match and merge results from OCR-first and rectangle detection pipelines
      * @param ocrRegions Results from OCR-first pipeline (cv::Rect)
      * @param rectangleRegions Results from rectangle detection pipeline (DetectedRectangle)
-     * @param image Source image
+     * @param ocrTextRegions OCR text regions for text filtering
+     * @param context Run context (working image, document type, thresholds, parameters)
+     * @param pixelScale Working image size relative to a full-resolution page (see TextRegionRefiner::setPixelScale())
      * @return Merged DetectionResult with matched regions (consensus-based)
      */
     DetectionResult matchAndMergePipelines(const QList<cv::Rect>& ocrRegions,
                                           const QList<DetectedRectangle>& rectangleRegions,
-                                          const QImage& image,
                                           const QList<OCRTextRegion>& ocrTextRegions,
-                                          const DetectionParameters& params);
+                                          DetectionContext& context,
+                                          double pixelScale = 1.0);
     
     /**
      * @brief Handle multi-label fields (one rectangle matching multiple OCR regions)
@@ -192,6 +224,27 @@ public:
         this->instrumentation = instrumentation;
     }
     
+    /**
+     * @brief Set the channel OCR-first runs publish partial results to
+     *
+     * OCR word boxes are published after Stage 1, rectangle candidates after
+     * Pass 6 and consensus regions after Pass 7 (or the CV-only fallback's
+     * regions when OCR finds no text). A run whose channel is cancelled stops
+     * at the next of these points, at the end of Passes 1-5 or at the next
+     * candidate inside them, and returns an empty result.
+     * @param channel Channel (not owned, may be nullptr to disable)
+     */
+    void setProgressChannel(DetectionProgressChannel* channel) { progressChannel = channel; }
+    
+    /**
+     * @brief Set a colour raster of the page for document classification
+     *
+     * OCR-first runs detect on the gray detection raster, which has no
+     * saturation; colour statistics are taken from this page instead.
+     * @param page Colour raster of the same page (e.g. the display raster), or null
+     */
+    void setColorReference(const QImage& page) { colorReference = page; }
+    
 private:
     // Detection methods
     DetectionResult detectGrid(const QImage& image);
@@ -225,10 +278,18 @@ private:
     int contourMinArea;      // Minimum contour area
     ConsensusMode consensusMode;  // Consensus matching mode (default: LENIENT_CONSENSUS)
     bool enablePreprocessing;    // Enable document preprocessing (default: false)
+    DocumentPreprocessor::PreprocessingMode preprocessingMode;  // Preprocessing mode (default: FAST_PREPROCESSING)
+    OcrTextExtractor::RecognitionMode recognitionMode;  // OCR mode (default: TWO_TIER_RECOGNITION)
     
     // Instrumentation (optional, for testing and analysis)
     // Using void* to avoid including test headers in production code
     void* instrumentation;
+    
+    // Partial results and cancellation (optional, not owned)
+    DetectionProgressChannel* progressChannel;
+    
+    // Colour raster of the page for classification (optional)
+    QImage colorReference;
 };
 
 } // namespace ocr_orc
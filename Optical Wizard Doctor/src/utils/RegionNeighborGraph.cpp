@@ -0,0 +1,147 @@
+#include "RegionNeighborGraph.h"
+#include "RegionDetector.h"  // Full definition needed here
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ocr_orc {
+
+RegionNeighborGraph::RegionNeighborGraph()
+    : radius(0.0)
+{
+    neighborOffsets.push_back(0);
+}
+
+RegionNeighborGraph::RegionNeighborGraph(const QList<DetectedRegion>& regions, double radius)
+    : radius(0.0)
+{
+    build(regions, radius);
+}
+
+void RegionNeighborGraph::build(const QList<DetectedRegion>& regions, double radius) {
+    batch.assign(regions);
+    this->radius = std::max(0.0, radius);
+    buildIndex();
+}
+
+void RegionNeighborGraph::build(const DetectedRegionBatch& batch, double radius) {
+    this->batch = batch;
+    this->radius = std::max(0.0, radius);
+    buildIndex();
+}
+
+void RegionNeighborGraph::buildIndex() {
+    const int n = batch.size();
+    
+    // Sorted orders for alignment clustering
+    xOrder.resize(static_cast<size_t>(n));
+    std::iota(xOrder.begin(), xOrder.end(), 0);
+    batch.sortIndicesByCenterX(xOrder.data(), xOrder.data() + n);
+    yOrder.resize(static_cast<size_t>(n));
+    std::iota(yOrder.begin(), yOrder.end(), 0);
+    batch.sortIndicesByCenterY(yOrder.data(), yOrder.data() + n);
+    
+    neighborOffsets.assign(static_cast<size_t>(n) + 1, 0);
+    neighborIndices.clear();
+    neighborDistancesSquared.clear();
+    if (n == 0 || radius <= 0.0) {
+        return;
+    }
+    
+    // Uniform grid over the center bounding box, cells of radius size
+    double minX = batch.centerX(xOrder.front());
+    double maxX = batch.centerX(xOrder.back());
+    double minY = batch.centerY(yOrder.front());
+    double maxY = batch.centerY(yOrder.back());
+    
+    int cols = std::clamp(static_cast<int>((maxX - minX) / radius) + 1, 1, MAX_GRID_CELLS_PER_AXIS);
+    int rows = std::clamp(static_cast<int>((maxY - minY) / radius) + 1, 1, MAX_GRID_CELLS_PER_AXIS);
+    double cellW = std::max(radius, (maxX - minX) / cols);
+    double cellH = std::max(radius, (maxY - minY) / rows);
+    
+    cellOfRow.resize(static_cast<size_t>(n));
+    cellOffsets.assign(static_cast<size_t>(rows * cols) + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        int cx = std::min(cols - 1, static_cast<int>((batch.centerX(i) - minX) / cellW));
+        int cy = std::min(rows - 1, static_cast<int>((batch.centerY(i) - minY) / cellH));
+        cellOfRow[i] = cy * cols + cx;
+        ++cellOffsets[cellOfRow[i] + 1];
+    }
+    for (size_t c = 1; c < cellOffsets.size(); ++c) {
+        cellOffsets[c] += cellOffsets[c - 1];
+    }
+    
+    // Rows are placed in ascending order, so each cell lists them ascending
+    cellRows.resize(static_cast<size_t>(n));
+    std::vector<int> fill(cellOffsets.begin(), cellOffsets.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        cellRows[fill[cellOfRow[i]]++] = i;
+    }
+    
+    const double radiusSquared = radius * radius;
+    std::vector<int> rowNeighbors;
+    for (int i = 0; i < n; ++i) {
+        const int cx = cellOfRow[i] % cols;
+        const int cy = cellOfRow[i] / cols;
+        const double x = batch.centerX(i);
+        const double y = batch.centerY(i);
+    
+        rowNeighbors.clear();
+        for (int gy = std::max(0, cy - 1); gy <= std::min(rows - 1, cy + 1); ++gy) {
+            for (int gx = std::max(0, cx - 1); gx <= std::min(cols - 1, cx + 1); ++gx) {
+                const int cell = gy * cols + gx;
+                for (int k = cellOffsets[cell]; k < cellOffsets[cell + 1]; ++k) {
+                    const int j = cellRows[k];
+                    if (j == i) {
+                        continue;
+                    }
+                    const double dx = batch.centerX(j) - x;
+                    const double dy = batch.centerY(j) - y;
+                    if (dx * dx + dy * dy <= radiusSquared) {
+                        rowNeighbors.push_back(j);
+                    }
+                }
+            }
+        }
+    
+        // Cells are visited out of row order; restore list order
+        std::sort(rowNeighbors.begin(), rowNeighbors.end());
+        for (int j : rowNeighbors) {
+            const double dx = batch.centerX(j) - x;
+            const double dy = batch.centerY(j) - y;
+            neighborIndices.push_back(j);
+            neighborDistancesSquared.push_back(dx * dx + dy * dy);
+        }
+        neighborOffsets[i + 1] = static_cast<int>(neighborIndices.size());
+    }
+}
+
+void RegionNeighborGraph::collectNeighbors(int index, double distance, std::vector<int>& neighbors) const {
+    neighbors.clear();
+    const double distanceSquared = distance * distance;
+    
+    if (distance <= radius) {
+        for (int k = neighborOffsets[index]; k < neighborOffsets[index + 1]; ++k) {
+            if (neighborDistancesSquared[k] <= distanceSquared) {
+                neighbors.push_back(neighborIndices[k]);
+            }
+        }
+        return;
+    }
+    
+    // Beyond the build radius: linear scan
+    const double x = batch.centerX(index);
+    const double y = batch.centerY(index);
+    for (int j = 0; j < batch.size(); ++j) {
+        if (j == index) {
+            continue;
+        }
+        const double dx = batch.centerX(j) - x;
+        const double dy = batch.centerY(j) - y;
+        if (dx * dx + dy * dy <= distanceSquared) {
+            neighbors.push_back(j);
+        }
+    }
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,99 @@
+#ifndef REGION_NEIGHBOR_GRAPH_H
+#define REGION_NEIGHBOR_GRAPH_H
+
+#include <QtCore/QList>
+#include <vector>
+#include "DetectedRegionBatch.h"
+
+namespace ocr_orc {
+
+/**
+ * @brief Spatial index over one detection result, shared by post-processing
+ *
+ * Built once per result from the region centers:
+ * - Radius neighbour lists (center distance <= radius), found through a
+ *   uniform grid with cells of the radius size, so building is near-linear
+ *   on dense forms instead of all-pairs
+ * - Row orders sorted by center X and center Y, used by alignment clustering
+ *
+ * SpatialClusterer and GroupInferencer read the sorted orders. Neighbour
+ * lists are kept in ascending row order so results match a linear scan
+ * over the list.
+ */
+class RegionNeighborGraph {
+public:
+    RegionNeighborGraph();
+    explicit RegionNeighborGraph(const QList<DetectedRegion>& regions, double radius = DEFAULT_RADIUS);
+    ~RegionNeighborGraph() = default;
+    
+    /**
+     * @brief Rebuild the graph for a region list (keeps capacity)
+     * @param regions Source regions
+     * @param radius Neighbour radius (normalized); 0 builds only the sorted orders
+     */
+    void build(const QList<DetectedRegion>& regions, double radius = DEFAULT_RADIUS);
+    
+    /**
+     * @brief Rebuild the graph for a batch (copied; keeps capacity)
+     */
+    void build(const DetectedRegionBatch& batch, double radius = DEFAULT_RADIUS);
+    
+    const DetectedRegionBatch& getBatch() const { return batch; }
+    int size() const { return batch.size(); }
+    double getRadius() const { return radius; }
+    
+    /**
+     * @brief Neighbours of a row within the build radius (ascending row order, self excluded)
+     */
+    const int* neighborsBegin(int index) const { return neighborIndices.data() + neighborOffsets[index]; }
+    const int* neighborsEnd(int index) const { return neighborIndices.data() + neighborOffsets[index + 1]; }
+    int neighborCount(int index) const { return neighborOffsets[index + 1] - neighborOffsets[index]; }
+    
+    /**
+     * @brief Collect neighbours within a distance (ascending row order, self excluded)
+     *
+     * Filters the stored list when distance <= build radius, otherwise scans
+     * all rows.
+     * @param index Row
+     * @param distance Center distance threshold (normalized)
+     * @param neighbors Output indices (cleared first)
+     */
+    void collectNeighbors(int index, double distance, std::vector<int>& neighbors) const;
+    
+    /**
+     * @brief All rows sorted by center X (stable)
+     */
+    const std::vector<int>& orderByCenterX() const { return xOrder; }
+    
+    /**
+     * @brief All rows sorted by center Y (stable)
+     */
+    const std::vector<int>& orderByCenterY() const { return yOrder; }
+    
+    static constexpr double DEFAULT_RADIUS = 0.1;  // Neighbour radius used by post-processing
+
+private:
+    void buildIndex();
+    
+    DetectedRegionBatch batch;
+    double radius;
+    
+    std::vector<int> xOrder;
+    std::vector<int> yOrder;
+    
+    // Neighbour lists, row i: neighborIndices[neighborOffsets[i] .. neighborOffsets[i + 1])
+    std::vector<int> neighborOffsets;
+    std::vector<int> neighborIndices;
+    std::vector<double> neighborDistancesSquared;
+    
+    // Uniform grid (bucketed by cell, flat)
+    std::vector<int> cellOffsets;
+    std::vector<int> cellRows;
+    std::vector<int> cellOfRow;
+    
+    static constexpr int MAX_GRID_CELLS_PER_AXIS = 1024;
+};
+
+} // namespace ocr_orc
+
+#endif // REGION_NEIGHBOR_GRAPH_H
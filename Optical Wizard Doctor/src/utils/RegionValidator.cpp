@@ -1,6 +1,7 @@
 #include "RegionValidator.h"
 #include "RegionDetector.h"
 #include "SpatialClusterer.h"
+#include <algorithm>
 #include <cmath>
 #if OCR_ORC_DEBUG_ENABLED
 #include <QtCore/QDebug>
@@ -22,68 +23,55 @@ void RegionValidator::setWeights(double spatialWeight, double sizeWeight, double
     this->alignmentWeight = alignmentWeight;
 }
 
-QList<DetectedRegion> RegionValidator::findNeighbors(const DetectedRegion& region,
-                                                      const QList<DetectedRegion>& allRegions,
-                                                      double distanceThreshold) {
-    QList<DetectedRegion> neighbors;
+void RegionValidator::findNeighbors(const DetectedRegionBatch& batch, int index,
+                                    double distanceThreshold, std::vector<int>& neighbors) {
+    neighbors.clear();
     
-    double centerX = (region.coords.x1 + region.coords.x2) / 2.0;
-    double centerY = (region.coords.y1 + region.coords.y2) / 2.0;
+    const double centerX = batch.centerX(index);
+    const double centerY = batch.centerY(index);
+    const double thresholdSquared = distanceThreshold * distanceThreshold;
     
-    for (const DetectedRegion& other : allRegions) {
+    for (int other = 0; other < batch.size(); ++other) {
         // Skip self
-        if (&other == &region) {
+        if (other == index) {
             continue;
         }
         
-        double otherCenterX = (other.coords.x1 + other.coords.x2) / 2.0;
-        double otherCenterY = (other.coords.y1 + other.coords.y2) / 2.0;
-        
-        double distance = std::sqrt(
-            std::pow(centerX - otherCenterX, 2) + 
-            std::pow(centerY - otherCenterY, 2)
-        );
-        
-        if (distance <= distanceThreshold) {
-            neighbors.append(other);
+        double dx = centerX - batch.centerX(other);
+        double dy = centerY - batch.centerY(other);
+        if (dx * dx + dy * dy <= thresholdSquared) {
+            neighbors.push_back(other);
         }
     }
-    
-    return neighbors;
 }
 
-double RegionValidator::validateSpatial(const DetectedRegion& region, 
-                                         const QList<DetectedRegion>& allRegions) {
-    QList<DetectedRegion> neighbors = findNeighbors(region, allRegions, 0.1);
-    
-    if (neighbors.isEmpty()) {
+double RegionValidator::validateSpatial(const std::vector<int>& neighbors) {
+    if (neighbors.empty()) {
         return 0.5; // Penalty: isolated region
     }
     
     return 1.0; // Has neighbors, good
 }
 
-double RegionValidator::validateSize(const DetectedRegion& region, 
-                                      const QList<DetectedRegion>& allRegions) {
-    QList<DetectedRegion> neighbors = findNeighbors(region, allRegions, 0.1);
-    
-    if (neighbors.isEmpty()) {
+double RegionValidator::validateSize(const DetectedRegionBatch& batch, int index,
+                                     const std::vector<int>& neighbors) {
+    if (neighbors.empty()) {
         return 0.7; // No neighbors to compare, moderate confidence
     }
     
     // Calculate average size of neighbors
     double avgWidth = 0.0;
     double avgHeight = 0.0;
-    for (const auto& neighbor : neighbors) {
-        avgWidth += (neighbor.coords.x2 - neighbor.coords.x1);
-        avgHeight += (neighbor.coords.y2 - neighbor.coords.y1);
+    for (int neighbor : neighbors) {
+        avgWidth += batch.width(neighbor);
+        avgHeight += batch.height(neighbor);
     }
     avgWidth /= neighbors.size();
     avgHeight /= neighbors.size();
     
     // Calculate size of current region
-    double regionWidth = region.coords.x2 - region.coords.x1;
-    double regionHeight = region.coords.y2 - region.coords.y1;
+    double regionWidth = batch.width(index);
+    double regionHeight = batch.height(index);
     
     // Check deviation
     double widthDev = std::abs(regionWidth - avgWidth) / avgWidth;
@@ -100,23 +88,22 @@ double RegionValidator::validateSize(const DetectedRegion& region,
     }
 }
 
-double RegionValidator::validateType(const DetectedRegion& region, 
-                                      const QList<DetectedRegion>& allRegions) {
-    if (region.inferredType == "unknown") {
+double RegionValidator::validateType(const DetectedRegionBatch& batch, int index,
+                                     const std::vector<int>& neighbors) {
+    const int type = batch.typeCode(index);
+    if (type == REGION_TYPE_UNKNOWN) {
         return 0.8; // Unknown type is acceptable
     }
     
-    QList<DetectedRegion> neighbors = findNeighbors(region, allRegions, 0.1);
-    
-    if (neighbors.isEmpty()) {
+    if (neighbors.empty()) {
         return 0.8; // No neighbors to compare
     }
     
     // Check type consistency with neighbors
     int matchingTypes = 0;
-    for (const auto& neighbor : neighbors) {
-        if (neighbor.inferredType == region.inferredType || 
-            neighbor.inferredType == "unknown") {
+    for (int neighbor : neighbors) {
+        int neighborType = batch.typeCode(neighbor);
+        if (neighborType == type || neighborType == REGION_TYPE_UNKNOWN) {
             matchingTypes++;
         }
     }
@@ -133,23 +120,20 @@ double RegionValidator::validateType(const DetectedRegion& region,
     }
 }
 
-double RegionValidator::validatePattern(const DetectedRegion& region, 
-                                        const QList<DetectedRegion>& allRegions) {
+double RegionValidator::validatePattern(const DetectedRegionBatch& batch, int index,
+                                        const std::vector<int>& nearNeighbors) {
     // If region has a suggested group, it likely fits a pattern
-    if (!region.suggestedGroup.isEmpty()) {
+    if (batch.hasSuggestedGroup(index)) {
         return 1.0; // Fits pattern
     }
     
     // Check if region is part of a detected sequence
-    QList<DetectedRegion> neighbors = findNeighbors(region, allRegions, 0.05);
-    
-    if (neighbors.size() >= 2) {
+    if (nearNeighbors.size() >= 2) {
         // Check if neighbors form a sequence (similar sizes, aligned)
         bool isSequence = true;
-        double firstY = (neighbors[0].coords.y1 + neighbors[0].coords.y2) / 2.0;
-        for (int i = 1; i < neighbors.size(); ++i) {
-            double y = (neighbors[i].coords.y1 + neighbors[i].coords.y2) / 2.0;
-            if (std::abs(y - firstY) > 0.02) {
+        double firstY = batch.centerY(nearNeighbors[0]);
+        for (size_t i = 1; i < nearNeighbors.size(); ++i) {
+            if (std::abs(batch.centerY(nearNeighbors[i]) - firstY) > 0.02) {
                 isSequence = false;
                 break;
             }
@@ -163,34 +147,61 @@ double RegionValidator::validatePattern(const DetectedRegion& region,
     return 0.6; // Doesn't clearly fit a pattern
 }
 
-double RegionValidator::validateAlignment(const DetectedRegion& region, 
+double RegionValidator::validateAlignment(const DetectedRegionBatch& batch, int index,
                                           const GridStructure& gridStructure) {
+    Q_UNUSED(batch);
+    Q_UNUSED(index);
+    
     if (gridStructure.rows == 0 || gridStructure.cols == 0) {
         return 1.0; // No grid to align with
     }
     
-    // Check if region aligns with grid cells
-    double regionCenterX = (region.coords.x1 + region.coords.x2) / 2.0;
-    double regionCenterY = (region.coords.y1 + region.coords.y2) / 2.0;
-    
-    // Simple check: see if region center is close to any grid cell center
-    // This is a simplified check - full implementation would check actual grid cell positions
-    double tolerance = 0.05; // 5% tolerance
-    
     // For now, if grid is detected, give moderate confidence
-    // Full implementation would check actual alignment
+    // Full implementation would check region centers against actual grid cell positions
     return 0.9; // Likely aligned with grid
 }
 
 double RegionValidator::validateRegion(const DetectedRegion& region,
                                        const QList<DetectedRegion>& allRegions,
                                        const GridStructure& gridStructure) {
+    // Locate the region in the list (self is skipped by index); a region from
+    // outside the list is appended so it is compared against every entry
+    scratchBatch.assign(allRegions);
+    int index = -1;
+    for (int i = 0; i < allRegions.size(); ++i) {
+        if (&allRegions[i] == &region) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        index = scratchBatch.append(region);
+    }
+    
+    return validateRegion(scratchBatch, index, gridStructure);
+}
+
+double RegionValidator::validateRegion(const DetectedRegionBatch& batch,
+                                       int index,
+                                       const GridStructure& gridStructure) {
+    if (index < 0 || index >= batch.size()) {
+        return 0.5;
+    }
+    
+    // Neighbor sets are computed once and shared by the layers that use them
+    findNeighbors(batch, index, 0.1, neighborScratch);
+    if (batch.hasSuggestedGroup(index)) {
+        nearNeighborScratch.clear();
+    } else {
+        findNeighbors(batch, index, 0.05, nearNeighborScratch);
+    }
+    
     // Perform all validation layers
-    double spatialScore = validateSpatial(region, allRegions);
-    double sizeScore = validateSize(region, allRegions);
-    double typeScore = validateType(region, allRegions);
-    double patternScore = validatePattern(region, allRegions);
-    double alignmentScore = validateAlignment(region, gridStructure);
+    double spatialScore = validateSpatial(neighborScratch);
+    double sizeScore = validateSize(batch, index, neighborScratch);
+    double typeScore = validateType(batch, index, neighborScratch);
+    double patternScore = validatePattern(batch, index, nearNeighborScratch);
+    double alignmentScore = validateAlignment(batch, index, gridStructure);
     
     // Weighted average
     double totalWeight = spatialWeight + sizeWeight + typeWeight + patternWeight + alignmentWeight;
@@ -2,8 +2,10 @@
 #define REGION_VALIDATOR_H
 
 #include <QtCore/QList>
+#include <vector>
 #include "RegionDetector.h"
 #include "SpatialClusterer.h"
+#include "DetectedRegionBatch.h"
 
 namespace ocr_orc {
 
@@ -16,6 +18,9 @@ namespace ocr_orc {
  * - Type: Consistent in context? (penalty if mismatches)
  * - Pattern: Fits detected pattern? (penalty if doesn't fit)
  * - Alignment: Aligned with grid? (penalty if misaligned)
+ * 
+ * Not reentrant: calls reuse member scratch buffers, so one instance must
+ * not be used from several threads at once (use one instance per thread).
  */
 class RegionValidator {
 public:
@@ -35,6 +40,19 @@ public:
         const GridStructure& gridStructure = GridStructure()
     );
     
+    /**
+     * @brief Validate one row of a batch (no region copies)
+     * @param batch Batch of all detected regions
+     * @param index Row to validate
+     * @param gridStructure Detected grid structure (if any)
+     * @return Combined confidence score (0.0-1.0)
+     */
+    double validateRegion(
+        const DetectedRegionBatch& batch,
+        int index,
+        const GridStructure& gridStructure = GridStructure()
+    );
+    
     /**
      * @brief Set validation weights (default: all 1.0)
      */
@@ -48,39 +66,42 @@ private:
     double patternWeight;
     double alignmentWeight;
     
-    SpatialClusterer clusterer;
+    // Scratch buffers reused across calls
+    DetectedRegionBatch scratchBatch;
+    std::vector<int> neighborScratch;      // Within 0.1 (spatial, size, type)
+    std::vector<int> nearNeighborScratch;  // Within 0.05 (pattern)
     
     /**
      * @brief Spatial validation: Check if region has neighbors
      */
-    double validateSpatial(const DetectedRegion& region, const QList<DetectedRegion>& allRegions);
+    double validateSpatial(const std::vector<int>& neighbors);
     
     /**
      * @brief Size validation: Check consistency with neighbors
      */
-    double validateSize(const DetectedRegion& region, const QList<DetectedRegion>& allRegions);
+    double validateSize(const DetectedRegionBatch& batch, int index, const std::vector<int>& neighbors);
     
     /**
      * @brief Type validation: Check type consistency in context
      */
-    double validateType(const DetectedRegion& region, const QList<DetectedRegion>& allRegions);
+    double validateType(const DetectedRegionBatch& batch, int index, const std::vector<int>& neighbors);
     
     /**
      * @brief Pattern validation: Check if region fits detected pattern
      */
-    double validatePattern(const DetectedRegion& region, const QList<DetectedRegion>& allRegions);
+    double validatePattern(const DetectedRegionBatch& batch, int index, const std::vector<int>& nearNeighbors);
     
     /**
      * @brief Alignment validation: Check alignment with grid
      */
-    double validateAlignment(const DetectedRegion& region, const GridStructure& gridStructure);
+    double validateAlignment(const DetectedRegionBatch& batch, int index, const GridStructure& gridStructure);
     
     /**
      * @brief Find neighbors within distance threshold
+     * @param neighbors Output: indices of other rows whose centers are within the threshold (cleared first)
      */
-    QList<DetectedRegion> findNeighbors(const DetectedRegion& region, 
-                                        const QList<DetectedRegion>& allRegions,
-                                        double distanceThreshold = 0.1);
+    void findNeighbors(const DetectedRegionBatch& batch, int index,
+                       double distanceThreshold, std::vector<int>& neighbors);
 };
 
 } // namespace ocr_orc
@@ -11,147 +11,145 @@ namespace ocr_orc {
 SpatialClusterer::SpatialClusterer() {
 }
 
-double SpatialClusterer::getCenterY(const DetectedRegion& region) {
-    return (region.coords.y1 + region.coords.y2) / 2.0;
-}
-
-double SpatialClusterer::getCenterX(const DetectedRegion& region) {
-    return (region.coords.x1 + region.coords.x2) / 2.0;
-}
-
-bool SpatialClusterer::isHorizontallyAligned(const DetectedRegion& r1, const DetectedRegion& r2, double tolerance) {
-    double y1 = getCenterY(r1);
-    double y2 = getCenterY(r2);
-    return std::abs(y1 - y2) <= tolerance;
-}
-
-bool SpatialClusterer::isVerticallyAligned(const DetectedRegion& r1, const DetectedRegion& r2, double tolerance) {
-    double x1 = getCenterX(r1);
-    double x2 = getCenterX(r2);
-    return std::abs(x1 - x2) <= tolerance;
-}
-
-void SpatialClusterer::sortByX(QList<DetectedRegion>& regions) {
-    std::sort(regions.begin(), regions.end(), 
-              [this](const DetectedRegion& a, const DetectedRegion& b) {
-                  return getCenterX(a) < getCenterX(b);
-              });
-}
-
-void SpatialClusterer::sortByY(QList<DetectedRegion>& regions) {
-    std::sort(regions.begin(), regions.end(), 
-              [this](const DetectedRegion& a, const DetectedRegion& b) {
-                  return getCenterY(a) < getCenterY(b);
-              });
-}
-
-QList<QList<DetectedRegion>> SpatialClusterer::clusterByHorizontalAlignment(
-    const QList<DetectedRegion>& regions,
-    double tolerance) {
-    
-    QList<QList<DetectedRegion>> clusters;
-    
-    // Make a copy to sort
-    QList<DetectedRegion> sortedRegions = regions;
-    sortByY(sortedRegions);
+void SpatialClusterer::clusterIndices(const RegionNeighborGraph& graph, double tolerance, bool horizontal,
+                                      RegionIndexClusters& clusters) {
+    clusters.clear();
+    const DetectedRegionBatch& batch = graph.getBatch();
+    const int count = batch.size();
+    if (count == 0) {
+        return;
+    }
     
-    for (const DetectedRegion& region : sortedRegions) {
-        bool addedToCluster = false;
-        
-        // Try to add to existing cluster
-        for (auto& cluster : clusters) {
-            if (!cluster.isEmpty()) {
-                // Check if aligned with first region in cluster
-                if (isHorizontallyAligned(region, cluster.first(), tolerance)) {
-                    cluster.append(region);
-                    addedToCluster = true;
-                    break;
-                }
+    // Visit rows in order of the primary center (Y for rows, X for columns)
+    const std::vector<int>& order = horizontal ? graph.orderByCenterY() : graph.orderByCenterX();
+    
+    // Assign each row to the first cluster whose first member is aligned with it.
+    // Anchor centers ascend, so the first aligned anchor is the first one at or
+    // above center - tolerance; the neighbours of that position are re-checked
+    // with the exact comparison to stay identical to a linear scan.
+    clusterOf.resize(count);
+    anchors.clear();
+    anchorCenters.clear();
+    for (int index : order) {
+        double center = horizontal ? batch.centerY(index) : batch.centerX(index);
+        int cluster = -1;
+        int first = static_cast<int>(std::lower_bound(anchorCenters.begin(), anchorCenters.end(),
+                                                      center - tolerance) - anchorCenters.begin());
+        for (int c = std::max(0, first - 1); c < static_cast<int>(anchorCenters.size()); ++c) {
+            if (std::abs(center - anchorCenters[c]) <= tolerance) {
+                cluster = c;
+                break;
+            }
+            if (anchorCenters[c] > center) {
+                break;
             }
         }
-        
-        // Create new cluster if not added
-        if (!addedToCluster) {
-            clusters.append({region});
+        if (cluster < 0) {
+            cluster = static_cast<int>(anchors.size());
+            anchors.push_back(index);
+            anchorCenters.push_back(center);
         }
+        clusterOf[index] = cluster;
+    }
+    
+    // Counting sort into the flat buffer, keeping visit order within each cluster
+    const int clusterCount = static_cast<int>(anchors.size());
+    clusters.offsets.assign(clusterCount + 1, 0);
+    for (int i = 0; i < count; ++i) {
+        clusters.offsets[clusterOf[i] + 1]++;
+    }
+    for (int c = 0; c < clusterCount; ++c) {
+        clusters.offsets[c + 1] += clusters.offsets[c];
+    }
+    clusters.indices.resize(count);
+    anchors.assign(clusters.offsets.begin(), clusters.offsets.end() - 1);  // Reused as fill cursors
+    for (int index : order) {
+        clusters.indices[anchors[clusterOf[index]]++] = index;
     }
     
-    // Sort each cluster by X-coordinate
-    for (auto& cluster : clusters) {
-        sortByX(cluster);
+    // Sort each cluster by the secondary center
+    for (int c = 0; c < clusterCount; ++c) {
+        int* begin = clusters.indices.data() + clusters.offsets[c];
+        int* end = clusters.indices.data() + clusters.offsets[c + 1];
+        if (horizontal) {
+            batch.sortIndicesByCenterX(begin, end);
+        } else {
+            batch.sortIndicesByCenterY(begin, end);
+        }
     }
+}
+
+void SpatialClusterer::clusterIndicesByHorizontalAlignment(const RegionNeighborGraph& graph,
+                                                           double tolerance,
+                                                           RegionIndexClusters& clusters) {
+    clusterIndices(graph, tolerance, true, clusters);
     
     #if OCR_ORC_DEBUG_ENABLED
     qDebug() << "[SpatialClusterer] Horizontal alignment: Found" 
-             << clusters.size() << "rows from" << regions.size() << "regions";
+             << clusters.clusterCount() << "rows from" << graph.size() << "regions";
     #endif
-    
-    return clusters;
 }
 
-QList<QList<DetectedRegion>> SpatialClusterer::clusterByVerticalAlignment(
-    const QList<DetectedRegion>& regions,
-    double tolerance) {
-    
-    QList<QList<DetectedRegion>> clusters;
-    
-    // Make a copy to sort
-    QList<DetectedRegion> sortedRegions = regions;
-    sortByX(sortedRegions);
-    
-    for (const DetectedRegion& region : sortedRegions) {
-        bool addedToCluster = false;
-        
-        // Try to add to existing cluster
-        for (auto& cluster : clusters) {
-            if (!cluster.isEmpty()) {
-                // Check if aligned with first region in cluster
-                if (isVerticallyAligned(region, cluster.first(), tolerance)) {
-                    cluster.append(region);
-                    addedToCluster = true;
-                    break;
-                }
-            }
-        }
-        
-        // Create new cluster if not added
-        if (!addedToCluster) {
-            clusters.append({region});
-        }
-    }
-    
-    // Sort each cluster by Y-coordinate
-    for (auto& cluster : clusters) {
-        sortByY(cluster);
-    }
+void SpatialClusterer::clusterIndicesByVerticalAlignment(const RegionNeighborGraph& graph,
+                                                         double tolerance,
+                                                         RegionIndexClusters& clusters) {
+    clusterIndices(graph, tolerance, false, clusters);
     
     #if OCR_ORC_DEBUG_ENABLED
     qDebug() << "[SpatialClusterer] Vertical alignment: Found" 
-             << clusters.size() << "columns from" << regions.size() << "regions";
+             << clusters.clusterCount() << "columns from" << graph.size() << "regions";
     #endif
+}
+
+QList<QList<DetectedRegion>> SpatialClusterer::clusterByHorizontalAlignment(
+    const QList<DetectedRegion>& regions,
+    double tolerance) {
     
-    return clusters;
+    scratchGraph.build(regions, 0.0);
+    clusterIndicesByHorizontalAlignment(scratchGraph, tolerance, scratchClusters);
+    return DetectedRegionBatch::materialize(regions, scratchClusters);
+}
+
+QList<QList<DetectedRegion>> SpatialClusterer::clusterByVerticalAlignment(
+    const QList<DetectedRegion>& regions,
+    double tolerance) {
+    
+    scratchGraph.build(regions, 0.0);
+    clusterIndicesByVerticalAlignment(scratchGraph, tolerance, scratchClusters);
+    return DetectedRegionBatch::materialize(regions, scratchClusters);
 }
 
 struct GridStructure SpatialClusterer::detectGridStructure(const QList<DetectedRegion>& regions) {
+    scratchGraph.build(regions, 0.0);
+    return detectGridStructure(scratchGraph, regions);
+}
+
+struct GridStructure SpatialClusterer::detectGridStructure(const RegionNeighborGraph& graph,
+                                                          const QList<DetectedRegion>& regions) {
     GridStructure grid;
+    const DetectedRegionBatch& batch = graph.getBatch();
     
-    if (regions.isEmpty()) {
+    if (batch.isEmpty()) {
         return grid;
     }
+    // Graph rows index straight into regions
+    Q_ASSERT_X(batch.size() == regions.size(), "SpatialClusterer::detectGridStructure",
+               "graph was not built from regions");
     
     // Cluster by horizontal alignment (rows)
-    QList<QList<DetectedRegion>> rows = clusterByHorizontalAlignment(regions, 0.01);
+    RegionIndexClusters& rows = scratchClusters;
+    clusterIndicesByHorizontalAlignment(graph, 0.01, rows);
+    const int rowCount = rows.clusterCount();
     
-    if (rows.isEmpty()) {
+    if (rowCount == 0) {
         return grid;
     }
     
     // Filter rows with similar number of cells (likely grid rows)
     // Find most common row size
     QMap<int, int> rowSizeCounts;
-    for (const auto& row : rows) {
-        rowSizeCounts[row.size()]++;
+    for (int r = 0; r < rowCount; ++r) {
+        rowSizeCounts[rows.clusterSize(r)]++;
     }
     
     int mostCommonSize = 0;
@@ -163,46 +161,45 @@ struct GridStructure SpatialClusterer::detectGridStructure(const QList<DetectedR
         }
     }
     
-    // Filter rows that match the most common size (within 1 cell tolerance)
-    QList<QList<DetectedRegion>> gridRows;
-    for (const auto& row : rows) {
-        if (std::abs((int)row.size() - mostCommonSize) <= 1) {
-            gridRows.append(row);
+    // Keep rows that match the most common size (within 1 cell tolerance)
+    // and accumulate cell dimensions from the batch columns
+    int gridRowCount = 0;
+    double totalWidth = 0.0;
+    double totalHeight = 0.0;
+    int count = 0;
+    for (int r = 0; r < rowCount; ++r) {
+        if (std::abs(rows.clusterSize(r) - mostCommonSize) > 1) {
+            continue;
+        }
+        gridRowCount++;
+        
+        QList<DetectedRegion> row;
+        row.reserve(rows.clusterSize(r));
+        for (const int* it = rows.clusterBegin(r); it != rows.clusterEnd(r); ++it) {
+            totalWidth += batch.width(*it);
+            totalHeight += batch.height(*it);
+            count++;
+            row.append(regions[*it]);
         }
+        grid.gridCells.append(row);
     }
     
-    if (gridRows.isEmpty()) {
+    if (gridRowCount == 0) {
         return grid;
     }
     
-    grid.rows = gridRows.size();
+    grid.rows = gridRowCount;
     grid.cols = mostCommonSize;
     
-    // Calculate average cell dimensions
-    double totalWidth = 0.0;
-    double totalHeight = 0.0;
-    int count = 0;
-    
-    for (const auto& row : gridRows) {
-        for (const auto& region : row) {
-            totalWidth += (region.coords.x2 - region.coords.x1);
-            totalHeight += (region.coords.y2 - region.coords.y1);
-            count++;
-        }
-    }
-    
     if (count > 0) {
         grid.cellWidth = totalWidth / count;
         grid.cellHeight = totalHeight / count;
     }
     
-    // Build grid structure
-    grid.gridCells = gridRows;
-    
     // Calculate confidence based on grid regularity
     // More rows with consistent size = higher confidence
-    double regularityScore = (double)gridRows.size() / rows.size();
-    double sizeConsistencyScore = (double)maxCount / rows.size();
+    double regularityScore = (double)gridRowCount / rowCount;
+    double sizeConsistencyScore = (double)maxCount / rowCount;
     grid.confidence = (regularityScore + sizeConsistencyScore) / 2.0;
     
     #if OCR_ORC_DEBUG_ENABLED
@@ -223,40 +220,41 @@ QList<QList<DetectedRegion>> SpatialClusterer::detectSequentialPattern(
         return sequences;
     }
     
-    // Cluster by horizontal alignment first (rows)
-    QList<QList<DetectedRegion>> rows = clusterByHorizontalAlignment(regions, 0.01);
+    // Cluster by horizontal alignment first (rows, already sorted by center X)
+    scratchGraph.build(regions, 0.0);
+    clusterIndicesByHorizontalAlignment(scratchGraph, 0.01, scratchClusters);
+    const DetectedRegionBatch& batch = scratchGraph.getBatch();
     
-    for (auto& row : rows) {
-        if (row.size() < 2) {
+    for (int r = 0; r < scratchClusters.clusterCount(); ++r) {
+        if (scratchClusters.clusterSize(r) < 2) {
             continue; // Need at least 2 regions for a sequence
         }
         
-        sortByX(row);
+        const int* row = scratchClusters.clusterBegin(r);
+        const int rowSize = scratchClusters.clusterSize(r);
         
         // Check if regions form a sequence (gaps are within maxGap)
-        QList<DetectedRegion> sequence;
-        sequence.append(row[0]);
-        
-        for (int i = 1; i < row.size(); ++i) {
-            double gap = getCenterX(row[i]) - getCenterX(row[i-1]) - 
-                        (row[i-1].coords.x2 - row[i-1].coords.x1) / 2.0 -
-                        (row[i].coords.x2 - row[i].coords.x1) / 2.0;
+        int sequenceStart = 0;
+        for (int i = 1; i <= rowSize; ++i) {
+            if (i < rowSize) {
+                double gap = batch.centerX(row[i]) - batch.centerX(row[i-1]) - 
+                            batch.width(row[i-1]) / 2.0 -
+                            batch.width(row[i]) / 2.0;
+                if (gap <= maxGap) {
+                    continue;
+                }
+            }
             
-            if (gap <= maxGap) {
-                sequence.append(row[i]);
-            } else {
-                // Gap too large, start new sequence
-                if (sequence.size() >= 2) {
-                    sequences.append(sequence);
+            // Gap too large (or end of row): emit the run if long enough
+            if (i - sequenceStart >= 2) {
+                QList<DetectedRegion> sequence;
+                sequence.reserve(i - sequenceStart);
+                for (int k = sequenceStart; k < i; ++k) {
+                    sequence.append(regions[row[k]]);
                 }
-                sequence.clear();
-                sequence.append(row[i]);
+                sequences.append(sequence);
             }
-        }
-        
-        // Add final sequence
-        if (sequence.size() >= 2) {
-            sequences.append(sequence);
+            sequenceStart = i;
         }
     }
     
@@ -3,6 +3,9 @@
 
 #include <QtCore/QList>
 #include <QtCore/QString>
+#include <vector>
+#include "DetectedRegionBatch.h"
+#include "RegionNeighborGraph.h"
 
 namespace ocr_orc {
 
@@ -18,6 +21,9 @@ struct GridStructure;
  * - Vertical alignment (same X-range)
  * - Grid structures
  * - Sequential patterns
+ * 
+ * Not reentrant: calls reuse member scratch buffers, so one instance must
+ * not be used from several threads at once (use one instance per thread).
  */
 class SpatialClusterer {
 public:
@@ -46,6 +52,26 @@ public:
         double tolerance = 0.01
     );
     
+    /**
+     * @brief Group graph rows by horizontal alignment (index view, no region copies)
+     * @param graph Neighbour graph of the regions (its sorted orders are reused)
+     * @param tolerance Tolerance for Y-coordinate matching (normalized)
+     * @param clusters Output: one cluster per row, each sorted by center X (cleared first)
+     */
+    void clusterIndicesByHorizontalAlignment(const RegionNeighborGraph& graph,
+                                             double tolerance,
+                                             RegionIndexClusters& clusters);
+    
+    /**
+     * @brief Group graph rows by vertical alignment (index view, no region copies)
+     * @param graph Neighbour graph of the regions (its sorted orders are reused)
+     * @param tolerance Tolerance for X-coordinate matching (normalized)
+     * @param clusters Output: one cluster per column, each sorted by center Y (cleared first)
+     */
+    void clusterIndicesByVerticalAlignment(const RegionNeighborGraph& graph,
+                                           double tolerance,
+                                           RegionIndexClusters& clusters);
+    
     /**
      * @brief Detect grid structure from regions
      * @param regions List of detected regions
@@ -53,6 +79,15 @@ public:
      */
     struct GridStructure detectGridStructure(const QList<DetectedRegion>& regions);
     
+    /**
+     * @brief Detect grid structure from a prebuilt neighbour graph
+     * @param graph Graph built from regions
+     * @param regions Regions the graph was built from, in the same order (only used to fill GridStructure::gridCells)
+     * @return GridStructure with detected grid information
+     */
+    struct GridStructure detectGridStructure(const RegionNeighborGraph& graph,
+                                             const QList<DetectedRegion>& regions);
+    
     /**
      * @brief Detect sequential pattern (cells in a row/column)
      * @param regions List of detected regions
@@ -66,34 +101,22 @@ public:
     
 private:
     /**
-     * @brief Calculate average Y-coordinate of a region
+     * @brief Greedy alignment clustering shared by both directions
+     * 
+     * Visits rows in order of the primary center, adds each to the first
+     * cluster whose first member is within tolerance, then sorts every
+     * cluster by the secondary center. Anchors are created in ascending
+     * primary-center order, so the first match is found by binary search.
      */
-    double getCenterY(const DetectedRegion& region);
+    void clusterIndices(const RegionNeighborGraph& graph, double tolerance, bool horizontal,
+                        RegionIndexClusters& clusters);
     
-    /**
-     * @brief Calculate average X-coordinate of a region
-     */
-    double getCenterX(const DetectedRegion& region);
-    
-    /**
-     * @brief Check if two regions are horizontally aligned (within tolerance)
-     */
-    bool isHorizontallyAligned(const DetectedRegion& r1, const DetectedRegion& r2, double tolerance);
-    
-    /**
-     * @brief Check if two regions are vertically aligned (within tolerance)
-     */
-    bool isVerticallyAligned(const DetectedRegion& r1, const DetectedRegion& r2, double tolerance);
-    
-    /**
-     * @brief Sort regions by X-coordinate
-     */
-    void sortByX(QList<DetectedRegion>& regions);
-    
-    /**
-     * @brief Sort regions by Y-coordinate
-     */
-    void sortByY(QList<DetectedRegion>& regions);
+    // Scratch buffers reused across calls
+    RegionNeighborGraph scratchGraph;  // Sorted orders only (radius 0)
+    RegionIndexClusters scratchClusters;
+    std::vector<int> clusterOf;
+    std::vector<int> anchors;
+    std::vector<double> anchorCenters;
 };
 
 } // namespace ocr_orc
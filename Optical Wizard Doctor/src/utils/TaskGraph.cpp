@@ -0,0 +1,265 @@
+#include "TaskGraph.h"
+#include "TraceRecorder.h"
+#include <QtCore/QThread>
+#include <algorithm>
+#include <cstdio>
+
+namespace ocr_orc {
+
+TaskGraph::TaskGraph(int requestedWorkers)
+    : workerCount(requestedWorkers > 0 ? requestedWorkers : std::max(1, QThread::idealThreadCount()))
+    , started(false)
+    , readyCount(0)
+    , remainingTasks(0)
+    , cancelled(false)
+    , stealCount(0)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+    cancel();
+    joinWorkers();
+}
+
+int TaskGraph::addTask(const QString& name, std::function<void()> work, const QList<int>& dependencies)
+{
+    if (started) {
+        fprintf(stderr, "[TaskGraph] Cannot add task '%s' after start()\n", qPrintable(name));
+        fflush(stderr);
+        return -1;
+    }
+    
+    const int taskId = static_cast<int>(tasks.size());
+    for (int dependency : dependencies) {
+        if (dependency < 0 || dependency >= taskId) {
+            fprintf(stderr, "[TaskGraph] Task '%s' has unknown dependency %d\n", qPrintable(name), dependency);
+            fflush(stderr);
+            return -1;
+        }
+    }
+    
+    auto task = std::make_unique<Task>();
+    task->name = name;
+    task->work = std::move(work);
+    for (int dependency : dependencies) {
+        // Duplicate ids count once
+        std::vector<int>& successors = tasks[dependency]->successors;
+        if (std::find(successors.begin(), successors.end(), taskId) == successors.end()) {
+            successors.push_back(taskId);
+            task->dependencyCount++;
+        }
+    }
+    task->pendingDependencies.store(task->dependencyCount);
+    tasks.push_back(std::move(task));
+    return taskId;
+}
+
+void TaskGraph::start()
+{
+    if (started) {
+        return;
+    }
+    started = true;
+    
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        remainingTasks = static_cast<int>(tasks.size());
+    }
+    if (tasks.empty()) {
+        return;
+    }
+    
+    // No point in more workers than tasks
+    workerCount = std::min(workerCount, static_cast<int>(tasks.size()));
+    for (int w = 0; w < workerCount; ++w) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    
+    // Spread the roots over the workers before any of them runs
+    int nextWorker = 0;
+    for (int t = 0; t < static_cast<int>(tasks.size()); ++t) {
+        if (tasks[t]->dependencyCount == 0) {
+            queues[nextWorker]->tasks.push_back(t);
+            readyCount++;
+            nextWorker = (nextWorker + 1) % workerCount;
+        }
+    }
+    
+    workers.reserve(workerCount);
+    for (int w = 0; w < workerCount; ++w) {
+        workers.emplace_back(&TaskGraph::workerLoop, this, w);
+    }
+}
+
+void TaskGraph::wait(int taskId)
+{
+    if (taskId < 0 || taskId >= static_cast<int>(tasks.size())) {
+        return;
+    }
+    start();
+    
+    std::unique_lock<std::mutex> lock(stateMutex);
+    taskFinished.wait(lock, [&]() { return tasks[taskId]->finished; });
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void TaskGraph::waitAll()
+{
+    start();
+    joinWorkers();
+    
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void TaskGraph::cancel()
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    cancelled = true;
+}
+
+bool TaskGraph::isCancelled() const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return cancelled;
+}
+
+bool TaskGraph::isFinished(int taskId) const
+{
+    if (taskId < 0 || taskId >= static_cast<int>(tasks.size())) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return tasks[taskId]->finished;
+}
+
+bool TaskGraph::wasSkipped(int taskId) const
+{
+    if (taskId < 0 || taskId >= static_cast<int>(tasks.size())) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return tasks[taskId]->skipped;
+}
+
+void TaskGraph::workerLoop(int worker)
+{
+    if (TraceRecorder::isEnabled()) {
+        TraceRecorder::instance().setCurrentThreadName(QString("TaskGraph worker %1").arg(worker));
+    }
+    
+    for (;;) {
+        int taskId = -1;
+        if (takeTask(worker, taskId)) {
+            runTask(worker, taskId);
+            continue;
+        }
+    
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [&]() { return readyCount > 0 || remainingTasks == 0; });
+        if (remainingTasks == 0) {
+            return;
+        }
+    }
+}
+
+bool TaskGraph::takeTask(int worker, int& taskId)
+{
+    // Own deque first, newest task
+    {
+        WorkerQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            taskId = own.tasks.back();
+            own.tasks.pop_back();
+        }
+    }
+    
+    // Then steal the oldest task of another worker
+    for (int offset = 1; taskId < 0 && offset < workerCount; ++offset) {
+        WorkerQueue& victim = *queues[(worker + offset) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            taskId = victim.tasks.front();
+            victim.tasks.pop_front();
+            stealCount++;
+        }
+    }
+    
+    if (taskId < 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    readyCount--;
+    return true;
+}
+
+void TaskGraph::runTask(int worker, int taskId)
+{
+    Task& task = *tasks[taskId];
+    
+    bool skip = false;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        skip = cancelled;
+    }
+    
+    if (!skip) {
+        try {
+            task.work();
+        } catch (...) {
+            fprintf(stderr, "[TaskGraph] Task '%s' failed, skipping pending tasks\n", qPrintable(task.name));
+            fflush(stderr);
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+            cancelled = true;
+        }
+    }
+    
+    // Release successors; the last dependency to finish makes a task ready on this worker
+    for (int successor : task.successors) {
+        if (tasks[successor]->pendingDependencies.fetch_sub(1) == 1) {
+            pushReady(worker, successor);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(stateMutex);
+    task.finished = true;
+    task.skipped = skip;
+    remainingTasks--;
+    taskFinished.notify_all();
+    if (remainingTasks == 0) {
+        workAvailable.notify_all();
+    }
+}
+
+void TaskGraph::pushReady(int worker, int taskId)
+{
+    {
+        WorkerQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.tasks.push_back(taskId);
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    readyCount++;
+    workAvailable.notify_one();
+}
+
+void TaskGraph::joinWorkers()
+{
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+} // namespace ocr_orc
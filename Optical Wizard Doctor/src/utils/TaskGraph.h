@@ -0,0 +1,148 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ocr_orc {
+
+/**
+ * @brief Dependency graph of tasks run by a work-stealing executor
+ *
+ * Tasks are added with the ids of the tasks whose results they read;
+ * dependencies must already exist, so the graph is acyclic by construction.
+ * start() launches the workers. Each worker owns a deque: it pops its own
+ * newest task (tasks made ready by its last task stay warm on that core) and
+ * steals the oldest task from another worker when its deque is empty. A task
+ * starts as soon as its last dependency finishes.
+ *
+ * The thread that builds the graph is not a worker. It can wait() for the
+ * tasks whose results it needs next and keep working while the rest of the
+ * graph runs.
+ *
+ * If a task throws, tasks that have not started are skipped and the first
+ * exception is rethrown from wait() and waitAll(). The destructor cancels
+ * pending tasks and joins the workers, so tasks may capture locals declared
+ * before the graph.
+ */
+class TaskGraph {
+public:
+    /**
+     * @brief Constructor
+     * @param requestedWorkers Number of worker threads (0 = QThread::idealThreadCount())
+     */
+    explicit TaskGraph(int requestedWorkers = 0);
+    ~TaskGraph();
+    
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+    
+    /**
+     * @brief Add a task (only before start())
+     * @param name Task name (for logs)
+     * @param work Work to run on a worker thread
+     * @param dependencies Ids of tasks that must finish first
+     * @return Task id, or -1 if the graph was already started or a dependency is unknown
+     */
+    int addTask(const QString& name, std::function<void()> work, const QList<int>& dependencies = QList<int>());
+    
+    /**
+     * @brief Start running the graph (no-op if already started)
+     */
+    void start();
+    
+    /**
+     * @brief Block until a task has finished (or was skipped)
+     *
+     * Rethrows the first exception thrown by any task.
+     */
+    void wait(int taskId);
+    
+    /**
+     * @brief Block until every task has finished and the workers have exited
+     *
+     * Rethrows the first exception thrown by any task.
+     */
+    void waitAll();
+    
+    /**
+     * @brief Skip all tasks that have not started yet
+     *
+     * Running tasks are not interrupted; long ones can poll isCancelled()
+     * and return early so the destructor does not wait for them.
+     */
+    void cancel();
+    
+    /**
+     * @brief Check whether cancel() was called
+     */
+    bool isCancelled() const;
+    
+    /**
+     * @brief Check whether a task has finished (or was skipped)
+     */
+    bool isFinished(int taskId) const;
+    
+    /**
+     * @brief Check whether a task was skipped after cancel() or a failure
+     */
+    bool wasSkipped(int taskId) const;
+    
+    int getWorkerCount() const { return workerCount; }
+    int getTaskCount() const { return static_cast<int>(tasks.size()); }
+    
+    /**
+     * @brief Number of tasks a worker took from another worker's deque
+     */
+    int getStealCount() const { return stealCount.load(); }
+
+private:
+    struct Task {
+        QString name;
+        std::function<void()> work;
+        std::vector<int> successors;
+        int dependencyCount = 0;
+        std::atomic<int> pendingDependencies{0};
+        bool finished = false;  // Guarded by stateMutex
+        bool skipped = false;   // Guarded by stateMutex
+    };
+    
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+    
+    int workerCount;
+    bool started;
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    
+    mutable std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable taskFinished;
+    int readyCount;      // Tasks sitting in deques (guarded by stateMutex)
+    int remainingTasks;  // Tasks not yet finished (guarded by stateMutex)
+    bool cancelled;      // Guarded by stateMutex
+    std::exception_ptr failure;  // First task exception (guarded by stateMutex)
+    std::atomic<int> stealCount;
+    
+    void workerLoop(int worker);
+    bool takeTask(int worker, int& taskId);
+    void runTask(int worker, int taskId);
+    void pushReady(int worker, int taskId);
+    void joinWorkers();
+};
+
+} // namespace ocr_orc
+
+#endif // TASK_GRAPH_H
@@ -0,0 +1,280 @@
+#include "TemplateLibrary.h"
+#include "TraceRecorder.h"
+#include <opencv2/imgproc.hpp>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+namespace ocr_orc {
+
+namespace {
+
+constexpr int LIBRARY_FORMAT_VERSION = 1;
+
+} // namespace
+
+int TemplateFingerprint::distance(const TemplateFingerprint& a, const TemplateFingerprint& b)
+{
+    int bitsDifferent = 0;
+    for (int w = 0; w < WORD_COUNT; ++w) {
+        bitsDifferent += std::popcount(a.bits[w] ^ b.bits[w]);
+    }
+    return bitsDifferent;
+}
+
+QString TemplateFingerprint::toHex() const
+{
+    QString hex;
+    hex.reserve(BIT_COUNT / 4);
+    for (quint64 word : bits) {
+        hex += QString::number(word, 16).rightJustified(16, QLatin1Char('0'));
+    }
+    return hex;
+}
+
+TemplateFingerprint TemplateFingerprint::fromHex(const QString& hex)
+{
+    TemplateFingerprint fingerprint;
+    if (hex.size() != BIT_COUNT / 4) {
+        return fingerprint;
+    }
+    for (int w = 0; w < WORD_COUNT; ++w) {
+        bool ok = false;
+        fingerprint.bits[w] = hex.mid(w * 16, 16).toULongLong(&ok, 16);
+        if (!ok) {
+            return TemplateFingerprint();
+        }
+    }
+    fingerprint.valid = true;
+    return fingerprint;
+}
+
+TemplateLibrary::TemplateLibrary()
+    : matchThreshold(0.85)
+{
+}
+
+TemplateFingerprint TemplateLibrary::computeFingerprint(const cv::Mat& page)
+{
+    TemplateFingerprint fingerprint;
+    if (page.empty()) {
+        return fingerprint;
+    }
+    
+    cv::Mat gray;
+    if (page.channels() == 1) {
+        gray = page;
+    } else {
+        cv::cvtColor(page, gray, page.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    }
+    double scale = std::min(1.0, static_cast<double>(WORK_LONG_SIDE) / std::max(gray.cols, gray.rows));
+    cv::Mat work;
+    if (scale < 1.0) {
+        cv::resize(gray, work, cv::Size(), scale, scale, cv::INTER_AREA);
+    } else {
+        work = gray;
+    }
+    
+    // Ink mask, then keep only long horizontal and vertical runs (ruled lines)
+    cv::Mat ink;
+    cv::adaptiveThreshold(work, ink, 255, cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY_INV, 15, 10);
+    cv::Mat horizontal;
+    cv::Mat vertical;
+    cv::morphologyEx(ink, horizontal, cv::MORPH_OPEN,
+                     cv::getStructuringElement(cv::MORPH_RECT,
+                                               cv::Size(std::max(3, work.cols / LINE_KERNEL_FRACTION), 1)));
+    cv::morphologyEx(ink, vertical, cv::MORPH_OPEN,
+                     cv::getStructuringElement(cv::MORPH_RECT,
+                                               cv::Size(1, std::max(3, work.rows / LINE_KERNEL_FRACTION))));
+    cv::Mat lines = horizontal | vertical;
+    if (cv::countNonZero(lines) == 0) {
+        return fingerprint;  // Blank page or free text only
+    }
+    
+    // Thicken so a scan shifted by a few pixels covers the same cells
+    cv::dilate(lines, lines, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(5, 5)));
+    
+    cv::Mat grid;
+    cv::resize(lines, grid, cv::Size(TemplateFingerprint::GRID_SIZE, TemplateFingerprint::GRID_SIZE), 0, 0,
+               cv::INTER_AREA);
+    const double mean = cv::mean(grid)[0];
+    
+    for (int y = 0; y < grid.rows; ++y) {
+        const uchar* row = grid.ptr<uchar>(y);
+        for (int x = 0; x < grid.cols; ++x) {
+            if (row[x] > mean) {
+                const int bit = y * TemplateFingerprint::GRID_SIZE + x;
+                fingerprint.bits[bit / 64] |= (quint64(1) << (bit % 64));
+            }
+        }
+    }
+    fingerprint.valid = true;
+    return fingerprint;
+}
+
+bool TemplateLibrary::addTemplate(const QString& templateId, const cv::Mat& page)
+{
+    TemplateFingerprint fingerprint = computeFingerprint(page);
+    if (!fingerprint.valid) {
+        fprintf(stderr, "[TemplateLibrary] No ruled structure in template '%s'\n", qPrintable(templateId));
+        fflush(stderr);
+        return false;
+    }
+    return addTemplate(templateId, fingerprint);
+}
+
+bool TemplateLibrary::addTemplate(const QString& templateId, const TemplateFingerprint& fingerprint)
+{
+    if (!fingerprint.valid || templateId.isEmpty()) {
+        return false;
+    }
+    
+    int index = templateIds.indexOf(templateId);
+    if (index < 0) {
+        index = static_cast<int>(templateIds.size());
+        templateIds.append(templateId);
+        packedBits.resize(packedBits.size() + TemplateFingerprint::WORD_COUNT);
+    }
+    std::copy(fingerprint.bits.begin(), fingerprint.bits.end(),
+              packedBits.begin() + static_cast<size_t>(index) * TemplateFingerprint::WORD_COUNT);
+    return true;
+}
+
+bool TemplateLibrary::removeTemplate(const QString& templateId)
+{
+    int index = templateIds.indexOf(templateId);
+    if (index < 0) {
+        return false;
+    }
+    
+    // Move the last entry into the gap
+    const int last = static_cast<int>(templateIds.size()) - 1;
+    if (index != last) {
+        templateIds[index] = templateIds[last];
+        std::copy(packedBits.begin() + static_cast<size_t>(last) * TemplateFingerprint::WORD_COUNT,
+                  packedBits.end(),
+                  packedBits.begin() + static_cast<size_t>(index) * TemplateFingerprint::WORD_COUNT);
+    }
+    templateIds.removeLast();
+    packedBits.resize(packedBits.size() - TemplateFingerprint::WORD_COUNT);
+    return true;
+}
+
+void TemplateLibrary::clear()
+{
+    templateIds.clear();
+    packedBits.clear();
+}
+
+QList<TemplateMatch> TemplateLibrary::findNearest(const TemplateFingerprint& fingerprint, int count) const
+{
+    QList<TemplateMatch> matches;
+    if (!fingerprint.valid || count <= 0 || templateIds.isEmpty()) {
+        return matches;
+    }
+    
+    // Linear popcount scan over the packed fingerprints
+    const int templateCount = size();
+    std::vector<std::pair<int, int>> scored(static_cast<size_t>(templateCount));  // (distance, index)
+    const quint64* entry = packedBits.data();
+    for (int t = 0; t < templateCount; ++t, entry += TemplateFingerprint::WORD_COUNT) {
+        int bitsDifferent = 0;
+        for (int w = 0; w < TemplateFingerprint::WORD_COUNT; ++w) {
+            bitsDifferent += std::popcount(entry[w] ^ fingerprint.bits[w]);
+        }
+        scored[t] = std::make_pair(bitsDifferent, t);
+    }
+    
+    const int resultCount = std::min(count, templateCount);
+    std::partial_sort(scored.begin(), scored.begin() + resultCount, scored.end());
+    
+    matches.reserve(resultCount);
+    for (int i = 0; i < resultCount; ++i) {
+        TemplateMatch match;
+        match.templateId = templateIds[scored[i].second];
+        match.distance = scored[i].first;
+        match.similarity = 1.0 - static_cast<double>(match.distance) / TemplateFingerprint::BIT_COUNT;
+        matches.append(match);
+    }
+    return matches;
+}
+
+TemplateMatch TemplateLibrary::identify(const cv::Mat& page) const
+{
+    TraceSpan span("TemplateLibrary::identify", "registration");
+    span.setArg("templates", size());
+    
+    QList<TemplateMatch> nearest = findNearest(computeFingerprint(page), 1);
+    if (nearest.isEmpty() || nearest.first().similarity < matchThreshold) {
+        return TemplateMatch();
+    }
+    span.setArg("similarity", nearest.first().similarity);
+    return nearest.first();
+}
+
+bool TemplateLibrary::save(const QString& filePath) const
+{
+    QJsonArray templates;
+    for (int t = 0; t < size(); ++t) {
+        TemplateFingerprint fingerprint;
+        std::copy(packedBits.begin() + static_cast<size_t>(t) * TemplateFingerprint::WORD_COUNT,
+                  packedBits.begin() + static_cast<size_t>(t + 1) * TemplateFingerprint::WORD_COUNT,
+                  fingerprint.bits.begin());
+        QJsonObject entry;
+        entry["id"] = templateIds[t];
+        entry["fingerprint"] = fingerprint.toHex();
+        templates.append(entry);
+    }
+    
+    QJsonObject root;
+    root["version"] = LIBRARY_FORMAT_VERSION;
+    root["gridSize"] = TemplateFingerprint::GRID_SIZE;
+    root["templates"] = templates;
+    
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        fprintf(stderr, "[TemplateLibrary] Cannot write %s\n", qPrintable(filePath));
+        fflush(stderr);
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+bool TemplateLibrary::load(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "[TemplateLibrary] Cannot read %s\n", qPrintable(filePath));
+        fflush(stderr);
+        return false;
+    }
+    
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root["version"].toInt() != LIBRARY_FORMAT_VERSION ||
+        root["gridSize"].toInt() != TemplateFingerprint::GRID_SIZE) {
+        fprintf(stderr, "[TemplateLibrary] Unsupported library file %s\n", qPrintable(filePath));
+        fflush(stderr);
+        return false;
+    }
+    
+    TemplateLibrary loaded;
+    for (const QJsonValue& value : root["templates"].toArray()) {
+        QJsonObject entry = value.toObject();
+        if (!loaded.addTemplate(entry["id"].toString(), TemplateFingerprint::fromHex(entry["fingerprint"].toString()))) {
+            fprintf(stderr, "[TemplateLibrary] Malformed entry in %s\n", qPrintable(filePath));
+            fflush(stderr);
+            return false;
+        }
+    }
+    
+    templateIds = loaded.templateIds;
+    packedBits = loaded.packedBits;
+    return true;
+}
+
+} // namespace ocr_orc
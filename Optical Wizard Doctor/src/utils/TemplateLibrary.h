@@ -0,0 +1,154 @@
+#ifndef TEMPLATE_LIBRARY_H
+#define TEMPLATE_LIBRARY_H
+
+#include <opencv2/opencv.hpp>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QtGlobal>
+#include <array>
+#include <vector>
+
+namespace ocr_orc {
+
+/**
+ * @brief Compact signature of a form's ruled-line structure
+ *
+ * The page's horizontal and vertical lines are extracted with long
+ * morphological openings, the line map is averaged onto a GRID_SIZE x
+ * GRID_SIZE grid, and each cell becomes one bit (line coverage above the
+ * page mean). Different scans of the same form differ in a few bits;
+ * different forms differ in many, so Hamming distance identifies the form.
+ */
+struct TemplateFingerprint {
+    static constexpr int GRID_SIZE = 32;
+    static constexpr int BIT_COUNT = GRID_SIZE * GRID_SIZE;
+    static constexpr int WORD_COUNT = BIT_COUNT / 64;
+    
+    std::array<quint64, WORD_COUNT> bits{};
+    bool valid = false;  // False for pages without ruled structure
+    
+    /**
+     * @brief Number of differing bits (0 - BIT_COUNT)
+     */
+    static int distance(const TemplateFingerprint& a, const TemplateFingerprint& b);
+    
+    /**
+     * @brief Hex encoding (BIT_COUNT / 4 characters)
+     */
+    QString toHex() const;
+    
+    /**
+     * @brief Decode toHex() output (invalid fingerprint on malformed input)
+     */
+    static TemplateFingerprint fromHex(const QString& hex);
+};
+
+/**
+ * @brief One library entry returned by a lookup
+ */
+struct TemplateMatch {
+    QString templateId;       // Empty if nothing matched
+    int distance = -1;        // Hamming distance to the query
+    double similarity = 0.0;  // 1 - distance / BIT_COUNT
+    
+    bool isValid() const { return !templateId.isEmpty(); }
+};
+
+/**
+ * @brief In-memory library of template fingerprints for form identification
+ *
+ * Fingerprints are packed back to back in one array, so a lookup is a
+ * popcount scan over WORD_COUNT words per template: thousands of templates
+ * are searched in well under a millisecond, and the page fingerprint itself
+ * (one downscale and two openings) dominates the cost of identify().
+ *
+ * Template ids are caller-defined (typically the path of the saved
+ * template project); the library can be saved to and loaded from JSON.
+ */
+class TemplateLibrary {
+public:
+    TemplateLibrary();
+    ~TemplateLibrary() = default;
+    
+    /**
+     * @brief Compute the fingerprint of a page
+     * @param page Page image (gray, BGR or BGRA)
+     * @return Fingerprint (invalid if the page has no ruled lines)
+     */
+    static TemplateFingerprint computeFingerprint(const cv::Mat& page);
+    
+    /**
+     * @brief Add or replace a template from its page image
+     * @param templateId Template identifier
+     * @param page Template page image
+     * @return false if the page has no usable structure
+     */
+    bool addTemplate(const QString& templateId, const cv::Mat& page);
+    
+    /**
+     * @brief Add or replace a template from a precomputed fingerprint
+     * @return false if the fingerprint is invalid
+     */
+    bool addTemplate(const QString& templateId, const TemplateFingerprint& fingerprint);
+    
+    /**
+     * @brief Remove a template
+     * @return true if it was present
+     */
+    bool removeTemplate(const QString& templateId);
+    
+    bool containsTemplate(const QString& templateId) const { return templateIds.contains(templateId); }
+    int size() const { return static_cast<int>(templateIds.size()); }
+    void clear();
+    
+    /**
+     * @brief Get the ids of all templates (insertion order, except after removals)
+     */
+    QStringList getTemplateIds() const { return templateIds; }
+    
+    /**
+     * @brief Find the nearest templates to a fingerprint
+     * @param fingerprint Query fingerprint
+     * @param count Maximum number of results
+     * @return Matches ordered by ascending distance (ties by insertion order)
+     */
+    QList<TemplateMatch> findNearest(const TemplateFingerprint& fingerprint, int count = 1) const;
+    
+    /**
+     * @brief Identify the template a page was scanned from
+     * @param page Page image
+     * @return Best match if its similarity reaches the match threshold, else an empty match
+     */
+    TemplateMatch identify(const cv::Mat& page) const;
+    
+    /**
+     * @brief Set the minimum similarity identify() accepts (default: 0.85)
+     */
+    void setMatchThreshold(double threshold) { matchThreshold = threshold; }
+    double getMatchThreshold() const { return matchThreshold; }
+    
+    /**
+     * @brief Save the library as JSON
+     * @return false if the file cannot be written
+     */
+    bool save(const QString& filePath) const;
+    
+    /**
+     * @brief Replace the library with one saved by save()
+     * @return false if the file cannot be read or is malformed
+     */
+    bool load(const QString& filePath);
+
+private:
+    QStringList templateIds;
+    std::vector<quint64> packedBits;  // WORD_COUNT words per template, in templateIds order
+    double matchThreshold;
+    
+    static constexpr int WORK_LONG_SIDE = 800;       // Line extraction size
+    static constexpr int LINE_KERNEL_FRACTION = 30;  // Minimum line length = side / fraction
+};
+
+} // namespace ocr_orc
+
+#endif // TEMPLATE_LIBRARY_H
@@ -0,0 +1,295 @@
+#include "TemplateRegistration.h"
+#include "ImageConverter.h"
+#include "PdfLoader.h"
+#include "TraceRecorder.h"
+#include <opencv2/calib3d.hpp>
+#include <opencv2/features2d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace ocr_orc {
+
+namespace {
+
+// Gray copy of a page (no copy when already gray)
+cv::Mat toGray(const cv::Mat& image)
+{
+    if (image.channels() == 1) {
+        return image;
+    }
+    cv::Mat gray;
+    cv::cvtColor(image, gray, image.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    return gray;
+}
+
+// Diagonal scale matrix (normalized <-> pixel)
+cv::Mat scaleMatrix(double sx, double sy)
+{
+    return (cv::Mat_<double>(3, 3) << sx, 0.0, 0.0, 0.0, sy, 0.0, 0.0, 0.0, 1.0);
+}
+
+} // namespace
+
+TemplateRegistration::TemplateRegistration()
+    : transformModel(AFFINE_TRANSFORM)
+    , maxFeatures(3000)
+{
+}
+
+bool TemplateRegistration::setTemplate(const DocumentState& templateState)
+{
+    TraceSpan span("TemplateRegistration::setTemplate", "registration");
+    
+    templateFeatures = TemplateFeatures();
+    templateRegions = templateState.regions;
+    templateGroups = templateState.groups;
+    
+    QImage image = templateState.image;
+    if (image.isNull() && !templateState.pdfPath.isEmpty()) {
+        image = PdfLoader::loadPdfFirstPage(templateState.pdfPath);
+    }
+    if (image.isNull()) {
+        fprintf(stderr, "[TemplateRegistration] Template has no page image\n");
+        fflush(stderr);
+        return false;
+    }
+    
+    templateFeatures = extractFeatures(ImageConverter::qImageToMat(image));
+    span.setArg("keypoints", static_cast<int>(templateFeatures.keypoints.size()));
+    span.setArg("regions", static_cast<int>(templateRegions.size()));
+    
+    if (static_cast<int>(templateFeatures.keypoints.size()) < MIN_INLIERS) {
+        fprintf(stderr, "[TemplateRegistration] Template has too few features (%d)\n",
+                static_cast<int>(templateFeatures.keypoints.size()));
+        fflush(stderr);
+        templateFeatures = TemplateFeatures();
+        return false;
+    }
+    return true;
+}
+
+TemplateFeatures TemplateRegistration::extractFeatures(const cv::Mat& image) const
+{
+    TemplateFeatures features;
+    if (image.empty()) {
+        return features;
+    }
+    features.imageSize = image.size();
+    
+    // Features are found on a fixed-size page so counts and RANSAC distances
+    // do not depend on the scan DPI
+    cv::Mat gray = toGray(image);
+    double scale = std::min(1.0, static_cast<double>(WORK_LONG_SIDE) / std::max(gray.cols, gray.rows));
+    cv::Mat work;
+    if (scale < 1.0) {
+        cv::resize(gray, work, cv::Size(), scale, scale, cv::INTER_AREA);
+    } else {
+        work = gray;
+    }
+    
+    cv::Ptr<cv::ORB> orb = cv::ORB::create(maxFeatures);
+    orb->detectAndCompute(work, cv::noArray(), features.keypoints, features.descriptors);
+    
+    for (cv::KeyPoint& keypoint : features.keypoints) {
+        keypoint.pt.x = static_cast<float>(keypoint.pt.x / scale);
+        keypoint.pt.y = static_cast<float>(keypoint.pt.y / scale);
+        keypoint.size = static_cast<float>(keypoint.size / scale);
+    }
+    return features;
+}
+
+TemplateRegistrationResult TemplateRegistration::registerPage(const QImage& page)
+{
+    return registerPage(ImageConverter::qImageToMat(page));
+}
+
+TemplateRegistrationResult TemplateRegistration::registerPage(const cv::Mat& page)
+{
+    TraceSpan span("TemplateRegistration::registerPage", "registration");
+    TemplateRegistrationResult result;
+    
+    if (!hasTemplate() || page.empty()) {
+        return result;
+    }
+    
+    TemplateFeatures pageFeatures = extractFeatures(page);
+    span.setArg("page_keypoints", static_cast<int>(pageFeatures.keypoints.size()));
+    if (pageFeatures.isEmpty()) {
+        return result;
+    }
+    
+    // Match template -> page, keeping unambiguous matches only
+    cv::BFMatcher matcher(cv::NORM_HAMMING);
+    std::vector<std::vector<cv::DMatch>> knnMatches;
+    matcher.knnMatch(templateFeatures.descriptors, pageFeatures.descriptors, knnMatches, 2);
+    
+    std::vector<cv::Point2f> templatePoints;
+    std::vector<cv::Point2f> pagePoints;
+    for (const std::vector<cv::DMatch>& candidates : knnMatches) {
+        if (candidates.size() < 2 || candidates[0].distance >= RATIO_TEST * candidates[1].distance) {
+            continue;
+        }
+        templatePoints.push_back(templateFeatures.keypoints[candidates[0].queryIdx].pt);
+        pagePoints.push_back(pageFeatures.keypoints[candidates[0].trainIdx].pt);
+    }
+    result.matchCount = static_cast<int>(templatePoints.size());
+    span.setArg("matches", result.matchCount);
+    
+    if (result.matchCount < MIN_INLIERS) {
+        fprintf(stderr, "[TemplateRegistration] Too few matches (%d)\n", result.matchCount);
+        fflush(stderr);
+        return result;
+    }
+    
+    // RANSAC distance is defined at work size; convert to page pixels
+    const double pageScale = std::min(1.0, static_cast<double>(WORK_LONG_SIDE) /
+                                           std::max(page.cols, page.rows));
+    const double threshold = RANSAC_THRESHOLD / pageScale;
+    
+    std::vector<uchar> inlierMask;
+    cv::Mat transform;
+    if (transformModel == HOMOGRAPHY_TRANSFORM) {
+        transform = cv::findHomography(templatePoints, pagePoints, cv::RANSAC, threshold, inlierMask);
+    } else {
+        cv::Mat affine = cv::estimateAffine2D(templatePoints, pagePoints, inlierMask, cv::RANSAC, threshold);
+        if (!affine.empty()) {
+            transform = cv::Mat::eye(3, 3, CV_64F);
+            affine.copyTo(transform(cv::Rect(0, 0, 3, 2)));
+        }
+    }
+    if (transform.empty()) {
+        fprintf(stderr, "[TemplateRegistration] Transform estimation failed\n");
+        fflush(stderr);
+        return result;
+    }
+    transform.convertTo(transform, CV_64F);
+    
+    // Inlier statistics
+    std::vector<cv::Point2f> projected;
+    cv::perspectiveTransform(templatePoints, projected, transform);
+    double errorSum = 0.0;
+    for (size_t i = 0; i < inlierMask.size(); ++i) {
+        if (inlierMask[i]) {
+            result.inlierCount++;
+            errorSum += cv::norm(projected[i] - pagePoints[i]);
+        }
+    }
+    result.inlierRatio = static_cast<double>(result.inlierCount) / result.matchCount;
+    result.reprojectionError = result.inlierCount > 0 ? errorSum / result.inlierCount : 0.0;
+    result.transform = transform;
+    span.setArg("inliers", result.inlierCount);
+    
+    if (result.inlierCount < MIN_INLIERS ||
+        !isPlausible(transform, templateFeatures.imageSize, page.size())) {
+        fprintf(stderr, "[TemplateRegistration] Rejected transform (%d inliers of %d matches)\n",
+                result.inlierCount, result.matchCount);
+        fflush(stderr);
+        return result;
+    }
+    
+    result.regions = projectRegions(templateRegions, transform, templateFeatures.imageSize, page.size());
+    result.success = true;
+    span.setArg("regions", static_cast<int>(result.regions.size()));
+    
+    fprintf(stderr, "[TemplateRegistration] Registered page: %d/%d inliers, %.2f px error, %d regions\n",
+            result.inlierCount, result.matchCount, result.reprojectionError,
+            static_cast<int>(result.regions.size()));
+    fflush(stderr);
+    return result;
+}
+
+bool TemplateRegistration::isPlausible(const cv::Mat& transform, const cv::Size& templateSize,
+                                       const cv::Size& pageSize) const
+{
+    // Express the transform in normalized units so different DPIs compare equal
+    cv::Mat normalized = scaleMatrix(1.0 / pageSize.width, 1.0 / pageSize.height) * transform *
+                         scaleMatrix(templateSize.width, templateSize.height);
+    normalized /= normalized.at<double>(2, 2);
+    
+    double sx = std::hypot(normalized.at<double>(0, 0), normalized.at<double>(1, 0));
+    double sy = std::hypot(normalized.at<double>(0, 1), normalized.at<double>(1, 1));
+    double det = normalized.at<double>(0, 0) * normalized.at<double>(1, 1) -
+                 normalized.at<double>(0, 1) * normalized.at<double>(1, 0);
+    if (det <= 0.0) {
+        return false;  // Mirrored or collapsed
+    }
+    if (sx < MIN_SCALE || sx > MAX_SCALE || sy < MIN_SCALE || sy > MAX_SCALE) {
+        return false;
+    }
+    double perspective = std::abs(normalized.at<double>(2, 0)) + std::abs(normalized.at<double>(2, 1));
+    return perspective <= MAX_PERSPECTIVE;
+}
+
+QMap<QString, RegionData> TemplateRegistration::projectRegions(const QMap<QString, RegionData>& regions,
+                                                               const cv::Mat& transform,
+                                                               const cv::Size& templateSize,
+                                                               const cv::Size& pageSize)
+{
+    QMap<QString, RegionData> projected;
+    if (transform.empty() || templateSize.area() <= 0 || pageSize.area() <= 0) {
+        return projected;
+    }
+    
+    // Normalized template -> normalized page in one matrix
+    cv::Mat normalized = scaleMatrix(1.0 / pageSize.width, 1.0 / pageSize.height) * transform *
+                         scaleMatrix(templateSize.width, templateSize.height);
+    
+    std::vector<cv::Point2d> corners(4);
+    std::vector<cv::Point2d> mapped;
+    for (auto it = regions.constBegin(); it != regions.constEnd(); ++it) {
+        const NormalizedCoords& coords = it.value().normalizedCoords;
+        corners[0] = cv::Point2d(coords.x1, coords.y1);
+        corners[1] = cv::Point2d(coords.x2, coords.y1);
+        corners[2] = cv::Point2d(coords.x2, coords.y2);
+        corners[3] = cv::Point2d(coords.x1, coords.y2);
+        cv::perspectiveTransform(corners, mapped, normalized);
+    
+        double x1 = mapped[0].x, x2 = mapped[0].x, y1 = mapped[0].y, y2 = mapped[0].y;
+        for (const cv::Point2d& point : mapped) {
+            x1 = std::min(x1, point.x);
+            x2 = std::max(x2, point.x);
+            y1 = std::min(y1, point.y);
+            y2 = std::max(y2, point.y);
+        }
+    
+        RegionData region = it.value();
+        region.normalizedCoords = NormalizedCoords(std::clamp(x1, 0.0, 1.0), std::clamp(y1, 0.0, 1.0),
+                                                   std::clamp(x2, 0.0, 1.0), std::clamp(y2, 0.0, 1.0));
+        if (region.normalizedCoords.x2 <= region.normalizedCoords.x1 ||
+            region.normalizedCoords.y2 <= region.normalizedCoords.y1) {
+            continue;  // Projected off the page
+        }
+        projected.insert(it.key(), region);
+    }
+    return projected;
+}
+
+bool TemplateRegistration::applyToDocument(const TemplateRegistrationResult& result, DocumentState& target) const
+{
+    if (!result.success) {
+        return false;
+    }
+    
+    target.saveState();
+    target.regions = result.regions;
+    
+    // Keep template groups, minus regions that fell off the page
+    target.groups.clear();
+    for (auto it = templateGroups.constBegin(); it != templateGroups.constEnd(); ++it) {
+        GroupData group(it.key());
+        for (const QString& regionName : it.value().regionNames) {
+            if (target.regions.contains(regionName)) {
+                group.addRegion(regionName);
+            }
+        }
+        if (!group.regionNames.isEmpty()) {
+            target.groups.insert(it.key(), group);
+        }
+    }
+    target.synchronizeCoordinates();
+    return true;
+}
+
+} // namespace ocr_orc
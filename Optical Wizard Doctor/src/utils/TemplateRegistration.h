@@ -0,0 +1,167 @@
+#ifndef TEMPLATE_REGISTRATION_H
+#define TEMPLATE_REGISTRATION_H
+
+#include "../models/DocumentState.h"
+#include "../models/RegionData.h"
+#include <opencv2/opencv.hpp>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtGui/QImage>
+#include <algorithm>
+#include <vector>
+
+namespace ocr_orc {
+
+/**
+ * @brief Keypoints and descriptors of one page
+ */
+struct TemplateFeatures {
+    std::vector<cv::KeyPoint> keypoints;  // Full-resolution pixel coordinates
+    cv::Mat descriptors;                  // ORB descriptors, one row per keypoint
+    cv::Size imageSize;                   // Full-resolution page size
+    
+    bool isEmpty() const { return keypoints.empty() || descriptors.empty(); }
+};
+
+/**
+ * @brief Result of aligning a page to a template
+ */
+struct TemplateRegistrationResult {
+    bool success = false;
+    cv::Mat transform;                  // 3x3 CV_64F, template pixels -> page pixels
+    int matchCount = 0;                 // Descriptor matches passing the ratio test
+    int inlierCount = 0;                // Matches consistent with the transform
+    double inlierRatio = 0.0;           // inlierCount / matchCount
+    double reprojectionError = 0.0;     // Mean inlier error (page pixels)
+    QMap<QString, RegionData> regions;  // Template regions projected onto the page
+};
+
+/**
+ * @brief Registration of new scans against a calibrated template
+ *
+ * For the same form scanned many times, the template's regions can be
+ * projected onto each new scan instead of running detection again:
+ * - ORB keypoints on a downscaled gray page (form corners and line
+ *   intersections are what FAST picks up on ruled forms)
+ * - Hamming matching with a ratio test
+ * - RANSAC affine (rotation, scale, shift, shear) or homography estimation
+ * - Region corners mapped through the transform; the axis-aligned bounding
+ *   box becomes the projected region
+ *
+ * setTemplate() extracts the template features once, so registerPage() per
+ * scan only pays for the page's own features and matching.
+ */
+class TemplateRegistration {
+public:
+    /**
+     * @brief Transform model estimated between template and page
+     */
+    enum TransformModel {
+        AFFINE_TRANSFORM,      // Flatbed scans and feeders (default)
+        HOMOGRAPHY_TRANSFORM   // Photographed pages with perspective
+    };
+    
+    TemplateRegistration();
+    ~TemplateRegistration() = default;
+    
+    /**
+     * @brief Set the template to register new pages against
+     *
+     * Uses templateState.image, or renders templateState.pdfPath if no image
+     * is loaded. Regions and groups are copied.
+     *
+     * @param templateState Calibrated document (regions in normalized coordinates)
+     * @return true if the template has enough features to register against
+     */
+    bool setTemplate(const DocumentState& templateState);
+    
+    /**
+     * @brief Check if a template is set
+     */
+    bool hasTemplate() const { return !templateFeatures.isEmpty(); }
+    
+    /**
+     * @brief Get the cached template features
+     */
+    const TemplateFeatures& getTemplateFeatures() const { return templateFeatures; }
+    
+    /**
+     * @brief Register a new page against the current template
+     * @param page New scan (gray, BGR or BGRA)
+     * @return Transform, match statistics and projected regions
+     */
+    TemplateRegistrationResult registerPage(const cv::Mat& page);
+    
+    /**
+     * @brief Register a new page against the current template
+     * @param page New scan
+     * @return Transform, match statistics and projected regions
+     */
+    TemplateRegistrationResult registerPage(const QImage& page);
+    
+    /**
+     * @brief Copy the projected regions and the template groups into a document
+     * @param result Successful registration result
+     * @param target Document holding the new page (its regions and groups are replaced)
+     * @return true if regions were applied
+     */
+    bool applyToDocument(const TemplateRegistrationResult& result, DocumentState& target) const;
+    
+    /**
+     * @brief Extract ORB features of a page
+     * @param image Page image (gray, BGR or BGRA)
+     * @return Keypoints in full-resolution coordinates and their descriptors
+     */
+    TemplateFeatures extractFeatures(const cv::Mat& image) const;
+    
+    /**
+     * @brief Project normalized regions through a pixel transform
+     * @param regions Regions in template normalized coordinates
+     * @param transform 3x3 template-to-page pixel transform
+     * @param templateSize Template page size (pixels)
+     * @param pageSize New page size (pixels)
+     * @return Regions in page normalized coordinates (clamped to the page)
+     */
+    static QMap<QString, RegionData> projectRegions(const QMap<QString, RegionData>& regions,
+                                                    const cv::Mat& transform,
+                                                    const cv::Size& templateSize,
+                                                    const cv::Size& pageSize);
+    
+    void setTransformModel(TransformModel model) { transformModel = model; }
+    TransformModel getTransformModel() const { return transformModel; }
+    
+    /**
+     * @brief Set the number of ORB keypoints per page (default: 3000)
+     */
+    void setMaxFeatures(int count) { maxFeatures = std::max(100, count); }
+    int getMaxFeatures() const { return maxFeatures; }
+
+private:
+    /**
+     * @brief Check that a transform is a plausible scan of the same page
+     *
+     * In normalized page units the transform should be close to a rigid
+     * motion: scale within [MIN_SCALE, MAX_SCALE] and, for homographies, a
+     * small perspective term.
+     */
+    bool isPlausible(const cv::Mat& transform, const cv::Size& templateSize, const cv::Size& pageSize) const;
+    
+    TransformModel transformModel;
+    int maxFeatures;
+    
+    TemplateFeatures templateFeatures;
+    QMap<QString, RegionData> templateRegions;
+    QMap<QString, GroupData> templateGroups;
+    
+    static constexpr int WORK_LONG_SIDE = 1200;          // Feature extraction size
+    static constexpr double RATIO_TEST = 0.75;           // Lowe's ratio
+    static constexpr double RANSAC_THRESHOLD = 3.0;      // Inlier distance at work size (pixels)
+    static constexpr int MIN_INLIERS = 15;
+    static constexpr double MIN_SCALE = 0.5;
+    static constexpr double MAX_SCALE = 2.0;
+    static constexpr double MAX_PERSPECTIVE = 0.5;       // |h20| + |h21| in normalized units
+};
+
+} // namespace ocr_orc
+
+#endif // TEMPLATE_REGISTRATION_H
@@ -1,6 +1,7 @@
 #include "TextRegionRefiner.h"
 #include "AdaptiveThresholdManager.h"
 #include "DetectionCache.h"
+#include "DetectionContext.h"
 #include "../core/CoordinateSystem.h"
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
@@ -15,14 +16,48 @@ TextRegionRefiner::TextRegionRefiner()
     , lineDetectionScore(0.0)
     , rectangularityScore(0.0)
     , detectionCache(nullptr)
+    , detectionContext(nullptr)
+    , pixelScale(1.0)
 {
 }
 
+void TextRegionRefiner::setPixelScale(double scale)
+{
+    pixelScale = scale > 0.0 ? scale : 1.0;
+}
+
+int TextRegionRefiner::px(int pixels) const
+{
+    return std::max(1, static_cast<int>(std::lround(pixels * pixelScale)));
+}
+
 void TextRegionRefiner::setDetectionCache(DetectionCache* cache)
 {
     detectionCache = cache;
 }
 
+void TextRegionRefiner::setDetectionContext(DetectionContext* context)
+{
+    detectionContext = context;
+    detectionCache = context ? &context->getDetectionCache() : nullptr;
+}
+
+cv::Mat TextRegionRefiner::toGrayscale(const cv::Mat& image) const
+{
+    // The run's working page is converted once and shared
+    if (detectionContext && detectionContext->isWorkingImage(image)) {
+        return detectionContext->getWorkingGray();
+    }
+    
+    cv::Mat gray;
+    if (image.channels() == 3) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = image;  // Callers only read the grayscale image
+    }
+    return gray;
+}
+
 NormalizedCoords TextRegionRefiner::refineRegion(const OCRTextRegion& ocrRegion, const cv::Mat& image)
 {
     if (image.empty()) {
@@ -126,20 +161,15 @@ QList<cv::Rect> TextRegionRefiner::detectLinesAroundText(const cv::Rect& textBox
     }
     
     // Convert to grayscale if needed
-    cv::Mat gray;
-    if (image.channels() == 3) {
-        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = image.clone();
-    }
+    cv::Mat gray = toGrayscale(image);
     
     // Apply binary thresholding
     cv::Mat binary;
     cv::threshold(gray, binary, 127, 255, cv::THRESH_BINARY_INV);
     
     // Create morphological kernels for line detection
-    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(25, 1));
-    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 25));
+    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(25), 1));
+    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(25)));
     
     // Detect horizontal lines
     cv::Mat horizontalLines;
@@ -209,12 +239,7 @@ QList<cv::Rect> TextRegionRefiner::detectRectanglesAroundText(const cv::Rect& te
     }
     
     // Convert to grayscale if needed
-    cv::Mat gray;
-    if (image.channels() == 3) {
-        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = image.clone();
-    }
+    cv::Mat gray = toGrayscale(image);
     
     // Apply binary thresholding
     cv::Mat binary;
@@ -245,10 +270,10 @@ QList<cv::Rect> TextRegionRefiner::detectRectanglesAroundText(const cv::Rect& te
             rect.y += searchArea.y;
             
             // Check if rectangle overlaps or is near text
-            bool overlapsText = (rect.x < textBox.x + textBox.width + 10 &&
-                                 rect.x + rect.width > textBox.x - 10 &&
-                                 rect.y < textBox.y + textBox.height + 10 &&
-                                 rect.y + rect.height > textBox.y - 10);
+            bool overlapsText = (rect.x < textBox.x + textBox.width + px(10) &&
+                                 rect.x + rect.width > textBox.x - px(10) &&
+                                 rect.y < textBox.y + textBox.height + px(10) &&
+                                 rect.y + rect.height > textBox.y - px(10));
             
             if (overlapsText) {
                 rects.append(rect);
@@ -381,10 +406,10 @@ cv::Rect TextRegionRefiner::findFormFieldNearLabel(const cv::Rect& labelBox, con
     
     // 1. Search BELOW label (most common - vertical forms)
     cv::Rect searchBelow(
-        std::max(0, labelBox.x - 10),  // Start slightly left of label
-        labelBox.y + labelBox.height + 5,  // Start 5px below label
-        std::min(imgWidth - std::max(0, labelBox.x - 10), labelBox.width + 100),  // Wider than label
-        std::min(imgHeight - (labelBox.y + labelBox.height + 5), labelBox.height * 3)  // Search 3x label height down
+        std::max(0, labelBox.x - px(10)),  // Start slightly left of label
+        labelBox.y + labelBox.height + px(5),  // Start 5px below label
+        std::min(imgWidth - std::max(0, labelBox.x - px(10)), labelBox.width + px(100)),  // Wider than label
+        std::min(imgHeight - (labelBox.y + labelBox.height + px(5)), labelBox.height * 3)  // Search 3x label height down
     );
     
     if (searchBelow.width > 0 && searchBelow.height > 0) {
@@ -402,9 +427,9 @@ cv::Rect TextRegionRefiner::findFormFieldNearLabel(const cv::Rect& labelBox, con
     
     // 3. Search ABOVE label (less common, but sometimes used)
     cv::Rect searchAbove(
-        std::max(0, labelBox.x - 10),
+        std::max(0, labelBox.x - px(10)),
         std::max(0, labelBox.y - labelBox.height * 2),  // Search 2x label height up
-        std::min(imgWidth - std::max(0, labelBox.x - 10), labelBox.width + 100),
+        std::min(imgWidth - std::max(0, labelBox.x - px(10)), labelBox.width + px(100)),
         std::min(labelBox.y - std::max(0, labelBox.y - labelBox.height * 2), labelBox.height * 2)
     );
     
@@ -428,10 +453,10 @@ cv::Rect TextRegionRefiner::detectFormFieldToRight(const cv::Rect& labelBox, con
     int imgHeight = image.rows;
     
     // Search area to the right of label
-    int searchStartX = labelBox.x + labelBox.width + 10;  // 10px gap
-    int searchWidth = std::min(imgWidth - searchStartX, 200);  // Search up to 200px right
-    int searchY = std::max(0, labelBox.y - 5);  // Align with label (slight vertical tolerance)
-    int searchHeight = std::min(imgHeight - searchY, labelBox.height + 10);
+    int searchStartX = labelBox.x + labelBox.width + px(10);  // 10px gap
+    int searchWidth = std::min(imgWidth - searchStartX, px(200));  // Search up to 200px right
+    int searchY = std::max(0, labelBox.y - px(5));  // Align with label (slight vertical tolerance)
+    int searchHeight = std::min(imgHeight - searchY, labelBox.height + px(10));
     
     if (searchWidth <= 0 || searchHeight <= 0) {
         return cv::Rect();
@@ -460,12 +485,7 @@ cv::Rect TextRegionRefiner::detectFormFieldInArea(const cv::Rect& searchArea, co
     }
     
     // Convert to grayscale if needed
-    cv::Mat gray;
-    if (image.channels() == 3) {
-        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = image.clone();
-    }
+    cv::Mat gray = toGrayscale(image);
     
     // Extract ROI
     cv::Mat roi = gray(clampedArea);
@@ -482,7 +502,7 @@ cv::Rect TextRegionRefiner::detectFormFieldInArea(const cv::Rect& searchArea, co
     cv::bitwise_not(binary, binary);
     
     // Look for horizontal lines (underlines) - these indicate form fields
-    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(40, 1));
+    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(40), 1));
     cv::Mat horizontalLines;
     cv::morphologyEx(binary, horizontalLines, cv::MORPH_OPEN, horizontalKernel);
     
@@ -502,10 +522,10 @@ cv::Rect TextRegionRefiner::detectFormFieldInArea(const cv::Rect& searchArea, co
         lineRect.y += clampedArea.y;
         
         // Check if this is a good underline (wide enough, reasonable position)
-        if (lineRect.width < 30) continue;  // Too narrow
+        if (lineRect.width < px(30)) continue;  // Too narrow
         
         // Create form field box: above the underline, reasonable height
-        int fieldHeight = 20;  // Typical form field height
+        int fieldHeight = px(20);  // Typical form field height
         cv::Rect fieldRect(
             lineRect.x,
             lineRect.y - fieldHeight,  // Field is above the underline
@@ -561,7 +581,7 @@ cv::Rect TextRegionRefiner::detectFormFieldInArea(const cv::Rect& searchArea, co
         boxRect.y += clampedArea.y;
         
         // Check if it's a reasonable form field size
-        if (boxRect.width < 30 || boxRect.height < 10 || boxRect.height > 50) continue;
+        if (boxRect.width < px(30) || boxRect.height < px(10) || boxRect.height > px(50)) continue;
         
         // Calculate rectangularity
         double contourArea = cv::contourArea(contour);
@@ -613,7 +633,7 @@ double TextRegionRefiner::calculateHorizontalEdgeDensity(const cv::Mat& roi)
     cv::Canny(roi, edges, 50, 150);
     
     // Create horizontal kernel to emphasize horizontal edges
-    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(5, 1));
+    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(5), 1));
     cv::Mat horizontalEdges;
     cv::morphologyEx(edges, horizontalEdges, cv::MORPH_DILATE, horizontalKernel);
     
@@ -635,7 +655,7 @@ double TextRegionRefiner::calculateVerticalEdgeDensity(const cv::Mat& roi)
     cv::Canny(roi, edges, 50, 150);
     
     // Create vertical kernel to emphasize vertical edges
-    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 5));
+    cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, px(5)));
     cv::Mat verticalEdges;
     cv::morphologyEx(edges, verticalEdges, cv::MORPH_DILATE, verticalKernel);
     
@@ -654,9 +674,9 @@ int TextRegionRefiner::countHorizontalLinesWithHough(const cv::Mat& edges, doubl
     
     // Use HoughLinesP to detect lines
     std::vector<cv::Vec4i> lines;
-    int minLineLength = std::min(edges.cols / 4, 20);  // At least 25% of width or 20px
-    int maxLineGap = 5;
-    cv::HoughLinesP(edges, lines, 1, CV_PI / 180, 30, minLineLength, maxLineGap);
+    int minLineLength = std::min(edges.cols / 4, px(20));  // At least 25% of width or 20px
+    int maxLineGap = px(5);
+    cv::HoughLinesP(edges, lines, 1, CV_PI / 180, px(30), minLineLength, maxLineGap);
     
     // Count horizontal lines (within angle tolerance)
     int horizontalCount = 0;
@@ -766,20 +786,9 @@ bool TextRegionRefiner::regionContainsText(const cv::Rect& region, const cv::Mat
     // Convert to grayscale if needed
     fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 4: Converting to grayscale (channels=%d)...\n", image.channels());
     fflush(stderr);
-    cv::Mat gray;
-    if (image.channels() == 3) {
-        fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 4: Calling cv::cvtColor() - this may take time on large images...\n");
-        fflush(stderr);
-        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-        fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 4: ✓ cv::cvtColor() returned\n");
-        fflush(stderr);
-    } else {
-        fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 4: Cloning image (already grayscale)...\n");
-        fflush(stderr);
-        gray = image.clone();
-        fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 4: ✓ Image cloned\n");
-        fflush(stderr);
-    }
+    cv::Mat gray = toGrayscale(image);
+    fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 4: ✓ Grayscale ready\n");
+    fflush(stderr);
     
     // Extract ROI
     fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 5: Extracting ROI...\n");
@@ -812,7 +821,7 @@ bool TextRegionRefiner::regionContainsText(const cv::Rect& region, const cv::Mat
         fprintf(stderr, "[TextRegionRefiner::regionContainsText] Step 7: No thresholdManager - calculating local brightness manually...\n");
         fflush(stderr);
         // Fallback: calculate local brightness manually
-        int padding = 50;
+        int padding = px(50);
         cv::Rect expandedRegion(
             std::max(0, clampedRegion.x - padding),
             std::max(0, clampedRegion.y - padding),
@@ -972,7 +981,8 @@ bool TextRegionRefiner::regionContainsText(const cv::Rect& region, const cv::Mat
 }
 
 QList<cv::Rect> TextRegionRefiner::findEmptyFormFields(const QList<OCRTextRegion>& ocrHints, 
-                                                       const cv::Mat& image)
+                                                       const cv::Mat& image,
+                                                       const std::function<bool()>& isCancelled)
 {
     QList<cv::Rect> emptyFields;
     
@@ -982,10 +992,13 @@ QList<cv::Rect> TextRegionRefiner::findEmptyFormFields(const QList<OCRTextRegion
     
     // Pass 1: For each OCR hint, search for empty form fields nearby
     for (const OCRTextRegion& hint : ocrHints) {
+        if (isCancelled && isCancelled()) {
+            return emptyFields;  // Result is being discarded
+        }
         cv::Rect hintBox = hint.boundingBox;
         
         // Skip very small hints (likely noise)
-        if (hintBox.width < 10 || hintBox.height < 5) {
+        if (hintBox.width < px(10) || hintBox.height < px(5)) {
             continue;
         }
         
@@ -1007,10 +1020,10 @@ QList<cv::Rect> TextRegionRefiner::findEmptyFormFields(const QList<OCRTextRegion
         
         // 1. Search BELOW hint (most common - vertical forms)
         cv::Rect searchBelow(
-            std::max(0, hintBox.x - 20),
-            hintBox.y + hintBox.height + 5,  // Start 5px below
-            std::min(image.cols - std::max(0, hintBox.x - 20), hintBox.width + 100),
-            std::min(image.rows - (hintBox.y + hintBox.height + 5), hintBox.height * 4)  // Search 4x height down
+            std::max(0, hintBox.x - px(20)),
+            hintBox.y + hintBox.height + px(5),  // Start 5px below
+            std::min(image.cols - std::max(0, hintBox.x - px(20)), hintBox.width + px(100)),
+            std::min(image.rows - (hintBox.y + hintBox.height + px(5)), hintBox.height * 4)  // Search 4x height down
         );
         
         if (searchBelow.width > 0 && searchBelow.height > 0) {
@@ -1022,10 +1035,10 @@ QList<cv::Rect> TextRegionRefiner::findEmptyFormFields(const QList<OCRTextRegion
         
         // 2. Search to the RIGHT of hint (horizontal forms)
         cv::Rect searchRight(
-            hintBox.x + hintBox.width + 10,  // 10px gap
-            std::max(0, hintBox.y - 5),
-            std::min(image.cols - (hintBox.x + hintBox.width + 10), 200),  // Up to 200px right
-            std::min(image.rows - std::max(0, hintBox.y - 5), hintBox.height + 10)
+            hintBox.x + hintBox.width + px(10),  // 10px gap
+            std::max(0, hintBox.y - px(5)),
+            std::min(image.cols - (hintBox.x + hintBox.width + px(10)), px(200)),  // Up to 200px right
+            std::min(image.rows - std::max(0, hintBox.y - px(5)), hintBox.height + px(10))
         );
         
         if (searchRight.width > 0 && searchRight.height > 0) {
@@ -1037,9 +1050,9 @@ QList<cv::Rect> TextRegionRefiner::findEmptyFormFields(const QList<OCRTextRegion
         
         // 3. Search ABOVE hint (less common)
         cv::Rect searchAbove(
-            std::max(0, hintBox.x - 20),
+            std::max(0, hintBox.x - px(20)),
             std::max(0, hintBox.y - hintBox.height * 2),  // Search 2x height up
-            std::min(image.cols - std::max(0, hintBox.x - 20), hintBox.width + 100),
+            std::min(image.cols - std::max(0, hintBox.x - px(20)), hintBox.width + px(100)),
             std::min(hintBox.y - std::max(0, hintBox.y - hintBox.height * 2), hintBox.height * 2)
         );
         
@@ -1098,8 +1111,8 @@ cv::Rect TextRegionRefiner::detectUnderlineBelow(const cv::Rect& textBox, const
     }
     
     // Expand search horizontally to find full underline width
-    int searchX = std::max(0, textBox.x - 20);
-    int searchWidth = std::min(image.cols - searchX, textBox.width + 40);
+    int searchX = std::max(0, textBox.x - px(20));
+    int searchWidth = std::min(image.cols - searchX, textBox.width + px(40));
     
     if (searchWidth <= 0) {
         return cv::Rect();
@@ -1108,12 +1121,7 @@ cv::Rect TextRegionRefiner::detectUnderlineBelow(const cv::Rect& textBox, const
     cv::Rect searchArea(searchX, searchStartY, searchWidth, searchHeight);
     
     // Convert to grayscale if needed
-    cv::Mat gray;
-    if (image.channels() == 3) {
-        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = image.clone();
-    }
+    cv::Mat gray = toGrayscale(image);
     
     // Apply binary thresholding
     cv::Mat binary;
@@ -1123,7 +1131,7 @@ cv::Rect TextRegionRefiner::detectUnderlineBelow(const cv::Rect& textBox, const
     cv::Mat roi = binary(searchArea);
     
     // Use horizontal morphology to detect underline
-    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(30, 1));
+    cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(px(30), 1));
     cv::Mat horizontalLines;
     cv::morphologyEx(roi, horizontalLines, cv::MORPH_OPEN, horizontalKernel);
     
@@ -1170,7 +1178,7 @@ cv::Rect TextRegionRefiner::mergeDetections(const cv::Rect& textBox,
         int y2 = std::max(merged.y + merged.height, underlineRect.y + underlineRect.height);
         
         // Add some padding below underline for form field
-        y2 += 5;  // 5px padding below underline
+        y2 += px(5);  // 5px padding below underline
         
         merged = cv::Rect(x1, y1, x2 - x1, y2 - y1);
     }
@@ -4,6 +4,7 @@
 #include "OcrTextExtractor.h"
 #include <opencv2/opencv.hpp>
 #include <QtCore/QList>
+#include <functional>
 
 namespace ocr_orc {
 
@@ -50,6 +51,13 @@ public:
      */
     int getExpansionRadius() const { return expansionRadiusPercent; }
     
+    /**
+     * @brief Scale the built-in pixel sizes (line kernels, field size limits,
+     *        label search offsets) to the page raster
+     * @param scale Raster size relative to a full-resolution page (1.0 = unchanged)
+     */
+    void setPixelScale(double scale);
+    
     /**
      * @brief Check if text is likely a label (for external use)
      * @param text Text to check
@@ -95,15 +103,26 @@ public:
      * @brief Multi-pass refinement: find empty form fields near OCR hints
      * @param ocrHints OCR text regions (used as coordinate hints only)
      * @param image Source image
+     * @param isCancelled Polled before each hint; may be empty (a cancelled call returns what it has)
      * @return List of empty form field rectangles (no text content)
      */
-    QList<cv::Rect> findEmptyFormFields(const QList<OCRTextRegion>& ocrHints, const cv::Mat& image);
+    QList<cv::Rect> findEmptyFormFields(const QList<OCRTextRegion>& ocrHints, const cv::Mat& image,
+                                        const std::function<bool()>& isCancelled = std::function<bool()>());
     
     /**
      * @brief Set detection cache for performance optimization
      * @param cache Detection cache instance (can be nullptr to disable caching)
      */
     void setDetectionCache(class DetectionCache* cache);
+    
+    /**
+     * @brief Share the run's page conversions and detection cache
+     * 
+     * Calls on the context's working image reuse its grayscale copy instead
+     * of converting the full page on every call. Also sets the detection cache.
+     * @param context Detection context (can be nullptr to disable sharing)
+     */
+    void setDetectionContext(class DetectionContext* context);
 
 private:
     /**
@@ -218,12 +237,26 @@ private:
      */
     int countHorizontalLinesWithHough(const cv::Mat& edges, double angleTolerance = 5.0);
     
+    /**
+     * @brief Grayscale view of an image (shared with the detection context when possible)
+     * @param image Source image (BGR or gray)
+     * @return Grayscale image (read-only)
+     */
+    cv::Mat toGrayscale(const cv::Mat& image) const;
+    
+    /**
+     * @brief Pixel size scaled by pixelScale (at least 1)
+     */
+    int px(int pixels) const;
+    
     int expansionRadiusPercent;  // Expansion radius as % of text height (default: 20)
     double lineDetectionScore;   // Cached line detection score
     double rectangularityScore;   // Cached rectangularity score
     
     // Detection cache for performance optimization (expert recommendation)
     class DetectionCache* detectionCache;  // Optional cache for expensive calculations
+    class DetectionContext* detectionContext;  // Optional per-run page conversions
+    double pixelScale;  // See setPixelScale()
 };
 
 } // namespace ocr_orc
@@ -0,0 +1,312 @@
+#include "TraceRecorder.h"
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QFile>
+#include <QtCore/QDir>
+#include <QtCore/QDateTime>
+#include <QtCore/QSettings>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QCoreApplication>
+#include <cstdio>
+
+namespace ocr_orc {
+
+std::atomic<bool> TraceRecorder::enabledFlag{false};
+
+namespace {
+    std::atomic<int> nextThreadId{1};
+}
+
+TraceRecorder& TraceRecorder::instance() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : traceDirectory(QStandardPaths::writableLocation(QStandardPaths::TempLocation))
+    , environmentSetsEnabled(false)
+    , environmentSetsDirectory(false)
+{
+    epoch.start();
+}
+
+void TraceRecorder::setEnabled(bool enabled) {
+    enabledFlag.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::configureFromEnvironment() {
+    QSettings settings("OCROrc", "OCR-Orc");
+    bool enabled = settings.value("diagnostics/enableTracing", false).toBool();
+    QString directory = settings.value("diagnostics/traceDirectory", QString()).toString();
+
+    // OCR_ORC_TRACE=1 enables tracing; any other non-"0" value is treated as the output directory
+    QByteArray env = qgetenv("OCR_ORC_TRACE");
+    bool envDirectory = false;
+    if (!env.isEmpty()) {
+        QString value = QString::fromLocal8Bit(env).trimmed();
+        if (value == "0" || value.compare("false", Qt::CaseInsensitive) == 0) {
+            enabled = false;
+        } else {
+            enabled = true;
+            if (value != "1" && value.compare("true", Qt::CaseInsensitive) != 0) {
+                directory = value;
+                envDirectory = true;
+            }
+        }
+    }
+    {
+        QMutexLocker locker(&mutex);
+        environmentSetsEnabled = !env.isEmpty();
+        environmentSetsDirectory = envDirectory;
+    }
+
+    if (!directory.isEmpty()) {
+        setOutputDirectory(directory);
+    }
+    setEnabled(enabled);
+
+    if (enabled) {
+        fprintf(stderr, "[TraceRecorder] Runtime tracing ENABLED - traces will be written to %s\n",
+                outputDirectory().toLocal8Bit().constData());
+        fflush(stderr);
+    }
+}
+
+void TraceRecorder::applyPreferences(bool enabled, const QString& directory) {
+    bool keepEnabled;
+    bool keepDirectory;
+    {
+        QMutexLocker locker(&mutex);
+        keepEnabled = environmentSetsEnabled;
+        keepDirectory = environmentSetsDirectory;
+    }
+    if (!keepDirectory) {
+        setOutputDirectory(directory);
+    }
+    if (!keepEnabled) {
+        setEnabled(enabled);
+    }
+}
+
+QString TraceRecorder::outputDirectory() const {
+    QMutexLocker locker(&mutex);
+    return traceDirectory;
+}
+
+void TraceRecorder::setOutputDirectory(const QString& directory) {
+    QMutexLocker locker(&mutex);
+    traceDirectory = directory;
+}
+
+qint64 TraceRecorder::nowUs() const {
+    return epoch.nsecsElapsed() / 1000;
+}
+
+int TraceRecorder::currentThreadId() {
+    thread_local int threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+void TraceRecorder::append(const TraceEvent& event) {
+    QMutexLocker locker(&mutex);
+    if (recordedEvents.size() >= MAX_EVENTS) {
+        return;
+    }
+    recordedEvents.append(event);
+}
+
+void TraceRecorder::recordSpan(const QString& name, const QString& category,
+                               qint64 startUs, qint64 durationUs,
+                               const QVariantMap& args) {
+    if (!isEnabled()) return;
+
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'X';
+    event.timestampUs = startUs;
+    event.durationUs = durationUs;
+    event.threadId = currentThreadId();
+    event.args = args;
+    append(event);
+}
+
+void TraceRecorder::recordCounter(const QString& name, double value) {
+    if (!isEnabled()) return;
+
+    TraceEvent event;
+    event.name = name;
+    event.category = "counter";
+    event.phase = 'C';
+    event.timestampUs = nowUs();
+    event.threadId = currentThreadId();
+    event.args.insert("value", value);
+    append(event);
+}
+
+void TraceRecorder::setCurrentThreadName(const QString& name) {
+    int threadId = currentThreadId();
+    QMutexLocker locker(&mutex);
+    threadNames[threadId] = name;
+}
+
+QList<TraceEvent> TraceRecorder::events() const {
+    QMutexLocker locker(&mutex);
+    return recordedEvents;
+}
+
+int TraceRecorder::eventCount() const {
+    QMutexLocker locker(&mutex);
+    return recordedEvents.size();
+}
+
+void TraceRecorder::clear() {
+    QMutexLocker locker(&mutex);
+    recordedEvents.clear();
+}
+
+bool TraceRecorder::exportChromeTrace(const QString& filePath) const {
+    QList<TraceEvent> snapshot;
+    QMap<int, QString> names;
+    {
+        QMutexLocker locker(&mutex);
+        snapshot = recordedEvents;
+        names = threadNames;
+    }
+    return writeChromeTrace(filePath, snapshot, names);
+}
+
+bool TraceRecorder::writeChromeTrace(const QString& filePath, const QList<TraceEvent>& snapshot,
+                                     const QMap<int, QString>& names) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        fprintf(stderr, "[TraceRecorder::exportChromeTrace] Failed to open %s for writing\n",
+                filePath.toLocal8Bit().constData());
+        fflush(stderr);
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    // Events are streamed one at a time so large traces do not need a second copy as a JSON DOM
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    auto writeObject = [&file, &first](const QJsonObject& obj) {
+        if (!first) {
+            file.write(",\n");
+        }
+        first = false;
+        file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    };
+
+    for (auto it = names.constBegin(); it != names.constEnd(); ++it) {
+        QJsonObject meta;
+        meta["name"] = "thread_name";
+        meta["ph"] = "M";
+        meta["pid"] = pid;
+        meta["tid"] = it.key();
+        QJsonObject args;
+        args["name"] = it.value();
+        meta["args"] = args;
+        writeObject(meta);
+    }
+
+    for (const TraceEvent& event : snapshot) {
+        QJsonObject obj;
+        obj["name"] = event.name;
+        obj["cat"] = event.category;
+        obj["ph"] = QString(QChar::fromLatin1(event.phase));
+        obj["ts"] = event.timestampUs;
+        obj["pid"] = pid;
+        obj["tid"] = event.threadId;
+        if (event.phase == 'X') {
+            obj["dur"] = event.durationUs;
+        }
+        if (!event.args.isEmpty()) {
+            obj["args"] = QJsonObject::fromVariantMap(event.args);
+        }
+        writeObject(obj);
+    }
+
+    file.write("\n]}\n");
+    file.close();
+
+    if (file.error() != QFile::NoError) {
+        fprintf(stderr, "[TraceRecorder::exportChromeTrace] Write error: %s\n",
+                file.errorString().toLocal8Bit().constData());
+        fflush(stderr);
+        return false;
+    }
+    return true;
+}
+
+QString TraceRecorder::exportToDefaultLocation(const QString& label) {
+    QString directory = outputDirectory();
+    if (!QDir().mkpath(directory)) {
+        fprintf(stderr, "[TraceRecorder::exportToDefaultLocation] Cannot create directory %s\n",
+                directory.toLocal8Bit().constData());
+        fflush(stderr);
+        return QString();
+    }
+
+    QString fileName = QString("ocr-orc-trace-%1-%2.json")
+                       .arg(label)
+                       .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz"));
+    QString filePath = QDir(directory).filePath(fileName);
+    
+    // Take the events out under the lock: spans ending during the write stay for the next export
+    QList<TraceEvent> taken;
+    QMap<int, QString> names;
+    {
+        QMutexLocker locker(&mutex);
+        taken.swap(recordedEvents);
+        names = threadNames;
+    }
+    if (!writeChromeTrace(filePath, taken, names)) {
+        QMutexLocker locker(&mutex);
+        taken.append(recordedEvents);
+        recordedEvents.swap(taken);
+        if (recordedEvents.size() > MAX_EVENTS) {
+            recordedEvents.resize(MAX_EVENTS);
+        }
+        return QString();
+    }
+
+    fprintf(stderr, "[TraceRecorder] Wrote %lld trace events to %s\n",
+            static_cast<long long>(taken.size()), filePath.toLocal8Bit().constData());
+    fflush(stderr);
+    return filePath;
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : active(TraceRecorder::isEnabled())
+    , startUs(0)
+    , spanCategory(category)
+{
+    if (active) {
+        spanName = QString::fromUtf8(name);
+        startUs = TraceRecorder::instance().nowUs();
+    }
+}
+
+TraceSpan::TraceSpan(const QString& name, const char* category)
+    : active(TraceRecorder::isEnabled())
+    , startUs(0)
+    , spanCategory(category)
+{
+    if (active) {
+        spanName = name;
+        startUs = TraceRecorder::instance().nowUs();
+    }
+}
+
+void TraceSpan::end() {
+    if (!active) return;
+    active = false;
+
+    TraceRecorder& recorder = TraceRecorder::instance();
+    recorder.recordSpan(spanName, QString::fromLatin1(spanCategory),
+                        startUs, recorder.nowUs() - startUs, args);
+}
+
+} // namespace ocr_orc
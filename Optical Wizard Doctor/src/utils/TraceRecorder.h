@@ -0,0 +1,231 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QVariant>
+#include <QtCore/QVariantMap>
+#include <QtCore/QMutex>
+#include <QtCore/QElapsedTimer>
+#include <atomic>
+
+namespace ocr_orc {
+
+/**
+ * @brief Single trace event in Chrome trace-event terms
+ *
+ * phase is 'X' (complete span), 'C' (counter) or 'M' (metadata, e.g. thread name).
+ */
+struct TraceEvent {
+    QString name;
+    QString category;
+    char phase;
+    qint64 timestampUs;   // Microseconds since the recorder's epoch
+    qint64 durationUs;    // Only meaningful for 'X' events
+    int threadId;         // Small sequential id assigned per thread
+    QVariantMap args;
+
+    TraceEvent() : phase('X'), timestampUs(0), durationUs(0), threadId(0) {}
+};
+
+/**
+ * @brief Process-wide runtime tracer, compiled into production builds
+ *
+ * Off by default. While disabled every entry point returns after a single
+ * relaxed atomic load. Arguments are still built by the caller, so spans in
+ * per-candidate loops set their args only when TraceSpan::isActive().
+ * Enable it from Preferences (Diagnostics tab) or by setting the
+ * OCR_ORC_TRACE environment variable ("1" to enable, or a directory path to
+ * enable and choose where traces are written).
+ *
+ * Recorded events can be exported as Chrome trace-event JSON and opened in
+ * chrome://tracing or https://ui.perfetto.dev.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Get the process-wide recorder
+     */
+    static TraceRecorder& instance();
+
+    /**
+     * @brief Fast check used by TraceSpan and the tracing macros
+     */
+    static bool isEnabled() { return enabledFlag.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Enable or disable recording (existing events are kept)
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Apply OCR_ORC_TRACE and the saved preference
+     *
+     * The environment variable wins over QSettings so a single run can be
+     * traced without touching the user's preferences.
+     */
+    void configureFromEnvironment();
+    
+    /**
+     * @brief Apply the Preferences settings, except where OCR_ORC_TRACE overrides them
+     * @param enabled Preference for recording
+     * @param directory Preferred output directory
+     */
+    void applyPreferences(bool enabled, const QString& directory);
+
+    /**
+     * @brief Directory traces are written to by exportToDefaultLocation()
+     */
+    QString outputDirectory() const;
+    void setOutputDirectory(const QString& directory);
+
+    /**
+     * @brief Record a completed span
+     * @param name Span name (e.g. "Pass 2: Filter Text-Containing Regions")
+     * @param category Comma-separated categories (e.g. "stage", "candidate")
+     * @param startUs Start time from nowUs()
+     * @param durationUs Span duration in microseconds
+     * @param args Optional key/value annotations shown in the trace viewer
+     */
+    void recordSpan(const QString& name, const QString& category,
+                    qint64 startUs, qint64 durationUs,
+                    const QVariantMap& args = QVariantMap());
+
+    /**
+     * @brief Record a counter sample (rendered as a graph track)
+     * @param name Counter name (e.g. "ocr_regions")
+     * @param value Counter value
+     */
+    void recordCounter(const QString& name, double value);
+
+    /**
+     * @brief Name the calling thread in exported traces
+     */
+    void setCurrentThreadName(const QString& name);
+
+    /**
+     * @brief Microseconds since the recorder's epoch
+     */
+    qint64 nowUs() const;
+
+    /**
+     * @brief Sequential id of the calling thread (stable for the thread's life)
+     */
+    static int currentThreadId();
+
+    /**
+     * @brief Snapshot of all recorded events
+     */
+    QList<TraceEvent> events() const;
+
+    /**
+     * @brief Number of recorded events
+     */
+    int eventCount() const;
+
+    /**
+     * @brief Drop all recorded events (thread names are kept)
+     */
+    void clear();
+
+    /**
+     * @brief Write recorded events as Chrome trace-event JSON
+     * @param filePath Destination file
+     * @return true on success
+     */
+    bool exportChromeTrace(const QString& filePath) const;
+
+    /**
+     * @brief Export to a timestamped file in outputDirectory() and clear
+     *
+     * The recorded events are taken out of the buffer in one step, so events
+     * recorded while the file is written go into the next export. If writing
+     * fails, the taken events are put back.
+     * @param label Short label used in the file name (e.g. "detection")
+     * @return Path of the written file, or empty string on failure
+     */
+    QString exportToDefaultLocation(const QString& label);
+
+private:
+    TraceRecorder();
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    void append(const TraceEvent& event);
+    
+    static bool writeChromeTrace(const QString& filePath, const QList<TraceEvent>& events,
+                                 const QMap<int, QString>& names);
+
+    static std::atomic<bool> enabledFlag;
+
+    mutable QMutex mutex;
+    QElapsedTimer epoch;
+    QList<TraceEvent> recordedEvents;
+    QMap<int, QString> threadNames;
+    QString traceDirectory;
+    bool environmentSetsEnabled;    // OCR_ORC_TRACE given: it decides recording
+    bool environmentSetsDirectory;  // OCR_ORC_TRACE named the output directory
+
+    // Cap memory if tracing is left on for a long session
+    static const int MAX_EVENTS = 1000000;
+};
+
+/**
+ * @brief RAII span: records a complete event from construction to end()/destruction
+ *
+ * Usage:
+ *   TraceSpan span("Pass 1: Find Empty Form Fields", "stage");
+ *   span.setArg("fields_found", fields.size());
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "stage");
+    TraceSpan(const QString& name, const char* category);
+    ~TraceSpan() { end(); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    /**
+     * @brief Attach an annotation (ignored while tracing is disabled)
+     */
+    void setArg(const char* key, const QVariant& value) {
+        if (active) {
+            args.insert(QString::fromLatin1(key), value);
+        }
+    }
+
+    /**
+     * @brief True while the span is recording (use to skip building expensive args)
+     */
+    bool isActive() const { return active; }
+
+    /**
+     * @brief Close the span early (subsequent calls are no-ops)
+     */
+    void end();
+
+private:
+    bool active;
+    qint64 startUs;
+    QString spanName;
+    const char* spanCategory;
+    QVariantMap args;
+};
+
+} // namespace ocr_orc
+
+// Convenience macros for spans that cover the rest of the enclosing scope
+#define OCR_ORC_TRACE_CONCAT_INNER(a, b) a##b
+#define OCR_ORC_TRACE_CONCAT(a, b) OCR_ORC_TRACE_CONCAT_INNER(a, b)
+#define OCR_ORC_TRACE_SCOPE(name, category) \
+    ::ocr_orc::TraceSpan OCR_ORC_TRACE_CONCAT(ocrOrcTraceSpan_, __LINE__)(name, category)
+#define OCR_ORC_TRACE_COUNTER(name, value) \
+    do { \
+        if (::ocr_orc::TraceRecorder::isEnabled()) { \
+            ::ocr_orc::TraceRecorder::instance().recordCounter(name, static_cast<double>(value)); \
+        } \
+    } while (0)
+
+#endif // TRACE_RECORDER_H
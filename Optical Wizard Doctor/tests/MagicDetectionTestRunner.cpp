@@ -147,6 +147,88 @@ void MagicDetectionTestRunner::setDetectionMethod(const QString& method)
     detectionMethod = method;
 }
 
+void MagicDetectionTestRunner::setRecognitionMode(OcrTextExtractor::RecognitionMode mode)
+{
+    detector.setRecognitionMode(mode);
+}
+
+OcrModeComparison MagicDetectionTestRunner::compareRecognitionModes(const QString& formId)
+{
+    OcrModeComparison comparison;
+    comparison.formId = formId;
+    
+    GroundTruthAnnotation groundTruth = dataManager.getGroundTruth(formId);
+    if (groundTruth.formId.isEmpty()) {
+        qWarning() << "Failed to load ground truth for form:" << formId;
+        return comparison;
+    }
+    
+    QString imagePath = dataManager.getFormsDirectory() + "/" + groundTruth.imagePath;
+    QImage image = dataManager.loadImage(imagePath);
+    if (image.isNull()) {
+        qWarning() << "✗ Failed to load image:" << imagePath;
+        return comparison;
+    }
+    
+    QElapsedTimer timer;
+    
+    // Separate extractors so the two-tier pass pays its own engine start-up
+    OcrTextExtractor fullPageExtractor;
+    timer.start();
+    QList<OCRTextRegion> fullPage = fullPageExtractor.extractTextRegions(image);
+    comparison.fullPageTimeMs = timer.elapsed();
+    
+    OcrTextExtractor twoTierExtractor;
+    timer.restart();
+    QList<OCRTextRegion> twoTier = twoTierExtractor.extractTextRegionsTwoTier(image);
+    comparison.twoTierTimeMs = timer.elapsed();
+    comparison.layoutWords = twoTierExtractor.getLastLayoutWordCount();
+    comparison.refinedRuns = twoTierExtractor.getLastRefinedSegmentCount();
+    
+    comparison.fullPageWords = fullPage.size();
+    comparison.twoTierWords = twoTier.size();
+    
+    for (const OCRTextRegion& reference : fullPage) {
+        bool isLabel = reference.typeHint == "letters" || reference.typeHint == "mixed";
+        if (isLabel) {
+            comparison.fullPageLabels++;
+        }
+        
+        double bestIoU = 0.0;
+        const OCRTextRegion* best = nullptr;
+        for (const OCRTextRegion& candidate : twoTier) {
+            double iou = MetricsCalculator::calculateIoU(reference.boundingBox, candidate.boundingBox);
+            if (iou > bestIoU) {
+                bestIoU = iou;
+                best = &candidate;
+            }
+        }
+        if (best == nullptr || bestIoU < 0.5) {
+            continue;
+        }
+        
+        comparison.matchedWords++;
+        if (best->text.compare(reference.text, Qt::CaseInsensitive) == 0) {
+            comparison.matchingText++;
+            if (isLabel) {
+                comparison.matchedLabels++;
+            }
+        }
+    }
+    
+    if (comparison.fullPageWords > 0) {
+        comparison.boxRecall = static_cast<double>(comparison.matchedWords) / comparison.fullPageWords;
+    }
+    if (comparison.matchedWords > 0) {
+        comparison.textAgreement = static_cast<double>(comparison.matchingText) / comparison.matchedWords;
+    }
+    if (comparison.fullPageLabels > 0) {
+        comparison.labelRecall = static_cast<double>(comparison.matchedLabels) / comparison.fullPageLabels;
+    }
+    
+    return comparison;
+}
+
 EvaluationMetrics MagicDetectionTestRunner::runSingleTest(const GroundTruthAnnotation& groundTruth)
 {
     // Clear previous instrumentation data
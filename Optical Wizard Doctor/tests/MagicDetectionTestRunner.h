@@ -12,6 +12,35 @@
 
 namespace ocr_orc {
 
+/**
+ * @brief Two-tier vs full-page OCR comparison for one form
+ * 
+ * The full-page pass is the reference: a two-tier word matches when its box
+ * overlaps a full-page word with IoU >= 0.5, and agrees when the text is the
+ * same ignoring case.
+ */
+struct OcrModeComparison {
+    QString formId;
+    double fullPageTimeMs;
+    double twoTierTimeMs;
+    int fullPageWords;
+    int twoTierWords;
+    int matchedWords;     // Full-page words with an overlapping two-tier word
+    int matchingText;     // Matched words whose text agrees
+    int fullPageLabels;   // Full-page words containing letters
+    int matchedLabels;    // Label words found with the same text
+    int layoutWords;      // Words found by the low-resolution pass
+    int refinedRuns;      // Runs re-read at full resolution
+    double boxRecall;     // matchedWords / fullPageWords
+    double textAgreement; // matchingText / matchedWords
+    double labelRecall;   // matchedLabels / fullPageLabels
+    
+    OcrModeComparison()
+        : fullPageTimeMs(0.0), twoTierTimeMs(0.0), fullPageWords(0), twoTierWords(0),
+          matchedWords(0), matchingText(0), fullPageLabels(0), matchedLabels(0),
+          layoutWords(0), refinedRuns(0), boxRecall(0.0), textAgreement(0.0), labelRecall(0.0) {}
+};
+
 /**
  * @brief Test runner for magic detection pipeline
  * 
@@ -54,6 +83,19 @@ public:
      */
     void setDetectionMethod(const QString& method);
     
+    /**
+     * @brief Set OCR recognition mode used by the OCR-first pipeline
+     * @param mode TWO_TIER_RECOGNITION (default) or FULL_PAGE_RECOGNITION
+     */
+    void setRecognitionMode(OcrTextExtractor::RecognitionMode mode);
+    
+    /**
+     * @brief Run both OCR modes on a form and compare words against the full-page pass
+     * @param formId Form ID to test
+     * @return Timing and accuracy comparison
+     */
+    OcrModeComparison compareRecognitionModes(const QString& formId);
+    
     /**
      * @brief Get instrumentation instance
      * @return Instrumentation instance
@@ -72,6 +114,11 @@ public:
      * @return Ground truth annotation
      */
     GroundTruthAnnotation getGroundTruth(const QString& formId) const;
+    
+    /**
+     * @brief Get IDs of all forms with ground truth
+     */
+    QList<QString> getAvailableForms() const { return dataManager.getAvailableForms(); }
 
 private:
     TestDataManager dataManager;
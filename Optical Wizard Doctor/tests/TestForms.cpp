@@ -0,0 +1,48 @@
+#include "TestForms.h"
+#include <opencv2/imgproc.hpp>
+#include <string>
+
+namespace ocr_orc {
+
+cv::Mat TestForms::makeBoxForm(int seed) {
+    cv::Mat page(1650, 1275, CV_8UC1, cv::Scalar(255));
+    cv::RNG rng(seed);
+
+    cv::rectangle(page, cv::Rect(60, 60, 1155, 1530), cv::Scalar(0), 3);
+    int y = 100;
+    while (y < 1500) {
+        int h = rng.uniform(40, 140);
+        int columns = rng.uniform(1, 5);
+        int x = 80;
+        for (int c = 0; c < columns; ++c) {
+            int w = (1100 / columns) - 20;
+            cv::rectangle(page, cv::Rect(x, y, w, h), cv::Scalar(0), 2);
+            x += w + 20;
+        }
+        y += h + rng.uniform(20, 80);
+    }
+    return page;
+}
+
+cv::Mat TestForms::makeLabelledForm(int seed) {
+    cv::Mat page(2200, 1700, CV_8UC3, cv::Scalar(255, 255, 255));
+    cv::RNG rng(seed);
+
+    cv::rectangle(page, cv::Rect(80, 80, 1540, 2040), cv::Scalar(0, 0, 0), 3);
+    for (int i = 0; i < 40; ++i) {
+        int x = rng.uniform(120, 1300);
+        int y = rng.uniform(150, 2000);
+        int w = rng.uniform(120, 300);
+        int h = rng.uniform(40, 90);
+        cv::rectangle(page, cv::Rect(x, y, w, h), cv::Scalar(0, 0, 0), 2);
+        std::string label = "Field " + std::to_string(seed) + "-" + std::to_string(i * 37 % 101);
+        cv::putText(page, label, cv::Point(x + 5, y - 8), cv::FONT_HERSHEY_SIMPLEX,
+                    0.8, cv::Scalar(0, 0, 0), 2);
+    }
+    for (int y = 300; y < 2000; y += 170) {
+        cv::line(page, cv::Point(100, y), cv::Point(rng.uniform(600, 1600), y), cv::Scalar(0, 0, 0), 2);
+    }
+    return page;
+}
+
+} // namespace ocr_orc
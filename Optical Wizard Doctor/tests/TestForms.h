@@ -0,0 +1,34 @@
+#ifndef TEST_FORMS_H
+#define TEST_FORMS_H
+
+#include <opencv2/core.hpp>
+
+namespace ocr_orc {
+
+/**
+ * @brief Synthetic form pages shared by the template tests
+ *
+ * Both layouts are deterministic for a seed, and different seeds give
+ * different layouts.
+ */
+class TestForms {
+public:
+    /**
+     * @brief Letter page at 150 DPI with rows of boxes (grayscale)
+     */
+    static cv::Mat makeBoxForm(int seed);
+
+    /**
+     * @brief Letter page at 200 DPI with labelled boxes and ruled lines (BGR)
+     *
+     * The labels give feature matchers texture beyond the ruled structure.
+     */
+    static cv::Mat makeLabelledForm(int seed);
+
+private:
+    TestForms() = delete;
+};
+
+} // namespace ocr_orc
+
+#endif // TEST_FORMS_H
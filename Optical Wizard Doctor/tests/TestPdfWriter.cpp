@@ -0,0 +1,48 @@
+#include "TestPdfWriter.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+
+namespace ocr_orc {
+
+bool TestPdfWriter::writeOnePagePdf(const QString& filePath, const QSizeF& pageSizePoints,
+                                    const QRectF& blackRectPoints) {
+    // PDF user space has its origin at the bottom-left
+    const QByteArray content = QByteArray("0 0 0 rg ") +
+        QByteArray::number(blackRectPoints.x()) + ' ' +
+        QByteArray::number(pageSizePoints.height() - blackRectPoints.bottom()) + ' ' +
+        QByteArray::number(blackRectPoints.width()) + ' ' +
+        QByteArray::number(blackRectPoints.height()) + " re f\n";
+
+    const QList<QByteArray> objects = {
+        "<< /Type /Catalog /Pages 2 0 R >>",
+        "<< /Type /Pages /Kids [3 0 R] /Count 1 >>",
+        "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " + QByteArray::number(pageSizePoints.width()) + ' ' +
+            QByteArray::number(pageSizePoints.height()) + "] /Resources << >> /Contents 4 0 R >>",
+        "<< /Length " + QByteArray::number(content.size()) + " >>\nstream\n" + content + "endstream",
+    };
+
+    QByteArray pdf("%PDF-1.4\n");
+    QList<qsizetype> offsets;
+    for (int i = 0; i < objects.size(); ++i) {
+        offsets.append(pdf.size());
+        pdf += QByteArray::number(i + 1) + " 0 obj\n" + objects[i] + "\nendobj\n";
+    }
+
+    const qsizetype xrefOffset = pdf.size();
+    pdf += "xref\n0 " + QByteArray::number(objects.size() + 1) + "\n";
+    pdf += "0000000000 65535 f \n";
+    for (qsizetype offset : offsets) {
+        pdf += QByteArray::number(offset).rightJustified(10, '0') + " 00000 n \n";
+    }
+    pdf += "trailer\n<< /Size " + QByteArray::number(objects.size() + 1) + " /Root 1 0 R >>\n";
+    pdf += "startxref\n" + QByteArray::number(xrefOffset) + "\n%%EOF\n";
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    return file.write(pdf) == pdf.size();
+}
+
+} // namespace ocr_orc
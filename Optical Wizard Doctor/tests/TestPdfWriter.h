@@ -0,0 +1,31 @@
+#ifndef TEST_PDF_WRITER_H
+#define TEST_PDF_WRITER_H
+
+#include <QtCore/QRectF>
+#include <QtCore/QSizeF>
+#include <QtCore/QString>
+
+namespace ocr_orc {
+
+/**
+ * @brief Writes small synthetic PDFs for tests that need Poppler input
+ */
+class TestPdfWriter {
+public:
+    /**
+     * @brief Write a one-page PDF with a black filled rectangle
+     * @param filePath Where to write the file
+     * @param pageSizePoints Page (MediaBox) size in points
+     * @param blackRectPoints Filled rectangle in points, origin at the top-left of the page
+     * @return true if the file was written
+     */
+    static bool writeOnePagePdf(const QString& filePath, const QSizeF& pageSizePoints,
+                                const QRectF& blackRectPoints);
+
+private:
+    TestPdfWriter() = delete;
+};
+
+} // namespace ocr_orc
+
+#endif // TEST_PDF_WRITER_H
@@ -23,6 +23,7 @@ private slots:
     void testCacheWithMultipleRegions();
     void testCacheAfterZoom();
     void testCacheAfterPan();
+    void testUpdateRegion();
 
 private:
     DocumentState* documentState;
@@ -53,63 +54,43 @@ void TestCanvasCoordinateCache::cleanupTestCase() {
 
 void TestCanvasCoordinateCache::testCacheInitialization() {
     QVERIFY(!cache->isValid());
-    QVERIFY(cache->getAllCachedCoordinates().isEmpty());
+    QVERIFY(cache->getAllImageRects().isEmpty());
 }
 
 void TestCanvasCoordinateCache::testCacheUpdate() {
-    double scaleFactor = 0.5;
-    QPointF imageOffset(100.0, 50.0);
-    double zoomLevel = 1.0;
-    
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor, imageOffset, zoomLevel);
+    cache->updateCache(documentState, testImage.width(), testImage.height());
     
     QVERIFY(cache->isValid());
-    QCOMPARE(cache->getAllCachedCoordinates().size(), 2);
-    QVERIFY(cache->getAllCachedCoordinates().contains("Region1"));
-    QVERIFY(cache->getAllCachedCoordinates().contains("Region2"));
+    QCOMPARE(cache->getAllImageRects().size(), 2);
+    QVERIFY(cache->getAllImageRects().contains("Region1"));
+    QVERIFY(cache->getAllImageRects().contains("Region2"));
 }
 
 void TestCanvasCoordinateCache::testCacheInvalidation() {
     cache->invalidate();
     QVERIFY(!cache->isValid());
-    QVERIFY(cache->getAllCachedCoordinates().isEmpty());
+    QVERIFY(cache->getAllImageRects().isEmpty());
 }
 
 void TestCanvasCoordinateCache::testNeedsUpdate() {
     // Cache should need update when invalid
-    QVERIFY(cache->needsUpdate(1.0, QPointF(0, 0), testImage.size()));
+    QVERIFY(cache->needsUpdate(testImage.size()));
     
     // Update cache
-    double scaleFactor = 0.5;
-    QPointF imageOffset(100.0, 50.0);
-    double zoomLevel = 1.0;
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor, imageOffset, zoomLevel);
-    
-    // Should not need update with same parameters
-    QVERIFY(!cache->needsUpdate(zoomLevel, imageOffset, testImage.size()));
+    cache->updateCache(documentState, testImage.width(), testImage.height());
     
-    // Should need update when zoom changes
-    QVERIFY(cache->needsUpdate(2.0, imageOffset, testImage.size()));
-    
-    // Should need update when offset changes
-    QVERIFY(cache->needsUpdate(zoomLevel, QPointF(200.0, 100.0), testImage.size()));
+    // Should not need update with same image size (zoom and pan don't matter)
+    QVERIFY(!cache->needsUpdate(testImage.size()));
     
     // Should need update when image size changes
-    QVERIFY(cache->needsUpdate(zoomLevel, imageOffset, QSize(3000, 4000)));
+    QVERIFY(cache->needsUpdate(QSize(3000, 4000)));
 }
 
 void TestCanvasCoordinateCache::testGetCachedCoordinates() {
     double scaleFactor = 0.5;
     QPointF imageOffset(100.0, 50.0);
-    double zoomLevel = 1.0;
     
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor, imageOffset, zoomLevel);
+    cache->updateCache(documentState, testImage.width(), testImage.height());
     
     // Get cached coordinates
     QRectF coords1 = cache->getCachedCoordinates("Region1", documentState,
@@ -120,6 +101,15 @@ void TestCanvasCoordinateCache::testGetCachedCoordinates() {
     QVERIFY(coords1.width() > 0);
     QVERIFY(coords1.height() > 0);
     
+    // Same result as the direct conversion: image rect 500,300 - 700,600 at 0.5 + offset
+    CanvasCoords expected = CoordinateSystem::normalizedToCanvas(
+        documentState->getRegion("Region1").normalizedCoords,
+        testImage.width(), testImage.height(), scaleFactor, imageOffset);
+    QCOMPARE(coords1.left(), expected.x1);
+    QCOMPARE(coords1.top(), expected.y1);
+    QCOMPARE(coords1.right(), expected.x2);
+    QCOMPARE(coords1.bottom(), expected.y2);
+    
     // Get coordinates for non-existent region (should calculate on the fly)
     QRectF coords3 = cache->getCachedCoordinates("NonExistent", documentState,
                                                  testImage.width(), testImage.height(),
@@ -135,44 +125,33 @@ void TestCanvasCoordinateCache::testCacheWithMultipleRegions() {
     documentState->addRegion("Region3", RegionData("Region3", norm3, "green"));
     documentState->addRegion("Region4", RegionData("Region4", norm4, "yellow"));
     
-    double scaleFactor = 0.5;
-    QPointF imageOffset(100.0, 50.0);
-    double zoomLevel = 1.0;
-    
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor, imageOffset, zoomLevel);
+    cache->updateCache(documentState, testImage.width(), testImage.height());
     
-    QCOMPARE(cache->getAllCachedCoordinates().size(), 4);
-    QVERIFY(cache->getAllCachedCoordinates().contains("Region1"));
-    QVERIFY(cache->getAllCachedCoordinates().contains("Region2"));
-    QVERIFY(cache->getAllCachedCoordinates().contains("Region3"));
-    QVERIFY(cache->getAllCachedCoordinates().contains("Region4"));
+    QCOMPARE(cache->getAllImageRects().size(), 4);
+    QVERIFY(cache->getAllImageRects().contains("Region1"));
+    QVERIFY(cache->getAllImageRects().contains("Region2"));
+    QVERIFY(cache->getAllImageRects().contains("Region3"));
+    QVERIFY(cache->getAllImageRects().contains("Region4"));
 }
 
 void TestCanvasCoordinateCache::testCacheAfterZoom() {
-    double scaleFactor1 = 0.5;
     QPointF imageOffset(100.0, 50.0);
-    double zoomLevel1 = 1.0;
     
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor1, imageOffset, zoomLevel1);
+    cache->updateCache(documentState, testImage.width(), testImage.height());
+    QRectF imageRect = cache->getAllImageRects().value("Region1");
     
     QRectF coords1 = cache->getCachedCoordinates("Region1", documentState,
                                                  testImage.width(), testImage.height(),
-                                                 scaleFactor1, imageOffset);
-    
-    // Zoom in
-    double zoomLevel2 = 2.0;
-    double scaleFactor2 = 1.0;
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor2, imageOffset, zoomLevel2);
+                                                 0.5, imageOffset);
     
+    // Zoom in: only the view transform changes
     QRectF coords2 = cache->getCachedCoordinates("Region1", documentState,
                                                  testImage.width(), testImage.height(),
-                                                 scaleFactor2, imageOffset);
+                                                 1.0, imageOffset);
+    
+    // Cache is untouched by zoom
+    QVERIFY(!cache->needsUpdate(testImage.size()));
+    QCOMPARE(cache->getAllImageRects().value("Region1"), imageRect);
     
     // Coordinates should be different after zoom
     QVERIFY(coords1 != coords2);
@@ -183,31 +162,46 @@ void TestCanvasCoordinateCache::testCacheAfterZoom() {
 
 void TestCanvasCoordinateCache::testCacheAfterPan() {
     double scaleFactor = 0.5;
-    QPointF imageOffset1(100.0, 50.0);
-    double zoomLevel = 1.0;
     
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor, imageOffset1, zoomLevel);
+    cache->updateCache(documentState, testImage.width(), testImage.height());
     
     QRectF coords1 = cache->getCachedCoordinates("Region1", documentState,
                                                  testImage.width(), testImage.height(),
-                                                 scaleFactor, imageOffset1);
-    
-    // Pan (change offset)
-    QPointF imageOffset2(200.0, 150.0);
-    cache->updateCache(documentState, 
-                      testImage.width(), testImage.height(),
-                      scaleFactor, imageOffset2, zoomLevel);
+                                                 scaleFactor, QPointF(100.0, 50.0));
     
+    // Pan (change offset): only the view transform changes
     QRectF coords2 = cache->getCachedCoordinates("Region1", documentState,
                                                  testImage.width(), testImage.height(),
-                                                 scaleFactor, imageOffset2);
+                                                 scaleFactor, QPointF(200.0, 150.0));
     
-    // Coordinates should be different after pan
-    QVERIFY(coords1 != coords2);
-    // Pan should shift coordinates
-    QVERIFY(coords2.x() != coords1.x() || coords2.y() != coords1.y());
+    // Cache is untouched by pan
+    QVERIFY(!cache->needsUpdate(testImage.size()));
+    
+    // Pan should shift coordinates by exactly the offset delta
+    QCOMPARE(coords2.topLeft() - coords1.topLeft(), QPointF(100.0, 100.0));
+    QCOMPARE(coords2.size(), coords1.size());
+}
+
+void TestCanvasCoordinateCache::testUpdateRegion() {
+    cache->updateCache(documentState, testImage.width(), testImage.height());
+    
+    // Edit one region and patch just its entry
+    RegionData region = documentState->getRegion("Region2");
+    region.normalizedCoords = NormalizedCoords(0.60, 0.10, 0.70, 0.20);
+    documentState->addRegion("Region2", region);
+    cache->updateRegion("Region2", documentState, testImage.width(), testImage.height());
+    
+    QVERIFY(cache->isValid());
+    QCOMPARE(cache->getAllImageRects().value("Region2"), QRectF(1200.0, 300.0, 200.0, 300.0));
+    
+    // Removed regions drop out of the cache
+    documentState->removeRegion("Region2");
+    cache->updateRegion("Region2", documentState, testImage.width(), testImage.height());
+    QVERIFY(!cache->getAllImageRects().contains("Region2"));
+    
+    // Different image size can't be patched; cache invalidates instead
+    cache->updateRegion("Region1", documentState, 100, 100);
+    QVERIFY(!cache->isValid());
 }
 
 QTEST_MAIN(TestCanvasCoordinateCache)
@@ -0,0 +1,152 @@
+// Test file for CanvasLayerCache and CanvasRenderer::regionPaintBounds
+// Tests static layer reuse, overlay dirty rects and region paint bounds
+
+#include <QtTest/QtTest>
+#include "../src/ui/canvas/core/rendering/CanvasLayerCache.h"
+#include "../src/ui/canvas/core/rendering/CanvasRenderer.h"
+#include "../src/ui/canvas/core/coordinate/CanvasCoordinateCache.h"
+#include "../src/models/DocumentState.h"
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+
+using namespace ocr_orc;
+
+class TestCanvasLayerCache : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testWholePixelPanReusesLayer();
+    void testSubPixelPanRebuilds();
+    void testScaleChangeRebuilds();
+    void testInvalidateAndDetailTileRebuild();
+    void testOverlayDirtyRect();
+    void testRegionPaintBounds();
+
+private:
+    void paintAt(CanvasLayerCache& cache, double scaleFactor, const QPointF& imageOffset);
+    
+    CanvasRenderer renderer;
+    QImage page;
+};
+
+void TestCanvasLayerCache::initTestCase() {
+    page = QImage(200, 100, QImage::Format_RGB32);
+    page.fill(Qt::white);
+}
+
+void TestCanvasLayerCache::paintAt(CanvasLayerCache& cache, double scaleFactor, const QPointF& imageOffset) {
+    const QSize widgetSize(400, 300);
+    QImage target(widgetSize, QImage::Format_ARGB32_Premultiplied);
+    target.fill(Qt::transparent);
+    QPainter painter(&target);
+    // No document state: the layer holds the page image only
+    cache.paint(painter, QRect(QPoint(0, 0), widgetSize), &renderer, nullptr, nullptr, page,
+                scaleFactor, imageOffset, widgetSize, 1.0, QSet<QString>());
+}
+
+void TestCanvasLayerCache::testWholePixelPanReusesLayer() {
+    CanvasLayerCache cache;
+    paintAt(cache, 1.0, QPointF(10.25, 20.5));
+    QVERIFY(cache.isValid());
+    QCOMPARE(cache.getRebuildCount(), 1);
+    
+    // Same sub-pixel phase: the layer is blitted at the new position
+    paintAt(cache, 1.0, QPointF(37.25, 5.5));
+    paintAt(cache, 1.0, QPointF(-12.75, 80.5));
+    QCOMPARE(cache.getRebuildCount(), 1);
+}
+
+void TestCanvasLayerCache::testSubPixelPanRebuilds() {
+    CanvasLayerCache cache;
+    paintAt(cache, 1.0, QPointF(10.0, 20.0));
+    paintAt(cache, 1.0, QPointF(10.5, 20.0));
+    QCOMPARE(cache.getRebuildCount(), 2);
+}
+
+void TestCanvasLayerCache::testScaleChangeRebuilds() {
+    CanvasLayerCache cache;
+    paintAt(cache, 1.0, QPointF(0.0, 0.0));
+    paintAt(cache, 1.5, QPointF(0.0, 0.0));
+    QCOMPARE(cache.getRebuildCount(), 2);
+    
+    // Back at a known scale still needs a rebuild: only one layer is kept
+    paintAt(cache, 1.0, QPointF(0.0, 0.0));
+    QCOMPARE(cache.getRebuildCount(), 3);
+}
+
+void TestCanvasLayerCache::testInvalidateAndDetailTileRebuild() {
+    CanvasLayerCache cache;
+    paintAt(cache, 2.0, QPointF(0.0, 0.0));
+    cache.invalidate();
+    QVERIFY(!cache.isValid());
+    paintAt(cache, 2.0, QPointF(0.0, 0.0));
+    QCOMPARE(cache.getRebuildCount(), 2);
+    
+    QImage tile(100, 50, QImage::Format_RGB32);
+    tile.fill(Qt::black);
+    cache.setDetailTile(tile, QRectF(0.0, 0.0, 0.5, 0.5));
+    QVERIFY(cache.hasDetailTile());
+    paintAt(cache, 2.0, QPointF(0.0, 0.0));
+    QCOMPARE(cache.getRebuildCount(), 3);
+    
+    // Clearing a tile that is not set changes nothing
+    cache.setDetailTile(QImage(), QRectF());
+    paintAt(cache, 2.0, QPointF(0.0, 0.0));
+    cache.setDetailTile(QImage(), QRectF());
+    paintAt(cache, 2.0, QPointF(0.0, 0.0));
+    QCOMPARE(cache.getRebuildCount(), 4);
+}
+
+void TestCanvasLayerCache::testOverlayDirtyRect() {
+    CanvasLayerCache::OverlaySnapshot before;
+    before.insert("Name", qMakePair(QRectF(10, 10, 50, 20), 1));
+    before.insert("Date", qMakePair(QRectF(100, 10, 40, 20), 0));
+    
+    // Nothing changed: nothing to repaint
+    QVERIFY(CanvasLayerCache::overlayDirtyRect(before, before).isEmpty());
+    
+    // "Date" moved, "Box" appeared; "Name" is untouched
+    CanvasLayerCache::OverlaySnapshot after = before;
+    after.insert("Date", qMakePair(QRectF(120, 40, 40, 20), 0));
+    after.insert("Box", qMakePair(QRectF(300.5, 200.5, 10, 10), 0));
+    QRect dirty = CanvasLayerCache::overlayDirtyRect(before, after);
+    QCOMPARE(dirty, QRect(100, 10, 60, 50) | QRect(300, 200, 11, 11));
+    
+    // A state change alone (e.g. hover -> selected) repaints the item in place
+    CanvasLayerCache::OverlaySnapshot restyled = before;
+    restyled.insert("Name", qMakePair(QRectF(10, 10, 50, 20), 2));
+    QCOMPARE(CanvasLayerCache::overlayDirtyRect(before, restyled), QRect(10, 10, 50, 20));
+    
+    // A removed item repaints where it was
+    CanvasLayerCache::OverlaySnapshot removed = before;
+    removed.remove("Date");
+    QCOMPARE(CanvasLayerCache::overlayDirtyRect(before, removed), QRect(100, 10, 40, 20));
+}
+
+void TestCanvasLayerCache::testRegionPaintBounds() {
+    RegionData region("Field", NormalizedCoords(0.1, 0.1, 0.2, 0.2));
+    const QRectF canvasRect(100, 100, 80, 40);
+    
+    QRectF plain = renderer.regionPaintBounds(region, canvasRect, 0.0, false, false);
+    QVERIFY(plain.contains(canvasRect));
+    // Label sits above the region
+    QVERIFY(plain.top() < canvasRect.top() - 5);
+    
+    // Handles reach past the shape
+    QRectF withHandles = renderer.regionPaintBounds(region, canvasRect, 0.0, true, true);
+    QVERIFY(withHandles.contains(plain));
+    QVERIFY(withHandles.left() < plain.left());
+    
+    // Rotation widens the box around the rotated corners
+    QRectF rotated = renderer.regionPaintBounds(region, canvasRect, 45.0, false, false);
+    QTransform rotation;
+    rotation.translate(canvasRect.center().x(), canvasRect.center().y());
+    rotation.rotate(45.0);
+    rotation.translate(-canvasRect.center().x(), -canvasRect.center().y());
+    QVERIFY(rotated.contains(rotation.mapRect(canvasRect)));
+    QVERIFY(rotated.height() > plain.height());
+}
+
+QTEST_MAIN(TestCanvasLayerCache)
+#include "test_canvas_layer_cache.moc"
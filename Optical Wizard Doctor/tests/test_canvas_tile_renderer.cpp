@@ -0,0 +1,170 @@
+// Test file for CanvasTileRenderer
+// Checks which part of the page a zoomed-in view asks Poppler to re-render,
+// how the rendered crop snaps to pixels, and when tiles may be requested at all
+
+#include <QtTest/QtTest>
+#include "../src/ui/canvas/core/rendering/CanvasTileRenderer.h"
+#include "../src/utils/PdfLoader.h"
+#include "../src/models/DocumentState.h"
+#include "../src/core/Constants.h"
+#include "TestPdfWriter.h"
+#include <QtCore/QTemporaryDir>
+
+using namespace ocr_orc;
+
+class TestCanvasTileRenderer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testNoTileAtRasterResolution();
+    void testZoomedInViewCoversViewport();
+    void testHighDpiScreenNeedsTile();
+    void testDpiIsCapped();
+    void testViewportClippedToPage();
+    void testMissingPdfEmitsNothing();
+    void testRegionSnappedOutward();
+    void testRegionPixelsMatchPage();
+    void testTileOnlyForRasterRenderedFromPdf();
+
+private:
+    const QSize pageSize = QSize(1275, 1650);   // Letter at DEFAULT_DPI
+    const QSize widgetSize = QSize(800, 600);
+    
+    QTemporaryDir tempDir;
+    QString letterPdf;  // 612x792 pt, black rectangle at (72, 72) 144x36 pt
+};
+
+void TestCanvasTileRenderer::initTestCase() {
+    QVERIFY(tempDir.isValid());
+    letterPdf = tempDir.filePath("letter.pdf");
+    QVERIFY(TestPdfWriter::writeOnePagePdf(letterPdf, QSizeF(612, 792), QRectF(72, 72, 144, 36)));
+}
+
+void TestCanvasTileRenderer::testNoTileAtRasterResolution() {
+    QRectF rect;
+    double dpi = 0.0;
+    QVERIFY(!CanvasTileRenderer::computeTileRequest(pageSize, 1.0, QPointF(0.0, 0.0), widgetSize, 1.0, rect, dpi));
+    QVERIFY(!CanvasTileRenderer::computeTileRequest(pageSize, 0.5, QPointF(0.0, 0.0), widgetSize, 2.0, rect, dpi));
+}
+
+void TestCanvasTileRenderer::testZoomedInViewCoversViewport() {
+    QRectF rect;
+    double dpi = 0.0;
+    // Scale 2, page scrolled so raster pixel (100, 200) is at the widget's top-left
+    QVERIFY(CanvasTileRenderer::computeTileRequest(pageSize, 2.0, QPointF(-200.0, -400.0), widgetSize, 1.0,
+                                                   rect, dpi));
+    QCOMPARE(dpi, PdfConstants::DEFAULT_DPI * 2.0);
+    QCOMPARE(rect.x(), 100.0 / pageSize.width());
+    QCOMPARE(rect.y(), 200.0 / pageSize.height());
+    QCOMPARE(rect.width(), 400.0 / pageSize.width());
+    QCOMPARE(rect.height(), 300.0 / pageSize.height());
+}
+
+void TestCanvasTileRenderer::testHighDpiScreenNeedsTile() {
+    QRectF rect;
+    double dpi = 0.0;
+    QVERIFY(CanvasTileRenderer::computeTileRequest(pageSize, 1.0, QPointF(0.0, 0.0), widgetSize, 2.0, rect, dpi));
+    QCOMPARE(dpi, PdfConstants::DEFAULT_DPI * 2.0);
+}
+
+void TestCanvasTileRenderer::testDpiIsCapped() {
+    QRectF rect;
+    double dpi = 0.0;
+    QVERIFY(CanvasTileRenderer::computeTileRequest(pageSize, CanvasConstants::MAX_ZOOM, QPointF(-5000.0, -5000.0),
+                                                   widgetSize, 2.0, rect, dpi));
+    QCOMPARE(dpi, static_cast<double>(PdfConstants::MAX_TILE_DPI));
+}
+
+void TestCanvasTileRenderer::testViewportClippedToPage() {
+    QRectF rect;
+    double dpi = 0.0;
+    // Page starts 100px into the widget: the visible part begins at the page edge
+    QVERIFY(CanvasTileRenderer::computeTileRequest(pageSize, 2.0, QPointF(100.0, 0.0), widgetSize, 1.0,
+                                                   rect, dpi));
+    QCOMPARE(rect.x(), 0.0);
+    QCOMPARE(rect.width(), 350.0 / pageSize.width());
+
+    // Page scrolled entirely out of view
+    QVERIFY(!CanvasTileRenderer::computeTileRequest(pageSize, 2.0, QPointF(-10000.0, 0.0), widgetSize, 1.0,
+                                                    rect, dpi));
+}
+
+void TestCanvasTileRenderer::testMissingPdfEmitsNothing() {
+    QVERIFY(PdfLoader::renderFirstPageRegion("/nonexistent/file.pdf", QRectF(0.0, 0.0, 0.5, 0.5), 300.0).isNull());
+
+    CanvasTileRenderer renderer;
+    QSignalSpy spy(&renderer, &CanvasTileRenderer::tileReady);
+    renderer.requestTile("/nonexistent/file.pdf", QRectF(0.0, 0.0, 0.5, 0.5), 300.0);
+    QVERIFY(!spy.wait(200));
+}
+
+void TestCanvasTileRenderer::testRegionSnappedOutward() {
+    // At 144 DPI the page is 1224x1584 px; the request edges fall between pixels
+    const double dpi = 144.0;
+    const QRectF requested(0.1003, 0.2003, 0.2004, 0.1998);  // 122.77..368.06 x 317.28..633.76 px
+    QRectF rendered;
+    QImage tile = PdfLoader::renderFirstPageRegion(letterPdf, requested, dpi, &rendered);
+    QVERIFY(!tile.isNull());
+
+    // Left/top floor, right/bottom ceil
+    QCOMPARE(tile.size(), QSize(369 - 122, 634 - 317));
+    QCOMPARE(rendered.x(), 122.0 / 1224.0);
+    QCOMPARE(rendered.y(), 317.0 / 1584.0);
+    QCOMPARE(rendered.width(), 247.0 / 1224.0);
+    QCOMPARE(rendered.height(), 317.0 / 1584.0);
+    QVERIFY(rendered.contains(requested));
+
+    // A request past the page edge is clipped to the page
+    tile = PdfLoader::renderFirstPageRegion(letterPdf, QRectF(0.9, 0.9, 0.5, 0.5), dpi, &rendered);
+    QVERIFY(!tile.isNull());
+    QCOMPARE(tile.size(), QSize(1224 - 1101, 1584 - 1425));
+    QCOMPARE(rendered.right(), 1.0);
+    QCOMPARE(rendered.bottom(), 1.0);
+}
+
+void TestCanvasTileRenderer::testRegionPixelsMatchPage() {
+    // Top-left quarter at 144 DPI: the rectangle spans 144..432 x 144..216 px
+    QRectF rendered;
+    QImage tile = PdfLoader::renderFirstPageRegion(letterPdf, QRectF(0.0, 0.0, 0.5, 0.25), 144.0, &rendered);
+    QVERIFY(!tile.isNull());
+    QCOMPARE(tile.size(), QSize(612, 396));
+    QCOMPARE(rendered, QRectF(0.0, 0.0, 0.5, 0.25));
+    QVERIFY(qGray(tile.pixel(288, 180)) < 64);
+    QVERIFY(qGray(tile.pixel(100, 100)) > 192);
+    QVERIFY(qGray(tile.pixel(288, 240)) > 192);
+
+    // The renderer emits the same crop and snapped rect
+    CanvasTileRenderer renderer;
+    QSignalSpy spy(&renderer, &CanvasTileRenderer::tileReady);
+    const int requestId = renderer.requestTile(letterPdf, QRectF(0.1003, 0.2003, 0.2004, 0.1998), 144.0);
+    QVERIFY(spy.wait(10000));
+    QCOMPARE(spy.at(0).at(0).toInt(), requestId);
+    QCOMPARE(spy.at(0).at(1).value<QImage>().size(), QSize(247, 317));
+    QCOMPARE(spy.at(0).at(2).toRectF(), QRectF(122.0 / 1224.0, 317.0 / 1584.0, 247.0 / 1224.0, 317.0 / 1584.0));
+}
+
+void TestCanvasTileRenderer::testTileOnlyForRasterRenderedFromPdf() {
+    DocumentState state;
+    state.pdfPath = letterPdf;
+    state.image = QImage(pageSize, QImage::Format_ARGB32);
+    QVERIFY(!state.isImageRenderedFromPdf());  // e.g. a raster imported from a project
+
+    state.imageSourcePdf = letterPdf;
+    QVERIFY(state.isImageRenderedFromPdf());
+
+    // A JSON import points pdfPath elsewhere but keeps the raster
+    state.pdfPath = tempDir.filePath("other.pdf");
+    QVERIFY(!state.isImageRenderedFromPdf());
+
+    state.pdfPath = letterPdf;
+    state.setImage(QImage(pageSize, QImage::Format_ARGB32));
+    QVERIFY(!state.isImageRenderedFromPdf());
+
+    state.imageSourcePdf = letterPdf;
+    state.clear();
+    QVERIFY(!state.isImageRenderedFromPdf());
+}
+
+QTEST_MAIN(TestCanvasTileRenderer)
+#include "test_canvas_tile_renderer.moc"
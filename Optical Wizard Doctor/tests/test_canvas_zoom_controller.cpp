@@ -3,7 +3,6 @@
 
 #include <QtTest/QtTest>
 #include "../src/ui/canvas/core/zoom/CanvasZoomController.h"
-#include "../src/ui/canvas/core/coordinate/CanvasCoordinateCache.h"
 #include "../src/models/DocumentState.h"
 #include <QtGui/QImage>
 
@@ -27,7 +26,6 @@ private slots:
 private:
     DocumentState* documentState;
     CanvasZoomController* zoomController;
-    CanvasCoordinateCache* coordinateCache;
     QImage testImage;
     const int canvasWidth = 800;
     const int canvasHeight = 600;
@@ -36,7 +34,6 @@ private:
 void TestCanvasZoomController::initTestCase() {
     documentState = new DocumentState();
     zoomController = new CanvasZoomController();
-    coordinateCache = new CanvasCoordinateCache();
     
     // Create test image
     testImage = QImage(2000, 3000, QImage::Format_RGB32);
@@ -47,7 +44,6 @@ void TestCanvasZoomController::initTestCase() {
 
 void TestCanvasZoomController::cleanupTestCase() {
     delete zoomController;
-    delete coordinateCache;
     delete documentState;
 }
 
@@ -80,7 +76,7 @@ void TestCanvasZoomController::testZoomIn() {
     
     double initialZoom = documentState->zoomLevel;
     zoomController->zoomIn(documentState, testImage, canvasWidth, canvasHeight,
-                          scaleFactor, imageOffset, coordinateCache);
+                          scaleFactor, imageOffset);
     
     // Zoom should increase
     QVERIFY(documentState->zoomLevel > initialZoom);
@@ -94,7 +90,7 @@ void TestCanvasZoomController::testZoomOut() {
     
     double initialZoom = documentState->zoomLevel;
     zoomController->zoomOut(documentState, testImage, canvasWidth, canvasHeight,
-                           scaleFactor, imageOffset, coordinateCache);
+                           scaleFactor, imageOffset);
     
     // Zoom should decrease
     QVERIFY(documentState->zoomLevel < initialZoom);
@@ -107,7 +103,7 @@ void TestCanvasZoomController::testZoomReset() {
     documentState->zoomLevel = 3.0;
     
     zoomController->zoomReset(documentState, testImage, canvasWidth, canvasHeight,
-                             scaleFactor, imageOffset, coordinateCache);
+                             scaleFactor, imageOffset);
     
     // Zoom should be reset to 1.0
     QCOMPARE(documentState->zoomLevel, 1.0);
@@ -121,7 +117,7 @@ void TestCanvasZoomController::testSetZoom() {
     double targetZoom = 2.5;
     zoomController->setZoom(targetZoom, documentState, testImage,
                             canvasWidth, canvasHeight,
-                            scaleFactor, imageOffset, coordinateCache);
+                            scaleFactor, imageOffset);
     
     // Zoom should be set to target
     QCOMPARE(documentState->zoomLevel, targetZoom);
@@ -138,7 +134,7 @@ void TestCanvasZoomController::testSetZoomAtPoint() {
     double initialOffset = imageOffset.x();
     zoomController->setZoomAtPoint(targetZoom, widgetPos, documentState, testImage,
                                   canvasWidth, canvasHeight,
-                                  scaleFactor, imageOffset, coordinateCache);
+                                  scaleFactor, imageOffset);
     
     // Zoom should be set
     QCOMPARE(documentState->zoomLevel, targetZoom);
@@ -0,0 +1,166 @@
+// Test file for ConcurrencyGovernor
+// Checks the per-subsystem split, detection leases and pinned (batch) allocations
+
+#include <QtTest/QtTest>
+#include "../src/utils/ConcurrencyGovernor.h"
+#include <QtCore/QThreadPool>
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace ocr_orc;
+
+class TestConcurrencyGovernor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testIdleAllocation();
+    void testSplitsCoresBetweenDetections();
+    void testNestedLeasesCountOnce();
+    void testLeaseAppliesAllocation();
+    void testSingleDetectionKeepsOpenCvThreads();
+    void testPinIgnoresWorkload();
+    void testEnvironmentPin();
+};
+
+void TestConcurrencyGovernor::testIdleAllocation() {
+    ConcurrencyGovernor::Allocation idle = ConcurrencyGovernor::computeAllocation(8, 0);
+    QCOMPARE(idle.opencvThreads, 8);
+    QCOMPARE(idle.globalPoolThreads, 8);
+    QCOMPARE(idle.stageWorkers, 8);
+    QCOMPARE(idle.tesseractThreads, 1);
+
+    // Nonsense core counts still give every subsystem a thread
+    ConcurrencyGovernor::Allocation none = ConcurrencyGovernor::computeAllocation(0, 0);
+    QCOMPARE(none.opencvThreads, 1);
+    QCOMPARE(none.stageWorkers, 1);
+}
+
+void TestConcurrencyGovernor::testSplitsCoresBetweenDetections() {
+    ConcurrencyGovernor::Allocation one = ConcurrencyGovernor::computeAllocation(8, 1);
+    QCOMPARE(one.stageWorkers, 8);
+    QCOMPARE(one.globalPoolThreads, ConcurrencyGovernor::MIN_GLOBAL_POOL_THREADS);
+
+    ConcurrencyGovernor::Allocation three = ConcurrencyGovernor::computeAllocation(8, 3);
+    QCOMPARE(three.stageWorkers, 2);
+    QCOMPARE(three.opencvThreads, 2);
+    QCOMPARE(three.globalPoolThreads, 2);
+
+    // More detections than cores: one worker each, never zero
+    ConcurrencyGovernor::Allocation crowded = ConcurrencyGovernor::computeAllocation(2, 4);
+    QCOMPARE(crowded.stageWorkers, 1);
+    QCOMPARE(crowded.opencvThreads, 1);
+    QCOMPARE(crowded.globalPoolThreads, 2);
+    QCOMPARE(crowded.tesseractThreads, 1);
+
+    // A single core still keeps the pool at one thread
+    QCOMPARE(ConcurrencyGovernor::computeAllocation(1, 1).globalPoolThreads, 1);
+}
+
+void TestConcurrencyGovernor::testNestedLeasesCountOnce() {
+    ConcurrencyGovernor& governor = ConcurrencyGovernor::instance();
+    const int before = governor.getActiveDetections();
+    {
+        ConcurrencyGovernor::DetectionLease outer;
+        QCOMPARE(governor.getActiveDetections(), before + 1);
+        {
+            ConcurrencyGovernor::DetectionLease nested;
+            QCOMPARE(governor.getActiveDetections(), before + 1);
+            QCOMPARE(nested.getAllocation(), outer.getAllocation());
+        }
+        QCOMPARE(governor.getActiveDetections(), before + 1);
+    }
+    QCOMPARE(governor.getActiveDetections(), before);
+}
+
+void TestConcurrencyGovernor::testLeaseAppliesAllocation() {
+    ConcurrencyGovernor& governor = ConcurrencyGovernor::instance();
+    const int cores = governor.getCoreCount();
+    {
+        ConcurrencyGovernor::DetectionLease lease;
+        QCOMPARE(lease.getAllocation(), ConcurrencyGovernor::computeAllocation(cores, 1));
+        QCOMPARE(governor.currentAllocation(), lease.getAllocation());
+        QCOMPARE(QThreadPool::globalInstance()->maxThreadCount(), lease.getAllocation().globalPoolThreads);
+    }
+    QCOMPARE(governor.currentAllocation(), ConcurrencyGovernor::computeAllocation(cores, 0));
+    QCOMPARE(QThreadPool::globalInstance()->maxThreadCount(), cores);
+}
+
+void TestConcurrencyGovernor::testSingleDetectionKeepsOpenCvThreads() {
+    // One detection on N cores must not serialise OpenCV for the whole process
+    for (int cores : {2, 4, 8, 16}) {
+        QCOMPARE(ConcurrencyGovernor::computeAllocation(cores, 1).opencvThreads, cores);
+    }
+
+    ConcurrencyGovernor& governor = ConcurrencyGovernor::instance();
+    const int cores = governor.getCoreCount();
+    {
+        ConcurrencyGovernor::DetectionLease lease;
+        QCOMPARE(lease.getAllocation().opencvThreads, cores);
+        QCOMPARE(cv::getNumThreads(), cores);
+    }
+    QCOMPARE(cv::getNumThreads(), cores);
+}
+
+void TestConcurrencyGovernor::testPinIgnoresWorkload() {
+    ConcurrencyGovernor& governor = ConcurrencyGovernor::instance();
+
+    ConcurrencyGovernor::Allocation fixed;
+    fixed.opencvThreads = 2;
+    fixed.tesseractThreads = 1;
+    fixed.globalPoolThreads = 3;
+    fixed.stageWorkers = 0;  // Clamped to one
+    governor.pin(fixed);
+    QVERIFY(governor.isPinned());
+
+    ConcurrencyGovernor::Allocation expected = fixed;
+    expected.stageWorkers = 1;
+    QCOMPARE(governor.currentAllocation(), expected);
+    {
+        // A second detection on another thread would normally halve the share
+        std::atomic<bool> leased{false};
+        std::atomic<bool> release{false};
+        ConcurrencyGovernor::Allocation secondAllocation;
+        std::thread other([&]() {
+            ConcurrencyGovernor::DetectionLease second;
+            secondAllocation = second.getAllocation();
+            leased = true;
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+        while (!leased.load()) {
+            std::this_thread::yield();
+        }
+
+        ConcurrencyGovernor::DetectionLease first;
+        const int activeDetections = governor.getActiveDetections();
+        const int poolThreads = QThreadPool::globalInstance()->maxThreadCount();
+        release = true;
+        other.join();
+
+        QCOMPARE(activeDetections, 2);
+        QCOMPARE(first.getAllocation(), expected);
+        QCOMPARE(secondAllocation, expected);
+        QCOMPARE(poolThreads, 3);
+    }
+    QCOMPARE(governor.currentAllocation(), expected);
+
+    governor.unpin();
+    QVERIFY(!governor.isPinned());
+    QCOMPARE(governor.currentAllocation(), ConcurrencyGovernor::computeAllocation(governor.getCoreCount(), 0));
+}
+
+void TestConcurrencyGovernor::testEnvironmentPin() {
+    ConcurrencyGovernor& governor = ConcurrencyGovernor::instance();
+    qputenv("OCR_ORC_THREADS", "4");
+    governor.configureFromEnvironment();
+    qunsetenv("OCR_ORC_THREADS");
+
+    QVERIFY(governor.isPinned());
+    QCOMPARE(governor.currentAllocation(), ConcurrencyGovernor::computeAllocation(4, 1));
+    governor.unpin();
+}
+
+QTEST_MAIN(TestConcurrencyGovernor)
+#include "test_concurrency_governor.moc"
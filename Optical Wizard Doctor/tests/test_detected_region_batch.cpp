@@ -0,0 +1,202 @@
+// Test file for DetectedRegionBatch
+// Checks the column batch and the index-based post-processing paths
+
+#include <QtTest/QtTest>
+#include "../src/utils/DetectedRegionBatch.h"
+#include "../src/utils/RegionNeighborGraph.h"
+#include "../src/utils/RegionDetector.h"
+#include "../src/utils/SpatialClusterer.h"
+#include "../src/utils/RegionValidator.h"
+#include "../src/utils/GroupInferencer.h"
+#include <QtCore/QList>
+#include <cmath>
+
+using namespace ocr_orc;
+
+class TestDetectedRegionBatch : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testColumns();
+    void testTypeCodes();
+    void testHorizontalClustersMatchListApi();
+    void testGridStructure();
+    void testValidatorIndexMatchesList();
+    void testNeighborGraphMatchesScan();
+    void testNeighborGraphEmpty();
+
+private:
+    static DetectedRegion makeRegion(double x, double y, double w, double h,
+                                     const QString& type = "unknown", double confidence = 0.8);
+    static QList<DetectedRegion> makeGrid(int rows, int cols);
+};
+
+DetectedRegion TestDetectedRegionBatch::makeRegion(double x, double y, double w, double h,
+                                                   const QString& type, double confidence) {
+    DetectedRegion region;
+    region.coords = NormalizedCoords(x, y, x + w, y + h);
+    region.confidence = confidence;
+    region.inferredType = type;
+    return region;
+}
+
+QList<DetectedRegion> TestDetectedRegionBatch::makeGrid(int rows, int cols) {
+    // Added in reverse so clustering has to sort
+    QList<DetectedRegion> regions;
+    for (int r = rows - 1; r >= 0; --r) {
+        for (int c = cols - 1; c >= 0; --c) {
+            regions.append(makeRegion(0.1 + c * 0.05, 0.1 + r * 0.05, 0.04, 0.03, "letters"));
+        }
+    }
+    return regions;
+}
+
+void TestDetectedRegionBatch::testColumns() {
+    QList<DetectedRegion> regions;
+    regions.append(makeRegion(0.1, 0.2, 0.2, 0.1, "numbers", 0.9));
+    DetectedRegion grouped = makeRegion(0.5, 0.5, 0.1, 0.1);
+    grouped.suggestedGroup = "Postalcode";
+    regions.append(grouped);
+
+    DetectedRegionBatch batch(regions);
+    QCOMPARE(batch.size(), 2);
+    QCOMPARE(batch.x1(0), 0.1);
+    QCOMPARE(batch.centerX(0), 0.2);
+    QCOMPARE(batch.centerY(0), 0.25);
+    QCOMPARE(batch.confidence(0), 0.9);
+    QVERIFY(!batch.hasSuggestedGroup(0));
+    QVERIFY(batch.hasSuggestedGroup(1));
+
+    // Refilling keeps rows aligned with the new list
+    batch.assign(regions.mid(1));
+    QCOMPARE(batch.size(), 1);
+    QVERIFY(batch.hasSuggestedGroup(0));
+}
+
+void TestDetectedRegionBatch::testTypeCodes() {
+    QList<DetectedRegion> regions;
+    regions.append(makeRegion(0.1, 0.1, 0.1, 0.1, "letters"));
+    regions.append(makeRegion(0.2, 0.1, 0.1, 0.1, "signature"));
+    regions.append(makeRegion(0.3, 0.1, 0.1, 0.1, "signature"));
+    regions.append(makeRegion(0.4, 0.1, 0.1, 0.1, "stamp"));
+
+    DetectedRegionBatch batch(regions);
+    QCOMPARE(batch.typeCode(0), static_cast<int>(REGION_TYPE_LETTERS));
+    QCOMPARE(batch.typeCode(1), batch.typeCode(2));
+    QVERIFY(batch.typeCode(1) != batch.typeCode(3));
+    QCOMPARE(batch.typeName(batch.typeCode(1)), QString("signature"));
+    QCOMPARE(batch.typeName(REGION_TYPE_UNKNOWN), QString("unknown"));
+}
+
+void TestDetectedRegionBatch::testHorizontalClustersMatchListApi() {
+    QList<DetectedRegion> regions = makeGrid(3, 4);
+
+    SpatialClusterer clusterer;
+    QList<QList<DetectedRegion>> rows = clusterer.clusterByHorizontalAlignment(regions, 0.01);
+
+    RegionNeighborGraph graph(regions);
+    const DetectedRegionBatch& batch = graph.getBatch();
+    RegionIndexClusters clusters;
+    clusterer.clusterIndicesByHorizontalAlignment(graph, 0.01, clusters);
+
+    QCOMPARE(clusters.clusterCount(), 3);
+    QCOMPARE(rows.size(), 3);
+    for (int r = 0; r < clusters.clusterCount(); ++r) {
+        QCOMPARE(clusters.clusterSize(r), 4);
+        QCOMPARE(static_cast<int>(rows[r].size()), 4);
+        const int* row = clusters.clusterBegin(r);
+        for (int c = 0; c < 4; ++c) {
+            QCOMPARE(regions[row[c]].coords.x1, rows[r][c].coords.x1);
+            QCOMPARE(regions[row[c]].coords.y1, rows[r][c].coords.y1);
+            if (c > 0) {
+                QVERIFY(batch.centerX(row[c]) > batch.centerX(row[c - 1]));
+            }
+        }
+    }
+}
+
+void TestDetectedRegionBatch::testGridStructure() {
+    QList<DetectedRegion> regions = makeGrid(3, 4);
+
+    SpatialClusterer clusterer;
+    RegionNeighborGraph graph(regions);
+    GridStructure grid = clusterer.detectGridStructure(graph, regions);
+    QCOMPARE(grid.rows, 3);
+    QCOMPARE(grid.cols, 4);
+    QCOMPARE(static_cast<int>(grid.gridCells.size()), 3);
+    QVERIFY(std::abs(grid.cellWidth - 0.04) < 1e-9);
+
+    GroupInferencer inferencer;
+    QCOMPARE(inferencer.inferGroupsFromSpatial(graph).size(), 3);
+    QCOMPARE(inferencer.inferGroupsFromSpatial(regions).size(), 3);
+}
+
+void TestDetectedRegionBatch::testValidatorIndexMatchesList() {
+    QList<DetectedRegion> regions = makeGrid(2, 3);
+    regions.append(makeRegion(0.9, 0.9, 0.05, 0.05, "numbers"));  // Isolated
+
+    RegionValidator validator;
+    DetectedRegionBatch batch(regions);
+    for (int i = 0; i < regions.size(); ++i) {
+        QCOMPARE(validator.validateRegion(batch, i), validator.validateRegion(regions[i], regions));
+    }
+
+    // The isolated region scores below the grid cells
+    QVERIFY(validator.validateRegion(batch, regions.size() - 1) < validator.validateRegion(batch, 0));
+}
+
+void TestDetectedRegionBatch::testNeighborGraphMatchesScan() {
+    // Dense grid plus scattered regions, so neighbours cross grid index cells
+    QList<DetectedRegion> regions = makeGrid(12, 15);
+    for (int i = 0; i < 40; ++i) {
+        regions.append(makeRegion(std::fmod(i * 0.137, 0.95), std::fmod(i * 0.291, 0.95), 0.02, 0.02));
+    }
+
+    RegionNeighborGraph graph(regions);
+    const DetectedRegionBatch& batch = graph.getBatch();
+    std::vector<int> neighbors;
+    for (double distance : {0.03, 0.05, 0.1, 0.3}) {
+        for (int i = 0; i < batch.size(); ++i) {
+            std::vector<int> expected;
+            for (int j = 0; j < batch.size(); ++j) {
+                double dx = batch.centerX(i) - batch.centerX(j);
+                double dy = batch.centerY(i) - batch.centerY(j);
+                if (j != i && dx * dx + dy * dy <= distance * distance) {
+                    expected.push_back(j);
+                }
+            }
+            graph.collectNeighbors(i, distance, neighbors);
+            QCOMPARE(neighbors, expected);
+        }
+    }
+
+    // Vertical clusters from the graph match the list API
+    SpatialClusterer clusterer;
+    RegionIndexClusters clusters;
+    clusterer.clusterIndicesByVerticalAlignment(graph, 0.01, clusters);
+    QList<QList<DetectedRegion>> columns = clusterer.clusterByVerticalAlignment(regions, 0.01);
+    QCOMPARE(clusters.clusterCount(), static_cast<int>(columns.size()));
+    for (int c = 0; c < clusters.clusterCount(); ++c) {
+        QCOMPARE(clusters.clusterSize(c), static_cast<int>(columns[c].size()));
+    }
+}
+
+void TestDetectedRegionBatch::testNeighborGraphEmpty() {
+    RegionNeighborGraph graph;
+    QCOMPARE(graph.size(), 0);
+
+    graph.build(QList<DetectedRegion>());
+    QVERIFY(graph.orderByCenterX().empty());
+
+    SpatialClusterer clusterer;
+    QCOMPARE(clusterer.detectGridStructure(graph, QList<DetectedRegion>()).rows, 0);
+
+    // Radius 0 keeps only the sorted orders
+    QList<DetectedRegion> regions = makeGrid(2, 2);
+    graph.build(regions, 0.0);
+    QCOMPARE(static_cast<int>(graph.orderByCenterY().size()), 4);
+    QCOMPARE(graph.neighborCount(0), 0);
+}
+
+QTEST_MAIN(TestDetectedRegionBatch)
+#include "test_detected_region_batch.moc"
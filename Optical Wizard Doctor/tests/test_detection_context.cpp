@@ -0,0 +1,208 @@
+// Test file for DetectionContext
+// Checks that a run converts and classifies the page once and that shared
+// conversions give the same answers as per-call conversions
+
+#include <QtTest/QtTest>
+#include "../src/utils/DetectionContext.h"
+#include "../src/utils/TextRegionRefiner.h"
+#include "../src/utils/ImageConverter.h"
+#include "../src/ui/components/dialogs/MagicDetectParamsDialog.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+
+using namespace ocr_orc;
+
+class TestDetectionContext : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testNullImage();
+    void testSourceConvertedOnce();
+    void testClassifiedOnce();
+    void testWorkingImageResetsAnalysis();
+    void testOwnsInputs();
+    void testRefinerMatchesUnsharedPath();
+    void testGrayscalePageUsedInPlace();
+    void testGrayscalePageUsesColorReference();
+
+private:
+    static QImage makePage();
+};
+
+QImage TestDetectionContext::makePage() {
+    cv::Mat page(1650, 1275, CV_8UC3, cv::Scalar(255, 255, 255));
+    for (int y = 150; y < 1500; y += 110) {
+        cv::rectangle(page, cv::Rect(100, y, 500, 60), cv::Scalar(0, 0, 0), 2);
+        cv::putText(page, "Label", cv::Point(700, y + 40), cv::FONT_HERSHEY_SIMPLEX, 1.0,
+                    cv::Scalar(0, 0, 0), 2);
+    }
+    return ImageConverter::matToQImage(page);
+}
+
+void TestDetectionContext::testNullImage() {
+    QImage image;
+    DetectionParameters params;
+    DetectionContext context(image, params);
+    QVERIFY(context.getSourceBgr().empty());
+    QVERIFY(context.getWorkingGray().empty());
+    QVERIFY(!context.isWorkingImage(cv::Mat()));
+    QCOMPARE(context.getConversionCount(), 0);
+}
+
+void TestDetectionContext::testSourceConvertedOnce() {
+    QImage image = makePage();
+    DetectionParameters params;
+    DetectionContext context(image, params);
+
+    cv::Mat first = context.getSourceBgr();
+    cv::Mat second = context.getSourceBgr();
+    cv::Mat working = context.getWorkingImage();
+    QCOMPARE(first.cols, image.width());
+    QCOMPARE(first.rows, image.height());
+    QVERIFY(first.data == second.data);
+    QVERIFY(working.data == first.data);
+    QCOMPARE(context.getConversionCount(), 1);
+
+    cv::Mat gray = context.getWorkingGray();
+    QCOMPARE(gray.channels(), 1);
+    QVERIFY(context.getWorkingGray().data == gray.data);
+    QCOMPARE(context.getConversionCount(), 2);
+
+    QVERIFY(context.isWorkingImage(first));
+    QVERIFY(!context.isWorkingImage(first.clone()));
+    QVERIFY(!context.isWorkingImage(first(cv::Rect(0, 0, 100, 100))));
+}
+
+void TestDetectionContext::testClassifiedOnce() {
+    QImage image = makePage();
+    DetectionParameters params;
+    params.horizontalOverfitPercent = 33.0;
+    DetectionContext context(image, params);
+
+    DocumentType type = context.getDocumentType();
+    AdaptiveThresholdManager manager = context.getThresholdManager();
+    QCOMPARE(context.getDocumentType(), type);
+    context.getThresholdManager();
+    QCOMPARE(context.getClassificationCount(), 1);
+
+    // Same answer as classifying directly, with the run's overrides applied
+    DocumentTypeClassifier classifier;
+    QCOMPARE(type, classifier.classifyDocument(ImageConverter::qImageToMat(image)));
+    QCOMPARE(manager.getHorizontalOverfitPercent(type), 33.0);
+}
+
+void TestDetectionContext::testWorkingImageResetsAnalysis() {
+    QImage image = makePage();
+    DetectionParameters params;
+    DetectionContext context(image, params);
+
+    context.getDocumentType();
+    cv::Mat oldGray = context.getWorkingGray();
+    QCOMPARE(context.getClassificationCount(), 1);
+
+    cv::Mat preprocessed;
+    cv::GaussianBlur(context.getSourceBgr(), preprocessed, cv::Size(3, 3), 0);
+    context.setWorkingImage(preprocessed);
+    QVERIFY(context.isWorkingImage(preprocessed));
+    QVERIFY(!context.isWorkingImage(context.getSourceBgr()));
+    QVERIFY(context.getWorkingGray().data != oldGray.data);
+
+    context.getDocumentType();
+    QCOMPARE(context.getClassificationCount(), 2);
+}
+
+void TestDetectionContext::testOwnsInputs() {
+    auto params = std::make_unique<DetectionParameters>();
+    params->horizontalOverfitPercent = 33.0;
+    auto image = std::make_unique<QImage>(makePage());
+    DetectionContext context(*image, *params);
+    const QSize pageSize = image->size();
+    params.reset();
+    image.reset();
+
+    // The caller's page and parameters are gone; the context's copies remain
+    QCOMPARE(context.getSourceBgr().cols, pageSize.width());
+    QCOMPARE(context.getParameters().horizontalOverfitPercent, 33.0);
+
+    // A manager handed out earlier survives a new working image and new parameters
+    AdaptiveThresholdManager manager = context.getThresholdManager();
+    const DocumentType type = context.getDocumentType();
+    context.setWorkingImage(context.getSourceBgr().clone());
+    DetectionParameters changed;
+    changed.horizontalOverfitPercent = 12.0;
+    context.setParameters(changed);
+    QCOMPARE(manager.getHorizontalOverfitPercent(type), 33.0);
+    QCOMPARE(context.getThresholdManager().getHorizontalOverfitPercent(context.getDocumentType()), 12.0);
+}
+
+void TestDetectionContext::testRefinerMatchesUnsharedPath() {
+    QImage image = makePage();
+    DetectionParameters params;
+    DetectionContext context(image, params);
+    cv::Mat page = context.getWorkingImage();
+
+    TextRegionRefiner plainRefiner;
+    TextRegionRefiner sharedRefiner;
+    sharedRefiner.setDetectionContext(&context);
+
+    QList<OCRTextRegion> noText;
+    const QList<cv::Rect> probes = {cv::Rect(100, 150, 500, 60), cv::Rect(690, 150, 200, 60),
+                                    cv::Rect(100, 370, 500, 60), cv::Rect(690, 480, 200, 60)};
+    for (const cv::Rect& probe : probes) {
+        QCOMPARE(sharedRefiner.regionContainsText(probe, page, noText),
+                 plainRefiner.regionContainsText(probe, page, noText));
+    }
+
+    // One gray conversion for all refiner calls
+    QCOMPARE(context.getConversionCount(), 2);
+}
+
+void TestDetectionContext::testGrayscalePageUsedInPlace() {
+    QImage image = makePage().convertToFormat(QImage::Format_Grayscale8);
+    DetectionParameters params;
+    DetectionContext context(image, params);
+
+    // A detection raster rendered as gray needs no conversion at all
+    cv::Mat source = context.getSourceBgr();
+    QCOMPARE(source.channels(), 1);
+    QCOMPARE(source.cols, image.width());
+    QCOMPARE(source.rows, image.height());
+    QVERIFY(source.data == image.constBits());
+    QVERIFY(context.getWorkingGray().data == source.data);
+    QCOMPARE(context.getConversionCount(), 0);
+
+    // Classification and the refiner accept the single-channel page
+    DocumentTypeClassifier classifier;
+    QCOMPARE(context.getDocumentType(), classifier.classifyDocument(source.clone()));
+    TextRegionRefiner refiner;
+    refiner.setDetectionContext(&context);
+    QList<OCRTextRegion> noText;
+    QVERIFY(refiner.regionContainsText(cv::Rect(690, 150, 200, 60), source, noText) ==
+            TextRegionRefiner().regionContainsText(cv::Rect(690, 150, 200, 60), source, noText));
+    QCOMPARE(context.getConversionCount(), 0);
+}
+
+void TestDetectionContext::testGrayscalePageUsesColorReference() {
+    cv::Mat colorPage = ImageConverter::qImageToMat(makePage());
+    cv::rectangle(colorPage, cv::Rect(0, 0, colorPage.cols, 300), cv::Scalar(200, 120, 40), cv::FILLED);
+    QImage display = ImageConverter::matToQImage(colorPage).convertToFormat(QImage::Format_RGB32);
+    QImage image = display.convertToFormat(QImage::Format_Grayscale8);
+    DetectionParameters params;
+    DetectionContext context(image, params);
+    context.setColorReference(display);
+
+    // Classified as the classifier would with the display raster's colour
+    DocumentTypeClassifier classifier;
+    classifier.setColorReference(colorPage);
+    QCOMPARE(context.getDocumentType(), classifier.classifyDocument(context.getSourceBgr().clone()));
+    QCOMPARE(context.getClassificationCount(), 1);
+
+    // Changing the reference reclassifies
+    context.setColorReference(QImage());
+    DocumentTypeClassifier grayClassifier;
+    QCOMPARE(context.getDocumentType(), grayClassifier.classifyDocument(context.getSourceBgr().clone()));
+    QCOMPARE(context.getClassificationCount(), 2);
+}
+
+QTEST_MAIN(TestDetectionContext)
+#include "test_detection_context.moc"
@@ -0,0 +1,99 @@
+// Test file for DetectionPresetIO
+// Checks preset round trips, defaults for missing values and rejection of invalid files
+
+#include <QtTest/QtTest>
+#include "../src/export/DetectionPresetIO.h"
+#include "../src/ui/components/dialogs/MagicDetectParamsDialog.h"
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QFile>
+#include <stdexcept>
+
+using namespace ocr_orc;
+
+class TestDetectionPresetIO : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip();
+    void testMissingValuesKeepDefaults();
+    void testInvalidFilesThrow();
+};
+
+void TestDetectionPresetIO::testRoundTrip() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("preset.json");
+
+    DetectionParameters params;
+    params.ocrOverlapThreshold = 0.12;
+    params.edgeDensityThreshold = 0.085;
+    params.iouThreshold = 0.55;
+    params.horizontalOverfitPercent = 35.0;
+    params.minHorizontalLines = 2;
+    params.strictConsensus = true;
+    params.minCheckboxSize = 14;
+    params.maxCheckboxSize = 45;
+    params.checkboxRectangularity = 0.65;
+    params.enableStandaloneCheckboxDetection = false;
+    DetectionPresetIO::exportToFile(params, "Tuned", path);
+
+    QString name;
+    DetectionParameters loaded = DetectionPresetIO::importFromFile(path, &name);
+    QCOMPARE(name, QString("Tuned"));
+    QCOMPARE(DetectionPresetIO::toJson(loaded), DetectionPresetIO::toJson(params));
+    QCOMPARE(loaded.minHorizontalLines, 2);
+    QVERIFY(loaded.strictConsensus);
+    QVERIFY(!loaded.enableStandaloneCheckboxDetection);
+}
+
+void TestDetectionPresetIO::testMissingValuesKeepDefaults() {
+    QJsonObject partial;
+    partial["iouThreshold"] = 0.65;
+    DetectionParameters params = DetectionPresetIO::fromJson(partial);
+
+    DetectionParameters defaults;
+    QCOMPARE(params.iouThreshold, 0.65);
+    QCOMPARE(params.ocrOverlapThreshold, defaults.ocrOverlapThreshold);
+    QCOMPARE(params.maxCheckboxSize, defaults.maxCheckboxSize);
+    QCOMPARE(params.enableStandaloneCheckboxDetection, defaults.enableStandaloneCheckboxDetection);
+}
+
+void TestDetectionPresetIO::testInvalidFilesThrow() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    try {
+        DetectionPresetIO::importFromFile(dir.filePath("missing.json"));
+        QFAIL("Should have thrown exception for a missing file");
+    } catch (const std::exception&) {
+        // Expected
+    }
+
+    QString garbagePath = dir.filePath("garbage.json");
+    QFile garbage(garbagePath);
+    QVERIFY(garbage.open(QIODevice::WriteOnly));
+    garbage.write("{ not json");
+    garbage.close();
+    try {
+        DetectionPresetIO::importFromFile(garbagePath);
+        QFAIL("Should have thrown exception for invalid JSON");
+    } catch (const std::exception&) {
+        // Expected
+    }
+
+    // A project file is valid JSON but not a preset
+    QString projectPath = dir.filePath("project.json");
+    QFile project(projectPath);
+    QVERIFY(project.open(QIODevice::WriteOnly));
+    project.write("{\"regions\": {}, \"version\": \"1.0\"}");
+    project.close();
+    try {
+        DetectionPresetIO::importFromFile(projectPath);
+        QFAIL("Should have thrown exception for a file without parameters");
+    } catch (const std::exception&) {
+        // Expected
+    }
+}
+
+QTEST_MAIN(TestDetectionPresetIO)
+#include "test_detection_preset_io.moc"
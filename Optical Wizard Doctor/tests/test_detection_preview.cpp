@@ -0,0 +1,178 @@
+// Test file for DetectionPreview
+// Checks the thumbnail scale, the parameter-to-stage mapping and that runs only recompute stale stages
+
+#include <QtTest/QtTest>
+#include "../src/utils/DetectionPreview.h"
+#include "../src/ui/components/dialogs/MagicDetectParamsDialog.h"
+#include <QtGui/QPainter>
+
+using namespace ocr_orc;
+
+class TestDetectionPreview : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testThumbnailScale();
+    void testAffectedStages();
+    void testSeededOcrRegions();
+    void testRunsOnlyAffectedStages();
+    void testCancelledRunKeepsCompletedStages();
+    void testForkSharesPreparedInputs();
+
+private:
+    static QImage createFormPage(int width, int height);
+    static QList<OCRTextRegion> labelsFor(const QImage& page);
+};
+
+QImage TestDetectionPreview::createFormPage(int width, int height) {
+    QImage page(width, height, QImage::Format_RGB32);
+    page.fill(Qt::white);
+    QPainter painter(&page);
+    painter.setPen(QPen(Qt::black, 3));
+    // Three labelled input boxes and a checkbox
+    for (int row = 0; row < 3; ++row) {
+        painter.drawRect(width / 3, 200 + row * 300, width / 2, 120);
+    }
+    painter.drawRect(width / 3, 1200, 60, 60);
+    painter.end();
+    return page;
+}
+
+QList<OCRTextRegion> TestDetectionPreview::labelsFor(const QImage& page) {
+    QList<OCRTextRegion> labels;
+    for (int row = 0; row < 3; ++row) {
+        OCRTextRegion label;
+        label.text = QString("Label %1:").arg(row + 1);
+        label.boundingBox = cv::Rect(page.width() / 10, 240 + row * 300, page.width() / 5, 50);
+        label.confidence = 90.0;
+        labels.append(label);
+    }
+    return labels;
+}
+
+void TestDetectionPreview::testThumbnailScale() {
+    DetectionPreview large(createFormPage(2400, 3000));
+    QCOMPARE(large.getThumbnail().height(), DetectionPreview::MAX_THUMBNAIL_SIZE);
+    QCOMPARE(large.getThumbnail().width(), 960);
+    QCOMPARE(large.getScale(), 0.4);
+
+    // Pages already at thumbnail size are used as they are
+    DetectionPreview small(QImage(800, 600, QImage::Format_RGB32));
+    QCOMPARE(small.getThumbnail().size(), QSize(800, 600));
+    QCOMPARE(small.getScale(), 1.0);
+
+    DetectionPreview empty((QImage()));
+    QVERIFY(!empty.prepare());
+}
+
+void TestDetectionPreview::testAffectedStages() {
+    DetectionParameters before;
+    QCOMPARE(DetectionPreview::affectedStages(before, before), 0);
+
+    DetectionParameters after = before;
+    after.iouThreshold += 0.1;
+    QCOMPARE(DetectionPreview::affectedStages(before, after), int(DetectionPreview::MERGE_STAGE));
+
+    after = before;
+    after.horizontalOverfitPercent += 5;
+    QCOMPARE(DetectionPreview::affectedStages(before, after),
+             DetectionPreview::OVERFIT_STAGE | DetectionPreview::MERGE_STAGE);
+
+    after = before;
+    after.edgeDensityThreshold += 0.01;
+    QCOMPARE(DetectionPreview::affectedStages(before, after),
+             DetectionPreview::TEXT_FILTER_STAGE | DetectionPreview::OVERFIT_STAGE | DetectionPreview::MERGE_STAGE);
+
+    after = before;
+    after.maxCheckboxSize += 10;
+    QCOMPARE(DetectionPreview::affectedStages(before, after), int(DetectionPreview::CHECKBOX_STAGE));
+
+    // Only used for ROI OCR, which the preview does not run
+    after = before;
+    after.ocrConfidenceThreshold += 10.0;
+    QCOMPARE(DetectionPreview::affectedStages(before, after), 0);
+}
+
+void TestDetectionPreview::testSeededOcrRegions() {
+    QImage page = createFormPage(2400, 3000);
+    DetectionPreview preview(page);
+    preview.setOcrRegions(labelsFor(page), page.size());
+    QCOMPARE(preview.getOcrRegionCount(), 3);
+    QVERIFY(preview.prepare());
+    QVERIFY(preview.isPrepared());
+    // Seeded regions skip OCR, so preparing keeps them as they were
+    QCOMPARE(preview.getOcrRegionCount(), 3);
+}
+
+void TestDetectionPreview::testRunsOnlyAffectedStages() {
+    QImage page = createFormPage(2400, 3000);
+    DetectionPreview preview(page);
+    preview.setOcrRegions(labelsFor(page), page.size());
+
+    DetectionParameters params;
+    DetectionPreview::Result first = preview.run(params);
+    QVERIFY(!first.cancelled);
+    QCOMPARE(first.stagesRun, int(DetectionPreview::ALL_STAGES));
+    QCOMPARE(preview.getValidStages(), int(DetectionPreview::ALL_STAGES));
+
+    // Same parameters: everything is reused
+    DetectionPreview::Result again = preview.run(params);
+    QCOMPARE(again.stagesRun, 0);
+    QCOMPARE(again.fields, first.fields);
+    QCOMPARE(again.checkboxes, first.checkboxes);
+
+    params.iouThreshold += 0.1;
+    QCOMPARE(preview.run(params).stagesRun, int(DetectionPreview::MERGE_STAGE));
+
+    params.verticalOverfitPercent += 5;
+    QCOMPARE(preview.run(params).stagesRun, DetectionPreview::OVERFIT_STAGE | DetectionPreview::MERGE_STAGE);
+
+    params.minCheckboxSize += 2;
+    QCOMPARE(preview.run(params).stagesRun, int(DetectionPreview::CHECKBOX_STAGE));
+}
+
+void TestDetectionPreview::testCancelledRunKeepsCompletedStages() {
+    QImage page = createFormPage(2400, 3000);
+    DetectionPreview preview(page);
+    preview.setOcrRegions(labelsFor(page), page.size());
+
+    DetectionParameters params;
+    preview.run(params);
+
+    params.horizontalOverfitPercent += 5;
+    DetectionPreview::Result cancelled = preview.run(params, []() { return true; });
+    QVERIFY(cancelled.cancelled);
+    QVERIFY(cancelled.fields.isEmpty());
+    QCOMPARE(preview.getValidStages(), DetectionPreview::CHECKBOX_STAGE | DetectionPreview::TEXT_FILTER_STAGE);
+
+    // The next run only finishes what the cancelled one left
+    DetectionPreview::Result resumed = preview.run(params);
+    QVERIFY(!resumed.cancelled);
+    QCOMPARE(resumed.stagesRun, DetectionPreview::OVERFIT_STAGE | DetectionPreview::MERGE_STAGE);
+}
+
+void TestDetectionPreview::testForkSharesPreparedInputs() {
+    QImage page = createFormPage(2400, 3000);
+    DetectionPreview full(page, 0);
+    QCOMPARE(full.getScale(), 1.0);
+    QCOMPARE(full.getThumbnail().size(), page.size());
+
+    full.setOcrRegions(labelsFor(page), page.size());
+    DetectionParameters params;
+    DetectionPreview::Result original = full.run(params);
+
+    // A fork starts prepared, with no cached stages of its own
+    std::unique_ptr<DetectionPreview> fork = full.fork();
+    QVERIFY(fork->isPrepared());
+    QCOMPARE(fork->getCandidateCount(), full.getCandidateCount());
+    QCOMPARE(fork->getValidStages(), 0);
+    DetectionPreview::Result forked = fork->run(params);
+    QCOMPARE(forked.stagesRun, int(DetectionPreview::ALL_STAGES));
+    QCOMPARE(forked.fields, original.fields);
+
+    fork->invalidateStages();
+    QCOMPARE(fork->run(params).stagesRun, int(DetectionPreview::ALL_STAGES));
+}
+
+QTEST_MAIN(TestDetectionPreview)
+#include "test_detection_preview.moc"
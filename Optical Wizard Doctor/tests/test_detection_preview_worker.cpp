@@ -0,0 +1,113 @@
+// Test file for DetectionPreviewWorker
+// Checks that superseded and cancelled previews are never emitted and that teardown does not wait for a running preview
+
+#include <QtTest/QtTest>
+#include "../src/ui/utils/DetectionPreviewWorker.h"
+#include "../src/utils/PageAnalysisCache.h"
+#include <QtGui/QPainter>
+#include <QtCore/QElapsedTimer>
+
+using namespace ocr_orc;
+
+class TestDetectionPreviewWorker : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testDebouncedBurstEmitsLatestOnly();
+    void testCancelSuppressesResult();
+    void testDestroyWhileRunning();
+
+private:
+    static QImage createSeededPage(int seed);
+    static const int RESULT_TIMEOUT_MS = 60000;
+};
+
+QImage TestDetectionPreviewWorker::createSeededPage(int seed) {
+    QImage page(1600, 2000, QImage::Format_RGB32);
+    page.fill(Qt::white);
+    QPainter painter(&page);
+    painter.setPen(QPen(Qt::black, 3));
+    QList<OCRTextRegion> labels;
+    for (int row = 0; row < 3; ++row) {
+        const int y = 200 + row * 300 + seed * 10;
+        painter.drawRect(600, y, 800, 120);
+        OCRTextRegion label;
+        label.text = QString("Label %1:").arg(row + 1);
+        label.boundingBox = cv::Rect(160, y + 40, 320, 50);
+        label.confidence = 90.0;
+        labels.append(label);
+    }
+    painter.end();
+
+    // Seed the OCR the worker looks up, so previews skip Tesseract
+    PageAnalysisCache::instance().storeOcr(PageAnalysisCache::pageKey(page),
+                                           OcrTextExtractor::TWO_TIER_RECOGNITION, labels);
+    return page;
+}
+
+void TestDetectionPreviewWorker::init() {
+    PageAnalysisCache::instance().clear();
+}
+
+void TestDetectionPreviewWorker::testDebouncedBurstEmitsLatestOnly() {
+    DetectionPreviewWorker worker;
+    worker.setPage(createSeededPage(0));
+    QSignalSpy spy(&worker, &DetectionPreviewWorker::previewReady);
+
+    // What the dialog does while a slider is dragged: cancel, then request
+    // again every time its debounce timer fires
+    DetectionParameters params;
+    int latest = 0;
+    for (int step = 0; step < 5; ++step) {
+        worker.cancel();
+        params.horizontalOverfitPercent += 1;
+        latest = worker.requestPreview(params);
+    }
+
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, RESULT_TIMEOUT_MS);
+    // Superseded jobs finished before the latest one, so nothing else can follow
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.first().at(0).toInt(), latest);
+}
+
+void TestDetectionPreviewWorker::testCancelSuppressesResult() {
+    DetectionPreviewWorker worker;
+    worker.setPage(createSeededPage(1));
+    QSignalSpy spy(&worker, &DetectionPreviewWorker::previewReady);
+
+    DetectionParameters params;
+    const int cancelledId = worker.requestPreview(params);
+    worker.cancel();
+
+    // Previews run in order, so once the next one arrives the cancelled one is done
+    params.iouThreshold += 0.1;
+    const int nextId = worker.requestPreview(params);
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, RESULT_TIMEOUT_MS);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.first().at(0).toInt(), nextId);
+    QVERIFY(nextId != cancelledId);
+}
+
+void TestDetectionPreviewWorker::testDestroyWhileRunning() {
+    // The first request prepares the page; destroying the worker must not wait for it
+    auto* worker = new DetectionPreviewWorker();
+    worker->setPage(createSeededPage(2));
+    worker->requestPreview(DetectionParameters());
+    QElapsedTimer timer;
+    timer.start();
+    delete worker;
+    QVERIFY(timer.elapsed() < 1000);
+
+    // The abandoned job runs out in the background; later workers still get results
+    DetectionPreviewWorker next;
+    next.setPage(createSeededPage(3));
+    QSignalSpy spy(&next, &DetectionPreviewWorker::previewReady);
+    const int requestId = next.requestPreview(DetectionParameters());
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, RESULT_TIMEOUT_MS);
+    QCOMPARE(spy.first().at(0).toInt(), requestId);
+}
+
+QTEST_MAIN(TestDetectionPreviewWorker)
+#include "test_detection_preview_worker.moc"
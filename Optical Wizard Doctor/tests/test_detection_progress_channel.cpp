@@ -0,0 +1,118 @@
+// Test file for DetectionProgressChannel
+// Checks layer ordering, listener delivery, cancellation and concurrent publishers
+
+#include <QtTest/QtTest>
+#include "../src/utils/DetectionProgressChannel.h"
+#include <thread>
+#include <vector>
+
+using namespace ocr_orc;
+
+class TestDetectionProgressChannel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testLayersKeepPublishOrder();
+    void testListenerReceivesLayers();
+    void testCancelDropsLaterLayers();
+    void testResetStartsNewRun();
+    void testConcurrentPublishers();
+
+private:
+    static QList<DetectedRegion> boxes(int count);
+};
+
+QList<DetectedRegion> TestDetectionProgressChannel::boxes(int count) {
+    QList<DetectedRegion> regions;
+    for (int i = 0; i < count; ++i) {
+        NormalizedCoords coords(0.01 * i, 0.1, 0.01 * i + 0.005, 0.2);
+        regions.append(DetectedRegion(coords, 0.9, "ocr", cv::Rect(i * 10, 10, 5, 10)));
+    }
+    return regions;
+}
+
+void TestDetectionProgressChannel::testLayersKeepPublishOrder() {
+    DetectionProgressChannel channel;
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::OCR_WORDS, boxes(5)));
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::RECTANGLE_CANDIDATES, boxes(3)));
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::CONSENSUS_REGIONS, boxes(2)));
+
+    QList<PartialDetectionLayer> layers = channel.getLayers();
+    QCOMPARE(layers.size(), 3);
+    QCOMPARE(layers[0].kind, PartialDetectionLayer::OCR_WORDS);
+    QCOMPARE(layers[0].regions.size(), 5);
+    QCOMPARE(layers[1].kind, PartialDetectionLayer::RECTANGLE_CANDIDATES);
+    QCOMPARE(layers[2].kind, PartialDetectionLayer::CONSENSUS_REGIONS);
+    QVERIFY(layers[0].elapsedMs <= layers[2].elapsedMs);
+}
+
+void TestDetectionProgressChannel::testListenerReceivesLayers() {
+    DetectionProgressChannel channel;
+    QList<PartialDetectionLayer::Kind> received;
+    channel.setListener([&received](const PartialDetectionLayer& layer) {
+        received.append(layer.kind);
+    });
+
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::OCR_WORDS, boxes(1)));
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::RECTANGLE_CANDIDATES, boxes(1)));
+    QCOMPARE(received, QList<PartialDetectionLayer::Kind>({PartialDetectionLayer::OCR_WORDS,
+                                                           PartialDetectionLayer::RECTANGLE_CANDIDATES}));
+}
+
+void TestDetectionProgressChannel::testCancelDropsLaterLayers() {
+    DetectionProgressChannel channel;
+    int notifications = 0;
+    channel.setListener([&notifications](const PartialDetectionLayer&) {
+        ++notifications;
+    });
+
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::OCR_WORDS, boxes(4)));
+    QVERIFY(!channel.isCancelled());
+    channel.requestCancel();
+    QVERIFY(channel.isCancelled());
+
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::RECTANGLE_CANDIDATES, boxes(4)));
+    QCOMPARE(channel.getLayers().size(), 1);
+    QCOMPARE(notifications, 1);
+}
+
+void TestDetectionProgressChannel::testResetStartsNewRun() {
+    DetectionProgressChannel channel;
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::OCR_WORDS, boxes(2)));
+    channel.requestCancel();
+
+    channel.reset();
+    QVERIFY(!channel.isCancelled());
+    QVERIFY(channel.getLayers().isEmpty());
+
+    channel.publish(PartialDetectionLayer(PartialDetectionLayer::CONSENSUS_REGIONS, boxes(2)));
+    QCOMPARE(channel.getLayers().size(), 1);
+}
+
+void TestDetectionProgressChannel::testConcurrentPublishers() {
+    DetectionProgressChannel channel;
+    std::atomic<int> notifications(0);
+    channel.setListener([&notifications](const PartialDetectionLayer&) {
+        notifications.fetch_add(1);
+    });
+
+    const int threads = 4;
+    const int perThread = 50;
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < threads; ++t) {
+        publishers.emplace_back([&channel]() {
+            for (int i = 0; i < perThread; ++i) {
+                channel.publish(PartialDetectionLayer(PartialDetectionLayer::OCR_WORDS, boxes(1)));
+            }
+        });
+    }
+    for (std::thread& publisher : publishers) {
+        publisher.join();
+    }
+
+    QCOMPARE(channel.getLayers().size(), threads * perThread);
+    QCOMPARE(notifications.load(), threads * perThread);
+}
+
+QTEST_MAIN(TestDetectionProgressChannel)
+#include "test_detection_progress_channel.moc"
@@ -0,0 +1,98 @@
+// Test file for DocumentPreprocessor
+// Checks that the FAST path agrees with QUALITY on skew and keeps edges when denoising
+
+#include <QtTest/QtTest>
+#include "../src/utils/DocumentPreprocessor.h"
+#include <opencv2/imgproc.hpp>
+#include <cmath>
+
+using namespace ocr_orc;
+
+class TestDocumentPreprocessor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testFastSkewMatchesQuality_data();
+    void testFastSkewMatchesQuality();
+    void testFastDenoiseKeepsEdges();
+
+private:
+    static cv::Mat rotatedPage(double angle);
+};
+
+cv::Mat TestDocumentPreprocessor::rotatedPage(double angle) {
+    // Letter page at 150 DPI: ruled lines and text-like word blocks
+    cv::Mat page(1650, 1275, CV_8UC3, cv::Scalar(255, 255, 255));
+    for (int y = 150; y < 1500; y += 45) {
+        cv::line(page, cv::Point(100, y), cv::Point(1175, y), cv::Scalar(0, 0, 0), 2);
+        for (int x = 110; x < 1100; x += 120) {
+            cv::rectangle(page, cv::Rect(x, y - 25, 80 + (x % 3) * 10, 16), cv::Scalar(40, 40, 40), cv::FILLED);
+        }
+    }
+    
+    cv::Mat rotation = cv::getRotationMatrix2D(cv::Point2f(page.cols / 2.0f, page.rows / 2.0f), angle, 1.0);
+    cv::Mat rotated;
+    cv::warpAffine(page, rotated, rotation, page.size(), cv::INTER_LINEAR, cv::BORDER_CONSTANT,
+                   cv::Scalar(255, 255, 255));
+    return rotated;
+}
+
+void TestDocumentPreprocessor::testFastSkewMatchesQuality_data() {
+    QTest::addColumn<double>("angle");
+    QTest::newRow("clockwise") << -3.0;
+    QTest::newRow("counter-clockwise") << 2.0;
+    QTest::newRow("straight") << 0.0;
+}
+
+void TestDocumentPreprocessor::testFastSkewMatchesQuality() {
+    QFETCH(double, angle);
+    const cv::Mat page = rotatedPage(angle);
+    
+    DocumentPreprocessor quality;
+    quality.setMode(DocumentPreprocessor::QUALITY_PREPROCESSING);
+    DocumentPreprocessor fast;
+    fast.setMode(DocumentPreprocessor::FAST_PREPROCESSING);
+    
+    const double qualityAngle = quality.detectSkewAngle(page);
+    const double fastAngle = fast.detectSkewAngle(page);
+    
+    // QUALITY works in 1 degree Hough steps; FAST must land within that resolution
+    QVERIFY2(std::abs(fastAngle - qualityAngle) <= 1.0,
+             qPrintable(QString("fast %1 vs quality %2").arg(fastAngle).arg(qualityAngle)));
+    QVERIFY2(std::abs(std::abs(fastAngle) - std::abs(angle)) <= 1.0,
+             qPrintable(QString("fast %1 for a page rotated by %2").arg(fastAngle).arg(angle)));
+}
+
+void TestDocumentPreprocessor::testFastDenoiseKeepsEdges() {
+    // Vertical step edge with noise on both sides
+    cv::Mat page(200, 200, CV_8UC3);
+    page(cv::Rect(0, 0, 100, 200)).setTo(cv::Scalar(30, 30, 30));
+    page(cv::Rect(100, 0, 100, 200)).setTo(cv::Scalar(225, 225, 225));
+    cv::Mat noise(page.size(), CV_16SC3);
+    cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(12));
+    cv::Mat noisy;
+    page.convertTo(noisy, CV_16SC3);
+    noisy += noise;
+    noisy.convertTo(noisy, CV_8UC3);
+    
+    DocumentPreprocessor fast;
+    fast.setMode(DocumentPreprocessor::FAST_PREPROCESSING);
+    const cv::Mat denoised = fast.denoise(noisy);
+    QCOMPARE(denoised.size(), noisy.size());
+    QCOMPARE(denoised.type(), noisy.type());
+    
+    // Pixels next to the edge keep their side's level instead of blurring across
+    cv::Scalar darkSide = cv::mean(denoised(cv::Rect(97, 20, 2, 160)));
+    cv::Scalar brightSide = cv::mean(denoised(cv::Rect(101, 20, 2, 160)));
+    QVERIFY2(darkSide[0] < 60.0, qPrintable(QString("dark side %1").arg(darkSide[0])));
+    QVERIFY2(brightSide[0] > 195.0, qPrintable(QString("bright side %1").arg(brightSide[0])));
+    
+    // Flat areas are smoothed
+    cv::Scalar noisyMean, noisyStd, denoisedMean, denoisedStd;
+    cv::meanStdDev(noisy(cv::Rect(20, 20, 60, 160)), noisyMean, noisyStd);
+    cv::meanStdDev(denoised(cv::Rect(20, 20, 60, 160)), denoisedMean, denoisedStd);
+    QVERIFY(denoisedStd[0] < noisyStd[0] * 0.75);
+}
+
+QTEST_MAIN(TestDocumentPreprocessor)
+#include "test_document_preprocessor.moc"
@@ -0,0 +1,156 @@
+// Test file for DocumentTypeClassifier
+// Checks that the thumbnail classifier agrees with the full-resolution path
+
+#include <QtTest/QtTest>
+#include "../src/utils/DocumentTypeClassifier.h"
+#include "../src/utils/PdfLoader.h"
+#include "../src/utils/ImageConverter.h"
+#include <opencv2/opencv.hpp>
+#include <QtCore/QDir>
+
+using namespace ocr_orc;
+
+class TestDocumentTypeClassifier : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testEmptyImage();
+    void testSyntheticPagesAgree_data();
+    void testSyntheticPagesAgree();
+    void testValidationMode();
+    void testColorReference();
+    void testCorpusAgrees();
+
+private:
+    static cv::Mat makePage(const QString& kind);
+};
+
+cv::Mat TestDocumentTypeClassifier::makePage(const QString& kind) {
+    // Letter page at 300 DPI so the thumbnail is a real downscale
+    cv::Mat page(3300, 2550, CV_8UC3, cv::Scalar(255, 255, 255));
+
+    if (kind == "colored") {
+        // Colored section bands with boxed fields
+        cv::rectangle(page, cv::Rect(0, 0, 2550, 600), cv::Scalar(200, 120, 40), cv::FILLED);
+        cv::rectangle(page, cv::Rect(0, 1500, 2550, 500), cv::Scalar(60, 180, 230), cv::FILLED);
+        for (int y = 700; y < 1400; y += 120) {
+            for (int x = 100; x < 2400; x += 400) {
+                cv::rectangle(page, cv::Rect(x, y, 300, 80), cv::Scalar(0, 0, 0), 3);
+            }
+        }
+    } else if (kind == "dense") {
+        // Grid of small boxes with text-like strokes
+        for (int y = 100; y < 3200; y += 70) {
+            for (int x = 100; x < 2450; x += 160) {
+                cv::rectangle(page, cv::Rect(x, y, 140, 50), cv::Scalar(0, 0, 0), 2);
+            }
+            cv::line(page, cv::Point(100, y + 60), cv::Point(2450, y + 60), cv::Scalar(0, 0, 0), 3);
+        }
+    } else if (kind == "ruled") {
+        // Light guide lines, as on a handwriting form
+        for (int y = 200; y < 3200; y += 100) {
+            cv::line(page, cv::Point(150, y), cv::Point(2400, y), cv::Scalar(170, 170, 170), 3);
+        }
+    }
+    return page;
+}
+
+void TestDocumentTypeClassifier::testEmptyImage() {
+    DocumentTypeClassifier classifier;
+    QCOMPARE(classifier.classifyDocument(cv::Mat()), STANDARD_FORM);
+}
+
+void TestDocumentTypeClassifier::testSyntheticPagesAgree_data() {
+    QTest::addColumn<QString>("kind");
+    QTest::newRow("blank") << "blank";
+    QTest::newRow("colored") << "colored";
+    QTest::newRow("dense") << "dense";
+    QTest::newRow("ruled") << "ruled";
+}
+
+void TestDocumentTypeClassifier::testSyntheticPagesAgree() {
+    QFETCH(QString, kind);
+    cv::Mat page = makePage(kind);
+
+    DocumentTypeClassifier classifier;
+    DocumentType thumbnailType = classifier.classifyDocument(page);
+    DocumentType fullType = classifier.classifyDocumentFullResolution(page);
+    QCOMPARE(thumbnailType, fullType);
+
+    // Gray input goes through the same paths
+    cv::Mat gray;
+    cv::cvtColor(page, gray, cv::COLOR_BGR2GRAY);
+    QCOMPARE(classifier.classifyDocument(gray), classifier.classifyDocumentFullResolution(gray));
+
+    // Pixel statistics are sampled, not averaged, so they track the full-resolution values
+    DocumentFeatures thumbnail = classifier.extractThumbnailFeatures(page);
+    DocumentFeatures full = classifier.extractFullResolutionFeatures(page);
+    QVERIFY(std::abs(thumbnail.contrast - full.contrast) < 0.05);
+    QVERIFY(std::abs(thumbnail.colorfulness - full.colorfulness) < 0.05);
+    QCOMPARE(thumbnail.hasColoredSections, full.hasColoredSections);
+}
+
+void TestDocumentTypeClassifier::testValidationMode() {
+    DocumentTypeClassifier classifier;
+    classifier.setValidationEnabled(true);
+    QVERIFY(classifier.isValidationEnabled());
+
+    classifier.classifyDocument(makePage("blank"));
+    classifier.classifyDocument(makePage("colored"));
+    QCOMPARE(classifier.getValidationCount(), 2);
+    QCOMPARE(classifier.getValidationMismatches(), 0);
+}
+
+void TestDocumentTypeClassifier::testColorReference() {
+    cv::Mat page = makePage("colored");
+    cv::Mat gray;
+    cv::cvtColor(page, gray, cv::COLOR_BGR2GRAY);
+
+    // Colour statistics come from the same grid as the thumbnail pass
+    DocumentFeatures color = DocumentTypeClassifier::extractColorFeatures(page);
+    DocumentFeatures thumbnail = DocumentTypeClassifier().extractThumbnailFeatures(page);
+    QCOMPARE(color.colorfulness, thumbnail.colorfulness);
+    QVERIFY(color.hasColoredSections);
+    QCOMPARE(DocumentTypeClassifier::extractColorFeatures(gray).colorfulness, 0.0);
+
+    // A gray page classified with its colour raster as reference matches the colour page
+    DocumentTypeClassifier colorClassifier;
+    const DocumentType expected = colorClassifier.classifyDocument(page);
+    DocumentTypeClassifier grayClassifier;
+    grayClassifier.setColorReference(page);
+    QCOMPARE(grayClassifier.classifyDocument(gray), expected);
+    QCOMPARE(grayClassifier.classifyDocumentFullResolution(gray), colorClassifier.classifyDocumentFullResolution(page));
+
+    // A BGRA reference gives the same statistics
+    cv::Mat bgra;
+    cv::cvtColor(page, bgra, cv::COLOR_BGR2BGRA);
+    QCOMPARE(DocumentTypeClassifier::extractColorFeatures(bgra).colorfulness, color.colorfulness);
+}
+
+void TestDocumentTypeClassifier::testCorpusAgrees() {
+    QString formsDir = QFINDTESTDATA("data/forms");
+    if (formsDir.isEmpty()) {
+        QSKIP("Test corpus not found");
+    }
+
+    QStringList pdfs = QDir(formsDir).entryList(QStringList() << "*.pdf", QDir::Files);
+    if (pdfs.isEmpty()) {
+        QSKIP("No PDFs in test corpus");
+    }
+
+    DocumentTypeClassifier classifier;
+    classifier.setValidationEnabled(true);
+    for (const QString& pdf : pdfs) {
+        QImage image = PdfLoader::loadPdfFirstPage(QDir(formsDir).absoluteFilePath(pdf));
+        if (image.isNull()) {
+            continue;
+        }
+        classifier.classifyDocument(ImageConverter::qImageToMat(image));
+    }
+
+    QVERIFY(classifier.getValidationCount() > 0);
+    QCOMPARE(classifier.getValidationMismatches(), 0);
+}
+
+QTEST_MAIN(TestDocumentTypeClassifier)
+#include "test_document_type_classifier.moc"
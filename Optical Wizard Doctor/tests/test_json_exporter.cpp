@@ -28,6 +28,7 @@ private slots:
     void testExportWithRegionType();
     void testExportWithPercentageFill();
     void testExportBackwardCompatibility();
+    void testStreamedOutputMatchesDomSerialization();
 
 private:
     QTemporaryDir* tempDir;
@@ -291,6 +292,56 @@ void TestJsonExporter::testExportBackwardCompatibility() {
     QVERIFY(!regionObj.contains("percentage_fill"));
 }
 
+void TestJsonExporter::testStreamedOutputMatchesDomSerialization() {
+    // The streaming writer must produce byte-identical output to QJsonDocument
+    DocumentState state;
+    state.pdfPath = "/test/\"quoted\" path/ünïcode.pdf";
+    state.image = QImage(1275, 1650, QImage::Format_RGB32);
+    
+    for (int i = 0; i < 500; ++i) {
+        QString name = QString("Field_%1").arg(i, 4, 10, QChar('0'));
+        double x = (i % 20) / 25.0;
+        double y = (i / 20) / 30.0;
+        RegionData region(name, NormalizedCoords(x, y, x + 0.03, y + 0.02), i % 2 ? "red" : "blue", "");
+        region.rotationAngle = (i % 7 == 0) ? 12.5 : 0.0;
+        region.shapeType = (i % 5 == 0) ? "circle" : "rect";
+        region.regionType = (i % 3 == 0) ? "digits" : "none";
+        state.addRegion(name, region);
+    }
+    state.addRegion("Name, \"with\" escapes\t", RegionData("x", NormalizedCoords(0.1, 0.1, 0.2, 0.2), "green", ""));
+    state.createGroup("GroupA");
+    state.createGroup("EmptyGroup");
+    for (int i = 0; i < 40; ++i) {
+        state.addRegionToGroup(QString("Field_%1").arg(i, 4, 10, QChar('0')), "GroupA");
+    }
+    
+    QString filePath = getTempFilePath("streamed.json");
+    JsonExporter::exportToFile(state, filePath);
+    
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray streamed = file.readAll();
+    file.close();
+    
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(streamed, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(doc.object()["regions"].toObject().size(), 501);
+    QCOMPARE(streamed, doc.toJson(QJsonDocument::Indented));
+    
+    // Empty document too
+    DocumentState empty;
+    QString emptyPath = getTempFilePath("streamed_empty.json");
+    JsonExporter::exportToFile(empty, emptyPath);
+    QFile emptyFile(emptyPath);
+    QVERIFY(emptyFile.open(QIODevice::ReadOnly));
+    QByteArray emptyStreamed = emptyFile.readAll();
+    QCOMPARE(emptyStreamed, QJsonDocument::fromJson(emptyStreamed).toJson(QJsonDocument::Indented));
+    
+    // No temp file left behind
+    QVERIFY(!QFile::exists(filePath + ".tmp"));
+}
+
 QTEST_MAIN(TestJsonExporter)
 #include "test_json_exporter.moc"
 
@@ -8,6 +8,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
 #include <QtCore/QTemporaryDir>
 #include <QtCore/QTemporaryFile>
 #include <QtGui/QImage>
@@ -30,6 +31,8 @@ private slots:
     void testImportWithNewFields();
     void testImportBackwardCompatibility();
     void testImportInvalidValues();
+    void testImportLargeRegionSet();
+    void testImportParseErrorKeepsState();
 
 private:
     QTemporaryDir* tempDir;
@@ -308,6 +311,70 @@ void TestJsonImporter::testImportInvalidValues() {
     QCOMPARE(region.percentageFill, QString("invalid_fill"));
 }
 
+void TestJsonImporter::testImportLargeRegionSet() {
+    // Groups come before regions in exported files (keys are sorted), and
+    // the streaming reader must still resolve group membership
+    QJsonObject regions;
+    QJsonArray groupMembers;
+    for (int i = 0; i < 5000; ++i) {
+        QString name = QString("Region_%1").arg(i);
+        QJsonObject coords;
+        coords["x1"] = 0.1;
+        coords["y1"] = 0.1;
+        coords["x2"] = 0.2 + (i % 50) / 100.0;
+        coords["y2"] = 0.2;
+        QJsonObject region;
+        region["normalized_coords"] = coords;
+        region["color"] = "red";
+        if (i % 10 == 0) {
+            region["group"] = "Tens";
+            groupMembers.append(name);
+        }
+        regions[name] = region;
+    }
+    QJsonObject groups;
+    groups["Tens"] = groupMembers;
+    
+    QJsonObject json;
+    json["groups"] = groups;
+    json["pdf_path"] = "/test/large.pdf";
+    json["regions"] = regions;
+    
+    QString filePath = createTestJsonFile(json);
+    
+    DocumentState state;
+    JsonImporter::importFromFile(state, filePath);
+    
+    QCOMPARE(state.regions.size(), 5000);
+    QCOMPARE(state.pdfPath, QString("/test/large.pdf"));
+    QVERIFY(state.hasGroup("Tens"));
+    QCOMPARE(state.getGroup("Tens").regionNames.size(), 500);
+    QCOMPARE(state.getRegion("Region_4999").color, QString("red"));
+}
+
+void TestJsonImporter::testImportParseErrorKeepsState() {
+    DocumentState state;
+    state.addRegion("Existing", RegionData("Existing", NormalizedCoords(0.1, 0.1, 0.2, 0.2), "blue", ""));
+    
+    // Valid prefix followed by a truncated region
+    QString filePath = tempDir->filePath("truncated.json");
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("{\n    \"regions\": {\n        \"A\": {\n            \"normalized_coords\": "
+               "{\"x1\": 0.1, \"x2\": 0.2, \"y1\": 0.1, \"y2\": 0.2}\n        },\n        \"B\": {");
+    file.close();
+    
+    try {
+        JsonImporter::importFromFile(state, filePath);
+        QFAIL("Should have thrown exception for truncated JSON");
+    } catch (const std::exception&) {
+        // Expected
+    }
+    
+    QCOMPARE(state.regions.size(), 1);
+    QVERIFY(state.hasRegion("Existing"));
+}
+
 QTEST_MAIN(TestJsonImporter)
 #include "test_json_importer.moc"
 
@@ -1,4 +1,7 @@
 #include "MagicDetectionTestRunner.h"
+#include "tuning/ParameterTuner.h"
+#include "../src/utils/ConcurrencyGovernor.h"
+#include "../src/export/DetectionPresetIO.h"
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
 #include <QtCore/QCommandLineParser>
@@ -9,6 +12,7 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
 
 // #region agent log
 static void debugLog(const QString& location, const QString& message, const QVariantMap& data = QVariantMap()) {
@@ -83,6 +87,31 @@ int main(int argc, char *argv[])
     QCommandLineOption skipOcrOption("skip-ocr", "Skip OCR and use hybrid detection method (faster, avoids Tesseract hangs)");
     parser.addOption(skipOcrOption);
     
+    QCommandLineOption fullPageOcrOption("full-page-ocr", "Recognize the full-resolution page in one pass instead of the two-tier OCR pass");
+    parser.addOption(fullPageOcrOption);
+    
+    QCommandLineOption compareOcrOption("compare-ocr", "Compare two-tier OCR against full-page OCR (timing and word accuracy) and exit");
+    parser.addOption(compareOcrOption);
+    
+    QCommandLineOption threadsOption("threads", "Pin the thread budget to N cores for reproducible timings (default: OCR_ORC_THREADS or adapt to load)", "count");
+    parser.addOption(threadsOption);
+    
+    QCommandLineOption tuneOption("tune", "Search detection parameters against the ground truth, write the Pareto front and the best preset, and exit");
+    parser.addOption(tuneOption);
+    
+    QCommandLineOption tuneTrialsOption("tune-trials", "Maximum number of tuning trials", "count", "200");
+    parser.addOption(tuneTrialsOption);
+    
+    QCommandLineOption tunePatienceOption("tune-patience", "Stop tuning after this many trials without improvement", "count", "60");
+    parser.addOption(tunePatienceOption);
+    
+    QCommandLineOption tuneSeedOption("tune-seed", "Random seed for the parameter search", "seed", "1");
+    parser.addOption(tuneSeedOption);
+    
+    QCommandLineOption tuneMaxSizeOption("tune-max-size", "Longest page side used by tuning trials (default: the live preview size; 0 = full resolution)",
+                                         "pixels", QString::number(ocr_orc::DetectionPreview::MAX_THUMBNAIL_SIZE));
+    parser.addOption(tuneMaxSizeOption);
+    
     fprintf(stderr, "Processing command line arguments...\n");
     fflush(stderr);
     parser.process(app);
@@ -107,6 +136,18 @@ int main(int argc, char *argv[])
     debugLog("test_magic_detection_suite.cpp:main", "Parsed skipOcr", {{"skipOcr", skipOcr}, {"isSet", parser.isSet(skipOcrOption)}});
     // #endregion
     
+    // Batch runs use a fixed thread allocation so timings do not depend on load
+    ocr_orc::ConcurrencyGovernor::instance().configureFromEnvironment();
+    if (parser.isSet(threadsOption)) {
+        int threads = parser.value(threadsOption).toInt();
+        if (threads > 0) {
+            ocr_orc::ConcurrencyGovernor::instance().pin(ocr_orc::ConcurrencyGovernor::computeAllocation(threads, 1));
+        } else {
+            fprintf(stderr, "Ignoring --threads %s (expected a positive integer)\n", qPrintable(parser.value(threadsOption)));
+            fflush(stderr);
+        }
+    }
+    
     double minPrecision = parser.value(minPrecisionOption).toDouble();
     double minRecall = parser.value(minRecallOption).toDouble();
     double minF1 = parser.value(minF1Option).toDouble();
@@ -189,6 +230,98 @@ int main(int argc, char *argv[])
         // #endregion
     }
     
+    if (parser.isSet(fullPageOcrOption)) {
+        runner.setRecognitionMode(ocr_orc::OcrTextExtractor::FULL_PAGE_RECOGNITION);
+    }
+    
+    if (parser.isSet(compareOcrOption)) {
+        QList<QString> forms = parser.positionalArguments();
+        if (forms.isEmpty()) {
+            forms = runner.getAvailableForms();
+        }
+        
+        QJsonArray comparisons;
+        for (const QString& formId : forms) {
+            ocr_orc::OcrModeComparison c = runner.compareRecognitionModes(formId);
+            fprintf(stdout, "%s: full-page %.0f ms (%d words), two-tier %.0f ms (%d words, %d layout, %d runs refined)\n",
+                    formId.toLocal8Bit().constData(), c.fullPageTimeMs, c.fullPageWords,
+                    c.twoTierTimeMs, c.twoTierWords, c.layoutWords, c.refinedRuns);
+            fprintf(stdout, "    box recall %.3f, text agreement %.3f, label recall %.3f\n",
+                    c.boxRecall, c.textAgreement, c.labelRecall);
+            fflush(stdout);
+            
+            QJsonObject obj;
+            obj["form_id"] = c.formId;
+            obj["full_page_ms"] = c.fullPageTimeMs;
+            obj["two_tier_ms"] = c.twoTierTimeMs;
+            obj["full_page_words"] = c.fullPageWords;
+            obj["two_tier_words"] = c.twoTierWords;
+            obj["layout_words"] = c.layoutWords;
+            obj["refined_runs"] = c.refinedRuns;
+            obj["box_recall"] = c.boxRecall;
+            obj["text_agreement"] = c.textAgreement;
+            obj["label_recall"] = c.labelRecall;
+            comparisons.append(obj);
+        }
+        
+        if (generateReports) {
+            QFile file(QDir(outputDir).filePath("ocr_mode_comparison.json"));
+            if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+                file.write(QJsonDocument(comparisons).toJson());
+                qDebug() << "Comparison saved to:" << file.fileName();
+            }
+        }
+        return 0;
+    }
+    
+    if (parser.isSet(tuneOption)) {
+        ocr_orc::ParameterTuner tuner;
+        tuner.setBaseDirectory(baseDir);
+        if (tuner.prepareForms(parser.positionalArguments(), parser.value(tuneMaxSizeOption).toInt()) == 0) {
+            qCritical() << "ERROR: No forms could be prepared for tuning";
+            return 1;
+        }
+        
+        // Trials share the cores; --threads limits how many run at once
+        ocr_orc::ParameterTuner::Options options;
+        options.maxTrials = parser.value(tuneTrialsOption).toInt();
+        options.patience = parser.value(tunePatienceOption).toInt();
+        options.seed = parser.value(tuneSeedOption).toUInt();
+        if (parser.isSet(threadsOption)) {
+            options.workers = parser.value(threadsOption).toInt();
+        }
+        QList<ocr_orc::TuningTrial> trials = tuner.run(options);
+        
+        fprintf(stdout, "Pareto front (precision, recall and runtime timed alone), %lld trials:\n", (long long)trials.size());
+        for (int index : ocr_orc::ParameterTuner::paretoFront(trials)) {
+            const ocr_orc::TuningTrial& t = trials[index];
+            fprintf(stdout, "  #%-4d P %.4f  R %.4f  F1 %.4f  %7.1f ms\n",
+                    t.index, t.precision, t.recall, t.f1Score, t.runtimeMs);
+        }
+        fflush(stdout);
+        
+        int best = ocr_orc::ParameterTuner::bestTrial(trials);
+        if (generateReports) {
+            QString reportPath = QDir(outputDir).filePath("tuning_results.json");
+            if (tuner.saveReport(trials, reportPath)) {
+                qDebug() << "Tuning results saved to:" << reportPath;
+            }
+            if (best >= 0) {
+                // Loadable from the Magic Detect dialog with "Load Preset..."
+                QString presetPath = QDir(outputDir).filePath("tuned_preset.json");
+                QString presetName = QString("Tuned (F1 %1, %2 form(s))")
+                                         .arg(trials[best].f1Score, 0, 'f', 3).arg(tuner.getFormCount());
+                try {
+                    ocr_orc::DetectionPresetIO::exportToFile(trials[best].params, presetName, presetPath);
+                    qDebug() << "Best configuration saved as preset:" << presetPath;
+                } catch (const std::exception& e) {
+                    qWarning() << "Failed to save tuned preset:" << e.what();
+                }
+            }
+        }
+        return best >= 0 ? 0 : 1;
+    }
+    
     ocr_orc::TestReporter* reporter = runner.getReporter();
     
     // #region agent log
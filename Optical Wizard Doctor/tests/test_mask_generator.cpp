@@ -7,6 +7,7 @@
 #include "../src/core/CoordinateSystem.h"
 #include <QtCore/QFile>
 #include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
 #include <QtGui/QImage>
 
 using namespace ocr_orc;
@@ -21,6 +22,10 @@ private slots:
     void testGenerateWithRegions();
     void testGenerateMaskFormat();
     void testGenerateImageSize();
+    void testShapesAndRotation();
+    void testPerGroupMasks();
+    void testGeneratePbm();
+    void testGenerateMultiPageTiff();
 
 private:
     QTemporaryDir* tempDir;
@@ -140,6 +145,131 @@ void TestMaskGenerator::testGenerateImageSize() {
     QCOMPARE(mask.height(), 750);
 }
 
+void TestMaskGenerator::testShapesAndRotation() {
+    DocumentState state;
+    QImage testImage(200, 200, QImage::Format_RGB32);
+    testImage.fill(Qt::white);
+    state.setImage(testImage);
+    
+    // Circle centered at (50, 50), radius 20
+    state.addRegion("Circle", RegionData("Circle", NormalizedCoords(0.15, 0.15, 0.35, 0.35), "blue", "", "circle"));
+    // 60x10 bar centered at (150, 150), rotated 90 degrees -> 10x60
+    state.addRegion("Bar", RegionData("Bar", NormalizedCoords(0.60, 0.725, 0.90, 0.775), "red", "", "rect",
+                                      "none", "none", 90.0));
+    
+    QList<MaskPage> pages = MaskGenerator::renderMasks(state, false);
+    QCOMPARE(pages.size(), 1);
+    const QImage& mask = pages.first().mask;
+    QCOMPARE(mask.format(), QImage::Format_Mono);
+    QCOMPARE(mask.size(), QSize(200, 200));
+    
+    // Circle: center in, bounding box corner out
+    QCOMPARE(mask.pixelIndex(50, 50), 1);
+    QCOMPARE(mask.pixelIndex(32, 50), 1);
+    QCOMPARE(mask.pixelIndex(31, 31), 0);
+    
+    // Rotated bar: vertical extent in, original horizontal extent out
+    QCOMPARE(mask.pixelIndex(150, 125), 1);
+    QCOMPARE(mask.pixelIndex(150, 175), 1);
+    QCOMPARE(mask.pixelIndex(125, 150), 0);
+    QCOMPARE(mask.pixelIndex(175, 150), 0);
+}
+
+void TestMaskGenerator::testPerGroupMasks() {
+    DocumentState* state = createTestState();
+    state->createGroup("Left");
+    state->addRegionToGroup("Region1", "Left");
+    
+    QList<MaskPage> pages = MaskGenerator::renderMasks(*state, true);
+    QCOMPARE(pages.size(), 2);
+    QCOMPARE(pages[0].name, QString("all"));
+    QCOMPARE(pages[1].name, QString("Left"));
+    
+    // Region1 (x 500-700) in both, Region2 (x 800-1000) only in the full mask
+    QCOMPARE(pages[0].mask.pixelIndex(600, 450), 1);
+    QCOMPARE(pages[0].mask.pixelIndex(900, 450), 1);
+    QCOMPARE(pages[1].mask.pixelIndex(600, 450), 1);
+    QCOMPARE(pages[1].mask.pixelIndex(900, 450), 0);
+    
+    delete state;
+}
+
+void TestMaskGenerator::testGeneratePbm() {
+    DocumentState* state = createTestState();
+    QString filePath = getTempFilePath("mask.pbm");
+    
+    MaskGenerator::generate(*state, filePath);
+    
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray bytes = file.readAll();
+    QVERIFY(bytes.startsWith("P4\n"));
+    QByteArray header = "P4\n# all\n2000 3000\n";
+    QCOMPARE(bytes.size(), header.size() + 250 * 3000);
+    
+    // PBM is 1 = black: row 0 all black, Region1 starts at byte 500 / 8 on row 450
+    QCOMPARE(static_cast<uchar>(bytes[header.size()]), static_cast<uchar>(0xFF));
+    QCOMPARE(static_cast<uchar>(bytes[header.size() + 450 * 250 + 63]), static_cast<uchar>(0x00));
+    
+    QImage mask(filePath);
+    QVERIFY(!mask.isNull());
+    QCOMPARE(mask.size(), QSize(2000, 3000));
+    
+    delete state;
+}
+
+void TestMaskGenerator::testGenerateMultiPageTiff() {
+    DocumentState* state = createTestState();
+    state->createGroup("Left");
+    state->addRegionToGroup("Region1", "Left");
+    
+    QString filePath = getTempFilePath("masks.tif");
+    MaskGenerator::generate(*state, filePath);
+    
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray bytes = file.readAll();
+    QVERIFY(bytes.startsWith(QByteArray("II*\0", 4)));
+    
+    // Walk the IFD chain
+    auto u16 = [&bytes](int offset) { return qFromLittleEndian<quint16>(bytes.constData() + offset); };
+    auto u32 = [&bytes](int offset) { return qFromLittleEndian<quint32>(bytes.constData() + offset); };
+    int pageCount = 0;
+    quint32 ifd = u32(4);
+    while (ifd != 0 && pageCount < 10) {
+        QVERIFY(ifd + 2 <= static_cast<quint32>(bytes.size()));
+        quint16 entries = u16(ifd);
+        ifd = u32(ifd + 2 + entries * 12);
+        pageCount++;
+    }
+    QCOMPARE(pageCount, 2);
+    
+    // Batch of two pages with one group each -> four pages
+    QString batchPath = getTempFilePath("batch.tif");
+    MaskGenerator::generateBatch({state, state}, batchPath);
+    QFile batch(batchPath);
+    QVERIFY(batch.open(QIODevice::ReadOnly));
+    bytes = batch.readAll();
+    pageCount = 0;
+    ifd = u32(4);
+    while (ifd != 0 && pageCount < 10) {
+        quint16 entries = u16(ifd);
+        ifd = u32(ifd + 2 + entries * 12);
+        pageCount++;
+    }
+    QCOMPARE(pageCount, 4);
+    
+    // Batch only supports multi-page formats
+    try {
+        MaskGenerator::generateBatch({state}, getTempFilePath("batch.png"));
+        QFAIL("Should have thrown exception for single-page format");
+    } catch (const std::runtime_error&) {
+        // Expected
+    }
+    
+    delete state;
+}
+
 QTEST_MAIN(TestMaskGenerator)
 #include "test_mask_generator.moc"
 
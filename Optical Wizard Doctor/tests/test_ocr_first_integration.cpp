@@ -3,7 +3,11 @@
 
 #include <QtTest/QtTest>
 #include "../src/utils/RegionDetector.h"
+#include "../src/utils/DetectionProgressChannel.h"
+#include "../src/utils/PageAnalysisCache.h"
+#include "../src/ui/components/dialogs/MagicDetectParamsDialog.h"
 #include <QtGui/QImage>
+#include <QtGui/QPainter>
 
 using namespace ocr_orc;
 
@@ -15,12 +19,41 @@ private slots:
     void testOcrFirstMethod();
     void testConfidenceFiltering();
     void testGroupInference();
+    void testPublishesLayersInOrder();
+    void testStopsWhenCancelled();
+    void testStage1UsesCachedOcr();
     // Note: Full integration tests require:
     // - Tesseract installation
     // - Test form images
     // - Ground truth data for validation
+
+private:
+    static QImage createSeededForm();
 };
 
+QImage TestOcrFirstIntegration::createSeededForm() {
+    QImage page(1200, 1600, QImage::Format_RGB32);
+    page.fill(Qt::white);
+    QPainter painter(&page);
+    painter.setPen(QPen(Qt::black, 3));
+    QList<OCRTextRegion> labels;
+    for (int row = 0; row < 3; ++row) {
+        const int y = 200 + row * 300;
+        painter.drawRect(450, y, 600, 100);
+        OCRTextRegion label;
+        label.text = QString("Label %1:").arg(row + 1);
+        label.boundingBox = cv::Rect(120, y + 30, 240, 40);
+        label.confidence = 90.0;
+        labels.append(label);
+    }
+    painter.end();
+    
+    // Stage 1 finds these in the page cache, so the run needs no Tesseract data
+    PageAnalysisCache::instance().storeOcr(PageAnalysisCache::pageKey(page),
+                                           OcrTextExtractor::TWO_TIER_RECOGNITION, labels);
+    return page;
+}
+
 void TestOcrFirstIntegration::testFullPipeline() {
     // This would test the full OCR-first pipeline:
     // 1. OCR extraction
@@ -60,5 +93,67 @@ void TestOcrFirstIntegration::testGroupInference() {
     QVERIFY(true);  // Placeholder
 }
 
+void TestOcrFirstIntegration::testPublishesLayersInOrder() {
+    QImage page = createSeededForm();
+    DetectionProgressChannel channel;
+    RegionDetector detector;
+    detector.setProgressChannel(&channel);
+    
+    detector.detectRegionsOCRFirst(page, "ocr-first", DetectionParameters());
+    QVERIFY(!channel.isCancelled());
+    
+    QList<PartialDetectionLayer> layers = channel.getLayers();
+    QCOMPARE(layers.size(), 3);
+    QCOMPARE(layers[0].kind, PartialDetectionLayer::OCR_WORDS);
+    QCOMPARE(layers[0].regions.size(), 3);
+    QCOMPARE(layers[1].kind, PartialDetectionLayer::RECTANGLE_CANDIDATES);
+    QCOMPARE(layers[2].kind, PartialDetectionLayer::CONSENSUS_REGIONS);
+    QVERIFY(layers[0].elapsedMs <= layers[1].elapsedMs);
+    QVERIFY(layers[1].elapsedMs <= layers[2].elapsedMs);
+}
+
+void TestOcrFirstIntegration::testStopsWhenCancelled() {
+    QImage page = createSeededForm();
+    DetectionProgressChannel channel;
+    // Cancel as soon as the first layer arrives, as the UI would
+    channel.setListener([&channel](const PartialDetectionLayer&) {
+        channel.requestCancel();
+    });
+    RegionDetector detector;
+    detector.setProgressChannel(&channel);
+    
+    DetectionResult result = detector.detectRegionsOCRFirst(page, "ocr-first", DetectionParameters());
+    QVERIFY(channel.isCancelled());
+    QCOMPARE(channel.getLayers().size(), 1);
+    QCOMPARE(channel.getLayers().first().kind, PartialDetectionLayer::OCR_WORDS);
+    QVERIFY(result.regions.isEmpty());
+    
+    // A cancelled channel drops anything published later, and reset() starts over
+    channel.reset();
+    QVERIFY(!channel.isCancelled());
+    QVERIFY(channel.getLayers().isEmpty());
+}
+
+void TestOcrFirstIntegration::testStage1UsesCachedOcr() {
+    QImage page = createSeededForm();
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    const int hitsBefore = cache.getHitCount();
+    DetectionProgressChannel channel;
+    RegionDetector detector;
+    detector.setProgressChannel(&channel);
+    
+    detector.detectRegionsOCRFirst(page, "ocr-first", DetectionParameters());
+    
+    // The seeded words come back unchanged instead of a fresh OCR pass
+    QVERIFY(cache.getHitCount() > hitsBefore);
+    QList<PartialDetectionLayer> layers = channel.getLayers();
+    QVERIFY(!layers.isEmpty());
+    QCOMPARE(layers[0].kind, PartialDetectionLayer::OCR_WORDS);
+    QCOMPARE(layers[0].regions.size(), 3);
+    for (int row = 0; row < 3; ++row) {
+        QCOMPARE(layers[0].regions[row].boundingBox, cv::Rect(120, 200 + row * 300 + 30, 240, 40));
+    }
+}
+
 QTEST_MAIN(TestOcrFirstIntegration)
 #include "test_ocr_first_integration.moc"
@@ -15,6 +15,7 @@ private slots:
     void testPreprocessing();
     void testTypeInference();
     void testConfidenceFiltering();
+    void testRegionsOfInterestOutsideImage();
     // Note: Full OCR extraction tests require Tesseract installation
     // and test images - these would be integration tests
 };
@@ -69,5 +70,27 @@ void TestOcrTextExtractor::testConfidenceFiltering() {
     QVERIFY(filtered[1].confidence == 80.0);
 }
 
+void TestOcrTextExtractor::testRegionsOfInterestOutsideImage() {
+    OcrTextExtractor extractor;
+    QList<cv::Rect> rois = {cv::Rect(10, 10, 50, 20), cv::Rect(500, 500, 40, 40)};
+    
+    // Null image: one empty result per ROI, in order
+    QList<OCRRoiResult> results = extractor.extractTextInRegions(QImage(), rois);
+    QCOMPARE(results.size(), 2);
+    QVERIFY(results[0].text.isEmpty());
+    QVERIFY(results[1].words.isEmpty());
+    
+    // ROIs are clamped to the image; ones fully outside come back empty
+    cv::Mat page(100, 200, CV_8UC1, cv::Scalar(255));
+    QList<cv::Rect> outside = {cv::Rect(300, 0, 20, 20), cv::Rect(-50, -50, 10, 10)};
+    results = extractor.extractTextInRegions(page, outside);
+    QCOMPARE(results.size(), 2);
+    QVERIFY(results[0].roi.empty());
+    QVERIFY(results[1].roi.empty());
+    QCOMPARE(results[0].confidence, 0.0);
+    
+    QVERIFY(extractor.extractTextInRegions(page, QList<cv::Rect>()).isEmpty());
+}
+
 QTEST_MAIN(TestOcrTextExtractor)
 #include "test_ocr_text_extractor.moc"
@@ -0,0 +1,159 @@
+// Test file for PageAnalysisCache
+// Checks page keys, per-mode OCR entries, page eviction and waiting on in-flight OCR
+
+#include <QtTest/QtTest>
+#include "../src/utils/PageAnalysisCache.h"
+#include <atomic>
+#include <thread>
+
+using namespace ocr_orc;
+
+class TestPageAnalysisCache : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testPageKeyFollowsPixels();
+    void testOcrEntriesArePerMode();
+    void testNewPageEvictsOldEntry();
+    void testFinishAfterSupersedeIsDropped();
+    void testLookupWaitsForInFlightOcr();
+    void testAbandonWakesWaiter();
+    void testRectangles();
+
+private:
+    static QImage page(int seed);
+    static QList<OCRTextRegion> words(int count);
+};
+
+QImage TestPageAnalysisCache::page(int seed) {
+    QImage image(120, 80, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    image.setPixel(seed % 120, seed % 80, qRgb(0, 0, 0));
+    return image;
+}
+
+QList<OCRTextRegion> TestPageAnalysisCache::words(int count) {
+    QList<OCRTextRegion> regions;
+    for (int i = 0; i < count; ++i) {
+        OCRTextRegion region;
+        region.text = QString("word%1").arg(i);
+        region.boundingBox = cv::Rect(i * 10, 5, 8, 6);
+        regions.append(region);
+    }
+    return regions;
+}
+
+void TestPageAnalysisCache::init() {
+    PageAnalysisCache::instance().clear();
+}
+
+void TestPageAnalysisCache::testPageKeyFollowsPixels() {
+    QCOMPARE(PageAnalysisCache::pageKey(page(1)), PageAnalysisCache::pageKey(page(1)));
+    QVERIFY(PageAnalysisCache::pageKey(page(1)) != PageAnalysisCache::pageKey(page(2)));
+    QVERIFY(PageAnalysisCache::pageKey(page(1)) !=
+            PageAnalysisCache::pageKey(page(1).convertToFormat(QImage::Format_ARGB32)));
+    QCOMPARE(PageAnalysisCache::pageKey(QImage()), quint64(0));
+}
+
+void TestPageAnalysisCache::testOcrEntriesArePerMode() {
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    const quint64 key = PageAnalysisCache::pageKey(page(1));
+    cache.storeOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION, words(3));
+
+    QList<OCRTextRegion> found;
+    QVERIFY(cache.lookupOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION, found));
+    QCOMPARE(found.size(), 3);
+    QCOMPARE(found[2].text, QString("word2"));
+    QVERIFY(!cache.lookupOcr(key, OcrTextExtractor::FULL_PAGE_RECOGNITION, found));
+}
+
+void TestPageAnalysisCache::testNewPageEvictsOldEntry() {
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    const quint64 first = PageAnalysisCache::pageKey(page(1));
+    const quint64 second = PageAnalysisCache::pageKey(page(2));
+    cache.storeOcr(first, OcrTextExtractor::TWO_TIER_RECOGNITION, words(2));
+    cache.storeOcr(second, OcrTextExtractor::TWO_TIER_RECOGNITION, words(4));
+
+    QList<OCRTextRegion> found;
+    QVERIFY(!cache.lookupOcr(first, OcrTextExtractor::TWO_TIER_RECOGNITION, found));
+    QVERIFY(cache.lookupOcr(second, OcrTextExtractor::TWO_TIER_RECOGNITION, found));
+    QCOMPARE(found.size(), 4);
+}
+
+void TestPageAnalysisCache::testFinishAfterSupersedeIsDropped() {
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    const quint64 first = PageAnalysisCache::pageKey(page(1));
+    const quint64 second = PageAnalysisCache::pageKey(page(2));
+    QVERIFY(cache.beginOcr(first, OcrTextExtractor::TWO_TIER_RECOGNITION));
+    QVERIFY(!cache.beginOcr(first, OcrTextExtractor::TWO_TIER_RECOGNITION));
+
+    // Another document is loaded before the speculative OCR finishes
+    cache.storeRectangles(second, QList<DetectedRectangle>());
+    QVERIFY(!cache.finishOcr(first, OcrTextExtractor::TWO_TIER_RECOGNITION, words(2)));
+
+    QList<DetectedRectangle> rectangles;
+    QVERIFY(cache.lookupRectangles(second, rectangles));
+    QList<OCRTextRegion> found;
+    QVERIFY(!cache.lookupOcr(first, OcrTextExtractor::TWO_TIER_RECOGNITION, found));
+}
+
+void TestPageAnalysisCache::testLookupWaitsForInFlightOcr() {
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    const quint64 key = PageAnalysisCache::pageKey(page(1));
+    QVERIFY(cache.beginOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION));
+
+    std::atomic<bool> finished(false);
+    std::thread producer([&cache, &finished, key]() {
+        QThread::msleep(50);
+        finished.store(true);
+        cache.finishOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION, words(5));
+    });
+
+    QList<OCRTextRegion> found;
+    QVERIFY(cache.lookupOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION, found, true));
+    QVERIFY(finished.load());
+    QCOMPARE(found.size(), 5);
+    producer.join();
+}
+
+void TestPageAnalysisCache::testAbandonWakesWaiter() {
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    const quint64 key = PageAnalysisCache::pageKey(page(1));
+    QVERIFY(cache.beginOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION));
+
+    std::thread producer([&cache, key]() {
+        QThread::msleep(50);
+        cache.abandonOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION);
+    });
+
+    const int missesBefore = cache.getMissCount();
+    QList<OCRTextRegion> found;
+    QVERIFY(!cache.lookupOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION, found, true));
+    QCOMPARE(cache.getMissCount(), missesBefore + 1);
+    producer.join();
+
+    // The reservation is free again
+    QVERIFY(cache.beginOcr(key, OcrTextExtractor::TWO_TIER_RECOGNITION));
+}
+
+void TestPageAnalysisCache::testRectangles() {
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    const quint64 key = PageAnalysisCache::pageKey(page(3));
+    QList<DetectedRectangle> rectangles;
+    QVERIFY(!cache.lookupRectangles(key, rectangles));
+
+    DetectedRectangle rectangle;
+    rectangle.boundingBox = cv::Rect(10, 10, 40, 20);
+    rectangle.type = "form_field";
+    cache.storeRectangles(key, QList<DetectedRectangle>({rectangle}));
+
+    const int hitsBefore = cache.getHitCount();
+    QVERIFY(cache.lookupRectangles(key, rectangles));
+    QCOMPARE(cache.getHitCount(), hitsBefore + 1);
+    QCOMPARE(rectangles.size(), 1);
+    QCOMPARE(rectangles[0].boundingBox.width, 40);
+}
+
+QTEST_MAIN(TestPageAnalysisCache)
+#include "test_page_analysis_cache.moc"
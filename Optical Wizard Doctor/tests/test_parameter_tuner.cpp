@@ -0,0 +1,107 @@
+// Test file for ParameterTuner
+// Checks the Pareto front, best-trial choice and that sampling stays inside the search space
+
+#include <QtTest/QtTest>
+#include "tuning/ParameterTuner.h"
+#include "../src/export/DetectionPresetIO.h"
+
+using namespace ocr_orc;
+
+class TestParameterTuner : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testParetoFront();
+    void testPrunedTrialsAreExcluded();
+    void testBestTrialPrefersFaster();
+    void testSamplingStaysInBounds();
+    void testSamplingIsSeeded();
+    void testZeroRadiusPerturbKeepsParameters();
+
+private:
+    static TuningTrial makeTrial(int index, double precision, double recall, double runtimeMs);
+};
+
+TuningTrial TestParameterTuner::makeTrial(int index, double precision, double recall, double runtimeMs) {
+    TuningTrial trial;
+    trial.index = index;
+    trial.precision = precision;
+    trial.recall = recall;
+    trial.f1Score = MetricsCalculator::calculateF1Score(precision, recall);
+    trial.runtimeMs = runtimeMs;
+    trial.formsEvaluated = 1;
+    return trial;
+}
+
+void TestParameterTuner::testParetoFront() {
+    QList<TuningTrial> trials;
+    trials << makeTrial(0, 0.80, 0.70, 100.0)   // Front: most accurate
+           << makeTrial(1, 0.70, 0.60, 40.0)    // Front: less accurate than 0 but faster
+           << makeTrial(2, 0.60, 0.75, 120.0)   // Front: most complete
+           << makeTrial(3, 0.90, 0.40, 100.0)   // Dominated by 4: same accuracy, slower
+           << makeTrial(4, 0.90, 0.40, 40.0)    // Front: most precise
+           << makeTrial(5, 0.70, 0.55, 60.0);   // Dominated by 1 on all three
+
+    QList<int> front = ParameterTuner::paretoFront(trials);
+    QCOMPARE(front.size(), 4);
+    QVERIFY(!front.contains(3));
+    QVERIFY(!front.contains(5));
+    // Sorted by F1, best first
+    QCOMPARE(front.first(), 0);
+}
+
+void TestParameterTuner::testPrunedTrialsAreExcluded() {
+    QList<TuningTrial> trials;
+    trials << makeTrial(0, 0.60, 0.60, 100.0);
+    TuningTrial pruned = makeTrial(1, 0.95, 0.95, 10.0);
+    pruned.pruned = true;
+    trials << pruned;
+
+    QCOMPARE(ParameterTuner::paretoFront(trials), QList<int>({0}));
+    QCOMPARE(ParameterTuner::bestTrial(trials), 0);
+    QCOMPARE(ParameterTuner::bestTrial(QList<TuningTrial>()), -1);
+}
+
+void TestParameterTuner::testBestTrialPrefersFaster() {
+    QList<TuningTrial> trials;
+    trials << makeTrial(0, 0.80, 0.80, 200.0)
+           << makeTrial(1, 0.80, 0.80, 150.0)
+           << makeTrial(2, 0.70, 0.90, 50.0);
+    QCOMPARE(ParameterTuner::bestTrial(trials), 1);
+}
+
+void TestParameterTuner::testSamplingStaysInBounds() {
+    std::mt19937 rng(7);
+    for (int i = 0; i < 200; ++i) {
+        DetectionParameters params = ParameterTuner::sampleRandom(rng);
+        QVERIFY(params.ocrOverlapThreshold >= 0.05 && params.ocrOverlapThreshold <= 0.35);
+        QVERIFY(params.iouThreshold >= 0.30 && params.iouThreshold <= 0.70);
+        QVERIFY(params.minHorizontalLines >= 1 && params.minHorizontalLines <= 6);
+        QVERIFY(params.minCheckboxSize < params.maxCheckboxSize);
+        QVERIFY(params.checkboxAspectRatioMin < params.checkboxAspectRatioMax);
+
+        DetectionParameters moved = ParameterTuner::perturb(params, 1.0, rng);
+        QVERIFY(moved.verticalOverfitPercent >= 30.0 && moved.verticalOverfitPercent <= 90.0);
+        QVERIFY(moved.checkboxRectangularity >= 0.40 && moved.checkboxRectangularity <= 0.80);
+        QVERIFY(moved.minCheckboxSize < moved.maxCheckboxSize);
+    }
+}
+
+void TestParameterTuner::testSamplingIsSeeded() {
+    std::mt19937 first(42);
+    std::mt19937 second(42);
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(DetectionPresetIO::toJson(ParameterTuner::sampleRandom(first)),
+                 DetectionPresetIO::toJson(ParameterTuner::sampleRandom(second)));
+    }
+}
+
+void TestParameterTuner::testZeroRadiusPerturbKeepsParameters() {
+    std::mt19937 rng(3);
+    DetectionParameters params = ParameterTuner::sampleRandom(rng);
+    DetectionParameters same = ParameterTuner::perturb(params, 0.0, rng);
+    QCOMPARE(DetectionPresetIO::toJson(same), DetectionPresetIO::toJson(params));
+}
+
+QTEST_MAIN(TestParameterTuner)
+#include "test_parameter_tuner.moc"
@@ -0,0 +1,122 @@
+// Test file for PdfLoadWorker
+// Checks signal order, preview size and that superseded or cancelled loads stay silent,
+// and the format and size of the gray detection raster
+
+#include <QtTest/QtTest>
+#include "../src/ui/utils/PdfLoadWorker.h"
+#include "../src/utils/PdfLoader.h"
+#include "../src/core/Constants.h"
+#include "TestPdfWriter.h"
+#include <QtCore/QTemporaryDir>
+
+using namespace ocr_orc;
+
+class TestPdfLoadWorker : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testPreviewArrivesFirstWithFullSize();
+    void testSupersededLoadNeverEmits();
+    void testCancelledLoadNeverEmits();
+    void testLoadPdfFirstPageGray();
+
+private:
+    static QSize pixelSize(const QSizeF& points, int dpi);
+
+    QTemporaryDir tempDir;
+    QString letterPdf;
+    QString smallPdf;
+};
+
+QSize TestPdfLoadWorker::pixelSize(const QSizeF& points, int dpi) {
+    return QSize(qRound(points.width() * dpi / 72.0), qRound(points.height() * dpi / 72.0));
+}
+
+void TestPdfLoadWorker::initTestCase() {
+    QVERIFY(tempDir.isValid());
+    letterPdf = tempDir.filePath("letter.pdf");
+    smallPdf = tempDir.filePath("small.pdf");
+    QVERIFY(TestPdfWriter::writeOnePagePdf(letterPdf, QSizeF(612, 792), QRectF(72, 72, 144, 36)));
+    QVERIFY(TestPdfWriter::writeOnePagePdf(smallPdf, QSizeF(288, 144), QRectF(36, 36, 72, 36)));
+}
+
+void TestPdfLoadWorker::testPreviewArrivesFirstWithFullSize() {
+    PdfLoadWorker worker;
+    QStringList order;
+    QImage preview;
+    QImage full;
+    connect(&worker, &PdfLoadWorker::previewReady, this, [&](int, const QString&, const QImage& image) {
+        order << "preview";
+        preview = image;
+    });
+    connect(&worker, &PdfLoadWorker::loadComplete, this, [&](int, const QString&, const QImage& image) {
+        order << "full";
+        full = image;
+    });
+    QSignalSpy detectionSpy(&worker, &PdfLoadWorker::detectionPageReady);
+
+    worker.startLoad(letterPdf);
+    QVERIFY(worker.isLoading());
+    QVERIFY(detectionSpy.wait(10000));
+
+    QCOMPARE(order, QStringList({"preview", "full"}));
+    QCOMPARE(full.size(), pixelSize(QSizeF(612, 792), PdfConstants::DEFAULT_DPI));
+    QCOMPARE(preview.size(), full.size());
+    QVERIFY(!worker.isLoading());
+}
+
+void TestPdfLoadWorker::testSupersededLoadNeverEmits() {
+    PdfLoadWorker worker;
+    QList<int> emittedIds;
+    auto record = [&emittedIds](int loadId, const QString&, const QImage&) { emittedIds << loadId; };
+    connect(&worker, &PdfLoadWorker::previewReady, this, record);
+    connect(&worker, &PdfLoadWorker::loadComplete, this, record);
+    connect(&worker, &PdfLoadWorker::detectionPageReady, this, record);
+    QSignalSpy detectionSpy(&worker, &PdfLoadWorker::detectionPageReady);
+
+    const int first = worker.startLoad(letterPdf);
+    const int second = worker.startLoad(smallPdf);
+    QVERIFY(second != first);
+    QCOMPARE(worker.currentLoadId(), second);
+
+    QVERIFY(detectionSpy.wait(10000));
+    QTest::qWait(200);  // Let any late result of the first load arrive
+    QVERIFY(!emittedIds.isEmpty());
+    for (int loadId : emittedIds) {
+        QCOMPARE(loadId, second);
+    }
+    QCOMPARE(detectionSpy.count(), 1);
+}
+
+void TestPdfLoadWorker::testCancelledLoadNeverEmits() {
+    PdfLoadWorker worker;
+    QSignalSpy previewSpy(&worker, &PdfLoadWorker::previewReady);
+    QSignalSpy completeSpy(&worker, &PdfLoadWorker::loadComplete);
+    QSignalSpy failedSpy(&worker, &PdfLoadWorker::loadFailed);
+
+    worker.startLoad(letterPdf);
+    worker.cancel();
+    QVERIFY(!worker.isLoading());
+
+    QTest::qWait(1000);
+    QCOMPARE(previewSpy.count() + completeSpy.count() + failedSpy.count(), 0);
+}
+
+void TestPdfLoadWorker::testLoadPdfFirstPageGray() {
+    QImage gray = PdfLoader::loadPdfFirstPageGray(letterPdf);
+    QVERIFY(!gray.isNull());
+    QCOMPARE(gray.format(), QImage::Format_Grayscale8);
+    QCOMPARE(gray.size(), pixelSize(QSizeF(612, 792), PdfConstants::DETECTION_DPI));
+
+    // The black rectangle (72,72 144x36 pt) is rendered dark on a white page
+    const QPoint inside = QPoint(qRound(144 * PdfConstants::DETECTION_DPI / 72.0),
+                                 qRound(90 * PdfConstants::DETECTION_DPI / 72.0));
+    QVERIFY(qGray(gray.pixel(inside)) < 64);
+    QVERIFY(qGray(gray.pixel(5, 5)) > 192);
+
+    QVERIFY(PdfLoader::loadPdfFirstPageGray(tempDir.filePath("missing.pdf")).isNull());
+}
+
+QTEST_MAIN(TestPdfLoadWorker)
+#include "test_pdf_load_worker.moc"
@@ -0,0 +1,269 @@
+// Test file for ProjectExporter / ProjectImporter
+// Tests the memory-mapped binary project format
+
+#include <QtTest/QtTest>
+#include "../src/export/ProjectExporter.h"
+#include "../src/export/ProjectImporter.h"
+#include "../src/models/DocumentState.h"
+#include "../src/utils/PageAnalysisCache.h"
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtGui/QColor>
+
+using namespace ocr_orc;
+
+class TestProjectFile : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testRoundTrip();
+    void testViewIsZeroCopy();
+    void testOcrWords();
+    void testOcrWordsRoundTripThroughPageCache();
+    void testEmptyDocument();
+    void testRejectsCorruptFiles();
+    void testSkipsInvalidRegions();
+
+private:
+    QTemporaryDir* tempDir;
+    DocumentState makeState();
+};
+
+void TestProjectFile::initTestCase() {
+    tempDir = new QTemporaryDir();
+    QVERIFY(tempDir->isValid());
+}
+
+void TestProjectFile::cleanupTestCase() {
+    delete tempDir;
+}
+
+DocumentState TestProjectFile::makeState() {
+    DocumentState state;
+    state.pdfPath = "/forms/intake.pdf";
+    state.image = QImage(120, 80, QImage::Format_ARGB32);
+    state.image.fill(QColor(10, 20, 30));
+    state.image.setPixelColor(5, 7, QColor(200, 100, 50));
+
+    state.addRegion("Name", RegionData("Name", NormalizedCoords(0.1, 0.1, 0.4, 0.15), "red", "", "rect", "letters"));
+    state.addRegion("Date", RegionData("Date", NormalizedCoords(0.5, 0.1, 0.7, 0.15), "blue", "", "rect", "numbers", "none", 3.5));
+    state.addRegion("Check", RegionData("Check", NormalizedCoords(0.1, 0.5, 0.12, 0.53), "green", "", "circle", "none", "standard"));
+    state.createGroup("Header");
+    state.addRegionToGroup("Name", "Header");
+    state.addRegionToGroup("Date", "Header");
+    return state;
+}
+
+void TestProjectFile::testRoundTrip() {
+    DocumentState original = makeState();
+    QString filePath = tempDir->filePath("roundtrip.orcproj");
+    ProjectExporter::exportToFile(original, filePath);
+    QVERIFY(ProjectImporter::isProjectFile(filePath));
+    QVERIFY(!QFile::exists(filePath + ".tmp"));
+
+    DocumentState imported;
+    ProjectImporter::importFromFile(imported, filePath);
+
+    QCOMPARE(imported.pdfPath, original.pdfPath);
+    QCOMPARE(imported.image.size(), original.image.size());
+    QCOMPARE(imported.image.pixelColor(5, 7), QColor(200, 100, 50));
+    QCOMPARE(imported.regions.size(), 3);
+    for (const QString& name : original.getAllRegionNames()) {
+        QVERIFY(imported.hasRegion(name));
+        QVERIFY(imported.getRegion(name) == original.getRegion(name));
+    }
+
+    // Group member order is preserved
+    QVERIFY(imported.hasGroup("Header"));
+    QCOMPARE(imported.getGroup("Header").regionNames, original.getGroup("Header").regionNames);
+}
+
+void TestProjectFile::testViewIsZeroCopy() {
+    DocumentState original = makeState();
+    QString filePath = tempDir->filePath("view.orcproj");
+    ProjectExporter::exportToFile(original, filePath);
+
+    QImage image;
+    {
+        ProjectFileView view(filePath);
+        QCOMPARE(view.versionMajor(), ProjectFormat::VERSION_MAJOR);
+        QCOMPARE(view.regionCount(), 3);
+
+        // Regions are stored in name order as columns
+        QCOMPARE(view.string(view.regionName()[0]), QString("Check"));
+        QCOMPARE(view.regionX1()[1], 0.5);
+        QCOMPARE(view.regionRotation()[1], 3.5);
+
+        image = view.image();
+    }
+
+    // The image outlives the view and still reads the mapped pixels
+    QCOMPARE(image.width(), 120);
+    QCOMPARE(image.pixelColor(5, 7), QColor(200, 100, 50));
+}
+
+void TestProjectFile::testOcrWords() {
+    DocumentState original = makeState();
+    QList<ProjectOcrWord> words;
+    for (int i = 0; i < 3; ++i) {
+        ProjectOcrWord word;
+        word.coords = NormalizedCoords(0.1 * i, 0.2, 0.1 * i + 0.05, 0.25);
+        word.text = QString("word%1").arg(i);
+        word.confidence = 90.0f + i;
+        word.blockId = 1;
+        word.lineId = 2;
+        word.wordId = i;
+        words.append(word);
+    }
+
+    QString filePath = tempDir->filePath("ocr.orcproj");
+    ProjectExporter::exportToFile(original, filePath, words);
+
+    DocumentState imported;
+    QList<ProjectOcrWord> importedWords;
+    ProjectImporter::importFromFile(imported, filePath, &importedWords);
+
+    QCOMPARE(importedWords.size(), 3);
+    QCOMPARE(importedWords[2].text, QString("word2"));
+    QCOMPARE(importedWords[2].wordId, 2);
+    QCOMPARE(importedWords[1].confidence, 91.0f);
+    QCOMPARE(importedWords[1].coords.x1, 0.1);
+}
+
+void TestProjectFile::testOcrWordsRoundTripThroughPageCache() {
+    PageAnalysisCache& cache = PageAnalysisCache::instance();
+    cache.clear();
+
+    // OCR that a detection (or the speculative run) left for the page
+    DocumentState original = makeState();
+    QList<OCRTextRegion> regions;
+    for (int i = 0; i < 4; ++i) {
+        OCRTextRegion region;
+        region.text = QString("word%1").arg(i);
+        region.boundingBox = cv::Rect(i * 30, 40, 24, 8);
+        region.coords = CoordinateSystem::imageToNormalized(ImageCoords(i * 30, 40, i * 30 + 24, 48), 120, 80);
+        region.confidence = 80.0 + i;
+        region.lineId = 1;
+        region.wordId = i;
+        regions.append(region);
+    }
+    cache.storeOcr(PageAnalysisCache::pageKey(original.getDetectionImage()),
+                   OcrTextExtractor::TWO_TIER_RECOGNITION, regions);
+
+    QString filePath = tempDir->filePath("cached_ocr.orcproj");
+    ProjectExporter::exportToFile(original, filePath, cache.projectOcrWords(original.getDetectionImage()));
+    cache.clear();
+
+    DocumentState imported;
+    QList<ProjectOcrWord> importedWords;
+    ProjectImporter::importFromFile(imported, filePath, &importedWords);
+    QCOMPARE(importedWords.size(), 4);
+    cache.seedFromProject(imported.getDetectionImage(), importedWords);
+
+    // Detection on the imported raster finds the OCR without running it
+    QList<OCRTextRegion> cached;
+    QVERIFY(cache.lookupOcr(PageAnalysisCache::pageKey(imported.getDetectionImage()),
+                            OcrTextExtractor::TWO_TIER_RECOGNITION, cached));
+    QCOMPARE(cached.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(cached[i].text, regions[i].text);
+        QCOMPARE(cached[i].boundingBox, regions[i].boundingBox);
+        QCOMPARE(cached[i].confidence, regions[i].confidence);
+        QCOMPARE(cached[i].wordId, i);
+    }
+
+    // Nothing cached for a page means nothing is saved
+    cache.clear();
+    QVERIFY(cache.projectOcrWords(original.getDetectionImage()).isEmpty());
+}
+
+void TestProjectFile::testEmptyDocument() {
+    DocumentState empty;
+    QString filePath = tempDir->filePath("empty.orcproj");
+    ProjectExporter::exportToFile(empty, filePath);
+
+    DocumentState imported = makeState();
+    ProjectImporter::importFromFile(imported, filePath);
+    QVERIFY(imported.regions.isEmpty());
+    QVERIFY(imported.groups.isEmpty());
+    QVERIFY(imported.image.isNull());
+}
+
+void TestProjectFile::testRejectsCorruptFiles() {
+    DocumentState original = makeState();
+    QString filePath = tempDir->filePath("corrupt.orcproj");
+    ProjectExporter::exportToFile(original, filePath);
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray bytes = file.readAll();
+    file.close();
+
+    // Truncated
+    QString truncatedPath = tempDir->filePath("truncated.orcproj");
+    QFile truncated(truncatedPath);
+    QVERIFY(truncated.open(QIODevice::WriteOnly));
+    truncated.write(bytes.left(bytes.size() / 2));
+    truncated.close();
+
+    DocumentState state = makeState();
+    try {
+        ProjectImporter::importFromFile(state, truncatedPath);
+        QFAIL("Should have thrown exception for invalid project file");
+    } catch (const std::runtime_error&) {
+        // Expected
+    }
+    QCOMPARE(state.regions.size(), 3); // Untouched
+
+    // Future major version
+    QByteArray future = bytes;
+    future[8] = static_cast<char>(ProjectFormat::VERSION_MAJOR + 1);
+    QString futurePath = tempDir->filePath("future.orcproj");
+    QFile futureFile(futurePath);
+    QVERIFY(futureFile.open(QIODevice::WriteOnly));
+    futureFile.write(future);
+    futureFile.close();
+    try {
+        ProjectImporter::importFromFile(state, futurePath);
+        QFAIL("Should have thrown exception for invalid project file");
+    } catch (const std::runtime_error&) {
+        // Expected
+    }
+
+    // Not a project at all
+    QString jsonPath = tempDir->filePath("not_project.orcproj");
+    QFile jsonFile(jsonPath);
+    QVERIFY(jsonFile.open(QIODevice::WriteOnly));
+    jsonFile.write("{\"regions\": {}}");
+    jsonFile.close();
+    QVERIFY(!ProjectImporter::isProjectFile(jsonPath));
+    try {
+        ProjectImporter::importFromFile(state, jsonPath);
+        QFAIL("Should have thrown exception for invalid project file");
+    } catch (const std::runtime_error&) {
+        // Expected
+    }
+}
+
+void TestProjectFile::testSkipsInvalidRegions() {
+    DocumentState original = makeState();
+    original.addRegion("Inverted", RegionData("Inverted", NormalizedCoords(0.6, 0.6, 0.3, 0.7)));
+    original.addRegion("OffPage", RegionData("OffPage", NormalizedCoords(0.8, 0.2, 1.4, 0.3)));
+    original.addRegion("Flat", RegionData("Flat", NormalizedCoords(0.2, 0.4, 0.5, 0.4)));
+    QString filePath = tempDir->filePath("invalid_regions.orcproj");
+    ProjectExporter::exportToFile(original, filePath);
+
+    // Same rules as the JSON importer: in [0, 1], x1 < x2, y1 < y2
+    DocumentState imported;
+    ProjectImporter::importFromFile(imported, filePath);
+    QCOMPARE(imported.regions.size(), 3);
+    QVERIFY(!imported.hasRegion("Inverted"));
+    QVERIFY(!imported.hasRegion("OffPage"));
+    QVERIFY(!imported.hasRegion("Flat"));
+}
+
+QTEST_MAIN(TestProjectFile)
+#include "test_project_file.moc"
@@ -0,0 +1,140 @@
+// Test file for SidePanelListModel and SidePanelListProxyModel
+// Checks that list updates are reported as fine-grained row changes
+
+#include <QtTest/QtTest>
+#include <QtTest/QAbstractItemModelTester>
+#include "../src/ui/components/widgets/SidePanelListModel.h"
+#include "../src/ui/components/widgets/SidePanelListProxyModel.h"
+
+using namespace ocr_orc;
+
+class TestSidePanelListModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPlaceholderWhenEmpty();
+    void testInsertIsIncremental();
+    void testRemoveIsIncremental();
+    void testLabelChangeIsDataChanged();
+    void testUnchangedUpdateEmitsNothing();
+    void testIndexOf();
+    void testProxyNaturalSortAndFilter();
+
+private:
+    static QList<SidePanelListModel::Item> items(const QStringList& names);
+};
+
+QList<SidePanelListModel::Item> TestSidePanelListModel::items(const QStringList& names) {
+    QList<SidePanelListModel::Item> result;
+    for (const QString& name : names) {
+        result.append({name, name});
+    }
+    return result;
+}
+
+void TestSidePanelListModel::testPlaceholderWhenEmpty() {
+    SidePanelListModel model("Nothing here");
+    QAbstractItemModelTester tester(&model);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.itemCount(), 0);
+    QCOMPARE(model.index(0).data().toString(), QString("Nothing here"));
+    QCOMPARE(model.flags(model.index(0)), Qt::NoItemFlags);
+
+    model.setItems(items({"a", "b"}));
+    QCOMPARE(model.rowCount(), 2);
+    model.setItems(items({}));
+    QCOMPARE(model.rowCount(), 1);
+}
+
+void TestSidePanelListModel::testInsertIsIncremental() {
+    SidePanelListModel model("Empty");
+    QAbstractItemModelTester tester(&model);
+    model.setItems(items({"a", "c", "e"}));
+
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    model.setItems(items({"a", "b", "c", "d", "e", "f"}));
+
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(inserted.count(), 3);
+    QCOMPARE(model.rowCount(), 6);
+    QCOMPARE(model.index(3).data(SidePanelListModel::NameRole).toString(), QString("d"));
+}
+
+void TestSidePanelListModel::testRemoveIsIncremental() {
+    SidePanelListModel model("Empty");
+    QAbstractItemModelTester tester(&model);
+    model.setItems(items({"a", "b", "c", "d", "e"}));
+
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    model.setItems(items({"a", "e"}));
+
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(removed.count(), 1);  // b..d as one run
+    QCOMPARE(removed[0][1].toInt(), 1);
+    QCOMPARE(removed[0][2].toInt(), 3);
+    QCOMPARE(model.rowCount(), 2);
+}
+
+void TestSidePanelListModel::testLabelChangeIsDataChanged() {
+    SidePanelListModel model("Empty");
+    QAbstractItemModelTester tester(&model);
+    model.setItems(items({"a", "b"}));
+
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    QList<SidePanelListModel::Item> grouped = items({"a", "b"});
+    grouped[1].label = "b [header]";
+    model.setItems(grouped);
+
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed[0][0].value<QModelIndex>().row(), 1);
+    QCOMPARE(model.index(1).data().toString(), QString("b [header]"));
+}
+
+void TestSidePanelListModel::testUnchangedUpdateEmitsNothing() {
+    SidePanelListModel model("Empty");
+    model.setItems(items({"a", "b", "c"}));
+
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    model.setItems(items({"a", "b", "c"}));
+
+    QCOMPARE(inserted.count() + removed.count() + changed.count() + reset.count(), 0);
+}
+
+void TestSidePanelListModel::testIndexOf() {
+    SidePanelListModel model("Empty");
+    model.setItems(items({"a", "b", "c"}));
+    QCOMPARE(model.indexOf("c").row(), 2);
+
+    model.setItems(items({"b", "c"}));
+    QCOMPARE(model.indexOf("c").row(), 1);
+    QVERIFY(!model.indexOf("a").isValid());
+}
+
+void TestSidePanelListModel::testProxyNaturalSortAndFilter() {
+    SidePanelListModel model("Empty");
+    SidePanelListProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.sort(0);
+    QAbstractItemModelTester tester(&proxy);
+
+    // Plain string order, as DocumentState returns it
+    model.setItems(items({"Field 1", "Field 10", "Field 2", "name"}));
+    QCOMPARE(proxy.index(0, 0).data().toString(), QString("Field 1"));
+    QCOMPARE(proxy.index(1, 0).data().toString(), QString("Field 2"));
+    QCOMPARE(proxy.index(2, 0).data().toString(), QString("Field 10"));
+
+    proxy.setFilterFixedString("field 1");
+    QCOMPARE(proxy.rowCount(), 2);
+
+    // The placeholder survives any filter
+    model.setItems(items({}));
+    QCOMPARE(proxy.rowCount(), 1);
+}
+
+QTEST_MAIN(TestSidePanelListModel)
+#include "test_side_panel_list_model.moc"
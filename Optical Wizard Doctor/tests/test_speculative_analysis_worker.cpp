@@ -0,0 +1,96 @@
+// Test file for SpeculativeAnalysisWorker
+// Checks that superseded and heavily edited runs never report, and that finished runs fill the page cache
+
+#include <QtTest/QtTest>
+#include "../src/ui/utils/SpeculativeAnalysisWorker.h"
+#include "../src/utils/PageAnalysisCache.h"
+#include <QtGui/QPainter>
+
+using namespace ocr_orc;
+
+class TestSpeculativeAnalysisWorker : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testFinishedRunFillsCache();
+    void testNewPageSupersedesRun();
+    void testHeavyEditsCancelRun();
+
+private:
+    static QImage createPage(int boxes);
+    static const int RESULT_TIMEOUT_MS = 60000;
+};
+
+QImage TestSpeculativeAnalysisWorker::createPage(int boxes) {
+    QImage page(600, 400, QImage::Format_RGB32);
+    page.fill(Qt::white);
+    QPainter painter(&page);
+    painter.setPen(QPen(Qt::black, 3));
+    for (int i = 0; i < boxes; ++i) {
+        painter.drawRect(40 + i * 130, 150, 100, 60);
+    }
+    painter.end();
+    return page;
+}
+
+void TestSpeculativeAnalysisWorker::init() {
+    PageAnalysisCache::instance().clear();
+}
+
+void TestSpeculativeAnalysisWorker::testFinishedRunFillsCache() {
+    SpeculativeAnalysisWorker worker;
+    QSignalSpy spy(&worker, &SpeculativeAnalysisWorker::analysisFinished);
+    QImage page = createPage(3);
+
+    const int runId = worker.start(page);
+    QVERIFY(worker.isRunning());
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, RESULT_TIMEOUT_MS);
+    QCOMPARE(spy.first().at(0).toInt(), runId);
+    QVERIFY(!worker.isRunning());
+
+    // Rectangles are stored for the page detection will be given
+    QList<DetectedRectangle> rectangles;
+    QVERIFY(PageAnalysisCache::instance().lookupRectangles(PageAnalysisCache::pageKey(page), rectangles));
+}
+
+void TestSpeculativeAnalysisWorker::testNewPageSupersedesRun() {
+    SpeculativeAnalysisWorker worker;
+    QSignalSpy spy(&worker, &SpeculativeAnalysisWorker::analysisFinished);
+
+    const int first = worker.start(createPage(2));
+    const int second = worker.start(createPage(4));
+    QVERIFY(second != first);
+
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, RESULT_TIMEOUT_MS);
+    // The first run's report is dropped even if it finishes later
+    QTest::qWait(200);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.first().at(0).toInt(), second);
+}
+
+void TestSpeculativeAnalysisWorker::testHeavyEditsCancelRun() {
+    SpeculativeAnalysisWorker worker;
+    QSignalSpy spy(&worker, &SpeculativeAnalysisWorker::analysisFinished);
+
+    const int cancelled = worker.start(createPage(3));
+    for (int edit = 1; edit < SpeculativeAnalysisWorker::HEAVY_EDIT_THRESHOLD; ++edit) {
+        worker.noteUserEdit();
+        QVERIFY(worker.isRunning());
+    }
+    worker.noteUserEdit();
+    QVERIFY(!worker.isRunning());
+
+    // Edits after a cancel are ignored, and the next page starts counting afresh
+    worker.noteUserEdit();
+    const int next = worker.start(createPage(1));
+    QVERIFY(worker.isRunning());
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, RESULT_TIMEOUT_MS);
+    QTest::qWait(200);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.first().at(0).toInt(), next);
+    QVERIFY(next != cancelled);
+}
+
+QTEST_MAIN(TestSpeculativeAnalysisWorker)
+#include "test_speculative_analysis_worker.moc"
@@ -0,0 +1,204 @@
+// Test file for TaskGraph
+// Checks dependency order, concurrency, work stealing, failures and cancellation
+
+#include <QtTest/QtTest>
+#include "../src/utils/TaskGraph.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace ocr_orc;
+
+class TestTaskGraph : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testEmptyGraph();
+    void testRejectsUnknownDependency();
+    void testDependencyOrder();
+    void testIndependentTasksOverlap();
+    void testIdleWorkersSteal();
+    void testWaitForSingleTask();
+    void testFailureSkipsDependents();
+    void testCancelSkipsPending();
+    void testRunningTaskSeesCancel();
+};
+
+void TestTaskGraph::testEmptyGraph() {
+    TaskGraph graph(4);
+    graph.start();
+    graph.waitAll();
+    QCOMPARE(graph.getTaskCount(), 0);
+}
+
+void TestTaskGraph::testRejectsUnknownDependency() {
+    TaskGraph graph(2);
+    QCOMPARE(graph.addTask("orphan", []() {}, QList<int>{0}), -1);
+    int first = graph.addTask("first", []() {});
+    QCOMPARE(first, 0);
+    QCOMPARE(graph.addTask("self", []() {}, QList<int>{1}), -1);
+
+    graph.start();
+    QCOMPARE(graph.addTask("late", []() {}), -1);
+    graph.waitAll();
+}
+
+void TestTaskGraph::testDependencyOrder() {
+    // Diamond: preprocess -> {a, b, c} -> merge, repeated to shake out races
+    for (int run = 0; run < 50; ++run) {
+        std::atomic<int> clock{0};
+        int preprocessTime = -1;
+        int branchTimes[3] = {-1, -1, -1};
+        int mergeTime = -1;
+
+        TaskGraph graph(4);
+        int preprocess = graph.addTask("preprocess", [&]() { preprocessTime = clock++; });
+        QList<int> branches;
+        for (int b = 0; b < 3; ++b) {
+            branches.append(graph.addTask(QString("branch %1").arg(b), [&, b]() { branchTimes[b] = clock++; },
+                                          QList<int>{preprocess}));
+        }
+        graph.addTask("merge", [&]() { mergeTime = clock++; }, branches);
+        graph.waitAll();
+
+        QCOMPARE(preprocessTime, 0);
+        for (int b = 0; b < 3; ++b) {
+            QVERIFY(branchTimes[b] > preprocessTime);
+            QVERIFY(mergeTime > branchTimes[b]);
+        }
+        QCOMPARE(mergeTime, 4);
+    }
+}
+
+void TestTaskGraph::testIndependentTasksOverlap() {
+    // Each task waits until all of them are running; only possible if they run concurrently
+    const int taskCount = 3;
+    std::atomic<int> running{0};
+    std::atomic<bool> allMet{true};
+
+    TaskGraph graph(taskCount);
+    for (int t = 0; t < taskCount; ++t) {
+        graph.addTask(QString("stage %1").arg(t), [&]() {
+            running++;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (running.load() < taskCount) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    allMet = false;
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+    graph.waitAll();
+    QVERIFY(allMet.load());
+}
+
+void TestTaskGraph::testIdleWorkersSteal() {
+    // One root releases many tasks onto its own worker; the others must steal them
+    std::atomic<int> done{0};
+    TaskGraph graph(4);
+    int root = graph.addTask("root", []() {});
+    for (int t = 0; t < 32; ++t) {
+        graph.addTask(QString("leaf %1").arg(t), [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            done++;
+        }, QList<int>{root});
+    }
+    graph.waitAll();
+    QCOMPARE(done.load(), 32);
+    QVERIFY(graph.getStealCount() > 0);
+}
+
+void TestTaskGraph::testWaitForSingleTask() {
+    std::atomic<bool> releaseSlow{false};
+    int fastResult = 0;
+
+    TaskGraph graph(2);
+    int slow = graph.addTask("slow", [&]() {
+        while (!releaseSlow.load()) {
+            std::this_thread::yield();
+        }
+    });
+    int fast = graph.addTask("fast", [&]() { fastResult = 42; });
+    graph.start();
+
+    // The fast result is usable while the slow task is still running
+    graph.wait(fast);
+    QCOMPARE(fastResult, 42);
+    QVERIFY(!graph.isFinished(slow));
+
+    releaseSlow = true;
+    graph.wait(slow);
+    QVERIFY(graph.isFinished(slow));
+    graph.waitAll();
+}
+
+void TestTaskGraph::testFailureSkipsDependents() {
+    bool dependentRan = false;
+
+    TaskGraph graph(2);
+    int failing = graph.addTask("failing", []() { throw std::runtime_error("stage failed"); });
+    int dependent = graph.addTask("dependent", [&]() { dependentRan = true; }, QList<int>{failing});
+
+    bool caught = false;
+    try {
+        graph.wait(dependent);
+    } catch (const std::runtime_error& e) {
+        caught = QString(e.what()) == "stage failed";
+    }
+    QVERIFY(caught);
+    QVERIFY(!dependentRan);
+    QVERIFY(graph.wasSkipped(dependent));
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, graph.waitAll());
+}
+
+void TestTaskGraph::testCancelSkipsPending() {
+    std::atomic<bool> releaseGate{false};
+    std::atomic<int> laterRuns{0};
+
+    {
+        TaskGraph graph(1);
+        int gate = graph.addTask("gate", [&]() {
+            while (!releaseGate.load()) {
+                std::this_thread::yield();
+            }
+        });
+        for (int t = 0; t < 5; ++t) {
+            graph.addTask(QString("later %1").arg(t), [&]() { laterRuns++; }, QList<int>{gate});
+        }
+        graph.start();
+        graph.cancel();
+        releaseGate = true;
+        // Destructor joins after the running task finishes
+    }
+    QCOMPARE(laterRuns.load(), 0);
+}
+
+void TestTaskGraph::testRunningTaskSeesCancel() {
+    std::atomic<bool> running{false};
+    std::atomic<bool> stoppedEarly{false};
+
+    {
+        TaskGraph graph(1);
+        graph.addTask("poller", [&]() {
+            running = true;
+            while (!graph.isCancelled()) {
+                std::this_thread::yield();
+            }
+            stoppedEarly = true;
+        });
+        QVERIFY(!graph.isCancelled());
+        graph.start();
+        while (!running.load()) {
+            std::this_thread::yield();
+        }
+        graph.cancel();
+        // Destructor returns because the running task polls for cancellation
+    }
+    QVERIFY(stoppedEarly.load());
+}
+
+QTEST_MAIN(TestTaskGraph)
+#include "test_task_graph.moc"
@@ -0,0 +1,144 @@
+// Test file for TemplateLibrary
+// Checks fingerprinting, nearest-template lookup and persistence
+
+#include <QtTest/QtTest>
+#include "../src/utils/TemplateLibrary.h"
+#include "TestForms.h"
+#include <opencv2/opencv.hpp>
+#include <QtCore/QTemporaryDir>
+
+using namespace ocr_orc;
+
+class TestTemplateLibrary : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBlankPageHasNoFingerprint();
+    void testHexRoundTrip();
+    void testIdentifiesRescans();
+    void testAddReplaceRemove();
+    void testLargeLibrary();
+    void testSaveLoad();
+
+private:
+    static cv::Mat rescan(const cv::Mat& page, double angle, int dx, int dy);
+};
+
+cv::Mat TestTemplateLibrary::rescan(const cv::Mat& page, double angle, int dx, int dy) {
+    cv::Mat transform = cv::getRotationMatrix2D(cv::Point2f(page.cols / 2.0f, page.rows / 2.0f), angle, 1.0);
+    transform.at<double>(0, 2) += dx;
+    transform.at<double>(1, 2) += dy;
+    cv::Mat scan;
+    cv::warpAffine(page, scan, transform, page.size(), cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(255));
+    return scan;
+}
+
+void TestTemplateLibrary::testBlankPageHasNoFingerprint() {
+    QVERIFY(!TemplateLibrary::computeFingerprint(cv::Mat()).valid);
+    QVERIFY(!TemplateLibrary::computeFingerprint(cv::Mat(1100, 850, CV_8UC1, cv::Scalar(255))).valid);
+
+    TemplateLibrary library;
+    QVERIFY(!library.addTemplate("blank", cv::Mat(1100, 850, CV_8UC1, cv::Scalar(255))));
+    QCOMPARE(library.size(), 0);
+    QVERIFY(!library.identify(TestForms::makeBoxForm(1)).isValid());
+}
+
+void TestTemplateLibrary::testHexRoundTrip() {
+    TemplateFingerprint fingerprint = TemplateLibrary::computeFingerprint(TestForms::makeBoxForm(1));
+    QVERIFY(fingerprint.valid);
+
+    TemplateFingerprint decoded = TemplateFingerprint::fromHex(fingerprint.toHex());
+    QVERIFY(decoded.valid);
+    QCOMPARE(TemplateFingerprint::distance(fingerprint, decoded), 0);
+    QVERIFY(!TemplateFingerprint::fromHex("xyz").valid);
+}
+
+void TestTemplateLibrary::testIdentifiesRescans() {
+    TemplateLibrary library;
+    for (int seed = 1; seed <= 20; ++seed) {
+        QVERIFY(library.addTemplate(QString("form-%1").arg(seed), TestForms::makeBoxForm(seed)));
+    }
+
+    for (int seed = 1; seed <= 20; ++seed) {
+        QString expected = QString("form-%1").arg(seed);
+        cv::Mat page = TestForms::makeBoxForm(seed);
+        QCOMPARE(library.identify(page).templateId, expected);
+
+        // Slightly skewed and shifted scan of the same form
+        TemplateMatch match = library.identify(rescan(page, 0.5, 8, -6));
+        QCOMPARE(match.templateId, expected);
+        QVERIFY(match.similarity >= library.getMatchThreshold());
+
+        // Color input takes the same path
+        cv::Mat color;
+        cv::cvtColor(page, color, cv::COLOR_GRAY2BGR);
+        QCOMPARE(library.identify(color).templateId, expected);
+    }
+}
+
+void TestTemplateLibrary::testAddReplaceRemove() {
+    TemplateLibrary library;
+    QVERIFY(library.addTemplate("a", TestForms::makeBoxForm(1)));
+    QVERIFY(library.addTemplate("b", TestForms::makeBoxForm(2)));
+    QVERIFY(library.addTemplate("c", TestForms::makeBoxForm(3)));
+    QCOMPARE(library.size(), 3);
+
+    // Replacing keeps one entry per id
+    QVERIFY(library.addTemplate("a", TestForms::makeBoxForm(4)));
+    QCOMPARE(library.size(), 3);
+    QCOMPARE(library.identify(TestForms::makeBoxForm(4)).templateId, QString("a"));
+
+    QVERIFY(library.removeTemplate("a"));
+    QVERIFY(!library.removeTemplate("a"));
+    QVERIFY(!library.containsTemplate("a"));
+    QCOMPARE(library.size(), 2);
+    QCOMPARE(library.identify(TestForms::makeBoxForm(3)).templateId, QString("c"));
+    QCOMPARE(library.identify(TestForms::makeBoxForm(2)).templateId, QString("b"));
+
+    library.clear();
+    QCOMPARE(library.size(), 0);
+}
+
+void TestTemplateLibrary::testLargeLibrary() {
+    // Thousands of random fingerprints around the real templates
+    TemplateLibrary library;
+    cv::RNG rng(7);
+    for (int i = 0; i < 5000; ++i) {
+        TemplateFingerprint fingerprint;
+        for (quint64& word : fingerprint.bits) {
+            word = (quint64(rng.next()) << 32) | rng.next();
+        }
+        fingerprint.valid = true;
+        QVERIFY(library.addTemplate(QString("random-%1").arg(i), fingerprint));
+    }
+    QVERIFY(library.addTemplate("target", TestForms::makeBoxForm(9)));
+
+    QList<TemplateMatch> nearest = library.findNearest(TemplateLibrary::computeFingerprint(TestForms::makeBoxForm(9)), 3);
+    QCOMPARE(nearest.size(), 3);
+    QCOMPARE(nearest[0].templateId, QString("target"));
+    QCOMPARE(nearest[0].distance, 0);
+    QVERIFY(nearest[1].distance >= nearest[0].distance);
+    QVERIFY(nearest[2].distance >= nearest[1].distance);
+}
+
+void TestTemplateLibrary::testSaveLoad() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("templates.json");
+
+    TemplateLibrary library;
+    QVERIFY(library.addTemplate("invoice", TestForms::makeBoxForm(11)));
+    QVERIFY(library.addTemplate("claim", TestForms::makeBoxForm(12)));
+    QVERIFY(library.save(path));
+
+    TemplateLibrary loaded;
+    QVERIFY(loaded.load(path));
+    QCOMPARE(loaded.getTemplateIds(), library.getTemplateIds());
+    QCOMPARE(loaded.identify(TestForms::makeBoxForm(12)).templateId, QString("claim"));
+
+    QVERIFY(!loaded.load(dir.filePath("missing.json")));
+    QCOMPARE(loaded.size(), 2);
+}
+
+QTEST_MAIN(TestTemplateLibrary)
+#include "test_template_library.moc"
@@ -0,0 +1,178 @@
+// Test file for TemplateRegistration
+// Registers warped copies of a synthetic form and checks the projected regions
+
+#include <QtTest/QtTest>
+#include "../src/utils/TemplateRegistration.h"
+#include "../src/utils/ImageConverter.h"
+#include "../src/models/DocumentState.h"
+#include "TestForms.h"
+#include <opencv2/opencv.hpp>
+
+using namespace ocr_orc;
+
+class TestTemplateRegistration : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testNoTemplate();
+    void testBlankTemplateRejected();
+    void testIdentity();
+    void testAffineScan();
+    void testHomographyScan();
+    void testDifferentResolution();
+    void testUnrelatedPageRejected();
+    void testApplyToDocument();
+
+private:
+    static DocumentState makeTemplate(const cv::Mat& page);
+    static void verifyProjection(const TemplateRegistrationResult& result, const DocumentState& tmpl,
+                                 const cv::Mat& transform, const cv::Size& templateSize,
+                                 const cv::Size& pageSize);
+};
+
+DocumentState TestTemplateRegistration::makeTemplate(const cv::Mat& page) {
+    DocumentState state;
+    state.setImage(ImageConverter::matToQImage(page));
+    state.addRegion("Name", RegionData("Name", NormalizedCoords(0.10, 0.10, 0.40, 0.14)));
+    state.addRegion("Date", RegionData("Date", NormalizedCoords(0.60, 0.50, 0.80, 0.53)));
+    state.addRegion("Total", RegionData("Total", NormalizedCoords(0.70, 0.85, 0.90, 0.90)));
+    state.createGroup("Header");
+    state.addRegionToGroup("Name", "Header");
+    return state;
+}
+
+void TestTemplateRegistration::verifyProjection(const TemplateRegistrationResult& result,
+                                                const DocumentState& tmpl,
+                                                const cv::Mat& transform,
+                                                const cv::Size& templateSize,
+                                                const cv::Size& pageSize) {
+    QVERIFY(result.success);
+    QCOMPARE(result.regions.size(), tmpl.regions.size());
+
+    QMap<QString, RegionData> expected =
+        TemplateRegistration::projectRegions(tmpl.regions, transform, templateSize, pageSize);
+    for (auto it = expected.constBegin(); it != expected.constEnd(); ++it) {
+        const NormalizedCoords& want = it.value().normalizedCoords;
+        const NormalizedCoords& got = result.regions[it.key()].normalizedCoords;
+        QVERIFY2(std::abs(want.x1 - got.x1) < 0.005 && std::abs(want.y1 - got.y1) < 0.005 &&
+                 std::abs(want.x2 - got.x2) < 0.005 && std::abs(want.y2 - got.y2) < 0.005,
+                 qPrintable(it.key()));
+    }
+}
+
+void TestTemplateRegistration::testNoTemplate() {
+    TemplateRegistration registration;
+    QVERIFY(!registration.hasTemplate());
+    QVERIFY(!registration.registerPage(TestForms::makeLabelledForm(1)).success);
+    QVERIFY(!registration.setTemplate(DocumentState()));
+}
+
+void TestTemplateRegistration::testBlankTemplateRejected() {
+    DocumentState state;
+    state.setImage(ImageConverter::matToQImage(cv::Mat(1100, 850, CV_8UC3, cv::Scalar(255, 255, 255))));
+
+    TemplateRegistration registration;
+    QVERIFY(!registration.setTemplate(state));
+    QVERIFY(!registration.hasTemplate());
+}
+
+void TestTemplateRegistration::testIdentity() {
+    cv::Mat form = TestForms::makeLabelledForm(1);
+    DocumentState tmpl = makeTemplate(form);
+
+    TemplateRegistration registration;
+    QVERIFY(registration.setTemplate(tmpl));
+    TemplateRegistrationResult result = registration.registerPage(form);
+    verifyProjection(result, tmpl, cv::Mat::eye(3, 3, CV_64F), form.size(), form.size());
+    QVERIFY(result.reprojectionError < 2.0);
+}
+
+void TestTemplateRegistration::testAffineScan() {
+    cv::Mat form = TestForms::makeLabelledForm(2);
+    DocumentState tmpl = makeTemplate(form);
+
+    // 1.5 degree skew, slight shrink and feeder offset
+    cv::Mat affine = cv::getRotationMatrix2D(cv::Point2f(850, 1100), 1.5, 0.97);
+    affine.at<double>(0, 2) += 25;
+    affine.at<double>(1, 2) -= 40;
+    cv::Mat scan;
+    cv::warpAffine(form, scan, affine, form.size(), cv::INTER_LINEAR, cv::BORDER_CONSTANT,
+                   cv::Scalar(255, 255, 255));
+
+    cv::Mat transform = cv::Mat::eye(3, 3, CV_64F);
+    affine.copyTo(transform(cv::Rect(0, 0, 3, 2)));
+
+    TemplateRegistration registration;
+    QVERIFY(registration.setTemplate(tmpl));
+    verifyProjection(registration.registerPage(scan), tmpl, transform, form.size(), scan.size());
+}
+
+void TestTemplateRegistration::testHomographyScan() {
+    cv::Mat form = TestForms::makeLabelledForm(3);
+    DocumentState tmpl = makeTemplate(form);
+
+    // Mild perspective, as from a phone photo
+    std::vector<cv::Point2f> from = {{0, 0}, {1700, 0}, {1700, 2200}, {0, 2200}};
+    std::vector<cv::Point2f> to = {{40, 30}, {1660, 60}, {1690, 2180}, {10, 2150}};
+    cv::Mat homography = cv::getPerspectiveTransform(from, to);
+    cv::Mat photo;
+    cv::warpPerspective(form, photo, homography, form.size(), cv::INTER_LINEAR, cv::BORDER_CONSTANT,
+                        cv::Scalar(255, 255, 255));
+
+    TemplateRegistration registration;
+    registration.setTransformModel(TemplateRegistration::HOMOGRAPHY_TRANSFORM);
+    QVERIFY(registration.setTemplate(tmpl));
+    verifyProjection(registration.registerPage(photo), tmpl, homography, form.size(), photo.size());
+}
+
+void TestTemplateRegistration::testDifferentResolution() {
+    cv::Mat form = TestForms::makeLabelledForm(4);
+    DocumentState tmpl = makeTemplate(form);
+
+    // Same form scanned at 150 DPI instead of 200
+    cv::Mat scan;
+    cv::resize(form, scan, cv::Size(1275, 1650), 0, 0, cv::INTER_AREA);
+
+    TemplateRegistration registration;
+    QVERIFY(registration.setTemplate(tmpl));
+    TemplateRegistrationResult result = registration.registerPage(scan);
+    QVERIFY(result.success);
+
+    // Normalized coordinates are unchanged by a pure resolution change
+    for (auto it = tmpl.regions.constBegin(); it != tmpl.regions.constEnd(); ++it) {
+        const NormalizedCoords& want = it.value().normalizedCoords;
+        const NormalizedCoords& got = result.regions[it.key()].normalizedCoords;
+        QVERIFY(std::abs(want.x1 - got.x1) < 0.005);
+        QVERIFY(std::abs(want.y2 - got.y2) < 0.005);
+    }
+}
+
+void TestTemplateRegistration::testUnrelatedPageRejected() {
+    DocumentState tmpl = makeTemplate(TestForms::makeLabelledForm(5));
+
+    TemplateRegistration registration;
+    QVERIFY(registration.setTemplate(tmpl));
+    QVERIFY(!registration.registerPage(cv::Mat(2200, 1700, CV_8UC3, cv::Scalar(255, 255, 255))).success);
+}
+
+void TestTemplateRegistration::testApplyToDocument() {
+    cv::Mat form = TestForms::makeLabelledForm(6);
+    DocumentState tmpl = makeTemplate(form);
+
+    TemplateRegistration registration;
+    QVERIFY(registration.setTemplate(tmpl));
+    TemplateRegistrationResult result = registration.registerPage(form);
+    QVERIFY(result.success);
+
+    DocumentState target;
+    target.setImage(ImageConverter::matToQImage(form));
+    QVERIFY(registration.applyToDocument(result, target));
+    QCOMPARE(target.regions.size(), tmpl.regions.size());
+    QVERIFY(target.hasGroup("Header"));
+    QCOMPARE(target.getGroup("Header").regionNames, QList<QString>() << "Name");
+    QCOMPARE(target.regions["Name"].group, QString("Header"));
+    QVERIFY(target.canUndo());
+}
+
+QTEST_MAIN(TestTemplateRegistration)
+#include "test_template_registration.moc"
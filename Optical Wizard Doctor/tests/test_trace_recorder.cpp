@@ -0,0 +1,177 @@
+// Test file for TraceRecorder
+// Tests runtime tracing spans, counters and Chrome trace export
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+#include <QtConcurrent/QtConcurrent>
+#include "../src/utils/TraceRecorder.h"
+
+using namespace ocr_orc;
+
+class TestTraceRecorder : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testDisabledRecordsNothing();
+    void testSpanRecordsDurationAndArgs();
+    void testEarlyEndIsIdempotent();
+    void testCounter();
+    void testThreadIdsDiffer();
+    void testExportChromeTrace();
+    void testExportToDefaultLocationDrainsBuffer();
+    void testEnvironmentWinsOverPreferences();
+};
+
+void TestTraceRecorder::init() {
+    TraceRecorder::instance().clear();
+    TraceRecorder::instance().setEnabled(true);
+}
+
+void TestTraceRecorder::cleanup() {
+    TraceRecorder::instance().setEnabled(false);
+    TraceRecorder::instance().clear();
+}
+
+void TestTraceRecorder::testDisabledRecordsNothing() {
+    TraceRecorder::instance().setEnabled(false);
+    {
+        TraceSpan span("disabled", "stage");
+        QVERIFY(!span.isActive());
+        span.setArg("ignored", 1);
+    }
+    OCR_ORC_TRACE_COUNTER("disabled_counter", 5);
+    QCOMPARE(TraceRecorder::instance().eventCount(), 0);
+}
+
+void TestTraceRecorder::testSpanRecordsDurationAndArgs() {
+    {
+        TraceSpan span("Pass 1", "stage");
+        span.setArg("fields_found", 12);
+        QTest::qWait(5);
+    }
+    QList<TraceEvent> events = TraceRecorder::instance().events();
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events[0].name, QString("Pass 1"));
+    QCOMPARE(events[0].category, QString("stage"));
+    QCOMPARE(events[0].phase, 'X');
+    QVERIFY(events[0].durationUs >= 1000);
+    QCOMPARE(events[0].args.value("fields_found").toInt(), 12);
+}
+
+void TestTraceRecorder::testEarlyEndIsIdempotent() {
+    {
+        TraceSpan span("early", "candidate");
+        span.end();
+        span.end();
+        QVERIFY(!span.isActive());
+    }
+    QCOMPARE(TraceRecorder::instance().eventCount(), 1);
+}
+
+void TestTraceRecorder::testCounter() {
+    OCR_ORC_TRACE_COUNTER("ocr_regions", 42);
+    QList<TraceEvent> events = TraceRecorder::instance().events();
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events[0].phase, 'C');
+    QCOMPARE(events[0].args.value("value").toDouble(), 42.0);
+}
+
+void TestTraceRecorder::testThreadIdsDiffer() {
+    int mainId = TraceRecorder::currentThreadId();
+    int otherId = QtConcurrent::run([]() {
+        TraceSpan span("worker", "stage");
+        return TraceRecorder::currentThreadId();
+    }).result();
+    QVERIFY(mainId != otherId);
+
+    QList<TraceEvent> events = TraceRecorder::instance().events();
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events[0].threadId, otherId);
+}
+
+void TestTraceRecorder::testExportChromeTrace() {
+    TraceRecorder::instance().setCurrentThreadName("Main");
+    {
+        TraceSpan outer("outer", "detection");
+        TraceSpan inner("inner", "candidate");
+    }
+    OCR_ORC_TRACE_COUNTER("final_regions", 3);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("trace.json");
+    QVERIFY(TraceRecorder::instance().exportChromeTrace(path));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QJsonArray traceEvents = doc.object().value("traceEvents").toArray();
+    int spans = 0;
+    int counters = 0;
+    int metadata = 0;
+    for (const QJsonValue& value : traceEvents) {
+        QJsonObject obj = value.toObject();
+        QString phase = obj.value("ph").toString();
+        QVERIFY(obj.contains("pid"));
+        QVERIFY(obj.contains("tid"));
+        if (phase == "X") {
+            spans++;
+            QVERIFY(obj.contains("dur"));
+        } else if (phase == "C") {
+            counters++;
+        } else if (phase == "M") {
+            metadata++;
+        }
+    }
+    QCOMPARE(spans, 2);
+    QCOMPARE(counters, 1);
+    QVERIFY(metadata >= 1);
+}
+
+void TestTraceRecorder::testExportToDefaultLocationDrainsBuffer() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString previousDirectory = TraceRecorder::instance().outputDirectory();
+    TraceRecorder::instance().setOutputDirectory(dir.path());
+    {
+        TraceSpan span("exported", "stage");
+    }
+    QString path = TraceRecorder::instance().exportToDefaultLocation("test");
+    QVERIFY(!path.isEmpty());
+    QCOMPARE(TraceRecorder::instance().eventCount(), 0);
+
+    // A failed write keeps the events for the next export
+    {
+        TraceSpan span("kept", "stage");
+    }
+    TraceRecorder::instance().setOutputDirectory(dir.filePath("trace.json/missing"));
+    QFile blocker(dir.filePath("trace.json"));
+    QVERIFY(blocker.open(QIODevice::WriteOnly));
+    blocker.close();
+    QVERIFY(TraceRecorder::instance().exportToDefaultLocation("test").isEmpty());
+    QCOMPARE(TraceRecorder::instance().eventCount(), 1);
+    TraceRecorder::instance().setOutputDirectory(previousDirectory);
+}
+
+void TestTraceRecorder::testEnvironmentWinsOverPreferences() {
+    qputenv("OCR_ORC_TRACE", "1");
+    TraceRecorder::instance().configureFromEnvironment();
+    TraceRecorder::instance().applyPreferences(false, QString());
+    QVERIFY(TraceRecorder::isEnabled());
+
+    qunsetenv("OCR_ORC_TRACE");
+    TraceRecorder::instance().configureFromEnvironment();
+    TraceRecorder::instance().applyPreferences(false, TraceRecorder::instance().outputDirectory());
+    QVERIFY(!TraceRecorder::isEnabled());
+}
+
+QTEST_MAIN(TestTraceRecorder)
+#include "test_trace_recorder.moc"
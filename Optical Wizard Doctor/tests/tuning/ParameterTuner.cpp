@@ -0,0 +1,437 @@
+#include "ParameterTuner.h"
+#include "../../src/utils/ConcurrencyGovernor.h"
+#include "../../src/utils/TraceRecorder.h"
+#include "../../src/export/DetectionPresetIO.h"
+#include <QtCore/QDebug>
+#include <QtCore/QSaveFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+
+namespace ocr_orc {
+
+struct ParameterTuner::PreparedForm {
+    GroundTruthAnnotation groundTruth;
+    std::unique_ptr<DetectionPreview> preview;  // Prepared once; trials run on forks
+};
+
+namespace {
+    // One searched parameter; exactly one of the member pointers is set
+    struct Dimension {
+        double DetectionParameters::* realValue;
+        int DetectionParameters::* intValue;
+        bool DetectionParameters::* flag;
+        double minimum;
+        double maximum;
+        double step;
+    };
+    
+    // Bounds bracket the built-in presets (Strict to Very Lenient) with some margin.
+    // ocrConfidenceThreshold is not searched: trials do not run ROI OCR.
+    const Dimension SEARCH_SPACE[] = {
+        {&DetectionParameters::ocrOverlapThreshold, nullptr, nullptr, 0.05, 0.35, 0.01},
+        {&DetectionParameters::baseBrightnessThreshold, nullptr, nullptr, 0.40, 0.80, 0.01},
+        {&DetectionParameters::brightnessAdaptiveFactor, nullptr, nullptr, 0.60, 0.95, 0.01},
+        {&DetectionParameters::edgeDensityThreshold, nullptr, nullptr, 0.05, 0.25, 0.005},
+        {&DetectionParameters::horizontalEdgeDensityThreshold, nullptr, nullptr, 0.05, 0.35, 0.005},
+        {&DetectionParameters::verticalEdgeDensityThreshold, nullptr, nullptr, 0.03, 0.25, 0.005},
+        {&DetectionParameters::iouThreshold, nullptr, nullptr, 0.30, 0.70, 0.05},
+        {&DetectionParameters::horizontalOverfitPercent, nullptr, nullptr, 20.0, 70.0, 5.0},
+        {&DetectionParameters::verticalOverfitPercent, nullptr, nullptr, 30.0, 90.0, 5.0},
+        {nullptr, &DetectionParameters::minHorizontalLines, nullptr, 1, 6, 1},
+        {nullptr, nullptr, &DetectionParameters::strictConsensus, 0, 1, 1},
+        {nullptr, &DetectionParameters::minCheckboxSize, nullptr, 8, 20, 1},
+        {nullptr, &DetectionParameters::maxCheckboxSize, nullptr, 30, 80, 1},
+        {&DetectionParameters::checkboxAspectRatioMin, nullptr, nullptr, 0.5, 0.9, 0.1},
+        {&DetectionParameters::checkboxAspectRatioMax, nullptr, nullptr, 1.1, 1.8, 0.1},
+        {&DetectionParameters::checkboxRectangularity, nullptr, nullptr, 0.40, 0.80, 0.05},
+        {nullptr, nullptr, &DetectionParameters::enableStandaloneCheckboxDetection, 0, 1, 1},
+    };
+    
+    double getValue(const DetectionParameters& params, const Dimension& dim) {
+        if (dim.realValue) return params.*dim.realValue;
+        if (dim.intValue) return params.*dim.intValue;
+        return (params.*dim.flag) ? 1.0 : 0.0;
+    }
+    
+    void setValue(DetectionParameters& params, const Dimension& dim, double value) {
+        // Snap to the dialog's step so presets round-trip through the spin boxes
+        value = std::clamp(value, dim.minimum, dim.maximum);
+        value = dim.minimum + std::round((value - dim.minimum) / dim.step) * dim.step;
+        value = std::clamp(value, dim.minimum, dim.maximum);
+        if (dim.realValue) {
+            params.*dim.realValue = value;
+        } else if (dim.intValue) {
+            params.*dim.intValue = static_cast<int>(std::lround(value));
+        } else {
+            params.*dim.flag = value >= 0.5;
+        }
+    }
+    
+    bool isComplete(const TuningTrial& trial) {
+        return !trial.pruned && trial.formsEvaluated > 0;
+    }
+    
+    bool dominates(const TuningTrial& a, const TuningTrial& b) {
+        bool noWorse = a.precision >= b.precision && a.recall >= b.recall && a.runtimeMs <= b.runtimeMs;
+        bool better = a.precision > b.precision || a.recall > b.recall || a.runtimeMs < b.runtimeMs;
+        return noWorse && better;
+    }
+    
+    DetectedRegion toDetectedRegion(const QRect& rect, const QSize& imageSize) {
+        cv::Rect box(rect.x(), rect.y(), rect.width(), rect.height());
+        NormalizedCoords coords = CoordinateSystem::imageToNormalized(
+            ImageCoords(box.x, box.y, box.x + box.width, box.y + box.height),
+            imageSize.width(), imageSize.height());
+        return DetectedRegion(coords, 1.0, "tuning", box);
+    }
+}
+
+ParameterTuner::ParameterTuner()
+{
+    dataManager.setBaseDirectory("tests/data");
+}
+
+ParameterTuner::~ParameterTuner() = default;
+
+void ParameterTuner::setBaseDirectory(const QString& baseDir)
+{
+    dataManager.setBaseDirectory(baseDir);
+}
+
+int ParameterTuner::prepareForms(const QList<QString>& formIds, int maxImageSize)
+{
+    forms.clear();
+    QList<QString> ids = formIds.isEmpty() ? dataManager.getAvailableForms() : formIds;
+    
+    for (const QString& formId : ids) {
+        GroundTruthAnnotation groundTruth = dataManager.getGroundTruth(formId);
+        if (groundTruth.formId.isEmpty()) {
+            qWarning() << "Failed to load ground truth for form:" << formId;
+            continue;
+        }
+    
+        QString imagePath = dataManager.getFormsDirectory() + "/" + groundTruth.imagePath;
+        QImage image = dataManager.loadImage(imagePath);
+        if (image.isNull()) {
+            qWarning() << "✗ Failed to load image:" << imagePath;
+            continue;
+        }
+    
+        // OCR, rectangles and candidates: the part every trial shares
+        QElapsedTimer timer;
+        timer.start();
+        auto form = std::make_unique<PreparedForm>();
+        form->groundTruth = groundTruth;
+        form->preview = std::make_unique<DetectionPreview>(image, maxImageSize);
+        if (!form->preview->prepare()) {
+            qWarning() << "✗ Failed to prepare form:" << formId;
+            continue;
+        }
+    
+        fprintf(stderr, "[ParameterTuner] Prepared %s (%dx%d): %d OCR regions, %d candidates (%lld ms)\n",
+                qPrintable(formId), form->preview->getThumbnail().width(), form->preview->getThumbnail().height(),
+                form->preview->getOcrRegionCount(), form->preview->getCandidateCount(), (long long)timer.elapsed());
+        fflush(stderr);
+        forms.push_back(std::move(form));
+    }
+    
+    return static_cast<int>(forms.size());
+}
+
+QList<TuningTrial> ParameterTuner::run(const Options& options)
+{
+    QList<TuningTrial> trials;
+    if (forms.empty()) {
+        qWarning() << "WARNING: No prepared forms to tune against";
+        return trials;
+    }
+    
+    const int workers = options.workers > 0 ? options.workers : ConcurrencyGovernor::instance().getCoreCount();
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    
+    // Each worker keeps its own forks for the whole search
+    std::vector<std::vector<std::unique_ptr<DetectionPreview>>> evaluators(workers);
+    QThreadPool pool;
+    pool.setMaxThreadCount(workers);
+    
+    int bestIndex = -1;
+    int sinceImprovement = 0;
+    QElapsedTimer searchTimer;
+    searchTimer.start();
+    
+    while (trials.size() < options.maxTrials && sinceImprovement < options.patience) {
+        const int batchSize = std::min<int>(workers, options.maxTrials - trials.size());
+    
+        // Explore at random, and exploit around the best trials with a shrinking step
+        QList<int> elite;
+        for (int i = 0; i < trials.size(); ++i) {
+            if (isComplete(trials[i])) {
+                elite.append(i);
+            }
+        }
+        std::sort(elite.begin(), elite.end(), [&trials](int a, int b) {
+            return trials[a].f1Score > trials[b].f1Score;
+        });
+        elite = elite.mid(0, 5);
+        const double progress = static_cast<double>(trials.size()) / options.maxTrials;
+        const double radius = std::max(0.03, 0.25 * (1.0 - progress));
+    
+        std::vector<TuningTrial> batch(batchSize);
+        for (int b = 0; b < batchSize; ++b) {
+            batch[b].index = trials.size() + b;
+            if (trials.isEmpty() && b == 0) {
+                batch[b].params = DetectionParameters();  // Baseline: the current defaults
+            } else if (elite.isEmpty() || unit(rng) < 0.3) {
+                batch[b].params = sampleRandom(rng);
+            } else {
+                const int parent = elite[static_cast<int>(unit(rng) * elite.size()) % elite.size()];
+                batch[b].params = perturb(trials[parent].params, radius, rng);
+            }
+        }
+    
+        const double pruneBelow = (bestIndex >= 0 && options.pruneRatio > 0.0)
+            ? trials[bestIndex].f1Score * options.pruneRatio : 0.0;
+        std::atomic<int> next{0};
+        for (int w = 0; w < std::min(workers, batchSize); ++w) {
+            pool.start([this, w, &evaluators, &batch, &next, pruneBelow]() {
+                if (TraceRecorder::isEnabled()) {
+                    TraceRecorder::instance().setCurrentThreadName("ParameterTuner");
+                }
+                // Each worker counts as a detection, so OpenCV does not oversubscribe the cores
+                ConcurrencyGovernor::DetectionLease lease;
+                std::vector<std::unique_ptr<DetectionPreview>>& slot = evaluators[w];
+                if (slot.empty()) {
+                    for (const std::unique_ptr<PreparedForm>& form : forms) {
+                        slot.push_back(form->preview->fork());
+                    }
+                }
+                int i;
+                while ((i = next.fetch_add(1)) < static_cast<int>(batch.size())) {
+                    evaluate(batch[i], slot, pruneBelow);
+                }
+            });
+        }
+        pool.waitForDone();
+    
+        for (const TuningTrial& trial : batch) {
+            trials.append(trial);
+            if (isComplete(trial) && (bestIndex < 0 || trial.f1Score > trials[bestIndex].f1Score + 1e-6)) {
+                bestIndex = trial.index;
+                sinceImprovement = 0;
+            } else {
+                sinceImprovement++;
+            }
+        }
+    
+        const TuningTrial& best = trials[bestIndex >= 0 ? bestIndex : 0];
+        fprintf(stderr, "[ParameterTuner] %lld/%d trials, best #%d: F1 %.4f (P %.4f, R %.4f), %lld s elapsed\n",
+                (long long)trials.size(), options.maxTrials, best.index, best.f1Score, best.precision, best.recall,
+                (long long)(searchTimer.elapsed() / 1000));
+        fflush(stderr);
+    }
+    
+    if (sinceImprovement >= options.patience) {
+        fprintf(stderr, "[ParameterTuner] Stopped early: no improvement in %d trials\n", sinceImprovement);
+        fflush(stderr);
+    }
+    
+    // Time every complete trial one at a time on the first worker's forks, so
+    // runtime can be compared like precision and recall
+    std::vector<std::unique_ptr<DetectionPreview>>& timing = evaluators[0];
+    if (timing.empty()) {
+        for (const std::unique_ptr<PreparedForm>& form : forms) {
+            timing.push_back(form->preview->fork());
+        }
+    }
+    QElapsedTimer timingTimer;
+    timingTimer.start();
+    int timed = 0;
+    for (TuningTrial& trial : trials) {
+        if (isComplete(trial)) {
+            timeAlone(trial, timing);
+            timed++;
+        }
+    }
+    fprintf(stderr, "[ParameterTuner] Timed %d complete trials alone in %lld s\n",
+            timed, (long long)(timingTimer.elapsed() / 1000));
+    fflush(stderr);
+    
+    for (int index : paretoFront(trials)) {
+        trials[index].onParetoFront = true;
+    }
+    return trials;
+}
+
+void ParameterTuner::evaluate(TuningTrial& trial, std::vector<std::unique_ptr<DetectionPreview>>& evaluators,
+                              double pruneBelow) const
+{
+    double precisionSum = 0.0;
+    double recallSum = 0.0;
+    
+    for (size_t i = 0; i < forms.size(); ++i) {
+        DetectionPreview& preview = *evaluators[i];
+        // Recompute every stage: each fork still holds the previous trial's stages
+        preview.invalidateStages();
+        DetectionPreview::Result result = preview.run(trial.params);
+    
+        const QSize imageSize = preview.getThumbnail().size();
+        QList<DetectedRegion> detected;
+        for (const QRect& field : result.fields) {
+            detected.append(toDetectedRegion(field, imageSize));
+        }
+        for (const QRect& checkbox : result.checkboxes) {
+            detected.append(toDetectedRegion(checkbox, imageSize));
+        }
+        EvaluationMetrics metrics = metricsCalculator.calculateMetrics(
+            detected, forms[i]->groundTruth, imageSize.width(), imageSize.height());
+    
+        precisionSum += metrics.precision;
+        recallSum += metrics.recall;
+        trial.formsEvaluated = static_cast<int>(i) + 1;
+        trial.precision = precisionSum / trial.formsEvaluated;
+        trial.recall = recallSum / trial.formsEvaluated;
+        trial.f1Score = MetricsCalculator::calculateF1Score(trial.precision, trial.recall);
+    
+        if (trial.f1Score < pruneBelow && i + 1 < forms.size()) {
+            trial.pruned = true;
+            return;
+        }
+    }
+}
+
+void ParameterTuner::timeAlone(TuningTrial& trial, std::vector<std::unique_ptr<DetectionPreview>>& evaluators) const
+{
+    // The only detection running, so OpenCV gets every core as in a real run
+    ConcurrencyGovernor::DetectionLease lease;
+    double runtimeSum = 0.0;
+    for (const std::unique_ptr<DetectionPreview>& preview : evaluators) {
+        preview->invalidateStages();
+        runtimeSum += preview->run(trial.params).elapsedMs;
+    }
+    trial.runtimeMs = evaluators.empty() ? 0.0 : runtimeSum / evaluators.size();
+}
+
+QList<int> ParameterTuner::paretoFront(const QList<TuningTrial>& trials)
+{
+    QList<int> front;
+    for (int i = 0; i < trials.size(); ++i) {
+        if (!isComplete(trials[i])) {
+            continue;
+        }
+        bool dominated = false;
+        for (int j = 0; j < trials.size() && !dominated; ++j) {
+            dominated = j != i && isComplete(trials[j]) && dominates(trials[j], trials[i]);
+        }
+        if (!dominated) {
+            front.append(i);
+        }
+    }
+    
+    // Most accurate first
+    std::sort(front.begin(), front.end(), [&trials](int a, int b) {
+        return trials[a].f1Score > trials[b].f1Score;
+    });
+    return front;
+}
+
+int ParameterTuner::bestTrial(const QList<TuningTrial>& trials)
+{
+    int best = -1;
+    for (int i = 0; i < trials.size(); ++i) {
+        if (!isComplete(trials[i])) {
+            continue;
+        }
+        if (best < 0 || trials[i].f1Score > trials[best].f1Score ||
+            (trials[i].f1Score == trials[best].f1Score && trials[i].runtimeMs < trials[best].runtimeMs)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+DetectionParameters ParameterTuner::sampleRandom(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    DetectionParameters params;
+    for (const Dimension& dim : SEARCH_SPACE) {
+        setValue(params, dim, dim.minimum + unit(rng) * (dim.maximum - dim.minimum));
+    }
+    return params;
+}
+
+DetectionParameters ParameterTuner::perturb(const DetectionParameters& params, double radius, std::mt19937& rng)
+{
+    std::normal_distribution<double> gaussian(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    DetectionParameters result = params;
+    for (const Dimension& dim : SEARCH_SPACE) {
+        if (dim.flag) {
+            if (unit(rng) < radius) {
+                result.*dim.flag = !(params.*dim.flag);
+            }
+            continue;
+        }
+        const double span = dim.maximum - dim.minimum;
+        setValue(result, dim, getValue(params, dim) + gaussian(rng) * radius * span);
+    }
+    return result;
+}
+
+bool ParameterTuner::saveReport(const QList<TuningTrial>& trials, const QString& outputPath) const
+{
+    QJsonObject root;
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    
+    QJsonArray formIds;
+    for (const std::unique_ptr<PreparedForm>& form : forms) {
+        formIds.append(form->groundTruth.formId);
+    }
+    root["forms"] = formIds;
+    root["total_trials"] = trials.size();
+    root["best_trial"] = bestTrial(trials);
+    
+    QJsonArray front;
+    for (int index : paretoFront(trials)) {
+        front.append(index);
+    }
+    root["pareto_front"] = front;
+    
+    QJsonArray trialArray;
+    for (const TuningTrial& trial : trials) {
+        QJsonObject trialObj;
+        trialObj["index"] = trial.index;
+        trialObj["precision"] = trial.precision;
+        trialObj["recall"] = trial.recall;
+        trialObj["f1_score"] = trial.f1Score;
+        trialObj["runtime_ms"] = trial.runtimeMs;
+        trialObj["forms_evaluated"] = trial.formsEvaluated;
+        trialObj["pruned"] = trial.pruned;
+        trialObj["pareto"] = trial.onParetoFront;
+        trialObj["parameters"] = DetectionPresetIO::toJson(trial.params);
+        trialArray.append(trialObj);
+    }
+    root["trials"] = trialArray;
+    
+    // QSaveFile writes to a temp file and renames it into place on commit
+    QSaveFile file(outputPath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+        if (file.commit()) {
+            return true;
+        }
+    }
+    
+    qWarning() << "Failed to write tuning report to" << outputPath << ":" << file.errorString();
+    return false;
+}
+
+} // namespace ocr_orc
@@ -0,0 +1,154 @@
+#ifndef PARAMETER_TUNER_H
+#define PARAMETER_TUNER_H
+
+#include "../TestDataManager.h"
+#include "../metrics/MetricsCalculator.h"
+#include "../../src/utils/DetectionPreview.h"
+#include "../../src/ui/components/dialogs/MagicDetectParamsDialog.h"
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ocr_orc {
+
+/**
+ * @brief One evaluated parameter configuration
+ */
+struct TuningTrial {
+    int index;
+    DetectionParameters params;
+    double precision;      // Mean over the forms evaluated
+    double recall;         // Mean over the forms evaluated
+    double f1Score;        // F1 of the mean precision and recall
+    double runtimeMs;      // Mean parameter-dependent stage time per form, timed alone (complete trials only)
+    int formsEvaluated;
+    bool pruned;           // Stopped early: could not catch up with the best trial
+    bool onParetoFront;
+    
+    TuningTrial()
+        : index(-1), precision(0.0), recall(0.0), f1Score(0.0), runtimeMs(0.0),
+          formsEvaluated(0), pruned(false), onParetoFront(false) {}
+};
+
+/**
+ * @brief Parallel search over DetectionParameters against ground-truth forms
+ *
+ * Each form is prepared once (page OCR, rectangle detection and candidate
+ * fields, see DetectionPreview); every trial reuses those results and only
+ * re-runs the parameter-dependent stages. Trials run in parallel, one
+ * DetectionPreview fork per worker and form.
+ *
+ * The search starts with random configurations and then mixes random
+ * samples with perturbations of the best configurations so far, with a
+ * shrinking step. It stops after maxTrials or when the best F1 score has
+ * not improved for `patience` trials. A trial is pruned after any form if
+ * its running F1 falls below pruneRatio times the best complete trial.
+ *
+ * Runtimes measured while trials compete for the cores are noise, so the
+ * search ranks on precision and recall only. Once it ends, every complete
+ * trial is re-run one at a time to measure its runtime under the same
+ * conditions, and the Pareto front is taken over precision, recall and
+ * runtime.
+ */
+class ParameterTuner {
+public:
+    /**
+     * @brief Search settings
+     */
+    struct Options {
+        int maxTrials;
+        int workers;           // 0 = one per core
+        int patience;          // Trials without improvement before stopping
+        double pruneRatio;     // Prune below this fraction of the best F1 (0 disables)
+        quint32 seed;
+    
+        Options()
+            : maxTrials(200), workers(0), patience(60), pruneRatio(0.6), seed(1) {}
+    };
+    
+    ParameterTuner();
+    ~ParameterTuner();
+    
+    ParameterTuner(const ParameterTuner&) = delete;
+    ParameterTuner& operator=(const ParameterTuner&) = delete;
+    
+    /**
+     * @brief Set base directory for test data
+     */
+    void setBaseDirectory(const QString& baseDir);
+    
+    /**
+     * @brief Load forms and run the parameter-independent detection work once per form
+     * @param formIds Forms to tune against (all forms with ground truth if empty)
+     * @param maxImageSize Longest page side to work at (default: the live preview's
+     *        thumbnail size, which bounds the planes every fork converts); 0 = full resolution
+     * @return Number of forms prepared
+     */
+    int prepareForms(const QList<QString>& formIds, int maxImageSize = DetectionPreview::MAX_THUMBNAIL_SIZE);
+    
+    /**
+     * @brief Run the search over the prepared forms
+     * @return All trials in evaluation order, complete ones timed and Pareto-front members flagged
+     */
+    QList<TuningTrial> run(const Options& options);
+    
+    /**
+     * @brief Indices of complete trials not dominated on (precision, recall, runtime)
+     *
+     * A trial dominates another when it is at least as precise, at least as
+     * complete and at least as fast, and strictly better in one of them.
+     */
+    static QList<int> paretoFront(const QList<TuningTrial>& trials);
+    
+    /**
+     * @brief Index of the complete trial with the best F1 (ties go to the faster one), or -1
+     *
+     * Ties are broken on runtimes timed alone, so the choice is always on the Pareto front.
+     */
+    static int bestTrial(const QList<TuningTrial>& trials);
+    
+    /**
+     * @brief Uniform sample of the search space
+     */
+    static DetectionParameters sampleRandom(std::mt19937& rng);
+    
+    /**
+     * @brief Random step away from a configuration
+     * @param radius Step size as a fraction of each parameter's range
+     */
+    static DetectionParameters perturb(const DetectionParameters& params, double radius, std::mt19937& rng);
+    
+    /**
+     * @brief Write every trial and the Pareto front as JSON
+     */
+    bool saveReport(const QList<TuningTrial>& trials, const QString& outputPath) const;
+    
+    int getFormCount() const { return static_cast<int>(forms.size()); }
+
+private:
+    struct PreparedForm;
+    
+    TestDataManager dataManager;
+    MetricsCalculator metricsCalculator;
+    std::vector<std::unique_ptr<PreparedForm>> forms;
+    
+    /**
+     * @brief Score one configuration on every form (stops early when pruned)
+     * @param evaluators This worker's forks, one per form
+     * @param pruneBelow F1 below which the trial is abandoned
+     */
+    void evaluate(TuningTrial& trial, std::vector<std::unique_ptr<DetectionPreview>>& evaluators,
+                  double pruneBelow) const;
+    
+    /**
+     * @brief Measure a configuration's runtime with nothing else running
+     * @param evaluators Forks to run on, one per form
+     */
+    void timeAlone(TuningTrial& trial, std::vector<std::unique_ptr<DetectionPreview>>& evaluators) const;
+};
+
+} // namespace ocr_orc
+
+#endif // PARAMETER_TUNER_H